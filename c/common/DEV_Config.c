@@ -9,20 +9,61 @@
  * for these interfaces.
  */
 #include "DEV_Config.h"
+#include "DEV_Sim.h"
+#include "DEV_Record.h"
+#include <stdlib.h>     // For getenv(), strtod()
 #include <fcntl.h>      // For open()
 #include <unistd.h>     // For close(), write(), read()
 #include <linux/spi/spidev.h> // For SPI_IOC_MESSAGE, struct spi_ioc_transfer
 #include <sys/ioctl.h>  // For ioctl()
 #include <time.h>       // For nanosleep()
-#include <string.h>     // For memset
+#include <string.h>     // For memset, strerror()
+#include <errno.h>      // For errno
+#include <poll.h>       // For poll()
+#include <sys/mman.h>   // For mmap() of the RP1 GPIO block
 
-// Global device handles
-static int spi_fd = -1;                     // File descriptor for the SPI device
-static struct gpiod_chip *gpio_chip = NULL; // GPIO chip handle
-static struct gpiod_line *rst_line = NULL;  // GPIO line for Reset pin
-static struct gpiod_line *cs_line = NULL;   // GPIO line for ADC Chip Select pin
-static struct gpiod_line *cs1_line = NULL;  // GPIO line for DAC Chip Select pin
-static struct gpiod_line *drdy_line = NULL; // GPIO line for Data Ready pin
+// Default bus and ports opened by DEV_ModuleInit() for the single-instance API
+static DEV_Bus default_bus = { .spi_fd = -1 };
+static DEV_Port adc_port = { .drdy_mode = DEV_DRDY_MODE_POLL, .spi_fd = -1 }; // RST, CS, DRDY of the ADS1256
+static DEV_Port dac_port = { .drdy_mode = DEV_DRDY_MODE_POLL, .spi_fd = -1 }; // CS1 of the DAC8532
+
+// Backend for buses opened without one, set by DEV_Backend_Select()
+static const DEV_Backend *default_backend = &DEV_Backend_Hardware;
+static const void *default_backend_arg = NULL;
+static int backend_selected = 0;
+static DEV_SimConfig select_sim_cfg;       // Argument storage for the selected backend
+static DEV_RecordConfig select_record_cfg;
+static char select_path[256];
+static DEV_CS_MODE cs_mode = DEV_CS_MODE_GPIO;
+static int cs_mode_selected = 0;
+
+#define DEV_BACKEND_ENV "DEV_BACKEND" // Backend specification used when none was selected
+#define DEV_CS_ENV      "DEV_CS"      // Chip-select mode ("gpio" or "native") used when none was selected
+
+#define DRDY_EVENT_BATCH 16 // Stale edge events drained per read
+
+/** @name Bus scheduler tuning */
+#define DEV_BUS_JOB_COST_INIT_NS 20000 ///< Initial per-write estimate: ioctl + two GPIO writes + 24 bits at 1.8 MHz
+#define DEV_BUS_DUE_COSTS        2     ///< A write is due when its deadline is this many write times away
+
+/**
+ * @brief Which queued writes DEV_Bus_PopJob() may take.
+ */
+typedef enum {
+    DEV_BUS_POP_GAP,    ///< Any write, if one fits before the gap ends
+    DEV_BUS_POP_FORCED, ///< Writes for a given port and writes that are due
+    DEV_BUS_POP_ALL,    ///< Any write
+} DEV_BUS_POP;
+
+/**
+ * @brief Returns the elapsed time between two CLOCK_MONOTONIC timestamps.
+ * @param start The earlier timestamp.
+ * @param end The later timestamp.
+ * @return Elapsed time in microseconds.
+ */
+static long DEV_ElapsedUs(const struct timespec *start, const struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) * 1000000L + (end->tv_nsec - start->tv_nsec) / 1000L;
+}
 
 /**
  * @brief Delays execution for a specified number of milliseconds.
@@ -36,115 +77,967 @@ void DEV_Delay_ms_func(int ms) {
 }
 
 /**
- * @brief Configures the GPIO lines used for device communication.
+ * @brief Opens and configures one spidev node.
  *
- * This function requests and configures the necessary GPIO lines (RST, CS, CS1, DRDY)
- * for output or input as required by the connected AD/DA module.
- * It assumes `gpio_chip` has already been successfully opened.
+ * Sets SPI mode 1 (CPOL=0, CPHA=1), 8 bits per word and the speed.
+ * @param path spidev node.
+ * @param speed_hz Maximum SCLK frequency.
+ * @return File descriptor, or -1 on failure.
+ */
+static int DEV_Hw_OpenSpi(const char *path, UDOUBLE speed_hz) {
+    uint8_t mode = SPI_MODE_1; // CPOL=0, CPHA=1
+    uint8_t bits = 8;
+    uint32_t speed = speed_hz;
+
+    int fd = open(path, O_RDWR);
+    if (fd < 0) {
+        fprintf(stderr, "DEV_Bus_Open: Failed to open SPI device %s: ", path);
+        perror(NULL);
+        return -1;
+    }
+    if (ioctl(fd, SPI_IOC_WR_MODE, &mode) < 0 ||
+        ioctl(fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 ||
+        ioctl(fd, SPI_IOC_WR_MAX_SPEED_HZ, &speed) < 0) {
+        perror("DEV_Bus_Open: Failed to configure SPI mode/bits/speed");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Opens the spidev node and the GPIO chip of a bus.
+ * @param bus Bus object (cleared by the caller).
+ * @param cfg Bus description.
+ * @return 0 on success, 1 on failure.
+ */
+static int DEV_Hw_BusOpen(DEV_Bus *bus, const DEV_BusConfig *cfg) {
+    UDOUBLE speed = bus->spi_speed_hz;
+
+    if (!cfg->spi_device || !cfg->gpio_chip) {
+        fprintf(stderr, "DEV_Bus_Open: Incomplete bus configuration\r\n");
+        return 1;
+    }
+
+    bus->spi_fd = DEV_Hw_OpenSpi(cfg->spi_device, speed);
+    if (bus->spi_fd < 0) {
+        return 1;
+    }
+
+    bus->gpio_chip = gpiod_chip_open_by_name(cfg->gpio_chip);
+    if (!bus->gpio_chip) {
+        fprintf(stderr, "DEV_Bus_Open: Failed to open GPIO chip %s: ", cfg->gpio_chip);
+        perror(NULL);
+        close(bus->spi_fd);
+        bus->spi_fd = -1;
+        return 1;
+    }
+    Debug("DEV_Bus_Open: %s at %u Hz, %s\n", cfg->spi_device, (unsigned)speed, cfg->gpio_chip);
+    return 0;
+}
+
+/**
+ * @brief Closes the spidev node and the GPIO chip of a bus.
+ * @param bus Bus to close.
+ */
+static void DEV_Hw_BusClose(DEV_Bus *bus) {
+    if (bus->gpio_chip) {
+        gpiod_chip_close(bus->gpio_chip);
+        bus->gpio_chip = NULL;
+    }
+    if (bus->spi_fd >= 0) {
+        close(bus->spi_fd);
+        bus->spi_fd = -1;
+    }
+}
+
+/**
+ * @brief Opens an SPI bus on its backend.
+ * @param bus Bus object to initialize.
+ * @param cfg Bus description.
+ * @return 0 on success, 1 on failure.
+ */
+int DEV_Bus_Open(DEV_Bus *bus, const DEV_BusConfig *cfg) {
+    memset(bus, 0, sizeof(*bus));
+    bus->spi_fd = -1;
+    if (!cfg) {
+        fprintf(stderr, "DEV_Bus_Open: Incomplete bus configuration\r\n");
+        return 1;
+    }
+
+    const DEV_Backend *backend = cfg->backend ? cfg->backend : default_backend;
+    DEV_BusConfig resolved = *cfg;
+    if (!cfg->backend) resolved.backend_arg = default_backend_arg;
+    bus->spi_speed_hz = cfg->spi_speed_hz ? cfg->spi_speed_hz : SPI_SPEED_HZ;
+
+    if (backend->bus_open(bus, &resolved) != 0) {
+        return 1;
+    }
+
+    pthread_mutex_init(&bus->lock, NULL);
+    pthread_mutex_init(&bus->queue_lock, NULL);
+    atomic_init(&bus->num_jobs, 0);
+    atomic_init(&bus->job_cost_ns, DEV_BUS_JOB_COST_INIT_NS);
+    atomic_init(&bus->last_gap_ns, 0);
+    bus->backend = backend;
+    return 0;
+}
+
+/**
+ * @brief Closes a bus.
+ * @param bus Bus to close.
+ */
+void DEV_Bus_Close(DEV_Bus *bus) {
+    if (!bus || !bus->backend) return;
+    bus->backend->bus_close(bus);
+    bus->backend = NULL;
+    pthread_mutex_destroy(&bus->lock);
+    pthread_mutex_destroy(&bus->queue_lock);
+}
+
+/**
+ * @brief Copies a bus's system call counters.
+ * @param bus Bus to read.
+ * @param stats Receives the counters.
+ */
+void DEV_Bus_GetIoStats(DEV_Bus *bus, DEV_BusIoStats *stats) {
+    if (!bus || !stats) return;
+    atomic_init(&stats->spi_messages, atomic_load_explicit(&bus->io.spi_messages, memory_order_relaxed));
+    atomic_init(&stats->spi_bytes, atomic_load_explicit(&bus->io.spi_bytes, memory_order_relaxed));
+    atomic_init(&stats->gpio_writes, atomic_load_explicit(&bus->io.gpio_writes, memory_order_relaxed));
+    atomic_init(&stats->gpio_reads, atomic_load_explicit(&bus->io.gpio_reads, memory_order_relaxed));
+    atomic_init(&stats->event_waits, atomic_load_explicit(&bus->io.event_waits, memory_order_relaxed));
+    atomic_init(&stats->mmio_accesses, atomic_load_explicit(&bus->io.mmio_accesses, memory_order_relaxed));
+    atomic_init(&stats->spi_errors, atomic_load_explicit(&bus->io.spi_errors, memory_order_relaxed));
+    atomic_init(&stats->gpio_errors, atomic_load_explicit(&bus->io.gpio_errors, memory_order_relaxed));
+}
+
+/**
+ * @brief Clears a bus's system call counters.
+ * @param bus Bus to reset.
+ */
+void DEV_Bus_ResetIoStats(DEV_Bus *bus) {
+    if (!bus) return;
+    atomic_store_explicit(&bus->io.spi_messages, 0, memory_order_relaxed);
+    atomic_store_explicit(&bus->io.spi_bytes, 0, memory_order_relaxed);
+    atomic_store_explicit(&bus->io.gpio_writes, 0, memory_order_relaxed);
+    atomic_store_explicit(&bus->io.gpio_reads, 0, memory_order_relaxed);
+    atomic_store_explicit(&bus->io.event_waits, 0, memory_order_relaxed);
+    atomic_store_explicit(&bus->io.mmio_accesses, 0, memory_order_relaxed);
+    atomic_store_explicit(&bus->io.spi_errors, 0, memory_order_relaxed);
+    atomic_store_explicit(&bus->io.gpio_errors, 0, memory_order_relaxed);
+}
+
+/**
+ * @brief Releases a line if it is requested.
+ * @param line Line to release (may be NULL).
+ */
+static void DEV_ReleaseLine(struct gpiod_line *line) {
+    if (line && gpiod_line_is_requested(line)) gpiod_line_release(line);
+}
+
+/**
+ * @brief Gets and requests one line of a port.
+ * @param chip GPIO chip.
+ * @param pin Pin number, or DEV_PIN_NONE.
+ * @param output Non-zero for an output driven high, zero for an input.
+ * @param line Output for the line (NULL for DEV_PIN_NONE).
+ * @return 0 on success, 1 on failure.
+ */
+static int DEV_RequestLine(struct gpiod_chip *chip, int pin, int output, struct gpiod_line **line) {
+    *line = NULL;
+    if (pin == DEV_PIN_NONE) return 0;
+
+    *line = gpiod_chip_get_line(chip, pin);
+    if (!*line) {
+        fprintf(stderr, "DEV_Port_Open: Failed to get GPIO line %d: ", pin);
+        perror(NULL);
+        return 1;
+    }
+    int ret = output ? gpiod_line_request_output(*line, "AD-DA", 1) : gpiod_line_request_input(*line, "AD-DA");
+    if (ret < 0) {
+        fprintf(stderr, "DEV_Port_Open: Failed to request GPIO line %d: ", pin);
+        perror(NULL);
+        *line = NULL;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Requests the lines of one device and opens its own spidev node if it has one.
+ * @param port Port object (bus and pins already set).
+ * @param cfg Pin assignment.
+ * @return 0 on success, 1 on failure.
+ */
+static int DEV_Hw_PortOpen(DEV_Port *port, const DEV_PortConfig *cfg) {
+    struct gpiod_chip *chip = port->bus->gpio_chip;
+
+    if (cfg->spi_device) {
+        port->spi_fd = DEV_Hw_OpenSpi(cfg->spi_device, DEV_Port_GetSpeed(port));
+        if (port->spi_fd < 0) return 1;
+    }
+    if (DEV_RequestLine(chip, cfg->rst_pin, 1, &port->rst_line) != 0 ||
+        DEV_RequestLine(chip, cfg->cs_pin, 1, &port->cs_line) != 0 ||
+        DEV_RequestLine(chip, cfg->drdy_pin, 0, &port->drdy_line) != 0) {
+        DEV_ReleaseLine(port->rst_line);
+        DEV_ReleaseLine(port->cs_line);
+        port->rst_line = port->cs_line = port->drdy_line = NULL;
+        if (port->spi_fd >= 0) close(port->spi_fd);
+        port->spi_fd = -1;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Releases the lines of a device.
+ * @param port Port to close.
  */
-static void DEV_GPIOConfig(void) {
-    rst_line = gpiod_chip_get_line(gpio_chip, DEV_RST_PIN);
-    cs_line = gpiod_chip_get_line(gpio_chip, DEV_CS_PIN);
-    cs1_line = gpiod_chip_get_line(gpio_chip, DEV_CS1_PIN);
-    drdy_line = gpiod_chip_get_line(gpio_chip, DEV_DRDY_PIN);
+static void DEV_Hw_PortClose(DEV_Port *port) {
+    DEV_ReleaseLine(port->rst_line);
+    DEV_ReleaseLine(port->cs_line);
+    DEV_ReleaseLine(port->drdy_line);
+    port->rst_line = port->cs_line = port->drdy_line = NULL;
+    if (port->spi_fd >= 0) {
+        close(port->spi_fd);
+        port->spi_fd = -1;
+    }
+}
 
-    if (!rst_line || !cs_line || !cs1_line || !drdy_line) {
-        perror("DEV_GPIOConfig: Failed to get GPIO lines");
-        return;
+/**
+ * @brief Opens one device on an open bus.
+ * @param port Port object to initialize.
+ * @param bus Open bus the device is on.
+ * @param cfg Pin assignment.
+ * @return 0 on success, 1 on failure.
+ */
+int DEV_Port_Open(DEV_Port *port, DEV_Bus *bus, const DEV_PortConfig *cfg) {
+    memset(port, 0, sizeof(*port));
+    port->drdy_mode = DEV_DRDY_MODE_POLL;
+    port->spi_fd = -1;
+    if (!bus || !bus->backend || !cfg) {
+        fprintf(stderr, "DEV_Port_Open: Bus not open\r\n");
+        return 1;
+    }
+    port->bus = bus;
+    port->pins = *cfg;
+    port->spi_speed_hz = cfg->spi_speed_hz;
+
+    if (bus->backend->port_open(port, cfg) != 0) {
+        port->bus = NULL;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Closes a device.
+ * @param port Port to close.
+ */
+void DEV_Port_Close(DEV_Port *port) {
+    if (!port || !port->bus) return;
+    if (port->bus->backend) { // Drop writes still queued for this port
+        DEV_Bus *bus = port->bus;
+        pthread_mutex_lock(&bus->queue_lock);
+        UBYTE n = atomic_load_explicit(&bus->num_jobs, memory_order_relaxed);
+        for (UBYTE i = 0; i < n; ) {
+            if (bus->jobs[i].port == port) bus->jobs[i] = bus->jobs[--n];
+            else i++;
+        }
+        atomic_store_explicit(&bus->num_jobs, n, memory_order_relaxed);
+        pthread_mutex_unlock(&bus->queue_lock);
+        bus->backend->port_close(port);
+    }
+    port->drdy_mode = DEV_DRDY_MODE_POLL;
+    port->bus = NULL;
+}
+
+/**
+ * @brief Returns the default ADC port.
+ * @return Pointer to the port opened by DEV_ModuleInit().
+ */
+DEV_Port *DEV_GetADCPort(void) {
+    return &adc_port;
+}
+
+/**
+ * @brief Returns the default DAC port.
+ * @return Pointer to the port opened by DEV_ModuleInit().
+ */
+DEV_Port *DEV_GetDACPort(void) {
+    return &dac_port;
+}
+
+/**
+ * @brief Returns the bus DEV_ModuleInit() opened.
+ * @return The default bus.
+ */
+DEV_Bus *DEV_GetDefaultBus(void) {
+    return &default_bus;
+}
+
+/**
+ * @brief Resolves a backend specification without the "record:" form.
+ * @param spec "hw", "rp1", "sim", "sim:<time_scale>" or "replay:<file>".
+ * @param backend Receives the backend.
+ * @param arg Receives the backend argument.
+ * @return 0 on success, 1 on an unknown specification.
+ */
+static int DEV_Backend_Parse(const char *spec, const DEV_Backend **backend, const void **arg) {
+    if (strcmp(spec, "hw") == 0) {
+        *backend = &DEV_Backend_Hardware;
+        *arg = NULL;
+        return 0;
+    }
+    if (strcmp(spec, "rp1") == 0) {
+        *backend = &DEV_Backend_Rp1;
+        *arg = NULL;
+        return 0;
+    }
+    if (strncmp(spec, "sim", 3) == 0 && (spec[3] == '\0' || spec[3] == ':')) {
+        DEV_Sim_DefaultConfig(&select_sim_cfg);
+        if (spec[3] == ':') {
+            char *end;
+            select_sim_cfg.time_scale = strtod(spec + 4, &end);
+            if (end == spec + 4 || *end != '\0' || select_sim_cfg.time_scale < 0) return 1;
+        }
+        *backend = &DEV_Backend_Sim;
+        *arg = &select_sim_cfg;
+        return 0;
     }
+    if (strncmp(spec, "replay:", 7) == 0 && spec[7] != '\0') {
+        snprintf(select_path, sizeof(select_path), "%s", spec + 7);
+        *backend = &DEV_Backend_Replay;
+        *arg = select_path;
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Chooses the backend used by DEV_ModuleInit() and by buses opened without one.
+ * @param spec Backend specification, see DEV_Config.h.
+ * @return 0 on success, 1 on an unknown specification.
+ */
+int DEV_Backend_Select(const char *spec) {
+    const DEV_Backend *backend;
+    const void *arg;
 
-    if (gpiod_line_request_output(rst_line, "AD-DA", 1) < 0 ||
-        gpiod_line_request_output(cs_line, "AD-DA", 1) < 0 ||
-        gpiod_line_request_output(cs1_line, "AD-DA", 1) < 0 ||
-        gpiod_line_request_input(drdy_line, "AD-DA") < 0) {
-        perror("DEV_GPIOConfig: Failed to request GPIO lines");
-        if(rst_line && gpiod_line_is_requested(rst_line)) gpiod_line_release(rst_line);
-        if(cs_line && gpiod_line_is_requested(cs_line)) gpiod_line_release(cs_line);
-        if(cs1_line && gpiod_line_is_requested(cs1_line)) gpiod_line_release(cs1_line);
-        if(drdy_line && gpiod_line_is_requested(drdy_line)) gpiod_line_release(drdy_line);
-        return;
+    if (!spec) return 1;
+    if (strncmp(spec, "record:", 7) == 0) {
+        const char *file = spec + 7;
+        const char *comma = strchr(file, ',');
+        size_t len = comma ? (size_t)(comma - file) : strlen(file);
+
+        if (len == 0 || len >= sizeof(select_path)) return 1;
+        if (DEV_Backend_Parse(comma ? comma + 1 : "hw", &backend, &arg) != 0 || backend == &DEV_Backend_Replay) {
+            return 1;
+        }
+        memcpy(select_path, file, len);
+        select_path[len] = '\0';
+        select_record_cfg.path = select_path;
+        select_record_cfg.inner = backend;
+        select_record_cfg.inner_arg = arg;
+        backend = &DEV_Backend_Record;
+        arg = &select_record_cfg;
+    } else if (DEV_Backend_Parse(spec, &backend, &arg) != 0) {
+        return 1;
     }
+
+    default_backend = backend;
+    default_backend_arg = arg;
+    backend_selected = 1;
+    return 0;
+}
+
+/**
+ * @brief Chooses who drives the chip selects of the ports DEV_ModuleInit() opens.
+ * @param mode Chip-select mode.
+ * @return 0 on success, 1 on an invalid mode.
+ */
+int DEV_CS_SetMode(DEV_CS_MODE mode) {
+    if (mode != DEV_CS_MODE_GPIO && mode != DEV_CS_MODE_NATIVE) return 1;
+    cs_mode = mode;
+    cs_mode_selected = 1;
+    return 0;
+}
+
+/**
+ * @brief Returns the chip-select mode DEV_ModuleInit() uses.
+ * @return DEV_CS_MODE_GPIO or DEV_CS_MODE_NATIVE.
+ */
+DEV_CS_MODE DEV_CS_GetMode(void) {
+    return cs_mode;
+}
+
+/**
+ * @brief Changes the SCLK frequency of one device's messages.
+ * @param port Open port.
+ * @param speed_hz Clock in Hz, or 0 to use the bus's speed again.
+ * @return 0 on success, 1 if the port is not open.
+ */
+int DEV_Port_SetSpeed(DEV_Port *port, UDOUBLE speed_hz) {
+    if (!port || !port->bus || !port->bus->backend) return 1;
+
+    pthread_mutex_lock(&port->bus->lock);
+    port->spi_speed_hz = speed_hz;
+    pthread_mutex_unlock(&port->bus->lock);
+    Debug("DEV_Port_SetSpeed: %u Hz\n", (unsigned)DEV_Port_GetSpeed(port));
+    return 0;
+}
+
+/**
+ * @brief Returns the SCLK frequency of a device's messages.
+ * @param port Open port.
+ * @return Its own speed, or the bus's speed when it has none.
+ */
+UDOUBLE DEV_Port_GetSpeed(const DEV_Port *port) {
+    if (port && port->spi_speed_hz) return port->spi_speed_hz;
+    return (port && port->bus && port->bus->spi_speed_hz) ? port->bus->spi_speed_hz : SPI_SPEED_HZ;
+}
+
+/**
+ * @brief Tells whether the controller frames a port's messages.
+ * @param port Open port.
+ * @return 1 for a native chip select, 0 for a GPIO one.
+ */
+int DEV_Port_HasNativeCS(const DEV_Port *port) {
+    return port && port->pins.cs_pin == DEV_PIN_NONE;
+}
+
+/**
+ * @brief Returns the name of the selected backend.
+ * @return Backend name.
+ */
+const char *DEV_Backend_Name(void) {
+    return default_backend->name;
 }
 
 /**
  * @brief Initializes the hardware module.
  *
- * This function performs the following steps:
- * 1. Opens the SPI device (e.g., "/dev/spidev0.0").
- * 2. Configures SPI parameters: mode, bits per word, and max speed.
- * 3. Opens the GPIO chip (e.g., "gpiochip4" for Raspberry Pi 5).
- * 4. Calls DEV_GPIOConfig() to configure individual GPIO lines.
+ * Opens the default bus from SPI_DEVICE, SPI_SPEED_HZ and GPIO_CHIP_NAME,
+ * then the ADC port (DEV_RST_PIN, DEV_CS_PIN, DEV_DRDY_PIN) and the DAC port
+ * (DEV_CS1_PIN) on it, using the backend from DEV_Backend_Select() or the
+ * DEV_BACKEND environment variable. In DEV_CS_MODE_NATIVE both ports are
+ * opened without CS lines and the DAC gets SPI_DEVICE_CS1.
  *
  * @return 0 on success, 1 on failure.
  */
 int DEV_ModuleInit(void) {
-    spi_fd = open(SPI_DEVICE, O_RDWR);
-    if (spi_fd < 0) {
-        perror("DEV_ModuleInit: Failed to open SPI device " SPI_DEVICE);
+    const DEV_BusConfig bus_cfg = { .spi_device = SPI_DEVICE, .spi_speed_hz = SPI_SPEED_HZ, .gpio_chip = GPIO_CHIP_NAME };
+    DEV_PortConfig adc_cfg = { .rst_pin = DEV_RST_PIN, .cs_pin = DEV_CS_PIN, .drdy_pin = DEV_DRDY_PIN };
+    DEV_PortConfig dac_cfg = { .rst_pin = DEV_PIN_NONE, .cs_pin = DEV_CS1_PIN, .drdy_pin = DEV_PIN_NONE };
+    const char *env = getenv(DEV_BACKEND_ENV);
+    const char *cs_env = getenv(DEV_CS_ENV);
+
+    if (!backend_selected && env && DEV_Backend_Select(env) != 0) {
+        fprintf(stderr, "DEV_ModuleInit: Unknown %s \"%s\"\r\n", DEV_BACKEND_ENV, env);
+        return 1;
+    }
+    if (!cs_mode_selected && cs_env) {
+        if (strcmp(cs_env, "native") == 0) {
+            cs_mode = DEV_CS_MODE_NATIVE;
+        } else if (strcmp(cs_env, "gpio") != 0) {
+            fprintf(stderr, "DEV_ModuleInit: Unknown %s \"%s\"\r\n", DEV_CS_ENV, cs_env);
+            return 1;
+        }
+    }
+    if (cs_mode == DEV_CS_MODE_NATIVE) { // The controller frames both devices, see DEV_CS_SetMode()
+        adc_cfg.cs_pin = DEV_PIN_NONE;
+        dac_cfg.cs_pin = DEV_PIN_NONE;
+        dac_cfg.spi_device = SPI_DEVICE_CS1;
+    }
+    if (DEV_Bus_Open(&default_bus, &bus_cfg) != 0) {
+        return 1;
+    }
+    if (DEV_Port_Open(&adc_port, &default_bus, &adc_cfg) != 0 ||
+        DEV_Port_Open(&dac_port, &default_bus, &dac_cfg) != 0) {
+        DEV_ModuleExit();
         return 1;
     }
 
-    uint8_t mode = SPI_MODE_1; // CPOL=0, CPHA=1
-    uint8_t bits = 8;
-    uint32_t speed = SPI_SPEED_HZ;
+    Debug("DEV_ModuleInit: SPI and GPIO initialized successfully (%s backend, %s chip selects).\n",
+          default_backend->name, cs_mode == DEV_CS_MODE_NATIVE ? "native" : "GPIO");
+    return 0;
+}
+
+/**
+ * @brief Performs one full-duplex SPI transfer in a single ioctl.
+ * @param tx Bytes to send, or NULL to send zeros.
+ * @param rx Buffer for the received bytes, or NULL to discard them.
+ * @param len Number of bytes to transfer.
+ * @return 0 on success, 1 on failure.
+ */
+int DEV_SPI_Transfer(const UBYTE *tx, UBYTE *rx, UDOUBLE len) {
+    DEV_SPI_Segment segment = {
+        .tx = tx,
+        .rx = rx,
+        .len = len,
+    };
+    return DEV_SPI_Message(&segment, 1);
+}
+
+/**
+ * @brief Sends a multi-segment SPI message on a bus in a single ioctl.
+ *
+ * Each segment is translated into one `struct spi_ioc_transfer`. The kernel
+ * executes them back to back, honouring `delay_usecs` between segments and
+ * `cs_change` for the controller's native chip select. A port with its own
+ * spidev node is addressed through that node, whose CS the kernel drives.
+ * @param bus Open bus.
+ * @param port Device being addressed, or NULL.
+ * @param segments Array of segments to transfer.
+ * @param num_segments Number of segments (1 to DEV_SPI_MAX_SEGMENTS).
+ * @return 0 on success, 1 on failure.
+ */
+static int DEV_Hw_Transfer(DEV_Bus *bus, DEV_Port *port, const DEV_SPI_Segment *segments, UBYTE num_segments) {
+    struct spi_ioc_transfer tr[DEV_SPI_MAX_SEGMENTS];
+    int fd = (port && port->spi_fd >= 0) ? port->spi_fd : bus->spi_fd;
+    UDOUBLE speed = port ? DEV_Port_GetSpeed(port) : bus->spi_speed_hz;
+
+    memset(tr, 0, sizeof(tr[0]) * num_segments);
+    for (UBYTE i = 0; i < num_segments; i++) {
+        tr[i].tx_buf = (unsigned long)segments[i].tx;
+        tr[i].rx_buf = (unsigned long)segments[i].rx;
+        tr[i].len = segments[i].len;
+        tr[i].delay_usecs = segments[i].delay_usecs;
+        tr[i].cs_change = (i + 1 < num_segments) && segments[i].cs_change; // On the last one it would keep CS asserted
+        tr[i].speed_hz = speed;
+        tr[i].bits_per_word = 8;
+    }
 
-    if (ioctl(spi_fd, SPI_IOC_WR_MODE, &mode) < 0) {
-        perror("DEV_ModuleInit: Failed to set SPI_IOC_WR_MODE");
-        close(spi_fd);
-        spi_fd = -1;
+    if (ioctl(fd, SPI_IOC_MESSAGE(num_segments), tr) < 0) {
+        Debug("DEV_SPI_Message: SPI transfer failed: %s\n", strerror(errno));
         return 1;
     }
-    if (ioctl(spi_fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0) {
-        perror("DEV_ModuleInit: Failed to set SPI_IOC_WR_BITS_PER_WORD");
-        close(spi_fd);
-        spi_fd = -1;
+    return 0;
+}
+
+/**
+ * @brief Sends a multi-segment SPI message on a bus through its backend.
+ * @param bus Open bus.
+ * @param port Device whose chip select frames the message, or NULL.
+ * @param segments Array of segments to transfer.
+ * @param num_segments Number of segments (1 to DEV_SPI_MAX_SEGMENTS).
+ * @return 0 on success, 1 on failure.
+ */
+static int DEV_Bus_Message(DEV_Bus *bus, DEV_Port *port, const DEV_SPI_Segment *segments, UBYTE num_segments) {
+    if (!bus || !bus->backend) {
+        Debug("DEV_SPI_Message: SPI not initialized.\n");
         return 1;
     }
-    if (ioctl(spi_fd, SPI_IOC_WR_MAX_SPEED_HZ, &speed) < 0) {
-        perror("DEV_ModuleInit: Failed to set SPI_IOC_WR_MAX_SPEED_HZ");
-        close(spi_fd);
-        spi_fd = -1;
+    if (!segments || num_segments == 0 || num_segments > DEV_SPI_MAX_SEGMENTS) {
+        Debug("DEV_SPI_Message: Invalid segment count %d\n", num_segments);
+        atomic_fetch_add_explicit(&bus->io.spi_errors, 1, memory_order_relaxed);
         return 1;
     }
 
-    gpio_chip = gpiod_chip_open_by_name(GPIO_CHIP_NAME);
-    if (!gpio_chip) {
-        perror("DEV_ModuleInit: Failed to open GPIO chip " GPIO_CHIP_NAME);
-        close(spi_fd);
-        spi_fd = -1;
+    UDOUBLE bytes = 0;
+    for (UBYTE i = 0; i < num_segments; i++) bytes += segments[i].len;
+    atomic_fetch_add_explicit(&bus->io.spi_messages, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&bus->io.spi_bytes, bytes, memory_order_relaxed);
+    int ret = bus->backend->transfer(bus, port, segments, num_segments);
+    if (ret != 0) atomic_fetch_add_explicit(&bus->io.spi_errors, 1, memory_order_relaxed);
+    return ret;
+}
+
+/**
+ * @brief Drives one output line of a port.
+ * @param port Target device.
+ * @param line Line to drive.
+ * @param value Level.
+ * @return 0 on success, 1 on failure.
+ */
+static int DEV_Port_SetLine(DEV_Port *port, DEV_LINE line, int value) {
+    int ret = port->bus->backend->set_line(port, line, value);
+    if (ret != 0) atomic_fetch_add_explicit(&port->bus->io.gpio_errors, 1, memory_order_relaxed);
+    return ret;
+}
+
+/**
+ * @brief Sends a multi-segment SPI message on the default bus in a single ioctl.
+ * @param segments Array of segments to transfer.
+ * @param num_segments Number of segments (1 to DEV_SPI_MAX_SEGMENTS).
+ * @return 0 on success, 1 on failure.
+ */
+int DEV_SPI_Message(const DEV_SPI_Segment *segments, UBYTE num_segments) {
+    return DEV_Bus_Message(&default_bus, NULL, segments, num_segments);
+}
+
+/**
+ * @brief Returns the clock used for bus scheduler deadlines.
+ * @return CLOCK_MONOTONIC_RAW time in nanoseconds.
+ */
+uint64_t DEV_Now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+#define DEV_CLOCK_CORR_TRIES 8 ///< Reads per DEV_ClockCorr_Measure(); the tightest one is kept
+
+/**
+ * @brief Reads a clock in nanoseconds.
+ * @param clock Clock to read.
+ * @param ns Receives the time.
+ * @return 0 on success, -1 on error.
+ */
+static int DEV_ClockNs(clockid_t clock, uint64_t *ns) {
+    struct timespec ts;
+    if (clock_gettime(clock, &ts) != 0) return -1;
+    *ns = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    return 0;
+}
+
+/**
+ * @brief Measures the offset between CLOCK_MONOTONIC and a target clock.
+ * @param corr Correlation to update.
+ * @param clock Target clock.
+ * @return 0 on success, 1 if the clock cannot be read.
+ */
+int DEV_ClockCorr_Measure(DEV_ClockCorr *corr, clockid_t clock) {
+    uint64_t best_window = UINT64_MAX, best_mono = 0, best_target = 0;
+
+    for (int i = 0; i < DEV_CLOCK_CORR_TRIES; i++) {
+        uint64_t before, target, after;
+        if (DEV_ClockNs(CLOCK_MONOTONIC, &before) != 0 || DEV_ClockNs(clock, &target) != 0 ||
+            DEV_ClockNs(CLOCK_MONOTONIC, &after) != 0) {
+            perror("DEV_ClockCorr_Measure: clock_gettime failed");
+            return 1;
+        }
+        if (after - before < best_window) {
+            best_window = after - before;
+            best_mono = before + (after - before) / 2;
+            best_target = target;
+        }
+    }
+
+    // Rate from the previous measurement of the same clock, if it is far enough back to be meaningful
+    if (corr->valid && corr->clock == clock && best_mono > corr->mono_ns + 100000000ULL) {
+        double mono_span = (double)(best_mono - corr->mono_ns);
+        double target_span = (double)best_target - (double)corr->target_ns;
+        corr->drift_ppb = (int64_t)((target_span - mono_span) / mono_span * 1e9);
+    } else if (!corr->valid || corr->clock != clock) {
+        corr->drift_ppb = 0;
+    }
+    corr->clock = clock;
+    corr->mono_ns = best_mono;
+    corr->target_ns = best_target;
+    corr->uncertainty_ns = best_window / 2;
+    corr->valid = 1;
+    return 0;
+}
+
+/**
+ * @brief Converts a CLOCK_MONOTONIC timestamp to the target clock.
+ * @param corr Correlation from DEV_ClockCorr_Measure().
+ * @param mono_ns CLOCK_MONOTONIC time in nanoseconds.
+ * @return Target clock time in nanoseconds, or 0 if no measurement was made.
+ */
+uint64_t DEV_ClockCorr_Convert(const DEV_ClockCorr *corr, uint64_t mono_ns) {
+    if (!corr || !corr->valid) return 0;
+
+    int64_t delta = (int64_t)(mono_ns - corr->mono_ns);
+    int64_t drift = (int64_t)((double)delta * (double)corr->drift_ppb / 1e9);
+    return corr->target_ns + (uint64_t)(delta + drift);
+}
+
+/**
+ * @brief Returns a job's deadline for earliest-deadline-first ordering.
+ * @param job Queued write.
+ * @return The deadline, or UINT64_MAX for a write without one.
+ */
+static uint64_t DEV_JobDeadline(const DEV_BusJob *job) {
+    return job->deadline_ns ? job->deadline_ns : UINT64_MAX;
+}
+
+/**
+ * @brief Removes the queued write with the earliest deadline among those `mode` allows.
+ * @param bus Bus whose queue to take from.
+ * @param mode Selection rule.
+ * @param gap_end_ns End of the gap (DEV_BUS_POP_GAP only).
+ * @param port Port whose writes are always eligible (DEV_BUS_POP_FORCED only).
+ * @param counter Scheduler counter to increment for the write taken.
+ * @param job Receives the write.
+ * @return 1 if a write was taken, 0 if none is eligible.
+ */
+static int DEV_Bus_PopJob(DEV_Bus *bus, DEV_BUS_POP mode, uint64_t gap_end_ns, const DEV_Port *port,
+                          unsigned long *counter, DEV_BusJob *job) {
+    uint64_t now = DEV_Now_ns();
+    uint64_t cost = atomic_load_explicit(&bus->job_cost_ns, memory_order_relaxed);
+    int best = -1;
+
+    if (mode == DEV_BUS_POP_GAP && now + cost > gap_end_ns) return 0;
+
+    pthread_mutex_lock(&bus->queue_lock);
+    UBYTE n = atomic_load_explicit(&bus->num_jobs, memory_order_relaxed);
+    for (int i = 0; i < n; i++) {
+        const DEV_BusJob *j = &bus->jobs[i];
+        if (mode == DEV_BUS_POP_FORCED && j->port != port &&
+            DEV_JobDeadline(j) > now + DEV_BUS_DUE_COSTS * cost) {
+            continue;
+        }
+        if (best < 0 || DEV_JobDeadline(j) < DEV_JobDeadline(&bus->jobs[best])) best = i;
+    }
+    if (best >= 0) {
+        *job = bus->jobs[best];
+        bus->jobs[best] = bus->jobs[n - 1];
+        atomic_store_explicit(&bus->num_jobs, n - 1, memory_order_relaxed);
+        (*counter)++;
+        if (job->deadline_ns && now > job->deadline_ns) bus->sched.late++;
+    }
+    pthread_mutex_unlock(&bus->queue_lock);
+    return best >= 0;
+}
+
+/**
+ * @brief Sends a message framed by the port's chip select. The bus lock must be held.
+ *
+ * Nothing is clocked out if CS cannot be asserted. A failed release fails
+ * the message too, since the device would stay selected for the next
+ * transaction on the bus.
+ * @param port Target device.
+ * @param segments Array of segments to transfer.
+ * @param num_segments Number of segments (1 to DEV_SPI_MAX_SEGMENTS).
+ * @return 0 on success, 1 on an SPI or chip select error.
+ */
+static int DEV_Port_MessageLocked(DEV_Port *port, const DEV_SPI_Segment *segments, UBYTE num_segments) {
+    if (port->pins.cs_pin == DEV_PIN_NONE) {
+        return DEV_Bus_Message(port->bus, port, segments, num_segments);
+    }
+
+    int ret = 1;
+    if (DEV_Port_SetLine(port, DEV_LINE_CS, LOW) == 0) {
+        ret = DEV_Bus_Message(port->bus, port, segments, num_segments);
+    } else {
+        Debug("DEV_Port_Message: Failed to assert CS, message not sent\n");
+    }
+    if (DEV_Port_SetLine(port, DEV_LINE_CS, HIGH) != 0) {
+        Debug("DEV_Port_Message: Failed to release CS\n");
+        ret = 1;
+    }
+    return ret;
+}
+
+/**
+ * @brief Sends one queued write. The bus lock must be held.
+ *
+ * The measured bus time feeds the per-write cost estimate used to decide
+ * whether a write still fits into a gap. Its submitter has already been
+ * told the write was accepted, so a failure is counted in `sched.failed`.
+ * @param bus Bus to send on.
+ * @param job Write to send.
+ * @return 0 on success, 1 on an SPI or chip select error.
+ */
+static int DEV_Bus_SendJobLocked(DEV_Bus *bus, const DEV_BusJob *job) {
+    DEV_SPI_Segment segment = { .tx = job->tx, .len = job->len };
+    uint64_t start = DEV_Now_ns();
+
+    int ret = DEV_Port_MessageLocked(job->port, &segment, 1);
+
+    int64_t took = (int64_t)(DEV_Now_ns() - start);
+    int64_t cost = (int64_t)atomic_load_explicit(&bus->job_cost_ns, memory_order_relaxed);
+    atomic_store_explicit(&bus->job_cost_ns, (uint64_t)(cost + (took - cost) / 8), memory_order_relaxed);
+    if (ret != 0) {
+        pthread_mutex_lock(&bus->queue_lock);
+        bus->sched.failed++;
+        pthread_mutex_unlock(&bus->queue_lock);
+        Debug("DEV_Bus_SendJob: Queued write failed\n");
+    }
+    return ret;
+}
+
+/**
+ * @brief Pops and sends queued writes until none is eligible.
+ * @param bus Bus to service; its lock must not be held.
+ * @param mode Selection rule (DEV_BUS_POP_GAP or DEV_BUS_POP_ALL).
+ * @param gap_end_ns End of the gap for DEV_BUS_POP_GAP.
+ * @param counter Scheduler counter to increment per write sent.
+ */
+static void DEV_Bus_Drain(DEV_Bus *bus, DEV_BUS_POP mode, uint64_t gap_end_ns, unsigned long *counter) {
+    DEV_BusJob job;
+
+    while (DEV_Bus_PopJob(bus, mode, gap_end_ns, NULL, counter, &job)) {
+        pthread_mutex_lock(&bus->lock);
+        DEV_Bus_SendJobLocked(bus, &job);
+        pthread_mutex_unlock(&bus->lock);
+    }
+}
+
+/**
+ * @brief Sends a multi-segment SPI message to a device, framed by its chip select.
+ *
+ * Queued writes for the same port, and queued writes that are due, go out
+ * first under the same lock.
+ * @param port Target device.
+ * @param segments Array of segments to transfer.
+ * @param num_segments Number of segments (1 to DEV_SPI_MAX_SEGMENTS).
+ * @return 0 on success, 1 on an SPI error or a chip select that could not be driven.
+ */
+int DEV_Port_Message(DEV_Port *port, const DEV_SPI_Segment *segments, UBYTE num_segments) {
+    if (!port || !port->bus || !port->bus->backend) {
+        Debug("DEV_Port_Message: Port not open.\n");
         return 1;
     }
 
-    DEV_GPIOConfig();
+    pthread_mutex_lock(&port->bus->lock);
+    if (atomic_load_explicit(&port->bus->num_jobs, memory_order_relaxed)) {
+        DEV_BusJob job;
+        while (DEV_Bus_PopJob(port->bus, DEV_BUS_POP_FORCED, 0, port, &port->bus->sched.sent_forced, &job)) {
+            DEV_Bus_SendJobLocked(port->bus, &job);
+        }
+    }
+    int ret = DEV_Port_MessageLocked(port, segments, num_segments);
+    pthread_mutex_unlock(&port->bus->lock);
+    return ret;
+}
 
-    Debug("DEV_ModuleInit: SPI and GPIO initialized successfully.\n");
+/**
+ * @brief Queues a short write to the device without waiting for the bus.
+ * @param port Target device.
+ * @param tx Bytes to send.
+ * @param len Number of bytes (1 to DEV_BUS_JOB_MAX_LEN).
+ * @param deadline_ns Latest send time on the DEV_Now_ns() clock, or 0 for none.
+ * @return 0 when queued (or sent), 1 on invalid arguments or a full queue.
+ */
+int DEV_Port_Submit(DEV_Port *port, const UBYTE *tx, UBYTE len, uint64_t deadline_ns) {
+    if (!port || !port->bus || !tx || len == 0 || len > DEV_BUS_JOB_MAX_LEN) {
+        fprintf(stderr, "DEV_Port_Submit: Port not open or invalid length %d.\n", len);
+        return 1;
+    }
+
+    DEV_Bus *bus = port->bus;
+    DEV_BusJob *job = NULL;
+    int ret = 0;
+
+    pthread_mutex_lock(&bus->queue_lock);
+    UBYTE n = atomic_load_explicit(&bus->num_jobs, memory_order_relaxed);
+    for (UBYTE i = 0; i < n; i++) {
+        if (bus->jobs[i].port == port && bus->jobs[i].len == len && bus->jobs[i].tx[0] == tx[0]) {
+            job = &bus->jobs[i];
+            break;
+        }
+    }
+    if (job) {
+        bus->sched.merged++;
+        if (deadline_ns == 0 || (job->deadline_ns && job->deadline_ns < deadline_ns)) {
+            deadline_ns = job->deadline_ns; // Keep the earlier promise
+        }
+    } else if (n < DEV_BUS_QUEUE_LEN) {
+        job = &bus->jobs[n];
+        job->port = port;
+        job->len = len;
+        atomic_store_explicit(&bus->num_jobs, n + 1, memory_order_relaxed);
+    } else {
+        bus->sched.rejected++;
+        ret = 1;
+    }
+    if (job) {
+        memcpy(job->tx, tx, len);
+        job->deadline_ns = deadline_ns;
+        bus->sched.submitted++;
+    }
+    pthread_mutex_unlock(&bus->queue_lock);
+
+    if (ret != 0) {
+        Debug("DEV_Port_Submit: Queue full, write dropped\n");
+        return ret;
+    }
+    if (DEV_Now_ns() - atomic_load_explicit(&bus->last_gap_ns, memory_order_relaxed) > DEV_BUS_GAP_IDLE_NS) {
+        DEV_Bus_Drain(bus, DEV_BUS_POP_ALL, 0, &bus->sched.sent_idle); // Nobody is announcing gaps
+    }
     return 0;
 }
 
 /**
- * @brief Writes a single byte to the SPI bus and reads a byte.
- *
- * This function sends `value` over SPI and stores the received byte.
- * @param value The byte to write to the SPI bus.
+ * @brief Sends queued writes that fit before `gap_end_ns`.
+ * @param bus Bus to service.
+ * @param gap_end_ns Time (DEV_Now_ns() clock) by which the bus must be free again.
  */
-void SPI_WriteByte(uint8_t value) {
-    uint8_t rx_buffer; 
-    struct spi_ioc_transfer tr = {
-        .tx_buf = (unsigned long)&value,
-        .rx_buf = (unsigned long)&rx_buffer,
-        .len = 1,
-        .speed_hz = SPI_SPEED_HZ,
-        .bits_per_word = 8,
-    };
+void DEV_Bus_ServiceGap(DEV_Bus *bus, uint64_t gap_end_ns) {
+    if (!bus) return;
+    atomic_store_explicit(&bus->last_gap_ns, DEV_Now_ns(), memory_order_relaxed);
+    if (atomic_load_explicit(&bus->num_jobs, memory_order_relaxed) == 0) return;
+    DEV_Bus_Drain(bus, DEV_BUS_POP_GAP, gap_end_ns, &bus->sched.sent_in_gap);
+}
+
+/**
+ * @brief Sends every queued write now.
+ * @param bus Bus to flush.
+ */
+void DEV_Bus_Flush(DEV_Bus *bus) {
+    if (!bus || !bus->backend) return;
+    DEV_Bus_Drain(bus, DEV_BUS_POP_ALL, 0, &bus->sched.sent_forced);
+}
+
+/**
+ * @brief Copies the bus scheduler counters.
+ * @param bus Bus to read.
+ * @param stats Receives the counters.
+ */
+void DEV_Bus_GetSchedStats(DEV_Bus *bus, DEV_BusSchedStats *stats) {
+    if (!bus || !stats) return;
+    pthread_mutex_lock(&bus->queue_lock);
+    *stats = bus->sched;
+    pthread_mutex_unlock(&bus->queue_lock);
+    stats->job_cost_ns = atomic_load_explicit(&bus->job_cost_ns, memory_order_relaxed);
+}
+
+/**
+ * @brief Drives the RST or CS line of a device.
+ * @param port Target device.
+ * @param line Line to drive.
+ * @param value Level.
+ * @return 0 on success, 1 on failure.
+ */
+static int DEV_Hw_SetLine(DEV_Port *port, DEV_LINE line, int value) {
+    struct gpiod_line *target = (line == DEV_LINE_RST) ? port->rst_line : port->cs_line;
+    atomic_fetch_add_explicit(&port->bus->io.gpio_writes, 1, memory_order_relaxed);
+    if (!target || gpiod_line_set_value(target, value) < 0) {
+        Debug("DEV_GPIO_Write: Failed to set GPIO line value: %s\n", strerror(errno));
+        return 1;
+    }
+    return 0;
+}
 
-    if (spi_fd < 0) {
-        fprintf(stderr, "SPI_WriteByte: SPI not initialized.\n");
-        return;
+/**
+ * @brief Reads the DRDY level of a device.
+ * @param port Target device.
+ * @return 0 or 1, or -1 on error.
+ */
+static int DEV_Hw_GetDrdy(DEV_Port *port) {
+    atomic_fetch_add_explicit(&port->bus->io.gpio_reads, 1, memory_order_relaxed);
+    int value = port->drdy_line ? gpiod_line_get_value(port->drdy_line) : -1;
+    if (value < 0) {
+        Debug("DEV_GPIO_Read: Failed to get GPIO line value: %s\n", strerror(errno));
     }
+    return value;
+}
 
-    if (ioctl(spi_fd, SPI_IOC_MESSAGE(1), &tr) < 0) {
-        perror("SPI_WriteByte: Failed to write SPI byte");
+/**
+ * @brief Drives the device's reset line.
+ * @param port Target device.
+ * @param value 0 to hold the device in reset, 1 to release it.
+ * @return 0 on success, 1 if the port has no reset line or the GPIO write failed.
+ */
+int DEV_Port_SetReset(DEV_Port *port, int value) {
+    if (!port || !port->bus || port->pins.rst_pin == DEV_PIN_NONE) {
+        fprintf(stderr, "DEV_Port_SetReset: No reset line configured.\n");
+        return 1;
     }
+    return DEV_Port_SetLine(port, DEV_LINE_RST, value);
+}
+
+/**
+ * @brief Writes a single byte to the SPI bus.
+ *
+ * The byte clocked in from the slave at the same time is discarded.
+ * @param value The byte to write to the SPI bus.
+ */
+void SPI_WriteByte(uint8_t value) {
+    DEV_SPI_Transfer(&value, NULL, 1);
 }
 
 /**
@@ -157,23 +1050,10 @@ void SPI_WriteByte(uint8_t value) {
 UBYTE SPI_ReadByte(void) {
     uint8_t tx_dummy = 0xFF;
     uint8_t rx_buffer = 0;
-    struct spi_ioc_transfer tr = {
-        .tx_buf = (unsigned long)&tx_dummy,
-        .rx_buf = (unsigned long)&rx_buffer,
-        .len = 1,
-        .speed_hz = SPI_SPEED_HZ,
-        .bits_per_word = 8,
-    };
 
-    if (spi_fd < 0) {
-        fprintf(stderr, "SPI_ReadByte: SPI not initialized.\n");
+    if (DEV_SPI_Transfer(&tx_dummy, &rx_buffer, 1) != 0) {
         return 0;
     }
-
-    if (ioctl(spi_fd, SPI_IOC_MESSAGE(1), &tr) < 0) {
-        perror("SPI_ReadByte: Failed to read SPI byte");
-        return 0; 
-    }
     return rx_buffer;
 }
 
@@ -183,27 +1063,27 @@ UBYTE SPI_ReadByte(void) {
  * @param value The value to write (0 for low, 1 for high).
  */
 void DEV_GPIO_Write(int pin, int value) {
-    struct gpiod_line *target_line = NULL;
+    DEV_Port *port = NULL;
+    DEV_LINE line = DEV_LINE_CS;
 
     switch (pin) {
         case DEV_RST_PIN:
-            target_line = rst_line;
+            port = &adc_port;
+            line = DEV_LINE_RST;
             break;
         case DEV_CS_PIN:
-            target_line = cs_line;
+            port = &adc_port;
             break;
         case DEV_CS1_PIN:
-            target_line = cs1_line;
+            port = &dac_port;
             break;
         default:
             fprintf(stderr, "DEV_GPIO_Write: Invalid GPIO pin: %d\n", pin);
             return;
     }
 
-    if (target_line) {
-        if (gpiod_line_set_value(target_line, value) < 0) {
-            perror("DEV_GPIO_Write: Failed to set GPIO line value");
-        }
+    if (port->bus) {
+        DEV_Port_SetLine(port, line, value);
     } else {
         fprintf(stderr, "DEV_GPIO_Write: GPIO pin %d not configured or invalid.\n", pin);
     }
@@ -215,41 +1095,489 @@ void DEV_GPIO_Write(int pin, int value) {
  * @return The value of the GPIO pin (0 for low, 1 for high). Returns -1 on error or invalid pin.
  */
 int DEV_GPIO_Read(int pin) {
-    if (pin == DEV_DRDY_PIN && drdy_line) {
-        int value = gpiod_line_get_value(drdy_line);
-        if (value < 0) {
-            perror("DEV_GPIO_Read: Failed to get GPIO line value");
-            return -1; 
-        }
+    if (pin == DEV_DRDY_PIN && adc_port.bus) {
+        int value = default_bus.backend->get_drdy(&adc_port);
+        if (value < 0) atomic_fetch_add_explicit(&default_bus.io.gpio_errors, 1, memory_order_relaxed);
         return value;
     }
     fprintf(stderr, "DEV_GPIO_Read: Invalid or unconfigured pin for reading: %d\n", pin);
     return -1; 
 }
 
+/**
+ * @brief Selects how DEV_Port_DRDY_Wait() waits for a device's DRDY line.
+ *
+ * The DRDY line is released and requested again either as a plain input
+ * (poll mode) or for falling-edge events (event mode).
+ * @param port Target device (DRDY configured).
+ * @param mode The wait mode (DEV_DRDY_MODE_POLL or DEV_DRDY_MODE_EVENT).
+ * @return 0 on success, 1 on failure.
+ */
+static int DEV_Hw_DrdySetMode(DEV_Port *port, DEV_DRDY_MODE mode) {
+    struct gpiod_line *drdy_line = port->drdy_line;
+    int ret;
+
+    if (!drdy_line) {
+        fprintf(stderr, "DEV_DRDY_SetMode: DRDY line not configured.\n");
+        return 1;
+    }
+    if (mode == port->drdy_mode && gpiod_line_is_requested(drdy_line)) {
+        return 0;
+    }
+
+    if (gpiod_line_is_requested(drdy_line)) gpiod_line_release(drdy_line);
+
+    if (mode == DEV_DRDY_MODE_EVENT) {
+        ret = gpiod_line_request_falling_edge_events(drdy_line, "AD-DA");
+    } else {
+        ret = gpiod_line_request_input(drdy_line, "AD-DA");
+    }
+    if (ret < 0) {
+        perror("DEV_DRDY_SetMode: Failed to request DRDY line");
+        // Fall back to the previous configuration so DRDY stays usable
+        if (port->drdy_mode == DEV_DRDY_MODE_EVENT) {
+            gpiod_line_request_falling_edge_events(drdy_line, "AD-DA");
+        } else {
+            gpiod_line_request_input(drdy_line, "AD-DA");
+        }
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Selects how DEV_Port_DRDY_Wait() waits for a device's DRDY line.
+ * @param port Target device.
+ * @param mode The wait mode (DEV_DRDY_MODE_POLL or DEV_DRDY_MODE_EVENT).
+ * @return 0 on success, 1 on failure.
+ */
+int DEV_Port_DRDY_SetMode(DEV_Port *port, DEV_DRDY_MODE mode) {
+    if (!port || !port->bus || port->pins.drdy_pin == DEV_PIN_NONE) {
+        fprintf(stderr, "DEV_DRDY_SetMode: DRDY line not configured.\n");
+        return 1;
+    }
+    if (port->bus->backend->drdy_set_mode(port, mode) != 0) {
+        return 1;
+    }
+
+    port->drdy_mode = mode;
+    Debug("DEV_DRDY_SetMode: DRDY wait mode set to %s\n", mode == DEV_DRDY_MODE_EVENT ? "event" : "poll");
+    return 0;
+}
+
+/**
+ * @brief Selects how DEV_DRDY_Wait() waits for the default ADC's DRDY line.
+ * @param mode The wait mode (DEV_DRDY_MODE_POLL or DEV_DRDY_MODE_EVENT).
+ * @return 0 on success, 1 on failure.
+ */
+int DEV_DRDY_SetMode(DEV_DRDY_MODE mode) {
+    return DEV_Port_DRDY_SetMode(&adc_port, mode);
+}
+
+/**
+ * @brief Returns the active DRDY wait mode of the default ADC port.
+ * @return DEV_DRDY_MODE_POLL or DEV_DRDY_MODE_EVENT.
+ */
+DEV_DRDY_MODE DEV_DRDY_GetMode(void) {
+    return adc_port.drdy_mode;
+}
+
+/**
+ * @brief Busy-polls the DRDY level until it reads low or the timeout expires.
+ * @param port Target device.
+ * @param timeout_us Maximum time to wait, in microseconds.
+ * @param timestamp Optional output for the time DRDY was seen low.
+ * @return 0 when DRDY is low, 1 on timeout, -1 on GPIO error.
+ */
+static int DEV_DRDY_WaitPoll(DEV_Port *port, UDOUBLE timeout_us, struct timespec *timestamp) {
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (;;) {
+        int value = gpiod_line_get_value(port->drdy_line);
+        atomic_fetch_add_explicit(&port->bus->io.gpio_reads, 1, memory_order_relaxed);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (value < 0) {
+            Debug("DEV_DRDY_Wait: Failed to get DRDY line value: %s\n", strerror(errno));
+            return -1;
+        }
+        if (value == LOW) {
+            if (timestamp) *timestamp = now;
+            return 0;
+        }
+        if (DEV_ElapsedUs(&start, &now) >= (long)timeout_us) {
+            return 1;
+        }
+    }
+}
+
+/**
+ * @brief Sleeps on DRDY falling-edge events until DRDY is low or the timeout expires.
+ *
+ * Edges queued while nobody was waiting are drained first. If DRDY is already
+ * low the newest drained edge supplies the timestamp; otherwise the call
+ * blocks in the kernel until the next falling edge.
+ * @param port Target device, DRDY requested for falling-edge events.
+ * @param timeout_us Maximum time to wait, in microseconds.
+ * @param timestamp Optional output for the kernel timestamp of the falling edge.
+ * @return 0 when DRDY is low, 1 on timeout, -1 on GPIO error.
+ */
+static int DEV_DRDY_WaitEvent(DEV_Port *port, UDOUBLE timeout_us, struct timespec *timestamp) {
+    struct gpiod_line *drdy_line = port->drdy_line;
+    DEV_BusIoStats *io = &port->bus->io;
+    struct gpiod_line_event events[DRDY_EVENT_BATCH];
+    struct pollfd pfd = { .fd = gpiod_line_event_get_fd(drdy_line), .events = POLLIN };
+    struct timespec last_edge = {0, 0};
+    int have_edge = 0;
+
+    if (pfd.fd < 0) {
+        Debug("DEV_DRDY_Wait: DRDY line has no event descriptor.\n");
+        return -1;
+    }
+
+    // Drain edges from conversions that completed before this call
+    while (poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN)) {
+        int n = gpiod_line_event_read_multiple(drdy_line, events, DRDY_EVENT_BATCH);
+        atomic_fetch_add_explicit(&io->event_waits, 2, memory_order_relaxed);
+        if (n <= 0) break;
+        last_edge = events[n - 1].ts;
+        have_edge = 1;
+    }
+
+    int value = gpiod_line_get_value(drdy_line);
+    atomic_fetch_add_explicit(&io->event_waits, 1, memory_order_relaxed); // The empty drain poll
+    atomic_fetch_add_explicit(&io->gpio_reads, 1, memory_order_relaxed);
+    if (value < 0) {
+        Debug("DEV_DRDY_Wait: Failed to get DRDY line value: %s\n", strerror(errno));
+        return -1;
+    }
+    if (value == LOW) {
+        if (timestamp) {
+            if (have_edge) *timestamp = last_edge;
+            else clock_gettime(CLOCK_MONOTONIC, timestamp);
+        }
+        return 0;
+    }
+
+    struct timespec timeout = {
+        .tv_sec = timeout_us / 1000000,
+        .tv_nsec = (timeout_us % 1000000) * 1000L,
+    };
+    int ret = gpiod_line_event_wait(drdy_line, &timeout);
+    atomic_fetch_add_explicit(&io->event_waits, ret > 0 ? 2 : 1, memory_order_relaxed);
+    if (ret == 0) {
+        return 1;
+    }
+    if (ret < 0 || gpiod_line_event_read(drdy_line, &events[0]) < 0) {
+        Debug("DEV_DRDY_Wait: Failed to wait for DRDY edge: %s\n", strerror(errno));
+        return -1;
+    }
+    if (timestamp) *timestamp = events[0].ts;
+    return 0;
+}
+
+/**
+ * @brief Waits on a device's DRDY line in its current mode.
+ * @param port Target device.
+ * @param timeout_us Maximum time to wait, in microseconds.
+ * @param timestamp Optional output for the CLOCK_MONOTONIC time DRDY was seen low.
+ * @return 0 when DRDY is low, 1 on timeout, -1 on GPIO error.
+ */
+static int DEV_Hw_DrdyWait(DEV_Port *port, UDOUBLE timeout_us, struct timespec *timestamp) {
+    if (!port->drdy_line) {
+        Debug("DEV_DRDY_Wait: DRDY line not configured.\n");
+        return -1;
+    }
+    if (port->drdy_mode == DEV_DRDY_MODE_EVENT) {
+        return DEV_DRDY_WaitEvent(port, timeout_us, timestamp);
+    }
+    return DEV_DRDY_WaitPoll(port, timeout_us, timestamp);
+}
+
+/**
+ * @brief Waits until a device's DRDY line is low (data ready) or the timeout expires.
+ * @param port Target device.
+ * @param timeout_us Maximum time to wait, in microseconds.
+ * @param timestamp Optional output for the CLOCK_MONOTONIC time DRDY was seen low.
+ * @return 0 when DRDY is low, 1 on timeout, -1 on GPIO error.
+ */
+int DEV_Port_DRDY_Wait(DEV_Port *port, UDOUBLE timeout_us, struct timespec *timestamp) {
+    if (!port || !port->bus || port->pins.drdy_pin == DEV_PIN_NONE) {
+        Debug("DEV_DRDY_Wait: DRDY line not configured.\n");
+        if (port && port->bus) atomic_fetch_add_explicit(&port->bus->io.gpio_errors, 1, memory_order_relaxed);
+        return -1;
+    }
+    int ret = port->bus->backend->drdy_wait(port, timeout_us, timestamp);
+    if (ret < 0) atomic_fetch_add_explicit(&port->bus->io.gpio_errors, 1, memory_order_relaxed);
+    return ret;
+}
+
+/** @brief spidev + libgpiod backend. */
+const DEV_Backend DEV_Backend_Hardware = {
+    .name = "hw",
+    .bus_open = DEV_Hw_BusOpen,
+    .bus_close = DEV_Hw_BusClose,
+    .port_open = DEV_Hw_PortOpen,
+    .port_close = DEV_Hw_PortClose,
+    .transfer = DEV_Hw_Transfer,
+    .set_line = DEV_Hw_SetLine,
+    .get_drdy = DEV_Hw_GetDrdy,
+    .drdy_set_mode = DEV_Hw_DrdySetMode,
+    .drdy_wait = DEV_Hw_DrdyWait,
+};
+
+/*---------------------------------------------------------------------------
+                    RP1 register-mapped GPIO (Raspberry Pi 5)
+---------------------------------------------------------------------------*/
+
+#define RP1_GPIOMEM_DEV      "/dev/gpiomem0" ///< RP1 bank 0 GPIO block, mappable without root
+#define RP1_GPIOMEM_SIZE     0x30000         ///< IO_BANK0, SYS_RIO0 and PADS_BANK0
+#define RP1_GPIO_CHIP_LABEL  "pinctrl-rp1"   ///< Label of the libgpiod chip the block belongs to
+#define RP1_BANK0_GPIOS      28              ///< GPIO0..27 (the 40-pin header)
+#define RP1_IO_BANK0         0x00000         ///< Per-GPIO STATUS/CTRL register pairs
+#define RP1_SYS_RIO0         0x10000         ///< Registered I/O: output, output enable, input
+#define RP1_RIO_OUT          0x0000
+#define RP1_RIO_OE           0x0004
+#define RP1_RIO_IN           0x0008
+#define RP1_RIO_SET          0x2000          ///< Atomic bit-set alias of the RIO registers
+#define RP1_RIO_CLR          0x3000          ///< Atomic bit-clear alias
+#define RP1_CTRL_FUNCSEL     0x1F            ///< GPIOn_CTRL function select field
+#define RP1_FUNCSEL_SYS_RIO  5               ///< Pin driven by SYS_RIO (what the kernel selects for a requested GPIO)
+
+/**
+ * @brief Register mapping of one RP1 bus.
+ */
+typedef struct {
+    int fd;                   ///< /dev/gpiomem0
+    volatile uint32_t *regs;  ///< Mapped GPIO block
+} dev_rp1_t;
+
+/**
+ * @brief Returns one 32-bit register of the mapped block.
+ * @param rp1 Mapping.
+ * @param offset Byte offset in the block.
+ * @return Register.
+ */
+static inline volatile uint32_t *DEV_Rp1_Reg(dev_rp1_t *rp1, UDOUBLE offset) {
+    return &rp1->regs[offset / sizeof(uint32_t)];
+}
+
+/**
+ * @brief Opens the bus as DEV_Backend_Hardware and maps the RP1 GPIO block.
+ *
+ * A failed mapping is not an error: the bus then behaves as the hardware backend.
+ * @param bus Bus object (cleared by the caller).
+ * @param cfg Bus description.
+ * @return 0 on success, 1 on failure.
+ */
+static int DEV_Rp1_BusOpen(DEV_Bus *bus, const DEV_BusConfig *cfg) {
+    const char *label;
+    dev_rp1_t *rp1;
+    void *map;
+
+    if (DEV_Hw_BusOpen(bus, cfg) != 0) return 1;
+
+    label = gpiod_chip_label(bus->gpio_chip);
+    if (!label || strcmp(label, RP1_GPIO_CHIP_LABEL) != 0) {
+        Debug("DEV_Bus_Open: %s is not the RP1 GPIO chip, using libgpiod\n", cfg->gpio_chip);
+        return 0;
+    }
+    rp1 = calloc(1, sizeof(*rp1));
+    if (!rp1) return 0;
+    rp1->fd = open(RP1_GPIOMEM_DEV, O_RDWR | O_SYNC);
+    if (rp1->fd < 0) {
+        fprintf(stderr, "DEV_Bus_Open: Cannot open %s, using libgpiod: ", RP1_GPIOMEM_DEV);
+        perror(NULL);
+        free(rp1);
+        return 0;
+    }
+    map = mmap(NULL, RP1_GPIOMEM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, rp1->fd, 0);
+    if (map == MAP_FAILED) {
+        perror("DEV_Bus_Open: Cannot map the RP1 GPIO block, using libgpiod");
+        close(rp1->fd);
+        free(rp1);
+        return 0;
+    }
+    rp1->regs = map;
+    bus->backend_ctx = rp1;
+    Debug("DEV_Bus_Open: RP1 GPIO registers mapped from %s\n", RP1_GPIOMEM_DEV);
+    return 0;
+}
+
+/**
+ * @brief Unmaps the GPIO block and closes the bus.
+ * @param bus Bus to close.
+ */
+static void DEV_Rp1_BusClose(DEV_Bus *bus) {
+    dev_rp1_t *rp1 = bus->backend_ctx;
+
+    if (rp1) {
+        munmap((void *)rp1->regs, RP1_GPIOMEM_SIZE);
+        close(rp1->fd);
+        free(rp1);
+        bus->backend_ctx = NULL;
+    }
+    DEV_Hw_BusClose(bus);
+}
+
+/**
+ * @brief Checks that a requested pin is under RIO control in the expected direction.
+ * @param rp1 Mapping.
+ * @param pin Pin number, or DEV_PIN_NONE.
+ * @param output Non-zero for an output.
+ * @return 1 if the pin can be accessed through the registers (or is unused), 0 otherwise.
+ */
+static int DEV_Rp1_PinMapped(dev_rp1_t *rp1, int pin, int output) {
+    if (pin == DEV_PIN_NONE) return 1;
+    if (pin < 0 || pin >= RP1_BANK0_GPIOS) return 0;
+
+    uint32_t ctrl = *DEV_Rp1_Reg(rp1, RP1_IO_BANK0 + pin * 8 + 4);
+    uint32_t oe = *DEV_Rp1_Reg(rp1, RP1_SYS_RIO0 + RP1_RIO_OE);
+    return (ctrl & RP1_CTRL_FUNCSEL) == RP1_FUNCSEL_SYS_RIO && !!(oe & (1u << pin)) == !!output;
+}
+
+/**
+ * @brief Requests the lines of a device and enables register access when its pins allow it.
+ *
+ * The lines stay requested through libgpiod, which owns their configuration
+ * and provides DRDY edge events; `port->backend_ctx` is set to the mapping
+ * only when every pin is checked.
+ * @param port Port object (bus and pins already set).
+ * @param cfg Pin assignment.
+ * @return 0 on success, 1 on failure.
+ */
+static int DEV_Rp1_PortOpen(DEV_Port *port, const DEV_PortConfig *cfg) {
+    dev_rp1_t *rp1 = port->bus->backend_ctx;
+
+    if (DEV_Hw_PortOpen(port, cfg) != 0) return 1;
+    if (rp1 && DEV_Rp1_PinMapped(rp1, cfg->rst_pin, 1) && DEV_Rp1_PinMapped(rp1, cfg->cs_pin, 1) &&
+        DEV_Rp1_PinMapped(rp1, cfg->drdy_pin, 0)) {
+        port->backend_ctx = rp1;
+    } else if (rp1) {
+        Debug("DEV_Port_Open: Pins %d/%d/%d not under RIO control, using libgpiod\n",
+              cfg->rst_pin, cfg->cs_pin, cfg->drdy_pin);
+    }
+    return 0;
+}
+
+/**
+ * @brief Releases the lines of a device.
+ * @param port Port to close.
+ */
+static void DEV_Rp1_PortClose(DEV_Port *port) {
+    port->backend_ctx = NULL;
+    DEV_Hw_PortClose(port);
+}
+
+/**
+ * @brief Drives RST or CS with one write to the atomic set/clear alias.
+ *
+ * RP1 sits behind PCIe, where writes are posted; reading RIO_OUT back
+ * guarantees the level is on the pin before the caller starts the SPI
+ * message (or times a reset pulse).
+ * @param port Target device.
+ * @param line Line to drive.
+ * @param value Level.
+ * @return 0 on success, 1 on failure.
+ */
+static int DEV_Rp1_SetLine(DEV_Port *port, DEV_LINE line, int value) {
+    dev_rp1_t *rp1 = port->backend_ctx;
+    int pin = (line == DEV_LINE_RST) ? port->pins.rst_pin : port->pins.cs_pin;
+
+    if (!rp1 || pin == DEV_PIN_NONE) return DEV_Hw_SetLine(port, line, value);
+
+    *DEV_Rp1_Reg(rp1, RP1_SYS_RIO0 + (value ? RP1_RIO_SET : RP1_RIO_CLR)) = 1u << pin;
+    (void)*DEV_Rp1_Reg(rp1, RP1_SYS_RIO0 + RP1_RIO_OUT);
+    atomic_fetch_add_explicit(&port->bus->io.mmio_accesses, 2, memory_order_relaxed);
+    return 0;
+}
+
+/**
+ * @brief Reads the DRDY level from RIO_IN.
+ * @param port Target device.
+ * @return 0 or 1, or -1 on error.
+ */
+static int DEV_Rp1_GetDrdy(DEV_Port *port) {
+    dev_rp1_t *rp1 = port->backend_ctx;
+
+    if (!rp1 || port->pins.drdy_pin == DEV_PIN_NONE) return DEV_Hw_GetDrdy(port);
+
+    atomic_fetch_add_explicit(&port->bus->io.mmio_accesses, 1, memory_order_relaxed);
+    return (*DEV_Rp1_Reg(rp1, RP1_SYS_RIO0 + RP1_RIO_IN) >> port->pins.drdy_pin) & 1;
+}
+
+/**
+ * @brief Waits on DRDY, spinning on RIO_IN in poll mode.
+ * @param port Target device.
+ * @param timeout_us Maximum time to wait, in microseconds.
+ * @param timestamp Optional output for the CLOCK_MONOTONIC time DRDY was seen low.
+ * @return 0 when DRDY is low, 1 on timeout, -1 on GPIO error.
+ */
+static int DEV_Rp1_DrdyWait(DEV_Port *port, UDOUBLE timeout_us, struct timespec *timestamp) {
+    dev_rp1_t *rp1 = port->backend_ctx;
+
+    if (!rp1 || port->drdy_mode == DEV_DRDY_MODE_EVENT) return DEV_Hw_DrdyWait(port, timeout_us, timestamp);
+
+    volatile uint32_t *in = DEV_Rp1_Reg(rp1, RP1_SYS_RIO0 + RP1_RIO_IN);
+    uint32_t mask = 1u << port->pins.drdy_pin;
+    unsigned long reads = 0;
+    struct timespec start, now;
+    int ret;
+
+    clock_gettime(CLOCK_MONOTONIC, &start); // vDSO, no system call
+    for (;;) {
+        uint32_t level = *in & mask;
+        reads++;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (!level) {
+            if (timestamp) *timestamp = now;
+            ret = 0;
+            break;
+        }
+        if (DEV_ElapsedUs(&start, &now) >= (long)timeout_us) {
+            ret = 1;
+            break;
+        }
+    }
+    atomic_fetch_add_explicit(&port->bus->io.mmio_accesses, reads, memory_order_relaxed);
+    return ret;
+}
+
+/** @brief spidev + RP1 register-mapped GPIO backend. */
+const DEV_Backend DEV_Backend_Rp1 = {
+    .name = "rp1",
+    .bus_open = DEV_Rp1_BusOpen,
+    .bus_close = DEV_Rp1_BusClose,
+    .port_open = DEV_Rp1_PortOpen,
+    .port_close = DEV_Rp1_PortClose,
+    .transfer = DEV_Hw_Transfer,
+    .set_line = DEV_Rp1_SetLine,
+    .get_drdy = DEV_Rp1_GetDrdy,
+    .drdy_set_mode = DEV_Hw_DrdySetMode,
+    .drdy_wait = DEV_Rp1_DrdyWait,
+};
+
+/**
+ * @brief Waits until the default ADC's DRDY line is low (data ready) or the timeout expires.
+ * @param timeout_us Maximum time to wait, in microseconds.
+ * @param timestamp Optional output for the CLOCK_MONOTONIC time DRDY was seen low.
+ * @return 0 when DRDY is low, 1 on timeout, -1 on GPIO error.
+ */
+int DEV_DRDY_Wait(UDOUBLE timeout_us, struct timespec *timestamp) {
+    return DEV_Port_DRDY_Wait(&adc_port, timeout_us, timestamp);
+}
+
 /**
  * @brief Cleans up and releases hardware resources.
  *
- * This function releases all requested GPIO lines, closes the GPIO chip handle,
- * and closes the SPI device file descriptor.
+ * This function closes the default ADC and DAC ports and the default bus.
  * It should be called when the application is exiting to ensure proper resource management.
  */
 void DEV_ModuleExit(void) {
     Debug("DEV_ModuleExit: Releasing SPI and GPIO resources...\n");
-    if (rst_line && gpiod_line_is_requested(rst_line)) gpiod_line_release(rst_line);
-    if (cs_line && gpiod_line_is_requested(cs_line)) gpiod_line_release(cs_line);
-    if (cs1_line && gpiod_line_is_requested(cs1_line)) gpiod_line_release(cs1_line);
-    if (drdy_line && gpiod_line_is_requested(drdy_line)) gpiod_line_release(drdy_line);
-    
-    rst_line = cs_line = cs1_line = drdy_line = NULL;
-
-    if (gpio_chip) {
-        gpiod_chip_close(gpio_chip);
-        gpio_chip = NULL;
-    }
-    if (spi_fd >= 0) {
-        close(spi_fd);
-        spi_fd = -1;
-    }
+    DEV_Bus_Flush(&default_bus); // Apply the last queued DAC values
+    DEV_Port_Close(&adc_port);
+    DEV_Port_Close(&dac_port);
+    DEV_Bus_Close(&default_bus);
     Debug("DEV_ModuleExit: SPI and GPIO resources released.\n");
-}
\ No newline at end of file
+}
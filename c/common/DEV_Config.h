@@ -14,7 +14,10 @@
 
 #include <stdint.h> // For uint8_t, uint16_t, uint32_t
 #include <stdio.h>  // For perror, fprintf
+#include <time.h>   // For struct timespec
 #include <gpiod.h>  // For gpiod structures and functions
+#include <pthread.h> // For the per-bus transaction lock
+#include <stdatomic.h> // For the bus scheduler's lock-free fast path
 #include "Debug.h"   // For Debug() macro
 
 // Typedefs for common data sizes
@@ -25,6 +28,7 @@
 /** @name SPI Device Configuration */
 #define SPI_DEVICE      "/dev/spidev0.0" ///< SPI device path
 #define SPI_SPEED_HZ    1800000          ///< SPI clock speed in Hz (1.8 MHz)
+#define SPI_DEVICE_CS1  "/dev/spidev0.1" ///< Node of the second chip select (the DAC8532 in DEV_CS_MODE_NATIVE)
 
 /** @name GPIO Chip Configuration */
 #define GPIO_CHIP_NAME  "gpiochip4"      ///< GPIO chip name (e.g., for Raspberry Pi 5)
@@ -35,6 +39,22 @@
 #define DEV_CS1_PIN     23  ///< DAC Chip Select pin (GPIO23)
 #define DEV_DRDY_PIN    17  ///< ADC Data Ready pin (GPIO17)
 
+/**
+ * @brief How DEV_DRDY_Wait() detects the falling edge of DRDY.
+ */
+typedef enum {
+    DEV_DRDY_MODE_POLL  = 0, ///< Busy-poll the line level (lowest latency, burns a core)
+    DEV_DRDY_MODE_EVENT = 1, ///< Sleep on kernel falling-edge events (frees the core, kernel timestamps)
+} DEV_DRDY_MODE;
+
+/**
+ * @brief Who drives the ADC and DAC chip selects of the default ports.
+ */
+typedef enum {
+    DEV_CS_MODE_GPIO   = 0, ///< User space toggles DEV_CS_PIN/DEV_CS1_PIN around every message (no overlay needed)
+    DEV_CS_MODE_NATIVE = 1, ///< The SPI controller frames each message on SPI_DEVICE/SPI_DEVICE_CS1 (needs the cs-gpios overlay)
+} DEV_CS_MODE;
+
 /** @name GPIO Pin State Definitions */
 #define HIGH            1   ///< GPIO pin high state
 #define LOW             0   ///< GPIO pin low state
@@ -47,6 +67,192 @@
 #define DEV_SPI_WriteByte(_dat) SPI_WriteByte(_dat) ///< Macro to write a byte via SPI
 #define DEV_SPI_ReadByte()      SPI_ReadByte()      ///< Macro to read a byte via SPI
 
+/** @name SPI Message Limits */
+#define DEV_SPI_MAX_SEGMENTS 16 ///< Maximum number of segments in one DEV_SPI_Message() call
+
+/**
+ * @brief One segment of a multi-segment SPI message.
+ *
+ * Each segment maps onto one `struct spi_ioc_transfer`, so a complete command
+ * sequence (e.g. RDATA, the t6 wait, and the 3 data bytes) can be handed to the
+ * kernel as a single ioctl. Either buffer may be NULL: a NULL `tx` clocks out
+ * zeros, a NULL `rx` discards the received bytes.
+ */
+typedef struct {
+    const UBYTE *tx;     ///< Bytes to send, or NULL to send zeros
+    UBYTE *rx;           ///< Buffer for received bytes, or NULL to discard them
+    UDOUBLE len;         ///< Number of bytes in this segment
+    UWORD delay_usecs;   ///< Delay after this segment before the next one starts (microseconds)
+    UBYTE cs_change;     ///< Deassert the controller's native CS between this segment and the next (GPIO chip selects are unaffected)
+} DEV_SPI_Segment;
+
+/** @brief Pin number meaning "not connected" in a DEV_PortConfig. */
+#define DEV_PIN_NONE (-1)
+
+typedef struct DEV_Backend DEV_Backend;
+
+/**
+ * @brief Runtime description of one SPI bus (spidev node + GPIO chip).
+ */
+typedef struct {
+    const char *spi_device;     ///< spidev node, e.g. "/dev/spidev0.0"
+    UDOUBLE spi_speed_hz;       ///< Default SCLK frequency of the bus's devices
+    const char *gpio_chip;      ///< GPIO chip holding the device pins, e.g. "gpiochip4"
+    const DEV_Backend *backend; ///< Backend, or NULL for the one chosen with DEV_Backend_Select()
+    const void *backend_arg;    ///< Backend-specific settings (e.g. a DEV_SimConfig), or NULL
+} DEV_BusConfig;
+
+/** @name Bus scheduler limits */
+#define DEV_BUS_QUEUE_LEN     16        ///< Queued writes per bus (DEV_Port_Submit())
+#define DEV_BUS_JOB_MAX_LEN   4         ///< Bytes per queued write
+#define DEV_BUS_GAP_IDLE_NS   2000000ULL ///< No gap announced for this long: submitters send their own writes
+
+typedef struct DEV_Port DEV_Port;
+
+/**
+ * @brief One queued write: a short, chip-select framed message without a response.
+ */
+typedef struct {
+    DEV_Port *port;                 ///< Target device
+    UBYTE tx[DEV_BUS_JOB_MAX_LEN];  ///< Bytes to send
+    UBYTE len;                      ///< Number of bytes in `tx`
+    uint64_t deadline_ns;           ///< Latest send time (DEV_Now_ns() clock), 0 for none
+} DEV_BusJob;
+
+/**
+ * @brief Bus scheduler counters, see DEV_Bus_GetSchedStats().
+ */
+typedef struct {
+    unsigned long submitted;   ///< Writes accepted by DEV_Port_Submit()
+    unsigned long merged;      ///< Writes that replaced a queued one to the same port and address byte
+    unsigned long rejected;    ///< Writes refused because the queue was full
+    unsigned long sent_in_gap; ///< Writes sent inside a gap announced with DEV_Bus_ServiceGap()
+    unsigned long sent_forced; ///< Writes sent ahead of another transaction (due, or same port) or by DEV_Bus_Flush()
+    unsigned long sent_idle;   ///< Writes sent by the submitter because no gaps were being announced
+    unsigned long late;        ///< Writes sent after their deadline
+    unsigned long failed;      ///< Writes lost to an SPI or chip select error when sent
+    uint64_t job_cost_ns;      ///< Current estimate of the time one write holds the bus
+} DEV_BusSchedStats;
+
+/**
+ * @brief System calls issued on behalf of a bus, see DEV_Bus_GetIoStats().
+ *
+ * The hardware backend counts the calls it makes; the simulator counts the
+ * calls the hardware backend would have made for the same traffic. Line
+ * accesses the RP1 backend makes through its register mapping are not
+ * system calls and are counted in `mmio_accesses` instead. Failures on the
+ * transfer and line paths are counted in `spi_errors` and `gpio_errors`
+ * rather than printed (see Debug()), so a dead bus cannot flood stderr.
+ */
+typedef struct {
+    _Atomic unsigned long spi_messages; ///< SPI_IOC_MESSAGE ioctls
+    _Atomic unsigned long spi_bytes;    ///< Bytes clocked by those messages
+    _Atomic unsigned long gpio_writes;  ///< Line value writes (CS, RST)
+    _Atomic unsigned long gpio_reads;   ///< Line value reads (DRDY polling and level checks)
+    _Atomic unsigned long event_waits;  ///< poll()/read() calls on DRDY edge events
+    _Atomic unsigned long mmio_accesses; ///< GPIO register reads/writes (RP1 backend, no system call)
+    _Atomic unsigned long spi_errors;   ///< SPI messages that failed or were refused
+    _Atomic unsigned long gpio_errors;  ///< Failed line writes, DRDY reads and DRDY waits
+} DEV_BusIoStats;
+
+/**
+ * @brief An open SPI bus shared by one or more DEV_Port devices.
+ *
+ * GPIO chip selects are driven from user space, so a transaction (CS low,
+ * ioctl, CS high) must not interleave with one for another device on the
+ * same bus. `lock` is held for exactly that window; devices on different
+ * buses never contend.
+ */
+typedef struct {
+    int spi_fd;                   ///< spidev file descriptor (-1 when closed)
+    UDOUBLE spi_speed_hz;         ///< SCLK frequency
+    struct gpiod_chip *gpio_chip; ///< GPIO chip used by the bus's ports
+    pthread_mutex_t lock;         ///< Serializes chip-select framed transactions
+    pthread_mutex_t queue_lock;   ///< Protects `jobs`, `num_jobs` updates and `sched`
+    DEV_BusJob jobs[DEV_BUS_QUEUE_LEN]; ///< Queued writes, unordered
+    _Atomic UBYTE num_jobs;       ///< Number of queued writes (read without the lock as a hint)
+    _Atomic uint64_t job_cost_ns; ///< Running estimate of one write's bus time
+    _Atomic uint64_t last_gap_ns; ///< Last DEV_Bus_ServiceGap() call
+    DEV_BusSchedStats sched;      ///< Scheduler counters
+    const DEV_Backend *backend;   ///< Operations of this bus (NULL while closed)
+    void *backend_ctx;            ///< Backend state
+    DEV_BusIoStats io;            ///< System calls made for this bus's devices
+} DEV_Bus;
+
+/**
+ * @brief Runtime pin assignment of one device on a bus (BCM numbering).
+ */
+typedef struct {
+    int rst_pin;  ///< Reset output, or DEV_PIN_NONE
+    int cs_pin;   ///< Chip select output, or DEV_PIN_NONE to rely on the controller's native CS
+    int drdy_pin; ///< Data-ready input, or DEV_PIN_NONE
+    const char *spi_device; ///< spidev node whose native CS selects the device, or NULL for the bus's node
+    UDOUBLE spi_speed_hz;   ///< SCLK for this device's messages, or 0 for the bus's
+} DEV_PortConfig;
+
+/**
+ * @brief One device on a bus: its chip select plus optional RST and DRDY lines.
+ */
+struct DEV_Port {
+    DEV_Bus *bus;                 ///< Bus the device is on
+    DEV_PortConfig pins;          ///< Pin assignment the port was opened with
+    struct gpiod_line *rst_line;  ///< Reset line, or NULL
+    struct gpiod_line *cs_line;   ///< Chip select line, or NULL
+    struct gpiod_line *drdy_line; ///< Data-ready line, or NULL
+    DEV_DRDY_MODE drdy_mode;      ///< How DEV_Port_DRDY_Wait() detects DRDY
+    int spi_fd;                   ///< Own spidev descriptor (DEV_PortConfig::spi_device), or -1
+    UDOUBLE spi_speed_hz;         ///< SCLK for this device's messages, or 0 for the bus's (see DEV_Port_SetSpeed())
+    void *backend_ctx;            ///< Backend state of the device (e.g. its simulated chip)
+};
+
+/**
+ * @brief Output lines a backend drives.
+ */
+typedef enum {
+    DEV_LINE_RST = 0, ///< Reset
+    DEV_LINE_CS  = 1, ///< GPIO chip select
+} DEV_LINE;
+
+/**
+ * @brief Operations behind DEV_Bus and DEV_Port.
+ *
+ * Everything the drivers do on the hardware goes through one of these, so a
+ * bus can run on spidev/gpiod, a simulator or a recorded session. Bus
+ * locking, chip-select framing and the write queue stay in DEV_Config.c;
+ * `transfer` and `set_line` are called with the bus lock held. The generic
+ * layer counts SPI messages in DEV_Bus::io; backends count their line
+ * accesses themselves.
+ */
+struct DEV_Backend {
+    const char *name;
+    int  (*bus_open)(DEV_Bus *bus, const DEV_BusConfig *cfg);   ///< 0 on success
+    void (*bus_close)(DEV_Bus *bus);
+    int  (*port_open)(DEV_Port *port, const DEV_PortConfig *cfg); ///< 0 on success
+    void (*port_close)(DEV_Port *port);
+    /** One SPI message; `port` is the device whose chip select frames it, or NULL for a raw bus message. */
+    int  (*transfer)(DEV_Bus *bus, DEV_Port *port, const DEV_SPI_Segment *segments, UBYTE num_segments);
+    int  (*set_line)(DEV_Port *port, DEV_LINE line, int value);  ///< 0 on success
+    int  (*get_drdy)(DEV_Port *port);                             ///< DRDY level, -1 on error
+    int  (*drdy_set_mode)(DEV_Port *port, DEV_DRDY_MODE mode);    ///< 0 on success
+    int  (*drdy_wait)(DEV_Port *port, UDOUBLE timeout_us, struct timespec *timestamp); ///< As DEV_Port_DRDY_Wait()
+};
+
+/** @brief spidev + libgpiod backend (the default). */
+extern const DEV_Backend DEV_Backend_Hardware;
+
+/**
+ * @brief spidev + RP1 register-mapped GPIO (Raspberry Pi 5).
+ *
+ * Lines are requested through libgpiod as on DEV_Backend_Hardware, which
+ * configures direction and pin function, and the RP1 GPIO block is mapped
+ * from /dev/gpiomem0: CS and RST writes and DRDY reads (including poll-mode
+ * waits) are then single register accesses instead of system calls.
+ * Event-mode waits still sleep on libgpiod edge events. A bus whose GPIO
+ * chip is not the RP1 bank 0, or where the mapping fails, and a port whose
+ * pins are not under RIO control, fall back to libgpiod.
+ */
+extern const DEV_Backend DEV_Backend_Rp1;
+
 /** @name Delay Macro */
 #define DEV_Delay_ms(__xms) DEV_Delay_ms_func(__xms) ///< Macro for millisecond delay
 
@@ -55,7 +261,101 @@
 ---------------------------------------------------------------------------*/
 
 /**
- * @brief Initializes the SPI device and GPIO lines.
+ * @brief Chooses the backend used by DEV_ModuleInit() and by buses opened without one.
+ *
+ * `spec` is one of:
+ * - "hw": spidev and libgpiod (the default);
+ * - "rp1": spidev with RP1 register-mapped GPIO, falling back to libgpiod;
+ * - "sim" or "sim:<time_scale>": the ADS1256/DAC8532 simulator, with DRDY
+ *   timing scaled by `time_scale` (1 = real time, 0 = conversions are ready at once);
+ * - "replay:<file>": answers from a session recorded with "record:";
+ * - "record:<file>[,<spec>]": runs `spec` (default "hw") and records it to `file`.
+ *
+ * Without a call, DEV_ModuleInit() uses the DEV_BACKEND environment variable if set.
+ * @param spec Backend specification.
+ * @return 0 on success, 1 on an unknown specification.
+ */
+int DEV_Backend_Select(const char *spec);
+
+/**
+ * @brief Chooses who drives the chip selects of the ports DEV_ModuleInit() opens.
+ *
+ * In DEV_CS_MODE_NATIVE the ADC is opened on SPI_DEVICE and the DAC on
+ * SPI_DEVICE_CS1 without CS lines: the kernel asserts CS for each message
+ * (and between segments marked `cs_change`), so a complete command is one
+ * ioctl with no GPIO writes. DEV_CS_PIN and DEV_CS1_PIN must then be the
+ * controller's `cs-gpios` (c/overlays/addac-spi0-cs.dts). Without a call,
+ * DEV_ModuleInit() uses the DEV_CS environment variable ("gpio" or "native") if set.
+ * @param mode Chip-select mode.
+ * @return 0 on success, 1 on an invalid mode.
+ */
+int DEV_CS_SetMode(DEV_CS_MODE mode);
+
+/**
+ * @brief Returns the chip-select mode DEV_ModuleInit() uses.
+ * @return DEV_CS_MODE_GPIO or DEV_CS_MODE_NATIVE.
+ */
+DEV_CS_MODE DEV_CS_GetMode(void);
+
+/**
+ * @brief Changes the SCLK frequency of one device's messages.
+ *
+ * Every message carries its own clock, so devices on one bus can run at
+ * different speeds (e.g. the DAC8532 much faster than the ADS1256). Takes
+ * the bus lock, so it never changes the clock of a message in flight.
+ * @param port Open port.
+ * @param speed_hz Clock in Hz, or 0 to use the bus's speed again.
+ * @return 0 on success, 1 if the port is not open.
+ */
+int DEV_Port_SetSpeed(DEV_Port *port, UDOUBLE speed_hz);
+
+/**
+ * @brief Returns the SCLK frequency of a device's messages.
+ * @param port Open port.
+ * @return Its own speed, or the bus's speed when it has none.
+ */
+UDOUBLE DEV_Port_GetSpeed(const DEV_Port *port);
+
+/**
+ * @brief Tells whether the controller frames a port's messages.
+ *
+ * Segments of one DEV_Port_Message() can then be split into separate
+ * chip-select frames with `cs_change`; with a GPIO chip select they cannot.
+ * @param port Open port.
+ * @return 1 for a native chip select, 0 for a GPIO one.
+ */
+int DEV_Port_HasNativeCS(const DEV_Port *port);
+
+/**
+ * @brief Returns the name of the backend DEV_Backend_Select() chose.
+ * @return Backend name, e.g. "hw" or "sim".
+ */
+const char *DEV_Backend_Name(void);
+
+/**
+ * @brief Copies a bus's system call counters.
+ * @param bus Bus to read.
+ * @param stats Receives the counters.
+ */
+void DEV_Bus_GetIoStats(DEV_Bus *bus, DEV_BusIoStats *stats);
+
+/**
+ * @brief Clears a bus's system call counters.
+ * @param bus Bus to reset.
+ */
+void DEV_Bus_ResetIoStats(DEV_Bus *bus);
+
+/**
+ * @brief Returns the bus DEV_ModuleInit() opened.
+ * @return The default bus (not open before DEV_ModuleInit()).
+ */
+DEV_Bus *DEV_GetDefaultBus(void);
+
+/**
+ * @brief Opens the default bus (SPI_DEVICE, GPIO_CHIP_NAME) and the default ADC and DAC ports.
+ *
+ * The single-instance functions below (DEV_SPI_Message(), DEV_GPIO_Write(),
+ * DEV_DRDY_Wait(), ...) operate on these defaults.
  * @return 0 on success, 1 on failure.
  */
 int DEV_ModuleInit(void);
@@ -77,6 +377,26 @@ void SPI_WriteByte(uint8_t value);
  */
 UBYTE SPI_ReadByte(void);
 
+/**
+ * @brief Performs one full-duplex SPI transfer in a single ioctl.
+ * @param tx Bytes to send, or NULL to send zeros.
+ * @param rx Buffer for the received bytes, or NULL to discard them.
+ * @param len Number of bytes to transfer.
+ * @return 0 on success, 1 on failure.
+ */
+int DEV_SPI_Transfer(const UBYTE *tx, UBYTE *rx, UDOUBLE len);
+
+/**
+ * @brief Sends a multi-segment SPI message in a single ioctl.
+ *
+ * Segments are clocked back to back; each segment's `delay_usecs` is inserted
+ * before the next one starts. Chip select handling stays with the caller.
+ * @param segments Array of segments to transfer.
+ * @param num_segments Number of segments (1 to DEV_SPI_MAX_SEGMENTS).
+ * @return 0 on success, 1 on failure.
+ */
+int DEV_SPI_Message(const DEV_SPI_Segment *segments, UBYTE num_segments);
+
 /**
  * @brief Writes a digital value to a specified GPIO pin.
  * @param pin The GPIO pin number (e.g., DEV_RST_PIN).
@@ -91,6 +411,199 @@ void DEV_GPIO_Write(int pin, int value);
  */
 int DEV_GPIO_Read(int pin);
 
+/**
+ * @brief Selects how DEV_DRDY_Wait() waits for the DRDY line.
+ *
+ * Switching to DEV_DRDY_MODE_EVENT re-requests the DRDY line for falling-edge
+ * events; switching back re-requests it as a plain input.
+ * @param mode The wait mode (DEV_DRDY_MODE_POLL or DEV_DRDY_MODE_EVENT).
+ * @return 0 on success, 1 on failure (the previous mode is restored if possible).
+ */
+int DEV_DRDY_SetMode(DEV_DRDY_MODE mode);
+
+/**
+ * @brief Returns the active DRDY wait mode.
+ * @return DEV_DRDY_MODE_POLL or DEV_DRDY_MODE_EVENT.
+ */
+DEV_DRDY_MODE DEV_DRDY_GetMode(void);
+
+/**
+ * @brief Waits until the DRDY line is low (data ready) or the timeout expires.
+ * @param timeout_us Maximum time to wait, in microseconds.
+ * @param timestamp Optional output for the CLOCK_MONOTONIC time DRDY was seen low.
+ *                  In event mode this is the kernel's edge timestamp. May be NULL.
+ * @return 0 when DRDY is low, 1 on timeout, -1 on GPIO error.
+ */
+int DEV_DRDY_Wait(UDOUBLE timeout_us, struct timespec *timestamp);
+
+/**
+ * @brief Opens an SPI bus and its GPIO chip.
+ * @param bus Bus object to initialize.
+ * @param cfg Bus description.
+ * @return 0 on success, 1 on failure.
+ */
+int DEV_Bus_Open(DEV_Bus *bus, const DEV_BusConfig *cfg);
+
+/**
+ * @brief Closes a bus. All ports on it must be closed first.
+ * @param bus Bus to close.
+ */
+void DEV_Bus_Close(DEV_Bus *bus);
+
+/**
+ * @brief Requests the lines of one device on an open bus.
+ *
+ * Outputs start high (CS deasserted, RST released); DRDY starts in poll mode.
+ * @param port Port object to initialize.
+ * @param bus Open bus the device is on.
+ * @param cfg Pin assignment.
+ * @return 0 on success, 1 on failure (no lines are left requested).
+ */
+int DEV_Port_Open(DEV_Port *port, DEV_Bus *bus, const DEV_PortConfig *cfg);
+
+/**
+ * @brief Releases the lines of a device.
+ * @param port Port to close.
+ */
+void DEV_Port_Close(DEV_Port *port);
+
+/**
+ * @brief Sends a multi-segment SPI message to the device, framed by its chip select.
+ *
+ * The bus lock is held from CS assert to CS deassert, so threads driving
+ * different devices on one bus can call this concurrently. Nothing is sent
+ * if CS cannot be asserted.
+ * @param port Target device.
+ * @param segments Array of segments to transfer.
+ * @param num_segments Number of segments (1 to DEV_SPI_MAX_SEGMENTS).
+ * @return 0 on success, 1 on an SPI error or a chip select that could not be driven.
+ */
+int DEV_Port_Message(DEV_Port *port, const DEV_SPI_Segment *segments, UBYTE num_segments);
+
+/**
+ * @brief Queues a short write to the device without waiting for the bus.
+ *
+ * Queued writes are sent earliest deadline first inside the gaps other
+ * drivers on the bus announce with DEV_Bus_ServiceGap() (for the ADS1256: while
+ * it converts). A write still queued when its deadline comes up is sent
+ * ahead of the next transaction on the bus, and any DEV_Port_Message() to
+ * the same port sends that port's queued writes first, so ordering per port
+ * is kept. A write to the same port whose first byte (the DAC8532 channel
+ * command) matches a queued one replaces it: the newest data wins and the
+ * earlier deadline is kept. If no gaps have been announced for
+ * DEV_BUS_GAP_IDLE_NS, the caller sends the queue itself.
+ * @param port Target device.
+ * @param tx Bytes to send.
+ * @param len Number of bytes (1 to DEV_BUS_JOB_MAX_LEN).
+ * @param deadline_ns Latest send time on the DEV_Now_ns() clock, or 0 for none.
+ * @return 0 when queued (or sent), 1 on invalid arguments or a full queue.
+ */
+int DEV_Port_Submit(DEV_Port *port, const UBYTE *tx, UBYTE len, uint64_t deadline_ns);
+
+/**
+ * @brief Sends queued writes that fit before `gap_end_ns`.
+ *
+ * Called by a driver that knows the bus will be idle for a while, e.g.
+ * after starting a conversion and before waiting for its result. Returns
+ * immediately when nothing is queued.
+ * @param bus Bus to service.
+ * @param gap_end_ns Time (DEV_Now_ns() clock) by which the bus must be free again.
+ */
+void DEV_Bus_ServiceGap(DEV_Bus *bus, uint64_t gap_end_ns);
+
+/**
+ * @brief Sends every queued write now.
+ * @param bus Bus to flush.
+ */
+void DEV_Bus_Flush(DEV_Bus *bus);
+
+/**
+ * @brief Copies the bus scheduler counters.
+ * @param bus Bus to read.
+ * @param stats Receives the counters.
+ */
+void DEV_Bus_GetSchedStats(DEV_Bus *bus, DEV_BusSchedStats *stats);
+
+/**
+ * @brief Returns the clock used for bus scheduler deadlines.
+ * @return CLOCK_MONOTONIC_RAW time in nanoseconds.
+ */
+uint64_t DEV_Now_ns(void);
+
+/**
+ * @brief Correlation between CLOCK_MONOTONIC and another clock (CLOCK_REALTIME,
+ *        CLOCK_TAI or a PTP hardware clock).
+ *
+ * Zero-initialize, then call DEV_ClockCorr_Measure() periodically (e.g. once
+ * a second). From the second measurement on, the rate difference between
+ * the clocks is tracked as well, so conversions between measurements follow
+ * NTP/PTP slewing.
+ */
+typedef struct {
+    clockid_t clock;         ///< Target clock
+    uint64_t mono_ns;        ///< CLOCK_MONOTONIC time of the last measurement
+    uint64_t target_ns;      ///< Target clock time at mono_ns
+    uint64_t uncertainty_ns; ///< Half the read window of the last measurement
+    int64_t drift_ppb;       ///< Target clock rate relative to CLOCK_MONOTONIC, in parts per billion
+    UBYTE valid;             ///< Non-zero once a measurement succeeded
+} DEV_ClockCorr;
+
+/**
+ * @brief Measures the offset between CLOCK_MONOTONIC and a target clock.
+ *
+ * The target is read between two CLOCK_MONOTONIC reads, several times; the
+ * tightest window is kept, so preemption during one read does not skew it.
+ * @param corr Correlation to update.
+ * @param clock Target clock, e.g. CLOCK_REALTIME, or FD_TO_CLOCKID() of an open /dev/ptpN.
+ * @return 0 on success, 1 if the clock cannot be read.
+ */
+int DEV_ClockCorr_Measure(DEV_ClockCorr *corr, clockid_t clock);
+
+/**
+ * @brief Converts a CLOCK_MONOTONIC timestamp (e.g. a DRDY time) to the target clock.
+ * @param corr Correlation from DEV_ClockCorr_Measure().
+ * @param mono_ns CLOCK_MONOTONIC time in nanoseconds.
+ * @return Target clock time in nanoseconds, or 0 if no measurement was made.
+ */
+uint64_t DEV_ClockCorr_Convert(const DEV_ClockCorr *corr, uint64_t mono_ns);
+
+/**
+ * @brief Drives the device's reset line.
+ * @param port Target device.
+ * @param value 0 to hold the device in reset, 1 to release it.
+ * @return 0 on success, 1 if the port has no reset line or the GPIO write failed.
+ */
+int DEV_Port_SetReset(DEV_Port *port, int value);
+
+/**
+ * @brief Selects how DEV_Port_DRDY_Wait() waits for the device's DRDY line.
+ * @param port Target device.
+ * @param mode The wait mode (DEV_DRDY_MODE_POLL or DEV_DRDY_MODE_EVENT).
+ * @return 0 on success, 1 on failure (the previous mode is restored if possible).
+ */
+int DEV_Port_DRDY_SetMode(DEV_Port *port, DEV_DRDY_MODE mode);
+
+/**
+ * @brief Waits until the device's DRDY line is low or the timeout expires.
+ * @param port Target device.
+ * @param timeout_us Maximum time to wait, in microseconds.
+ * @param timestamp Optional output for the CLOCK_MONOTONIC time DRDY was seen low.
+ * @return 0 when DRDY is low, 1 on timeout, -1 on GPIO error.
+ */
+int DEV_Port_DRDY_Wait(DEV_Port *port, UDOUBLE timeout_us, struct timespec *timestamp);
+
+/**
+ * @brief Returns the port DEV_ModuleInit() opened for the ADS1256 (DEV_RST_PIN, DEV_CS_PIN, DEV_DRDY_PIN).
+ * @return The default ADC port (not open before DEV_ModuleInit()).
+ */
+DEV_Port *DEV_GetADCPort(void);
+
+/**
+ * @brief Returns the port DEV_ModuleInit() opened for the DAC8532 (DEV_CS1_PIN).
+ * @return The default DAC port (not open before DEV_ModuleInit()).
+ */
+DEV_Port *DEV_GetDACPort(void);
+
 /**
  * @brief Delays execution for a specified number of milliseconds.
  * @param ms The delay time in milliseconds.
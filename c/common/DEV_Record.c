@@ -0,0 +1,682 @@
+/**
+ * @file DEV_Record.c
+ * @brief Session log for DEV_Backend_Record and DEV_Backend_Replay.
+ *
+ * The log starts with the magic "ADRC1" followed by records of a fixed
+ * header (dev_rec_hdr_t, host byte order) and a payload:
+ *
+ * | type            | count        | payload                                     |
+ * |-----------------|--------------|---------------------------------------------|
+ * | BUS_OPEN        | 0            | SPI speed (uint32)                          |
+ * | PORT_OPEN       | 0            | rst, cs, drdy pins (3 x int32)              |
+ * | PORT_CLOSE      | 0            | none                                        |
+ * | TRANSFER        | segments     | per segment: dev_rec_seg_t, tx bytes, rx bytes |
+ * | SET_LINE        | DEV_LINE     | value (int32)                               |
+ * | GET_DRDY        | 0            | none                                        |
+ * | DRDY_MODE       | DEV_DRDY_MODE| none                                        |
+ * | DRDY_WAIT       | 0            | timeout_us (uint32); `t_ns` is the DRDY time |
+ *
+ * `t_ns` is relative to the first bus open. Replay answers each call with
+ * the next record, so it runs as fast as the code above it allows while the
+ * DRDY timestamps keep their recorded spacing.
+ */
+#include "DEV_Record.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define DEV_REC_MAGIC     "ADRC1"
+#define DEV_REC_MAX_PORTS 16
+#define DEV_REC_NO_PORT   0xFF
+#define DEV_REC_BUFSIZE   (1 << 20) ///< stdio buffer of the log
+#define DEV_REC_RESYNC    256       ///< Records searched ahead for the expected operation after a mismatch
+
+/** @brief Record types. */
+typedef enum {
+    DEV_REC_BUS_OPEN = 1,
+    DEV_REC_PORT_OPEN,
+    DEV_REC_PORT_CLOSE,
+    DEV_REC_TRANSFER,
+    DEV_REC_SET_LINE,
+    DEV_REC_GET_DRDY,
+    DEV_REC_DRDY_MODE,
+    DEV_REC_DRDY_WAIT,
+} DEV_REC_TYPE;
+
+/** @brief Header of one record. */
+typedef struct {
+    uint8_t type;      ///< DEV_REC_TYPE
+    uint8_t port;      ///< Port id in open order, DEV_REC_NO_PORT for bus records
+    uint16_t count;    ///< Type-specific, see the file comment
+    int32_t result;    ///< Return value of the operation
+    uint64_t t_ns;     ///< Session time of the operation (DRDY time for DRDY_WAIT)
+    uint32_t size;     ///< Payload bytes that follow
+    uint32_t reserved;
+} dev_rec_hdr_t;
+
+/** @brief Segment descriptor inside a TRANSFER payload. */
+typedef struct {
+    uint32_t len;
+    uint16_t delay_usecs;
+    uint8_t cs_change;
+    uint8_t flags;     ///< DEV_REC_SEG_TX and/or DEV_REC_SEG_RX: which byte arrays follow
+} dev_rec_seg_t;
+
+#define DEV_REC_SEG_TX 0x01
+#define DEV_REC_SEG_RX 0x02
+
+/** @brief The process's session. */
+static struct {
+    pthread_mutex_t lock;
+    FILE *file;
+    int users;                          ///< Open buses
+    uint64_t t0_ns;                     ///< Session start
+    const DEV_Backend *inner;           ///< Recording: backend doing the work
+    DEV_Port *ports[DEV_REC_MAX_PORTS]; ///< Port ids
+    int num_ports;
+    UBYTE *payload;                     ///< Scratch for building or reading payloads
+    size_t payload_cap;
+    DEV_ReplayStats stats;
+} dev_rec = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+/**
+ * @brief Returns the CLOCK_MONOTONIC time.
+ * @return Time in nanoseconds.
+ */
+static uint64_t DEV_Rec_Now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Returns the id of an open port.
+ * @param port Port, or NULL.
+ * @return Id, or DEV_REC_NO_PORT.
+ */
+static uint8_t DEV_Rec_PortId(const DEV_Port *port) {
+    for (int i = 0; port && i < dev_rec.num_ports; i++) {
+        if (dev_rec.ports[i] == port) return (uint8_t)i;
+    }
+    return DEV_REC_NO_PORT;
+}
+
+/**
+ * @brief Makes the payload scratch buffer at least `size` bytes.
+ * @param size Needed size.
+ * @return 0 on success, 1 on allocation failure.
+ */
+static int DEV_Rec_Reserve(size_t size) {
+    if (size <= dev_rec.payload_cap) return 0;
+    UBYTE *p = realloc(dev_rec.payload, size);
+    if (!p) return 1;
+    dev_rec.payload = p;
+    dev_rec.payload_cap = size;
+    return 0;
+}
+
+/**
+ * @brief Appends one record to the log (lock held).
+ * @param hdr Header; `size` gives the payload length.
+ * @param payload Payload, or NULL when `size` is 0.
+ */
+static void DEV_Rec_Write(const dev_rec_hdr_t *hdr, const void *payload) {
+    if (!dev_rec.file) return;
+    if (fwrite(hdr, sizeof(*hdr), 1, dev_rec.file) != 1 ||
+        (hdr->size && fwrite(payload, hdr->size, 1, dev_rec.file) != 1)) {
+        perror("DEV_Record: Failed to write the session log");
+        fclose(dev_rec.file);
+        dev_rec.file = NULL;
+    }
+}
+
+/**
+ * @brief Appends a record.
+ * @param type Record type.
+ * @param port Port, or NULL.
+ * @param count Type-specific count.
+ * @param result Result of the operation.
+ * @param t_ns Absolute CLOCK_MONOTONIC time of the operation.
+ * @param payload Payload, or NULL.
+ * @param size Payload bytes.
+ */
+static void DEV_Rec_Log(DEV_REC_TYPE type, const DEV_Port *port, uint16_t count, int32_t result, uint64_t t_ns,
+                        const void *payload, uint32_t size) {
+    dev_rec_hdr_t hdr = {
+        .type = (uint8_t)type, .port = DEV_Rec_PortId(port), .count = count, .result = result,
+        .t_ns = t_ns - dev_rec.t0_ns, .size = size,
+    };
+    pthread_mutex_lock(&dev_rec.lock);
+    DEV_Rec_Write(&hdr, payload);
+    pthread_mutex_unlock(&dev_rec.lock);
+}
+
+/**
+ * @brief Returns a bus configuration that points at the inner backend.
+ * @param cfg Bus configuration of the recording bus.
+ * @param inner Output for the inner configuration.
+ */
+static void DEV_Rec_InnerConfig(const DEV_BusConfig *cfg, DEV_BusConfig *inner) {
+    const DEV_RecordConfig *rec = cfg->backend_arg;
+    *inner = *cfg;
+    inner->backend = (rec && rec->inner) ? rec->inner : &DEV_Backend_Hardware;
+    inner->backend_arg = rec ? rec->inner_arg : NULL;
+}
+
+/**
+ * @brief Opens the log on the first bus and the bus on the inner backend.
+ * @param bus Bus being opened.
+ * @param cfg Bus description; `backend_arg` is a DEV_RecordConfig.
+ * @return 0 on success, 1 on failure.
+ */
+static int DEV_Rec_BusOpen(DEV_Bus *bus, const DEV_BusConfig *cfg) {
+    const DEV_RecordConfig *rec = cfg->backend_arg;
+    DEV_BusConfig inner;
+
+    if (!rec || !rec->path) {
+        fprintf(stderr, "DEV_Bus_Open: Record backend needs a DEV_RecordConfig\r\n");
+        return 1;
+    }
+    DEV_Rec_InnerConfig(cfg, &inner);
+    if (dev_rec.inner && dev_rec.inner != inner.backend) {
+        fprintf(stderr, "DEV_Bus_Open: All recorded buses must use the same backend\r\n");
+        return 1;
+    }
+    if (inner.backend->bus_open(bus, &inner) != 0) return 1;
+
+    pthread_mutex_lock(&dev_rec.lock);
+    if (dev_rec.users++ == 0) {
+        dev_rec.file = fopen(rec->path, "wb");
+        if (!dev_rec.file) {
+            pthread_mutex_unlock(&dev_rec.lock);
+            fprintf(stderr, "DEV_Bus_Open: Cannot create %s: ", rec->path);
+            perror(NULL);
+            dev_rec.users--;
+            inner.backend->bus_close(bus);
+            return 1;
+        }
+        setvbuf(dev_rec.file, NULL, _IOFBF, DEV_REC_BUFSIZE);
+        fwrite(DEV_REC_MAGIC, 1, strlen(DEV_REC_MAGIC), dev_rec.file);
+        dev_rec.t0_ns = DEV_Rec_Now();
+        dev_rec.num_ports = 0;
+        dev_rec.inner = inner.backend;
+    }
+    pthread_mutex_unlock(&dev_rec.lock);
+
+    uint32_t speed = bus->spi_speed_hz;
+    DEV_Rec_Log(DEV_REC_BUS_OPEN, NULL, 0, 0, DEV_Rec_Now(), &speed, sizeof(speed));
+    Debug("DEV_Bus_Open: Recording %s backend to %s\n", inner.backend->name, rec->path);
+    return 0;
+}
+
+/**
+ * @brief Closes the bus on the inner backend and the log with the last bus.
+ * @param bus Bus to close.
+ */
+static void DEV_Rec_BusClose(DEV_Bus *bus) {
+    dev_rec.inner->bus_close(bus);
+    pthread_mutex_lock(&dev_rec.lock);
+    if (--dev_rec.users == 0) {
+        if (dev_rec.file) fclose(dev_rec.file);
+        dev_rec.file = NULL;
+        dev_rec.inner = NULL;
+    }
+    pthread_mutex_unlock(&dev_rec.lock);
+}
+
+/**
+ * @brief Assigns the next port id (lock taken inside).
+ * @param port Port being opened.
+ * @return 0 on success, 1 if the table is full.
+ */
+static int DEV_Rec_AddPort(DEV_Port *port) {
+    int ret = 0;
+    pthread_mutex_lock(&dev_rec.lock);
+    if (dev_rec.num_ports < DEV_REC_MAX_PORTS) dev_rec.ports[dev_rec.num_ports++] = port;
+    else ret = 1;
+    pthread_mutex_unlock(&dev_rec.lock);
+    if (ret) fprintf(stderr, "DEV_Port_Open: Too many recorded ports\r\n");
+    return ret;
+}
+
+/**
+ * @brief Opens a port on the inner backend and logs it.
+ * @param port Port being opened.
+ * @param cfg Pin assignment.
+ * @return 0 on success, 1 on failure.
+ */
+static int DEV_Rec_PortOpen(DEV_Port *port, const DEV_PortConfig *cfg) {
+    if (dev_rec.inner->port_open(port, cfg) != 0) return 1;
+    if (DEV_Rec_AddPort(port) != 0) {
+        dev_rec.inner->port_close(port);
+        return 1;
+    }
+    int32_t pins[3] = { cfg->rst_pin, cfg->cs_pin, cfg->drdy_pin };
+    DEV_Rec_Log(DEV_REC_PORT_OPEN, port, 0, 0, DEV_Rec_Now(), pins, sizeof(pins));
+    return 0;
+}
+
+/**
+ * @brief Closes a port on the inner backend and logs it.
+ * @param port Port to close.
+ */
+static void DEV_Rec_PortClose(DEV_Port *port) {
+    DEV_Rec_Log(DEV_REC_PORT_CLOSE, port, 0, 0, DEV_Rec_Now(), NULL, 0);
+    dev_rec.inner->port_close(port);
+}
+
+/**
+ * @brief Runs a transfer on the inner backend and logs its tx and rx bytes.
+ * @param bus Bus.
+ * @param port Device framing the message, or NULL.
+ * @param segments Array of segments.
+ * @param num_segments Number of segments.
+ * @return Result of the inner transfer.
+ */
+static int DEV_Rec_Transfer(DEV_Bus *bus, DEV_Port *port, const DEV_SPI_Segment *segments, UBYTE num_segments) {
+    uint64_t t = DEV_Rec_Now();
+    int ret = dev_rec.inner->transfer(bus, port, segments, num_segments);
+    size_t size = 0;
+
+    for (UBYTE i = 0; i < num_segments; i++) {
+        size += sizeof(dev_rec_seg_t) + (segments[i].tx ? segments[i].len : 0) + (segments[i].rx ? segments[i].len : 0);
+    }
+
+    pthread_mutex_lock(&dev_rec.lock);
+    if (DEV_Rec_Reserve(size) == 0) {
+        UBYTE *p = dev_rec.payload;
+        for (UBYTE i = 0; i < num_segments; i++) {
+            const DEV_SPI_Segment *s = &segments[i];
+            dev_rec_seg_t seg = {
+                .len = s->len, .delay_usecs = s->delay_usecs, .cs_change = s->cs_change,
+                .flags = (uint8_t)((s->tx ? DEV_REC_SEG_TX : 0) | (s->rx ? DEV_REC_SEG_RX : 0)),
+            };
+            memcpy(p, &seg, sizeof(seg));
+            p += sizeof(seg);
+            if (s->tx) { memcpy(p, s->tx, s->len); p += s->len; }
+            if (s->rx) { memcpy(p, s->rx, s->len); p += s->len; }
+        }
+        dev_rec_hdr_t hdr = {
+            .type = DEV_REC_TRANSFER, .port = DEV_Rec_PortId(port), .count = num_segments, .result = ret,
+            .t_ns = t - dev_rec.t0_ns, .size = (uint32_t)size,
+        };
+        DEV_Rec_Write(&hdr, dev_rec.payload);
+    }
+    pthread_mutex_unlock(&dev_rec.lock);
+    return ret;
+}
+
+/**
+ * @brief Drives a line on the inner backend and logs it.
+ * @param port Target device.
+ * @param line Line.
+ * @param value Level.
+ * @return Result of the inner call.
+ */
+static int DEV_Rec_SetLine(DEV_Port *port, DEV_LINE line, int value) {
+    int32_t v = value;
+    int ret = dev_rec.inner->set_line(port, line, value);
+    DEV_Rec_Log(DEV_REC_SET_LINE, port, (uint16_t)line, ret, DEV_Rec_Now(), &v, sizeof(v));
+    return ret;
+}
+
+/**
+ * @brief Reads DRDY on the inner backend and logs it.
+ * @param port Target device.
+ * @return DRDY level, -1 on error.
+ */
+static int DEV_Rec_GetDrdy(DEV_Port *port) {
+    int ret = dev_rec.inner->get_drdy(port);
+    DEV_Rec_Log(DEV_REC_GET_DRDY, port, 0, ret, DEV_Rec_Now(), NULL, 0);
+    return ret;
+}
+
+/**
+ * @brief Changes the DRDY mode on the inner backend and logs it.
+ * @param port Target device.
+ * @param mode The wait mode.
+ * @return Result of the inner call.
+ */
+static int DEV_Rec_DrdySetMode(DEV_Port *port, DEV_DRDY_MODE mode) {
+    int ret = dev_rec.inner->drdy_set_mode(port, mode);
+    DEV_Rec_Log(DEV_REC_DRDY_MODE, port, (uint16_t)mode, ret, DEV_Rec_Now(), NULL, 0);
+    return ret;
+}
+
+/**
+ * @brief Waits for DRDY on the inner backend and logs the result and DRDY time.
+ * @param port Target device.
+ * @param timeout_us Maximum time to wait, in microseconds.
+ * @param timestamp Optional output for the time DRDY was seen low.
+ * @return Result of the inner wait.
+ */
+static int DEV_Rec_DrdyWait(DEV_Port *port, UDOUBLE timeout_us, struct timespec *timestamp) {
+    struct timespec ts = {0, 0};
+    uint32_t timeout = timeout_us;
+    int ret = dev_rec.inner->drdy_wait(port, timeout_us, &ts);
+    uint64_t t = (ret == 0) ? (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec : DEV_Rec_Now();
+
+    DEV_Rec_Log(DEV_REC_DRDY_WAIT, port, 0, ret, t, &timeout, sizeof(timeout));
+    if (timestamp) *timestamp = ts;
+    return ret;
+}
+
+const DEV_Backend DEV_Backend_Record = {
+    .name = "record",
+    .bus_open = DEV_Rec_BusOpen,
+    .bus_close = DEV_Rec_BusClose,
+    .port_open = DEV_Rec_PortOpen,
+    .port_close = DEV_Rec_PortClose,
+    .transfer = DEV_Rec_Transfer,
+    .set_line = DEV_Rec_SetLine,
+    .get_drdy = DEV_Rec_GetDrdy,
+    .drdy_set_mode = DEV_Rec_DrdySetMode,
+    .drdy_wait = DEV_Rec_DrdyWait,
+};
+
+/**
+ * @brief Reads one record and its payload into dev_rec.payload (lock held).
+ * @param hdr Output for the header.
+ * @return 0 on success, 1 at the end of the log.
+ */
+static int DEV_Rec_ReadOne(dev_rec_hdr_t *hdr) {
+    if (!dev_rec.file || fread(hdr, sizeof(*hdr), 1, dev_rec.file) != 1) return 1;
+    if (DEV_Rec_Reserve(hdr->size) != 0 ||
+        (hdr->size && fread(dev_rec.payload, hdr->size, 1, dev_rec.file) != 1)) return 1;
+    return 0;
+}
+
+/**
+ * @brief Reads the next record if it matches the expected operation (lock held).
+ *
+ * On a mismatch, up to DEV_REC_RESYNC leftover transfer and DRDY records
+ * are skipped to reach the expected operation, which recovers from a thread
+ * that ran a few more iterations while recording than while replaying (the
+ * stream thread's last scans before it saw the stop request). A replayed
+ * thread that runs longer gets errors from its extra DRDY waits instead.
+ * When nothing matches, the log position is restored so that the records
+ * are still available to the operations that follow. The payload is left in
+ * dev_rec.payload.
+ * @param type Expected type.
+ * @param port Expected port, or NULL.
+ * @param hdr Output for the header.
+ * @return 0 on a match, 1 at the end of the log or on a mismatch (counted as a desync).
+ */
+static int DEV_Rec_Next(DEV_REC_TYPE type, const DEV_Port *port, dev_rec_hdr_t *hdr) {
+    int id = DEV_Rec_PortId(port);
+    long start = dev_rec.file ? ftell(dev_rec.file) : -1;
+    int skipped;
+
+    for (skipped = 0; skipped <= DEV_REC_RESYNC; skipped++) {
+        if (DEV_Rec_ReadOne(hdr) != 0) break;
+        if (hdr->type == type && hdr->port == id) {
+            if (skipped) dev_rec.stats.desyncs++;
+            dev_rec.stats.operations++;
+            return 0;
+        }
+        if (skipped == 0 && dev_rec.stats.desyncs == 0) {
+            fprintf(stderr, "DEV_Replay: Expected record type %d, port %d, log has type %d, port %d\r\n",
+                    type, id, hdr->type, hdr->port);
+        }
+        /* Only leftover data-path records are skipped, and a DRDY wait never
+         * skips: an extra wait must not consume the conversions of a later run. */
+        if (type == DEV_REC_DRDY_WAIT ||
+            (hdr->type != DEV_REC_TRANSFER && hdr->type != DEV_REC_DRDY_WAIT && hdr->type != DEV_REC_GET_DRDY)) break;
+    }
+    if (dev_rec.stats.desyncs++ == 0 && skipped == 0) fprintf(stderr, "DEV_Replay: End of the session log\r\n");
+    if (start >= 0) fseek(dev_rec.file, start, SEEK_SET);
+    return 1;
+}
+
+/**
+ * @brief Closes the session log with the last bus.
+ * @param bus Bus to close.
+ */
+static void DEV_Replay_BusClose(DEV_Bus *bus) {
+    (void)bus;
+    pthread_mutex_lock(&dev_rec.lock);
+    if (--dev_rec.users == 0) {
+        if (dev_rec.file) fclose(dev_rec.file);
+        dev_rec.file = NULL;
+        if (dev_rec.stats.tx_mismatches || dev_rec.stats.desyncs) {
+            fprintf(stderr, "DEV_Replay: %lu operations, %lu tx mismatches, %lu desyncs\r\n",
+                    dev_rec.stats.operations, dev_rec.stats.tx_mismatches, dev_rec.stats.desyncs);
+        }
+    }
+    pthread_mutex_unlock(&dev_rec.lock);
+}
+
+/**
+ * @brief Opens the session log on the first bus.
+ * @param bus Bus being opened.
+ * @param cfg Bus description; `backend_arg` is the log path.
+ * @return 0 on success, 1 on failure.
+ */
+static int DEV_Replay_BusOpen(DEV_Bus *bus, const DEV_BusConfig *cfg) {
+    const char *path = cfg->backend_arg;
+    dev_rec_hdr_t hdr;
+    char magic[sizeof(DEV_REC_MAGIC) - 1];
+    int ret = 0;
+
+    if (!path) {
+        fprintf(stderr, "DEV_Bus_Open: Replay backend needs a log path\r\n");
+        return 1;
+    }
+    pthread_mutex_lock(&dev_rec.lock);
+    if (dev_rec.users == 0) {
+        dev_rec.file = fopen(path, "rb");
+        if (!dev_rec.file || fread(magic, sizeof(magic), 1, dev_rec.file) != 1 ||
+            memcmp(magic, DEV_REC_MAGIC, sizeof(magic)) != 0) {
+            fprintf(stderr, "DEV_Bus_Open: %s is not a session log\r\n", path);
+            if (dev_rec.file) fclose(dev_rec.file);
+            dev_rec.file = NULL;
+            pthread_mutex_unlock(&dev_rec.lock);
+            return 1;
+        }
+        setvbuf(dev_rec.file, NULL, _IOFBF, DEV_REC_BUFSIZE);
+        memset(&dev_rec.stats, 0, sizeof(dev_rec.stats));
+        dev_rec.t0_ns = DEV_Rec_Now();
+        dev_rec.num_ports = 0;
+    }
+    dev_rec.users++;
+    if (DEV_Rec_Next(DEV_REC_BUS_OPEN, NULL, &hdr) != 0) ret = 1;
+    pthread_mutex_unlock(&dev_rec.lock);
+
+    if (ret != 0) {
+        DEV_Replay_BusClose(bus);
+        return 1;
+    }
+    Debug("DEV_Bus_Open: Replaying %s\n", path);
+    return 0;
+}
+
+/**
+ * @brief Matches a port open against the log.
+ * @param port Port being opened.
+ * @param cfg Pin assignment.
+ * @return 0 if the log opens a port with the same pins, 1 otherwise.
+ */
+static int DEV_Replay_PortOpen(DEV_Port *port, const DEV_PortConfig *cfg) {
+    dev_rec_hdr_t hdr;
+    int32_t pins[3] = { cfg->rst_pin, cfg->cs_pin, cfg->drdy_pin };
+    int ret;
+
+    if (DEV_Rec_AddPort(port) != 0) return 1;
+    pthread_mutex_lock(&dev_rec.lock);
+    ret = DEV_Rec_Next(DEV_REC_PORT_OPEN, port, &hdr);
+    if (ret == 0 && (hdr.size != sizeof(pins) || memcmp(dev_rec.payload, pins, sizeof(pins)) != 0)) {
+        fprintf(stderr, "DEV_Replay: Port %d was recorded with other pins\r\n", hdr.port);
+        dev_rec.stats.desyncs++;
+        ret = 1;
+    }
+    pthread_mutex_unlock(&dev_rec.lock);
+    return ret;
+}
+
+/**
+ * @brief Matches a port close against the log.
+ * @param port Port to close.
+ */
+static void DEV_Replay_PortClose(DEV_Port *port) {
+    dev_rec_hdr_t hdr;
+    pthread_mutex_lock(&dev_rec.lock);
+    DEV_Rec_Next(DEV_REC_PORT_CLOSE, port, &hdr);
+    pthread_mutex_unlock(&dev_rec.lock);
+}
+
+/**
+ * @brief Answers a transfer with the recorded rx bytes and compares the tx bytes.
+ * @param bus Bus.
+ * @param port Device framing the message, or NULL.
+ * @param segments Array of segments.
+ * @param num_segments Number of segments.
+ * @return Recorded result, or 1 on a desync.
+ */
+static int DEV_Replay_Transfer(DEV_Bus *bus, DEV_Port *port, const DEV_SPI_Segment *segments, UBYTE num_segments) {
+    dev_rec_hdr_t hdr;
+    int ret = 1;
+    (void)bus;
+
+    pthread_mutex_lock(&dev_rec.lock);
+    if (DEV_Rec_Next(DEV_REC_TRANSFER, port, &hdr) == 0) {
+        const UBYTE *p = dev_rec.payload;
+        const UBYTE *end = p + hdr.size;
+        int mismatch = (hdr.count != num_segments);
+
+        for (UBYTE i = 0; i < num_segments && i < hdr.count && p + sizeof(dev_rec_seg_t) <= end; i++) {
+            const DEV_SPI_Segment *s = &segments[i];
+            dev_rec_seg_t seg;
+            memcpy(&seg, p, sizeof(seg));
+            p += sizeof(seg);
+            size_t need = ((seg.flags & DEV_REC_SEG_TX) ? seg.len : 0) + ((seg.flags & DEV_REC_SEG_RX) ? seg.len : 0);
+            if (p + need > end) break;
+            if (seg.len != s->len) mismatch = 1;
+            UDOUBLE n = seg.len < s->len ? seg.len : s->len;
+            if (seg.flags & DEV_REC_SEG_TX) {
+                if (s->tx ? memcmp(p, s->tx, n) != 0 : 0) mismatch = 1;
+                p += seg.len;
+            } else if (s->tx) {
+                mismatch = 1;
+            }
+            if (seg.flags & DEV_REC_SEG_RX) {
+                if (s->rx) memcpy(s->rx, p, n);
+                p += seg.len;
+            } else if (s->rx) {
+                memset(s->rx, 0, s->len);
+                mismatch = 1;
+            }
+        }
+        if (mismatch) dev_rec.stats.tx_mismatches++;
+        ret = hdr.result;
+    }
+    pthread_mutex_unlock(&dev_rec.lock);
+    return ret;
+}
+
+/**
+ * @brief Matches a line write against the log.
+ * @param port Target device.
+ * @param line Line.
+ * @param value Level.
+ * @return Recorded result, or 1 on a desync.
+ */
+static int DEV_Replay_SetLine(DEV_Port *port, DEV_LINE line, int value) {
+    dev_rec_hdr_t hdr;
+    int ret = 1;
+    atomic_fetch_add_explicit(&port->bus->io.gpio_writes, 1, memory_order_relaxed);
+    pthread_mutex_lock(&dev_rec.lock);
+    if (DEV_Rec_Next(DEV_REC_SET_LINE, port, &hdr) == 0) {
+        int32_t v = 0;
+        if (hdr.size == sizeof(v)) memcpy(&v, dev_rec.payload, sizeof(v));
+        if (hdr.count != line || v != value) dev_rec.stats.tx_mismatches++;
+        ret = hdr.result;
+    }
+    pthread_mutex_unlock(&dev_rec.lock);
+    return ret;
+}
+
+/**
+ * @brief Answers a DRDY read from the log.
+ * @param port Target device.
+ * @return Recorded level, or -1 on a desync.
+ */
+static int DEV_Replay_GetDrdy(DEV_Port *port) {
+    dev_rec_hdr_t hdr;
+    int ret = -1;
+    atomic_fetch_add_explicit(&port->bus->io.gpio_reads, 1, memory_order_relaxed);
+    pthread_mutex_lock(&dev_rec.lock);
+    if (DEV_Rec_Next(DEV_REC_GET_DRDY, port, &hdr) == 0) ret = hdr.result;
+    pthread_mutex_unlock(&dev_rec.lock);
+    return ret;
+}
+
+/**
+ * @brief Matches a DRDY mode change against the log.
+ * @param port Target device.
+ * @param mode The wait mode.
+ * @return Recorded result, or 1 on a desync.
+ */
+static int DEV_Replay_DrdySetMode(DEV_Port *port, DEV_DRDY_MODE mode) {
+    dev_rec_hdr_t hdr;
+    int ret = 1;
+    pthread_mutex_lock(&dev_rec.lock);
+    if (DEV_Rec_Next(DEV_REC_DRDY_MODE, port, &hdr) == 0) {
+        if (hdr.count != mode) dev_rec.stats.tx_mismatches++;
+        ret = hdr.result;
+    }
+    pthread_mutex_unlock(&dev_rec.lock);
+    return ret;
+}
+
+/**
+ * @brief Answers a DRDY wait from the log without waiting.
+ *
+ * Counts one GPIO read (poll mode) or one event wait (event mode) per call.
+ * @param port Target device.
+ * @param timeout_us Maximum time to wait (unused).
+ * @param timestamp Optional output for the recorded DRDY time, rebased to this session.
+ * @return Recorded result, or -1 on a desync.
+ */
+static int DEV_Replay_DrdyWait(DEV_Port *port, UDOUBLE timeout_us, struct timespec *timestamp) {
+    dev_rec_hdr_t hdr;
+    int ret = -1;
+    (void)timeout_us;
+
+    if (port->drdy_mode == DEV_DRDY_MODE_EVENT) atomic_fetch_add_explicit(&port->bus->io.event_waits, 1, memory_order_relaxed);
+    else atomic_fetch_add_explicit(&port->bus->io.gpio_reads, 1, memory_order_relaxed);
+
+    pthread_mutex_lock(&dev_rec.lock);
+    if (DEV_Rec_Next(DEV_REC_DRDY_WAIT, port, &hdr) == 0) {
+        uint64_t t = dev_rec.t0_ns + hdr.t_ns;
+        if (timestamp) {
+            timestamp->tv_sec = (time_t)(t / 1000000000ULL);
+            timestamp->tv_nsec = (long)(t % 1000000000ULL);
+        }
+        ret = hdr.result;
+    }
+    pthread_mutex_unlock(&dev_rec.lock);
+    return ret;
+}
+
+const DEV_Backend DEV_Backend_Replay = {
+    .name = "replay",
+    .bus_open = DEV_Replay_BusOpen,
+    .bus_close = DEV_Replay_BusClose,
+    .port_open = DEV_Replay_PortOpen,
+    .port_close = DEV_Replay_PortClose,
+    .transfer = DEV_Replay_Transfer,
+    .set_line = DEV_Replay_SetLine,
+    .get_drdy = DEV_Replay_GetDrdy,
+    .drdy_set_mode = DEV_Replay_DrdySetMode,
+    .drdy_wait = DEV_Replay_DrdyWait,
+};
+
+/**
+ * @brief Returns the counters of the current replay.
+ * @param stats Receives the counters.
+ */
+void DEV_Replay_GetStats(DEV_ReplayStats *stats) {
+    if (!stats) return;
+    pthread_mutex_lock(&dev_rec.lock);
+    *stats = dev_rec.stats;
+    pthread_mutex_unlock(&dev_rec.lock);
+}
@@ -0,0 +1,56 @@
+/**
+ * @file DEV_Record.h
+ * @brief Record and replay backends: capture a session's bus traffic and play it back.
+ *
+ * DEV_Backend_Record wraps another backend and appends every operation
+ * (port opens, SPI messages with their tx and rx bytes, line writes, DRDY
+ * waits with their results and timestamps) to a log file. DEV_Backend_Replay
+ * answers the same sequence of operations from that log without any
+ * hardware: received bytes, DRDY results and timestamp spacing come from the
+ * recording, so a run captured on a Pi can be re-executed anywhere to
+ * reproduce a problem or compare code changes on identical data. Transmitted
+ * bytes that differ from the recording are counted, not rejected.
+ *
+ * One session is recorded or replayed per process: every bus opened on
+ * these backends shares the log. Single-threaded sessions replay exactly;
+ * for stream runs the number of scans the acquisition thread makes before
+ * it sees the stop request differs between the two runs, and replay
+ * resynchronizes on the next operation of the main thread (the few
+ * operations around each stop are counted as desyncs).
+ */
+#ifndef _DEV_RECORD_H_
+#define _DEV_RECORD_H_
+
+#include "DEV_Config.h"
+
+/**
+ * @brief Argument of DEV_Backend_Record.
+ */
+typedef struct {
+    const char *path;           ///< Log file to create
+    const DEV_Backend *inner;   ///< Backend that does the work (NULL for DEV_Backend_Hardware)
+    const void *inner_arg;      ///< Its backend_arg
+} DEV_RecordConfig;
+
+/**
+ * @brief Counters of a replay.
+ */
+typedef struct {
+    unsigned long operations;   ///< Operations answered from the log
+    unsigned long tx_mismatches;///< SPI messages whose transmitted bytes differ from the recording
+    unsigned long desyncs;      ///< Operations that did not match the next record (resynchronized, or answered with an error)
+} DEV_ReplayStats;
+
+/** @brief Recording backend. Its `backend_arg` is a DEV_RecordConfig. */
+extern const DEV_Backend DEV_Backend_Record;
+
+/** @brief Replay backend. Its `backend_arg` is the path of a log written by DEV_Backend_Record. */
+extern const DEV_Backend DEV_Backend_Replay;
+
+/**
+ * @brief Returns the counters of the current replay.
+ * @param stats Receives the counters.
+ */
+void DEV_Replay_GetStats(DEV_ReplayStats *stats);
+
+#endif // _DEV_RECORD_H_
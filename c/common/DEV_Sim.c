@@ -0,0 +1,947 @@
+/**
+ * @file DEV_Sim.c
+ * @brief ADS1256/DAC8532 simulator behind the DEV_Backend interface.
+ *
+ * The ADS1256 model keeps one conversion timeline: after a restart (reset,
+ * WAKEUP after SYNC or STANDBY, a DRATE write, a calibration) the first
+ * result is ready after the datasheet's settling time and the following
+ * ones every data period. Results are not stored; a result is computed when
+ * it is read, as the input averaged over the filter's settling window, so
+ * MUX changes without SYNC yield the mixed results the real chip gives and
+ * conversions after SYNC are clean. Each MUX change starts a segment of the
+ * input history in which the node voltage relaxes to the new input with
+ * the input's RC time constant.
+ *
+ * Spinning in SPI transfers and DRDY polling, and sleeping in DRDY event
+ * waits, reproduce the CPU and wake-up pattern of the hardware backend.
+ */
+#include "DEV_Sim.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define DEV_SIM_MAX_CHIPS     8   ///< Ports per simulated bus
+#define DEV_SIM_MUX_HISTORY   8   ///< MUX segments kept for the filter window
+#define DEV_SIM_FILTER_POINTS 16  ///< Input samples averaged per conversion
+#define DEV_SIM_NUM_REGS      11
+#define DEV_SIM_FSC_DEFAULT   0x44AC08 ///< Typical full-scale coefficient at gain 1
+
+/** @name ADS1256 registers and commands (as in ADS1256.h, which the HAL does not include) */
+#define REG_STATUS 0
+#define REG_MUX    1
+#define REG_ADCON  2
+#define REG_DRATE  3
+#define REG_IO     4
+#define REG_OFC0   5
+#define REG_OFC1   6
+#define REG_OFC2   7
+#define REG_FSC0   8
+#define REG_FSC1   9
+#define REG_FSC2   10
+#define CMD_WAKEUP   0x00
+#define CMD_RDATA    0x01
+#define CMD_RDATAC   0x03
+#define CMD_SDATAC   0x0F
+#define CMD_RREG     0x10
+#define CMD_WREG     0x50
+#define CMD_SELFCAL  0xF0
+#define CMD_SELFOCAL 0xF1
+#define CMD_SELFGCAL 0xF2
+#define CMD_SYSOCAL  0xF3
+#define CMD_SYSGCAL  0xF4
+#define CMD_SYNC     0xFC
+#define CMD_STANDBY  0xFD
+#define CMD_RESET    0xFE
+
+/**
+ * @brief Data rate, period and first-data settling time of each DRATE code.
+ */
+static const struct {
+    UBYTE code;
+    double sps;
+    double settle_us; ///< SYNC to first DRDY (datasheet, fCLKIN = 7.68 MHz)
+} DEV_Sim_Rates[] = {
+    { 0xF0, 30000, 210 },    { 0xE0, 15000, 250 },    { 0xD0, 7500, 310 },     { 0xC0, 3750, 440 },
+    { 0xB0, 2000, 680 },     { 0xA1, 1000, 1180 },    { 0x92, 500, 2180 },     { 0x82, 100, 10180 },
+    { 0x72, 60, 16840 },     { 0x63, 50, 20180 },     { 0x53, 30, 33510 },     { 0x43, 25, 40180 },
+    { 0x33, 15, 66840 },     { 0x23, 10, 100180 },    { 0x13, 5, 200180 },     { 0x03, 2.5, 400180 },
+};
+
+/** @brief Parser state of the ADS1256 serial interface. */
+typedef enum {
+    DEV_SIM_CMD = 0,   ///< Expecting a command byte
+    DEV_SIM_COUNT,     ///< Expecting the register count of RREG/WREG
+    DEV_SIM_WDATA,     ///< Receiving WREG data
+} DEV_SIM_PARSE;
+
+/** @brief One MUX setting in the input history. */
+typedef struct {
+    uint64_t t_ns;   ///< Time the MUX was written
+    UBYTE mux;       ///< MUX register value
+    double start_v;  ///< Node voltage at that time
+} dev_sim_mux_seg_t;
+
+/** @brief Simulated ADS1256. */
+typedef struct {
+    UBYTE regs[DEV_SIM_NUM_REGS];
+    DEV_SIM_PARSE parse;
+    UBYTE cmd;                     ///< RREG/WREG being processed
+    UBYTE remaining;               ///< WREG bytes still to come
+    UBYTE reg_ptr;                 ///< Next register of RREG/WREG
+    UBYTE out[DEV_SIM_NUM_REGS];   ///< Bytes the chip shifts out next
+    UBYTE out_len;
+    UBYTE out_pos;
+    UBYTE rdatac;                  ///< Read Data Continuous mode
+    UBYTE running;                 ///< Converting (not in reset, SYNC or STANDBY)
+    uint64_t origin_ns;            ///< Completion time of conversion 0 of the timeline
+    uint64_t period_ns;            ///< Data period (0: a conversion is always ready)
+    uint64_t window_ns;            ///< Filter settling window
+    int64_t read_index;            ///< Last conversion read, -1 if none
+    int64_t cached_index;          ///< Conversion whose code is in `cached`
+    int32_t cached;
+    int32_t held;                  ///< Data register content when the timeline restarted
+    dev_sim_mux_seg_t mux_hist[DEV_SIM_MUX_HISTORY];
+    unsigned mux_count;            ///< Segments written (the newest is mux_count - 1)
+} dev_sim_adc_t;
+
+/** @brief Simulated DAC8532. */
+typedef struct {
+    UWORD buffer[2];
+    UWORD output[2];
+    UBYTE frame[3];
+    UBYTE pos;
+} dev_sim_dac_t;
+
+/** @brief One simulated device (the backend_ctx of its port). */
+typedef struct {
+    UBYTE is_adc;
+    UBYTE cs_low;
+    UBYTE late_bit;   ///< Bit carried into the next byte while clocked above its limit
+    dev_sim_adc_t adc;
+    dev_sim_dac_t dac;
+} dev_sim_chip_t;
+
+/** @brief State of a simulated bus (its backend_ctx). */
+typedef struct {
+    DEV_SimConfig cfg;
+    pthread_mutex_t lock;           ///< Protects everything below and the chips
+    dev_sim_chip_t *chips[DEV_SIM_MAX_CHIPS];
+    unsigned rng;
+    uint64_t t0_ns;                 ///< Bus open time, origin of the sine inputs
+} dev_sim_bus_t;
+
+/**
+ * @brief Fills a configuration with defaults.
+ * @param cfg Configuration to initialize.
+ */
+void DEV_Sim_DefaultConfig(DEV_SimConfig *cfg) {
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->time_scale = 1.0;
+    cfg->spi_overhead_ns = 10000;
+    cfg->gpio_cost_ns = 1000;
+    cfg->vref = 2.5;
+    cfg->dac_vref = 5.0;
+    cfg->noise_lsb = 2.0;
+    cfg->adc_max_sclk_hz = 1920000;   // CLKIN / 4
+    cfg->dac_max_sclk_hz = 30000000;
+    cfg->dac_to_ain[0] = DEV_SIM_NO_LOOPBACK;
+    cfg->dac_to_ain[1] = DEV_SIM_NO_LOOPBACK;
+    cfg->seed = 1;
+}
+
+/**
+ * @brief Returns the CLOCK_MONOTONIC time the DRDY timestamps are on.
+ * @return Time in nanoseconds.
+ */
+static uint64_t DEV_Sim_Now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Converts a nanosecond time to a timespec.
+ * @param ns Time in nanoseconds.
+ * @param ts Output.
+ */
+static void DEV_Sim_ToTimespec(uint64_t ns, struct timespec *ts) {
+    ts->tv_sec = (time_t)(ns / 1000000000ULL);
+    ts->tv_nsec = (long)(ns % 1000000000ULL);
+}
+
+/**
+ * @brief Busy-waits until a CLOCK_MONOTONIC time.
+ * @param t_ns Target time.
+ */
+static void DEV_Sim_SpinUntil(uint64_t t_ns) {
+    while (DEV_Sim_Now() < t_ns) {
+    }
+}
+
+/**
+ * @brief Sleeps until a CLOCK_MONOTONIC time.
+ * @param t_ns Target time.
+ */
+static void DEV_Sim_SleepUntil(uint64_t t_ns) {
+    struct timespec ts;
+    DEV_Sim_ToTimespec(t_ns, &ts);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+    }
+}
+
+/**
+ * @brief Scales a chip or bus duration by the configured time scale.
+ * @param sim Bus state.
+ * @param ns Duration on the real board.
+ * @return Simulated duration.
+ */
+static uint64_t DEV_Sim_Scale(const dev_sim_bus_t *sim, double ns) {
+    return (uint64_t)(ns * sim->cfg.time_scale);
+}
+
+/**
+ * @brief Looks up the timing of a DRATE code.
+ * @param code DRATE register value.
+ * @return Table index (30000 SPS for unknown codes).
+ */
+static int DEV_Sim_RateIndex(UBYTE code) {
+    for (unsigned i = 0; i < sizeof(DEV_Sim_Rates) / sizeof(DEV_Sim_Rates[0]); i++) {
+        if (DEV_Sim_Rates[i].code == code) return (int)i;
+    }
+    return 0;
+}
+
+/**
+ * @brief Returns a standard normal sample.
+ * @param sim Bus state (its generator is advanced).
+ * @return Gaussian value with zero mean and unit variance.
+ */
+static double DEV_Sim_Gauss(dev_sim_bus_t *sim) {
+    double u1 = (rand_r(&sim->rng) + 1.0) / ((double)RAND_MAX + 2.0);
+    double u2 = (rand_r(&sim->rng) + 1.0) / ((double)RAND_MAX + 2.0);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+/**
+ * @brief Returns the DAC8532 of a bus.
+ * @param sim Bus state.
+ * @return The first simulated DAC, or NULL.
+ */
+static dev_sim_chip_t *DEV_Sim_FindDac(dev_sim_bus_t *sim) {
+    for (int i = 0; i < DEV_SIM_MAX_CHIPS; i++) {
+        if (sim->chips[i] && !sim->chips[i]->is_adc) return sim->chips[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Returns the voltage of one analog input at a time.
+ * @param sim Bus state.
+ * @param ain MUX nibble (0-7, 8 and above is AINCOM).
+ * @param t_ns Time.
+ * @return Input voltage.
+ */
+static double DEV_Sim_InputVoltage(dev_sim_bus_t *sim, UBYTE ain, uint64_t t_ns) {
+    if (ain > DEV_SIM_AINCOM) ain = DEV_SIM_AINCOM;
+
+    for (int j = 0; j < 2; j++) {
+        if (sim->cfg.dac_to_ain[j] == ain) {
+            dev_sim_chip_t *dac = DEV_Sim_FindDac(sim);
+            if (dac) return dac->dac.output[j] * sim->cfg.dac_vref / 65535.0;
+        }
+    }
+    double v = sim->cfg.input_v[ain];
+    if (sim->cfg.sine_v[ain] != 0) {
+        double t = (double)(int64_t)(t_ns - sim->t0_ns) / 1e9;
+        v += sim->cfg.sine_v[ain] * sin(2.0 * M_PI * sim->cfg.sine_hz[ain] * t);
+    }
+    return v;
+}
+
+/**
+ * @brief Returns the differential voltage a MUX setting selects.
+ * @param sim Bus state.
+ * @param mux MUX register value.
+ * @param t_ns Time.
+ * @return AINP - AINN.
+ */
+static double DEV_Sim_Target(dev_sim_bus_t *sim, UBYTE mux, uint64_t t_ns) {
+    return DEV_Sim_InputVoltage(sim, mux >> 4, t_ns) - DEV_Sim_InputVoltage(sim, mux & 0x0F, t_ns);
+}
+
+/**
+ * @brief Returns the RC time constant after switching to a MUX setting.
+ * @param sim Bus state.
+ * @param mux MUX register value.
+ * @return Scaled time constant in nanoseconds.
+ */
+static double DEV_Sim_Tau(dev_sim_bus_t *sim, UBYTE mux) {
+    UBYTE p = (mux >> 4) > DEV_SIM_AINCOM ? DEV_SIM_AINCOM : (mux >> 4);
+    UBYTE n = (mux & 0x0F) > DEV_SIM_AINCOM ? DEV_SIM_AINCOM : (mux & 0x0F);
+    double tau = sim->cfg.input_tau_us[p] > sim->cfg.input_tau_us[n] ? sim->cfg.input_tau_us[p] : sim->cfg.input_tau_us[n];
+    return tau * 1000.0 * sim->cfg.time_scale;
+}
+
+/**
+ * @brief Returns the voltage in a MUX segment, relaxing from its start value.
+ * @param sim Bus state.
+ * @param seg Segment.
+ * @param t_ns Time at or after the segment start.
+ * @return Node voltage.
+ */
+static double DEV_Sim_SegmentVoltage(dev_sim_bus_t *sim, const dev_sim_mux_seg_t *seg, uint64_t t_ns) {
+    double target = DEV_Sim_Target(sim, seg->mux, t_ns);
+    double tau = DEV_Sim_Tau(sim, seg->mux);
+    if (tau <= 0) return target;
+    double dt = (double)(t_ns - seg->t_ns);
+    return target + (seg->start_v - DEV_Sim_Target(sim, seg->mux, seg->t_ns)) * exp(-dt / tau);
+}
+
+/**
+ * @brief Returns the node voltage the modulator sees at a time.
+ * @param sim Bus state.
+ * @param adc Chip.
+ * @param t_ns Time.
+ * @return Voltage.
+ */
+static double DEV_Sim_NodeVoltage(dev_sim_bus_t *sim, dev_sim_adc_t *adc, uint64_t t_ns) {
+    unsigned oldest = adc->mux_count > DEV_SIM_MUX_HISTORY ? adc->mux_count - DEV_SIM_MUX_HISTORY : 0;
+
+    for (unsigned i = adc->mux_count; i-- > oldest; ) {
+        const dev_sim_mux_seg_t *seg = &adc->mux_hist[i % DEV_SIM_MUX_HISTORY];
+        if (seg->t_ns <= t_ns || i == oldest) {
+            return DEV_Sim_SegmentVoltage(sim, seg, t_ns > seg->t_ns ? t_ns : seg->t_ns);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Records a MUX write in the input history.
+ * @param sim Bus state.
+ * @param adc Chip.
+ * @param mux New MUX value.
+ * @param t_ns Time of the write.
+ */
+static void DEV_Sim_SetMux(dev_sim_bus_t *sim, dev_sim_adc_t *adc, UBYTE mux, uint64_t t_ns) {
+    dev_sim_mux_seg_t seg = { .t_ns = t_ns, .mux = mux };
+    seg.start_v = adc->mux_count ? DEV_Sim_NodeVoltage(sim, adc, t_ns) : DEV_Sim_Target(sim, mux, t_ns);
+    adc->mux_hist[adc->mux_count % DEV_SIM_MUX_HISTORY] = seg;
+    adc->mux_count++;
+    adc->regs[REG_MUX] = mux;
+}
+
+/**
+ * @brief Returns the index of the newest completed conversion.
+ * @param adc Chip.
+ * @param t_ns Time.
+ * @return Conversion index, or -1 if none has completed on the current timeline.
+ */
+static int64_t DEV_Sim_Latest(const dev_sim_adc_t *adc, uint64_t t_ns) {
+    if (!adc->running || t_ns < adc->origin_ns) return -1;
+    if (adc->period_ns == 0) return adc->read_index + 1; // Instant timing: always a fresh result
+    return (int64_t)((t_ns - adc->origin_ns) / adc->period_ns);
+}
+
+/**
+ * @brief Returns whether an unread conversion is available (DRDY low).
+ * @param adc Chip.
+ * @param t_ns Time.
+ * @return 1 if DRDY is low.
+ */
+static int DEV_Sim_Ready(const dev_sim_adc_t *adc, uint64_t t_ns) {
+    int64_t latest = DEV_Sim_Latest(adc, t_ns);
+    return latest >= 0 && latest > adc->read_index;
+}
+
+/**
+ * @brief Computes the code of a conversion.
+ * @param sim Bus state.
+ * @param adc Chip.
+ * @param end_ns Completion time of the conversion.
+ * @return 24-bit two's complement code.
+ */
+static int32_t DEV_Sim_Convert(dev_sim_bus_t *sim, dev_sim_adc_t *adc, uint64_t end_ns) {
+    double v = 0;
+
+    if (adc->window_ns == 0 || end_ns < adc->window_ns) {
+        v = DEV_Sim_NodeVoltage(sim, adc, end_ns);
+    } else {
+        for (int i = 0; i < DEV_SIM_FILTER_POINTS; i++) {
+            uint64_t t = end_ns - adc->window_ns + (adc->window_ns * (2 * i + 1)) / (2 * DEV_SIM_FILTER_POINTS);
+            v += DEV_Sim_NodeVoltage(sim, adc, t);
+        }
+        v /= DEV_SIM_FILTER_POINTS;
+    }
+
+    UBYTE pga = adc->regs[REG_ADCON] & 0x07;
+    double gain = (double)(1 << (pga > 6 ? 6 : pga));
+    double code = v * gain / (2.0 * sim->cfg.vref) * 8388608.0 + sim->cfg.noise_lsb * DEV_Sim_Gauss(sim);
+    if (code > 8388607.0) code = 8388607.0;
+    if (code < -8388608.0) code = -8388608.0;
+    return (int32_t)lround(code);
+}
+
+/**
+ * @brief Returns the data register content and marks it read.
+ * @param sim Bus state.
+ * @param adc Chip.
+ * @param t_ns Time of the read.
+ * @return Code.
+ */
+static int32_t DEV_Sim_ReadData(dev_sim_bus_t *sim, dev_sim_adc_t *adc, uint64_t t_ns) {
+    int64_t latest = DEV_Sim_Latest(adc, t_ns);
+    if (latest < 0) return adc->held;
+    if (latest != adc->cached_index) {
+        uint64_t end = adc->period_ns ? adc->origin_ns + (uint64_t)latest * adc->period_ns : t_ns;
+        adc->cached = DEV_Sim_Convert(sim, adc, end);
+        adc->cached_index = latest;
+    }
+    adc->read_index = latest;
+    return adc->cached;
+}
+
+/**
+ * @brief Latches the data register and restarts the conversion timeline.
+ * @param sim Bus state.
+ * @param adc Chip.
+ * @param t_ns Restart time.
+ * @param first_us Time to the first result on the real chip, or a negative
+ *                 value for the settling time of the current DRATE.
+ */
+static void DEV_Sim_Restart(dev_sim_bus_t *sim, dev_sim_adc_t *adc, uint64_t t_ns, double first_us) {
+    int rate = DEV_Sim_RateIndex(adc->regs[REG_DRATE]);
+
+    if (adc->running && DEV_Sim_Latest(adc, t_ns) >= 0) {
+        int64_t unread = adc->read_index;
+        adc->held = DEV_Sim_ReadData(sim, adc, t_ns);
+        adc->read_index = unread;
+    }
+    if (first_us < 0) first_us = DEV_Sim_Rates[rate].settle_us;
+    adc->period_ns = DEV_Sim_Scale(sim, 1e9 / DEV_Sim_Rates[rate].sps);
+    adc->window_ns = DEV_Sim_Scale(sim, DEV_Sim_Rates[rate].settle_us * 1000.0);
+    adc->origin_ns = t_ns + DEV_Sim_Scale(sim, first_us * 1000.0);
+    adc->read_index = -1;
+    adc->cached_index = -1;
+    adc->running = 1;
+}
+
+/**
+ * @brief Stops conversions (SYNC, STANDBY or RST low), keeping the last result.
+ * @param sim Bus state.
+ * @param adc Chip.
+ * @param t_ns Time.
+ */
+static void DEV_Sim_Halt(dev_sim_bus_t *sim, dev_sim_adc_t *adc, uint64_t t_ns) {
+    if (adc->running && DEV_Sim_Latest(adc, t_ns) >= 0) {
+        adc->held = DEV_Sim_ReadData(sim, adc, t_ns);
+    }
+    adc->running = 0;
+}
+
+/**
+ * @brief Puts the ADS1256 into its power-up state and starts converting.
+ * @param sim Bus state.
+ * @param adc Chip.
+ * @param t_ns Time the reset ends.
+ */
+static void DEV_Sim_ResetAdc(dev_sim_bus_t *sim, dev_sim_adc_t *adc, uint64_t t_ns) {
+    static const UBYTE defaults[DEV_SIM_NUM_REGS] = {
+        0x30, 0x01, 0x20, 0xF0, 0xE0, 0x00, 0x00, 0x00,
+        DEV_SIM_FSC_DEFAULT & 0xFF, (DEV_SIM_FSC_DEFAULT >> 8) & 0xFF, DEV_SIM_FSC_DEFAULT >> 16,
+    };
+    memcpy(adc->regs, defaults, sizeof(defaults));
+    adc->parse = DEV_SIM_CMD;
+    adc->out_len = adc->out_pos = 0;
+    adc->rdatac = 0;
+    adc->held = 0;
+    adc->running = 0;
+    DEV_Sim_SetMux(sim, adc, defaults[REG_MUX], t_ns);
+    DEV_Sim_Restart(sim, adc, t_ns, -1);
+}
+
+/**
+ * @brief Queues a conversion result to be shifted out MSB first.
+ * @param adc Chip.
+ * @param code 24-bit code.
+ */
+static void DEV_Sim_QueueData(dev_sim_adc_t *adc, int32_t code) {
+    adc->out[0] = (UBYTE)(code >> 16);
+    adc->out[1] = (UBYTE)(code >> 8);
+    adc->out[2] = (UBYTE)code;
+    adc->out_len = 3;
+    adc->out_pos = 0;
+}
+
+/**
+ * @brief Applies a register write.
+ * @param sim Bus state.
+ * @param adc Chip.
+ * @param reg Register address.
+ * @param value Written value.
+ * @param t_ns Time.
+ */
+static void DEV_Sim_WriteReg(dev_sim_bus_t *sim, dev_sim_adc_t *adc, UBYTE reg, UBYTE value, uint64_t t_ns) {
+    UBYTE acal = adc->regs[REG_STATUS] & 0x04;
+    int rate = DEV_Sim_RateIndex(adc->regs[REG_DRATE]);
+
+    switch (reg) {
+        case REG_STATUS:
+            adc->regs[REG_STATUS] = (UBYTE)((adc->regs[REG_STATUS] & 0xF1) | (value & 0x0E)); // ID and DRDY are read-only
+            break;
+        case REG_MUX:
+            DEV_Sim_SetMux(sim, adc, value, t_ns);
+            break;
+        case REG_ADCON:
+        case REG_DRATE:
+            adc->regs[reg] = value;
+            // The filter restarts on a new rate; with ACAL a self-calibration runs first
+            DEV_Sim_Restart(sim, adc, t_ns, acal ? 2 * DEV_Sim_Rates[rate].settle_us : -1);
+            break;
+        case REG_IO:
+            adc->regs[REG_IO] = value;
+            break;
+        default:
+            if (reg < DEV_SIM_NUM_REGS) adc->regs[reg] = value;
+            break;
+    }
+}
+
+/**
+ * @brief Shifts one byte through the simulated ADS1256.
+ * @param sim Bus state.
+ * @param adc Chip.
+ * @param in Byte on DIN.
+ * @param t_ns Time the byte completes.
+ * @return Byte on DOUT.
+ */
+static UBYTE DEV_Sim_AdcByte(dev_sim_bus_t *sim, dev_sim_adc_t *adc, UBYTE in, uint64_t t_ns) {
+    UBYTE out = 0;
+
+    if (adc->rdatac) {
+        if (in == CMD_SDATAC) {
+            adc->rdatac = 0;
+        } else if (in == CMD_RESET) {
+            DEV_Sim_ResetAdc(sim, adc, t_ns);
+        } else {
+            if (adc->out_pos >= adc->out_len) DEV_Sim_QueueData(adc, DEV_Sim_ReadData(sim, adc, t_ns));
+            out = adc->out[adc->out_pos++];
+        }
+        return out;
+    }
+
+    if (adc->out_pos < adc->out_len) { // DIN is ignored while a response is shifted out
+        out = adc->out[adc->out_pos++];
+        return out;
+    }
+
+    switch (adc->parse) {
+        case DEV_SIM_COUNT:
+            if (adc->cmd == CMD_RREG) {
+                adc->out_len = 0;
+                adc->out_pos = 0;
+                for (int i = 0; i <= (in & 0x0F) && adc->reg_ptr + i < DEV_SIM_NUM_REGS; i++) {
+                    UBYTE v = adc->regs[adc->reg_ptr + i];
+                    if (adc->reg_ptr + i == REG_STATUS) v = (UBYTE)((v & 0xFE) | !DEV_Sim_Ready(adc, t_ns));
+                    adc->out[adc->out_len++] = v;
+                }
+                adc->parse = DEV_SIM_CMD;
+            } else {
+                adc->remaining = (UBYTE)((in & 0x0F) + 1);
+                adc->parse = DEV_SIM_WDATA;
+            }
+            return out;
+        case DEV_SIM_WDATA:
+            DEV_Sim_WriteReg(sim, adc, adc->reg_ptr++, in, t_ns);
+            if (--adc->remaining == 0) adc->parse = DEV_SIM_CMD;
+            return out;
+        case DEV_SIM_CMD:
+            break;
+    }
+
+    if ((in & 0xF0) == CMD_RREG || (in & 0xF0) == CMD_WREG) {
+        adc->cmd = in & 0xF0;
+        adc->reg_ptr = in & 0x0F;
+        adc->parse = DEV_SIM_COUNT;
+        return out;
+    }
+    switch (in) {
+        case CMD_WAKEUP:
+        case 0xFF:
+            if (!adc->running) DEV_Sim_Restart(sim, adc, t_ns, -1);
+            break;
+        case CMD_RDATA:
+            DEV_Sim_QueueData(adc, DEV_Sim_ReadData(sim, adc, t_ns));
+            break;
+        case CMD_RDATAC:
+            adc->rdatac = 1;
+            DEV_Sim_QueueData(adc, DEV_Sim_ReadData(sim, adc, t_ns));
+            break;
+        case CMD_SYNC:
+        case CMD_STANDBY:
+            DEV_Sim_Halt(sim, adc, t_ns);
+            break;
+        case CMD_RESET:
+            DEV_Sim_ResetAdc(sim, adc, t_ns);
+            break;
+        case CMD_SELFCAL:
+        case CMD_SELFOCAL:
+        case CMD_SELFGCAL:
+        case CMD_SYSOCAL:
+        case CMD_SYSGCAL: {
+            int rate = DEV_Sim_RateIndex(adc->regs[REG_DRATE]);
+            if (in == CMD_SELFCAL || in == CMD_SELFOCAL) memset(&adc->regs[REG_OFC0], 0, 3);
+            if (in == CMD_SYSOCAL) {
+                int32_t offset = DEV_Sim_Convert(sim, adc, t_ns);
+                adc->regs[REG_OFC0] = (UBYTE)offset;
+                adc->regs[REG_OFC1] = (UBYTE)(offset >> 8);
+                adc->regs[REG_OFC2] = (UBYTE)(offset >> 16);
+            }
+            if (in != CMD_SELFOCAL && in != CMD_SYSOCAL) {
+                adc->regs[REG_FSC0] = DEV_SIM_FSC_DEFAULT & 0xFF;
+                adc->regs[REG_FSC1] = (DEV_SIM_FSC_DEFAULT >> 8) & 0xFF;
+                adc->regs[REG_FSC2] = DEV_SIM_FSC_DEFAULT >> 16;
+            }
+            DEV_Sim_Restart(sim, adc, t_ns, 2 * DEV_Sim_Rates[rate].settle_us);
+            break;
+        }
+        default:
+            Debug("DEV_Sim: Unknown ADS1256 command 0x%02X\n", in);
+            break;
+    }
+    return out;
+}
+
+/**
+ * @brief Shifts one byte into the simulated DAC8532.
+ * @param dac Chip.
+ * @param in Byte on DIN.
+ */
+static void DEV_Sim_DacByte(dev_sim_dac_t *dac, UBYTE in) {
+    dac->frame[dac->pos++] = in;
+    if (dac->pos < sizeof(dac->frame)) return;
+
+    UBYTE ctrl = dac->frame[0];
+    UBYTE sel = (ctrl >> 2) & 0x01; // Buffer select: 0 = A, 1 = B
+    dac->buffer[sel] = (UWORD)((dac->frame[1] << 8) | dac->frame[2]);
+    if (ctrl & 0x10) dac->output[0] = dac->buffer[0]; // LDA
+    if (ctrl & 0x20) dac->output[1] = dac->buffer[1]; // LDB
+    dac->pos = 0;
+}
+
+/**
+ * @brief Creates the state of a simulated bus.
+ * @param bus Bus being opened.
+ * @param cfg Bus description; `backend_arg` is a DEV_SimConfig or NULL.
+ * @return 0 on success, 1 on failure.
+ */
+static int DEV_Sim_BusOpen(DEV_Bus *bus, const DEV_BusConfig *cfg) {
+    dev_sim_bus_t *sim = calloc(1, sizeof(*sim));
+    if (!sim) return 1;
+
+    if (cfg->backend_arg) sim->cfg = *(const DEV_SimConfig *)cfg->backend_arg;
+    else DEV_Sim_DefaultConfig(&sim->cfg);
+    pthread_mutex_init(&sim->lock, NULL);
+    sim->rng = sim->cfg.seed;
+    sim->t0_ns = DEV_Sim_Now();
+    bus->backend_ctx = sim;
+    Debug("DEV_Bus_Open: Simulated bus at %u Hz, time scale %g\n", bus->spi_speed_hz, sim->cfg.time_scale);
+    return 0;
+}
+
+/**
+ * @brief Frees the state of a simulated bus.
+ * @param bus Bus to close.
+ */
+static void DEV_Sim_BusClose(DEV_Bus *bus) {
+    dev_sim_bus_t *sim = bus->backend_ctx;
+    if (!sim) return;
+    pthread_mutex_destroy(&sim->lock);
+    free(sim);
+    bus->backend_ctx = NULL;
+}
+
+/**
+ * @brief Attaches a simulated chip to a port: an ADS1256 if it has DRDY, else a DAC8532.
+ * @param port Port being opened.
+ * @param cfg Pin assignment.
+ * @return 0 on success, 1 on failure.
+ */
+static int DEV_Sim_PortOpen(DEV_Port *port, const DEV_PortConfig *cfg) {
+    dev_sim_bus_t *sim = port->bus->backend_ctx;
+    dev_sim_chip_t *chip = calloc(1, sizeof(*chip));
+    int slot = -1;
+
+    if (!chip) return 1;
+    pthread_mutex_lock(&sim->lock);
+    for (int i = 0; i < DEV_SIM_MAX_CHIPS && slot < 0; i++) {
+        if (!sim->chips[i]) slot = i;
+    }
+    if (slot < 0) {
+        pthread_mutex_unlock(&sim->lock);
+        fprintf(stderr, "DEV_Port_Open: Too many simulated devices on one bus\r\n");
+        free(chip);
+        return 1;
+    }
+    chip->is_adc = (cfg->drdy_pin != DEV_PIN_NONE);
+    if (chip->is_adc) DEV_Sim_ResetAdc(sim, &chip->adc, DEV_Sim_Now());
+    sim->chips[slot] = chip;
+    pthread_mutex_unlock(&sim->lock);
+    port->backend_ctx = chip;
+    return 0;
+}
+
+/**
+ * @brief Detaches the simulated chip of a port.
+ * @param port Port to close.
+ */
+static void DEV_Sim_PortClose(DEV_Port *port) {
+    dev_sim_bus_t *sim = port->bus->backend_ctx;
+    pthread_mutex_lock(&sim->lock);
+    for (int i = 0; i < DEV_SIM_MAX_CHIPS; i++) {
+        if (sim->chips[i] == port->backend_ctx) sim->chips[i] = NULL;
+    }
+    pthread_mutex_unlock(&sim->lock);
+    free(port->backend_ctx);
+    port->backend_ctx = NULL;
+}
+
+/**
+ * @brief Clocks one SPI message through the selected chips, taking the time the bus would.
+ * @param bus Simulated bus.
+ * @param port Device framing the message, or NULL for the chips whose CS is low.
+ * @param segments Array of segments.
+ * @param num_segments Number of segments.
+ * @return 0.
+ */
+static int DEV_Sim_Transfer(DEV_Bus *bus, DEV_Port *port, const DEV_SPI_Segment *segments, UBYTE num_segments) {
+    dev_sim_bus_t *sim = bus->backend_ctx;
+    dev_sim_chip_t *targets[DEV_SIM_MAX_CHIPS];
+    int num_targets = 0;
+    UDOUBLE speed = port ? DEV_Port_GetSpeed(port) : (bus->spi_speed_hz ? bus->spi_speed_hz : SPI_SPEED_HZ);
+    double byte_ns = 8e9 / speed;
+    uint64_t start = DEV_Sim_Now();
+    double offset = sim->cfg.spi_overhead_ns;
+
+    pthread_mutex_lock(&sim->lock);
+    if (port) {
+        dev_sim_chip_t *chip = port->backend_ctx;
+        targets[num_targets++] = chip;
+        if (port->pins.cs_pin == DEV_PIN_NONE) { // Native CS frames every message
+            chip->adc.parse = DEV_SIM_CMD;
+            chip->dac.pos = 0;
+            chip->late_bit = 0;
+        }
+    } else {
+        for (int i = 0; i < DEV_SIM_MAX_CHIPS; i++) {
+            if (sim->chips[i] && sim->chips[i]->cs_low) targets[num_targets++] = sim->chips[i];
+        }
+    }
+
+    for (UBYTE s = 0; s < num_segments; s++) {
+        const DEV_SPI_Segment *seg = &segments[s];
+        for (UDOUBLE i = 0; i < seg->len; i++) {
+            UBYTE in = seg->tx ? seg->tx[i] : 0;
+            UBYTE out = 0;
+            offset += byte_ns;
+            uint64_t t = start + DEV_Sim_Scale(sim, offset);
+            for (int c = 0; c < num_targets; c++) {
+                dev_sim_chip_t *chip = targets[c];
+                UDOUBLE limit = chip->is_adc ? sim->cfg.adc_max_sclk_hz : sim->cfg.dac_max_sclk_hz;
+                int late = limit && speed > limit;
+                if (chip->is_adc) {
+                    UBYTE dout = DEV_Sim_AdcByte(sim, &chip->adc, in, t);
+                    if (late) { // DOUT settles after the controller samples it: one bit behind
+                        UBYTE carry = dout & 1;
+                        dout = (UBYTE)((chip->late_bit << 7) | (dout >> 1));
+                        chip->late_bit = carry;
+                    }
+                    out |= dout;
+                } else {
+                    UBYTE din = in;
+                    if (late) { // DIN sampled a bit late
+                        UBYTE carry = in & 1;
+                        din = (UBYTE)((chip->late_bit << 7) | (in >> 1));
+                        chip->late_bit = carry;
+                    }
+                    DEV_Sim_DacByte(&chip->dac, din);
+                }
+            }
+            if (seg->rx) seg->rx[i] = out;
+        }
+        offset += seg->delay_usecs * 1000.0;
+        if (port && port->pins.cs_pin == DEV_PIN_NONE && seg->cs_change && s + 1 < num_segments) {
+            targets[0]->adc.parse = DEV_SIM_CMD; // Native CS pulses high: a new frame starts
+            targets[0]->dac.pos = 0;
+        }
+    }
+    pthread_mutex_unlock(&sim->lock);
+
+    DEV_Sim_SpinUntil(start + DEV_Sim_Scale(sim, offset));
+    return 0;
+}
+
+/**
+ * @brief Drives RST or CS of a simulated chip.
+ * @param port Target device.
+ * @param line Line.
+ * @param value Level.
+ * @return 0.
+ */
+static int DEV_Sim_SetLine(DEV_Port *port, DEV_LINE line, int value) {
+    dev_sim_bus_t *sim = port->bus->backend_ctx;
+    dev_sim_chip_t *chip = port->backend_ctx;
+    uint64_t now = DEV_Sim_Now();
+
+    atomic_fetch_add_explicit(&port->bus->io.gpio_writes, 1, memory_order_relaxed);
+    pthread_mutex_lock(&sim->lock);
+    if (line == DEV_LINE_CS) {
+        if (!value && !chip->cs_low) { // CS falling edge resets the serial interface
+            chip->adc.parse = DEV_SIM_CMD;
+            chip->adc.out_len = chip->adc.out_pos = 0;
+            chip->dac.pos = 0;
+            chip->late_bit = 0;
+        }
+        chip->cs_low = !value;
+    } else if (chip->is_adc) {
+        if (!value) DEV_Sim_Halt(sim, &chip->adc, now);
+        else if (!chip->adc.running) DEV_Sim_ResetAdc(sim, &chip->adc, now);
+    }
+    pthread_mutex_unlock(&sim->lock);
+    DEV_Sim_SpinUntil(now + DEV_Sim_Scale(sim, sim->cfg.gpio_cost_ns));
+    return 0;
+}
+
+/**
+ * @brief Returns the DRDY level of a simulated ADS1256.
+ * @param port Target device.
+ * @return 0 when a result is ready, 1 otherwise, -1 for a chip without DRDY.
+ */
+static int DEV_Sim_GetDrdy(DEV_Port *port) {
+    dev_sim_bus_t *sim = port->bus->backend_ctx;
+    dev_sim_chip_t *chip = port->backend_ctx;
+    int ready;
+
+    atomic_fetch_add_explicit(&port->bus->io.gpio_reads, 1, memory_order_relaxed);
+    if (!chip->is_adc) return -1;
+    pthread_mutex_lock(&sim->lock);
+    ready = DEV_Sim_Ready(&chip->adc, DEV_Sim_Now());
+    pthread_mutex_unlock(&sim->lock);
+    return ready ? LOW : HIGH;
+}
+
+/**
+ * @brief Accepts either DRDY mode.
+ * @param port Target device.
+ * @param mode The wait mode.
+ * @return 0 for an ADS1256, 1 otherwise.
+ */
+static int DEV_Sim_DrdySetMode(DEV_Port *port, DEV_DRDY_MODE mode) {
+    dev_sim_chip_t *chip = port->backend_ctx;
+    (void)mode;
+    return chip->is_adc ? 0 : 1;
+}
+
+/**
+ * @brief Waits for the next simulated DRDY edge.
+ *
+ * Poll mode spins until the edge and reports when it was seen; event mode
+ * sleeps and reports the edge time, as the kernel timestamp would. The IO
+ * counters get the calls DEV_Backend_Hardware would have made.
+ * @param port Target device.
+ * @param timeout_us Maximum time to wait, in microseconds.
+ * @param timestamp Optional output for the CLOCK_MONOTONIC time of DRDY.
+ * @return 0 when DRDY is low, 1 on timeout, -1 for a chip without DRDY.
+ */
+static int DEV_Sim_DrdyWait(DEV_Port *port, UDOUBLE timeout_us, struct timespec *timestamp) {
+    dev_sim_bus_t *sim = port->bus->backend_ctx;
+    dev_sim_chip_t *chip = port->backend_ctx;
+    DEV_BusIoStats *io = &port->bus->io;
+    int event = (port->drdy_mode == DEV_DRDY_MODE_EVENT);
+    uint64_t now = DEV_Sim_Now();
+    uint64_t deadline = now + (uint64_t)timeout_us * 1000ULL;
+    uint64_t edge = UINT64_MAX;
+    int ready;
+
+    if (!chip->is_adc) return -1;
+    pthread_mutex_lock(&sim->lock);
+    dev_sim_adc_t *adc = &chip->adc;
+    ready = DEV_Sim_Ready(adc, now);
+    if (ready) {
+        int64_t latest = DEV_Sim_Latest(adc, now);
+        edge = adc->period_ns ? adc->origin_ns + (uint64_t)latest * adc->period_ns : now;
+    } else if (adc->running) {
+        edge = adc->period_ns ? adc->origin_ns + (uint64_t)(adc->read_index + 1) * adc->period_ns : now;
+        if (edge < adc->origin_ns) edge = adc->origin_ns;
+    }
+    pthread_mutex_unlock(&sim->lock);
+
+    if (event) {
+        atomic_fetch_add_explicit(&io->event_waits, ready ? 3 : 1, memory_order_relaxed); // Drain (+ read), empty poll
+        atomic_fetch_add_explicit(&io->gpio_reads, 1, memory_order_relaxed);
+    }
+    if (!ready) {
+        uint64_t until = edge < deadline ? edge : deadline;
+        if (event) DEV_Sim_SleepUntil(until);
+        else DEV_Sim_SpinUntil(until);
+        if (event) atomic_fetch_add_explicit(&io->event_waits, edge <= deadline ? 2 : 1, memory_order_relaxed);
+        if (edge > deadline) {
+            if (!event) atomic_fetch_add_explicit(&io->gpio_reads, 1 + (until - now) / (sim->cfg.gpio_cost_ns + 1),
+                                                  memory_order_relaxed);
+            return 1;
+        }
+    }
+    if (!event) {
+        uint64_t seen = DEV_Sim_Now();
+        atomic_fetch_add_explicit(&io->gpio_reads, 1 + (seen - now) / (sim->cfg.gpio_cost_ns + 1), memory_order_relaxed);
+        edge = seen;
+    }
+    if (timestamp) DEV_Sim_ToTimespec(edge, timestamp);
+    return 0;
+}
+
+const DEV_Backend DEV_Backend_Sim = {
+    .name = "sim",
+    .bus_open = DEV_Sim_BusOpen,
+    .bus_close = DEV_Sim_BusClose,
+    .port_open = DEV_Sim_PortOpen,
+    .port_close = DEV_Sim_PortClose,
+    .transfer = DEV_Sim_Transfer,
+    .set_line = DEV_Sim_SetLine,
+    .get_drdy = DEV_Sim_GetDrdy,
+    .drdy_set_mode = DEV_Sim_DrdySetMode,
+    .drdy_wait = DEV_Sim_DrdyWait,
+};
+
+/**
+ * @brief Changes the DC level of an input of a simulated bus.
+ * @param bus Bus opened on DEV_Backend_Sim.
+ * @param ain Input (0-7, or DEV_SIM_AINCOM).
+ * @param volts New level.
+ * @return 0 on success, 1 if the bus is not simulated or the input is invalid.
+ */
+int DEV_Sim_SetInput(DEV_Bus *bus, UBYTE ain, double volts) {
+    if (!bus || bus->backend != &DEV_Backend_Sim || ain >= DEV_SIM_INPUTS) return 1;
+    dev_sim_bus_t *sim = bus->backend_ctx;
+    pthread_mutex_lock(&sim->lock);
+    sim->cfg.input_v[ain] = volts;
+    pthread_mutex_unlock(&sim->lock);
+    return 0;
+}
+
+/**
+ * @brief Returns a DAC8532 output of a simulated bus.
+ * @param bus Bus opened on DEV_Backend_Sim.
+ * @param channel 0 for output A, 1 for output B.
+ * @return Output voltage, or 0 if the bus is not simulated or no DAC was opened.
+ */
+double DEV_Sim_GetDacOutput(DEV_Bus *bus, UBYTE channel) {
+    double v = 0;
+    if (!bus || bus->backend != &DEV_Backend_Sim || channel > 1) return 0;
+    dev_sim_bus_t *sim = bus->backend_ctx;
+    pthread_mutex_lock(&sim->lock);
+    dev_sim_chip_t *dac = DEV_Sim_FindDac(sim);
+    if (dac) v = dac->dac.output[channel] * sim->cfg.dac_vref / 65535.0;
+    pthread_mutex_unlock(&sim->lock);
+    return v;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file DEV_Sim.h
+ * @brief Hardware-free backend simulating the ADS1256 and DAC8532 of the AD/DA board.
+ *
+ * A bus opened on DEV_Backend_Sim (e.g. with DEV_Backend_Select("sim") before
+ * DEV_ModuleInit()) answers SPI traffic and line changes the way the board
+ * would, so the drivers, the stream engine and the examples run unchanged
+ * on any Linux machine:
+ *
+ * - A port with a DRDY pin is an ADS1256: register file with reset values,
+ *   command parser (RREG/WREG, RDATA, RDATAC/SDATAC, SYNC/WAKEUP, STANDBY,
+ *   RESET, calibrations), conversions on the datasheet timeline (first DRDY
+ *   after the filter settling time, then one per data period), a digital
+ *   filter that averages the input over its settling window, an RC settling
+ *   model per input and Gaussian noise.
+ * - A port without DRDY is a DAC8532: 24-bit writes fill buffer A/B and the
+ *   load bits update the outputs, which can be looped back to an ADC input.
+ * - Messages clocked faster than a chip's SCLK limit are corrupted by one
+ *   bit of lag, so clock probes see the failures they would on hardware.
+ *
+ * All chip timing is multiplied by `time_scale`: 1 reproduces the real
+ * DRDY cadence and SPI clocking (waits spin or sleep as the hardware
+ * backend would), 0 makes every conversion ready at once for the cheapest
+ * possible functional runs. The bus's DEV_BusIoStats count the system calls
+ * the hardware backend would have made for the same traffic.
+ */
+#ifndef _DEV_SIM_H_
+#define _DEV_SIM_H_
+
+#include "DEV_Config.h"
+
+#define DEV_SIM_INPUTS      9    ///< AIN0..AIN7 and AINCOM
+#define DEV_SIM_AINCOM      8    ///< Index of AINCOM in the input arrays
+#define DEV_SIM_NO_LOOPBACK 0xFF ///< DEV_SimConfig::dac_to_ain entry for an unconnected DAC output
+
+/**
+ * @brief Simulated board. Fill with DEV_Sim_DefaultConfig().
+ */
+typedef struct {
+    double time_scale;                     ///< Multiplier on all chip and bus timing (1 = real time, 0 = instant)
+    UDOUBLE spi_overhead_ns;               ///< Fixed cost of one SPI message (the ioctl round trip)
+    UDOUBLE gpio_cost_ns;                  ///< Cost of one line read while polling DRDY
+    double vref;                           ///< ADS1256 reference voltage (the board uses 2.5 V)
+    double dac_vref;                       ///< DAC8532 reference voltage (the board uses 5 V)
+    double input_v[DEV_SIM_INPUTS];        ///< DC level of each input, volts
+    double sine_v[DEV_SIM_INPUTS];         ///< Amplitude of a sine added to each input, volts
+    double sine_hz[DEV_SIM_INPUTS];        ///< Frequency of that sine
+    double input_tau_us[DEV_SIM_INPUTS];   ///< RC time constant seen after the MUX switches to the input
+    double noise_lsb;                      ///< RMS noise added to each conversion, in codes
+    UDOUBLE adc_max_sclk_hz;               ///< Above this SCLK the ADS1256's DOUT lags one bit (0 = no limit)
+    UDOUBLE dac_max_sclk_hz;               ///< Above this SCLK the DAC8532 latches DIN one bit late (0 = no limit)
+    UBYTE dac_to_ain[2];                   ///< Input driven by DAC output A/B, or DEV_SIM_NO_LOOPBACK
+    unsigned seed;                         ///< Noise generator seed (runs are reproducible)
+} DEV_SimConfig;
+
+/** @brief ADS1256/DAC8532 simulator backend. Its `backend_arg` is a DEV_SimConfig, or NULL for the defaults. */
+extern const DEV_Backend DEV_Backend_Sim;
+
+/**
+ * @brief Fills a configuration with defaults: real time, 10 us per SPI
+ *        message, 1 us per GPIO read, all inputs at 0 V without settling
+ *        delay, 2 codes of noise, no DAC loopback, SCLK limits of
+ *        1.92 MHz (ADS1256, CLKIN/4) and 30 MHz (DAC8532).
+ * @param cfg Configuration to initialize.
+ */
+void DEV_Sim_DefaultConfig(DEV_SimConfig *cfg);
+
+/**
+ * @brief Changes the DC level of an input of a simulated bus.
+ * @param bus Bus opened on DEV_Backend_Sim.
+ * @param ain Input (0-7, or DEV_SIM_AINCOM).
+ * @param volts New level.
+ * @return 0 on success, 1 if the bus is not simulated or the input is invalid.
+ */
+int DEV_Sim_SetInput(DEV_Bus *bus, UBYTE ain, double volts);
+
+/**
+ * @brief Returns a DAC8532 output of a simulated bus.
+ * @param bus Bus opened on DEV_Backend_Sim.
+ * @param channel 0 for output A, 1 for output B.
+ * @return Output voltage, or 0 if the bus is not simulated or no DAC was opened.
+ */
+double DEV_Sim_GetDacOutput(DEV_Bus *bus, UBYTE channel);
+
+#endif // _DEV_SIM_H_
@@ -0,0 +1,137 @@
+/**
+ * @file LatencyHist.c
+ * @brief Lock-free log-linear latency histograms (readers and reset).
+ *
+ * The recording side is inline in LatencyHist.h.
+ */
+#include "LatencyHist.h"
+#include <stdio.h>
+
+/**
+ * @brief Returns the largest value that maps to a bucket.
+ * @param index Bucket index.
+ * @return Upper edge of the bucket in nanoseconds.
+ */
+static uint64_t LatencyHist_BucketMax(unsigned index)
+{
+    if (index < (1u << LATENCY_HIST_SUB_BITS)) return index;
+
+    unsigned shift = (index >> LATENCY_HIST_SUB_BITS) - 1;
+    uint64_t sub = (index & ((1u << LATENCY_HIST_SUB_BITS) - 1)) | (1u << LATENCY_HIST_SUB_BITS);
+    return ((sub + 1) << shift) - 1;
+}
+
+/**
+ * @brief Empties a histogram.
+ * @param hist Histogram to clear.
+ */
+void LatencyHist_Reset(latency_hist_t *hist)
+{
+    for (unsigned i = 0; i < LATENCY_HIST_BUCKETS; i++) {
+        atomic_store_explicit(&hist->counts[i], 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&hist->count, 0, memory_order_relaxed);
+    atomic_store_explicit(&hist->sum_ns, 0, memory_order_relaxed);
+    atomic_store_explicit(&hist->min_ns, 0, memory_order_relaxed);
+    atomic_store_explicit(&hist->max_ns, 0, memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the number of samples recorded.
+ * @param hist Histogram to read.
+ * @return Sample count.
+ */
+uint64_t LatencyHist_Count(const latency_hist_t *hist)
+{
+    return atomic_load_explicit(&hist->count, memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the value below which a given percentage of samples fall.
+ * @param hist Histogram to read.
+ * @param percentile Percentile, 0.0 to 100.0.
+ * @return Value in nanoseconds, 0 if the histogram is empty.
+ */
+uint64_t LatencyHist_Percentile(const latency_hist_t *hist, double percentile)
+{
+    uint64_t total = 0;
+    uint64_t min_ns = atomic_load_explicit(&hist->min_ns, memory_order_relaxed);
+    uint64_t max_ns = atomic_load_explicit(&hist->max_ns, memory_order_relaxed);
+
+    // Sum the buckets instead of using `count`, so the rank matches this snapshot
+    for (unsigned i = 0; i < LATENCY_HIST_BUCKETS; i++) {
+        total += atomic_load_explicit(&hist->counts[i], memory_order_relaxed);
+    }
+    if (total == 0) return 0;
+
+    if (percentile <= 0.0) return min_ns;
+    if (percentile >= 100.0) return max_ns;
+
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)total + 0.5);
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < LATENCY_HIST_BUCKETS; i++) {
+        seen += atomic_load_explicit(&hist->counts[i], memory_order_relaxed);
+        if (seen >= rank) {
+            uint64_t value = LatencyHist_BucketMax(i);
+            if (value > max_ns) value = max_ns;
+            if (value < min_ns) value = min_ns;
+            return value;
+        }
+    }
+    return max_ns; // Buckets grew while scanning
+}
+
+/**
+ * @brief Counts the samples at or below each of a set of bounds.
+ * @param hist Histogram to read.
+ * @param bounds_ns Ascending upper bounds in nanoseconds.
+ * @param n Number of bounds.
+ * @param out Receives `n` cumulative counts.
+ * @return Total samples in the snapshot.
+ */
+uint64_t LatencyHist_Cumulative(const latency_hist_t *hist, const uint64_t *bounds_ns, unsigned n, uint64_t *out)
+{
+    uint64_t total = 0;
+    unsigned b = 0;
+
+    for (unsigned i = 0; i < LATENCY_HIST_BUCKETS; i++) {
+        uint64_t edge = LatencyHist_BucketMax(i);
+        for (; b < n && bounds_ns[b] < edge; b++) out[b] = total;
+        total += atomic_load_explicit(&hist->counts[i], memory_order_relaxed);
+    }
+    for (; b < n; b++) out[b] = total;
+    return total;
+}
+
+/**
+ * @brief Returns the mean of the recorded samples.
+ * @param hist Histogram to read.
+ * @return Mean in nanoseconds, 0 if the histogram is empty.
+ */
+double LatencyHist_Mean(const latency_hist_t *hist)
+{
+    uint64_t count = atomic_load_explicit(&hist->count, memory_order_relaxed);
+    if (count == 0) return 0.0;
+    return (double)atomic_load_explicit(&hist->sum_ns, memory_order_relaxed) / (double)count;
+}
+
+/**
+ * @brief Prints a one-line percentile summary in microseconds.
+ * @param name Label for the line.
+ * @param hist Histogram to print; nothing is printed if it is empty.
+ */
+void LatencyHist_Print(const char *name, const latency_hist_t *hist)
+{
+    uint64_t count = LatencyHist_Count(hist);
+    if (count == 0) return;
+
+    printf("  %-22s n=%-9llu min %9.1f  p50 %9.1f  p99 %9.1f  p99.9 %9.1f  max %9.1f us\n",
+           name, (unsigned long long)count,
+           LatencyHist_Percentile(hist, 0.0) / 1000.0,
+           LatencyHist_Percentile(hist, 50.0) / 1000.0,
+           LatencyHist_Percentile(hist, 99.0) / 1000.0,
+           LatencyHist_Percentile(hist, 99.9) / 1000.0,
+           LatencyHist_Percentile(hist, 100.0) / 1000.0);
+}
@@ -0,0 +1,159 @@
+/**
+ * @file LatencyHist.h
+ * @brief Lock-free log-linear latency histograms.
+ *
+ * Values (nanoseconds) are binned HDR-style: every power-of-two range is split
+ * into 2^LATENCY_HIST_SUB_BITS linear sub-buckets, so the relative error of a
+ * reported percentile is below 1 / 2^LATENCY_HIST_SUB_BITS (about 3%) from
+ * 32 ns up to ~68 s, in a fixed 4 KiB table. Recording is one bucket index
+ * computation and a few relaxed atomic updates, so it can be called from the
+ * acquisition loop while another thread reads percentiles.
+ */
+
+#ifndef _LATENCY_HIST_H_
+#define _LATENCY_HIST_H_
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+
+/** @name Histogram geometry */
+#define LATENCY_HIST_SUB_BITS 5   ///< 32 linear sub-buckets per power of two
+#define LATENCY_HIST_MAX_BITS 36  ///< Values >= 2^36 ns (~68 s) land in the last bucket
+#define LATENCY_HIST_BUCKETS  ((LATENCY_HIST_MAX_BITS - LATENCY_HIST_SUB_BITS + 1) << LATENCY_HIST_SUB_BITS)
+
+/**
+ * @brief Latency histogram. Zero-initialized storage is an empty histogram.
+ */
+typedef struct {
+    _Atomic uint32_t counts[LATENCY_HIST_BUCKETS]; ///< Samples per bucket
+    _Atomic uint64_t count;   ///< Total samples recorded
+    _Atomic uint64_t sum_ns;  ///< Sum of all samples, for the mean
+    _Atomic uint64_t min_ns;  ///< Smallest sample, 0 until the first one (a 0 ns sample is kept as 1 ns)
+    _Atomic uint64_t max_ns;  ///< Largest sample
+} latency_hist_t;
+
+/**
+ * @brief Returns the current CLOCK_MONOTONIC_RAW time in nanoseconds.
+ *
+ * The raw clock is not slewed by NTP, so short intervals are not stretched
+ * or shrunk while the system time is being corrected.
+ * @return Nanoseconds since an arbitrary start point.
+ */
+static inline uint64_t LatencyHist_Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Maps a value to its bucket.
+ * @param ns Value in nanoseconds.
+ * @return Bucket index (0 to LATENCY_HIST_BUCKETS - 1).
+ */
+static inline unsigned LatencyHist_Index(uint64_t ns)
+{
+    if (ns < (1u << LATENCY_HIST_SUB_BITS)) return (unsigned)ns;
+
+    unsigned msb = 63 - (unsigned)__builtin_clzll(ns);
+    if (msb >= LATENCY_HIST_MAX_BITS) return LATENCY_HIST_BUCKETS - 1;
+
+    unsigned shift = msb - LATENCY_HIST_SUB_BITS;
+    return ((shift + 1) << LATENCY_HIST_SUB_BITS) +
+           (unsigned)((ns >> shift) & ((1u << LATENCY_HIST_SUB_BITS) - 1));
+}
+
+/**
+ * @brief Records one sample.
+ *
+ * Safe to call concurrently with itself and with the readers below.
+ * @param hist Histogram to update.
+ * @param ns Sample in nanoseconds.
+ */
+static inline void LatencyHist_Record(latency_hist_t *hist, uint64_t ns)
+{
+    atomic_fetch_add_explicit(&hist->counts[LatencyHist_Index(ns)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&hist->sum_ns, ns, memory_order_relaxed);
+
+    // min/max only need a CAS when they actually change, which is rare after warm-up
+    uint64_t cur = atomic_load_explicit(&hist->max_ns, memory_order_relaxed);
+    while (ns > cur && !atomic_compare_exchange_weak_explicit(&hist->max_ns, &cur, ns,
+                                                              memory_order_relaxed, memory_order_relaxed)) {
+    }
+    cur = atomic_load_explicit(&hist->min_ns, memory_order_relaxed);
+    while ((ns < cur || cur == 0) && !atomic_compare_exchange_weak_explicit(&hist->min_ns, &cur, ns ? ns : 1,
+                                                                            memory_order_relaxed, memory_order_relaxed)) {
+    }
+    atomic_fetch_add_explicit(&hist->count, 1, memory_order_relaxed);
+}
+
+/**
+ * @brief Records the time elapsed since `start_ns`.
+ * @param hist Histogram to update.
+ * @param start_ns Start time from LatencyHist_Now().
+ * @return The current time, so consecutive intervals can be chained.
+ */
+static inline uint64_t LatencyHist_RecordSince(latency_hist_t *hist, uint64_t start_ns)
+{
+    uint64_t now = LatencyHist_Now();
+    LatencyHist_Record(hist, now - start_ns);
+    return now;
+}
+
+/**
+ * @brief Empties a histogram.
+ *
+ * Samples recorded concurrently with the reset may be partially kept.
+ * @param hist Histogram to clear.
+ */
+void LatencyHist_Reset(latency_hist_t *hist);
+
+/**
+ * @brief Returns the number of samples recorded.
+ * @param hist Histogram to read.
+ * @return Sample count.
+ */
+uint64_t LatencyHist_Count(const latency_hist_t *hist);
+
+/**
+ * @brief Returns the value below which a given percentage of samples fall.
+ *
+ * The result is the upper edge of the bucket holding that rank, clamped to
+ * the recorded min/max, so p0 and p100 are exact.
+ * @param hist Histogram to read.
+ * @param percentile Percentile, 0.0 to 100.0.
+ * @return Value in nanoseconds, 0 if the histogram is empty.
+ */
+uint64_t LatencyHist_Percentile(const latency_hist_t *hist, double percentile);
+
+/**
+ * @brief Counts the samples at or below each of a set of bounds, in one pass.
+ *
+ * A bucket is counted under a bound only if its upper edge is at or below
+ * it, so each result may lag the exact count by the samples of one bucket
+ * (under 3% of the bound). This is the cumulative form Prometheus
+ * histograms use.
+ * @param hist Histogram to read.
+ * @param bounds_ns Ascending upper bounds in nanoseconds.
+ * @param n Number of bounds.
+ * @param out Receives `n` cumulative counts.
+ * @return Total samples in the snapshot, consistent with `out`.
+ */
+uint64_t LatencyHist_Cumulative(const latency_hist_t *hist, const uint64_t *bounds_ns, unsigned n, uint64_t *out);
+
+/**
+ * @brief Returns the mean of the recorded samples.
+ * @param hist Histogram to read.
+ * @return Mean in nanoseconds, 0 if the histogram is empty.
+ */
+double LatencyHist_Mean(const latency_hist_t *hist);
+
+/**
+ * @brief Prints "name: n=, min/p50/p99/p99.9/max" in microseconds on one line.
+ * @param name Label for the line.
+ * @param hist Histogram to print; nothing is printed if it is empty.
+ */
+void LatencyHist_Print(const char *name, const latency_hist_t *hist);
+
+#endif // _LATENCY_HIST_H_
@@ -0,0 +1,495 @@
+#define _DEFAULT_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <sys/resource.h>
+#include "../../lib/ADS1256/ADS1256.h"
+#include "../../lib/ADS1256/ADS1256_stream.h"
+#include "../../common/Debug.h"
+#include <stdio.h>
+
+#define BENCH_MAX_RUNS   64
+#define BENCH_MAX_VALUES 8
+#define BENCH_READ_CHUNK 1024
+
+/**
+ * @brief Acquisition paths the benchmark can run.
+ */
+typedef enum {
+    BENCH_OPTIMIZED = 0, ///< ADS1256_GetNChannels_Optimized()
+    BENCH_FAST,          ///< ADS1256_GetNChannels_Fast()
+    BENCH_SCAN,          ///< Pipelined scan list, ADS1256_Scan()
+    BENCH_KERNEL,        ///< Compiled scan kernel of the same shape, ADS1256_RunKernel()
+    BENCH_CONTINUOUS,    ///< RDATAC on one channel
+    BENCH_STREAM,        ///< Acquisition thread and ring, ADS1256_Stream_Read()
+    BENCH_NUM_MODES
+} BENCH_MODE;
+
+static const char *mode_names[BENCH_NUM_MODES] = { "optimized", "fast", "scan", "kernel", "continuous", "stream" };
+
+/**
+ * @brief Percentiles of one latency histogram, in nanoseconds.
+ */
+typedef struct {
+    uint64_t p50, p99, p999, max;
+} bench_pct_t;
+
+/**
+ * @brief Measurements of one run.
+ */
+typedef struct {
+    BENCH_MODE mode;
+    int channels;
+    double drate_sps;
+    unsigned long scans;
+    unsigned long samples;
+    unsigned long errors;
+    double wall_s;
+    double cpu_ns_per_sample;
+    double scan_rate_hz;
+    double syscalls_per_sample;
+    DEV_BusIoStats io;
+    long voluntary_switches;
+    long involuntary_switches;
+    bench_pct_t drdy_wait;
+    bench_pct_t spi_transaction;
+    bench_pct_t scan_period;
+} bench_run_t;
+
+static void print_usage(const char *prog)
+{
+    printf("Usage: %s [options]\n\n", prog);
+    printf("Runs a fixed amount of acquisition work per configuration and reports\n");
+    printf("throughput, CPU and system calls per sample, and latency percentiles.\n\n");
+    printf("Options:\n");
+    printf("  -B <spec>       Backend: hw, rp1, sim[:<time_scale>], replay:<file>, record:<file>[,<spec>] (default sim)\n");
+    printf("  -m <m,m,...>    Modes: optimized,fast,scan,kernel,continuous,stream (default all)\n");
+    printf("  -c <n,n,...>    Channel counts (default 1,2,4,8; continuous runs 1 only)\n");
+    printf("  -r <sps,...>    Data rates (default 30000,1000)\n");
+    printf("  -n <scans>      Scans per run (default 2000)\n");
+    printf("  -s <cycles>     Settling cycles for optimized/scan/stream (default 1)\n");
+    printf("  -d poll|event   DRDY wait mode (default poll)\n");
+    printf("  -S <hz>         ADC SPI clock (default %d)\n", SPI_SPEED_HZ);
+    printf("  -P <max_hz>     Probe the fastest error-free ADC SPI clock up to max_hz first\n");
+    printf("  -o <file>       Write the results as JSON (\"-\" for stdout)\n");
+}
+
+/**
+ * @brief Parses a comma-separated list of numbers.
+ * @param s List.
+ * @param out Output array.
+ * @param max Capacity of `out`.
+ * @return Number of values parsed.
+ */
+static int parse_list(const char *s, double *out, int max)
+{
+    int n = 0;
+    char *end;
+    while (*s && n < max) {
+        out[n++] = strtod(s, &end);
+        if (end == s || *end != ',') break;
+        s = end + 1;
+    }
+    return n;
+}
+
+/**
+ * @brief Parses a comma-separated list of mode names.
+ * @param s List.
+ * @param enabled Output flags indexed by BENCH_MODE.
+ * @return 0 on success, 1 on an unknown name.
+ */
+static int parse_modes(const char *s, UBYTE *enabled)
+{
+    char buf[128];
+    snprintf(buf, sizeof(buf), "%s", s);
+    memset(enabled, 0, BENCH_NUM_MODES);
+    for (char *tok = strtok(buf, ","); tok; tok = strtok(NULL, ",")) {
+        int found = 0;
+        for (int m = 0; m < BENCH_NUM_MODES; m++) {
+            if (strcmp(tok, mode_names[m]) == 0) enabled[m] = found = 1;
+        }
+        if (!found) {
+            fprintf(stderr, "Unknown mode %s\n", tok);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Returns a clock in nanoseconds.
+ * @param clock Clock id.
+ * @return Time in nanoseconds.
+ */
+static uint64_t now_ns(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Reads p50/p99/p99.9/max of a histogram.
+ * @param hist Histogram.
+ * @param out Output.
+ */
+static void read_pct(const latency_hist_t *hist, bench_pct_t *out)
+{
+    out->p50 = LatencyHist_Percentile(hist, 50.0);
+    out->p99 = LatencyHist_Percentile(hist, 99.0);
+    out->p999 = LatencyHist_Percentile(hist, 99.9);
+    out->max = LatencyHist_Percentile(hist, 100.0);
+}
+
+/**
+ * @brief Finds the compiled kernel that scans AIN0.. against AINCOM like the other modes.
+ * @param num Number of channels.
+ * @param drate Data rate.
+ * @param settling Settling cycles of every entry.
+ * @return The kernel, or NULL if ADS1256_kernels.def has none of this shape.
+ */
+static const ADS1256_Kernel *find_kernel(int num, ADS1256_DRATE drate, UBYTE settling)
+{
+    const ADS1256_Kernel *k;
+
+    for (UBYTE i = 0; (k = ADS1256_GetKernel(i)) != NULL; i++) {
+        int match = k->num_entries == num && k->drate == drate && k->gain == ADS1256_GAIN_1;
+        for (int e = 0; match && e < num; e++) {
+            match = k->mux[e] == ADS1256_MUX(e, ADS1256_MUX_AINCOM) && k->settling_cycles[e] == settling;
+        }
+        if (match) return k;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Runs `scans` scans of one mode, or fewer on an error.
+ * @param mode Acquisition path.
+ * @param channels Channel numbers.
+ * @param num Number of channels.
+ * @param drate Data rate.
+ * @param settling Settling cycles.
+ * @param scans Scans to run.
+ * @param run Receives the scan, sample and error counts.
+ * @return 0 on success, 1 if the mode could not be started.
+ */
+static int run_work(BENCH_MODE mode, UBYTE *channels, int num, ADS1256_DRATE drate, UBYTE settling,
+                    unsigned long scans, bench_run_t *run)
+{
+    UDOUBLE values[BENCH_MAX_VALUES];
+    static ADS1256_ScanList list;
+    static ads1256_sample_t chunk[BENCH_READ_CHUNK];
+
+    switch (mode) {
+        case BENCH_OPTIMIZED:
+        case BENCH_FAST:
+            for (unsigned long i = 0; i < scans; i++) {
+                UBYTE status = (mode == BENCH_FAST) ? ADS1256_GetNChannels_Fast(values, channels, num)
+                                                    : ADS1256_GetNChannels_Optimized(values, channels, num, settling);
+                if (status != ADS1256_OK) run->errors++;
+                else run->scans++;
+            }
+            break;
+
+        case BENCH_SCAN:
+            if (ADS1256_ScanList_Build(&list, channels, num, ADS1256_GAIN_1, drate, settling) != ADS1256_OK) return 1;
+            for (unsigned long i = 0; i < scans; i++) {
+                if (ADS1256_Scan(&list, values) != ADS1256_OK) run->errors++;
+                else run->scans++;
+            }
+            break;
+
+        case BENCH_KERNEL: {
+            const ADS1256_Kernel *kernel = find_kernel(num, drate, settling);
+            if (!kernel) return 1;
+            for (unsigned long i = 0; i < scans; i++) {
+                if (ADS1256_RunKernel(kernel, values) != ADS1256_OK) run->errors++;
+                else run->scans++;
+            }
+            break;
+        }
+
+        case BENCH_CONTINUOUS: {
+            if (ADS1256_StartContinuous(channels[0]) != ADS1256_OK) return 1;
+            for (unsigned long i = 0; i < scans; i += BENCH_MAX_VALUES) {
+                UDOUBLE n = (scans - i < BENCH_MAX_VALUES) ? (UDOUBLE)(scans - i) : BENCH_MAX_VALUES;
+                if (ADS1256_ReadContinuous(values, n) != ADS1256_OK) run->errors++;
+                else run->scans += n;
+            }
+            ADS1256_StopContinuous();
+            break;
+        }
+
+        case BENCH_STREAM: {
+            ads1256_stream_config_t cfg;
+            ads1256_stream_t stream;
+            unsigned long want = scans * (unsigned long)num;
+            unsigned long got = 0;
+
+            ADS1256_Stream_DefaultConfig(&cfg);
+            cfg.num_channels = (UBYTE)num;
+            memcpy(cfg.channels, channels, num);
+            cfg.drate = drate;
+            cfg.settling_cycles = settling;
+            if (ADS1256_Stream_Start(&stream, &cfg) != ADS1256_OK) return 1;
+            while (got < want) {
+                UDOUBLE n = ADS1256_Stream_Read(&stream, chunk, BENCH_READ_CHUNK, 1000);
+                if (n == 0) { // One second without data: give up
+                    run->errors++;
+                    break;
+                }
+                got += n;
+            }
+            ADS1256_Stream_Stop(&stream);
+            run->errors += (unsigned long)ADS1256_Stream_Overruns(&stream);
+            run->scans = got / num;
+            break;
+        }
+
+        default:
+            return 1;
+    }
+    run->samples = run->scans * (unsigned long)(mode == BENCH_CONTINUOUS ? 1 : num);
+    return 0;
+}
+
+/**
+ * @brief Runs one configuration and measures it.
+ * @param mode Acquisition path.
+ * @param num Number of channels (AIN0 upwards).
+ * @param drate Data rate.
+ * @param settling Settling cycles.
+ * @param scans Scans to run.
+ * @param run Output.
+ * @return 0 on success, 1 on failure.
+ */
+static int bench_one(BENCH_MODE mode, int num, ADS1256_DRATE drate, UBYTE settling, unsigned long scans,
+                     bench_run_t *run)
+{
+    UBYTE channels[NUM_SINGLE_ENDED_CHANNELS];
+    struct rusage ru0, ru1;
+    bench_run_t warmup;
+    DEV_Bus *bus = DEV_GetDefaultBus();
+    performance_metrics_t *metrics = ADS1256_GetPerformanceMetrics();
+
+    for (int i = 0; i < num; i++) channels[i] = (UBYTE)i;
+    memset(run, 0, sizeof(*run));
+    run->mode = mode;
+    run->channels = num;
+    run->drate_sps = ADS1256_DrateToSps(drate);
+
+    if (ADS1256_ConfigADC(ADS1256_GAIN_1, drate) != ADS1256_OK) return 1;
+
+    // A short warm-up settles the pipeline and faults in the stack and caches
+    memset(&warmup, 0, sizeof(warmup));
+    if (mode != BENCH_STREAM && run_work(mode, channels, num, drate, settling, scans / 20 + 1, &warmup) != 0) return 1;
+
+    ADS1256_InitPerformanceMonitoring(drate);
+    DEV_Bus_ResetIoStats(bus);
+    getrusage(RUSAGE_SELF, &ru0);
+    uint64_t wall0 = now_ns(CLOCK_MONOTONIC);
+    uint64_t cpu0 = now_ns(CLOCK_PROCESS_CPUTIME_ID);
+
+    if (run_work(mode, channels, num, drate, settling, scans, run) != 0) return 1;
+
+    uint64_t cpu1 = now_ns(CLOCK_PROCESS_CPUTIME_ID);
+    uint64_t wall1 = now_ns(CLOCK_MONOTONIC);
+    getrusage(RUSAGE_SELF, &ru1);
+    DEV_Bus_GetIoStats(bus, &run->io);
+
+    run->wall_s = (wall1 - wall0) / 1e9;
+    if (run->samples > 0) {
+        unsigned long calls = run->io.spi_messages + run->io.gpio_writes + run->io.gpio_reads + run->io.event_waits;
+        run->cpu_ns_per_sample = (double)(cpu1 - cpu0) / run->samples;
+        run->syscalls_per_sample = (double)calls / run->samples;
+    }
+    if (run->wall_s > 0) run->scan_rate_hz = run->scans / run->wall_s;
+    run->voluntary_switches = ru1.ru_nvcsw - ru0.ru_nvcsw;
+    run->involuntary_switches = ru1.ru_nivcsw - ru0.ru_nivcsw;
+    read_pct(&metrics->drdy_wait, &run->drdy_wait);
+    read_pct(&metrics->spi_transaction, &run->spi_transaction);
+    read_pct(&metrics->scan_period, &run->scan_period);
+    return 0;
+}
+
+/**
+ * @brief Writes one percentile object.
+ * @param f Output.
+ * @param name Key.
+ * @param p Percentiles.
+ * @param last Non-zero for the last member of the enclosing object.
+ */
+static void json_pct(FILE *f, const char *name, const bench_pct_t *p, int last)
+{
+    fprintf(f, "      \"%s\": {\"p50\": %llu, \"p99\": %llu, \"p99_9\": %llu, \"max\": %llu}%s\n", name,
+            (unsigned long long)p->p50, (unsigned long long)p->p99, (unsigned long long)p->p999,
+            (unsigned long long)p->max, last ? "" : ",");
+}
+
+/**
+ * @brief Writes all runs as JSON.
+ * @param f Output.
+ * @param runs Runs.
+ * @param n Number of runs.
+ * @param scans Scans requested per run.
+ * @param settling Settling cycles.
+ * @param drdy_mode DRDY wait mode name.
+ */
+static void write_json(FILE *f, const bench_run_t *runs, int n, unsigned long scans, int settling, const char *drdy_mode)
+{
+    fprintf(f, "{\n  \"backend\": \"%s\",\n  \"scans_per_run\": %lu,\n  \"settling_cycles\": %d,\n"
+               "  \"drdy_mode\": \"%s\",\n  \"spi_speed_hz\": %d,\n  \"runs\": [\n",
+            DEV_Backend_Name(), scans, settling, drdy_mode, (int)ADS1256_GetSpiSpeed());
+    for (int i = 0; i < n; i++) {
+        const bench_run_t *r = &runs[i];
+        fprintf(f, "    {\n");
+        fprintf(f, "      \"mode\": \"%s\", \"channels\": %d, \"drate_sps\": %g,\n", mode_names[r->mode], r->channels,
+                r->drate_sps);
+        fprintf(f, "      \"scans\": %lu, \"samples\": %lu, \"errors\": %lu, \"wall_s\": %.6f,\n", r->scans, r->samples,
+                r->errors, r->wall_s);
+        fprintf(f, "      \"scan_rate_hz\": %.2f, \"sps_per_channel\": %.2f, \"cpu_ns_per_sample\": %.1f,\n",
+                r->scan_rate_hz, r->scan_rate_hz, r->cpu_ns_per_sample);
+        fprintf(f, "      \"syscalls_per_sample\": %.3f, \"spi_messages\": %lu, \"spi_bytes\": %lu, "
+                   "\"gpio_writes\": %lu, \"gpio_reads\": %lu, \"event_waits\": %lu, \"mmio_accesses\": %lu,\n",
+                r->syscalls_per_sample, (unsigned long)r->io.spi_messages, (unsigned long)r->io.spi_bytes,
+                (unsigned long)r->io.gpio_writes, (unsigned long)r->io.gpio_reads, (unsigned long)r->io.event_waits,
+                (unsigned long)r->io.mmio_accesses);
+        fprintf(f, "      \"voluntary_switches\": %ld, \"involuntary_switches\": %ld,\n", r->voluntary_switches,
+                r->involuntary_switches);
+        json_pct(f, "drdy_wait_ns", &r->drdy_wait, 0);
+        json_pct(f, "spi_transaction_ns", &r->spi_transaction, 0);
+        json_pct(f, "scan_period_ns", &r->scan_period, 1);
+        fprintf(f, "    }%s\n", i + 1 < n ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+int main(int argc, char **argv)
+{
+    static bench_run_t runs[BENCH_MAX_RUNS];
+    UBYTE modes[BENCH_NUM_MODES] = { 1, 1, 1, 1, 1, 1 };
+    double counts[NUM_SINGLE_ENDED_CHANNELS] = { 1, 2, 4, 8 };
+    double rates[ADS1256_DRATE_MAX] = { 30000, 1000 };
+    int num_counts = 4, num_rates = 2, num_runs = 0;
+    unsigned long scans = 2000;
+    int settling = 1;
+    const char *backend = "sim";
+    const char *json_path = NULL;
+    DEV_DRDY_MODE drdy_mode = DEV_DRDY_MODE_POLL;
+    UDOUBLE spi_hz = 0, probe_max_hz = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "B:m:c:r:n:s:d:S:P:o:h")) != -1) {
+        switch (opt) {
+            case 'B': backend = optarg; break;
+            case 'm': if (parse_modes(optarg, modes) != 0) return 1; break;
+            case 'c': num_counts = parse_list(optarg, counts, NUM_SINGLE_ENDED_CHANNELS); break;
+            case 'r': num_rates = parse_list(optarg, rates, ADS1256_DRATE_MAX); break;
+            case 'n': scans = strtoul(optarg, NULL, 10); break;
+            case 's': settling = atoi(optarg); break;
+            case 'd': drdy_mode = (strcmp(optarg, "event") == 0) ? DEV_DRDY_MODE_EVENT : DEV_DRDY_MODE_POLL; break;
+            case 'S': spi_hz = strtoul(optarg, NULL, 10); break;
+            case 'P': probe_max_hz = strtoul(optarg, NULL, 10); break;
+            case 'o': json_path = optarg; break;
+            default: print_usage(argv[0]); return 1;
+        }
+    }
+    if (scans == 0 || settling < 1 || settling > 255) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (DEV_Backend_Select(backend) != 0) {
+        fprintf(stderr, "Unknown backend %s\n", backend);
+        return 1;
+    }
+    if (DEV_ModuleInit() != 0) {
+        printf("❌ Backend %s initialization failed\n", backend);
+        return 1;
+    }
+    if (ADS1256_init(ADS1256_30000SPS, ADS1256_GAIN_1, SCAN_MODE_SINGLE_ENDED) != ADS1256_OK) {
+        printf("❌ ADS1256 initialization failed\n");
+        DEV_ModuleExit();
+        return 1;
+    }
+    if (spi_hz && ADS1256_SetSpiSpeed(spi_hz) != ADS1256_OK) {
+        printf("❌ Invalid SPI clock %u Hz\n", (unsigned)spi_hz);
+        DEV_ModuleExit();
+        return 1;
+    }
+    if (probe_max_hz) {
+        ADS1256_SpeedProbe probe;
+        ADS1256_SpeedProbeResult res;
+
+        ADS1256_SpeedProbe_Init(&probe);
+        probe.max_hz = probe_max_hz;
+        if (probe.min_hz > probe_max_hz) probe.min_hz = probe_max_hz;
+        if (ADS1256_ProbeSpiSpeed(&probe, &res) != ADS1256_OK) {
+            printf("❌ SPI clock probe failed (first failure at %u Hz)\n", (unsigned)res.failed_hz);
+            DEV_ModuleExit();
+            return 1;
+        }
+        printf("SPI clock probe: %u Hz after %d passing step(s)", (unsigned)res.best_hz, res.steps_passed);
+        if (res.failed_hz) {
+            printf(", %u Hz failed (%lu register, %lu input errors)", (unsigned)res.failed_hz, res.reg_errors,
+                   res.input_errors);
+        }
+        printf("\n");
+    }
+    if (drdy_mode == DEV_DRDY_MODE_EVENT && DEV_DRDY_SetMode(DEV_DRDY_MODE_EVENT) != 0) {
+        printf("⚠️  Event mode unavailable, polling DRDY\n");
+        drdy_mode = DEV_DRDY_MODE_POLL;
+    }
+
+    printf("Backend %s, %lu scans per run, %d settling cycle(s), DRDY %s, SPI %u Hz\n\n", DEV_Backend_Name(), scans,
+           settling, drdy_mode == DEV_DRDY_MODE_EVENT ? "event" : "poll", (unsigned)ADS1256_GetSpiSpeed());
+    printf("%-10s %3s %7s %10s %9s %9s %9s %9s %9s %6s\n", "mode", "ch", "SPS", "scan/s", "cpu ns/s", "calls/s",
+           "drdy p99", "spi p99", "scan p99", "errors");
+
+    for (int m = 0; m < BENCH_NUM_MODES; m++) {
+        if (!modes[m]) continue;
+        for (int r = 0; r < num_rates; r++) {
+            ADS1256_DRATE drate = ADS1256_30000SPS;
+            while (drate < ADS1256_2d5SPS && ADS1256_DrateToSps(drate) > rates[r]) drate++;
+
+            for (int c = 0; c < num_counts && num_runs < BENCH_MAX_RUNS; c++) {
+                int num = (int)counts[c];
+                if (num < 1 || num > NUM_SINGLE_ENDED_CHANNELS) continue;
+                if (m == BENCH_CONTINUOUS && num != 1) continue;
+                if (m == BENCH_KERNEL && !find_kernel(num, drate, (UBYTE)settling)) continue;
+
+                bench_run_t *run = &runs[num_runs];
+                if (bench_one((BENCH_MODE)m, num, drate, (UBYTE)settling, scans, run) != 0) {
+                    printf("%-10s %3d %7g   failed to start\n", mode_names[m], num, ADS1256_DrateToSps(drate));
+                    continue;
+                }
+                num_runs++;
+                printf("%-10s %3d %7g %10.1f %9.0f %9.2f %9.1f %9.1f %9.1f %6lu\n", mode_names[m], num,
+                       run->drate_sps, run->scan_rate_hz, run->cpu_ns_per_sample, run->syscalls_per_sample,
+                       run->drdy_wait.p99 / 1000.0, run->spi_transaction.p99 / 1000.0, run->scan_period.p99 / 1000.0,
+                       run->errors);
+                fflush(stdout);
+            }
+        }
+    }
+    printf("\n(cpu ns/s and calls/s are per sample; latencies in microseconds)\n");
+
+    if (json_path) {
+        FILE *f = strcmp(json_path, "-") == 0 ? stdout : fopen(json_path, "w");
+        if (!f) {
+            perror("Cannot write JSON results");
+        } else {
+            write_json(f, runs, num_runs, scans, settling, drdy_mode == DEV_DRDY_MODE_EVENT ? "event" : "poll");
+            if (f != stdout) {
+                fclose(f);
+                printf("Results written to %s\n", json_path);
+            }
+        }
+    }
+
+    DEV_ModuleExit();
+    return 0;
+}
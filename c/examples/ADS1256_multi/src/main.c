@@ -0,0 +1,201 @@
+#define _DEFAULT_SOURCE
+#include <stdlib.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <getopt.h>
+#include "../../lib/ADS1256/ADS1256.h"
+#include "../../lib/ADS1256/ADS1256_multi.h"
+#include "../../common/DEV_Sim.h"
+#include "../../common/Debug.h"
+#include <stdio.h>
+
+#define MULTI_READ_CHUNK 256
+
+/**
+ * @brief Wiring of each board. Board 0 is the AD/DA HAT on SPI0; edit the
+ *        other rows to match how the extra boards are connected.
+ */
+static const struct {
+    DEV_BusConfig bus;
+    DEV_PortConfig port;
+} boards[] = {
+    { { .spi_device = SPI_DEVICE, .spi_speed_hz = SPI_SPEED_HZ, .gpio_chip = GPIO_CHIP_NAME },
+      { .rst_pin = DEV_RST_PIN, .cs_pin = DEV_CS_PIN, .drdy_pin = DEV_DRDY_PIN } },
+    { { .spi_device = "/dev/spidev1.0", .spi_speed_hz = SPI_SPEED_HZ, .gpio_chip = GPIO_CHIP_NAME },
+      { .rst_pin = 24, .cs_pin = 25, .drdy_pin = 27 } },
+    { { .spi_device = "/dev/spidev3.0", .spi_speed_hz = SPI_SPEED_HZ, .gpio_chip = GPIO_CHIP_NAME },
+      { .rst_pin = 5,  .cs_pin = 6,  .drdy_pin = 12 } },
+    { { .spi_device = "/dev/spidev4.0", .spi_speed_hz = SPI_SPEED_HZ, .gpio_chip = GPIO_CHIP_NAME },
+      { .rst_pin = 13, .cs_pin = 16, .drdy_pin = 26 } },
+};
+#define MULTI_NUM_BOARDS ((int)(sizeof(boards) / sizeof(boards[0])))
+
+static volatile sig_atomic_t running = 1;
+
+void Handler(int signo)
+{
+    running = 0;
+}
+
+static void print_usage(const char *prog)
+{
+    printf("Usage: %s [options]\n\n", prog);
+    printf("Scans the same channels on several ADS1256 boards with one pinned thread\n");
+    printf("per board and a shared SYNC instant, and reports the merged frame rate and\n");
+    printf("the DRDY skew between the boards.\n\n");
+    printf("Options:\n");
+    printf("  -B <spec>       Backend: hw, rp1, sim[:<time_scale>] (default sim)\n");
+    printf("  -b <boards>     Number of boards, 1..%d (default 2)\n", MULTI_NUM_BOARDS);
+    printf("  -c <ch,ch,...>  Channels scanned on every board (default 0,1,2,3)\n");
+    printf("  -r <sps>        Data rate (default 30000)\n");
+    printf("  -p <cpu,...>    CPU core of each board's thread (default unpinned)\n");
+    printf("  -P <prio>       SCHED_FIFO priority of the threads (default 0)\n");
+    printf("  -t <seconds>    Run time (default 5, 0 = until Ctrl+C)\n");
+}
+
+/**
+ * @brief Parses a comma-separated list of integers.
+ * @param s List.
+ * @param out Output array.
+ * @param max Capacity of `out`.
+ * @return Number of values parsed.
+ */
+static int parse_ints(const char *s, int *out, int max)
+{
+    int n = 0;
+    char *copy = strdup(s);
+    for (char *tok = strtok(copy, ","); tok && n < max; tok = strtok(NULL, ",")) {
+        out[n++] = atoi(tok);
+    }
+    free(copy);
+    return n;
+}
+
+int main(int argc, char **argv)
+{
+    static DEV_Bus buses[MULTI_NUM_BOARDS];
+    static DEV_Port ports[MULTI_NUM_BOARDS];
+    static ads1256_dev_t devs[MULTI_NUM_BOARDS];
+    static ads1256_multi_t multi;
+    static ads1256_multi_frame_t frames[MULTI_READ_CHUNK];
+    static latency_hist_t skew;
+    ads1256_multi_config_t cfg;
+    const char *backend = "sim";
+    int num_boards = 2, num_opened = 0, seconds = 5;
+    int list[ADS1256_MULTI_MAX_DEVS];
+    double sps = 30000;
+    int opt, rc = 1;
+
+    ADS1256_Multi_DefaultConfig(&cfg);
+    while ((opt = getopt(argc, argv, "B:b:c:r:p:P:t:h")) != -1) {
+        switch (opt) {
+            case 'B': backend = optarg; break;
+            case 'b': num_boards = atoi(optarg); break;
+            case 'c': {
+                int ch[NUM_SINGLE_ENDED_CHANNELS];
+                cfg.num_channels = (UBYTE)parse_ints(optarg, ch, NUM_SINGLE_ENDED_CHANNELS);
+                for (int i = 0; i < cfg.num_channels; i++) cfg.channels[i] = (UBYTE)ch[i];
+                break;
+            }
+            case 'r': sps = atof(optarg); break;
+            case 'p': {
+                int n = parse_ints(optarg, list, ADS1256_MULTI_MAX_DEVS);
+                for (int i = 0; i < n; i++) cfg.cpus[i] = list[i];
+                break;
+            }
+            case 'P': cfg.rt_priority = atoi(optarg); break;
+            case 't': seconds = atoi(optarg); break;
+            default: print_usage(argv[0]); return 1;
+        }
+    }
+    if (num_boards < 1 || num_boards > MULTI_NUM_BOARDS || cfg.num_channels == 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    while (cfg.drate < ADS1256_2d5SPS && ADS1256_DrateToSps(cfg.drate) > sps) cfg.drate++;
+
+    signal(SIGINT, Handler);
+    if (DEV_Backend_Select(backend) != 0) {
+        fprintf(stderr, "Unknown backend %s\n", backend);
+        return 1;
+    }
+
+    for (; num_opened < num_boards; num_opened++) {
+        int b = num_opened;
+        if (DEV_Bus_Open(&buses[b], &boards[b].bus) != 0) {
+            printf("❌ Board %d: cannot open %s\n", b, boards[b].bus.spi_device);
+            goto out;
+        }
+        if (DEV_Port_Open(&ports[b], &buses[b], &boards[b].port) != 0) {
+            printf("❌ Board %d: cannot open its pins\n", b);
+            DEV_Bus_Close(&buses[b]);
+            goto out;
+        }
+        if (strncmp(DEV_Backend_Name(), "sim", 3) == 0) {
+            for (UBYTE ain = 0; ain < NUM_SINGLE_ENDED_CHANNELS; ain++) {
+                DEV_Sim_SetInput(&buses[b], ain, 0.25 * (b + 1) + 0.01 * ain); // Tell the boards apart
+            }
+        }
+        if (ADS1256_Dev_Init(&devs[b], &ports[b], cfg.drate, cfg.gain, SCAN_MODE_SINGLE_ENDED) != 0) {
+            printf("❌ Board %d: ADS1256 initialization failed\n", b);
+            DEV_Port_Close(&ports[b]);
+            DEV_Bus_Close(&buses[b]);
+            goto out;
+        }
+        cfg.devs[b] = &devs[b];
+    }
+    cfg.num_devs = (UBYTE)num_boards;
+
+    if (ADS1256_Multi_Start(&multi, &cfg) != ADS1256_OK) {
+        printf("❌ Multi-board acquisition failed to start\n");
+        goto out;
+    }
+    printf("Backend %s, %d board(s), %d channel(s) each at %g SPS\n\n", DEV_Backend_Name(), num_boards,
+           cfg.num_channels, ADS1256_DrateToSps(cfg.drate));
+    printf("%8s %10s %10s %10s %10s %10s   last frame\n", "time", "frames/s", "samples/s", "skew p50", "skew p99",
+           "skew max");
+
+    struct timespec t0, now;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    unsigned long window = 0;
+    int elapsed = 0;
+    while (running && (seconds == 0 || elapsed < seconds)) {
+        UDOUBLE n = ADS1256_Multi_Read(&multi, frames, MULTI_READ_CHUNK, 100);
+        for (UDOUBLE i = 0; i < n; i++) {
+            LatencyHist_Record(&skew, frames[i].skew_ns);
+        }
+        window += n;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec - t0.tv_sec > elapsed) {
+            elapsed++;
+            printf("%7ds %10lu %10lu %8.1fus %8.1fus %8.1fus  ", elapsed, window, window * num_boards,
+                   LatencyHist_Percentile(&skew, 50) / 1000.0, LatencyHist_Percentile(&skew, 99) / 1000.0,
+                   LatencyHist_Percentile(&skew, 100) / 1000.0);
+            if (n > 0) {
+                const ads1256_multi_frame_t *f = &frames[n - 1];
+                printf(" AIN%d", f->channel);
+                for (UBYTE b = 0; b < f->num_values; b++) {
+                    printf(" %.4fV", ADS1256_RawToVoltage(f->values[b], ADC_VREF_POS_5V0, ADC_VREF_NEG_GND, cfg.gain));
+                }
+            }
+            printf("\n");
+            fflush(stdout);
+            window = 0;
+            LatencyHist_Reset(&skew);
+        }
+    }
+
+    ADS1256_Multi_Stop(&multi);
+    printf("\n%llu overruns, %llu resyncs\n", (unsigned long long)ADS1256_Multi_Overruns(&multi),
+           (unsigned long long)ADS1256_Multi_Resyncs(&multi));
+    rc = 0;
+
+out:
+    for (int b = 0; b < num_opened; b++) {
+        DEV_Port_Close(&ports[b]);
+        DEV_Bus_Close(&buses[b]);
+    }
+    return rc;
+}
@@ -0,0 +1,273 @@
+#define _DEFAULT_SOURCE
+#include <stdlib.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <netinet/in.h>
+#include "../../lib/ADS1256/ADS1256.h"
+#include "../../lib/ADS1256/ADS1256_net.h"
+#include "../../lib/ADS1256/ADS1256_dsp.h"
+#include "../../lib/ADS1256/ADS1256_shm.h"
+#include "../../lib/ADS1256/ADS1256_metrics.h"
+#include "../../common/Debug.h"
+#include <stdio.h>
+
+static volatile sig_atomic_t running = 1;
+
+void Handler(int signo)
+{
+    running = 0;
+}
+
+static void print_usage(const char *prog)
+{
+    printf("Usage:\n");
+    printf("  %s [options] udp <host> [port]   Send packets to host (default port %d)\n", prog, ADS1256_NET_DEFAULT_PORT);
+    printf("  %s [options] tcp [port]          Serve packets to TCP clients\n", prog);
+    printf("  %s recv [port]                   Receive UDP packets and report loss\n\n", prog);
+    printf("Options:\n");
+    printf("  -c <ch,ch,...>  Channels to scan (default 0,1,2,3)\n");
+    printf("  -r <sps>        Data rate (default 30000)\n");
+    printf("  -g <gain>       PGA gain 1..64 (default 1)\n");
+    printf("  -f <frames>     Frames per packet (default %d)\n", ADS1256_NET_DEFAULT_FRAMES);
+    printf("  -b <packets>    Packets per sendmmsg() batch (default %d)\n", ADS1256_NET_DEFAULT_BATCH);
+    printf("  -l <us>         Flush a partial batch after this many microseconds (default %d)\n",
+           ADS1256_NET_DEFAULT_FLUSH_US);
+    printf("  -p <port>       Control port, 0 to disable (default %d)\n", ADS1256_NET_DEFAULT_CONTROL_PORT);
+    printf("  -a <addr>       Bind the control port, TCP listener and Prometheus endpoint to this address\n");
+    printf("                  (default 127.0.0.1, 0.0.0.0 = all; both are unauthenticated, use a trusted network)\n");
+    printf("  -d <R>          Decimate on board by 2*R: 4-stage CIC by R, then a compensating FIR by 2\n");
+    printf("  -s <name>       Also publish frames to local processes in shared memory (e.g. %s)\n",
+           ADS1256_SHM_DEFAULT_NAME);
+    printf("  -m <port>       Serve Prometheus metrics on http://<addr>:<port>/metrics (e.g. %d)\n",
+           ADS1256_METRICS_DEFAULT_PORT);
+    printf("  -M <host[:port]> Push StatsD metrics every second (default port %d)\n\n",
+           ADS1256_METRICS_DEFAULT_STATSD_PORT);
+    printf("Remote control (with -a <pi address>), e.g.: echo \"DRATE 1000\" | nc -u -w1 <pi> %d\n",
+           ADS1256_NET_DEFAULT_CONTROL_PORT);
+    printf("  SCAN 0,1,2 | DRATE <sps> | GAIN <1..64> | STATUS\n");
+}
+
+/**
+ * @brief Receiver side: decode packets and count lost packets and frames.
+ * @param port UDP port to listen on.
+ * @return Process exit code.
+ */
+static int receive(UWORD port)
+{
+    static UBYTE packet[65536];
+    static ads1256_frame_t frames[ADS1256_NET_MAX_FRAMES_PER_PACKET];
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(port), .sin_addr.s_addr = htonl(INADDR_ANY) };
+    struct timeval tv = { 0, 200000 };
+    unsigned long long packets = 0, frame_count = 0, lost_packets = 0, lost_frames = 0;
+    uint64_t next_packet = 0;
+    time_t last_print = time(NULL);
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0 || bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        perror("Cannot bind receive port");
+        return 1;
+    }
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    printf("Receiving on UDP port %u. Press Ctrl+C to stop\n\n", port);
+
+    while (running) {
+        ads1256_net_header_t h;
+        ssize_t len = recv(fd, packet, sizeof(packet), 0);
+        int n = (len > 0) ? ADS1256_Net_Decode(packet, (size_t)len, &h, frames, ADS1256_NET_MAX_FRAMES_PER_PACKET) : -1;
+
+        if (n >= 0) {
+            if (packets > 0 && h.packet_seq != next_packet) lost_packets += h.packet_seq - next_packet;
+            next_packet = h.packet_seq + 1;
+            packets++;
+            frame_count += n;
+            lost_frames += h.lost;
+        }
+
+        time_t now = time(NULL);
+        if (now != last_print && packets > 0) {
+            printf("Packets: %llu (lost %llu) | frames: %llu (lost at source %llu) | gen %u, AIN%d = %ld     \r",
+                   packets, lost_packets, frame_count, lost_frames, h.config_gen, frames[n > 0 ? n - 1 : 0].channel,
+                   (long)(int32_t)frames[n > 0 ? n - 1 : 0].value);
+            fflush(stdout);
+            last_print = now;
+        }
+    }
+    printf("\n");
+    close(fd);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    ads1256_stream_config_t stream_cfg;
+    ads1256_net_config_t net_cfg;
+    ads1256_net_t net;
+    static ads1256_dsp_t dsp;
+    static ads1256_shm_t shm;
+    static ads1256_metrics_t metrics;
+    ads1256_metrics_config_t metrics_cfg;
+    UBYTE export_metrics = 0;
+    const char *shm_name = NULL;
+    double sps = 30000;
+    int decimation = 1;
+    int opt;
+
+    signal(SIGINT, Handler);
+    signal(SIGTERM, Handler);
+
+    ADS1256_Stream_DefaultConfig(&stream_cfg);
+    ADS1256_Net_DefaultConfig(&net_cfg);
+    ADS1256_Metrics_DefaultConfig(&metrics_cfg);
+    stream_cfg.num_channels = 4;
+    for (int i = 0; i < 4; i++) stream_cfg.channels[i] = i;
+
+    while ((opt = getopt(argc, argv, "c:r:g:f:b:l:p:a:d:s:m:M:h")) != -1) {
+        switch (opt) {
+            case 'c': {
+                char *s = optarg;
+                stream_cfg.num_channels = 0;
+                while (*s && stream_cfg.num_channels < NUM_SINGLE_ENDED_CHANNELS) {
+                    stream_cfg.channels[stream_cfg.num_channels++] = (UBYTE)strtol(s, &s, 10);
+                    if (*s != ',') break;
+                    s++;
+                }
+                break;
+            }
+            case 'r': sps = atof(optarg); break;
+            case 'g': {
+                int g = atoi(optarg);
+                stream_cfg.gain = ADS1256_GAIN_1;
+                while (stream_cfg.gain < ADS1256_GAIN_64 && (1 << stream_cfg.gain) < g) stream_cfg.gain++;
+                break;
+            }
+            case 'f': net_cfg.frames_per_packet = (UWORD)atoi(optarg); break;
+            case 'b': net_cfg.batch_packets = (UWORD)atoi(optarg); break;
+            case 'l': net_cfg.flush_us = (UDOUBLE)atol(optarg); break;
+            case 'p': net_cfg.control_port = (UWORD)atoi(optarg); break;
+            case 'a': net_cfg.bind_addr = optarg; break;
+            case 'd': decimation = atoi(optarg); break;
+            case 's': shm_name = optarg; break;
+            case 'm':
+                metrics_cfg.mode = ADS1256_METRICS_PROMETHEUS;
+                metrics_cfg.port = (UWORD)atoi(optarg);
+                export_metrics = 1;
+                break;
+            case 'M': {
+                char *colon = strrchr(optarg, ':');
+                metrics_cfg.mode = ADS1256_METRICS_STATSD;
+                metrics_cfg.host = optarg;
+                metrics_cfg.port = ADS1256_METRICS_DEFAULT_STATSD_PORT;
+                if (colon) {
+                    *colon = '\0';
+                    metrics_cfg.port = (UWORD)atoi(colon + 1);
+                }
+                export_metrics = 1;
+                break;
+            }
+            default: print_usage(argv[0]); return 1;
+        }
+    }
+    if (optind >= argc) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (metrics_cfg.mode == ADS1256_METRICS_PROMETHEUS) metrics_cfg.host = net_cfg.bind_addr;
+
+    const char *mode = argv[optind];
+    if (strcmp(mode, "recv") == 0) {
+        return receive(optind + 1 < argc ? (UWORD)atoi(argv[optind + 1]) : ADS1256_NET_DEFAULT_PORT);
+    } else if (strcmp(mode, "udp") == 0 && optind + 1 < argc) {
+        net_cfg.mode = ADS1256_NET_UDP;
+        net_cfg.host = argv[optind + 1];
+        if (optind + 2 < argc) net_cfg.port = (UWORD)atoi(argv[optind + 2]);
+    } else if (strcmp(mode, "tcp") == 0) {
+        net_cfg.mode = ADS1256_NET_TCP;
+        if (optind + 1 < argc) net_cfg.port = (UWORD)atoi(argv[optind + 1]);
+    } else {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    for (stream_cfg.drate = ADS1256_30000SPS; stream_cfg.drate < ADS1256_2d5SPS; stream_cfg.drate++) {
+        if (ADS1256_DrateToSps(stream_cfg.drate) <= sps) break;
+    }
+    stream_cfg.cpu = 3;          // Last Pi 5 core; isolate it with isolcpus=3 for best results
+    stream_cfg.rt_priority = 80;
+    stream_cfg.lock_memory = 1;
+    net_cfg.cpu = 2;
+
+    // Filtering runs on the acquisition thread, so only the decimated frames are sent
+    if (decimation > 1) {
+        ads1256_dsp_chain_config_t chain;
+        ADS1256_Dsp_Init(&dsp);
+        ADS1256_Dsp_DefaultChain(&chain);
+        chain.cic_order = 4;
+        chain.cic_decimation = (UWORD)decimation;
+        chain.fir_taps = 31;
+        chain.fir_decimation = 2;
+        for (int i = 0; i < NUM_SINGLE_ENDED_CHANNELS; i++) {
+            if (ADS1256_Dsp_SetChain(&dsp, (UBYTE)i, &chain) != ADS1256_OK) return 1;
+        }
+        stream_cfg.dsp = &dsp;
+        printf("On-board decimation by %d\n", 2 * decimation);
+    }
+
+    if (shm_name) {
+        ads1256_shm_config_t shm_cfg;
+        ADS1256_Shm_DefaultConfig(&shm_cfg);
+        shm_cfg.name = shm_name;
+        if (ADS1256_Shm_Create(&shm, &shm_cfg) != ADS1256_OK) return 1;
+        stream_cfg.shm = &shm;
+        printf("Publishing frames in shared memory %s\n", shm_name);
+    }
+
+    DEV_ModuleInit();
+    // A restarted server takes the running chip over instead of resetting it
+    if (ADS1256_WarmInit(stream_cfg.drate, stream_cfg.gain, SCAN_MODE_SINGLE_ENDED) != ADS1256_OK) {
+        printf("❌ ADS1256 initialization failed\n");
+        ADS1256_Shm_Destroy(&shm);
+        DEV_ModuleExit();
+        return 1;
+    }
+
+    if (ADS1256_Net_Start(&net, &stream_cfg, &net_cfg) != ADS1256_OK) {
+        printf("❌ Failed to start the network stream\n");
+        ADS1256_Shm_Destroy(&shm);
+        DEV_ModuleExit();
+        return 1;
+    }
+    printf("Streaming %d channel(s) at %g SPS over %s port %u, control on UDP %s:%u. Press Ctrl+C to stop\n",
+           stream_cfg.num_channels, ADS1256_DrateToSps(stream_cfg.drate), mode, net_cfg.port, net_cfg.bind_addr,
+           net_cfg.control_port);
+
+    // The exporter only reads counters the acquisition thread bumps anyway; it costs nothing there
+    if (export_metrics) {
+        if (ADS1256_Metrics_Start(&metrics, &metrics_cfg) != ADS1256_OK ||
+            ADS1256_Metrics_Add(&metrics, "board0", NULL, &net.stream) != ADS1256_OK) {
+            printf("❌ Metrics export disabled\n");
+            ADS1256_Metrics_Stop(&metrics);
+        } else if (metrics_cfg.mode == ADS1256_METRICS_PROMETHEUS) {
+            printf("Prometheus metrics on http://%s:%u/metrics\n", metrics_cfg.host, metrics_cfg.port);
+        } else {
+            printf("Pushing StatsD metrics to %s:%u\n", metrics_cfg.host, metrics_cfg.port);
+        }
+    }
+
+    while (running) {
+        sleep(1);
+        printf("Frames: %llu, packets: %llu, lost: %llu, send errors: %llu     \r",
+               (unsigned long long)atomic_load(&net.frames), (unsigned long long)atomic_load(&net.packets_sent),
+               (unsigned long long)atomic_load(&net.lost), (unsigned long long)atomic_load(&net.send_errors));
+        fflush(stdout);
+    }
+
+    ADS1256_Metrics_Stop(&metrics); // Before the stream it reads from goes away
+    ADS1256_Net_Stop(&net);
+    ADS1256_Net_PrintReport(&net);
+    ADS1256_Shm_Destroy(&shm);
+    DEV_ModuleExit();
+    return 0;
+}
@@ -0,0 +1,210 @@
+#define _DEFAULT_SOURCE
+#include <stdlib.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include "../../lib/ADS1256/ADS1256.h"
+#include "../../lib/ADS1256/ADS1256_stream.h"
+#include "../../lib/ADS1256/ADS1256_shm.h"
+#include "../../common/Debug.h"
+#include <stdio.h>
+
+#define SHM_READ_CHUNK 1024
+
+static volatile sig_atomic_t running = 1;
+
+void Handler(int signo)
+{
+    running = 0;
+}
+
+static void print_usage(const char *prog)
+{
+    printf("Usage:\n");
+    printf("  %s [options] pub [name]   Acquire and publish frames in shared memory (default %s)\n", prog,
+           ADS1256_SHM_DEFAULT_NAME);
+    printf("  %s [options] sub [name]   Attach to a publisher and report rate, loss and latency\n\n", prog);
+    printf("Start any number of sub processes; each reads the same frames independently.\n\n");
+    printf("Options:\n");
+    printf("  -B <spec>       Backend for pub: hw, rp1, sim[:<time_scale>] (default DEV_BACKEND or hw)\n");
+    printf("  -c <ch,ch,...>  Channels to scan (default 0,1,2,3)\n");
+    printf("  -r <sps>        Data rate (default 30000)\n");
+    printf("  -n <frames>     Ring size in frames (default %d)\n", ADS1256_SHM_DEFAULT_RING);
+    printf("  -d <us>         sub: sleep this long between reads, to see a slow reader's overruns\n");
+}
+
+/**
+ * @brief Returns CLOCK_MONOTONIC in nanoseconds, the clock frames are stamped with.
+ * @return Current time.
+ */
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Publisher: runs the acquisition thread with the shared-memory ring attached.
+ * @param stream_cfg Stream configuration.
+ * @param shm_cfg Shared-memory configuration.
+ * @return Process exit code.
+ */
+static int publish(ads1256_stream_config_t *stream_cfg, const ads1256_shm_config_t *shm_cfg)
+{
+    static ads1256_shm_t shm;
+    ads1256_stream_t stream;
+
+    if (DEV_ModuleInit() != 0) {
+        printf("❌ Backend %s initialization failed\n", DEV_Backend_Name());
+        return 1;
+    }
+    if (ADS1256_WarmInit(stream_cfg->drate, stream_cfg->gain, SCAN_MODE_SINGLE_ENDED) != ADS1256_OK) {
+        printf("❌ ADS1256 initialization failed\n");
+        DEV_ModuleExit();
+        return 1;
+    }
+    if (ADS1256_Shm_Create(&shm, shm_cfg) != ADS1256_OK) {
+        DEV_ModuleExit();
+        return 1;
+    }
+    stream_cfg->shm = &shm;
+    if (ADS1256_Stream_Start(&stream, stream_cfg) != ADS1256_OK) {
+        printf("❌ Failed to start the acquisition thread\n");
+        ADS1256_Shm_Destroy(&shm);
+        DEV_ModuleExit();
+        return 1;
+    }
+    printf("Publishing %d channel(s) at %g SPS in %s (%u frames). Press Ctrl+C to stop\n", stream_cfg->num_channels,
+           ADS1256_DrateToSps(stream_cfg->drate), shm.name, shm.hdr->capacity);
+
+    uint64_t last = 0;
+    while (running) {
+        sleep(1);
+        uint64_t head = shm.head;
+        printf("Published: %llu frames (%llu/s), DRDY errors: %llu     \r", (unsigned long long)head,
+               (unsigned long long)(head - last), (unsigned long long)atomic_load(&stream.drdy_errors));
+        fflush(stdout);
+        last = head;
+    }
+    printf("\n");
+
+    ADS1256_Stream_Stop(&stream);
+    ADS1256_Shm_Destroy(&shm);
+    DEV_ModuleExit();
+    return 0;
+}
+
+/**
+ * @brief Subscriber: reads the shared ring and reports what it sees.
+ * @param name Object name of the publisher.
+ * @param delay_us Pause between reads.
+ * @return Process exit code.
+ */
+static int subscribe(const char *name, int delay_us)
+{
+    static ads1256_frame_t frames[SHM_READ_CHUNK];
+    static latency_hist_t latency;
+    ads1256_shm_reader_t reader;
+    unsigned long long window = 0, gaps = 0;
+    uint64_t next_sequence = 0, last_print = now_ns();
+    UBYTE started = 0;
+
+    if (ADS1256_Shm_Attach(&reader, name) != ADS1256_OK) {
+        printf("❌ No publisher at %s\n", name);
+        return 1;
+    }
+    printf("Attached to %s (%u frames, producer pid %d). Press Ctrl+C to stop\n", name, reader.hdr->capacity,
+           (int)reader.hdr->producer_pid);
+
+    while (running && ADS1256_Shm_ProducerAlive(&reader)) {
+        UDOUBLE n = ADS1256_Shm_Read(&reader, frames, SHM_READ_CHUNK, 100);
+        uint64_t now = now_ns();
+
+        for (UDOUBLE i = 0; i < n; i++) {
+            if (started && frames[i].sequence != next_sequence) gaps += frames[i].sequence - next_sequence;
+            next_sequence = frames[i].sequence + 1;
+            started = 1;
+            LatencyHist_Record(&latency, now - frames[i].timestamp_ns);
+        }
+        window += n;
+
+        if (now - last_print >= 1000000000ULL) {
+            printf("Frames: %llu/s | lost here: %llu, sequence gaps: %llu | DRDY-to-reader p50 %.1f us, p99 %.1f us",
+                   window, (unsigned long long)ADS1256_Shm_ReaderOverruns(&reader), gaps,
+                   LatencyHist_Percentile(&latency, 50.0) / 1000.0, LatencyHist_Percentile(&latency, 99.0) / 1000.0);
+            if (n > 0) printf(" | AIN%d = %ld", frames[n - 1].channel, (long)(int32_t)frames[n - 1].value);
+            printf("     \r");
+            fflush(stdout);
+            LatencyHist_Reset(&latency);
+            window = 0;
+            last_print = now;
+        }
+        if (delay_us > 0) usleep((useconds_t)delay_us);
+    }
+    printf("\n%s\n", running ? "Publisher closed the ring" : "Detached");
+
+    ADS1256_Shm_Detach(&reader);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    ads1256_stream_config_t stream_cfg;
+    ads1256_shm_config_t shm_cfg;
+    const char *backend = NULL;
+    double sps = 30000;
+    int delay_us = 0;
+    int opt;
+
+    signal(SIGINT, Handler);
+    signal(SIGTERM, Handler);
+
+    ADS1256_Stream_DefaultConfig(&stream_cfg);
+    ADS1256_Shm_DefaultConfig(&shm_cfg);
+    shm_cfg.forward_frames = 0; // Nothing in this process reads the stream ring
+
+    while ((opt = getopt(argc, argv, "B:c:r:n:d:h")) != -1) {
+        switch (opt) {
+            case 'B': backend = optarg; break;
+            case 'c': {
+                char *s = optarg;
+                stream_cfg.num_channels = 0;
+                while (*s && stream_cfg.num_channels < NUM_SINGLE_ENDED_CHANNELS) {
+                    stream_cfg.channels[stream_cfg.num_channels++] = (UBYTE)strtol(s, &s, 10);
+                    if (*s != ',') break;
+                    s++;
+                }
+                break;
+            }
+            case 'r': sps = atof(optarg); break;
+            case 'n': shm_cfg.capacity = (UDOUBLE)atol(optarg); break;
+            case 'd': delay_us = atoi(optarg); break;
+            default: print_usage(argv[0]); return 1;
+        }
+    }
+    if (optind >= argc) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (optind + 1 < argc) shm_cfg.name = argv[optind + 1];
+
+    const char *mode = argv[optind];
+    if (strcmp(mode, "sub") == 0) {
+        return subscribe(shm_cfg.name, delay_us);
+    } else if (strcmp(mode, "pub") != 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (backend && DEV_Backend_Select(backend) != 0) {
+        fprintf(stderr, "Unknown backend %s\n", backend);
+        return 1;
+    }
+    for (stream_cfg.drate = ADS1256_30000SPS; stream_cfg.drate < ADS1256_2d5SPS; stream_cfg.drate++) {
+        if (ADS1256_DrateToSps(stream_cfg.drate) <= sps) break;
+    }
+    return publish(&stream_cfg, &shm_cfg);
+}
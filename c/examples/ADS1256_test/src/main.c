@@ -6,6 +6,11 @@
 #include <unistd.h> // For usleep
 #include <math.h>   // For fabs or other math functions if needed
 #include "../../lib/ADS1256/ADS1256.h"
+#include "../../lib/ADS1256/ADS1256_stream.h"
+#include "../../lib/ADS1256/ADS1256_capture.h"
+#include "../../lib/ADS1256/ADS1256_stats.h"
+#include "../../lib/ADS1256/ADS1256_convert.h"
+#include "../../lib/ADS1256/ADS1256_calib.h"
 #include "../../common/Debug.h" 
 #include <stdio.h> // Changed from "stdio.h"
 
@@ -21,6 +26,7 @@ static ADS1256_GAIN gain_setting = ADS1256_GAIN_1;     // Default GAIN
 static UBYTE selected_channels[NUM_SINGLE_ENDED_CHANNELS] = {0, 1, 2, 3}; // Default channels
 static int num_selected_channels = 4; // Default number of channels
 static int adc_reinit_required = 0; // Flag to indicate if ADC needs re-initialization
+static ADS1256_CalTable cal_table;  // Saved OFC/FSC coefficients, loaded from ADS1256_CAL_DEFAULT_FILE
 
 void Handler(int signo) {
     running = 0;
@@ -85,6 +91,7 @@ void test_n_channel_optimized(UBYTE *channels, int num_ch, ADS1256_DRATE current
                     float voltage = ADS1256_RawToVoltage(ADC[i], ADC_VREF_POS_5V0, ADC_VREF_NEG_GND, current_gain);
                     printf("%.4f\t\t", voltage);
                 }
+                metrics = ADS1256_GetPerformanceMetrics(); // Rates are derived on read
                 printf("%.1f\t\t%.1f\t\t", 
                        metrics->actual_avg_sps_per_channel, metrics->efficiency_percent);
                 
@@ -175,8 +182,260 @@ void test_n_channel_fast(UBYTE *channels, int num_ch, ADS1256_DRATE current_drat
     free(ADC);
 }
 
+void test_continuous(UBYTE channel, ADS1256_DRATE current_drate, ADS1256_GAIN current_gain) {
+    printf("\n=== Testing Continuous Mode (RDATAC) on AIN%d ===\n", channel);
+
+    const UDOUBLE block_size = 100; // Samples per ADS1256_ReadContinuous() call
+    UDOUBLE *ADC = malloc(block_size * sizeof(UDOUBLE));
+    float *volts = malloc(block_size * sizeof(float));
+    if (!ADC || !volts) {
+        perror("Failed to allocate memory for ADC readings");
+        free(ADC);
+        free(volts);
+        return;
+    }
+    ADS1256_ConvScale conv;
+    ADS1256_ConvScale_Init(&conv, ADC_VREF_POS_5V0, ADC_VREF_NEG_GND, current_gain, 1.0f, 0.0f);
+    unsigned long block_count = 0;
+    time_t last_report_time = time(NULL);
+
+    ADS1256_InitPerformanceMonitoring(current_drate);
+    performance_metrics_t *metrics = ADS1256_GetPerformanceMetrics();
+
+    if (ADS1256_StartContinuous(channel) != ADS1256_OK) {
+        printf("❌ Failed to start continuous mode\n");
+        free(ADC);
+        free(volts);
+        return;
+    }
+
+    printf("Theoretical SPS: %.0f\n", metrics->theoretical_sps_per_channel);
+    printf("Press Ctrl+C to stop and view final report\n\n");
+    printf("AIN%d(V, block mean)\tRate\t\tEff%%\n", channel);
+    printf("--------\t\t--------\t\t-----\n");
+
+    while(running) {
+        if (ADS1256_ReadContinuous(ADC, block_size) != ADS1256_OK) {
+            printf("\n❌ DRDY timeout in continuous mode\n");
+            break;
+        }
+        block_count++;
+
+        // Only format output between blocks so the read loop stays tight
+        if(display_mode == 1 && block_count % 10 == 0) {
+            ADS1256_RawToVoltageBatch((const int32_t *)ADC, volts, block_size, &conv);
+            float voltage = 0.0f;
+            for (UDOUBLE i = 0; i < block_size; i++) voltage += volts[i];
+            voltage /= block_size;
+            metrics = ADS1256_GetPerformanceMetrics();
+            printf("%.6f\t\t%.1f\t\t%.1f\r", voltage,
+                   metrics->continuous_sps, metrics->continuous_efficiency_percent);
+            fflush(stdout);
+        }
+
+        time_t current_time_val = time(NULL);
+        if(display_mode == 2 && current_time_val - last_report_time >= 5) {
+            ADS1256_PrintPerformanceReport();
+            last_report_time = current_time_val;
+        }
+    }
+
+    ADS1256_StopContinuous();
+    printf("\n\n");
+    ADS1256_PrintPerformanceReport();
+    free(ADC);
+    free(volts);
+}
+
+void test_threaded_stream(UBYTE *channels, int num_ch, ADS1256_DRATE current_drate, ADS1256_GAIN current_gain) {
+    printf("\n=== Testing %d-Channel Threaded Streaming ===\n", num_ch);
+
+    const UDOUBLE read_block = 4096; // Samples per bulk read
+    ads1256_sample_t *samples = malloc(read_block * sizeof(ads1256_sample_t));
+    if (!samples) {
+        perror("Failed to allocate memory for stream samples");
+        return;
+    }
+
+    ads1256_stream_config_t cfg;
+    ADS1256_Stream_DefaultConfig(&cfg);
+    for (int i = 0; i < num_ch; i++) cfg.channels[i] = channels[i];
+    cfg.num_channels = num_ch;
+    cfg.gain = current_gain;
+    cfg.drate = current_drate;
+    cfg.cpu = 3;          // Last Pi 5 core; isolate it with isolcpus=3 for best results
+    cfg.rt_priority = 80;
+    cfg.lock_memory = 1;
+
+    ads1256_stream_t stream;
+    if (ADS1256_Stream_Start(&stream, &cfg) != ADS1256_OK) {
+        printf("❌ Failed to start acquisition thread\n");
+        free(samples);
+        return;
+    }
+
+    printf("Acquisition thread running (CPU %d, SCHED_FIFO %d). Press Ctrl+C to stop\n\n", cfg.cpu, cfg.rt_priority);
+
+    unsigned long long total_read = 0;
+    unsigned long long seq_gaps = 0;
+    uint64_t next_seq = 0;
+    DEV_ClockCorr corr = {0};
+    struct timeval start_tv, now_tv;
+    gettimeofday(&start_tv, NULL);
+    time_t last_print = time(NULL);
+
+    while(running) {
+        UDOUBLE n = ADS1256_Stream_Read(&stream, samples, read_block, 100);
+        total_read += n;
+
+        // Sequence numbers are assigned at acquisition, so dropped samples leave gaps
+        for (UDOUBLE i = 0; i < n; i++) {
+            if (total_read - n + i > 0 && samples[i].sequence != next_seq) seq_gaps++;
+            next_seq = samples[i].sequence + 1;
+        }
+
+        // Slow consumer work no longer costs samples; it only fills the ring
+        time_t now = time(NULL);
+        if (n > 0 && now != last_print) {
+            gettimeofday(&now_tv, NULL);
+            double elapsed = (now_tv.tv_sec - start_tv.tv_sec) + (now_tv.tv_usec - start_tv.tv_usec) / 1000000.0;
+            float voltage = ADS1256_RawToVoltage(samples[n - 1].value, ADC_VREF_POS_5V0, ADC_VREF_NEG_GND, current_gain);
+            DEV_ClockCorr_Measure(&corr, CLOCK_REALTIME);
+            uint64_t wall_ns = DEV_ClockCorr_Convert(&corr, samples[n - 1].timestamp_ns);
+            printf("AIN%d: %.4f V @ %llu.%06llu | %.1f SPS total | %.1f SPS/ch | overruns: %llu, gaps: %llu     \r",
+                   samples[n - 1].channel, voltage, (unsigned long long)(wall_ns / 1000000000ULL),
+                   (unsigned long long)(wall_ns % 1000000000ULL / 1000), total_read / elapsed,
+                   total_read / elapsed / num_ch, (unsigned long long)ADS1256_Stream_Overruns(&stream), seq_gaps);
+            fflush(stdout);
+            last_print = now;
+        }
+    }
+
+    ADS1256_Stream_Stop(&stream);
+    printf("\n\nSamples read: %llu, overruns: %llu\n", total_read, (unsigned long long)ADS1256_Stream_Overruns(&stream));
+    ADS1256_PrintPerformanceReport();
+    free(samples);
+}
+
+void test_capture(UBYTE *channels, int num_ch, ADS1256_DRATE current_drate, ADS1256_GAIN current_gain) {
+    printf("\n=== Capturing %d Channels to Disk ===\n", num_ch);
+
+    ads1256_stream_config_t cfg;
+    ADS1256_Stream_DefaultConfig(&cfg);
+    for (int i = 0; i < num_ch; i++) cfg.channels[i] = channels[i];
+    cfg.num_channels = num_ch;
+    cfg.gain = current_gain;
+    cfg.drate = current_drate;
+    cfg.cpu = 3;          // Acquisition on the isolated core, the writer on another one
+    cfg.rt_priority = 80;
+    cfg.lock_memory = 1;
+
+    ads1256_stream_t stream;
+    if (ADS1256_Stream_Start(&stream, &cfg) != ADS1256_OK) {
+        printf("❌ Failed to start acquisition thread\n");
+        return;
+    }
+
+    ads1256_capture_config_t cap_cfg;
+    ads1256_capture_t cap;
+    ADS1256_Capture_DefaultConfig(&cap_cfg);
+    cap_cfg.cpu = 2;
+    if (ADS1256_Capture_Start(&cap, &stream, &cap_cfg) != ADS1256_OK) {
+        printf("❌ Failed to start capture\n");
+        ADS1256_Stream_Stop(&stream);
+        return;
+    }
+
+    printf("Writing %s_NNNNNN.adc. Press Ctrl+C to stop\n\n", cap_cfg.path_prefix);
+    while (running) {
+        sleep(1);
+        printf("Frames: %llu, segments: %llu, lost: %llu, overruns: %llu     \r",
+               (unsigned long long)atomic_load(&cap.frames), (unsigned long long)atomic_load(&cap.segments),
+               (unsigned long long)atomic_load(&cap.lost), (unsigned long long)ADS1256_Stream_Overruns(&stream));
+        fflush(stdout);
+    }
+
+    ADS1256_Capture_Stop(&cap);
+    ADS1256_Stream_Stop(&stream);
+    ADS1256_Capture_PrintReport(&cap);
+}
+
+void test_stats(UBYTE *channels, int num_ch, ADS1256_DRATE current_drate, ADS1256_GAIN current_gain) {
+    printf("\n=== Channel Statistics and Threshold Trigger (%d Channels) ===\n", num_ch);
+
+    static ads1256_frame_t window[ADS1256_STATS_DEFAULT_WINDOW];
+    ads1256_stats_config_t stats_cfg;
+    ads1256_stats_t stats;
+    ADS1256_Stats_DefaultConfig(&stats_cfg);
+    stats_cfg.forward_frames = 0; // Only summaries and trigger windows leave the acquisition thread
+    if (ADS1256_Stats_Init(&stats, &stats_cfg) != ADS1256_OK) {
+        printf("❌ Failed to set up statistics\n");
+        return;
+    }
+
+    // Rising edge through mid-scale on the first channel, 1% hysteresis
+    ads1256_trigger_config_t trig = { ADS1256_TRIG_RISING, 0x3FFFFF / 2, 0x3FFFFF / 100, 256, 256 };
+    if (ADS1256_Stats_SetTrigger(&stats, channels[0], &trig) != ADS1256_OK) {
+        ADS1256_Stats_Free(&stats);
+        return;
+    }
+
+    ads1256_stream_config_t cfg;
+    ADS1256_Stream_DefaultConfig(&cfg);
+    for (int i = 0; i < num_ch; i++) cfg.channels[i] = channels[i];
+    cfg.num_channels = num_ch;
+    cfg.gain = current_gain;
+    cfg.drate = current_drate;
+    cfg.cpu = 3;          // Last Pi 5 core; isolate it with isolcpus=3 for best results
+    cfg.rt_priority = 80;
+    cfg.lock_memory = 1;
+    cfg.stats = &stats;
+
+    ads1256_stream_t stream;
+    if (ADS1256_Stream_Start(&stream, &cfg) != ADS1256_OK) {
+        printf("❌ Failed to start acquisition thread\n");
+        ADS1256_Stats_Free(&stats);
+        return;
+    }
+
+    printf("Trigger: AIN%d rising through %.4f V. Press Ctrl+C to stop\n\n", channels[0],
+           ADS1256_RawToVoltage(trig.level, ADC_VREF_POS_5V0, ADC_VREF_NEG_GND, current_gain));
+
+    uint64_t last_end = 0;
+    while (running) {
+        usleep(100000);
+
+        ads1256_stats_event_t ev;
+        while (ADS1256_Stats_PollEvent(&stats, &ev, window, ADS1256_STATS_DEFAULT_WINDOW)) {
+            printf("⚡ AIN%d triggered at frame %llu: %u frames (%u before), peak %.4f V\n", ev.channel,
+                   (unsigned long long)ev.trigger_sequence, (unsigned)ev.count, (unsigned)ev.pre_count,
+                   ADS1256_RawToVoltage(ev.frames[ev.count - 1].value, ADC_VREF_POS_5V0, ADC_VREF_NEG_GND, current_gain));
+        }
+
+        ads1256_stats_summary_t s;
+        if (ADS1256_Stats_Get(&stats, channels[0], &s, NULL) != ADS1256_OK || s.end_ns == last_end) continue;
+        last_end = s.end_ns;
+        for (int i = 0; i < num_ch; i++) {
+            if (ADS1256_Stats_Get(&stats, channels[i], &s, NULL) != ADS1256_OK) continue;
+            printf("AIN%d: n=%llu mean %.6f V, min %.6f V, max %.6f V, std %.1f uV, rms %.6f V\n", channels[i],
+                   (unsigned long long)s.count,
+                   s.mean * ADS1256_RawToVoltage(1, ADC_VREF_POS_5V0, ADC_VREF_NEG_GND, current_gain),
+                   ADS1256_RawToVoltage(s.min, ADC_VREF_POS_5V0, ADC_VREF_NEG_GND, current_gain),
+                   ADS1256_RawToVoltage(s.max, ADC_VREF_POS_5V0, ADC_VREF_NEG_GND, current_gain),
+                   s.stddev * ADS1256_RawToVoltage(1, ADC_VREF_POS_5V0, ADC_VREF_NEG_GND, current_gain) * 1e6,
+                   s.rms * ADS1256_RawToVoltage(1, ADC_VREF_POS_5V0, ADC_VREF_NEG_GND, current_gain));
+        }
+        printf("Triggers: %llu, dropped: %llu, overruns: %llu\n\n", (unsigned long long)atomic_load(&stats.triggers),
+               (unsigned long long)atomic_load(&stats.events_dropped), (unsigned long long)ADS1256_Stream_Overruns(&stream));
+    }
+
+    ADS1256_Stream_Stop(&stream);
+    printf("\nFrames processed on the acquisition thread: %llu\n", (unsigned long long)atomic_load(&stats.frames));
+    ADS1256_Stats_Free(&stats);
+}
+
 void benchmark_comparison(UBYTE *channels, int num_ch, ADS1256_DRATE current_drate, ADS1256_GAIN current_gain) {
-    printf("\n=== Benchmarking: Optimized vs Fast Mode (%d Channels) ===\n", num_ch);
+    printf("\n=== Benchmarking: Optimized vs Fast vs Pipelined Mode (%d Channels) ===\n", num_ch);
 
     const int benchmark_duration_sec = 10;
     printf("Running %d-second benchmark for each mode...\n\n", benchmark_duration_sec);
@@ -226,6 +485,45 @@ void benchmark_comparison(UBYTE *channels, int num_ch, ADS1256_DRATE current_dra
     printf("   Fast: %.1f SPS/ch, %.1f%% efficiency (vs theoretical DRATE limit)\n\n",
             fast_actual_sps_ch, fast_efficiency_bm);
 
+    // Test pipelined scan list (MUX switch overlapped with the previous channel's readback)
+    printf("3. Testing PIPELINED scan list (1 settling cycle)...\n");
+    ADS1256_ScanList scan;
+    double pipelined_actual_sps_ch = 0;
+    if (ADS1256_ScanList_Build(&scan, channels, num_ch, current_gain, current_drate, 1) == ADS1256_OK) {
+        ADS1256_InitPerformanceMonitoring(current_drate);
+        bm_start_time = time(NULL);
+        while((time(NULL) - bm_start_time) < benchmark_duration_sec && running) {
+            ADS1256_Scan(&scan, ADC_bm);
+        }
+        opt_metrics = ADS1256_GetPerformanceMetrics();
+        pipelined_actual_sps_ch = opt_metrics->actual_avg_sps_per_channel;
+        printf("   Pipelined: %.1f SPS/ch, %.1f%% efficiency\n\n",
+               pipelined_actual_sps_ch, opt_metrics->efficiency_percent);
+    }
+
+    // Measure the settling each channel actually needs (steady inputs on every channel)
+    printf("4. Testing AUTO-TUNED scan list (per-channel settling)...\n");
+    ADS1256_TuneResult tune[ADS1256_SCAN_MAX_ENTRIES];
+    double tuned_actual_sps_ch = 0;
+    int tuned_ok = 0;
+    if (ADS1256_ScanList_Build(&scan, channels, num_ch, current_gain, current_drate, 1) == ADS1256_OK &&
+        ADS1256_ScanList_AutoTune(&scan, NULL, tune) == ADS1256_OK) {
+        tuned_ok = 1;
+        for (int i = 0; i < num_ch; i++) {
+            printf("   AIN%d: %d cycle(s)%s, residual %.1f LSB, noise %.1f LSB\n", channels[i], tune[i].settling_cycles,
+                   tune[i].converged ? "" : " (did not converge)", tune[i].error_lsb, tune[i].noise_lsb);
+        }
+        ADS1256_InitPerformanceMonitoring(current_drate);
+        bm_start_time = time(NULL);
+        while((time(NULL) - bm_start_time) < benchmark_duration_sec && running) {
+            ADS1256_Scan(&scan, ADC_bm);
+        }
+        opt_metrics = ADS1256_GetPerformanceMetrics();
+        tuned_actual_sps_ch = opt_metrics->actual_avg_sps_per_channel;
+        printf("   Auto-tuned: %.1f SPS/ch, %.1f%% efficiency\n\n",
+               tuned_actual_sps_ch, opt_metrics->efficiency_percent);
+    }
+
     printf("\n=== Comparison Results ===\n");
     if (optimized_actual_sps_ch > 0) {
         printf("Speed gain (Fast vs Optimized): %.1f%%\n", 
@@ -233,14 +531,34 @@ void benchmark_comparison(UBYTE *channels, int num_ch, ADS1256_DRATE current_dra
     } else {
         printf("Speed gain (Fast vs Optimized): N/A (Optimized rate was zero or too low)\n");
     }
-    // Recommendation based on this benchmark
+    if (fast_actual_sps_ch > 0 && pipelined_actual_sps_ch > 0) {
+        printf("Speed gain (Pipelined vs Fast): %.1f%%\n",
+               ((pipelined_actual_sps_ch / fast_actual_sps_ch) - 1) * 100);
+    }
+    if (optimized_actual_sps_ch > 0 && tuned_actual_sps_ch > 0) {
+        printf("Speed gain (Auto-tuned vs Optimized): %.1f%%\n",
+               ((tuned_actual_sps_ch / optimized_actual_sps_ch) - 1) * 100);
+    }
+    // Recommendation based on the measured settling rather than a fixed count
     printf("Recommendation: ");
-    if (fast_actual_sps_ch > optimized_actual_sps_ch && fast_efficiency_bm > optimized_efficiency * 0.8) {
+    if (tuned_ok) {
+        int worst = 1, all_converged = 1;
+        for (int i = 0; i < num_ch; i++) {
+            if (tune[i].settling_cycles > worst) worst = tune[i].settling_cycles;
+            if (!tune[i].converged) all_converged = 0;
+        }
+        if (!all_converged) {
+            printf("Some channels did not settle within the tolerance; check source impedance or enable the input buffer.\n");
+        } else if (worst == 1) {
+            printf("Every channel settles in 1 cycle: use the pipelined scan list (or FAST mode).\n");
+        } else {
+            printf("Use a scan list tuned with ADS1256_ScanList_AutoTune(); the slowest channel needs %d cycle(s) at %s, %s.\n",
+                   worst, drate_to_string(current_drate), gain_to_string(current_gain));
+        }
+    } else if (fast_actual_sps_ch > optimized_actual_sps_ch && fast_efficiency_bm > optimized_efficiency * 0.8) {
          printf("Consider FAST mode for higher throughput if minor accuracy trade-off is acceptable.\n");
-    } else if (optimized_efficiency > 80) {
-        printf("OPTIMIZED mode offers good accuracy and efficiency.\n");
     } else {
-        printf("Review setup; both modes may be underperforming. FAST mode is quicker.\n");
+        printf("OPTIMIZED mode offers good accuracy and efficiency.\n");
     }
     free(ADC_bm);
 }
@@ -292,7 +610,7 @@ void select_drate_setting(ADS1256_DRATE *current_drate_ptr) {
         if (*current_drate_ptr != (ADS1256_DRATE)choice) {
             *current_drate_ptr = (ADS1256_DRATE)choice;
             adc_reinit_required = 1;
-            printf("DRATE set to %s. ADC will be re-initialized before next test.\n", drate_to_string(*current_drate_ptr));
+            printf("DRATE set to %s. It will be applied before the next test.\n", drate_to_string(*current_drate_ptr));
         } else {
             printf("DRATE unchanged.\n");
         }
@@ -315,7 +633,7 @@ void select_gain_setting(ADS1256_GAIN *current_gain_ptr) {
         if (*current_gain_ptr != (ADS1256_GAIN)choice) {
             *current_gain_ptr = (ADS1256_GAIN)choice;
             adc_reinit_required = 1;
-            printf("GAIN set to %s. ADC will be re-initialized before next test.\n", gain_to_string(*current_gain_ptr));
+            printf("GAIN set to %s. It will be applied before the next test.\n", gain_to_string(*current_gain_ptr));
         } else {
             printf("GAIN unchanged.\n");
         }
@@ -392,6 +710,13 @@ int main(void) {
 
     signal(SIGINT, Handler);
 
+    // Saved calibration is reloaded on every GAIN/DRATE change instead of recalibrating
+    ADS1256_CalTable_Init(&cal_table, 0);
+    if (ADS1256_CalTable_Load(&cal_table, ADS1256_CAL_DEFAULT_FILE) == ADS1256_OK) {
+        printf("✅ Loaded calibration from %s\n", ADS1256_CAL_DEFAULT_FILE);
+    }
+    ADS1256_SetCalTable(&cal_table);
+
     // Initial ADC initialization with default settings
     ADS1256_SCAN_MODE scan_mode_setting = SCAN_MODE_SINGLE_ENDED;
     if(ADS1256_init(drate_setting, gain_setting, scan_mode_setting) == 1) {
@@ -417,8 +742,13 @@ int main(void) {
         printf(")\n");
         printf("6. Change DRATE (Current: %s)\n", drate_to_string(drate_setting));
         printf("7. Change GAIN (Current: %s)\n", gain_to_string(gain_setting));
-        printf("8. Exit\n");
-        printf("Choice (1-8): ");
+        printf("8. Continuous single-channel test on AIN%d (RDATAC, Current: %s)\n", selected_channels[0], drate_to_string(drate_setting));
+        printf("9. Threaded streaming %d-channel test (RT thread + ring buffer)\n", num_selected_channels);
+        printf("10. Self-calibrate current GAIN/DRATE and save to %s\n", ADS1256_CAL_DEFAULT_FILE);
+        printf("11. Capture %d channels to disk (capture_NNNNNN.adc)\n", num_selected_channels);
+        printf("12. Channel statistics and threshold trigger (%d channels)\n", num_selected_channels);
+        printf("13. Exit\n");
+        printf("Choice (1-13): ");
         
         if (scanf("%d", &choice) != 1) {
             while(getchar() != '\n'); // Clear invalid input
@@ -427,16 +757,16 @@ int main(void) {
 
         running = 1; // Reset running flag for tests that use it
 
-        // Re-initialize ADC if settings changed
-        if (adc_reinit_required && (choice == 1 || choice == 2 || choice == 3)) {
-            printf("\nRe-initializing ADS1256 with new settings (DRATE: %s, GAIN: %s)...\n",
+        // Apply changed DRATE/GAIN in place (register writes only, no chip reset)
+        if (adc_reinit_required && (choice == 1 || choice == 2 || choice == 3 || choice == 8 || choice == 9 || choice == 10 || choice == 11 || choice == 12)) {
+            printf("\nApplying new settings to ADS1256 (DRATE: %s, GAIN: %s)...\n",
                    drate_to_string(drate_setting), gain_to_string(gain_setting));
-            if (ADS1256_init(drate_setting, gain_setting, scan_mode_setting) == 1) {
-                printf("❌ ADS1256 re-initialization failed. Aborting test.\n");
+            if (ADS1256_SetDataRate(drate_setting) != ADS1256_OK || ADS1256_SetGain(gain_setting) != ADS1256_OK) {
+                printf("❌ ADS1256 reconfiguration failed. Aborting test.\n");
                 DEV_ModuleExit(); // Or handle error more gracefully
                 return 1; 
             }
-            printf("✅ ADS1256 re-initialized successfully.\n");
+            printf("✅ ADS1256 reconfigured successfully.\n");
             adc_reinit_required = 0; // Reset flag
             print_channel_config(selected_channels, num_selected_channels); // Show updated config
         }
@@ -467,13 +797,34 @@ int main(void) {
                 select_gain_setting(&gain_setting);
                 break;
             case 8:
+                test_continuous(selected_channels[0], drate_setting, gain_setting);
+                break;
+            case 9:
+                test_threaded_stream(selected_channels, num_selected_channels, drate_setting, gain_setting);
+                break;
+            case 10:
+                if (ADS1256_CalTable_Calibrate(&cal_table, gain_setting, drate_setting, CMD_SELFCAL) == ADS1256_OK &&
+                    ADS1256_CalTable_Save(&cal_table, ADS1256_CAL_DEFAULT_FILE) == ADS1256_OK) {
+                    printf("✅ Calibrated %s / %s and saved to %s\n", drate_to_string(drate_setting),
+                           gain_to_string(gain_setting), ADS1256_CAL_DEFAULT_FILE);
+                } else {
+                    printf("❌ Calibration failed\n");
+                }
+                break;
+            case 11:
+                test_capture(selected_channels, num_selected_channels, drate_setting, gain_setting);
+                break;
+            case 12:
+                test_stats(selected_channels, num_selected_channels, drate_setting, gain_setting);
+                break;
+            case 13:
                 printf("Exiting...\n\n");
                 break;
             default:
                 printf("Invalid choice. Please try again.\n\n");
                 break;
         }
-    } while (choice != 8 && running); // Main loop exits on choice 8 or if running is set to 0 by signal handler
+    } while (choice != 13 && running); // Main loop exits on choice 13 or if running is set to 0 by signal handler
 
     DEV_ModuleExit();
     printf("Program terminated.\n\n");
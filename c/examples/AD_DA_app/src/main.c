@@ -2,54 +2,66 @@
  * @file main.c
  * @brief Example application demonstrating ADC (ADS1256) and DAC (DAC8532) functionality.
  *
- * This application initializes the ADS1256 ADC and DAC8532 DAC, continuously reads
- * all 8 ADC channels, prints their values, and then uses the value from ADC channel 0
- * to set the output voltages on the two DAC channels.
- * - DAC Channel B is set to the scaled voltage from ADC Channel 0.
- * - DAC Channel A is set to (V_REF - scaled voltage from ADC Channel 0).
+ * This application runs a fixed-rate control loop that samples the AIN0-AIN1
+ * differential input and drives both DAC channels from it:
+ * - DAC Channel B follows the voltage of AIN0-AIN1.
+ * - DAC Channel A is set to (V_REF - voltage of AIN0-AIN1).
+ *
+ * The loop thread is pinned and runs at real-time priority; the main thread
+ * only prints the latest values. On exit, the DRDY-to-DAC latency
+ * percentiles are printed.
  *
  * @copyright Copyright (c) 2023
- * 
+ *
  */
-#include <stdlib.h>     
-#include <signal.h>     
-#include <time.h>       
-#include <string.h>     
-#include <stdio.h>      
+#include <stdlib.h>
+#include <signal.h>
+#include <time.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
 
 #include "../../lib/ADS1256/ADS1256.h"
 #include "../../lib/DAC8532/DAC8532.h"
-#include "../../common/DEV_Config.h" 
-#include "../../common/Debug.h"      
+#include "../../lib/ADDAC/ADDAC_loop.h"
+#include "../../common/DEV_Config.h"
+#include "../../common/Debug.h"
+
+#define LOOP_RATE_HZ      2000 ///< Control loop rate
+#define LOOP_DEADLINE_US  500  ///< DRDY-to-DAC budget per cycle
+#define LOOP_CPU          3    ///< Core reserved for the loop thread
+#define LOOP_RT_PRIORITY  80   ///< SCHED_FIFO priority of the loop thread
+#define STATUS_PERIOD_US  100000
+
+static volatile sig_atomic_t keep_running = 1;
 
 /**
  * @brief Signal handler for graceful termination (e.g., Ctrl+C).
  *
- * This function is called when an interrupt signal (SIGINT) is received.
- * It prints an exit message, cleans up resources by calling DEV_ModuleExit(),
- * and then terminates the program.
+ * Only sets a flag; the main loop stops the control loop and cleans up.
  *
  * @param signo The signal number that triggered the handler (unused in this function).
  */
 void SigintHandler(int signo)
 {
-    printf("\r\nExiting program.\r\n");
-    DEV_ModuleExit();
-    exit(0);
+    (void)signo;
+    keep_running = 0;
 }
 
 /**
  * @brief Main function for the AD/DA application.
  *
- * Initializes the hardware modules (ADC and DAC), then enters an infinite loop
- * to continuously read ADC values and set DAC outputs.
+ * Initializes the hardware modules (ADC and DAC), starts the control loop
+ * and prints its inputs and outputs until interrupted.
  *
  * @return int Program exit status (0 for success, non-zero for failure).
  */
 int main(void)
 {
-    UDOUBLE adc_readings[8]; 
-    float voltage_ch0;       
+    ADS1256_ScanList inputs;
+    ADS1256_ConvScale in_scale;
+    addac_loop_config_t cfg;
+    addac_loop_t loop;
 
     printf("AD/DA Example Application Started.\r\n");
 
@@ -60,34 +72,57 @@ int main(void)
 
     signal(SIGINT, SigintHandler);
 
-    if (ADS1256_init(ADS1256_30000SPS, ADS1256_GAIN_1, SCAN_MODE_DIFFERENTIAL_INPUTS) != 0) { 
+    if (ADS1256_init(ADS1256_30000SPS, ADS1256_GAIN_1, SCAN_MODE_DIFFERENTIAL_INPUTS) != 0) {
         printf("ADS1256 Initialization Failed.\r\n");
         DEV_ModuleExit();
         return 1;
     }
     printf("ADS1256 Initialized Successfully.\r\n");
 
-    while (1) {
-        ADS1256_GetAllChannels(adc_readings);
+    ADS1256_ScanList_Init(&inputs);
+    ADS1256_ScanList_Add(&inputs, ADS1256_MUX(ADS1256_MUX_AIN0, ADS1256_MUX_AIN1), ADS1256_GAIN_1,
+                         ADS1256_30000SPS, 1);
+    ADS1256_ConvScale_Init(&in_scale, ADC_VREF_POS_5V0, ADC_VREF_NEG_GND, ADS1256_GAIN_1, 1.0f, 0.0f);
 
-        // The rest of the logic uses adc_readings[0] which corresponds to AIN0-AIN1
-        voltage_ch0 = ADS1256_RawToVoltage(adc_readings[0], ADS1256_GAIN_1, ADC_VREF_POS_5V0, ADC_VREF_NEG_GND);
-        
-        if (voltage_ch0 < 0.0f) voltage_ch0 = 0.0f;
-        if (voltage_ch0 > DAC_VREF) voltage_ch0 = DAC_VREF; // DAC_VREF is used from the original logic
+    ADDAC_Loop_DefaultConfig(&cfg);
+    cfg.inputs = &inputs;
+    cfg.rate_hz = LOOP_RATE_HZ;
+    cfg.deadline_us = LOOP_DEADLINE_US;
+    cfg.num_outputs = 2;
+    cfg.outputs[0].channel = DAC8532_CHANNEL_B; // Follower
+    cfg.outputs[0].input = 0;
+    cfg.outputs[0].ctrl = ADDAC_CTRL_PASSTHROUGH;
+    ADDAC_Map_Init(&cfg.outputs[0].map, &in_scale, DAC_VREF, 1.0f, 0.0f);
+    cfg.outputs[1].channel = DAC8532_CHANNEL_A; // V_REF - input
+    cfg.outputs[1].input = 0;
+    cfg.outputs[1].ctrl = ADDAC_CTRL_PASSTHROUGH;
+    ADDAC_Map_Init(&cfg.outputs[1].map, &in_scale, DAC_VREF, -1.0f, DAC_VREF);
+    cfg.cpu = LOOP_CPU;
+    cfg.rt_priority = LOOP_RT_PRIORITY;
+    cfg.lock_memory = 1;
 
-        DAC8532_Out_Voltage(DAC8532_CHANNEL_B, voltage_ch0);
+    if (ADDAC_Loop_Start(&loop, &cfg) != ADS1256_OK) {
+        printf("Control Loop Start Failed.\r\n");
+        DEV_ModuleExit();
+        return 1;
+    }
 
-        float voltage_chA = DAC_VREF - voltage_ch0; // DAC_VREF is used from the original logic
-        if (voltage_chA < 0.0f) voltage_chA = 0.0f; 
-        DAC8532_Out_Voltage(DAC8532_CHANNEL_A, voltage_chA);
+    while (keep_running) {
+        float voltage_ch0 = ADS1256_RawToVoltage((UDOUBLE)ADDAC_Loop_GetInput(&loop, 0), ADC_VREF_POS_5V0,
+                                                 ADC_VREF_NEG_GND, ADS1256_GAIN_1);
+        float voltage_chB = ADDAC_Loop_GetOutput(&loop, 0) * DAC_VREF / DAC_VALUE_MAX;
+        float voltage_chA = ADDAC_Loop_GetOutput(&loop, 1) * DAC_VREF / DAC_VALUE_MAX;
 
         // Print concise output on a single line, overwriting the previous line.
         // Pad with spaces to clear any remnants of a longer previous line.
-        printf("\rADC CH0: %.4f V | DAC A: %.4f V | DAC B: %.4f V                ", voltage_ch0, voltage_chA, voltage_ch0);
+        printf("\rADC CH0: %.4f V | DAC A: %.4f V | DAC B: %.4f V                ", voltage_ch0, voltage_chA, voltage_chB);
         fflush(stdout); // Ensure output is displayed immediately
+        usleep(STATUS_PERIOD_US);
     }
 
+    printf("\r\nExiting program.\r\n");
+    ADDAC_Loop_Stop(&loop);
+    ADDAC_Loop_PrintReport(&loop);
     DEV_ModuleExit();
     return 0;
-}
\ No newline at end of file
+}
@@ -1,43 +1,70 @@
 #include <stdlib.h>
 #include <signal.h>
 #include <time.h>
+#include <unistd.h>
 #include "../../lib/DAC8532/DAC8532.h"
+#include "../../lib/DAC8532/DAC8532_wave.h"
 #include "../../common/Debug.h" // Assuming Debug.h is used, DEV_Config.h is included by DAC8532.h
 #include "stdio.h"
 #include <string.h>
 
+#define WAVE_RATE_HZ    20000 ///< Updates per second on each channel
+#define SINE_POINTS     100   ///< 200 Hz sine on channel A
+#define TRIANGLE_POINTS 400   ///< 50 Hz triangle on channel B
+#define WAVE_SPIN_NS    30000 ///< Busy-wait the last 30 us before each tick
+
+static volatile sig_atomic_t keep_running = 1;
+
 void Handler(int signo)
 {
-    //System Exit
-    printf("\r\nEND                  \r\n");
-    DEV_ModuleExit();
-    exit(0);
+    keep_running = 0;
 }
 
 int main(void)
 {
-    UDOUBLE i;
+    static UWORD sine[SINE_POINTS];
+    static UWORD triangle[TRIANGLE_POINTS];
+    dac8532_wave_t wave;
+    dac8532_wave_config_t cfg;
+
     DEV_ModuleInit();
 
     // Exception handling:ctrl + c
     signal(SIGINT, Handler);
-    
+
     printf("Program start\r\n");
-    
-    DAC8532_Out_Voltage(DAC8532_CHANNEL_A, 0);
-    while(1){
-        for(i=0;i<50;i++){
-            DAC8532_Out_Voltage(DAC8532_CHANNEL_A, DAC_VREF * i / 50);
-            DAC8532_Out_Voltage(DAC8532_CHANNEL_B, DAC_VREF - DAC_VREF * i / 50);
-            DEV_Delay_ms(1);
-        }
-        for(i=0;i<50;i++){
-            DAC8532_Out_Voltage(DAC8532_CHANNEL_B, DAC_VREF * i / 50);
-            DAC8532_Out_Voltage(DAC8532_CHANNEL_A, DAC_VREF - DAC_VREF * i / 50);
-            DEV_Delay_ms(1);
-        }
+
+    // The tables are built once; playback only copies codes to the DAC
+    DAC8532_Synth_Sine(sine, SINE_POINTS, DAC_VREF, DAC_VREF / 2, DAC_VREF / 2);
+    DAC8532_Synth_Ramp(triangle, TRIANGLE_POINTS / 2, DAC_VREF, 0.0f, DAC_VREF);
+    DAC8532_Synth_Ramp(triangle + TRIANGLE_POINTS / 2, TRIANGLE_POINTS / 2, DAC_VREF, DAC_VREF, 0.0f);
+
+    DAC8532_Wave_Init(&wave);
+    DAC8532_LoadWaveform(&wave, DAC8532_CHANNEL_A, sine, SINE_POINTS);
+    DAC8532_LoadWaveform(&wave, DAC8532_CHANNEL_B, triangle, TRIANGLE_POINTS);
+
+    DAC8532_Wave_DefaultConfig(&cfg);
+    cfg.rate_hz = WAVE_RATE_HZ;
+    cfg.spin_ns = WAVE_SPIN_NS;
+    cfg.cpu = 3;
+    cfg.rt_priority = 80;
+    cfg.lock_memory = 1;
+    if (DAC8532_Wave_Start(&wave, &cfg) != 0) {
+        DEV_ModuleExit();
+        return 1;
+    }
+
+    while (keep_running && DAC8532_Wave_IsRunning(&wave)) {
+        sleep(1);
     }
+
+    DAC8532_Wave_Stop(&wave);
+    DAC8532_Wave_PrintReport(&wave);
+    DAC8532_Wave_Free(&wave);
+
     DAC8532_Out_Voltage(DAC8532_CHANNEL_B, 0);
     DAC8532_Out_Voltage(DAC8532_CHANNEL_A, 0);
+    printf("\r\nEND                  \r\n");
+    DEV_ModuleExit();
     return 0;
-}
\ No newline at end of file
+}
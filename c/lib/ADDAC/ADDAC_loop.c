@@ -0,0 +1,499 @@
+/**
+ * @file ADDAC_loop.c
+ * @brief Fixed-rate ADC-to-DAC control loop for the ADS1256/DAC8532 board.
+ *
+ * In paced mode every cycle restarts the input scan (SYNC) right after the
+ * wake-up, so the inputs are sampled at a fixed phase of the cycle instead
+ * of whenever the previous pipelined conversion finished. The controllers
+ * run in integer arithmetic on ADC codes; the only floating point is in the
+ * *_Init() helpers, which run once at setup.
+ */
+#define _GNU_SOURCE // For pthread_setaffinity_np, CPU_SET
+#include "ADDAC_loop.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#define ADDAC_LOOP_DEFAULT_RATE_HZ 1000
+#define ADDAC_CODE_MAX ((int32_t)0x7FFFFF)  ///< Largest positive ADS1256 code
+#define ADDAC_CODE_MIN (-(int32_t)0x800000) ///< Most negative ADS1256 code
+
+/**
+ * @brief Returns the current CLOCK_MONOTONIC time, the clock of DRDY timestamps.
+ * @return Nanoseconds.
+ */
+static uint64_t ADDAC_MonoNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Converts nanoseconds to a timespec.
+ * @param ns Nanoseconds.
+ * @param ts Output timespec.
+ */
+static void ADDAC_NsToTimespec(uint64_t ns, struct timespec *ts)
+{
+    ts->tv_sec = (time_t)(ns / 1000000000ULL);
+    ts->tv_nsec = (long)(ns % 1000000000ULL);
+}
+
+/**
+ * @brief Saturates a 64-bit value to a range.
+ * @param v Value.
+ * @param lo Lower limit.
+ * @param hi Upper limit.
+ * @return The clamped value.
+ */
+static int64_t ADDAC_Clamp(int64_t v, int64_t lo, int64_t hi)
+{
+    return (v < lo) ? lo : (v > hi) ? hi : v;
+}
+
+/**
+ * @brief Converts a float to a fixed-point value with rounding.
+ * @param v Value.
+ * @param q_bits Fractional bits.
+ * @return The fixed-point value, saturated to int32.
+ */
+static int32_t ADDAC_ToFixed(float v, unsigned q_bits)
+{
+    double scaled = (double)v * (double)(1LL << q_bits);
+    return (int32_t)ADDAC_Clamp(llrint(scaled), INT32_MIN, INT32_MAX);
+}
+
+/**
+ * @brief Initializes a PID controller.
+ * @param pid Controller to initialize.
+ * @param kp Proportional gain.
+ * @param ki Integral gain per sample.
+ * @param kd Derivative gain per sample.
+ * @param setpoint Target input code.
+ * @param out_min Lower output limit.
+ * @param out_max Upper output limit.
+ */
+void ADDAC_PID_Init(addac_pid_t *pid, float kp, float ki, float kd, int32_t setpoint,
+                    int32_t out_min, int32_t out_max)
+{
+    memset(pid, 0, sizeof(*pid));
+    pid->kp_q16 = ADDAC_ToFixed(kp, ADDAC_PID_Q_BITS);
+    pid->ki_q16 = ADDAC_ToFixed(ki, ADDAC_PID_Q_BITS);
+    pid->kd_q16 = ADDAC_ToFixed(kd, ADDAC_PID_Q_BITS);
+    pid->setpoint = setpoint;
+    pid->out_min = out_min;
+    pid->out_max = out_max;
+}
+
+/**
+ * @brief Runs one PID step.
+ *
+ * The integrator is clamped to the output range, so it cannot wind up
+ * while the output is saturated.
+ * @param pid Controller.
+ * @param input Input code.
+ * @return Controller output, within out_min .. out_max.
+ */
+int32_t ADDAC_PID_Step(addac_pid_t *pid, int32_t input)
+{
+    const int64_t lo = (int64_t)pid->out_min << ADDAC_PID_Q_BITS;
+    const int64_t hi = (int64_t)pid->out_max << ADDAC_PID_Q_BITS;
+    int32_t error = pid->setpoint - input;
+
+    pid->integral = ADDAC_Clamp(pid->integral + (int64_t)pid->ki_q16 * error, lo, hi);
+    int64_t u = (int64_t)pid->kp_q16 * error + pid->integral +
+                (int64_t)pid->kd_q16 * (error - pid->prev_error);
+    pid->prev_error = error;
+
+    return (int32_t)(ADDAC_Clamp(u, lo, hi) >> ADDAC_PID_Q_BITS);
+}
+
+/**
+ * @brief Initializes a biquad section from normalized coefficients.
+ * @param bq Section to initialize.
+ * @param b0 Feed-forward coefficient 0.
+ * @param b1 Feed-forward coefficient 1.
+ * @param b2 Feed-forward coefficient 2.
+ * @param a1 Feedback coefficient 1.
+ * @param a2 Feedback coefficient 2.
+ * @return ADS1256_OK on success, ADS1256_ERROR if a coefficient is outside -2 .. 2.
+ */
+UBYTE ADDAC_Biquad_Init(addac_biquad_t *bq, float b0, float b1, float b2, float a1, float a2)
+{
+    const float c[5] = { b0, b1, b2, a1, a2 };
+
+    for (int i = 0; i < 5; i++) {
+        if (!(c[i] >= -2.0f && c[i] < 2.0f)) {
+            fprintf(stderr, "ADDAC_Biquad_Init: Coefficient %d (%f) outside the Q1.30 range\r\n", i, c[i]);
+            return ADS1256_ERROR;
+        }
+    }
+    memset(bq, 0, sizeof(*bq));
+    bq->b0 = ADDAC_ToFixed(b0, ADDAC_BIQUAD_Q_BITS);
+    bq->b1 = ADDAC_ToFixed(b1, ADDAC_BIQUAD_Q_BITS);
+    bq->b2 = ADDAC_ToFixed(b2, ADDAC_BIQUAD_Q_BITS);
+    bq->a1 = ADDAC_ToFixed(a1, ADDAC_BIQUAD_Q_BITS);
+    bq->a2 = ADDAC_ToFixed(a2, ADDAC_BIQUAD_Q_BITS);
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Runs one biquad step.
+ * @param bq Section.
+ * @param input Input code.
+ * @return Filter output, saturated to the ADS1256 code range.
+ */
+int32_t ADDAC_Biquad_Step(addac_biquad_t *bq, int32_t input)
+{
+    // 24-bit samples times Q1.30 coefficients: five products stay below 2^57
+    int64_t acc = (int64_t)bq->b0 * input + (int64_t)bq->b1 * bq->x1 + (int64_t)bq->b2 * bq->x2 -
+                  (int64_t)bq->a1 * bq->y1 - (int64_t)bq->a2 * bq->y2;
+    int32_t y = (int32_t)ADDAC_Clamp((acc + (1LL << (ADDAC_BIQUAD_Q_BITS - 1))) >> ADDAC_BIQUAD_Q_BITS,
+                                     ADDAC_CODE_MIN, ADDAC_CODE_MAX);
+
+    bq->x2 = bq->x1;
+    bq->x1 = input;
+    bq->y2 = bq->y1;
+    bq->y1 = y;
+    return y;
+}
+
+/**
+ * @brief Builds a map so that V_dac = scale * V_in + offset_v.
+ * @param map Map to fill.
+ * @param in Conversion of the input channel.
+ * @param dac_vref DAC reference voltage.
+ * @param scale Voltage gain from input to output.
+ * @param offset_v Output voltage for a 0 V input.
+ */
+void ADDAC_Map_Init(addac_map_t *map, const ADS1256_ConvScale *in, float dac_vref, float scale, float offset_v)
+{
+    double codes_per_volt = (double)DAC_VALUE_MAX / (double)dac_vref;
+
+    // The input's own offset correction becomes part of the output offset
+    map->offset = (int32_t)lrint(((double)offset_v + (double)scale * in->offset) * codes_per_volt);
+    map->gain_q24 = ADDAC_ToFixed((float)((double)scale * in->scale * codes_per_volt), ADDAC_MAP_Q_BITS);
+}
+
+/**
+ * @brief Applies a map.
+ * @param map Map.
+ * @param value Controller value in ADC code units.
+ * @return DAC code, clamped to 0 .. DAC_VALUE_MAX.
+ */
+UWORD ADDAC_Map_Apply(const addac_map_t *map, int32_t value)
+{
+    int64_t code = map->offset + (((int64_t)value * map->gain_q24) >> ADDAC_MAP_Q_BITS);
+    return (UWORD)ADDAC_Clamp(code, 0, DAC_VALUE_MAX);
+}
+
+/**
+ * @brief Fills a configuration with defaults.
+ * @param cfg Configuration to initialize.
+ */
+void ADDAC_Loop_DefaultConfig(addac_loop_config_t *cfg)
+{
+    ADS1256_ConvScale unity;
+
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->adc = NULL;
+    cfg->dac = NULL;
+    cfg->inputs = NULL;
+    cfg->rate_hz = ADDAC_LOOP_DEFAULT_RATE_HZ;
+    cfg->deadline_us = 0;
+    cfg->num_outputs = 1;
+    cfg->outputs[0].channel = DAC8532_CHANNEL_A;
+    cfg->outputs[0].input = 0;
+    cfg->outputs[0].ctrl = ADDAC_CTRL_PASSTHROUGH;
+    ADS1256_ConvScale_Init(&unity, ADC_VREF_POS_5V0, ADC_VREF_NEG_GND, ADS1256_GAIN_1, 1.0f, 0.0f);
+    ADDAC_Map_Init(&cfg->outputs[0].map, &unity, DAC_VREF, 1.0f, 0.0f);
+    cfg->transfer = NULL;
+    cfg->user = NULL;
+    cfg->cpu = -1;
+    cfg->rt_priority = 0;
+    cfg->lock_memory = 0;
+}
+
+/**
+ * @brief Applies CPU affinity and scheduling policy to the calling thread.
+ * @param cfg Loop configuration.
+ */
+static void ADDAC_Loop_ApplyScheduling(const addac_loop_config_t *cfg)
+{
+    if (cfg->cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cfg->cpu, &set);
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (err != 0) {
+            fprintf(stderr, "ADDAC_Loop: Failed to pin thread to CPU %d: %s\r\n", cfg->cpu, strerror(err));
+        }
+    }
+    if (cfg->rt_priority > 0) {
+        struct sched_param param = { .sched_priority = cfg->rt_priority };
+        int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (err != 0) {
+            fprintf(stderr, "ADDAC_Loop: SCHED_FIFO priority %d unavailable (%s), using SCHED_OTHER\r\n",
+                    cfg->rt_priority, strerror(err));
+        }
+    }
+}
+
+/**
+ * @brief Runs the transfer function of one cycle.
+ * @param loop Running loop.
+ * @param inputs Sign-extended input codes.
+ * @param codes DAC codes, updated in place.
+ */
+static void ADDAC_Loop_Compute(addac_loop_t *loop, const int32_t *inputs, UWORD *codes)
+{
+    addac_loop_config_t *cfg = &loop->config;
+
+    if (cfg->transfer) {
+        cfg->transfer(inputs, loop->scan.num_entries, codes, cfg->num_outputs, cfg->user);
+        return;
+    }
+
+    for (UBYTE o = 0; o < cfg->num_outputs; o++) {
+        addac_output_t *out = &cfg->outputs[o];
+        int32_t x = inputs[out->input];
+        int32_t value;
+
+        switch (out->ctrl) {
+            case ADDAC_CTRL_PID:
+                out->pid.setpoint = atomic_load_explicit(&loop->setpoint[o], memory_order_relaxed);
+                value = ADDAC_PID_Step(&out->pid, x);
+                break;
+            case ADDAC_CTRL_BIQUAD:
+                value = ADDAC_Biquad_Step(&out->biquad, x);
+                break;
+            default:
+                value = x;
+                break;
+        }
+        codes[o] = ADDAC_Map_Apply(&out->map, value);
+    }
+}
+
+/**
+ * @brief Loop thread body: wait for the cycle, sample, compute, write, measure.
+ * @param arg The addac_loop_t being run.
+ * @return NULL.
+ */
+static void *ADDAC_Loop_Thread(void *arg)
+{
+    addac_loop_t *loop = (addac_loop_t *)arg;
+    addac_loop_config_t *cfg = &loop->config;
+    const uint64_t period_ns = cfg->rate_hz ? 1000000000ULL / cfg->rate_hz : 0;
+    const uint64_t deadline_ns = (uint64_t)cfg->deadline_us * 1000ULL;
+    UDOUBLE raw[ADS1256_SCAN_MAX_ENTRIES];
+    int32_t inputs[ADS1256_SCAN_MAX_ENTRIES];
+    UWORD codes[ADDAC_LOOP_MAX_OUTPUTS] = {0};
+    uint64_t next_ns = ADDAC_MonoNs();
+    // Two outputs on the two channels change together through the load bits
+    const UBYTE both_channels = cfg->num_outputs == 2 && cfg->outputs[0].channel != cfg->outputs[1].channel;
+
+    ADDAC_Loop_ApplyScheduling(cfg);
+
+    while (atomic_load_explicit(&loop->running, memory_order_relaxed)) {
+        uint64_t start_ns;
+
+        if (period_ns) {
+            struct timespec wake;
+            next_ns += period_ns;
+            ADDAC_NsToTimespec(next_ns, &wake);
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL) != 0) {
+            }
+            start_ns = ADDAC_MonoNs();
+            LatencyHist_Record(&loop->wakeup_lateness, start_ns - next_ns);
+            ADS1256_ScanList_Reset(&loop->scan); // Sample at this wake-up, not after the last cycle
+        } else {
+            start_ns = ADDAC_MonoNs();
+        }
+
+        if (ADS1256_Dev_Scan(cfg->adc, &loop->scan, raw) != ADS1256_OK) {
+            atomic_fetch_add_explicit(&loop->errors, 1, memory_order_relaxed);
+            continue;
+        }
+        for (UBYTE i = 0; i < loop->scan.num_entries; i++) {
+            inputs[i] = (int32_t)(raw[i] << 8) >> 8; // Sign-extend bit 23
+            atomic_store_explicit(&loop->last_input[i], inputs[i], memory_order_relaxed);
+        }
+
+        ADDAC_Loop_Compute(loop, inputs, codes);
+
+        UBYTE write_failed = 0;
+        if (both_channels) {
+            UBYTE a = (cfg->outputs[0].channel == DAC8532_CHANNEL_A) ? 0 : 1;
+            write_failed = (DAC8532_Dev_WriteBoth(cfg->dac, codes[a], codes[1 - a]) != 0);
+        } else {
+            for (UBYTE o = 0; o < cfg->num_outputs; o++) {
+                write_failed |= (DAC8532_Dev_Write(cfg->dac, cfg->outputs[o].channel, codes[o]) != 0);
+            }
+        }
+        for (UBYTE o = 0; o < cfg->num_outputs; o++) {
+            atomic_store_explicit(&loop->last_output[o], codes[o], memory_order_relaxed);
+        }
+        uint64_t done_ns = ADDAC_MonoNs();
+
+        struct timespec drdy;
+        ADS1256_Dev_GetLastDRDYTime(cfg->adc, &drdy);
+        uint64_t latency_ns = done_ns - ((uint64_t)drdy.tv_sec * 1000000000ULL + (uint64_t)drdy.tv_nsec);
+        LatencyHist_Record(&loop->latency, latency_ns);
+        LatencyHist_Record(&loop->cycle_time, done_ns - start_ns);
+        if (deadline_ns && latency_ns > deadline_ns) {
+            atomic_fetch_add_explicit(&loop->deadline_misses, 1, memory_order_relaxed);
+        }
+        if (write_failed) {
+            atomic_fetch_add_explicit(&loop->errors, 1, memory_order_relaxed);
+        }
+        atomic_fetch_add_explicit(&loop->cycles, 1, memory_order_relaxed);
+
+        // Skip the periods a long cycle ran into instead of bursting to catch up
+        while (period_ns && next_ns + period_ns <= done_ns) {
+            next_ns += period_ns;
+            atomic_fetch_add_explicit(&loop->overruns, 1, memory_order_relaxed);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Starts the loop thread.
+ * @param loop Loop object to start.
+ * @param cfg Configuration (copied).
+ * @return ADS1256_OK on success, ADS1256_ERROR on failure.
+ */
+UBYTE ADDAC_Loop_Start(addac_loop_t *loop, const addac_loop_config_t *cfg)
+{
+    if (!loop || !cfg || !cfg->inputs || cfg->inputs->num_entries == 0 ||
+        cfg->num_outputs == 0 || cfg->num_outputs > ADDAC_LOOP_MAX_OUTPUTS) {
+        fprintf(stderr, "ADDAC_Loop_Start: Invalid configuration\r\n");
+        return ADS1256_ERROR;
+    }
+    for (UBYTE o = 0; o < cfg->num_outputs; o++) {
+        if (cfg->outputs[o].input >= cfg->inputs->num_entries) {
+            fprintf(stderr, "ADDAC_Loop_Start: Output %d reads input %d, scan list has %d\r\n",
+                    o, cfg->outputs[o].input, cfg->inputs->num_entries);
+            return ADS1256_ERROR;
+        }
+    }
+
+    memset(loop, 0, sizeof(*loop));
+    loop->config = *cfg;
+    loop->scan = *cfg->inputs;
+    loop->config.inputs = NULL; // Only the private copy is used by the thread
+    ADS1256_ScanList_Reset(&loop->scan);
+    if (!loop->config.adc) loop->config.adc = ADS1256_GetDefaultDev();
+    if (!loop->config.dac) {
+        DAC8532_Dev_Init(&loop->dac, DEV_GetDACPort(), DAC_VREF);
+        loop->config.dac = &loop->dac;
+    }
+
+    for (UBYTE o = 0; o < ADDAC_LOOP_MAX_OUTPUTS; o++) {
+        atomic_init(&loop->last_output[o], 0);
+        atomic_init(&loop->setpoint[o], cfg->outputs[o].pid.setpoint);
+    }
+    for (UBYTE i = 0; i < ADS1256_SCAN_MAX_ENTRIES; i++) {
+        atomic_init(&loop->last_input[i], 0);
+    }
+    atomic_init(&loop->cycles, 0);
+    atomic_init(&loop->overruns, 0);
+    atomic_init(&loop->deadline_misses, 0);
+    atomic_init(&loop->errors, 0);
+    atomic_init(&loop->running, 1);
+    LatencyHist_Reset(&loop->latency);
+    LatencyHist_Reset(&loop->cycle_time);
+    LatencyHist_Reset(&loop->wakeup_lateness);
+
+    if (cfg->lock_memory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        perror("ADDAC_Loop_Start: mlockall failed, continuing unlocked");
+    }
+
+    int err = pthread_create(&loop->thread, NULL, ADDAC_Loop_Thread, loop);
+    if (err != 0) {
+        fprintf(stderr, "ADDAC_Loop_Start: Failed to create thread: %s\r\n", strerror(err));
+        return ADS1256_ERROR;
+    }
+    loop->thread_started = 1;
+
+    Debug("ADDAC_Loop_Start: %d inputs, %d outputs, %u Hz, cpu %d, prio %d\n",
+          loop->scan.num_entries, cfg->num_outputs, cfg->rate_hz, cfg->cpu, cfg->rt_priority);
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Stops the loop thread.
+ * @param loop Loop object.
+ * @return ADS1256_OK on success, ADS1256_ERROR if the loop was not running.
+ */
+UBYTE ADDAC_Loop_Stop(addac_loop_t *loop)
+{
+    if (!loop || !loop->thread_started) return ADS1256_ERROR;
+
+    atomic_store_explicit(&loop->running, 0, memory_order_relaxed);
+    pthread_join(loop->thread, NULL);
+    loop->thread_started = 0;
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Changes the PID setpoint of an output.
+ * @param loop Running loop.
+ * @param output Output index.
+ * @param setpoint New target input code.
+ */
+void ADDAC_Loop_SetSetpoint(addac_loop_t *loop, UBYTE output, int32_t setpoint)
+{
+    if (!loop || output >= ADDAC_LOOP_MAX_OUTPUTS) return;
+    atomic_store_explicit(&loop->setpoint[output], setpoint, memory_order_relaxed);
+}
+
+/**
+ * @brief Returns an input of the last completed cycle.
+ * @param loop Loop object.
+ * @param input Scan list entry index.
+ * @return Sign-extended input code (0 for an invalid index).
+ */
+int32_t ADDAC_Loop_GetInput(addac_loop_t *loop, UBYTE input)
+{
+    if (!loop || input >= ADS1256_SCAN_MAX_ENTRIES) return 0;
+    return atomic_load_explicit(&loop->last_input[input], memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the DAC code written to an output in the last completed cycle.
+ * @param loop Loop object.
+ * @param output Output index.
+ * @return DAC code (0 for an invalid index).
+ */
+UWORD ADDAC_Loop_GetOutput(addac_loop_t *loop, UBYTE output)
+{
+    if (!loop || output >= ADDAC_LOOP_MAX_OUTPUTS) return 0;
+    return atomic_load_explicit(&loop->last_output[output], memory_order_relaxed);
+}
+
+/**
+ * @brief Prints cycle counters and latency percentiles.
+ * @param loop Loop object.
+ */
+void ADDAC_Loop_PrintReport(addac_loop_t *loop)
+{
+    if (!loop) return;
+
+    printf("\n--- Control Loop Report ---\n");
+    printf("Rate: %u Hz%s, %d inputs, %d outputs\n", loop->config.rate_hz,
+           loop->config.rate_hz ? "" : " (free-running)", loop->scan.num_entries, loop->config.num_outputs);
+    printf("Cycles: %llu, overruns: %llu, deadline misses: %llu (budget %u us), errors: %llu\n",
+           (unsigned long long)atomic_load(&loop->cycles), (unsigned long long)atomic_load(&loop->overruns),
+           (unsigned long long)atomic_load(&loop->deadline_misses), loop->config.deadline_us,
+           (unsigned long long)atomic_load(&loop->errors));
+    LatencyHist_Print("DRDY to DAC written", &loop->latency);
+    LatencyHist_Print("Cycle time", &loop->cycle_time);
+    LatencyHist_Print("Wake-up lateness", &loop->wakeup_lateness);
+    printf("---------------------------\n");
+}
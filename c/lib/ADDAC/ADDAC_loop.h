@@ -0,0 +1,257 @@
+/**
+ * @file ADDAC_loop.h
+ * @brief Fixed-rate ADC-to-DAC control loop for the ADS1256/DAC8532 board.
+ *
+ * Each cycle the loop thread samples a compiled input scan list, runs a
+ * transfer function (a user callback, or a built-in fixed-point PID or
+ * biquad per output) and writes the DAC outputs. Cycles are paced with
+ * clock_nanosleep(TIMER_ABSTIME), so the schedule does not drift, and the
+ * latency from the DRDY of the last input to the last DAC write is measured
+ * for every cycle. Nothing in the cycle allocates, prints or uses floating
+ * point.
+ */
+
+#ifndef _ADDAC_LOOP_H_
+#define _ADDAC_LOOP_H_
+
+#include "../ADS1256/ADS1256.h"
+#include "../ADS1256/ADS1256_convert.h"
+#include "../DAC8532/DAC8532.h"
+#include "../../common/LatencyHist.h"
+#include <pthread.h>
+#include <stdatomic.h>
+
+/** @brief Maximum number of DAC outputs driven by one loop (the DAC8532 has two). */
+#define ADDAC_LOOP_MAX_OUTPUTS 2
+
+/** @name Fixed-point formats */
+#define ADDAC_PID_Q_BITS    16 ///< PID gains are Q15.16
+#define ADDAC_BIQUAD_Q_BITS 30 ///< Biquad coefficients are Q1.30 (range -2 .. 2)
+#define ADDAC_MAP_Q_BITS    24 ///< Output map gain is Q7.24 (DAC codes per ADC code)
+
+/**
+ * @brief Built-in transfer function of one output.
+ */
+typedef enum {
+    ADDAC_CTRL_PASSTHROUGH = 0, ///< Output follows the input through the map
+    ADDAC_CTRL_PID,             ///< PID on (setpoint - input), output through the map
+    ADDAC_CTRL_BIQUAD,          ///< Second-order IIR section on the input, output through the map
+} ADDAC_CTRL;
+
+/**
+ * @brief Discrete PID controller in ADC code units. Fill with ADDAC_PID_Init().
+ */
+typedef struct {
+    int32_t kp_q16;      ///< Proportional gain
+    int32_t ki_q16;      ///< Integral gain per sample
+    int32_t kd_q16;      ///< Derivative gain per sample
+    int32_t setpoint;    ///< Target input code
+    int32_t out_min;     ///< Lower output limit (also bounds the integrator)
+    int32_t out_max;     ///< Upper output limit (also bounds the integrator)
+    int64_t integral;    ///< Integrator state, Q16
+    int32_t prev_error;  ///< Error of the previous sample
+} addac_pid_t;
+
+/**
+ * @brief Direct form I biquad section. Fill with ADDAC_Biquad_Init().
+ *
+ * y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+ */
+typedef struct {
+    int32_t b0, b1, b2, a1, a2; ///< Coefficients, Q1.30 (a0 normalized to 1)
+    int32_t x1, x2, y1, y2;     ///< Delay line
+} addac_biquad_t;
+
+/**
+ * @brief Affine map from a controller value (ADC code units) to a DAC code.
+ *
+ * code = offset + (value * gain_q24) >> 24, clamped to 0 .. DAC_VALUE_MAX.
+ */
+typedef struct {
+    int32_t offset;   ///< DAC code for a controller value of 0
+    int32_t gain_q24; ///< DAC codes per ADC code, Q7.24
+} addac_map_t;
+
+/**
+ * @brief One DAC output of the loop.
+ */
+typedef struct {
+    UBYTE channel;          ///< DAC8532_CHANNEL_A or DAC8532_CHANNEL_B
+    UBYTE input;            ///< Index of the scan list entry feeding this output
+    ADDAC_CTRL ctrl;        ///< Built-in transfer function (unused with a transfer callback)
+    addac_pid_t pid;        ///< State for ADDAC_CTRL_PID
+    addac_biquad_t biquad;  ///< State for ADDAC_CTRL_BIQUAD
+    addac_map_t map;        ///< Controller value to DAC code
+} addac_output_t;
+
+/**
+ * @brief User transfer function, called once per cycle on the loop thread.
+ *
+ * Must not block. Runs instead of the built-in controllers.
+ * @param inputs Sign-extended input codes, one per scan list entry.
+ * @param num_inputs Number of inputs.
+ * @param codes DAC codes to write, one per configured output (prefilled with the previous codes).
+ * @param num_outputs Number of outputs.
+ * @param user The `user` pointer from the configuration.
+ */
+typedef void (*addac_transfer_fn)(const int32_t *inputs, UBYTE num_inputs, UWORD *codes, UBYTE num_outputs,
+                                  void *user);
+
+/**
+ * @brief Control loop configuration. Fill with ADDAC_Loop_DefaultConfig().
+ */
+typedef struct {
+    ads1256_dev_t *adc;             ///< ADC to sample, or NULL for the default device (ADS1256_init())
+    dac8532_dev_t *dac;             ///< DAC to drive, or NULL for the board's DAC at DAC_VREF
+    const ADS1256_ScanList *inputs; ///< Input scan list (copied), built for `adc`
+    UDOUBLE rate_hz;                ///< Cycle rate, or 0 to run back to back at the scan rate
+    UDOUBLE deadline_us;            ///< DRDY-to-output budget; longer cycles count as misses (0 = none)
+    addac_output_t outputs[ADDAC_LOOP_MAX_OUTPUTS]; ///< Outputs; one per DAC channel updates both together
+    UBYTE num_outputs;              ///< Number of entries in `outputs` (1 or 2)
+    addac_transfer_fn transfer;     ///< Optional user transfer function
+    void *user;                     ///< Passed to `transfer`
+    int cpu;                        ///< CPU core to pin the loop thread to, or -1
+    int rt_priority;                ///< SCHED_FIFO priority (1-99), or 0 for SCHED_OTHER
+    UBYTE lock_memory;              ///< Non-zero to mlockall() the process before starting
+} addac_loop_config_t;
+
+/**
+ * @brief Control loop state. Treat as opaque; use the accessor functions.
+ */
+typedef struct {
+    addac_loop_config_t config;     ///< Copy of the configuration (outputs hold the live controller state)
+    ADS1256_ScanList scan;          ///< Input scan list executed by the thread
+    dac8532_dev_t dac;              ///< DAC used when the configuration gives none
+    pthread_t thread;               ///< Loop thread
+    UBYTE thread_started;           ///< Non-zero while `thread` must be joined
+    _Atomic int running;            ///< Cleared to ask the thread to stop
+    _Atomic int32_t last_input[ADS1256_SCAN_MAX_ENTRIES]; ///< Inputs of the last cycle
+    _Atomic uint16_t last_output[ADDAC_LOOP_MAX_OUTPUTS]; ///< DAC codes of the last cycle
+    _Atomic int32_t setpoint[ADDAC_LOOP_MAX_OUTPUTS];     ///< PID setpoints, picked up every cycle
+    _Atomic uint64_t cycles;        ///< Completed cycles
+    _Atomic uint64_t overruns;      ///< Periods skipped because a cycle ran past the next start
+    _Atomic uint64_t deadline_misses; ///< Cycles whose latency exceeded deadline_us
+    _Atomic uint64_t errors;        ///< Cycles lost to ADC or DAC errors
+    latency_hist_t latency;         ///< DRDY of the last input to the last DAC write done
+    latency_hist_t cycle_time;      ///< Cycle start (wake-up) to the last DAC write done
+    latency_hist_t wakeup_lateness; ///< Actual minus scheduled wake-up time
+} addac_loop_t;
+
+/**
+ * @brief Fills a configuration with defaults: default ADC and DAC, 1 kHz,
+ *        no deadline, one pass-through output on DAC channel A from input 0
+ *        (V_dac = V_in for a 5 V reference at gain 1), unpinned, SCHED_OTHER,
+ *        no mlockall. `inputs` must still be set.
+ * @param cfg Configuration to initialize.
+ */
+void ADDAC_Loop_DefaultConfig(addac_loop_config_t *cfg);
+
+/**
+ * @brief Starts the loop thread.
+ *
+ * The ADC must already be initialized. While the loop runs, its thread
+ * owns the ADC and the DAC: do not call their drivers until
+ * ADDAC_Loop_Stop() returns.
+ * @param loop Loop object to start.
+ * @param cfg Configuration (copied).
+ * @return ADS1256_OK on success, ADS1256_ERROR on an invalid configuration or thread error.
+ */
+UBYTE ADDAC_Loop_Start(addac_loop_t *loop, const addac_loop_config_t *cfg);
+
+/**
+ * @brief Stops the loop thread.
+ * @param loop Loop object.
+ * @return ADS1256_OK on success, ADS1256_ERROR if the loop was not running.
+ */
+UBYTE ADDAC_Loop_Stop(addac_loop_t *loop);
+
+/**
+ * @brief Changes the PID setpoint of an output while the loop runs.
+ * @param loop Running loop.
+ * @param output Output index.
+ * @param setpoint New target input code.
+ */
+void ADDAC_Loop_SetSetpoint(addac_loop_t *loop, UBYTE output, int32_t setpoint);
+
+/**
+ * @brief Returns an input of the last completed cycle.
+ * @param loop Loop object.
+ * @param input Scan list entry index.
+ * @return Sign-extended input code.
+ */
+int32_t ADDAC_Loop_GetInput(addac_loop_t *loop, UBYTE input);
+
+/**
+ * @brief Returns the DAC code written to an output in the last completed cycle.
+ * @param loop Loop object.
+ * @param output Output index.
+ * @return DAC code.
+ */
+UWORD ADDAC_Loop_GetOutput(addac_loop_t *loop, UBYTE output);
+
+/**
+ * @brief Prints cycle counters and latency percentiles.
+ * @param loop Loop object.
+ */
+void ADDAC_Loop_PrintReport(addac_loop_t *loop);
+
+/**
+ * @brief Initializes a PID controller.
+ * @param pid Controller to initialize.
+ * @param kp Proportional gain (output codes per input code).
+ * @param ki Integral gain per sample.
+ * @param kd Derivative gain per sample.
+ * @param setpoint Target input code.
+ * @param out_min Lower output limit.
+ * @param out_max Upper output limit.
+ */
+void ADDAC_PID_Init(addac_pid_t *pid, float kp, float ki, float kd, int32_t setpoint,
+                    int32_t out_min, int32_t out_max);
+
+/**
+ * @brief Runs one PID step.
+ * @param pid Controller.
+ * @param input Input code.
+ * @return Controller output, within out_min .. out_max.
+ */
+int32_t ADDAC_PID_Step(addac_pid_t *pid, int32_t input);
+
+/**
+ * @brief Initializes a biquad section from normalized coefficients (a0 = 1).
+ * @param bq Section to initialize.
+ * @param b0 Feed-forward coefficient 0.
+ * @param b1 Feed-forward coefficient 1.
+ * @param b2 Feed-forward coefficient 2.
+ * @param a1 Feedback coefficient 1.
+ * @param a2 Feedback coefficient 2.
+ * @return ADS1256_OK on success, ADS1256_ERROR if a coefficient is outside -2 .. 2.
+ */
+UBYTE ADDAC_Biquad_Init(addac_biquad_t *bq, float b0, float b1, float b2, float a1, float a2);
+
+/**
+ * @brief Runs one biquad step.
+ * @param bq Section.
+ * @param input Input code.
+ * @return Filter output.
+ */
+int32_t ADDAC_Biquad_Step(addac_biquad_t *bq, int32_t input);
+
+/**
+ * @brief Builds a map so that V_dac = scale * V_in + offset_v.
+ * @param map Map to fill.
+ * @param in Conversion of the input channel (ADS1256_ConvScale_Init()).
+ * @param dac_vref DAC reference voltage.
+ * @param scale Voltage gain from input to output (negative to invert).
+ * @param offset_v Output voltage for a 0 V input.
+ */
+void ADDAC_Map_Init(addac_map_t *map, const ADS1256_ConvScale *in, float dac_vref, float scale, float offset_v);
+
+/**
+ * @brief Applies a map.
+ * @param map Map.
+ * @param value Controller value in ADC code units.
+ * @return DAC code, clamped to 0 .. DAC_VALUE_MAX.
+ */
+UWORD ADDAC_Map_Apply(const addac_map_t *map, int32_t value);
+
+#endif // _ADDAC_LOOP_H_
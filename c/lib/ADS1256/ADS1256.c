@@ -10,530 +10,2430 @@
 
 #include "ADS1256.h"
 #include <stdio.h> 
-#include <sys/time.h> 
+#include <string.h>
+#include <math.h>
 
-// Global variable to store the current scan mode
-UBYTE ScanMode = SCAN_MODE_SINGLE_ENDED; // Default to single-ended
+/** @name DRDY timeout handling */
+#define ADS1256_DRDY_TIMEOUT_DEFAULT_US 500000 ///< Timeout used before a data rate has been configured (covers reset)
+#define ADS1256_DRDY_TIMEOUT_PERIODS    5      ///< Conversion periods to allow for one DRDY cycle after SYNC
+#define ADS1256_DRDY_TIMEOUT_MARGIN_US  10000  ///< Fixed margin added on top for scheduling delays
+#define ADS1256_GAP_GUARD_NS            5000   ///< Bus time left free before the next DRDY when lending the bus
 
-// Performance tracking structure instance
-static performance_metrics_t perf_metrics = {0};
+/**
+ * @brief Adds `n` to a performance counter.
+ *
+ * Relaxed ordering is enough: readers in other threads only need each total
+ * to become visible eventually, not in any order relative to the others.
+ */
+#define ADS1256_COUNT(dev, counter, n) atomic_fetch_add_explicit(&(dev)->metrics.counter, (n), memory_order_relaxed)
+
+// Instance behind the single-instance API (ADS1256_init() and friends)
+static ads1256_dev_t default_dev = { .drdy_timeout_us = ADS1256_DRDY_TIMEOUT_DEFAULT_US };
+
+/** @name Register shadow (STATUS..FSC2) */
+#define ADS1256_REG_ALL_VALID   ((UWORD)((1u << ADS1256_NUM_REGS) - 1))
+#define ADS1256_STATUS_WRITABLE 0x0E  ///< ORDER, ACAL, BUFEN; ID (7-4) and DRDY (0) are read-only
+#define ADS1256_REG_UPDATE_TX   (3 * ADS1256_NUM_REGS)       ///< Worst-case WREG bytes for one update
+#define ADS1256_REG_UPDATE_SEGS ((ADS1256_NUM_REGS + 1) / 2) ///< Worst-case WREG frames for one update
+
+/**
+ * @brief Set of pending register writes, merged into WREG bursts when sent.
+ */
+typedef struct {
+    UBYTE value[ADS1256_NUM_REGS];
+    UWORD dirty; ///< Bit n set when value[n] must be written
+} ADS1256_RegUpdate;
+
+/** @name Calibration timing */
+#define ADS1256_CAL_START_US        50     ///< Time for DRDY to go high after a calibration command
+#define ADS1256_CAL_TIMEOUT_PERIODS 10     ///< Conversion periods allowed for a calibration (SELFCAL needs ~3)
+#define ADS1256_CAL_TIMEOUT_MARGIN_US 100000
+#define ADS1256_CAL_REGS_MASK ((UWORD)(0x3Fu << REG_OFC0)) ///< OFC0..FSC2 in reg_valid
+
+/** @name SPI command timing (datasheet values for fCLKIN = 7.68 MHz, rounded up) */
+#define ADS1256_T6_US        7  ///< t6: DIN to DOUT delay after RDATA/RREG (50 tCLKIN = 6.5 us)
+#define ADS1256_T11_SYNC_US  4  ///< t11: delay after SYNC before the next command (24 tCLKIN = 3.1 us)
+#define ADS1256_T11_CMD_US   1  ///< t11: delay after WREG before the next command (4 tCLKIN = 0.5 us)
+
+/** @name Reset timing */
+#define ADS1256_RESET_PULSE_NS 1000   ///< t16: RESET low width (4 tCLKIN = 0.52 us), rounded up
+#define ADS1256_RESET_GUARD_NS 100000 ///< Time after the reset before DRDY is trusted again
+
+/** @brief ADCON register value for a gain: CLKOUT off, sensor detect off, PGA = gain. */
+#define ADS1256_ADCON_VALUE(gain) ((UBYTE)((0 << 5) | (0 << 3) | ((gain) & 0x07)))
 
 /**
- * @brief Resets the ADS1256 module.
+ * @brief Runs one SPI message with CS asserted and times it.
+ *
+ * Failures are counted in the metrics; callers only pass the status on.
+ * @param dev Device context.
+ * @param msg Message segments.
+ * @param count Number of segments.
+ * @return 0 on success, non-zero on an SPI error.
  */
-static void ADS1256_reset(void)
+static int ADS1256_Transfer(ads1256_dev_t *dev, const DEV_SPI_Segment *msg, UBYTE count)
 {
-    DEV_Digital_Write(DEV_RST_PIN, HIGH);
-    DEV_Delay_ms(200);
-    DEV_Digital_Write(DEV_RST_PIN, LOW); 
-    DEV_Delay_ms(200);
-    DEV_Digital_Write(DEV_RST_PIN, HIGH);
-    DEV_Delay_ms(200); 
+    uint64_t start = LatencyHist_Now();
+    int ret = DEV_Port_Message(dev->port, msg, count);
+    dev->spi_done_ns = LatencyHist_RecordSince(&dev->metrics.spi_transaction, start);
+    if (ret != 0) ADS1256_COUNT(dev, spi_errors, 1);
+    return ret;
 }
 
 /**
  * @brief Sends a command to the ADS1256.
+ * @param dev Device context.
  * @param Cmd The command byte to send (from ADS1256_CMD enum).
+ * @return ADS1256_OK on success, ADS1256_ERROR on an SPI error.
  */
-static void ADS1256_WriteCmd(UBYTE Cmd)
+static UBYTE ADS1256_WriteCmd(ads1256_dev_t *dev, UBYTE Cmd)
 {
-    DEV_Digital_Write(DEV_CS_PIN, LOW);
-    DEV_SPI_WriteByte(Cmd);      
-    DEV_Digital_Write(DEV_CS_PIN, HIGH);
+    DEV_SPI_Segment seg = { .tx = &Cmd, .len = 1 };
+    return (ADS1256_Transfer(dev, &seg, 1) == 0) ? ADS1256_OK : ADS1256_ERROR;
 }
 
 /**
- * @brief Writes data to a specified register in the ADS1256.
- * @param Reg The target register address (from ADS1256_REG enum).
- * @param Data The byte of data to write to the register.
+ * @brief Returns the seconds elapsed since a CLOCK_MONOTONIC_RAW timestamp.
+ * @param start Start time.
+ * @return Elapsed time in seconds.
  */
-static void ADS1256_WriteReg(UBYTE Reg, UBYTE Data)
+static double ADS1256_SecondsSince(const struct timespec *start)
 {
-    DEV_Digital_Write(DEV_CS_PIN, LOW);  
-    DEV_SPI_WriteByte(CMD_WREG | Reg); 
-    DEV_SPI_WriteByte(0x00);           
-    DEV_SPI_WriteByte(Data);           
-    DEV_Digital_Write(DEV_CS_PIN, HIGH);  
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
 }
 
 /**
- * @brief Reads data from a specified register in the ADS1256.
- * @param Reg The target register address (from ADS1256_REG enum).
- * @return The byte of data read from the register.
+ * @brief Rejects register/command access while RDATAC or a polled operation is active.
+ *
+ * In continuous mode the chip only listens for SDATAC and RESET, so any
+ * other command would be lost and the next data read would be corrupted.
+ * While ADS1256_Dev_Poll() drives a reset or calibration, other commands
+ * would interleave with its steps.
+ * @param dev Device context.
+ * @param caller Name of the calling function, for the debug message.
+ * @return 1 if the device is busy (caller must bail out), 0 otherwise.
  */
-static UBYTE ADS1256_Read_data(UBYTE Reg)
+static UBYTE ADS1256_DeviceBusy(ads1256_dev_t *dev, const char *caller)
 {
-    UBYTE temp = 0;
-    DEV_Digital_Write(DEV_CS_PIN, LOW);  
-    DEV_SPI_WriteByte(CMD_RREG | Reg); 
-    DEV_SPI_WriteByte(0x00);           
-    // DEV_Delay_ms(1); // Small delay for command processing. Datasheet t6 is ~0.5us. SPI driver might handle this.
-    temp = DEV_SPI_ReadByte();         
-    DEV_Digital_Write(DEV_CS_PIN, HIGH);  
-    return temp;
+    if (dev->continuous_active) {
+        Debug("%s: Not allowed in continuous mode, call ADS1256_StopContinuous() first\n", caller);
+        return 1;
+    }
+    if (dev->op != ADS1256_OP_NONE) {
+        Debug("%s: Not allowed while a reset or calibration runs, call ADS1256_Poll() until it is done\n", caller);
+        return 1;
+    }
+    return 0;
 }
 
 /**
- * @brief Waits for the Data Ready (DRDY) pin to go low.
+ * @brief Reads consecutive registers from the ADS1256 with one RREG.
+ * @param dev Device context.
+ * @param Reg The first register address (from ADS1256_REG enum).
+ * @param n Number of registers to read (1-11).
+ * @param out Output for `n` register values.
+ * @return ADS1256_OK on success, ADS1256_ERROR on an SPI error.
  */
-static void ADS1256_WaitDRDY(void)
+static UBYTE ADS1256_ReadRegs(ads1256_dev_t *dev, UBYTE Reg, UBYTE n, UBYTE *out)
 {
-    UDOUBLE i = 0;
-    const UDOUBLE timeout_cycles = 4000000; 
-    for(i = 0; i < timeout_cycles; i++) {
-        if(DEV_Digital_Read(DEV_DRDY_PIN) == LOW) {
-            return; 
-        }
-    }
-    Debug("ADS1256_WaitDRDY: Timeout!\n");
+    UBYTE tx[2] = { CMD_RREG | Reg, (UBYTE)(n - 1) };
+    DEV_SPI_Segment msg[2] = {
+        { .tx = tx, .len = sizeof(tx), .delay_usecs = ADS1256_T6_US }, // RREG + count, then t6
+        { .rx = out, .len = n },                                        // Register values
+    };
+
+    int ret = ADS1256_Transfer(dev, msg, 2);
+    return (ret == 0) ? ADS1256_OK : ADS1256_ERROR;
 }
 
 /**
- * @brief Reads the Chip ID from the ADS1256.
- * @return The 4-bit chip ID. Expected value is 3 for ADS1256.
+ * @brief Reloads the whole register shadow from the chip with a single RREG burst.
+ * @param dev Device context.
+ * @return ADS1256_OK on success, ADS1256_ERROR on an SPI error (shadow left invalid).
  */
-UBYTE ADS1256_ReadChipID(void)
+static UBYTE ADS1256_RefreshShadow(ads1256_dev_t *dev)
 {
-    UBYTE id;
-    id = ADS1256_Read_data(REG_STATUS);
-    return (id >> 4); 
+    if (ADS1256_ReadRegs(dev, REG_STATUS, ADS1256_NUM_REGS, dev->reg_shadow) != ADS1256_OK) {
+        dev->reg_valid = 0;
+        return ADS1256_ERROR;
+    }
+    dev->reg_valid = ADS1256_REG_ALL_VALID;
+    return ADS1256_OK;
 }
 
 /**
- * @brief Configures the ADS1256 ADC settings.
- * @param gain The PGA gain setting (ADS1256_GAIN enum).
- * @param drate The data rate (ADS1256_DRATE enum).
+ * @brief Reads a register, from the shadow unless a refresh is forced.
+ * @param dev Device context.
+ * @param Reg The register address (from ADS1256_REG enum).
+ * @param force Non-zero to read the chip even if the shadow is valid.
+ * @return The register value (0 for an invalid address).
  */
-void ADS1256_ConfigADC(ADS1256_GAIN gain, ADS1256_DRATE drate)
+UBYTE ADS1256_Dev_ReadReg(ads1256_dev_t *dev, UBYTE Reg, UBYTE force)
 {
-    ADS1256_WaitDRDY();
-
-    UBYTE status_reg = (0 << 7) | // ORDER: MSB first
-                       (0 << 6) | // ACAL: Auto-Calibration disabled
-                       (1 << 5) | // BUFEN: Analog input buffer enabled
-                       (0 << 4) | // DRDY_MODE: DRDY pin reflects DRDY state
-                       (0 << 3) | // CLKOUT: Clock output disabled
-                       (0 << 2) | // SDCS: Sensor detect current sources off
-                       (0 << 0);  // Lower 2 bits are read-only
+    if (Reg >= ADS1256_NUM_REGS) return 0;
 
-    UBYTE mux_reg = 0x01; // Default: AIN0 positive, AINCOM negative
+    if (force || !(dev->reg_valid & (1u << Reg))) {
+        if (ADS1256_DeviceBusy(dev, __func__)) return dev->reg_shadow[Reg]; // RREG is not allowed during RDATAC
+        if (ADS1256_ReadRegs(dev, Reg, 1, &dev->reg_shadow[Reg]) != ADS1256_OK) {
+            dev->reg_valid &= ~(1u << Reg);
+            return dev->reg_shadow[Reg];
+        }
+        dev->reg_valid |= (1u << Reg);
+    }
+    return dev->reg_shadow[Reg];
+}
 
-    UBYTE adcon_reg = (0 << 5) | // CLK_OFF: Internal oscillator ON
-                      (0 << 3) | // SDCS_MODE: Sensor detect current sources controlled by SDCS bits
-                      (gain & 0x07); // PGA: Gain setting
+/**
+ * @brief Converts a data rate enum to its nominal samples per second.
+ * @param drate The ADS1256_DRATE enum value.
+ * @return The nominal data rate in SPS (2.5 for unknown values).
+ */
+float ADS1256_DrateToSps(ADS1256_DRATE drate)
+{
+    switch(drate) {
+        case ADS1256_30000SPS: return 30000.0f;
+        case ADS1256_15000SPS: return 15000.0f;
+        case ADS1256_7500SPS:  return 7500.0f;
+        case ADS1256_3750SPS:  return 3750.0f;
+        case ADS1256_2000SPS:  return 2000.0f;
+        case ADS1256_1000SPS:  return 1000.0f;
+        case ADS1256_500SPS:   return 500.0f;
+        case ADS1256_100SPS:   return 100.0f;
+        case ADS1256_60SPS:    return 60.0f;
+        case ADS1256_50SPS:    return 50.0f;
+        case ADS1256_30SPS:    return 30.0f;
+        case ADS1256_25SPS:    return 25.0f;
+        case ADS1256_15SPS:    return 15.0f;
+        case ADS1256_10SPS:    return 10.0f;
+        case ADS1256_5SPS:     return 5.0f;
+        case ADS1256_2d5SPS:   return 2.5f;
+        default:
+            Debug("ADS1256_DrateToSps: Unknown DRATE enum, defaulting to 2.5 SPS.\n");
+            return 2.5f;
+    }
+}
 
-    UBYTE drate_reg = ADS1256_DRATE_E[drate];
+/**
+ * @brief Waits for the Data Ready (DRDY) pin to go low.
+ *
+ * Uses the HAL's DRDY wait (busy poll or edge events, see DEV_DRDY_SetMode())
+ * with a timeout derived from the configured data rate. The time DRDY was
+ * seen low is kept for ADS1256_GetLastDRDYTime(); successful waits go into
+ * the DRDY wait histogram, timeouts and GPIO errors are counted.
+ *
+ * Before waiting, the bus is offered to queued writes of other devices
+ * (DEV_Port_Submit()) up to the earliest time the next DRDY can come: one
+ * conversion period after the later of the last conversion start and the
+ * last DRDY.
+ *
+ * With a deadline set (ADS1256_Dev_SetDeadline()) neither the lent gap nor
+ * the wait runs past it; a wait cut short by the deadline, or started after
+ * it, counts as a deadline miss instead of a DRDY timeout.
+ * @param dev Device context.
+ * @return ADS1256_OK when data is ready, ADS1256_TIMEOUT or ADS1256_ERROR otherwise.
+ */
+static UBYTE ADS1256_WaitDRDY(ads1256_dev_t *dev)
+{
+    uint64_t start = LatencyHist_Now();
 
-    DEV_Digital_Write(DEV_CS_PIN, LOW);
-    DEV_SPI_WriteByte(CMD_WREG | REG_STATUS); 
-    DEV_SPI_WriteByte(0x03); // Write 4 registers (STATUS, MUX, ADCON, DRATE)
+    if (dev->deadline_ns && start >= dev->deadline_ns) {
+        ADS1256_COUNT(dev, deadline_misses, 1);
+        return ADS1256_TIMEOUT;
+    }
+    if (dev->conv_period_ns > ADS1256_GAP_GUARD_NS) {
+        uint64_t since = (dev->conv_start_ns > dev->drdy_seen_ns) ? dev->conv_start_ns : dev->drdy_seen_ns;
+        uint64_t gap_end = since + dev->conv_period_ns - ADS1256_GAP_GUARD_NS;
+        if (dev->deadline_ns && gap_end > dev->deadline_ns) gap_end = dev->deadline_ns;
+        DEV_Bus_ServiceGap(dev->port->bus, gap_end);
+    }
 
-    DEV_SPI_WriteByte(status_reg);
-    DEV_SPI_WriteByte(mux_reg);    
-    DEV_SPI_WriteByte(adcon_reg);
-    DEV_SPI_WriteByte(drate_reg);
+    UDOUBLE timeout_us = dev->drdy_timeout_us;
+    UBYTE capped = 0;
+    if (dev->deadline_ns) {
+        uint64_t now = LatencyHist_Now();
+        uint64_t left_us = (now < dev->deadline_ns) ? (dev->deadline_ns - now) / 1000 : 0;
+        if (left_us < timeout_us) {
+            timeout_us = (UDOUBLE)left_us;
+            capped = 1;
+        }
+    }
 
-    DEV_Digital_Write(DEV_CS_PIN, HIGH);
-    DEV_Delay_ms(1); 
+    int ret = DEV_Port_DRDY_Wait(dev->port, timeout_us, &dev->last_drdy_time);
+    if (ret == 0) {
+        dev->drdy_seen_ns = LatencyHist_RecordSince(&dev->metrics.drdy_wait, start);
+        return ADS1256_OK;
+    }
+    if (ret > 0) {
+        if (capped) {
+            ADS1256_COUNT(dev, deadline_misses, 1);
+        } else {
+            ADS1256_COUNT(dev, drdy_timeouts, 1);
+            Debug("ADS1256_WaitDRDY: Timeout after %u us!\n", timeout_us);
+        }
+        return ADS1256_TIMEOUT;
+    }
+    ADS1256_COUNT(dev, gpio_errors, 1);
+    return ADS1256_ERROR;
 }
 
 /**
- * @brief Sets the active input channel for single-ended measurements.
- * @param Channel The channel number (0-7 for AIN0-AIN7 vs AINCOM).
+ * @brief Sets the time by which blocking calls on a device must return.
+ * @param dev Device context.
+ * @param deadline_ns Deadline on the DEV_Now_ns() clock, or 0 for none.
  */
-static void ADS1256_SetChannel(UBYTE Channel)
+void ADS1256_Dev_SetDeadline(ads1256_dev_t *dev, uint64_t deadline_ns)
 {
-    if (Channel > 7) {
-        Debug("ADS1256_SetChannel: Invalid channel %d\n", Channel);
-        return;
-    }
-    ADS1256_WriteReg(REG_MUX, (Channel << 4) | 0x08); // PSEL=Channel, NSEL=AINCOM
+    dev->deadline_ns = deadline_ns;
 }
 
 /**
- * @brief Sets the active input channel pair for differential measurements.
- * @param DiffPairIndex The differential channel pair index (0-3).
+ * @brief Returns the time at which DRDY was last seen low.
+ * @param dev Device context.
+ * @param ts Output for the CLOCK_MONOTONIC timestamp (kernel edge time in event mode).
  */
-static void ADS1256_SetDiffChannel(UBYTE DiffPairIndex) 
+void ADS1256_Dev_GetLastDRDYTime(ads1256_dev_t *dev, struct timespec *ts)
 {
-    UBYTE mux_val = 0;
-    switch (DiffPairIndex) {
-        case 0: mux_val = (ADS1256_MUX_AIN0 << 4) | ADS1256_MUX_AIN1; break; // AIN0 - AIN1
-        case 1: mux_val = (ADS1256_MUX_AIN2 << 4) | ADS1256_MUX_AIN3; break; // AIN2 - AIN3
-        case 2: mux_val = (ADS1256_MUX_AIN4 << 4) | ADS1256_MUX_AIN5; break; // AIN4 - AIN5
-        case 3: mux_val = (ADS1256_MUX_AIN6 << 4) | ADS1256_MUX_AIN7; break; // AIN6 - AIN7
-        // Additional combinations if needed, e.g., AIN1-AIN0
-        // case 4: mux_val = (ADS1256_MUX_AIN1 << 4) | ADS1256_MUX_AIN0; break; // AIN1 - AIN0 
-        default:
-            Debug("ADS1256_SetDiffChannel: Invalid differential pair index %d\n", DiffPairIndex);
-            return;
-    }
-    ADS1256_WriteReg(REG_MUX, mux_val);
+    if (ts) *ts = dev->last_drdy_time;
 }
 
 /**
- * @brief Initializes the ADS1256 module.
- * @param drate The desired data rate (ADS1256_DRATE enum).
- * @param gain The desired PGA gain (ADS1256_GAIN enum).
- * @param scan_mode The desired scan mode (SCAN_MODE_SINGLE_ENDED or SCAN_MODE_DIFFERENTIAL_INPUTS).
- * @return 0 on successful initialization, 1 on failure.
+ * @brief Reads the Chip ID from the ADS1256.
+ * @param dev Device context.
+ * @return The 4-bit chip ID. Expected value is 3 for ADS1256.
  */
-UBYTE ADS1256_init(ADS1256_DRATE drate, ADS1256_GAIN gain, ADS1256_SCAN_MODE scan_mode)
+UBYTE ADS1256_Dev_ReadChipID(ads1256_dev_t *dev)
 {
-    ScanMode = scan_mode;
-    ADS1256_reset();
-    UBYTE chip_id = ADS1256_ReadChipID();
-    if (chip_id == ADS1256_ID) { 
-        Debug("ADS1256_init: Chip ID read success (ID: %d)\r\n", chip_id);
-    } else {
-        fprintf(stderr, "ADS1256_init: Chip ID read failed (Expected: %d, Got: %d)\r\n", ADS1256_ID, chip_id);
-        return 1; 
-    }
-    ADS1256_ConfigADC(gain, drate); 
-    // ADS1256_WriteCmd(CMD_SELFCAL); // Optional: Perform self-calibration
-    // DEV_Delay_ms(200); 
-    // ADS1256_WaitDRDY(); 
+    UBYTE id = ADS1256_Dev_ReadReg(dev, REG_STATUS, 0); // ID bits never change, the shadow is good enough
+    return (id >> 4); 
+}
 
-    Debug("ADS1256_init: Initialization complete. Mode: %s\n", 
-          (ScanMode == SCAN_MODE_SINGLE_ENDED) ? "Single-Ended" : "Differential");
-    return 0; 
+/**
+ * @brief Sets the DRDY wait timeout and expected conversion period for a data rate.
+ * @param dev Device context.
+ * @param drate The data rate the next conversions run at.
+ */
+static void ADS1256_SetDrdyTimeout(ads1256_dev_t *dev, ADS1256_DRATE drate)
+{
+    // Allow a few conversion periods per DRDY cycle at the new rate
+    dev->drdy_timeout_us = (UDOUBLE)(ADS1256_DRDY_TIMEOUT_PERIODS * 1000000.0f / ADS1256_DrateToSps(drate))
+                      + ADS1256_DRDY_TIMEOUT_MARGIN_US;
+    dev->conv_period_ns = (uint64_t)(1e9f / ADS1256_DrateToSps(drate));
 }
 
 /**
- * @brief Reads the raw 24-bit ADC conversion data.
- * @return The raw 24-bit ADC data, sign-extended to UDOUBLE (uint32_t).
+ * @brief Stages a register write unless the shadow shows the chip already holds the value.
+ * @param dev Device context.
+ * @param upd Pending update to add to.
+ * @param reg Register address.
+ * @param value Value to write (read-only STATUS bits are ignored in the comparison).
  */
-static UDOUBLE ADS1256_read_ADC_Data(void)
+static void ADS1256_RegUpdate_Set(ads1256_dev_t *dev, ADS1256_RegUpdate *upd, UBYTE reg, UBYTE value)
 {
-    UDOUBLE read_value = 0;
-    UBYTE buf[3] = {0, 0, 0};
+    UBYTE writable = (reg == REG_STATUS) ? ADS1256_STATUS_WRITABLE : 0xFF;
 
-    DEV_Digital_Write(DEV_CS_PIN, LOW);
-    DEV_SPI_WriteByte(CMD_RDATA);    
-    // DEV_Delay_ms(1); // Small delay, t_6 is ~3.125us for 7.68MHz clock.
+    if ((dev->reg_valid & (1u << reg)) && ((dev->reg_shadow[reg] ^ value) & writable) == 0) {
+        upd->dirty &= ~(1u << reg);
+        return;
+    }
+    upd->value[reg] = value;
+    upd->dirty |= (1u << reg);
+}
 
-    buf[0] = DEV_SPI_ReadByte(); 
-    buf[1] = DEV_SPI_ReadByte(); 
-    buf[2] = DEV_SPI_ReadByte(); 
-    DEV_Digital_Write(DEV_CS_PIN, HIGH);
+/**
+ * @brief Maps a DRATE register value back to its enum.
+ * @param drate_reg DRATE register value.
+ * @return The matching ADS1256_DRATE, or ADS1256_DRATE_MAX if none matches.
+ */
+static ADS1256_DRATE ADS1256_DrateFromReg(UBYTE drate_reg)
+{
+    for (UBYTE d = 0; d < ADS1256_DRATE_MAX; d++) {
+        if (ADS1256_DRATE_E[d] == drate_reg) return (ADS1256_DRATE)d;
+    }
+    return ADS1256_DRATE_MAX;
+}
 
-    read_value = ((UDOUBLE)buf[0] << 16) | ((UDOUBLE)buf[1] << 8) | (UDOUBLE)buf[2];
+/**
+ * @brief Stages the saved OFC/FSC coefficients for a gain/DRATE pair, if the attached table has them.
+ * @param dev Device context.
+ * @param upd Pending update to add to.
+ * @param gain Gain the next conversions run at.
+ * @param drate Data rate the next conversions run at.
+ */
+static void ADS1256_StageCalibration(ads1256_dev_t *dev, ADS1256_RegUpdate *upd, ADS1256_GAIN gain, ADS1256_DRATE drate)
+{
+    if (!dev->cal_table || gain > ADS1256_GAIN_64 || drate >= ADS1256_DRATE_MAX) return;
+    if (!(dev->cal_table->valid[gain] & (1u << drate))) return;
 
-    if (read_value & 0x00800000) {
-        read_value |= 0xFF000000; 
+    const ADS1256_CalCoeffs *c = &dev->cal_table->coeffs[gain][drate];
+    for (UBYTE i = 0; i < 3; i++) {
+        ADS1256_RegUpdate_Set(dev, upd, REG_OFC0 + i, c->ofc[i]);
+        ADS1256_RegUpdate_Set(dev, upd, REG_FSC0 + i, c->fsc[i]);
     }
-    return read_value;
 }
 
 /**
- * @brief Gets the ADC conversion value for a specified channel.
- * @param Channel The channel number (0-7 for single-ended, 0-3 for differential pair index).
- * @return The raw ADC value for the channel, sign-extended.
+ * @brief Appends the staged register writes to a message as merged WREG bursts.
+ *
+ * Runs of adjacent dirty registers go out as one multi-register WREG. A single
+ * clean register between two runs is rewritten with its shadow value, which
+ * costs one byte instead of a second WREG header and t11 gap. The shadow is
+ * updated as the frames are built.
+ * @param dev Device context.
+ * @param msg Message segment array to append to (room for ADS1256_REG_UPDATE_SEGS).
+ * @param count Current number of segments; updated.
+ * @param upd Staged writes.
+ * @param tx Buffer (ADS1256_REG_UPDATE_TX bytes) for the WREG frames.
+ * @return Number of WREG frames appended (0 if nothing had to be written).
  */
-UDOUBLE ADS1256_GetChannelValue(UBYTE Channel) 
+static UBYTE ADS1256_AppendRegUpdate(ads1256_dev_t *dev, DEV_SPI_Segment *msg, UBYTE *count, const ADS1256_RegUpdate *upd, UBYTE *tx)
 {
-    UDOUBLE value = 0;
+    UBYTE frames = 0;
+    UBYTE pos = 0;
+    UBYTE reg = 0;
 
-    if (ScanMode == SCAN_MODE_SINGLE_ENDED) { 
-        if (Channel >= NUM_SINGLE_ENDED_CHANNELS) {
-            Debug("ADS1256_GetChannelValue: Invalid single-ended channel %d\n", Channel);
-            return 0;
-        }
-        ADS1256_SetChannel(Channel);
-    } else { // SCAN_MODE_DIFFERENTIAL_INPUTS
-        if (Channel >= NUM_DIFFERENTIAL_PAIRS) {
-            Debug("ADS1256_GetChannelValue: Invalid differential pair index %d\n", Channel);
-            return 0;
+    while (reg < ADS1256_NUM_REGS) {
+        if (!(upd->dirty & (1u << reg))) {
+            reg++;
+            continue;
         }
-        ADS1256_SetDiffChannel(Channel);
-    }
 
-    ADS1256_WriteCmd(CMD_SYNC);  
-    ADS1256_WriteCmd(CMD_WAKEUP);
+        UBYTE first = reg, last = reg;
+        while (last + 1 < ADS1256_NUM_REGS) {
+            if (upd->dirty & (1u << (last + 1))) {
+                last++;
+            } else if (last + 2 < ADS1256_NUM_REGS && (upd->dirty & (1u << (last + 2))) &&
+                       (dev->reg_valid & (1u << (last + 1))) && (last + 1) != REG_STATUS) {
+                last += 2; // Bridge one clean register
+            } else {
+                break;
+            }
+        }
 
-    ADS1256_WaitDRDY(); 
-    value = ADS1256_read_ADC_Data();
+        UBYTE *frame = &tx[pos];
+        frame[0] = CMD_WREG | first;
+        frame[1] = last - first; // Number of registers - 1
+        for (UBYTE r = first; r <= last; r++) {
+            UBYTE value = (upd->dirty & (1u << r)) ? upd->value[r] : dev->reg_shadow[r];
+            frame[2 + r - first] = value;
+            if (r == REG_STATUS && !(dev->reg_valid & (1u << r))) {
+                continue; // ID/DRDY bits unknown until STATUS is read back
+            }
+            if (r == REG_STATUS) {
+                value = (dev->reg_shadow[r] & ~ADS1256_STATUS_WRITABLE) | (value & ADS1256_STATUS_WRITABLE);
+            }
+            dev->reg_shadow[r] = value;
+            dev->reg_valid |= (1u << r);
+        }
 
-    return value;
+        UBYTE len = 2 + (last - first + 1);
+        msg[(*count)++] = (DEV_SPI_Segment){ .tx = frame, .len = len, .delay_usecs = ADS1256_T11_CMD_US };
+        pos += len;
+        frames++;
+        reg = last + 1;
+    }
+    return frames;
 }
 
 /**
- * @brief Reads ADC values from all relevant channels based on ScanMode.
- * @param ADC_Value Pointer to an array where the ADC values will be stored.
- *                  Size should be NUM_SINGLE_ENDED_CHANNELS or NUM_DIFFERENTIAL_PAIRS.
+ * @brief Appends SYNC and WAKEUP (with their t11 gaps) to a message to restart the conversion.
+ * @param msg Message segment array to append to.
+ * @param count Current number of segments; updated.
  */
-void ADS1256_GetAllChannels(UDOUBLE *ADC_Value)
+static void ADS1256_AppendSyncWakeup(DEV_SPI_Segment *msg, UBYTE *count)
 {
-    UBYTE i;
-    UBYTE num_channels_to_read = (ScanMode == SCAN_MODE_SINGLE_ENDED) ? 
-                                 NUM_SINGLE_ENDED_CHANNELS : NUM_DIFFERENTIAL_PAIRS;
+    static const UBYTE sync = CMD_SYNC;
+    static const UBYTE wakeup = CMD_WAKEUP;
 
-    for (i = 0; i < num_channels_to_read; i++) {
-        ADC_Value[i] = ADS1256_GetChannelValue(i);
-    }
+    msg[(*count)++] = (DEV_SPI_Segment){ .tx = &sync, .len = 1, .delay_usecs = ADS1256_T11_SYNC_US };
+    msg[(*count)++] = (DEV_SPI_Segment){ .tx = &wakeup, .len = 1, .delay_usecs = ADS1256_T11_CMD_US };
 }
 
-// --- Performance Monitoring and Optimized Read Functions ---
-
 /**
- * @brief Fixes sign extension for a raw 24-bit ADC value.
- * @param raw_value The raw 24-bit ADC value.
- * @return The sign-extended 32-bit value.
+ * @brief Sends a message with CS asserted.
+ *
+ * If the transfer fails the register shadow can no longer be trusted, so it
+ * is invalidated and the next configuration change rewrites every register.
+ * @param dev Device context.
+ * @param msg Message segments.
+ * @param count Number of segments.
+ * @return ADS1256_OK on success, ADS1256_ERROR on an SPI error.
  */
-static UDOUBLE ADS1256_fix_sign_extension(UDOUBLE raw_value) {
-    if (raw_value & 0x00800000) { 
-        raw_value |= 0xFF000000;  
+static UBYTE ADS1256_SendMessage(ads1256_dev_t *dev, const DEV_SPI_Segment *msg, UBYTE count)
+{
+    int ret = ADS1256_Transfer(dev, msg, count);
+
+    if (ret != 0) {
+        dev->reg_valid = 0;
+        return ADS1256_ERROR;
     }
-    return raw_value;
+    return ADS1256_OK;
 }
 
 /**
- * @brief Reads ADC data after ensuring proper settling time.
- * @param num_settling_drdy_cycles Number of DRDY cycles to wait for settling.
- * @return Settled raw ADC data, sign-extended.
+ * @brief Stages the registers ADS1256_Dev_ConfigADC() programs, plus saved calibration.
+ * @param dev Device context.
+ * @param upd Pending update to add to.
+ * @param gain The PGA gain setting (ADS1256_GAIN enum).
+ * @param drate The data rate (ADS1256_DRATE enum).
  */
-static UDOUBLE ADS1256_read_ADC_Data_settled(UBYTE num_settling_drdy_cycles)
+static void ADS1256_StageConfig(ads1256_dev_t *dev, ADS1256_RegUpdate *upd, ADS1256_GAIN gain, ADS1256_DRATE drate)
 {
-    UBYTE buf[3] = {0, 0, 0};
-    UDOUBLE read_value = 0;
+    UBYTE status_reg = (0 << 3) | // ORDER: MSB first
+                       (0 << 2) | // ACAL: Auto-Calibration disabled
+                       (0 << 1);  // BUFEN: Analog input buffer disabled (bits 7-4 and 0 are read-only)
 
-    if (num_settling_drdy_cycles == 0) num_settling_drdy_cycles = 1; 
+    UBYTE mux_reg = 0x01; // Default: AIN0 positive, AINCOM negative
 
-    for (UBYTE settle_count = 0; settle_count < num_settling_drdy_cycles; settle_count++) {
-        ADS1256_WaitDRDY(); 
-
-        if (settle_count == num_settling_drdy_cycles - 1) {
-            DEV_Digital_Write(DEV_CS_PIN, LOW);
-            DEV_SPI_WriteByte(CMD_RDATA);
-            buf[0] = DEV_SPI_ReadByte();
-            buf[1] = DEV_SPI_ReadByte();
-            buf[2] = DEV_SPI_ReadByte();
-            DEV_Digital_Write(DEV_CS_PIN, HIGH);
-        }
-    }
+    UBYTE adcon_reg = ADS1256_ADCON_VALUE(gain); // CLKOUT off, sensor detect off, PGA = gain
 
-    read_value = ((UDOUBLE)buf[0] << 16) | ((UDOUBLE)buf[1] << 8) | (UDOUBLE)buf[2];
-    return ADS1256_fix_sign_extension(read_value);
+    UBYTE drate_reg = ADS1256_DRATE_E[drate];
+
+    ADS1256_RegUpdate_Set(dev, upd, REG_STATUS, status_reg);
+    ADS1256_RegUpdate_Set(dev, upd, REG_MUX, mux_reg);
+    ADS1256_RegUpdate_Set(dev, upd, REG_ADCON, adcon_reg);
+    ADS1256_RegUpdate_Set(dev, upd, REG_DRATE, drate_reg);
+    ADS1256_StageCalibration(dev, upd, gain, drate);
 }
 
 /**
- * @brief Optimized function to acquire data from a specified list of up to N single-ended channels.
- * @param ADC_Value Pointer to an array to store the read ADC values.
- * @param channels Array of UBYTE specifying the channel numbers (0-7) to read.
- * @param num_channels_to_read The number of channels to read from the `channels` array.
- * @param settling_cycles Number of DRDY cycles to wait for settling after each channel switch.
+ * @brief Configures the ADS1256 ADC settings.
+ * @param dev Device context.
+ * @param gain The PGA gain setting (ADS1256_GAIN enum).
+ * @param drate The data rate (ADS1256_DRATE enum).
+ * @return ADS1256_OK on success, ADS1256_TIMEOUT if DRDY never asserted (or the deadline passed),
+ *         ADS1256_ERROR on an invalid argument or SPI error.
  */
-void ADS1256_GetNChannels_Optimized(UDOUBLE *ADC_Value, UBYTE *channels, UBYTE num_channels_to_read, UBYTE settling_cycles)
+UBYTE ADS1256_Dev_ConfigADC(ads1256_dev_t *dev, ADS1256_GAIN gain, ADS1256_DRATE drate)
 {
-    if (!ADC_Value || !channels || num_channels_to_read == 0) return;
-    if (num_channels_to_read > NUM_SINGLE_ENDED_CHANNELS) num_channels_to_read = NUM_SINGLE_ENDED_CHANNELS; 
-    if (settling_cycles == 0) settling_cycles = 1; 
+    if (ADS1256_DeviceBusy(dev, __func__)) return ADS1256_ERROR;
+    if (gain > ADS1256_GAIN_64 || drate >= ADS1256_DRATE_MAX) return ADS1256_ERROR;
 
-    // struct timeval scan_start_tv; // For more detailed per-scan timing if needed
-    // gettimeofday(&scan_start_tv, NULL);
+    ADS1256_RegUpdate upd = { .dirty = 0 };
+    ADS1256_StageConfig(dev, &upd, gain, drate);
 
-    for (UBYTE i = 0; i < num_channels_to_read; i++) {
-        UBYTE current_channel = channels[i];
+    ADS1256_SetDrdyTimeout(dev, drate);
+    if (upd.dirty == 0) {
+        Debug("ADS1256_ConfigADC: Registers already configured, nothing written\n");
+        return ADS1256_OK;
+    }
 
-        if (current_channel >= NUM_SINGLE_ENDED_CHANNELS) { 
-            ADC_Value[i] = 0; 
-            Debug("ADS1256_GetNChannels_Optimized: Invalid channel %d requested.\n", current_channel);
-            continue;
-        }
+    UBYTE status = ADS1256_WaitDRDY(dev);
+    if (status != ADS1256_OK) {
+        Debug("ADS1256_ConfigADC: DRDY not asserted, configuration skipped\n");
+        return status;
+    }
 
-        ADS1256_SetChannel(current_channel);
+    UBYTE tx[ADS1256_REG_UPDATE_TX];
+    DEV_SPI_Segment msg[ADS1256_REG_UPDATE_SEGS];
+    UBYTE count = 0;
+    ADS1256_AppendRegUpdate(dev, msg, &count, &upd, tx);
+    if (ADS1256_SendMessage(dev, msg, count) != ADS1256_OK) {
+        Debug("ADS1256_ConfigADC: SPI write failed\n");
+        return ADS1256_ERROR;
+    }
+    return ADS1256_OK;
+}
 
-        ADS1256_WriteCmd(CMD_SYNC);
-        ADS1256_WriteCmd(CMD_WAKEUP);
+/**
+ * @brief Sends staged register writes followed by SYNC/WAKEUP to restart conversion.
+ * @param dev Device context.
+ * @param upd Staged writes.
+ * @return ADS1256_OK on success (including when nothing had to be written), ADS1256_ERROR on an SPI error.
+ */
+static UBYTE ADS1256_Retune(ads1256_dev_t *dev, const ADS1256_RegUpdate *upd)
+{
+    UBYTE tx[ADS1256_REG_UPDATE_TX];
+    DEV_SPI_Segment msg[ADS1256_REG_UPDATE_SEGS + 2];
+    UBYTE count = 0;
 
-        ADC_Value[i] = ADS1256_read_ADC_Data_settled(settling_cycles);
+    if (!ADS1256_AppendRegUpdate(dev, msg, &count, upd, tx)) {
+        return ADS1256_OK;
     }
+    ADS1256_AppendSyncWakeup(msg, &count);
+    return ADS1256_SendMessage(dev, msg, count);
+}
 
-    perf_metrics.total_samples_acquired += num_channels_to_read;
-    perf_metrics.total_n_channel_scans++;
-
-    struct timeval current_time_tv;
-    gettimeofday(&current_time_tv, NULL);
-    double elapsed_seconds = (current_time_tv.tv_sec - perf_metrics.start_time.tv_sec) +
-                           (current_time_tv.tv_usec - perf_metrics.start_time.tv_usec) / 1000000.0;
+/**
+ * @brief Changes the PGA gain without resetting the chip.
+ * @param dev Device context.
+ * @param gain The new gain (ADS1256_GAIN enum).
+ * @return ADS1256_OK on success, ADS1256_ERROR on an invalid gain, SPI error or active RDATAC.
+ */
+UBYTE ADS1256_Dev_SetGain(ads1256_dev_t *dev, ADS1256_GAIN gain)
+{
+    if (gain > ADS1256_GAIN_64 || ADS1256_DeviceBusy(dev, __func__)) return ADS1256_ERROR;
 
-    if (elapsed_seconds > 0 && perf_metrics.theoretical_sps_per_channel > 0) {
-        perf_metrics.actual_avg_sps_total = perf_metrics.total_samples_acquired / elapsed_seconds;
-        perf_metrics.actual_avg_sps_per_channel = perf_metrics.actual_avg_sps_total / num_channels_to_read; // Avg over the N channels scanned
+    ADS1256_RegUpdate upd = { .dirty = 0 };
+    ADS1256_RegUpdate_Set(dev, &upd, REG_ADCON, ADS1256_ADCON_VALUE(gain));
+    ADS1256_StageCalibration(dev, &upd, gain, ADS1256_DrateFromReg(ADS1256_Dev_ReadReg(dev, REG_DRATE, 0)));
+    return ADS1256_Retune(dev, &upd);
+}
 
-        // Efficiency is based on how fast one of the N channels is being sampled vs its theoretical max
-        perf_metrics.efficiency_percent = (perf_metrics.actual_avg_sps_per_channel / perf_metrics.theoretical_sps_per_channel) * 100.0;
+/**
+ * @brief Changes the data rate without resetting the chip.
+ * @param dev Device context.
+ * @param drate The new data rate (ADS1256_DRATE enum).
+ * @return ADS1256_OK on success, ADS1256_ERROR on an invalid rate, SPI error or active RDATAC.
+ */
+UBYTE ADS1256_Dev_SetDataRate(ads1256_dev_t *dev, ADS1256_DRATE drate)
+{
+    if (drate >= ADS1256_DRATE_MAX || ADS1256_DeviceBusy(dev, __func__)) return ADS1256_ERROR;
+
+    ADS1256_RegUpdate upd = { .dirty = 0 };
+    ADS1256_RegUpdate_Set(dev, &upd, REG_DRATE, ADS1256_DRATE_E[drate]);
+    ADS1256_StageCalibration(dev, &upd, (ADS1256_GAIN)(ADS1256_Dev_ReadReg(dev, REG_ADCON, 0) & 0x07), drate);
+    UBYTE status = ADS1256_Retune(dev, &upd);
+    if (status == ADS1256_OK) {
+        ADS1256_SetDrdyTimeout(dev, drate);
     }
+    return status;
 }
 
 /**
- * @brief Ultra-fast acquisition from a list of up to N single-ended channels with minimal overhead.
- * @param ADC_Value Pointer to an array to store the read ADC values.
- * @param channels Array of UBYTE specifying the channel numbers (0-7) to read.
- * @param num_channels_to_read The number of channels to read from the `channels` array.
+ * @brief Builds the MUX register value for a single-ended measurement.
+ * @param Channel The channel number (0-7 for AIN0-AIN7 vs AINCOM).
+ * @param mux_val Output for the MUX register value.
+ * @return 0 on success, 1 if the channel is invalid.
  */
-void ADS1256_GetNChannels_Fast(UDOUBLE *ADC_Value, UBYTE *channels, UBYTE num_channels_to_read)
+static UBYTE ADS1256_SingleEndedMux(UBYTE Channel, UBYTE *mux_val)
 {
-    if (!ADC_Value || !channels || num_channels_to_read == 0) return;
-    if (num_channels_to_read > NUM_SINGLE_ENDED_CHANNELS) num_channels_to_read = NUM_SINGLE_ENDED_CHANNELS;
-
-    for (UBYTE i = 0; i < num_channels_to_read; i++) {
-        UBYTE current_channel = channels[i];
-
-        if (current_channel >= NUM_SINGLE_ENDED_CHANNELS) {
-            ADC_Value[i] = 0;
-            Debug("ADS1256_GetNChannels_Fast: Invalid channel %d requested.\n", current_channel);
-            continue;
-        }
-        // Optimized MUX setting: combine WREG MUX, num_reg, data into fewer SPI transactions if possible
-        // For now, using standard WriteReg for clarity, can be further optimized.
-        ADS1256_WriteReg(REG_MUX, (current_channel << 4) | 0x08); // Channel to AINCOM
-        // Minimal delay if any, e.g., DEV_Delay_us(1); // Datasheet t1 is MUX settling time
+    if (Channel > 7) {
+        Debug("ADS1256_SingleEndedMux: Invalid channel %d\n", Channel);
+        return 1;
+    }
+    *mux_val = (Channel << 4) | ADS1256_MUX_AINCOM; // PSEL=Channel, NSEL=AINCOM
+    return 0;
+}
 
-        ADS1256_WriteCmd(CMD_SYNC);
-        ADS1256_WriteCmd(CMD_WAKEUP);
+/**
+ * @brief Builds the MUX register value for a differential measurement.
+ * @param DiffPairIndex The differential channel pair index (0-3).
+ * @param mux_val Output for the MUX register value.
+ * @return 0 on success, 1 if the pair index is invalid.
+ */
+static UBYTE ADS1256_DiffMux(UBYTE DiffPairIndex, UBYTE *mux_val)
+{
+    switch (DiffPairIndex) {
+        case 0: *mux_val = (ADS1256_MUX_AIN0 << 4) | ADS1256_MUX_AIN1; break; // AIN0 - AIN1
+        case 1: *mux_val = (ADS1256_MUX_AIN2 << 4) | ADS1256_MUX_AIN3; break; // AIN2 - AIN3
+        case 2: *mux_val = (ADS1256_MUX_AIN4 << 4) | ADS1256_MUX_AIN5; break; // AIN4 - AIN5
+        case 3: *mux_val = (ADS1256_MUX_AIN6 << 4) | ADS1256_MUX_AIN7; break; // AIN6 - AIN7
+        // Additional combinations if needed, e.g., AIN1-AIN0
+        // case 4: *mux_val = (ADS1256_MUX_AIN1 << 4) | ADS1256_MUX_AIN0; break; // AIN1 - AIN0 
+        default:
+            Debug("ADS1256_DiffMux: Invalid differential pair index %d\n", DiffPairIndex);
+            return 1;
+    }
+    return 0;
+}
 
-        ADS1256_WaitDRDY(); // Minimal settling (1 DRDY cycle)
-        ADC_Value[i] = ADS1256_read_ADC_Data();
+/**
+ * @brief Builds the MUX value for a channel according to the current ScanMode.
+ * @param dev Device context.
+ * @param Channel Channel number (0-7 single-ended) or differential pair index (0-3).
+ * @param mux_val Output for the MUX register value.
+ * @return 0 on success, 1 if the channel is invalid for the current mode.
+ */
+static UBYTE ADS1256_ChannelMux(ads1256_dev_t *dev, UBYTE Channel, UBYTE *mux_val)
+{
+    if (dev->scan_mode == SCAN_MODE_SINGLE_ENDED) {
+        return ADS1256_SingleEndedMux(Channel, mux_val);
     }
-    perf_metrics.total_samples_acquired += num_channels_to_read;
-    perf_metrics.total_n_channel_scans++; 
+    return ADS1256_DiffMux(Channel, mux_val);
+}
+
+/**
+ * @brief Selects an input and restarts conversion in a single SPI message.
+ *
+ * Sends WREG MUX (skipped if the MUX already holds the value), SYNC and
+ * WAKEUP back to back with the required t11 gaps, so a channel switch costs
+ * one ioctl instead of three transactions.
+ * @param dev Device context.
+ * @param mux_val The MUX register value (PSEL << 4 | NSEL).
+ * @return ADS1256_OK on success, ADS1256_ERROR on an SPI error.
+ */
+static UBYTE ADS1256_SelectMux(ads1256_dev_t *dev, UBYTE mux_val)
+{
+    UBYTE wreg[3];
+    DEV_SPI_Segment msg[3];
+    UBYTE count = 0;
+    ADS1256_RegUpdate upd = { .dirty = 0 };
+
+    ADS1256_RegUpdate_Set(dev, &upd, REG_MUX, mux_val);
+    ADS1256_AppendRegUpdate(dev, msg, &count, &upd, wreg);
+    ADS1256_AppendSyncWakeup(msg, &count);
+    if (ADS1256_SendMessage(dev, msg, count) != ADS1256_OK) return ADS1256_ERROR;
+    dev->conv_start_ns = dev->spi_done_ns;
+    return ADS1256_OK;
 }
 
+// --- Polled Operations (reset, calibration) ---
 
 /**
- * @brief Initializes performance monitoring.
- * @param drate_enum_val The configured data rate (ADS1256_DRATE enum value).
+ * @brief Arms the DRDY step of the running operation.
+ * @param dev Device context.
+ * @param guard_ns Time from now before DRDY is looked at (DRDY may still show the previous state).
+ * @param timeout_us Time from now by which DRDY must have gone low.
  */
-void ADS1256_InitPerformanceMonitoring(ADS1256_DRATE drate_enum_val)
+static void ADS1256_OpWait(ads1256_dev_t *dev, uint64_t guard_ns, UDOUBLE timeout_us)
 {
-    float sps_value = 0.0f;
-    switch(drate_enum_val) {
-        case ADS1256_30000SPS: sps_value = 30000.0f; break;
-        case ADS1256_15000SPS: sps_value = 15000.0f; break;
-        case ADS1256_7500SPS:  sps_value = 7500.0f;  break;
-        case ADS1256_3750SPS:  sps_value = 3750.0f;  break;
-        case ADS1256_2000SPS:  sps_value = 2000.0f;  break;
-        case ADS1256_1000SPS:  sps_value = 1000.0f;  break;
-        case ADS1256_500SPS:   sps_value = 500.0f;   break;
-        case ADS1256_100SPS:   sps_value = 100.0f;   break;
-        case ADS1256_60SPS:    sps_value = 60.0f;    break;
-        case ADS1256_50SPS:    sps_value = 50.0f;    break;
-        case ADS1256_30SPS:    sps_value = 30.0f;    break;
-        case ADS1256_25SPS:    sps_value = 25.0f;    break;
-        case ADS1256_15SPS:    sps_value = 15.0f;    break;
-        case ADS1256_10SPS:    sps_value = 10.0f;    break;
-        case ADS1256_5SPS:     sps_value = 5.0f;     break;
-        case ADS1256_2d5SPS:   sps_value = 2.5f;     break;
-        default: sps_value = 2.5f; 
-                 Debug("ADS1256_InitPerformanceMonitoring: Unknown DRATE enum, defaulting to 2.5 SPS.\n");
-    }
-
-    perf_metrics.theoretical_sps_per_channel = sps_value;
-    perf_metrics.actual_avg_sps_per_channel = 0;
-    perf_metrics.actual_avg_sps_total = 0;
-    perf_metrics.efficiency_percent = 0;
-    perf_metrics.total_samples_acquired = 0;
-    perf_metrics.total_n_channel_scans = 0;
-
-    gettimeofday(&perf_metrics.start_time, NULL);
+    uint64_t now = DEV_Now_ns();
 
-    Debug("=== ADS1256 Performance Monitor Initialized ===\n");
-    Debug("Theoretical Max SPS (single channel continuous): %.0f\n",
-           perf_metrics.theoretical_sps_per_channel);
+    dev->op_ready_ns = now + guard_ns;
+    dev->op_deadline_ns = now + (uint64_t)timeout_us * 1000;
 }
 
 /**
- * @brief Gets a pointer to the current performance metrics structure.
- * @return Pointer to the static `perf_metrics` structure.
+ * @brief Checks, without blocking, whether DRDY ended the running operation's step.
+ * @param dev Device context.
+ * @return ADS1256_OK once DRDY is low, ADS1256_BUSY while it is not, ADS1256_TIMEOUT when
+ *         the step or the device deadline expired, ADS1256_ERROR on a GPIO error.
  */
-performance_metrics_t* ADS1256_GetPerformanceMetrics(void)
+static UBYTE ADS1256_OpPollDRDY(ads1256_dev_t *dev)
 {
-    // Ensure latest efficiency is calculated before returning
-    struct timeval current_time_tv;
-    gettimeofday(&current_time_tv, NULL);
-    double elapsed_seconds = (current_time_tv.tv_sec - perf_metrics.start_time.tv_sec) +
-                           (current_time_tv.tv_usec - perf_metrics.start_time.tv_usec) / 1000000.0;
-
-    if (elapsed_seconds > 0 && perf_metrics.theoretical_sps_per_channel > 0 && perf_metrics.total_samples_acquired > 0) {
-        // Note: actual_avg_sps_total is total samples / total time.
-        // actual_avg_sps_per_channel depends on how many channels were in each scan.
-        // For simplicity, if GetNChannels was used with N channels, then actual_avg_sps_per_channel was updated there.
-        // If GetChannelValue was used, this calculation might need adjustment based on usage pattern.
-        // Here, we recalculate overall average SPS if total_samples_acquired is the primary counter.
-        perf_metrics.actual_avg_sps_total = perf_metrics.total_samples_acquired / elapsed_seconds;
-        
-        // If we assume all scans were of a consistent number of channels (e.g. N from last N-channel call, or 1 for single calls)
-        // this efficiency calculation remains an approximation of per-channel throughput vs theoretical.
-        if (perf_metrics.total_n_channel_scans > 0) {
-             double avg_channels_per_scan_approx = (double)perf_metrics.total_samples_acquired / perf_metrics.total_n_channel_scans;
-             if (avg_channels_per_scan_approx > 0) {
-                double effective_sps_per_active_channel = perf_metrics.actual_avg_sps_total / avg_channels_per_scan_approx;
-                perf_metrics.efficiency_percent = (effective_sps_per_active_channel / perf_metrics.theoretical_sps_per_channel) * 100.0;
-             }
-        } else if (perf_metrics.total_samples_acquired > 0) { // Fallback if only single samples were taken
-            perf_metrics.efficiency_percent = (perf_metrics.actual_avg_sps_total / perf_metrics.theoretical_sps_per_channel) * 100.0;
-        }
+    uint64_t now = DEV_Now_ns();
 
-    } else {
-        perf_metrics.efficiency_percent = 0; // Not enough data
+    if (dev->deadline_ns && now >= dev->deadline_ns) {
+        ADS1256_COUNT(dev, deadline_misses, 1);
+        return ADS1256_TIMEOUT;
+    }
+    if (now < dev->op_ready_ns) return ADS1256_BUSY;
+
+    int ret = DEV_Port_DRDY_Wait(dev->port, 0, &dev->last_drdy_time);
+    if (ret == 0) {
+        dev->drdy_seen_ns = now;
+        return ADS1256_OK;
     }
-    return &perf_metrics;
+    if (ret < 0) {
+        ADS1256_COUNT(dev, gpio_errors, 1);
+        return ADS1256_ERROR;
+    }
+    if (now >= dev->op_deadline_ns) {
+        ADS1256_COUNT(dev, drdy_timeouts, 1);
+        return ADS1256_TIMEOUT;
+    }
+    return ADS1256_BUSY;
 }
 
 /**
- * @brief Prints a detailed performance report to stdout.
+ * @brief Reset step: once DRDY is back, reloads the shadow, checks the ID and configures the chip.
+ *
+ * The configuration write waits for DRDY, which was just seen low, so it
+ * does not block for more than one conversion period at the reset rate.
+ * @param dev Device context.
+ * @return ADS1256_BUSY, or the final status of the reset.
  */
-void ADS1256_PrintPerformanceReport(void)
+static UBYTE ADS1256_PollReset(ads1256_dev_t *dev)
 {
-    // Update metrics before printing
-    ADS1256_GetPerformanceMetrics(); 
+    UBYTE status = ADS1256_OpPollDRDY(dev);
+    if (status != ADS1256_OK) return status;
 
-    struct timeval current_time_tv;
-    gettimeofday(&current_time_tv, NULL);
-    double elapsed_seconds = (current_time_tv.tv_sec - perf_metrics.start_time.tv_sec) +
-                           (current_time_tv.tv_usec - perf_metrics.start_time.tv_usec) / 1000000.0;
+    if (ADS1256_RefreshShadow(dev) != ADS1256_OK) {
+        Debug("ADS1256_Poll: Register read after reset failed\n");
+        return ADS1256_ERROR;
+    }
+    UBYTE chip_id = ADS1256_Dev_ReadChipID(dev);
+    if (chip_id != ADS1256_ID) {
+        Debug("ADS1256_Poll: Chip ID read failed (Expected: %d, Got: %d)\n", ADS1256_ID, chip_id);
+        return ADS1256_ERROR;
+    }
+    Debug("ADS1256_Poll: Chip ID read success (ID: %d)\n", chip_id);
 
-    printf("\n=== ADS1256 Performance Report ===\n");
-    printf("Runtime: %.2f seconds\n", elapsed_seconds);
-    printf("Total Samples Acquired: %lu\n", perf_metrics.total_samples_acquired);
-    printf("Total N-Channel Scan Operations: %lu\n", perf_metrics.total_n_channel_scans);
-    printf("Theoretical Max SPS (single channel continuous): %.0f\n",
-           perf_metrics.theoretical_sps_per_channel);
-    printf("Actual Average Total SPS (all samples / time): %.1f\n",
-           perf_metrics.actual_avg_sps_total);
-    // The concept of "actual_avg_sps_per_channel" is tricky if scan types vary.
-    // The efficiency calculation gives a better sense of per-channel throughput vs theoretical.
-    printf("Overall Efficiency (Effective Per-Channel SPS vs Theoretical Single Channel Max): %.1f%%\n", perf_metrics.efficiency_percent);
+    dev->op = ADS1256_OP_NONE; // Last step: ConfigADC() would reject the busy device
+    return ADS1256_Dev_ConfigADC(dev, dev->op_gain, dev->op_drate);
+}
 
-    if (perf_metrics.total_samples_acquired == 0) {
-        printf("Status: No scan data yet.\n");
-    } else if (perf_metrics.efficiency_percent > 90) {
-        printf("Status: EXCELLENT - Near theoretical limits for the operation type.\n");
-    } else if (perf_metrics.efficiency_percent > 75) {
-        printf("Status: GOOD - Acceptable performance.\n");
-    } else if (perf_metrics.efficiency_percent > 50) {
-        printf("Status: FAIR - Consider optimization if higher throughput needed.\n");
-    } else {
-        printf("Status: POOR - Significant optimization may be needed or expectations reviewed.\n");
+/**
+ * @brief Calibration steps: sends the command once DRDY is low, then reads OFC/FSC once it is low again.
+ * @param dev Device context.
+ * @return ADS1256_BUSY, or the final status of the calibration.
+ */
+static UBYTE ADS1256_PollCalibrate(ads1256_dev_t *dev)
+{
+    UBYTE status = ADS1256_OpPollDRDY(dev);
+    if (status != ADS1256_OK) return status;
+
+    if (dev->op_step == 0) {
+        UBYTE cmd = dev->op_cmd;
+        DEV_SPI_Segment msg = { .tx = &cmd, .len = 1 };
+        dev->reg_valid &= ~ADS1256_CAL_REGS_MASK; // The chip rewrites OFC/FSC
+        if (ADS1256_SendMessage(dev, &msg, 1) != ADS1256_OK) return ADS1256_ERROR;
+        dev->op_step = 1;
+        ADS1256_OpWait(dev, (uint64_t)ADS1256_CAL_START_US * 1000, dev->op_timeout_us);
+        return ADS1256_BUSY;
     }
-    printf("=============================================\n\n");
+
+    if (ADS1256_ReadRegs(dev, REG_OFC0, 6, &dev->reg_shadow[REG_OFC0]) != ADS1256_OK) return ADS1256_ERROR;
+    dev->reg_valid |= ADS1256_CAL_REGS_MASK;
+    Debug("ADS1256_Calibrate: 0x%02X done, OFC %02X%02X%02X FSC %02X%02X%02X\n", dev->op_cmd,
+          dev->reg_shadow[REG_OFC2], dev->reg_shadow[REG_OFC1], dev->reg_shadow[REG_OFC0],
+          dev->reg_shadow[REG_FSC2], dev->reg_shadow[REG_FSC1], dev->reg_shadow[REG_FSC0]);
+    return ADS1256_OK;
 }
 
 /**
- * @brief Converts a raw ADC value to voltage.
- * @param raw_value The raw 24-bit ADC code, sign-extended.
- * @param vref_positive Positive reference voltage (e.g., 5.0V for +5V VREF, 2.5V for internal VREF).
- * @param vref_negative Negative reference voltage (e.g., 0.0V for GND, -2.5V for internal VREF).
- * @param gain_enum The PGA gain setting used during the ADC conversion.
- * @return The calculated voltage as a float.
+ * @brief Advances the running reset or calibration without blocking.
+ * @param dev Device context.
+ * @return ADS1256_BUSY while the operation runs, then its result (ADS1256_OK,
+ *         ADS1256_TIMEOUT or ADS1256_ERROR). ADS1256_OK if nothing runs.
  */
-float ADS1256_RawToVoltage(UDOUBLE raw_value, float vref_positive, float vref_negative, ADS1256_GAIN gain_enum)
+UBYTE ADS1256_Dev_Poll(ads1256_dev_t *dev)
 {
-    int32_t signed_adc_code = (int32_t)raw_value; // Cast to signed 32-bit
-    float pga_gain_val = 1.0f;
+    UBYTE status;
 
-    switch(gain_enum) {
+    switch (dev->op) {
+        case ADS1256_OP_RESET:     status = ADS1256_PollReset(dev); break;
+        case ADS1256_OP_CALIBRATE: status = ADS1256_PollCalibrate(dev); break;
+        default: return ADS1256_OK;
+    }
+    if (status != ADS1256_BUSY) dev->op = ADS1256_OP_NONE;
+    return status;
+}
+
+/**
+ * @brief Drives the running operation to its end, sleeping on DRDY between polls.
+ *
+ * Sleeps are bounded by the step timeout and the device deadline, so a
+ * blocking call returns as soon as the chip is ready or the time is up.
+ * @param dev Device context.
+ * @param status Return value of the call that started the operation.
+ * @return Final status of the operation.
+ */
+static UBYTE ADS1256_RunOp(ads1256_dev_t *dev, UBYTE status)
+{
+    while (status == ADS1256_BUSY) {
+        uint64_t now = DEV_Now_ns();
+
+        if (now < dev->op_ready_ns) {
+            struct timespec ts = { .tv_sec = 0, .tv_nsec = (long)(dev->op_ready_ns - now) };
+            nanosleep(&ts, NULL);
+        } else {
+            uint64_t until = dev->op_deadline_ns;
+            if (dev->deadline_ns && dev->deadline_ns < until) until = dev->deadline_ns;
+            if (until > now) DEV_Port_DRDY_Wait(dev->port, (UDOUBLE)((until - now + 999) / 1000), NULL);
+        }
+        status = ADS1256_Dev_Poll(dev);
+    }
+    return status;
+}
+
+/**
+ * @brief Starts a reset: pulses RESET (or sends the RESET command if the port has no reset line).
+ *
+ * Aborts a running operation and leaves RDATAC. ADS1256_Dev_Poll() then
+ * waits for the chip to signal DRDY, reloads the register shadow, checks
+ * the chip ID and programs the gain and data rate.
+ * @param dev Device context with its port set.
+ * @param drate Data rate to configure once the chip is back.
+ * @param gain PGA gain to configure once the chip is back.
+ * @return ADS1256_BUSY when started, ADS1256_ERROR on an invalid argument or a GPIO/SPI error.
+ */
+UBYTE ADS1256_Dev_ResetStart(ads1256_dev_t *dev, ADS1256_DRATE drate, ADS1256_GAIN gain)
+{
+    if (!dev->port || gain > ADS1256_GAIN_64 || drate >= ADS1256_DRATE_MAX) return ADS1256_ERROR;
+
+    dev->op = ADS1256_OP_NONE;
+    ADS1256_COUNT(dev, resets, 1);
+    dev->reg_valid = 0;         // Reloaded once the chip is back
+    dev->continuous_active = 0; // RESET also terminates RDATAC
+    dev->drdy_timeout_us = ADS1256_DRDY_TIMEOUT_DEFAULT_US;
+    dev->conv_period_ns = 0;    // No gaps are lent to the bus until a data rate is configured
+
+    if (dev->port->pins.rst_pin != DEV_PIN_NONE) {
+        if (DEV_Port_SetReset(dev->port, LOW) != 0) {
+            ADS1256_COUNT(dev, gpio_errors, 1);
+            return ADS1256_ERROR;
+        }
+        uint64_t low = DEV_Now_ns();
+        while (DEV_Now_ns() - low < ADS1256_RESET_PULSE_NS) {
+            // Pulse width is far below any sleep granularity
+        }
+        if (DEV_Port_SetReset(dev->port, HIGH) != 0) {
+            ADS1256_COUNT(dev, gpio_errors, 1);
+            return ADS1256_ERROR;
+        }
+    } else if (ADS1256_WriteCmd(dev, CMD_RESET) != ADS1256_OK) {
+        return ADS1256_ERROR;
+    }
+
+    dev->op = ADS1256_OP_RESET;
+    dev->op_step = 0;
+    dev->op_gain = gain;
+    dev->op_drate = drate;
+    ADS1256_OpWait(dev, ADS1256_RESET_GUARD_NS, ADS1256_DRDY_TIMEOUT_DEFAULT_US);
+    return ADS1256_BUSY;
+}
+
+/**
+ * @brief Starts a calibration at the current gain/DRATE; ADS1256_Dev_Poll() completes it.
+ *
+ * The command is sent on the first poll that sees DRDY low. DRDY then stays
+ * high while the calibration runs, which takes about three conversion
+ * periods for a self-calibration, so the step timeout is several periods.
+ * @param dev Device context.
+ * @param cal_cmd One of the five calibration commands.
+ * @return ADS1256_BUSY while running (or the result if it finished at once),
+ *         ADS1256_ERROR on an invalid command or a busy device.
+ */
+UBYTE ADS1256_Dev_CalibrateStart(ads1256_dev_t *dev, ADS1256_CMD cal_cmd)
+{
+    if (cal_cmd < CMD_SELFCAL || cal_cmd > CMD_SYSGCAL) {
+        Debug("ADS1256_CalibrateStart: 0x%02X is not a calibration command\n", cal_cmd);
+        return ADS1256_ERROR;
+    }
+    if (ADS1256_DeviceBusy(dev, __func__)) return ADS1256_ERROR;
+
+    ADS1256_DRATE drate = ADS1256_DrateFromReg(ADS1256_Dev_ReadReg(dev, REG_DRATE, 0));
+    if (drate >= ADS1256_DRATE_MAX) drate = ADS1256_2d5SPS; // Unknown rate: assume the slowest
+
+    dev->op = ADS1256_OP_CALIBRATE;
+    dev->op_step = 0;
+    dev->op_cmd = (UBYTE)cal_cmd;
+    dev->op_timeout_us = (UDOUBLE)(ADS1256_CAL_TIMEOUT_PERIODS * 1000000.0f / ADS1256_DrateToSps(drate))
+                         + ADS1256_CAL_TIMEOUT_MARGIN_US;
+    ADS1256_OpWait(dev, 0, dev->drdy_timeout_us);
+    return ADS1256_Dev_Poll(dev);
+}
+
+/**
+ * @brief Initializes an ADS1256 on a port.
+ *
+ * Runs ADS1256_Dev_ResetStart() and polls it to completion, sleeping on
+ * DRDY instead of fixed delays. Metrics and an attached calibration table
+ * are kept, so the device can be re-initialized without losing them.
+ * @param dev Device context, zero-initialized before the first call.
+ * @param port Port the chip is wired to (from DEV_Port_Open()).
+ * @param drate The desired data rate (ADS1256_DRATE enum).
+ * @param gain The desired PGA gain (ADS1256_GAIN enum).
+ * @param scan_mode The desired scan mode (SCAN_MODE_SINGLE_ENDED or SCAN_MODE_DIFFERENTIAL_INPUTS).
+ * @return 0 on successful initialization, 1 on failure.
+ */
+UBYTE ADS1256_Dev_Init(ads1256_dev_t *dev, DEV_Port *port, ADS1256_DRATE drate, ADS1256_GAIN gain,
+                       ADS1256_SCAN_MODE scan_mode)
+{
+    if (!dev || !port) return 1;
+
+    dev->port = port;
+    dev->scan_mode = scan_mode;
+    UBYTE status = ADS1256_RunOp(dev, ADS1256_Dev_ResetStart(dev, drate, gain));
+    if (status != ADS1256_OK) {
+        UBYTE chip_id = dev->reg_shadow[REG_STATUS] >> 4;
+        if (status == ADS1256_TIMEOUT) {
+            fprintf(stderr, "ADS1256_init: DRDY did not assert after reset\r\n");
+        } else if ((dev->reg_valid & (1u << REG_STATUS)) && chip_id != ADS1256_ID) {
+            fprintf(stderr, "ADS1256_init: Chip ID read failed (Expected: %d, Got: %d)\r\n", ADS1256_ID, chip_id);
+        } else {
+            fprintf(stderr, "ADS1256_init: Register access or configuration failed\r\n");
+        }
+        return 1;
+    }
+    // Calibration: attach saved coefficients with ADS1256_SetCalTable() before init,
+    // or run ADS1256_Calibrate(CMD_SELFCAL, NULL) here at the cost of the calibration time.
+
+    Debug("ADS1256_init: Initialization complete. Mode: %s\n", 
+          (dev->scan_mode == SCAN_MODE_SINGLE_ENDED) ? "Single-Ended" : "Differential");
+    return 0; 
+}
+
+/**
+ * @brief Takes over a chip that is already running, without resetting it.
+ *
+ * Sends SDATAC in case a previous owner left RDATAC active and reads
+ * STATUS..FSC2 back in one RREG. If the chip ID matches, the registers that
+ * differ from the requested configuration (and the attached calibration
+ * table) are rewritten in the same message as SYNC/WAKEUP. The chip counts as
+ * live once the first conversion at the requested rate signals DRDY.
+ * @param dev Device context with its port and scan mode set.
+ * @param drate The desired data rate.
+ * @param gain The desired PGA gain.
+ * @return ADS1256_OK if the chip was taken over, otherwise the status that calls for a reset.
+ */
+static UBYTE ADS1256_WarmStart(ads1256_dev_t *dev, ADS1256_DRATE drate, ADS1256_GAIN gain)
+{
+    dev->op = ADS1256_OP_NONE;
+    dev->continuous_active = 0;
+    dev->conv_period_ns = 0;
+    if (ADS1256_WriteCmd(dev, CMD_SDATAC) != ADS1256_OK) return ADS1256_ERROR;
+    if (ADS1256_RefreshShadow(dev) != ADS1256_OK) return ADS1256_ERROR;
+
+    UBYTE chip_id = ADS1256_Dev_ReadChipID(dev);
+    if (chip_id != ADS1256_ID) {
+        Debug("ADS1256_WarmInit: Chip ID %d, expected %d\n", chip_id, ADS1256_ID);
+        return ADS1256_ERROR;
+    }
+
+    UBYTE tx[ADS1256_REG_UPDATE_TX];
+    DEV_SPI_Segment msg[ADS1256_REG_UPDATE_SEGS + 2];
+    UBYTE count = 0;
+    ADS1256_RegUpdate upd = { .dirty = 0 };
+    ADS1256_StageConfig(dev, &upd, gain, drate);
+    ADS1256_AppendRegUpdate(dev, msg, &count, &upd, tx);
+    ADS1256_AppendSyncWakeup(msg, &count);
+    if (ADS1256_SendMessage(dev, msg, count) != ADS1256_OK) return ADS1256_ERROR;
+    dev->conv_start_ns = dev->spi_done_ns;
+
+    ADS1256_SetDrdyTimeout(dev, drate);
+    return ADS1256_WaitDRDY(dev);
+}
+
+/**
+ * @brief Initializes an ADS1256, skipping the reset when the chip is already up.
+ *
+ * Meant for processes that are restarted while the board stays powered: the
+ * chip keeps its registers and calibration, so only the registers that differ
+ * are rewritten and the first sample follows within about one conversion
+ * period. If the chip does not identify itself or never signals DRDY, this
+ * falls back to ADS1256_Dev_Init().
+ * @param dev Device context, zero-initialized before the first call.
+ * @param port Port the chip is wired to (from DEV_Port_Open()).
+ * @param drate The desired data rate (ADS1256_DRATE enum).
+ * @param gain The desired PGA gain (ADS1256_GAIN enum).
+ * @param scan_mode The desired scan mode.
+ * @return 0 on successful initialization, 1 on failure.
+ */
+UBYTE ADS1256_Dev_WarmInit(ads1256_dev_t *dev, DEV_Port *port, ADS1256_DRATE drate, ADS1256_GAIN gain,
+                           ADS1256_SCAN_MODE scan_mode)
+{
+    if (!dev || !port || gain > ADS1256_GAIN_64 || drate >= ADS1256_DRATE_MAX) return 1;
+
+    dev->port = port;
+    dev->scan_mode = scan_mode;
+    if (ADS1256_WarmStart(dev, drate, gain) == ADS1256_OK) {
+        ADS1256_COUNT(dev, warm_starts, 1);
+        Debug("ADS1256_WarmInit: Chip already running, reset skipped\n");
+        return 0;
+    }
+    Debug("ADS1256_WarmInit: Chip not usable as found, resetting\n");
+    return ADS1256_Dev_Init(dev, port, drate, gain, scan_mode);
+}
+
+/**
+ * @brief Fixes sign extension for a raw 24-bit ADC value.
+ * @param raw_value The raw 24-bit ADC value.
+ * @return The sign-extended 32-bit value.
+ */
+static UDOUBLE ADS1256_fix_sign_extension(UDOUBLE raw_value) {
+    if (raw_value & 0x00800000) { 
+        raw_value |= 0xFF000000;  
+    }
+    return raw_value;
+}
+
+/**
+ * @brief Reads the raw 24-bit ADC conversion data.
+ * @param dev Device context.
+ * @param value Output for the raw 24-bit ADC data, sign-extended to UDOUBLE (left untouched on error).
+ * @return ADS1256_OK on success, ADS1256_ERROR on an SPI error.
+ */
+static UBYTE ADS1256_read_ADC_Data(ads1256_dev_t *dev, UDOUBLE *value)
+{
+    UDOUBLE read_value = 0;
+    UBYTE buf[3] = {0, 0, 0};
+    UBYTE cmd = CMD_RDATA;
+    DEV_SPI_Segment msg[2] = {
+        { .tx = &cmd, .len = 1, .delay_usecs = ADS1256_T6_US }, // RDATA, then t6 before DOUT is valid
+        { .rx = buf,  .len = sizeof(buf) },                      // 24-bit result, MSB first
+    };
+
+    if (ADS1256_Transfer(dev, msg, 2) != 0) return ADS1256_ERROR;
+
+    read_value = ((UDOUBLE)buf[0] << 16) | ((UDOUBLE)buf[1] << 8) | (UDOUBLE)buf[2];
+    *value = ADS1256_fix_sign_extension(read_value);
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Converts one channel: selects it, waits for DRDY and reads the result.
+ * @param dev Device context.
+ * @param Channel The channel number (0-7 for single-ended, 0-3 for differential pair index).
+ * @param value Output for the raw ADC value, sign-extended (left untouched on error).
+ * @return ADS1256_OK on success, ADS1256_TIMEOUT if no result arrived in time,
+ *         ADS1256_ERROR on an invalid channel, SPI/GPIO error or active RDATAC.
+ */
+UBYTE ADS1256_Dev_ReadChannel(ads1256_dev_t *dev, UBYTE Channel, UDOUBLE *value)
+{
+    UBYTE mux_val = 0;
+
+    if (!value || ADS1256_DeviceBusy(dev, __func__)) return ADS1256_ERROR;
+
+    if (dev->scan_mode == SCAN_MODE_SINGLE_ENDED) { 
+        if (Channel >= NUM_SINGLE_ENDED_CHANNELS) {
+            Debug("ADS1256_ReadChannel: Invalid single-ended channel %d\n", Channel);
+            return ADS1256_ERROR;
+        }
+        ADS1256_SingleEndedMux(Channel, &mux_val);
+    } else { // SCAN_MODE_DIFFERENTIAL_INPUTS
+        if (Channel >= NUM_DIFFERENTIAL_PAIRS) {
+            Debug("ADS1256_ReadChannel: Invalid differential pair index %d\n", Channel);
+            return ADS1256_ERROR;
+        }
+        ADS1256_DiffMux(Channel, &mux_val);
+    }
+
+    if (ADS1256_SelectMux(dev, mux_val) != ADS1256_OK) return ADS1256_ERROR;
+
+    UBYTE status = ADS1256_WaitDRDY(dev);
+    if (status != ADS1256_OK) {
+        Debug("ADS1256_ReadChannel: No conversion result for channel %d\n", Channel);
+        return status;
+    }
+    return ADS1256_read_ADC_Data(dev, value);
+}
+
+/**
+ * @brief Gets the ADC conversion value for a specified channel.
+ * @param dev Device context.
+ * @param Channel The channel number (0-7 for single-ended, 0-3 for differential pair index).
+ * @return The raw ADC value for the channel, sign-extended (0 on failure).
+ */
+UDOUBLE ADS1256_Dev_GetChannelValue(ads1256_dev_t *dev, UBYTE Channel) 
+{
+    UDOUBLE value = 0;
+
+    ADS1256_Dev_ReadChannel(dev, Channel, &value);
+    return value;
+}
+
+/**
+ * @brief Reads ADC values from all relevant channels based on ScanMode.
+ * @param dev Device context.
+ * @param ADC_Value Pointer to an array where the ADC values will be stored.
+ *                  Size should be NUM_SINGLE_ENDED_CHANNELS or NUM_DIFFERENTIAL_PAIRS.
+ * @return ADS1256_OK, or the first error (that channel and the ones after it are set to 0).
+ */
+UBYTE ADS1256_Dev_GetAllChannels(ads1256_dev_t *dev, UDOUBLE *ADC_Value)
+{
+    UBYTE i;
+    UBYTE status = ADS1256_OK;
+    UBYTE num_channels_to_read = (dev->scan_mode == SCAN_MODE_SINGLE_ENDED) ? 
+                                 NUM_SINGLE_ENDED_CHANNELS : NUM_DIFFERENTIAL_PAIRS;
+
+    for (i = 0; i < num_channels_to_read; i++) {
+        ADC_Value[i] = 0;
+        if (status == ADS1256_OK) status = ADS1256_Dev_ReadChannel(dev, i, &ADC_Value[i]);
+    }
+    return status;
+}
+
+// --- Performance Monitoring and Optimized Read Functions ---
+
+/**
+ * @brief Reads ADC data after ensuring proper settling time.
+ * @param dev Device context.
+ * @param num_settling_drdy_cycles Number of DRDY cycles to wait for settling.
+ * @param value Output for the settled raw ADC data, sign-extended.
+ * @return ADS1256_OK on success, or the DRDY wait or SPI error (value is left untouched).
+ */
+static UBYTE ADS1256_read_ADC_Data_settled(ads1256_dev_t *dev, UBYTE num_settling_drdy_cycles, UDOUBLE *value)
+{
+    if (num_settling_drdy_cycles == 0) num_settling_drdy_cycles = 1; 
+
+    for (UBYTE settle_count = 0; settle_count < num_settling_drdy_cycles; settle_count++) {
+        UBYTE status = ADS1256_WaitDRDY(dev);
+        if (status != ADS1256_OK) {
+            return status;
+        }
+    }
+
+    return ADS1256_read_ADC_Data(dev, value);
+}
+
+/**
+ * @brief Accounts one completed N-channel scan in the performance metrics.
+ * @param dev Device context.
+ * @param num_channels Number of samples the scan produced.
+ */
+static void ADS1256_UpdateScanMetrics(ads1256_dev_t *dev, UBYTE num_channels)
+{
+    ADS1256_COUNT(dev, total_samples_acquired, num_channels);
+    ADS1256_COUNT(dev, total_n_channel_scans, 1);
+
+    uint64_t now = LatencyHist_Now();
+    if (dev->last_scan_ns != 0) {
+        LatencyHist_Record(&dev->metrics.scan_period, now - dev->last_scan_ns);
+    }
+    dev->last_scan_ns = now;
+}
+
+/**
+ * @brief Optimized function to acquire data from a specified list of up to N single-ended channels.
+ * @param dev Device context.
+ * @param ADC_Value Pointer to an array to store the read ADC values.
+ * @param channels Array of UBYTE specifying the channel numbers (0-7) to read.
+ * @param num_channels_to_read The number of channels to read from the `channels` array.
+ * @param settling_cycles Number of DRDY cycles to wait for settling after each channel switch.
+ * @return ADS1256_OK on success, or the first DRDY wait or SPI error (the scan is aborted).
+ */
+UBYTE ADS1256_Dev_GetNChannels_Optimized(ads1256_dev_t *dev, UDOUBLE *ADC_Value, UBYTE *channels, UBYTE num_channels_to_read, UBYTE settling_cycles)
+{
+    if (!ADC_Value || !channels || num_channels_to_read == 0) return ADS1256_ERROR;
+    if (ADS1256_DeviceBusy(dev, __func__)) return ADS1256_ERROR;
+    if (num_channels_to_read > NUM_SINGLE_ENDED_CHANNELS) num_channels_to_read = NUM_SINGLE_ENDED_CHANNELS; 
+    if (settling_cycles == 0) settling_cycles = 1; 
+
+    for (UBYTE i = 0; i < num_channels_to_read; i++) {
+        UBYTE current_channel = channels[i];
+
+        if (current_channel >= NUM_SINGLE_ENDED_CHANNELS) { 
+            ADC_Value[i] = 0; 
+            Debug("ADS1256_GetNChannels_Optimized: Invalid channel %d requested.\n", current_channel);
+            continue;
+        }
+
+        UBYTE status = ADS1256_SelectMux(dev, (current_channel << 4) | ADS1256_MUX_AINCOM);
+        if (status == ADS1256_OK) status = ADS1256_read_ADC_Data_settled(dev, settling_cycles, &ADC_Value[i]);
+        if (status != ADS1256_OK) {
+            Debug("ADS1256_GetNChannels_Optimized: Scan aborted at channel %d\n", current_channel);
+            return status;
+        }
+        LatencyHist_Record(&dev->metrics.conversion[i], dev->drdy_seen_ns - dev->conv_start_ns);
+    }
+
+    ADS1256_UpdateScanMetrics(dev, num_channels_to_read);
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Ultra-fast acquisition from a list of up to N single-ended channels with minimal overhead.
+ * @param dev Device context.
+ * @param ADC_Value Pointer to an array to store the read ADC values.
+ * @param channels Array of UBYTE specifying the channel numbers (0-7) to read.
+ * @param num_channels_to_read The number of channels to read from the `channels` array.
+ * @return ADS1256_OK on success, or the first DRDY wait or SPI error (the scan is aborted).
+ */
+UBYTE ADS1256_Dev_GetNChannels_Fast(ads1256_dev_t *dev, UDOUBLE *ADC_Value, UBYTE *channels, UBYTE num_channels_to_read)
+{
+    if (!ADC_Value || !channels || num_channels_to_read == 0) return ADS1256_ERROR;
+    if (ADS1256_DeviceBusy(dev, __func__)) return ADS1256_ERROR;
+    if (num_channels_to_read > NUM_SINGLE_ENDED_CHANNELS) num_channels_to_read = NUM_SINGLE_ENDED_CHANNELS;
+
+    for (UBYTE i = 0; i < num_channels_to_read; i++) {
+        UBYTE current_channel = channels[i];
+
+        if (current_channel >= NUM_SINGLE_ENDED_CHANNELS) {
+            ADC_Value[i] = 0;
+            Debug("ADS1256_GetNChannels_Fast: Invalid channel %d requested.\n", current_channel);
+            continue;
+        }
+        // WREG MUX, SYNC and WAKEUP go out as one SPI message
+        UBYTE status = ADS1256_SelectMux(dev, (current_channel << 4) | ADS1256_MUX_AINCOM); // Channel to AINCOM
+        if (status == ADS1256_OK) status = ADS1256_WaitDRDY(dev); // Minimal settling (1 DRDY cycle)
+        if (status == ADS1256_OK) {
+            LatencyHist_Record(&dev->metrics.conversion[i], dev->drdy_seen_ns - dev->conv_start_ns);
+            status = ADS1256_read_ADC_Data(dev, &ADC_Value[i]);
+        }
+        if (status != ADS1256_OK) {
+            Debug("ADS1256_GetNChannels_Fast: Scan aborted at channel %d\n", current_channel);
+            return status;
+        }
+    }
+    ADS1256_UpdateScanMetrics(dev, num_channels_to_read);
+    return ADS1256_OK;
+}
+
+// --- Scan Lists (Pipelined Multi-Channel Sequencer) ---
+
+/**
+ * @brief Clears a scan list.
+ * @param list Scan list to initialize.
+ */
+void ADS1256_ScanList_Init(ADS1256_ScanList *list)
+{
+    memset(list, 0, sizeof(*list));
+}
+
+/**
+ * @brief Appends an entry with an arbitrary PSEL/NSEL pair to a scan list.
+ * @param list Scan list.
+ * @param mux MUX register value, e.g. ADS1256_MUX(ADS1256_MUX_AIN2, ADS1256_MUX_AIN5).
+ * @param gain PGA gain for this entry.
+ * @param drate Data rate for this entry.
+ * @param settling_cycles DRDY cycles before the entry's result is taken (0 is treated as 1).
+ * @return ADS1256_OK on success, ADS1256_ERROR if the list is full or the gain/rate is invalid.
+ */
+UBYTE ADS1256_ScanList_Add(ADS1256_ScanList *list, UBYTE mux, ADS1256_GAIN gain, ADS1256_DRATE drate,
+                           UBYTE settling_cycles)
+{
+    if (!list || list->num_entries >= ADS1256_SCAN_MAX_ENTRIES || gain > ADS1256_GAIN_64 ||
+        drate >= ADS1256_DRATE_MAX) {
+        Debug("ADS1256_ScanList_Add: Scan list full or invalid gain %d / drate %d\n", gain, drate);
+        return ADS1256_ERROR;
+    }
+
+    ADS1256_ScanEntry *entry = &list->entries[list->num_entries++];
+    entry->mux = mux;
+    entry->gain = gain;
+    entry->drate = drate;
+    entry->settling_cycles = settling_cycles ? settling_cycles : 1;
+    entry->channel = mux >> 4; // Label with PSEL unless the caller assigns a channel number
+    list->primed = 0; // The pipeline has to be restarted with the new layout
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Builds a scan list from an array of channel numbers.
+ * @param dev Device context.
+ * @param list Scan list to (re)build.
+ * @param channels Channel numbers (0-7), or differential pair indices (0-3) in differential mode.
+ * @param num_channels Number of entries in `channels`.
+ * @param gain PGA gain applied to every entry.
+ * @param drate Data rate applied to every entry.
+ * @param settling_cycles DRDY cycles per entry (0 is treated as 1).
+ * @return ADS1256_OK on success, ADS1256_ERROR on an invalid channel or too many entries.
+ */
+UBYTE ADS1256_Dev_ScanList_Build(ads1256_dev_t *dev, ADS1256_ScanList *list, const UBYTE *channels, UBYTE num_channels,
+                                 ADS1256_GAIN gain, ADS1256_DRATE drate, UBYTE settling_cycles)
+{
+    if (!list || !channels || num_channels == 0 || num_channels > ADS1256_SCAN_MAX_ENTRIES) {
+        return ADS1256_ERROR;
+    }
+
+    ADS1256_ScanList_Init(list);
+    for (UBYTE i = 0; i < num_channels; i++) {
+        UBYTE mux_val = 0;
+        if (ADS1256_ChannelMux(dev, channels[i], &mux_val) != 0 ||
+            ADS1256_ScanList_Add(list, mux_val, gain, drate, settling_cycles) != ADS1256_OK) {
+            ADS1256_ScanList_Init(list);
+            return ADS1256_ERROR;
+        }
+        list->entries[i].channel = channels[i];
+    }
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Forces the next ADS1256_Scan() to restart the pipeline.
+ *
+ * Use after an idle period: otherwise the first result of the next scan is
+ * the conversion that was started at the end of the previous scan.
+ * @param list Scan list.
+ */
+void ADS1256_ScanList_Reset(ADS1256_ScanList *list)
+{
+    if (list) list->primed = 0;
+}
+
+/**
+ * @brief Appends the register changes for a scan entry plus SYNC and WAKEUP to a message.
+ *
+ * Only the MUX/ADCON/DRATE values that differ from the shadow are written,
+ * merged into one WREG burst, so entries sharing a gain and data rate cost a
+ * single-register WREG. On a gain or rate change the saved OFC/FSC
+ * coefficients for the new pair (if a table is attached) join the burst.
+ * @param dev Device context.
+ * @param msg Message segment array to append to.
+ * @param count Current number of segments; updated.
+ * @param entry Entry whose input is selected.
+ * @param tx Buffer (ADS1256_REG_UPDATE_TX bytes) for the WREG frames.
+ */
+static void ADS1256_AppendSelect(ads1256_dev_t *dev, DEV_SPI_Segment *msg, UBYTE *count, const ADS1256_ScanEntry *entry, UBYTE *tx)
+{
+    ADS1256_RegUpdate upd = { .dirty = 0 };
+
+    ADS1256_RegUpdate_Set(dev, &upd, REG_MUX, entry->mux);
+    ADS1256_RegUpdate_Set(dev, &upd, REG_ADCON, ADS1256_ADCON_VALUE(entry->gain));
+    ADS1256_RegUpdate_Set(dev, &upd, REG_DRATE, ADS1256_DRATE_E[entry->drate]);
+    if (upd.dirty & ((1u << REG_DRATE) | (1u << REG_ADCON))) {
+        ADS1256_StageCalibration(dev, &upd, entry->gain, entry->drate); // Burst continues through IO into OFC/FSC
+    }
+    if (upd.dirty & (1u << REG_DRATE)) {
+        ADS1256_SetDrdyTimeout(dev, entry->drate); // The next DRDY wait is for a conversion at this rate
+    }
+    ADS1256_AppendRegUpdate(dev, msg, count, &upd, tx);
+    ADS1256_AppendSyncWakeup(msg, count);
+}
+
+/**
+ * @brief Returns the last DRDY timestamp in nanoseconds.
+ * @param dev Device context.
+ * @return CLOCK_MONOTONIC time of the last DRDY edge.
+ */
+static uint64_t ADS1256_LastDRDYNs(const ads1256_dev_t *dev)
+{
+    return (uint64_t)dev->last_drdy_time.tv_sec * 1000000000ULL + (uint64_t)dev->last_drdy_time.tv_nsec;
+}
+
+/**
+ * @brief Stores one result as a raw value and/or a timestamped frame.
+ * @param dev Device context.
+ * @param out Raw value array, or NULL.
+ * @param frames Frame array, or NULL.
+ * @param i Index to store at.
+ * @param value Raw, sign-extended result.
+ * @param channel Channel label.
+ */
+static void ADS1256_StoreResult(ads1256_dev_t *dev, UDOUBLE *out, ads1256_frame_t *frames, UDOUBLE i,
+                                UDOUBLE value, UBYTE channel)
+{
+    if (out) out[i] = value;
+    if (frames) {
+        frames[i].timestamp_ns = ADS1256_LastDRDYNs(dev);
+        frames[i].sequence = dev->frame_seq++;
+        frames[i].value = value;
+        frames[i].channel = channel;
+    }
+}
+
+/**
+ * @brief Waits until the conversion of scan entry `i` is complete, priming the pipeline first if needed.
+ * @param dev Device context.
+ * @param list Scan list (valid, non-empty).
+ * @param i Entry index; must be 0 when the list is not primed.
+ * @return ADS1256_OK on success, or the DRDY wait/SPI error (the pipeline is reset).
+ */
+static UBYTE ADS1256_ScanWait(ads1256_dev_t *dev, ADS1256_ScanList *list, UBYTE i)
+{
+    if (!list->primed) {
+        UBYTE wreg_tx[ADS1256_REG_UPDATE_TX];
+        DEV_SPI_Segment msg[ADS1256_REG_UPDATE_SEGS + 2];
+        UBYTE count = 0;
+
+        if (i != 0) return ADS1256_ERROR; // A restarted pipeline begins with entry 0
+        ADS1256_AppendSelect(dev, msg, &count, &list->entries[0], wreg_tx);
+        if (ADS1256_SendMessage(dev, msg, count) != ADS1256_OK) return ADS1256_ERROR;
+        dev->conv_start_ns = dev->spi_done_ns;
+        list->primed = 1;
+    }
+
+    for (UBYTE settle = 0; settle < list->entries[i].settling_cycles; settle++) {
+        UBYTE status = ADS1256_WaitDRDY(dev);
+        if (status != ADS1256_OK) {
+            Debug("ADS1256_Scan: Scan aborted at entry %d\n", i);
+            list->primed = 0;
+            return status;
+        }
+    }
+    LatencyHist_Record(&dev->metrics.conversion[i], dev->drdy_seen_ns - dev->conv_start_ns);
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Switches to the entry after `i` and reads the result of entry `i`, already latched.
+ *
+ * Completing the last entry accounts the scan in the performance metrics.
+ * @param dev Device context.
+ * @param list Scan list (valid, non-empty).
+ * @param i Entry whose conversion ADS1256_ScanWait() saw complete.
+ * @param value Output for the raw, sign-extended result.
+ * @return ADS1256_OK on success, ADS1256_ERROR on an SPI error (the pipeline is reset).
+ */
+static UBYTE ADS1256_ScanSwitchRead(ads1256_dev_t *dev, ADS1256_ScanList *list, UBYTE i, UDOUBLE *value)
+{
+    UBYTE wreg_tx[ADS1256_REG_UPDATE_TX];
+    UBYTE rdata = CMD_RDATA;
+    UBYTE buf[3];
+    DEV_SPI_Segment msg[ADS1256_REG_UPDATE_SEGS + 4]; // WREG(s), SYNC, WAKEUP, RDATA, data
+    UBYTE count = 0;
+    const ADS1256_ScanEntry *next = &list->entries[(i + 1) % list->num_entries];
+
+    // Switch to the next entry, then read the result that is already latched
+    ADS1256_AppendSelect(dev, msg, &count, next, wreg_tx);
+    msg[count++] = (DEV_SPI_Segment){ .tx = &rdata, .len = 1, .delay_usecs = ADS1256_T6_US };
+    msg[count++] = (DEV_SPI_Segment){ .rx = buf, .len = sizeof(buf) };
+
+    if (ADS1256_SendMessage(dev, msg, count) != ADS1256_OK) {
+        list->primed = 0;
+        return ADS1256_ERROR;
+    }
+    dev->conv_start_ns = dev->spi_done_ns; // The next entry started converting at SYNC/WAKEUP
+
+    *value = ADS1256_fix_sign_extension(((UDOUBLE)buf[0] << 16) | ((UDOUBLE)buf[1] << 8) | (UDOUBLE)buf[2]);
+    if (i + 1 == list->num_entries) {
+        ADS1256_UpdateScanMetrics(dev, list->num_entries);
+    }
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Executes one pipelined pass over a scan list.
+ *
+ * When conversion `i` completes (DRDY low), a single SPI message switches the
+ * MUX (and ADCON/DRATE where they change) to entry `i+1`, restarts the conversion
+ * with SYNC/WAKEUP and only then clocks out the result of entry `i`, which the
+ * chip holds in its output register. Entry `i+1` therefore settles while entry
+ * `i` is being read. The last entry primes entry 0, so back-to-back scans
+ * keep the pipeline full.
+ * @param dev Device context.
+ * @param list Scan list built with ADS1256_ScanList_Build()/ADS1256_ScanList_Add().
+ * @param out Output array with one raw, sign-extended value per entry, or NULL.
+ * @param frames Output array with one frame per entry, or NULL.
+ * @return ADS1256_OK on success, or the DRDY wait error (the pipeline is reset).
+ */
+static UBYTE ADS1256_ScanPass(ads1256_dev_t *dev, ADS1256_ScanList *list, UDOUBLE *out, ads1256_frame_t *frames)
+{
+    if (!list || (!out && !frames) || list->num_entries == 0) return ADS1256_ERROR;
+    if (ADS1256_DeviceBusy(dev, "ADS1256_Dev_Scan")) return ADS1256_ERROR;
+
+    for (UBYTE i = 0; i < list->num_entries; i++) {
+        UDOUBLE value;
+        UBYTE status = ADS1256_ScanWait(dev, list, i);
+
+        if (status == ADS1256_OK) status = ADS1256_ScanSwitchRead(dev, list, i, &value);
+        if (status != ADS1256_OK) return status;
+        ADS1256_StoreResult(dev, out, frames, i, value, list->entries[i].channel);
+    }
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Executes one pipelined pass over a scan list.
+ * @param dev Device context.
+ * @param list Scan list built with ADS1256_ScanList_Build()/ADS1256_ScanList_Add().
+ * @param out Output array with one raw, sign-extended value per entry.
+ * @return ADS1256_OK on success, or the DRDY wait error (the pipeline is reset).
+ */
+UBYTE ADS1256_Dev_Scan(ads1256_dev_t *dev, ADS1256_ScanList *list, UDOUBLE *out)
+{
+    if (!out) return ADS1256_ERROR;
+    return ADS1256_ScanPass(dev, list, out, NULL);
+}
+
+/**
+ * @brief Executes one pipelined pass over a scan list and returns timestamped frames.
+ *
+ * Each frame is stamped with the DRDY that completed its own conversion
+ * (the last settling cycle of the entry).
+ * @param dev Device context.
+ * @param list Scan list built with ADS1256_ScanList_Build()/ADS1256_ScanList_Add().
+ * @param frames Output array with one frame per entry.
+ * @return ADS1256_OK on success, or the DRDY wait error (the pipeline is reset).
+ */
+UBYTE ADS1256_Dev_ScanFrames(ads1256_dev_t *dev, ADS1256_ScanList *list, ads1256_frame_t *frames)
+{
+    if (!frames) return ADS1256_ERROR;
+    return ADS1256_ScanPass(dev, list, NULL, frames);
+}
+
+/**
+ * @brief First half of one scan step: waits for entry `i`'s conversion (priming the pipeline at entry 0).
+ * @param dev Device context.
+ * @param list Scan list.
+ * @param i Entry index, counting up from 0 within a pass.
+ * @return ADS1256_OK on success, or ADS1256_TIMEOUT/ADS1256_ERROR (the pipeline is reset).
+ */
+UBYTE ADS1256_Dev_ScanWaitEntry(ads1256_dev_t *dev, ADS1256_ScanList *list, UBYTE i)
+{
+    if (!list || i >= list->num_entries) return ADS1256_ERROR;
+    if (ADS1256_DeviceBusy(dev, __func__)) return ADS1256_ERROR;
+    return ADS1256_ScanWait(dev, list, i);
+}
+
+/**
+ * @brief Second half of one scan step: starts the next entry's conversion and reads entry `i`.
+ * @param dev Device context.
+ * @param list Scan list.
+ * @param i Entry passed to the preceding ADS1256_Dev_ScanWaitEntry().
+ * @param frame Output for the timestamped result.
+ * @return ADS1256_OK on success, ADS1256_ERROR on an SPI error or a pipeline that is not primed.
+ */
+UBYTE ADS1256_Dev_ScanReadEntry(ads1256_dev_t *dev, ADS1256_ScanList *list, UBYTE i, ads1256_frame_t *frame)
+{
+    UDOUBLE value;
+
+    if (!list || !frame || i >= list->num_entries || !list->primed) return ADS1256_ERROR;
+    if (ADS1256_ScanSwitchRead(dev, list, i, &value) != ADS1256_OK) return ADS1256_ERROR;
+    ADS1256_StoreResult(dev, NULL, frame, 0, value, list->entries[i].channel);
+    return ADS1256_OK;
+}
+
+// --- Compiled Scan Kernels (ADS1256_kernels.def) ---
+
+/** @brief Bytes of one precomputed kernel frame: WREG MUX (3), SYNC, WAKEUP, RDATA. */
+#define ADS1256_KERNEL_FRAME 6
+#define ADS1256_KERNEL_REGS  ((UWORD)((1u << REG_MUX) | (1u << REG_ADCON) | (1u << REG_DRATE)))
+
+/**
+ * @brief Checks whether a kernel's pipeline is running on the device.
+ *
+ * A kernel pass ends by selecting entry 0, so the pipeline is primed exactly
+ * when the shadow shows entry 0 at the kernel's gain and rate. Any other
+ * access that changes these registers, or an error that invalidated them,
+ * makes the next pass prime again.
+ * @param dev Device context.
+ * @param mux MUX value of entry 0.
+ * @param gain Kernel gain.
+ * @param drate Kernel data rate.
+ * @return Non-zero if the next DRDY completes a conversion of entry 0.
+ */
+static inline int ADS1256_KernelPrimed(const ads1256_dev_t *dev, UBYTE mux, ADS1256_GAIN gain, ADS1256_DRATE drate)
+{
+    return !dev->continuous_active && (dev->reg_valid & ADS1256_KERNEL_REGS) == ADS1256_KERNEL_REGS &&
+           dev->reg_shadow[REG_MUX] == mux && dev->reg_shadow[REG_ADCON] == ADS1256_ADCON_VALUE(gain) &&
+           dev->reg_shadow[REG_DRATE] == ADS1256_DRATE_E[drate];
+}
+
+/**
+ * @brief Selects a kernel's entry 0 through the generic path and starts its conversion.
+ *
+ * This is the only place a kernel goes through the register diffing, so a
+ * gain or rate change also loads the attached calibration coefficients and
+ * the DRDY timeout.
+ * @param dev Device context.
+ * @param mux MUX value of entry 0.
+ * @param gain Kernel gain.
+ * @param drate Kernel data rate.
+ * @return ADS1256_OK on success, ADS1256_ERROR during RDATAC or on an SPI error.
+ */
+static UBYTE ADS1256_KernelPrime(ads1256_dev_t *dev, UBYTE mux, ADS1256_GAIN gain, ADS1256_DRATE drate)
+{
+    const ADS1256_ScanEntry first = { .mux = mux, .gain = gain, .drate = drate, .settling_cycles = 1 };
+    UBYTE wreg_tx[ADS1256_REG_UPDATE_TX];
+    DEV_SPI_Segment msg[ADS1256_REG_UPDATE_SEGS + 2];
+    UBYTE count = 0;
+
+    if (ADS1256_DeviceBusy(dev, "ADS1256_Kernel")) return ADS1256_ERROR;
+
+    ADS1256_AppendSelect(dev, msg, &count, &first, wreg_tx);
+    if (ADS1256_SendMessage(dev, msg, count) != ADS1256_OK) return ADS1256_ERROR;
+    dev->conv_start_ns = dev->spi_done_ns;
+    return ADS1256_OK;
+}
+
+/**
+ * @brief One kernel step: waits for entry `pos`, selects the next entry and reads the latched result.
+ *
+ * Inlined into every generated kernel with constant arguments, so the
+ * settling loop and all indices fold away.
+ * @param dev Device context.
+ * @param pos Position of the entry in the scan.
+ * @param settling_cycles DRDY cycles of the entry (>= 1).
+ * @param next Precomputed frame selecting the next entry.
+ * @param value Output for the raw, sign-extended result.
+ * @return ADS1256_OK on success, or the DRDY wait/SPI error (the MUX shadow is invalidated).
+ */
+static inline UBYTE ADS1256_KernelStep(ads1256_dev_t *dev, UBYTE pos, UBYTE settling_cycles, const UBYTE *next,
+                                       UDOUBLE *value)
+{
+    UBYTE buf[3];
+    const DEV_SPI_Segment msg[5] = {
+        { .tx = next,     .len = 3, .delay_usecs = ADS1256_T11_CMD_US },  // WREG MUX
+        { .tx = next + 3, .len = 1, .delay_usecs = ADS1256_T11_SYNC_US }, // SYNC
+        { .tx = next + 4, .len = 1, .delay_usecs = ADS1256_T11_CMD_US },  // WAKEUP
+        { .tx = next + 5, .len = 1, .delay_usecs = ADS1256_T6_US },       // RDATA
+        { .rx = buf,      .len = sizeof(buf) },
+    };
+
+    for (UBYTE settle = 0; settle < settling_cycles; settle++) {
+        UBYTE status = ADS1256_WaitDRDY(dev);
+        if (status != ADS1256_OK) {
+            Debug("ADS1256_Kernel: Scan aborted at entry %d\n", pos);
+            dev->reg_valid &= ~(1u << REG_MUX); // Forces the next pass to prime again
+            return status;
+        }
+    }
+    LatencyHist_Record(&dev->metrics.conversion[pos], dev->drdy_seen_ns - dev->conv_start_ns);
+
+    if (ADS1256_SendMessage(dev, msg, 5) != ADS1256_OK) return ADS1256_ERROR;
+    dev->conv_start_ns = dev->spi_done_ns;
+    dev->reg_shadow[REG_MUX] = next[2];
+
+    *value = ADS1256_fix_sign_extension(((UDOUBLE)buf[0] << 16) | ((UDOUBLE)buf[1] << 8) | (UDOUBLE)buf[2]);
+    return ADS1256_OK;
+}
+
+// Constant tables of each kernel: select frames, MUX values, settling cycles
+#define ADS1256_KERNEL_ENTRY(mux, settling_cycles) { CMD_WREG | REG_MUX, 0x00, (mux), CMD_SYNC, CMD_WAKEUP, CMD_RDATA },
+#define ADS1256_KERNEL(name, gain, drate, entries)                                                        \
+    _Static_assert(ADS1256_KERNEL_LEN_##name >= 1 && ADS1256_KERNEL_LEN_##name <= ADS1256_SCAN_MAX_ENTRIES, \
+                   "kernel " #name " needs 1 to ADS1256_SCAN_MAX_ENTRIES entries");                       \
+    static const UBYTE ADS1256_Kernel_##name##_frames[][ADS1256_KERNEL_FRAME] = { entries };
+#include ADS1256_KERNELS_DEF
+#undef ADS1256_KERNEL
+#undef ADS1256_KERNEL_ENTRY
+
+#define ADS1256_KERNEL_ENTRY(mux, settling_cycles) (mux),
+#define ADS1256_KERNEL(name, gain, drate, entries) static const UBYTE ADS1256_Kernel_##name##_mux[] = { entries };
+#include ADS1256_KERNELS_DEF
+#undef ADS1256_KERNEL
+#undef ADS1256_KERNEL_ENTRY
+
+#define ADS1256_KERNEL_ENTRY(mux, settling_cycles) ((settling_cycles) ? (settling_cycles) : 1),
+#define ADS1256_KERNEL(name, gain, drate, entries) \
+    static const UBYTE ADS1256_Kernel_##name##_settling[] = { entries };
+#include ADS1256_KERNELS_DEF
+#undef ADS1256_KERNEL
+#undef ADS1256_KERNEL_ENTRY
+
+// Kernel bodies: one unrolled step per entry, the last one selecting entry 0 again
+#define ADS1256_KERNEL_ENTRY(mux, settling_cycles)                                                          \
+    status = ADS1256_KernelStep(dev, pos, ((settling_cycles) ? (settling_cycles) : 1), frames[(pos + 1) % n], \
+                                &out[pos]);                                                                 \
+    if (status != ADS1256_OK) return status;                                                                \
+    pos++;
+#define ADS1256_KERNEL(name, gain, drate, entries)                                        \
+    UBYTE ADS1256_Dev_Kernel_##name(ads1256_dev_t *dev, UDOUBLE *out)                     \
+    {                                                                                     \
+        const UBYTE (*frames)[ADS1256_KERNEL_FRAME] = ADS1256_Kernel_##name##_frames;     \
+        const UBYTE n = ADS1256_KERNEL_LEN_##name;                                        \
+        UBYTE pos = 0;                                                                    \
+        UBYTE status;                                                                     \
+                                                                                          \
+        if (!ADS1256_KernelPrimed(dev, frames[0][2], (gain), (drate))) {                  \
+            status = ADS1256_KernelPrime(dev, frames[0][2], (gain), (drate));             \
+            if (status != ADS1256_OK) return status;                                      \
+        }                                                                                 \
+        entries                                                                           \
+        ADS1256_UpdateScanMetrics(dev, n);                                                \
+        return ADS1256_OK;                                                                \
+    }
+#include ADS1256_KERNELS_DEF
+#undef ADS1256_KERNEL
+#undef ADS1256_KERNEL_ENTRY
+
+// Run-time directory, terminated by an entry without a name
+#define ADS1256_KERNEL_ENTRY(mux, settling_cycles)
+#define ADS1256_KERNEL(name, gain, drate, entries)                                                   \
+    { #name, (gain), (drate), ADS1256_KERNEL_LEN_##name, ADS1256_Kernel_##name##_mux,                \
+      ADS1256_Kernel_##name##_settling, ADS1256_Dev_Kernel_##name },
+static const ADS1256_Kernel ADS1256_KernelTable[] = {
+#include ADS1256_KERNELS_DEF
+    { .name = NULL }
+};
+#undef ADS1256_KERNEL
+#undef ADS1256_KERNEL_ENTRY
+
+/**
+ * @brief Looks up a compiled kernel by name.
+ * @param name Name from ADS1256_kernels.def.
+ * @return The kernel, or NULL if none has that name.
+ */
+const ADS1256_Kernel *ADS1256_FindKernel(const char *name)
+{
+    if (!name) return NULL;
+    for (const ADS1256_Kernel *k = ADS1256_KernelTable; k->name; k++) {
+        if (strcmp(k->name, name) == 0) return k;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Returns a compiled kernel by position.
+ * @param index Position in ADS1256_kernels.def.
+ * @return The kernel, or NULL past the last one.
+ */
+const ADS1256_Kernel *ADS1256_GetKernel(UBYTE index)
+{
+    if (index >= sizeof(ADS1256_KernelTable) / sizeof(ADS1256_KernelTable[0]) - 1) return NULL;
+    return &ADS1256_KernelTable[index];
+}
+
+/**
+ * @brief Runs one scan of a kernel picked at run time.
+ * @param dev Device context.
+ * @param kernel Kernel from ADS1256_FindKernel()/ADS1256_GetKernel().
+ * @param out Output array with kernel->num_entries raw, sign-extended values.
+ * @return ADS1256_OK on success, or ADS1256_TIMEOUT/ADS1256_ERROR.
+ */
+UBYTE ADS1256_Dev_RunKernel(ads1256_dev_t *dev, const ADS1256_Kernel *kernel, UDOUBLE *out)
+{
+    if (!kernel || !kernel->scan || !out) return ADS1256_ERROR;
+    return kernel->scan(dev, out);
+}
+
+// --- Settling Auto-Tuner ---
+
+/**
+ * @brief Fills an auto-tuner configuration with defaults.
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_TuneConfig_Init(ADS1256_TuneConfig *cfg)
+{
+    cfg->tolerance_lsb = 32;
+    cfg->max_cycles = 16;
+    cfg->reference_cycles = 32;
+    cfg->repeats = 8;
+    cfg->step_mux = ADS1256_TUNE_STEP_PREVIOUS;
+}
+
+/**
+ * @brief Selects an entry the way a scan does and reads the conversion after a number of DRDY cycles.
+ * @param dev Device context.
+ * @param entry Entry to select.
+ * @param cycles DRDY cycles to wait (>= 1).
+ * @param value Output for the sign-extended result, or NULL to discard it.
+ * @return ADS1256_OK, or the SPI/DRDY wait error.
+ */
+static UBYTE ADS1256_TuneSample(ads1256_dev_t *dev, const ADS1256_ScanEntry *entry, UBYTE cycles, int32_t *value)
+{
+    UBYTE wreg_tx[ADS1256_REG_UPDATE_TX];
+    DEV_SPI_Segment msg[ADS1256_REG_UPDATE_SEGS + 2];
+    UBYTE count = 0;
+    UDOUBLE raw;
+
+    ADS1256_AppendSelect(dev, msg, &count, entry, wreg_tx);
+    if (ADS1256_SendMessage(dev, msg, count) != ADS1256_OK) return ADS1256_ERROR;
+    dev->conv_start_ns = dev->spi_done_ns;
+
+    UBYTE status = ADS1256_read_ADC_Data_settled(dev, cycles, &raw);
+    if (status != ADS1256_OK) return status;
+    if (value) *value = (int32_t)raw;
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Measures the settling each scan entry needs and stores it in the list.
+ *
+ * Every candidate count is tried with the same sequence the pipelined scan
+ * produces: the step source is selected and settled, then the entry is
+ * selected with SYNC/WAKEUP and read after that many DRDY cycles. Averaging
+ * `repeats` steps keeps conversion noise from deciding the result; the
+ * tolerance is widened by three standard errors of the noise measured on
+ * the settled readings.
+ * @param dev Device context.
+ * @param list Scan list to tune.
+ * @param cfg Configuration, or NULL for the defaults.
+ * @param results One result per entry, or NULL.
+ * @return ADS1256_OK on success (also if an entry did not converge), or the DRDY wait error.
+ */
+UBYTE ADS1256_Dev_ScanList_AutoTune(ads1256_dev_t *dev, ADS1256_ScanList *list, const ADS1256_TuneConfig *cfg,
+                                    ADS1256_TuneResult *results)
+{
+    ADS1256_TuneConfig defaults;
+    UBYTE status = ADS1256_OK;
+
+    if (!list || list->num_entries == 0) return ADS1256_ERROR;
+    if (ADS1256_DeviceBusy(dev, __func__)) return ADS1256_ERROR;
+    if (!cfg) {
+        ADS1256_TuneConfig_Init(&defaults);
+        cfg = &defaults;
+    }
+    if (cfg->max_cycles == 0 || cfg->repeats == 0) return ADS1256_ERROR;
+
+    for (UBYTE i = 0; i < list->num_entries; i++) {
+        ADS1256_ScanEntry *entry = &list->entries[i];
+        ADS1256_ScanEntry from = list->entries[(i + list->num_entries - 1) % list->num_entries];
+        ADS1256_TuneResult res = { .settling_cycles = cfg->max_cycles };
+        double sum = 0, sum_sq = 0;
+        int32_t v = 0;
+        UDOUBLE raw = 0;
+
+        if (cfg->step_mux != ADS1256_TUNE_STEP_PREVIOUS) {
+            from = *entry;
+            from.mux = cfg->step_mux;
+        }
+
+        // Settled value: long wait, then consecutive conversions of the same input
+        status = ADS1256_TuneSample(dev, entry, cfg->reference_cycles ? cfg->reference_cycles : 1, NULL);
+        for (UBYTE r = 0; r < cfg->repeats && status == ADS1256_OK; r++) {
+            status = ADS1256_read_ADC_Data_settled(dev, 1, &raw);
+            sum += (int32_t)raw;
+            sum_sq += (double)(int32_t)raw * (int32_t)raw;
+        }
+        if (status != ADS1256_OK) break;
+
+        double settled = sum / cfg->repeats;
+        double var = (cfg->repeats > 1) ? (sum_sq - sum * settled) / (cfg->repeats - 1) : 0.0;
+        res.settled = (int32_t)(settled < 0 ? settled - 0.5 : settled + 0.5);
+        res.noise_lsb = (var > 0) ? sqrt(var) : 0.0;
+        double limit = cfg->tolerance_lsb + 3.0 * res.noise_lsb / sqrt((double)cfg->repeats);
+
+        for (UBYTE k = 1; k <= cfg->max_cycles && status == ADS1256_OK; k++) {
+            sum = 0;
+            for (UBYTE r = 0; r < cfg->repeats && status == ADS1256_OK; r++) {
+                status = ADS1256_TuneSample(dev, &from, cfg->max_cycles, NULL);
+                if (status == ADS1256_OK) status = ADS1256_TuneSample(dev, entry, k, &v);
+                sum += v;
+            }
+            if (status != ADS1256_OK) break;
+
+            res.error_lsb = fabs(sum / cfg->repeats - settled);
+            if (res.error_lsb <= limit) {
+                res.settling_cycles = k;
+                res.converged = 1;
+                break;
+            }
+        }
+        if (status != ADS1256_OK) break;
+
+        entry->settling_cycles = res.settling_cycles;
+        if (results) results[i] = res;
+        Debug("ADS1256_ScanList_AutoTune: Entry %d (MUX 0x%02X): %d cycle(s), error %.1f LSB, noise %.1f LSB%s\r\n",
+              i, entry->mux, res.settling_cycles, res.error_lsb, res.noise_lsb, res.converged ? "" : " (not converged)");
+    }
+
+    if (status != ADS1256_OK) {
+        Debug("ADS1256_ScanList_AutoTune: Aborted, DRDY wait failed\r\n");
+    }
+    list->primed = 0;
+    return status;
+}
+
+// --- Calibration ---
+
+/**
+ * @brief Runs a calibration command at the current gain/DRATE and reads back the result.
+ *
+ * Blocking form of ADS1256_Dev_CalibrateStart(): the steps are polled with
+ * DRDY waits in between, bounded by the device deadline.
+ * @param dev Device context.
+ * @param cal_cmd One of the five calibration commands.
+ * @param coeffs Output for the new coefficients (may be NULL).
+ * @return ADS1256_OK, ADS1256_TIMEOUT or ADS1256_ERROR.
+ */
+UBYTE ADS1256_Dev_Calibrate(ads1256_dev_t *dev, ADS1256_CMD cal_cmd, ADS1256_CalCoeffs *coeffs)
+{
+    UBYTE status = ADS1256_RunOp(dev, ADS1256_Dev_CalibrateStart(dev, cal_cmd));
+    if (status != ADS1256_OK) {
+        Debug("ADS1256_Calibrate: Calibration 0x%02X did not complete (status %d)\n", cal_cmd, status);
+        return status;
+    }
+
+    if (coeffs) ADS1256_Dev_GetCalibration(dev, coeffs);
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Returns the coefficients currently in OFC0..FSC2.
+ * @param dev Device context.
+ * @param coeffs Output for the coefficients.
+ */
+void ADS1256_Dev_GetCalibration(ads1256_dev_t *dev, ADS1256_CalCoeffs *coeffs)
+{
+    for (UBYTE i = 0; i < 3; i++) {
+        coeffs->ofc[i] = ADS1256_Dev_ReadReg(dev, REG_OFC0 + i, 0);
+        coeffs->fsc[i] = ADS1256_Dev_ReadReg(dev, REG_FSC0 + i, 0);
+    }
+}
+
+/**
+ * @brief Writes OFC0..FSC2 with one WREG burst (skipped if unchanged).
+ * @param dev Device context.
+ * @param coeffs Coefficients to load.
+ * @return ADS1256_OK on success, ADS1256_ERROR on failure.
+ */
+UBYTE ADS1256_Dev_SetCalibration(ads1256_dev_t *dev, const ADS1256_CalCoeffs *coeffs)
+{
+    if (!coeffs || ADS1256_DeviceBusy(dev, __func__)) return ADS1256_ERROR;
+
+    ADS1256_RegUpdate upd = { .dirty = 0 };
+    for (UBYTE i = 0; i < 3; i++) {
+        ADS1256_RegUpdate_Set(dev, &upd, REG_OFC0 + i, coeffs->ofc[i]);
+        ADS1256_RegUpdate_Set(dev, &upd, REG_FSC0 + i, coeffs->fsc[i]);
+    }
+
+    UBYTE tx[ADS1256_REG_UPDATE_TX];
+    DEV_SPI_Segment msg[ADS1256_REG_UPDATE_SEGS];
+    UBYTE count = 0;
+    if (!ADS1256_AppendRegUpdate(dev, msg, &count, &upd, tx)) return ADS1256_OK;
+    return ADS1256_SendMessage(dev, msg, count); // New coefficients apply from the next conversion
+}
+
+/**
+ * @brief Attaches saved coefficients that are loaded on every gain/DRATE change.
+ * @param dev Device context.
+ * @param table Table to use, or NULL to detach.
+ */
+void ADS1256_Dev_SetCalTable(ads1256_dev_t *dev, const ADS1256_CalTable *table)
+{
+    dev->cal_table = table;
+}
+
+// --- SPI Clock ---
+
+/**
+ * @brief Sets the SCLK frequency of the device's messages.
+ * @param dev Device context.
+ * @param speed_hz Clock in Hz.
+ * @return ADS1256_OK on success, ADS1256_ERROR on an invalid speed or a closed port.
+ */
+UBYTE ADS1256_Dev_SetSpiSpeed(ads1256_dev_t *dev, UDOUBLE speed_hz)
+{
+    if (!dev->port || speed_hz == 0) return ADS1256_ERROR;
+    return (DEV_Port_SetSpeed(dev->port, speed_hz) == 0) ? ADS1256_OK : ADS1256_ERROR;
+}
+
+/**
+ * @brief Returns the SCLK frequency the device's messages use.
+ * @param dev Device context.
+ * @return Clock in Hz.
+ */
+UDOUBLE ADS1256_Dev_GetSpiSpeed(ads1256_dev_t *dev)
+{
+    return DEV_Port_GetSpeed(dev->port);
+}
+
+/**
+ * @brief Fills a probe configuration with defaults.
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_SpeedProbe_Init(ADS1256_SpeedProbe *cfg)
+{
+    cfg->min_hz = 1000000;
+    cfg->max_hz = ADS1256_SCLK_MAX_HZ;
+    cfg->step = 1.25f;
+    cfg->iterations = 64;
+    cfg->known_mux = ADS1256_PROBE_NO_INPUT;
+    cfg->known_reads = 8;
+    cfg->tolerance_lsb = 256;
+}
+
+/**
+ * @brief Compares a register burst with the shadow (STATUS ID and writable bits, IO skipped).
+ * @param dev Device context.
+ * @param regs STATUS..FSC2 as read from the chip.
+ * @return Number of mismatching registers.
+ */
+static unsigned long ADS1256_ProbeCompare(const ads1256_dev_t *dev, const UBYTE *regs)
+{
+    unsigned long errors = 0;
+
+    if ((regs[REG_STATUS] >> 4) != ADS1256_ID ||
+        ((regs[REG_STATUS] ^ dev->reg_shadow[REG_STATUS]) & ADS1256_STATUS_WRITABLE)) {
+        errors++;
+    }
+    for (UBYTE r = REG_MUX; r < ADS1256_NUM_REGS; r++) {
+        if (r != REG_IO && regs[r] != dev->reg_shadow[r]) errors++; // IO reads back its input pins
+    }
+    return errors;
+}
+
+/**
+ * @brief Runs one register write/readback round.
+ * @param dev Device context.
+ * @param round Round number, selects the pattern.
+ * @return Number of mismatching registers (an SPI error counts as one).
+ */
+static unsigned long ADS1256_ProbeRegisters(ads1256_dev_t *dev, UWORD round)
+{
+    UBYTE pattern[3] = {
+        (UBYTE)(0x55 ^ (round * 0x3B)),
+        (UBYTE)(0xAA ^ (round * 0x5D)),
+        (UBYTE)(0x0F + round * 0x11),
+    };
+    ADS1256_RegUpdate upd = { .dirty = 0 };
+    UBYTE tx[ADS1256_REG_UPDATE_TX];
+    DEV_SPI_Segment msg[ADS1256_REG_UPDATE_SEGS];
+    UBYTE regs[ADS1256_NUM_REGS];
+    UBYTE count = 0;
+
+    for (UBYTE i = 0; i < 3; i++) ADS1256_RegUpdate_Set(dev, &upd, REG_OFC0 + i, pattern[i]);
+    ADS1256_AppendRegUpdate(dev, msg, &count, &upd, tx);
+    if (count && ADS1256_Transfer(dev, msg, count) != 0) return 1;
+    if (ADS1256_ReadRegs(dev, REG_STATUS, ADS1256_NUM_REGS, regs) != ADS1256_OK) return 1;
+    return ADS1256_ProbeCompare(dev, regs);
+}
+
+/**
+ * @brief Converts the probe's known input.
+ * @param dev Device context.
+ * @param entry Input with the device's current gain and data rate.
+ * @param value Output for the sign-extended result.
+ * @return ADS1256_OK, or the SPI/DRDY wait error.
+ */
+static UBYTE ADS1256_ProbeInput(ads1256_dev_t *dev, const ADS1256_ScanEntry *entry, int32_t *value)
+{
+    return ADS1256_TuneSample(dev, entry, 1, value); // SYNC/WAKEUP makes the first result settled
+}
+
+/**
+ * @brief Writes a saved register set back with one forced update and verifies it.
+ * @param dev Device context.
+ * @param saved STATUS..FSC2 to restore.
+ * @return ADS1256_OK if the chip reads back the saved values, ADS1256_ERROR otherwise.
+ */
+static UBYTE ADS1256_ProbeRestore(ads1256_dev_t *dev, const UBYTE *saved)
+{
+    ADS1256_RegUpdate upd = { .dirty = (UWORD)ADS1256_REG_ALL_VALID };
+    UBYTE tx[ADS1256_REG_UPDATE_TX];
+    DEV_SPI_Segment msg[ADS1256_REG_UPDATE_SEGS];
+    UBYTE count = 0;
+
+    if (ADS1256_WriteCmd(dev, CMD_WAKEUP) != ADS1256_OK) return ADS1256_ERROR; // Leaves standby if a corrupted command entered it
+    memcpy(upd.value, saved, ADS1256_NUM_REGS);
+    dev->reg_valid = 0;
+    ADS1256_AppendRegUpdate(dev, msg, &count, &upd, tx);
+    if (ADS1256_SendMessage(dev, msg, count) != ADS1256_OK) return ADS1256_ERROR;
+    if (ADS1256_RefreshShadow(dev) != ADS1256_OK) return ADS1256_ERROR;
+
+    for (UBYTE r = REG_MUX; r < ADS1256_NUM_REGS; r++) {
+        if (r != REG_IO && dev->reg_shadow[r] != saved[r]) return ADS1256_ERROR;
+    }
+    return ((dev->reg_shadow[REG_STATUS] ^ saved[REG_STATUS]) & ADS1256_STATUS_WRITABLE) ? ADS1256_ERROR : ADS1256_OK;
+}
+
+/**
+ * @brief Finds the fastest SPI clock the device passes without errors and keeps it.
+ *
+ * Clocks are tried in increasing order and the first failure stops the
+ * probe, so a marginal clock above it is never selected. A failed clock can
+ * corrupt any register, not just OFC, so the whole register set saved at
+ * the start is written back at the chosen clock and verified.
+ * @param dev Device context.
+ * @param cfg Configuration, or NULL for the defaults.
+ * @param result Outcome, or NULL.
+ * @return ADS1256_OK when at least one clock passed, ADS1256_ERROR otherwise
+ *         (or if the registers could not be restored).
+ */
+UBYTE ADS1256_Dev_ProbeSpiSpeed(ads1256_dev_t *dev, const ADS1256_SpeedProbe *cfg, ADS1256_SpeedProbeResult *result)
+{
+    ADS1256_SpeedProbe defaults;
+    ADS1256_SpeedProbeResult res = { .best_hz = 0 };
+    UBYTE saved[ADS1256_NUM_REGS];
+    ADS1256_ScanEntry known = { .settling_cycles = 1 };
+    int use_input = (cfg && cfg->known_mux != ADS1256_PROBE_NO_INPUT && cfg->known_reads);
+    double reference = 0;
+
+    if (!dev->port || ADS1256_DeviceBusy(dev, __func__)) return ADS1256_ERROR;
+    if (!cfg) {
+        ADS1256_SpeedProbe_Init(&defaults);
+        cfg = &defaults;
+    }
+    if (cfg->min_hz == 0 || cfg->max_hz < cfg->min_hz || cfg->step <= 1.0f || cfg->iterations == 0) return ADS1256_ERROR;
+
+    UDOUBLE original_hz = DEV_Port_GetSpeed(dev->port);
+    if (ADS1256_RefreshShadow(dev) != ADS1256_OK) return ADS1256_ERROR;
+    memcpy(saved, dev->reg_shadow, sizeof(saved));
+
+    if (use_input) {
+        known.mux = cfg->known_mux;
+        known.gain = (ADS1256_GAIN)(saved[REG_ADCON] & 0x07);
+        known.drate = ADS1256_DrateFromReg(saved[REG_DRATE]);
+        if (known.drate >= ADS1256_DRATE_MAX) return ADS1256_ERROR;
+        for (UBYTE i = 0; i < cfg->known_reads; i++) { // Reference at the clock the device already runs at
+            int32_t v;
+            if (ADS1256_ProbeInput(dev, &known, &v) != ADS1256_OK) return ADS1256_ERROR;
+            reference += v;
+        }
+        reference /= cfg->known_reads;
+    }
+
+    for (double hz = cfg->min_hz; ; hz *= cfg->step) {
+        UDOUBLE speed = (hz >= cfg->max_hz) ? cfg->max_hz : (UDOUBLE)hz;
+        unsigned long reg_errors = 0, input_errors = 0;
+
+        DEV_Port_SetSpeed(dev->port, speed);
+        for (UWORD i = 0; i < cfg->iterations; i++) reg_errors += ADS1256_ProbeRegisters(dev, i);
+        if (use_input) {
+            for (UBYTE i = 0; i < cfg->known_reads && reg_errors == 0; i++) {
+                int32_t v;
+                if (ADS1256_ProbeInput(dev, &known, &v) != ADS1256_OK || fabs(v - reference) > cfg->tolerance_lsb) {
+                    input_errors++;
+                }
+            }
+        }
+        Debug("ADS1256_ProbeSpiSpeed: %u Hz: %lu register, %lu input errors\n", (unsigned)speed, reg_errors,
+              input_errors);
+
+        if (reg_errors || input_errors) {
+            res.failed_hz = speed;
+            res.reg_errors = reg_errors;
+            res.input_errors = input_errors;
+            break;
+        }
+        res.best_hz = speed;
+        res.steps_passed++;
+        if (speed >= cfg->max_hz) break;
+    }
+
+    DEV_Port_SetSpeed(dev->port, res.best_hz ? res.best_hz : original_hz);
+    UBYTE status = ADS1256_ProbeRestore(dev, saved);
+    if (status != ADS1256_OK) fprintf(stderr, "ADS1256_ProbeSpiSpeed: Registers could not be restored\r\n");
+    if (result) *result = res;
+    return (status == ADS1256_OK && res.best_hz) ? ADS1256_OK : ADS1256_ERROR;
+}
+
+// --- Continuous (RDATAC) Acquisition ---
+
+/**
+ * @brief Starts Read Data Continuous mode on a single channel.
+ *
+ * Selects the channel, restarts the digital filter once with SYNC/WAKEUP and
+ * issues RDATAC after the first DRDY. From then on every DRDY yields one
+ * result that is clocked out without any command byte.
+ * @param dev Device context.
+ * @param Channel Channel number (0-7 single-ended) or differential pair index (0-3),
+ *                interpreted according to the scan mode passed to ADS1256_init().
+ * @return ADS1256_OK on success, ADS1256_ERROR or ADS1256_TIMEOUT on failure.
+ */
+UBYTE ADS1256_Dev_StartContinuous(ads1256_dev_t *dev, UBYTE Channel)
+{
+    UBYTE mux_val = 0;
+    UBYTE cmd = CMD_RDATAC;
+    UBYTE first[3];
+    DEV_SPI_Segment msg[2] = {
+        { .tx = &cmd, .len = 1, .delay_usecs = ADS1256_T6_US }, // RDATAC, then t6
+        { .rx = first, .len = sizeof(first) },                   // Result that was ready when RDATAC was sent
+    };
+
+    if (ADS1256_DeviceBusy(dev, __func__)) return ADS1256_ERROR;
+    if (ADS1256_ChannelMux(dev, Channel, &mux_val) != 0) return ADS1256_ERROR;
+
+    if (ADS1256_SelectMux(dev, mux_val) != ADS1256_OK) return ADS1256_ERROR;
+
+    // RDATAC must be issued while DRDY is low
+    UBYTE status = ADS1256_WaitDRDY(dev);
+    if (status != ADS1256_OK) {
+        return status;
+    }
+
+    // The first result belongs to the RDATAC frame and is dropped
+    if (ADS1256_Transfer(dev, msg, 2) != 0) return ADS1256_ERROR;
+
+    dev->continuous_active = 1;
+    dev->continuous_channel = Channel;
+
+    dev->metrics.continuous_samples_acquired = 0;
+    dev->metrics.continuous_sps = 0;
+    dev->metrics.continuous_efficiency_percent = 0;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &dev->metrics.continuous_start_time);
+    dev->last_scan_ns = dev->drdy_seen_ns;
+
+    Debug("ADS1256_StartContinuous: RDATAC started on channel %d (MUX 0x%02X)\n", Channel, mux_val);
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Reads consecutive conversions while in continuous mode.
+ *
+ * Each sample costs one DRDY wait and one 3-byte transfer; no commands are sent.
+ * @param dev Device context.
+ * @param buf Output array for the raw, sign-extended results, or NULL.
+ * @param frames Output array for timestamped frames, or NULL.
+ * @param n Number of samples to read.
+ * @return ADS1256_OK when all samples were read, otherwise the DRDY wait or SPI error
+ *         (samples read before the error are stored and counted).
+ */
+static UBYTE ADS1256_ContinuousPass(ads1256_dev_t *dev, UDOUBLE *buf, ads1256_frame_t *frames, UDOUBLE n)
+{
+    UBYTE status = ADS1256_OK;
+    UDOUBLE count = 0;
+
+    if ((!buf && !frames) || !dev->continuous_active) {
+        Debug("ADS1256_ReadContinuous: Continuous mode not active\n");
+        return ADS1256_ERROR;
+    }
+
+    for (count = 0; count < n; count++) {
+        UBYTE data[3] = {0, 0, 0};
+        DEV_SPI_Segment seg = { .rx = data, .len = sizeof(data) };
+
+        status = ADS1256_WaitDRDY(dev);
+        if (status != ADS1256_OK) {
+            break;
+        }
+        // Sample period from DRDY to DRDY, which is the conversion cadence
+        LatencyHist_Record(&dev->metrics.scan_period, dev->drdy_seen_ns - dev->last_scan_ns);
+        dev->last_scan_ns = dev->drdy_seen_ns;
+
+        if (ADS1256_Transfer(dev, &seg, 1) != 0) {
+            status = ADS1256_ERROR;
+            break;
+        }
+
+        UDOUBLE value = ADS1256_fix_sign_extension(((UDOUBLE)data[0] << 16) | ((UDOUBLE)data[1] << 8) | (UDOUBLE)data[2]);
+        ADS1256_StoreResult(dev, buf, frames, count, value, dev->continuous_channel);
+    }
+
+    // Every sample is a complete single-channel "scan"
+    ADS1256_COUNT(dev, total_samples_acquired, count);
+    ADS1256_COUNT(dev, total_n_channel_scans, count);
+    ADS1256_COUNT(dev, continuous_samples_acquired, count);
+    return status;
+}
+
+/**
+ * @brief Reads consecutive conversions while in continuous mode.
+ * @param dev Device context.
+ * @param buf Output array for the raw, sign-extended results.
+ * @param n Number of samples to read.
+ * @return ADS1256_OK when all samples were read, otherwise the DRDY wait error
+ *         (samples read before the error are stored and counted).
+ */
+UBYTE ADS1256_Dev_ReadContinuous(ads1256_dev_t *dev, UDOUBLE *buf, UDOUBLE n)
+{
+    if (!buf) return ADS1256_ERROR;
+    return ADS1256_ContinuousPass(dev, buf, NULL, n);
+}
+
+/**
+ * @brief Reads consecutive conversions in continuous mode as timestamped frames.
+ * @param dev Device context.
+ * @param frames Output array of at least `n` frames.
+ * @param n Number of samples to read.
+ * @return ADS1256_OK when all samples were read, otherwise the DRDY wait error
+ *         (frames read before the error are stored).
+ */
+UBYTE ADS1256_Dev_ReadContinuousFrames(ads1256_dev_t *dev, ads1256_frame_t *frames, UDOUBLE n)
+{
+    if (!frames) return ADS1256_ERROR;
+    return ADS1256_ContinuousPass(dev, NULL, frames, n);
+}
+
+/**
+ * @brief Leaves continuous mode so that registers and commands are accepted again.
+ * @param dev Device context.
+ * @return ADS1256_OK on success, ADS1256_ERROR if continuous mode was not active or SDATAC could not be sent.
+ */
+UBYTE ADS1256_Dev_StopContinuous(ads1256_dev_t *dev)
+{
+    if (!dev->continuous_active) {
+        return ADS1256_ERROR;
+    }
+
+    // Issue SDATAC while DRDY is low so it cannot collide with a data update.
+    // On timeout it is sent anyway; the chip accepts SDATAC at any time.
+    ADS1256_WaitDRDY(dev);
+    if (ADS1256_WriteCmd(dev, CMD_SDATAC) != ADS1256_OK) {
+        return ADS1256_ERROR; // Still in RDATAC: retry, or recover with ADS1256_Dev_ResetStart()
+    }
+    dev->continuous_active = 0;
+    dev->last_scan_ns = 0;
+
+    Debug("ADS1256_StopContinuous: RDATAC stopped after %lu samples\n", dev->metrics.continuous_samples_acquired);
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Initializes performance monitoring.
+ * @param dev Device context.
+ * @param drate_enum_val The configured data rate (ADS1256_DRATE enum value).
+ */
+void ADS1256_Dev_InitPerformanceMonitoring(ads1256_dev_t *dev, ADS1256_DRATE drate_enum_val)
+{
+    float sps_value = ADS1256_DrateToSps(drate_enum_val);
+
+    dev->metrics.theoretical_sps_per_channel = sps_value;
+    dev->metrics.actual_avg_sps_per_channel = 0;
+    dev->metrics.actual_avg_sps_total = 0;
+    dev->metrics.efficiency_percent = 0;
+    dev->metrics.total_samples_acquired = 0;
+    dev->metrics.total_n_channel_scans = 0;
+    dev->metrics.continuous_samples_acquired = 0;
+    dev->metrics.continuous_sps = 0;
+    dev->metrics.continuous_efficiency_percent = 0;
+    dev->metrics.drdy_timeouts = 0;
+    dev->metrics.deadline_misses = 0;
+    dev->metrics.spi_errors = 0;
+    dev->metrics.gpio_errors = 0;
+    dev->metrics.resets = 0;
+    dev->metrics.warm_starts = 0;
+
+    LatencyHist_Reset(&dev->metrics.drdy_wait);
+    LatencyHist_Reset(&dev->metrics.spi_transaction);
+    for (UBYTE i = 0; i < ADS1256_SCAN_MAX_ENTRIES; i++) {
+        LatencyHist_Reset(&dev->metrics.conversion[i]);
+    }
+    LatencyHist_Reset(&dev->metrics.scan_period);
+    dev->last_scan_ns = dev->continuous_active ? dev->drdy_seen_ns : 0;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &dev->metrics.start_time);
+    dev->metrics.continuous_start_time = dev->metrics.start_time;
+
+    Debug("=== ADS1256 Performance Monitor Initialized ===\n");
+    Debug("Theoretical Max SPS (single channel continuous): %.0f\n",
+           dev->metrics.theoretical_sps_per_channel);
+}
+
+/**
+ * @brief Computes the derived rates and returns the performance metrics.
+ *
+ * Call it from one thread only; it writes the rate fields of the returned structure.
+ * @param dev Device context.
+ * @return Pointer to the device's metrics.
+ */
+performance_metrics_t* ADS1256_Dev_GetPerformanceMetrics(ads1256_dev_t *dev)
+{
+    // The acquisition path only counts; the rates are derived here, on demand
+    double elapsed_seconds = ADS1256_SecondsSince(&dev->metrics.start_time);
+    unsigned long samples = atomic_load_explicit(&dev->metrics.total_samples_acquired, memory_order_relaxed);
+    unsigned long scans = atomic_load_explicit(&dev->metrics.total_n_channel_scans, memory_order_relaxed);
+
+    dev->metrics.actual_avg_sps_total = 0;
+    dev->metrics.actual_avg_sps_per_channel = 0;
+    dev->metrics.efficiency_percent = 0; // Not enough data
+    if (elapsed_seconds > 0 && dev->metrics.theoretical_sps_per_channel > 0 && samples > 0 && scans > 0) {
+        dev->metrics.actual_avg_sps_total = samples / elapsed_seconds;
+
+        // Every channel of a scan is sampled once per scan, whatever the mix of scan sizes
+        dev->metrics.actual_avg_sps_per_channel = scans / elapsed_seconds;
+        dev->metrics.efficiency_percent =
+            (dev->metrics.actual_avg_sps_per_channel / dev->metrics.theoretical_sps_per_channel) * 100.0;
+    }
+
+    double continuous_seconds = ADS1256_SecondsSince(&dev->metrics.continuous_start_time);
+    unsigned long continuous = atomic_load_explicit(&dev->metrics.continuous_samples_acquired, memory_order_relaxed);
+
+    dev->metrics.continuous_sps = 0;
+    dev->metrics.continuous_efficiency_percent = 0;
+    if (continuous_seconds > 0 && dev->metrics.theoretical_sps_per_channel > 0 && continuous > 0) {
+        dev->metrics.continuous_sps = continuous / continuous_seconds;
+        dev->metrics.continuous_efficiency_percent =
+            (dev->metrics.continuous_sps / dev->metrics.theoretical_sps_per_channel) * 100.0;
+    }
+    return &dev->metrics;
+}
+
+/**
+ * @brief Prints a detailed performance report to stdout.
+ * @param dev Device context.
+ */
+void ADS1256_Dev_PrintPerformanceReport(ads1256_dev_t *dev)
+{
+    // Update metrics before printing
+    ADS1256_Dev_GetPerformanceMetrics(dev); 
+
+    double elapsed_seconds = ADS1256_SecondsSince(&dev->metrics.start_time);
+
+    printf("\n=== ADS1256 Performance Report ===\n");
+    printf("Runtime: %.2f seconds\n", elapsed_seconds);
+    printf("Total Samples Acquired: %lu\n", dev->metrics.total_samples_acquired);
+    printf("Total N-Channel Scan Operations: %lu\n", dev->metrics.total_n_channel_scans);
+    printf("Theoretical Max SPS (single channel continuous): %.0f\n",
+           dev->metrics.theoretical_sps_per_channel);
+    printf("Actual Average Total SPS (all samples / time): %.1f\n",
+           dev->metrics.actual_avg_sps_total);
+    // The concept of "actual_avg_sps_per_channel" is tricky if scan types vary.
+    // The efficiency calculation gives a better sense of per-channel throughput vs theoretical.
+    printf("Overall Efficiency (Effective Per-Channel SPS vs Theoretical Single Channel Max): %.1f%%\n", dev->metrics.efficiency_percent);
+    if (dev->metrics.continuous_samples_acquired > 0) {
+        printf("Continuous (RDATAC) Samples: %lu at %.1f SPS, Efficiency: %.1f%%\n",
+               dev->metrics.continuous_samples_acquired, dev->metrics.continuous_sps,
+               dev->metrics.continuous_efficiency_percent);
+    }
+    printf("DRDY Timeouts: %lu, Deadline Misses: %lu\n", dev->metrics.drdy_timeouts, dev->metrics.deadline_misses);
+    printf("SPI Errors: %lu, GPIO Errors: %lu, Resets: %lu, Warm Starts: %lu\n", dev->metrics.spi_errors,
+           dev->metrics.gpio_errors, dev->metrics.resets, dev->metrics.warm_starts);
+
+    printf("Latency (CLOCK_MONOTONIC_RAW):\n");
+    LatencyHist_Print("DRDY wait", &dev->metrics.drdy_wait);
+    LatencyHist_Print("SPI transaction", &dev->metrics.spi_transaction);
+    for (UBYTE i = 0; i < ADS1256_SCAN_MAX_ENTRIES; i++) {
+        char name[24];
+        snprintf(name, sizeof(name), "Conversion [%d]", i);
+        LatencyHist_Print(name, &dev->metrics.conversion[i]);
+    }
+    LatencyHist_Print("Scan period", &dev->metrics.scan_period);
+
+    if (dev->metrics.total_samples_acquired == 0) {
+        printf("Status: No scan data yet.\n");
+    } else if (dev->metrics.efficiency_percent > 90) {
+        printf("Status: EXCELLENT - Near theoretical limits for the operation type.\n");
+    } else if (dev->metrics.efficiency_percent > 75) {
+        printf("Status: GOOD - Acceptable performance.\n");
+    } else if (dev->metrics.efficiency_percent > 50) {
+        printf("Status: FAIR - Consider optimization if higher throughput needed.\n");
+    } else {
+        printf("Status: POOR - Significant optimization may be needed or expectations reviewed.\n");
+    }
+    printf("=============================================\n\n");
+}
+
+/**
+ * @brief Converts a raw ADC value to voltage.
+ * @param raw_value The raw 24-bit ADC code, sign-extended.
+ * @param vref_positive Positive reference voltage (e.g., 5.0V for +5V VREF, 2.5V for internal VREF).
+ * @param vref_negative Negative reference voltage (e.g., 0.0V for GND, -2.5V for internal VREF).
+ * @param gain_enum The PGA gain setting used during the ADC conversion.
+ * @return The calculated voltage as a float.
+ */
+float ADS1256_RawToVoltage(UDOUBLE raw_value, float vref_positive, float vref_negative, ADS1256_GAIN gain_enum)
+{
+    int32_t signed_adc_code = (int32_t)raw_value; // Cast to signed 32-bit
+    float pga_gain_val = 1.0f;
+
+    switch(gain_enum) {
         case ADS1256_GAIN_1  : pga_gain_val = 1.0f; break;
         case ADS1256_GAIN_2  : pga_gain_val = 2.0f; break;
         case ADS1256_GAIN_4  : pga_gain_val = 4.0f; break;
@@ -556,3 +2456,433 @@ float ADS1256_RawToVoltage(UDOUBLE raw_value, float vref_positive, float vref_ne
 
     return ((float)signed_adc_code / 8388608.0f) * (vref_span / pga_gain_val);
 }
+
+// --- Single-instance API: the board's ADC on the default port ---
+
+/**
+ * @brief Returns the device behind the single-instance API.
+ * @return Default device context.
+ */
+ads1256_dev_t *ADS1256_GetDefaultDev(void)
+{
+    return &default_dev;
+}
+
+/**
+ * @brief Initializes the ADS1256 module on the default port.
+ * @param drate The desired data rate (ADS1256_DRATE enum).
+ * @param gain The desired PGA gain (ADS1256_GAIN enum).
+ * @param scan_mode The desired scan mode (SCAN_MODE_SINGLE_ENDED or SCAN_MODE_DIFFERENTIAL_INPUTS).
+ * @return 0 on successful initialization, 1 on failure.
+ */
+UBYTE ADS1256_init(ADS1256_DRATE drate, ADS1256_GAIN gain, ADS1256_SCAN_MODE scan_mode)
+{
+    return ADS1256_Dev_Init(&default_dev, DEV_GetADCPort(), drate, gain, scan_mode);
+}
+
+/**
+ * @brief Initializes the default device, skipping the reset when the chip is already up.
+ * @param drate The desired data rate (ADS1256_DRATE enum).
+ * @param gain The desired PGA gain (ADS1256_GAIN enum).
+ * @param scan_mode The desired scan mode.
+ * @return 0 on successful initialization, 1 on failure.
+ */
+UBYTE ADS1256_WarmInit(ADS1256_DRATE drate, ADS1256_GAIN gain, ADS1256_SCAN_MODE scan_mode)
+{
+    return ADS1256_Dev_WarmInit(&default_dev, DEV_GetADCPort(), drate, gain, scan_mode);
+}
+
+/**
+ * @brief Starts a reset of the default device (on the default port if it was never initialized).
+ * @param drate Data rate to configure once the chip is back.
+ * @param gain PGA gain to configure once the chip is back.
+ * @return ADS1256_BUSY when started, ADS1256_ERROR on an invalid argument or a GPIO/SPI error.
+ */
+UBYTE ADS1256_ResetStart(ADS1256_DRATE drate, ADS1256_GAIN gain)
+{
+    if (!default_dev.port) default_dev.port = DEV_GetADCPort();
+    return ADS1256_Dev_ResetStart(&default_dev, drate, gain);
+}
+
+/**
+ * @brief Starts a calibration of the default device.
+ * @param cal_cmd Calibration command.
+ * @return ADS1256_BUSY while running (or the result if it finished at once),
+ *         ADS1256_ERROR on an invalid command or a busy device.
+ */
+UBYTE ADS1256_CalibrateStart(ADS1256_CMD cal_cmd)
+{
+    return ADS1256_Dev_CalibrateStart(&default_dev, cal_cmd);
+}
+
+/**
+ * @brief Advances the running operation of the default device.
+ * @return ADS1256_BUSY while the operation runs, then its result (ADS1256_OK,
+ *         ADS1256_TIMEOUT or ADS1256_ERROR). ADS1256_OK if nothing runs.
+ */
+UBYTE ADS1256_Poll(void)
+{
+    return ADS1256_Dev_Poll(&default_dev);
+}
+
+/**
+ * @brief Sets the deadline for blocking calls on the default device.
+ * @param deadline_ns Deadline on the DEV_Now_ns() clock, or 0 for none.
+ */
+void ADS1256_SetDeadline(uint64_t deadline_ns)
+{
+    ADS1256_Dev_SetDeadline(&default_dev, deadline_ns);
+}
+
+/**
+ * @brief Reads a register of the default device.
+ * @param Reg The register address (from ADS1256_REG enum).
+ * @param force Non-zero to bypass the shadow and read the chip.
+ * @return The register value (0 for an invalid address).
+ */
+UBYTE ADS1256_ReadReg(UBYTE Reg, UBYTE force)
+{
+    return ADS1256_Dev_ReadReg(&default_dev, Reg, force);
+}
+
+/**
+ * @brief Returns the timestamp of the last DRDY edge of the default device.
+ * @param ts Receives the timestamp.
+ */
+void ADS1256_GetLastDRDYTime(struct timespec *ts)
+{
+    ADS1256_Dev_GetLastDRDYTime(&default_dev, ts);
+}
+
+/**
+ * @brief Reads the chip ID of the default device.
+ * @return The 4-bit chip ID. Expected value is 3 for ADS1256.
+ */
+UBYTE ADS1256_ReadChipID(void)
+{
+    return ADS1256_Dev_ReadChipID(&default_dev);
+}
+
+/**
+ * @brief Sets gain and data rate of the default device.
+ * @param gain The PGA gain.
+ * @param drate The data rate.
+ * @return ADS1256_OK on success, ADS1256_TIMEOUT if DRDY never asserted (or the deadline passed),
+ *         ADS1256_ERROR on an invalid argument or SPI error.
+ */
+UBYTE ADS1256_ConfigADC(ADS1256_GAIN gain, ADS1256_DRATE drate)
+{
+    return ADS1256_Dev_ConfigADC(&default_dev, gain, drate);
+}
+
+/**
+ * @brief Sets the gain of the default device.
+ * @param gain The PGA gain.
+ * @return ADS1256_OK on success, ADS1256_ERROR on an invalid gain, SPI error or active RDATAC.
+ */
+UBYTE ADS1256_SetGain(ADS1256_GAIN gain)
+{
+    return ADS1256_Dev_SetGain(&default_dev, gain);
+}
+
+/**
+ * @brief Sets the data rate of the default device.
+ * @param drate The data rate.
+ * @return ADS1256_OK on success, ADS1256_ERROR on an invalid rate, SPI error or active RDATAC.
+ */
+UBYTE ADS1256_SetDataRate(ADS1256_DRATE drate)
+{
+    return ADS1256_Dev_SetDataRate(&default_dev, drate);
+}
+
+/**
+ * @brief Reads one channel of the default device.
+ * @param Channel Channel or differential pair index.
+ * @return The raw ADC value for the channel, sign-extended (0 on failure).
+ */
+UDOUBLE ADS1256_GetChannelValue(UBYTE Channel)
+{
+    return ADS1256_Dev_GetChannelValue(&default_dev, Channel);
+}
+
+/**
+ * @brief Reads one channel of the default device and reports the status.
+ * @param Channel Channel or differential pair index.
+ * @param value Receives the raw 24-bit value.
+ * @return ADS1256_OK on success, ADS1256_TIMEOUT if no result arrived in time,
+ *         ADS1256_ERROR on an invalid channel, SPI/GPIO error or active RDATAC.
+ */
+UBYTE ADS1256_ReadChannel(UBYTE Channel, UDOUBLE *value)
+{
+    return ADS1256_Dev_ReadChannel(&default_dev, Channel, value);
+}
+
+/**
+ * @brief Reads all channels of the default device.
+ * @param ADC_Value Receives one value per channel.
+ * @return ADS1256_OK, or the first error (that channel and the ones after it are set to 0).
+ */
+UBYTE ADS1256_GetAllChannels(UDOUBLE *ADC_Value)
+{
+    return ADS1256_Dev_GetAllChannels(&default_dev, ADC_Value);
+}
+
+/**
+ * @brief Reads several channels of the default device with settling cycles.
+ * @param ADC_Value Receives one value per channel.
+ * @param channels Channel indices.
+ * @param num_channels_to_read Number of channels.
+ * @param settling_cycles DRDY cycles discarded after each switch.
+ * @return ADS1256_OK on success, or the first DRDY wait or SPI error (the scan is aborted).
+ */
+UBYTE ADS1256_GetNChannels_Optimized(UDOUBLE *ADC_Value, UBYTE *channels, UBYTE num_channels_to_read, UBYTE settling_cycles)
+{
+    return ADS1256_Dev_GetNChannels_Optimized(&default_dev, ADC_Value, channels, num_channels_to_read, settling_cycles);
+}
+
+/**
+ * @brief Reads a list of single-ended channels of the default device with minimal overhead,
+ *        one channel select, DRDY wait and RDATA after another.
+ * @param ADC_Value Receives one value per channel.
+ * @param channels Channel indices.
+ * @param num_channels_to_read Number of channels.
+ * @return ADS1256_OK on success, or the first DRDY wait or SPI error (the scan is aborted).
+ */
+UBYTE ADS1256_GetNChannels_Fast(UDOUBLE *ADC_Value, UBYTE *channels, UBYTE num_channels_to_read)
+{
+    return ADS1256_Dev_GetNChannels_Fast(&default_dev, ADC_Value, channels, num_channels_to_read);
+}
+
+/**
+ * @brief Builds a scan list for the default device's scan mode.
+ * @param list Scan list to fill.
+ * @param channels Channel indices.
+ * @param num_channels Number of channels.
+ * @param gain PGA gain for every entry.
+ * @param drate Data rate for every entry.
+ * @param settling_cycles DRDY cycles per entry (0 is treated as 1).
+ * @return ADS1256_OK on success, ADS1256_ERROR on an invalid channel or too many entries.
+ */
+UBYTE ADS1256_ScanList_Build(ADS1256_ScanList *list, const UBYTE *channels, UBYTE num_channels,
+                             ADS1256_GAIN gain, ADS1256_DRATE drate, UBYTE settling_cycles)
+{
+    return ADS1256_Dev_ScanList_Build(&default_dev, list, channels, num_channels, gain, drate, settling_cycles);
+}
+
+/**
+ * @brief Runs one pass of a scan list on the default device.
+ * @param list Scan list.
+ * @param out Receives one value per entry.
+ * @return ADS1256_OK on success, or the DRDY wait error (the pipeline is reset).
+ */
+UBYTE ADS1256_Scan(ADS1256_ScanList *list, UDOUBLE *out)
+{
+    return ADS1256_Dev_Scan(&default_dev, list, out);
+}
+
+/**
+ * @brief Runs one pass of a scan list on the default device, returning frames.
+ * @param list Scan list.
+ * @param frames Receives one frame per entry.
+ * @return ADS1256_OK on success, or the DRDY wait error (the pipeline is reset).
+ */
+UBYTE ADS1256_ScanFrames(ADS1256_ScanList *list, ads1256_frame_t *frames)
+{
+    return ADS1256_Dev_ScanFrames(&default_dev, list, frames);
+}
+
+/**
+ * @brief Auto-tunes the settling of a scan list on the default device.
+ * @param list Scan list.
+ * @param cfg Configuration, or NULL for the defaults.
+ * @param results One result per entry, or NULL.
+ * @return ADS1256_OK on success (also if an entry did not converge), or the DRDY wait error.
+ */
+UBYTE ADS1256_ScanList_AutoTune(ADS1256_ScanList *list, const ADS1256_TuneConfig *cfg, ADS1256_TuneResult *results)
+{
+    return ADS1256_Dev_ScanList_AutoTune(&default_dev, list, cfg, results);
+}
+
+/**
+ * @brief Waits for a scan entry's conversion on the default device.
+ * @param list Scan list.
+ * @param i Entry index.
+ * @return ADS1256_OK on success, or ADS1256_TIMEOUT/ADS1256_ERROR (the pipeline is reset).
+ */
+UBYTE ADS1256_ScanWaitEntry(ADS1256_ScanList *list, UBYTE i)
+{
+    return ADS1256_Dev_ScanWaitEntry(&default_dev, list, i);
+}
+
+/**
+ * @brief Starts the next entry and reads entry `i` on the default device.
+ * @param list Scan list.
+ * @param i Entry index.
+ * @param frame Output for the timestamped result.
+ * @return ADS1256_OK on success, ADS1256_ERROR on an SPI error or a pipeline that is not primed.
+ */
+UBYTE ADS1256_ScanReadEntry(ADS1256_ScanList *list, UBYTE i, ads1256_frame_t *frame)
+{
+    return ADS1256_Dev_ScanReadEntry(&default_dev, list, i, frame);
+}
+
+// ADS1256_Kernel_<name>(): each compiled kernel on the default device
+#define ADS1256_KERNEL_ENTRY(mux, settling_cycles)
+#define ADS1256_KERNEL(name, gain, drate, entries)             \
+    UBYTE ADS1256_Kernel_##name(UDOUBLE *out)                  \
+    {                                                          \
+        return ADS1256_Dev_Kernel_##name(&default_dev, out);   \
+    }
+#include ADS1256_KERNELS_DEF
+#undef ADS1256_KERNEL
+#undef ADS1256_KERNEL_ENTRY
+
+/**
+ * @brief Runs one scan of a kernel picked at run time on the default device.
+ * @param kernel Kernel from ADS1256_FindKernel()/ADS1256_GetKernel().
+ * @param out Output array with kernel->num_entries raw, sign-extended values.
+ * @return ADS1256_OK on success, or ADS1256_TIMEOUT/ADS1256_ERROR.
+ */
+UBYTE ADS1256_RunKernel(const ADS1256_Kernel *kernel, UDOUBLE *out)
+{
+    return ADS1256_Dev_RunKernel(&default_dev, kernel, out);
+}
+
+/**
+ * @brief Sets the SCLK frequency of the default device.
+ * @param speed_hz Clock in Hz.
+ * @return ADS1256_OK on success, ADS1256_ERROR on an invalid speed or a closed port.
+ */
+UBYTE ADS1256_SetSpiSpeed(UDOUBLE speed_hz)
+{
+    return ADS1256_Dev_SetSpiSpeed(&default_dev, speed_hz);
+}
+
+/**
+ * @brief Returns the SCLK frequency of the default device.
+ * @return Clock in Hz.
+ */
+UDOUBLE ADS1256_GetSpiSpeed(void)
+{
+    return ADS1256_Dev_GetSpiSpeed(&default_dev);
+}
+
+/**
+ * @brief Probes the fastest error-free SPI clock of the default device.
+ * @param cfg Configuration, or NULL for the defaults.
+ * @param result Outcome, or NULL.
+ * @return ADS1256_OK when at least one clock passed, ADS1256_ERROR otherwise
+ *         (or if the registers could not be restored).
+ */
+UBYTE ADS1256_ProbeSpiSpeed(const ADS1256_SpeedProbe *cfg, ADS1256_SpeedProbeResult *result)
+{
+    return ADS1256_Dev_ProbeSpiSpeed(&default_dev, cfg, result);
+}
+
+/**
+ * @brief Calibrates the default device.
+ * @param cal_cmd Calibration command.
+ * @param coeffs Receives the resulting coefficients, or NULL.
+ * @return ADS1256_OK, ADS1256_TIMEOUT or ADS1256_ERROR.
+ */
+UBYTE ADS1256_Calibrate(ADS1256_CMD cal_cmd, ADS1256_CalCoeffs *coeffs)
+{
+    return ADS1256_Dev_Calibrate(&default_dev, cal_cmd, coeffs);
+}
+
+/**
+ * @brief Returns the calibration coefficients of the default device.
+ * @param coeffs Receives the coefficients.
+ */
+void ADS1256_GetCalibration(ADS1256_CalCoeffs *coeffs)
+{
+    ADS1256_Dev_GetCalibration(&default_dev, coeffs);
+}
+
+/**
+ * @brief Writes calibration coefficients to the default device.
+ * @param coeffs Coefficients to write.
+ * @return ADS1256_OK on success, ADS1256_ERROR on failure.
+ */
+UBYTE ADS1256_SetCalibration(const ADS1256_CalCoeffs *coeffs)
+{
+    return ADS1256_Dev_SetCalibration(&default_dev, coeffs);
+}
+
+/**
+ * @brief Attaches a calibration table to the default device.
+ * @param table Table, or NULL to detach.
+ */
+void ADS1256_SetCalTable(const ADS1256_CalTable *table)
+{
+    ADS1256_Dev_SetCalTable(&default_dev, table);
+}
+
+/**
+ * @brief Starts continuous conversion on the default device.
+ * @param Channel Channel or differential pair index.
+ * @return ADS1256_OK on success, ADS1256_ERROR or ADS1256_TIMEOUT on failure.
+ */
+UBYTE ADS1256_StartContinuous(UBYTE Channel)
+{
+    return ADS1256_Dev_StartContinuous(&default_dev, Channel);
+}
+
+/**
+ * @brief Reads samples in continuous mode from the default device.
+ * @param buf Receives the samples.
+ * @param n Number of samples.
+ * @return ADS1256_OK when all samples were read, otherwise the DRDY wait error
+ *         (samples read before the error are stored and counted).
+ */
+UBYTE ADS1256_ReadContinuous(UDOUBLE *buf, UDOUBLE n)
+{
+    return ADS1256_Dev_ReadContinuous(&default_dev, buf, n);
+}
+
+/**
+ * @brief Reads timestamped frames from the default device in continuous mode.
+ * @param frames Output array of at least `n` frames.
+ * @param n Number of samples.
+ * @return ADS1256_OK when all samples were read, otherwise the DRDY wait error
+ *         (frames read before the error are stored).
+ */
+UBYTE ADS1256_ReadContinuousFrames(ads1256_frame_t *frames, UDOUBLE n)
+{
+    return ADS1256_Dev_ReadContinuousFrames(&default_dev, frames, n);
+}
+
+/**
+ * @brief Stops continuous conversion on the default device.
+ * @return ADS1256_OK on success, ADS1256_ERROR if continuous mode was not active or SDATAC could not be sent.
+ */
+UBYTE ADS1256_StopContinuous(void)
+{
+    return ADS1256_Dev_StopContinuous(&default_dev);
+}
+
+/**
+ * @brief Resets the performance metrics of the default device.
+ * @param drate_enum_val The configured data rate.
+ */
+void ADS1256_InitPerformanceMonitoring(ADS1256_DRATE drate_enum_val)
+{
+    ADS1256_Dev_InitPerformanceMonitoring(&default_dev, drate_enum_val);
+}
+
+/**
+ * @brief Returns the performance metrics of the default device.
+ * @return Pointer to the device's metrics.
+ */
+performance_metrics_t* ADS1256_GetPerformanceMetrics(void)
+{
+    return ADS1256_Dev_GetPerformanceMetrics(&default_dev);
+}
+
+/**
+ * @brief Prints the performance report of the default device.
+ */
+void ADS1256_PrintPerformanceReport(void)
+{
+    ADS1256_Dev_PrintPerformanceReport(&default_dev);
+}
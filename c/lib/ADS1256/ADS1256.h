@@ -11,6 +11,7 @@
 #define _ADS1256_H_
 
 #include "../../common/DEV_Config.h" 
+#include "../../common/LatencyHist.h"
 #include <sys/time.h>              
 
 #define ADS1256_ID (0x03) ///< Expected Chip ID for ADS1256
@@ -25,6 +26,16 @@
 /** @brief Default negative reference voltage (e.g., connected to AGND) */
 #define ADC_VREF_NEG_GND 0.0f
 
+/**
+ * @brief Status codes returned by ADS1256 driver operations.
+ */
+typedef enum {
+    ADS1256_OK      = 0, ///< Operation completed successfully
+    ADS1256_ERROR   = 1, ///< Generic failure (invalid argument, SPI or GPIO error)
+    ADS1256_TIMEOUT = 2, ///< DRDY did not assert within the timeout, or the deadline passed
+    ADS1256_BUSY    = 3, ///< Operation still running, call ADS1256_Poll() again
+} ADS1256_STATUS;
+
 /**
  * @brief Enumeration for ADC scan modes.
  */
@@ -106,6 +117,9 @@ typedef enum {
     // Values 0x9 to 0xF are reserved or have special meanings (e.g., test voltages)
 } ADS1256_MUX_CHANNEL;
 
+/** @brief Builds a MUX register value from a positive and negative input (ADS1256_MUX_CHANNEL). */
+#define ADS1256_MUX(psel, nsel) ((UBYTE)((((psel) & 0x0F) << 4) | ((nsel) & 0x0F)))
+
 /**
  * @brief Enumeration for ADS1256 commands.
  */
@@ -150,19 +164,232 @@ static const uint8_t ADS1256_DRATE_E[ADS1256_DRATE_MAX] =
     0x03  ///< 2.5SPS
 };
 
+/** @brief Maximum number of entries in an ADS1256_ScanList. */
+#define ADS1256_SCAN_MAX_ENTRIES 16
+
 /**
  * @brief Structure to hold performance metrics for ADC operations.
+ *
+ * Timestamps are CLOCK_MONOTONIC_RAW. The latency histograms are reset by
+ * ADS1256_InitPerformanceMonitoring() and can be read with the
+ * LatencyHist_*() functions while acquisition is running.
+ *
+ * The acquisition path only bumps the counters, with relaxed atomic adds, so
+ * other threads (see ADS1256_metrics.h) can sample them at any time. The
+ * derived rates are computed by ADS1256_GetPerformanceMetrics() and are only
+ * current right after that call.
  */
 typedef struct {
     double theoretical_sps_per_channel; ///< Theoretical max SPS for one channel at current DRATE.
     double actual_avg_sps_per_channel;  ///< Actual measured average SPS per channel when scanning N channels.
     double actual_avg_sps_total;        ///< Actual total measured SPS (sum of all samples from all scanned channels / time).
     double efficiency_percent;          ///< Efficiency: (actual_avg_sps_per_channel / theoretical_sps_per_channel) * 100.
-    unsigned long total_samples_acquired; ///< Total individual samples acquired since monitoring started.
-    unsigned long total_n_channel_scans;  ///< Total number of N-channel scan operations performed.
-    struct timeval start_time;          ///< Timestamp when performance monitoring started.
+    _Atomic unsigned long total_samples_acquired; ///< Total individual samples acquired since monitoring started.
+    _Atomic unsigned long total_n_channel_scans; ///< Total number of N-channel scan operations performed.
+    struct timespec start_time;         ///< Timestamp when performance monitoring started.
+    _Atomic unsigned long continuous_samples_acquired; ///< Samples read in RDATAC mode since ADS1256_StartContinuous().
+    double continuous_sps;              ///< Measured RDATAC sample rate since ADS1256_StartContinuous().
+    double continuous_efficiency_percent; ///< Efficiency: (continuous_sps / theoretical_sps_per_channel) * 100.
+    struct timespec continuous_start_time; ///< Timestamp of the last ADS1256_StartContinuous().
+    _Atomic unsigned long drdy_timeouts; ///< DRDY waits that ran into the timeout.
+    _Atomic unsigned long deadline_misses; ///< Operations cut short by the deadline set with ADS1256_SetDeadline().
+    _Atomic unsigned long spi_errors;   ///< SPI transfers that failed.
+    _Atomic unsigned long gpio_errors;  ///< DRDY or reset line accesses that failed.
+    _Atomic unsigned long resets;       ///< Chip resets started (by init or ADS1256_ResetStart()).
+    _Atomic unsigned long warm_starts;  ///< ADS1256_WarmInit() calls that took over a running chip without a reset.
+    latency_hist_t drdy_wait;           ///< Time spent waiting for DRDY, per wait.
+    latency_hist_t spi_transaction;     ///< Duration of each SPI transaction, CS assert to deassert.
+    latency_hist_t conversion[ADS1256_SCAN_MAX_ENTRIES]; ///< Per scan position: channel select sent to result ready.
+    latency_hist_t scan_period;         ///< Time between consecutive completed scans (or RDATAC samples).
 } performance_metrics_t;
 
+/**
+ * @brief One input of a scan list.
+ */
+typedef struct {
+    UBYTE mux;              ///< MUX register value (PSEL << 4 | NSEL), see ADS1256_MUX()
+    ADS1256_GAIN gain;      ///< PGA gain for this input
+    ADS1256_DRATE drate;    ///< Data rate for this input
+    UBYTE settling_cycles;  ///< DRDY cycles to wait before the result is taken (>= 1)
+    UBYTE channel;          ///< Caller's channel number, for labelling results
+} ADS1256_ScanEntry;
+
+/**
+ * @brief Precompiled scan sequence executed by ADS1256_Scan().
+ */
+typedef struct {
+    ADS1256_ScanEntry entries[ADS1256_SCAN_MAX_ENTRIES]; ///< Inputs in scan order
+    UBYTE num_entries;      ///< Number of valid entries
+    UBYTE primed;           ///< Non-zero when entry 0 is already converting (set by the previous scan)
+} ADS1256_ScanList;
+
+/** @brief ADS1256_TuneConfig::step_mux value: step from the entry that precedes each entry in the scan. */
+#define ADS1256_TUNE_STEP_PREVIOUS 0xFF
+
+/**
+ * @brief Settings of the settling auto-tuner. Fill with ADS1256_TuneConfig_Init().
+ */
+typedef struct {
+    UDOUBLE tolerance_lsb;   ///< Largest allowed |mean reading - settled value|, in codes
+    UBYTE max_cycles;        ///< Largest settling count tried (<= 255)
+    UBYTE reference_cycles;  ///< DRDY cycles before the settled value is sampled
+    UBYTE repeats;           ///< Steps per candidate count, averaged (also the number of settled readings)
+    UBYTE step_mux;          ///< MUX value to step from, or ADS1256_TUNE_STEP_PREVIOUS
+} ADS1256_TuneConfig;
+
+/**
+ * @brief Auto-tuner result for one scan entry.
+ */
+typedef struct {
+    UBYTE settling_cycles;  ///< Count stored in the entry
+    UBYTE converged;        ///< Zero if even max_cycles missed the tolerance (max_cycles is stored)
+    int32_t settled;        ///< Settled value (mean of the reference readings), codes
+    double noise_lsb;       ///< Standard deviation of the reference readings, codes
+    double error_lsb;       ///< |mean reading - settled value| at the stored count, codes
+} ADS1256_TuneResult;
+
+/** @name SPI clock limits */
+#define ADS1256_CLKIN_HZ    7680000                ///< Crystal on the board
+#define ADS1256_SCLK_MAX_HZ (ADS1256_CLKIN_HZ / 4) ///< Datasheet limit: tSCLK >= 4 tCLKIN
+
+/** @brief ADS1256_SpeedProbe::known_mux value: no known-input check. */
+#define ADS1256_PROBE_NO_INPUT 0xFF
+
+/**
+ * @brief Settings of the SPI clock probe. Fill with ADS1256_SpeedProbe_Init().
+ */
+typedef struct {
+    UDOUBLE min_hz;         ///< First clock tried (should be known to work)
+    UDOUBLE max_hz;         ///< Highest clock tried
+    float step;             ///< Factor between successive clocks (> 1)
+    UWORD iterations;       ///< Register write/readback rounds per clock
+    UBYTE known_mux;        ///< MUX of an input held steady during the probe, or ADS1256_PROBE_NO_INPUT
+    UBYTE known_reads;      ///< Conversions of that input per clock
+    UDOUBLE tolerance_lsb;  ///< Largest allowed |reading - reference| for that input, in codes
+} ADS1256_SpeedProbe;
+
+/**
+ * @brief Outcome of ADS1256_ProbeSpiSpeed().
+ */
+typedef struct {
+    UDOUBLE best_hz;             ///< Fastest clock that passed (now used by the device)
+    UDOUBLE failed_hz;           ///< First clock that failed, or 0 if every clock passed
+    UBYTE steps_passed;          ///< Number of clocks that passed
+    unsigned long reg_errors;    ///< Register readback mismatches at failed_hz
+    unsigned long input_errors;  ///< Known-input conversions out of tolerance (or missing) at failed_hz
+} ADS1256_SpeedProbeResult;
+
+/**
+ * @brief One conversion result with the time it became available.
+ *
+ * The timestamp is the DRDY falling edge that completed this conversion:
+ * the kernel edge time in DRDY event mode, or the CLOCK_MONOTONIC time the
+ * low level was first read in poll mode. Use DEV_ClockCorr_Convert() to map
+ * it to CLOCK_REALTIME or a PTP clock.
+ */
+typedef struct {
+    uint64_t timestamp_ns; ///< CLOCK_MONOTONIC time of the DRDY that completed this conversion
+    uint64_t sequence;     ///< Per-device frame counter; a gap means frames were lost downstream
+    UDOUBLE value;         ///< Raw 24-bit code, sign-extended
+    UBYTE channel;         ///< Channel label from the scan entry (AINx, or pair index in differential mode)
+} ads1256_frame_t;
+
+/**
+ * @brief Calibration coefficients as held in OFC0..OFC2 and FSC0..FSC2 (byte 0 first).
+ */
+typedef struct {
+    UBYTE ofc[3]; ///< Offset calibration coefficient, OFC0..OFC2
+    UBYTE fsc[3]; ///< Full-scale calibration coefficient, FSC0..FSC2
+} ADS1256_CalCoeffs;
+
+/**
+ * @brief Saved coefficients for every gain/DRATE combination of one board.
+ *
+ * Attach with ADS1256_SetCalTable(); the driver then loads the matching
+ * coefficients whenever the gain or data rate changes. See ADS1256_calib.h
+ * for calibrating, saving and loading tables.
+ */
+typedef struct {
+    UDOUBLE board_id;                       ///< Caller-chosen board identifier stored with the table
+    UWORD valid[ADS1256_GAIN_64 + 1];       ///< Bit d of valid[g] set when coeffs[g][d] is filled
+    ADS1256_CalCoeffs coeffs[ADS1256_GAIN_64 + 1][ADS1256_DRATE_MAX]; ///< Indexed by gain, then DRATE
+} ADS1256_CalTable;
+
+/** @brief Number of registers mirrored in the register shadow (STATUS..FSC2). */
+#define ADS1256_NUM_REGS 11
+
+/**
+ * @brief Multi-step operation driven by ADS1256_Poll().
+ */
+typedef enum {
+    ADS1256_OP_NONE = 0,  ///< Nothing running
+    ADS1256_OP_RESET,     ///< Started by ADS1256_ResetStart()
+    ADS1256_OP_CALIBRATE, ///< Started by ADS1256_CalibrateStart()
+} ADS1256_OP;
+
+/**
+ * @brief State of one ADS1256: the port it is wired to, register shadow,
+ *        calibration table and performance metrics.
+ *
+ * Zero-initialize before the first ADS1256_Dev_Init(). Each device may be
+ * driven from its own thread; a device itself is not locked, so it must not
+ * be used by two threads at once. The fields are private to the driver.
+ */
+typedef struct {
+    DEV_Port *port;                     ///< Bus, chip select, reset and DRDY lines
+    ADS1256_SCAN_MODE scan_mode;        ///< Channel numbering used by the channel-based API
+    performance_metrics_t metrics;      ///< Counters and latency histograms
+    UDOUBLE drdy_timeout_us;            ///< Current DRDY timeout, derived from the data rate
+    uint64_t conv_period_ns;            ///< Conversion period at the current data rate (0 until configured)
+    struct timespec last_drdy_time;     ///< Timestamp of the last DRDY edge
+    UBYTE continuous_active;            ///< Non-zero while in RDATAC mode
+    UBYTE reg_shadow[ADS1256_NUM_REGS]; ///< Last known value of STATUS..FSC2
+    UWORD reg_valid;                    ///< Bit n set when reg_shadow[n] matches the chip
+    const ADS1256_CalTable *cal_table;  ///< Attached calibration table, or NULL
+    uint64_t spi_done_ns;               ///< End of the last SPI transaction
+    uint64_t drdy_seen_ns;              ///< Time the last DRDY wait returned
+    uint64_t conv_start_ns;             ///< Time the current conversion was started
+    uint64_t last_scan_ns;              ///< Completion time of the previous scan
+    uint64_t frame_seq;                 ///< Sequence number of the next ads1256_frame_t
+    UBYTE continuous_channel;           ///< Channel passed to ADS1256_Dev_StartContinuous()
+    uint64_t deadline_ns;               ///< Deadline of blocking calls (DEV_Now_ns() clock), 0 for none
+    ADS1256_OP op;                      ///< Operation driven by ADS1256_Dev_Poll()
+    UBYTE op_step;                      ///< Step of `op`
+    UBYTE op_cmd;                       ///< Calibration command of `op`
+    ADS1256_GAIN op_gain;               ///< Gain configured at the end of a reset
+    ADS1256_DRATE op_drate;             ///< Data rate configured at the end of a reset
+    UDOUBLE op_timeout_us;              ///< DRDY timeout of the calibration step
+    uint64_t op_ready_ns;               ///< DRDY is not looked at before this time
+    uint64_t op_deadline_ns;            ///< DRDY must go low by this time
+} ads1256_dev_t;
+
+/** @brief Table of compiled scan kernels (see ADS1256_kernels.def); override to build your own. */
+#ifndef ADS1256_KERNELS_DEF
+#define ADS1256_KERNELS_DEF "ADS1256_kernels.def"
+#endif
+
+/** @brief Entries of each compiled kernel, as ADS1256_KERNEL_LEN_<name>. */
+#define ADS1256_KERNEL_ENTRY(mux, settling_cycles) + 1
+#define ADS1256_KERNEL(name, gain, drate, entries) ADS1256_KERNEL_LEN_##name = 0 entries,
+enum {
+#include ADS1256_KERNELS_DEF
+};
+#undef ADS1256_KERNEL
+#undef ADS1256_KERNEL_ENTRY
+
+/**
+ * @brief Description of one compiled scan kernel, for picking a kernel at run time.
+ */
+typedef struct {
+    const char *name;              ///< Name from ADS1256_kernels.def
+    ADS1256_GAIN gain;             ///< Gain shared by all entries
+    ADS1256_DRATE drate;           ///< Data rate shared by all entries
+    UBYTE num_entries;             ///< Results per scan
+    const UBYTE *mux;              ///< MUX value of each entry
+    const UBYTE *settling_cycles;  ///< DRDY cycles of each entry (>= 1)
+    UBYTE (*scan)(ads1256_dev_t *dev, UDOUBLE *out); ///< ADS1256_Dev_Kernel_<name>()
+} ADS1256_Kernel;
+
 /*--------------------------------------------------------------------------
                             Function Prototypes
 ---------------------------------------------------------------------------*/
@@ -175,26 +402,108 @@ typedef struct {
  */
 UBYTE ADS1256_init(ADS1256_DRATE drate, ADS1256_GAIN gain, ADS1256_SCAN_MODE scan_mode);
 
+/**
+ * @brief Initializes the module without a reset if the chip is already running.
+ *
+ * For processes restarted while the board stays powered. Sends SDATAC (a
+ * previous owner may have left RDATAC active), reads STATUS..FSC2 back in one
+ * RREG and checks the chip ID. Registers that differ from the requested
+ * configuration or the attached calibration table are rewritten together
+ * with SYNC/WAKEUP, so OFC/FSC from an earlier calibration survive. Returns
+ * once the first conversion at the new rate signals DRDY. Falls back to
+ * ADS1256_init() if the chip does not answer or convert.
+ * @param drate The desired data rate.
+ * @param gain The desired PGA gain.
+ * @param scan_mode The desired scan mode.
+ * @return 0 on success, 1 on failure.
+ */
+UBYTE ADS1256_WarmInit(ADS1256_DRATE drate, ADS1256_GAIN gain, ADS1256_SCAN_MODE scan_mode);
+
+/**
+ * @brief Starts a reset without blocking; ADS1256_Poll() completes it.
+ *
+ * RESET is pulsed low for about a microsecond (or the RESET command is sent
+ * if the port has no reset line). Each poll then checks DRDY once: when the
+ * chip signals it is back, the register shadow is reloaded, the chip ID
+ * checked and the gain and data rate programmed. Aborts a running
+ * calibration and leaves RDATAC, so it also recovers a wedged chip.
+ * ADS1256_init() is this call polled to completion.
+ * @param drate Data rate to configure once the chip is back.
+ * @param gain PGA gain to configure once the chip is back.
+ * @return ADS1256_BUSY when started, ADS1256_ERROR on an invalid argument or a GPIO/SPI error.
+ */
+UBYTE ADS1256_ResetStart(ADS1256_DRATE drate, ADS1256_GAIN gain);
+
+/**
+ * @brief Advances a reset or calibration started with ADS1256_ResetStart() or
+ *        ADS1256_CalibrateStart(). Never blocks on DRDY.
+ *
+ * Other commands are rejected with ADS1256_ERROR until the operation ends.
+ * The deadline set with ADS1256_SetDeadline() also ends it.
+ * @return ADS1256_BUSY while the operation runs, then its result once
+ *         (ADS1256_OK, ADS1256_TIMEOUT or ADS1256_ERROR); ADS1256_OK if nothing runs.
+ */
+UBYTE ADS1256_Poll(void);
+
+/**
+ * @brief Sets the time by which blocking calls must return.
+ *
+ * Every DRDY wait is shortened to end at the deadline; one that would end
+ * later, or starts after it, returns ADS1256_TIMEOUT and is counted in
+ * performance_metrics_t::deadline_misses. The deadline stays until changed.
+ * @param deadline_ns Deadline on the DEV_Now_ns() clock, or 0 for none.
+ */
+void ADS1256_SetDeadline(uint64_t deadline_ns);
+
 /**
  * @brief Configures the ADC gain and data rate.
  * @param gain The desired gain (ADS1256_GAIN enum).
  * @param drate The desired data rate (ADS1256_DRATE enum).
+ * @return ADS1256_OK on success, ADS1256_TIMEOUT if DRDY never asserted.
+ */
+UBYTE ADS1256_ConfigADC(ADS1256_GAIN gain, ADS1256_DRATE drate);
+
+/**
+ * @brief Changes the PGA gain in place (one WREG + SYNC/WAKEUP, no reset).
+ *
+ * Nothing is sent if the gain is already programmed.
+ * @param gain The new gain (ADS1256_GAIN enum).
+ * @return ADS1256_OK on success, ADS1256_ERROR on failure.
+ */
+UBYTE ADS1256_SetGain(ADS1256_GAIN gain);
+
+/**
+ * @brief Changes the data rate in place (one WREG + SYNC/WAKEUP, no reset).
+ *
+ * Nothing is sent if the rate is already programmed.
+ * @param drate The new data rate (ADS1256_DRATE enum).
+ * @return ADS1256_OK on success, ADS1256_ERROR on failure.
  */
-void ADS1256_ConfigADC(ADS1256_GAIN gain, ADS1256_DRATE drate);
+UBYTE ADS1256_SetDataRate(ADS1256_DRATE drate);
 
 /**
  * @brief Reads the ADC value for a single specified channel.
  * @param Channel The channel number (0-7 for single-ended, 0-3 for differential pair index).
- * @return Raw 24-bit ADC value, sign-extended.
+ * @return Raw 24-bit ADC value, sign-extended (0 on failure, see ADS1256_ReadChannel()).
  */
 UDOUBLE ADS1256_GetChannelValue(UBYTE Channel);
 
+/**
+ * @brief Reads the ADC value for a single channel and reports why it failed.
+ * @param Channel The channel number (0-7 for single-ended, 0-3 for differential pair index).
+ * @param value Output for the raw 24-bit ADC value, sign-extended (untouched on failure).
+ * @return ADS1256_OK, ADS1256_TIMEOUT if no result arrived in time,
+ *         ADS1256_ERROR on an invalid channel, SPI/GPIO error or busy device.
+ */
+UBYTE ADS1256_ReadChannel(UBYTE Channel, UDOUBLE *value);
+
 /**
  * @brief Reads all relevant channels based on ScanMode and populates the provided array.
  * @param ADC_Value Pointer to an array to store ADC values.
  *                  Size should be NUM_SINGLE_ENDED_CHANNELS or NUM_DIFFERENTIAL_PAIRS.
+ * @return ADS1256_OK, or the first error (that channel and the ones after it are set to 0).
  */
-void ADS1256_GetAllChannels(UDOUBLE *ADC_Value);
+UBYTE ADS1256_GetAllChannels(UDOUBLE *ADC_Value);
 
 /**
  * @brief Reads the 4-bit chip ID from the ADS1256.
@@ -202,6 +511,27 @@ void ADS1256_GetAllChannels(UDOUBLE *ADC_Value);
  */
 UBYTE ADS1256_ReadChipID(void);
 
+/**
+ * @brief Reads a configuration register (STATUS..FSC2).
+ *
+ * The driver mirrors every register it writes or reads, so by default the
+ * value comes from that shadow without any SPI traffic. Pass `force` to read
+ * the chip, e.g. for the DRDY bit in STATUS or after an external calibration.
+ * @param Reg The register address (from ADS1256_REG enum).
+ * @param force Non-zero to bypass the shadow.
+ * @return The register value (0 for an invalid address).
+ */
+UBYTE ADS1256_ReadReg(UBYTE Reg, UBYTE force);
+
+/**
+ * @brief Returns the time at which DRDY was last seen low.
+ *
+ * With DEV_DRDY_MODE_EVENT this is the kernel's falling-edge timestamp,
+ * i.e. the moment the conversion that was just read completed.
+ * @param ts Output for the CLOCK_MONOTONIC timestamp.
+ */
+void ADS1256_GetLastDRDYTime(struct timespec *ts);
+
 // === Optimized N-Channel Read Functions ===
 /**
  * @brief Acquires data from a specified list of N single-ended channels with proper settling.
@@ -209,16 +539,292 @@ UBYTE ADS1256_ReadChipID(void);
  * @param channels Array of channel numbers (0-7) to read.
  * @param num_channels_to_read Number of channels in the `channels` array.
  * @param settling_cycles Number of DRDY cycles to wait for settling after each channel switch.
+ * @return ADS1256_OK on success, or ADS1256_TIMEOUT/ADS1256_ERROR if a conversion was missed.
  */
-void ADS1256_GetNChannels_Optimized(UDOUBLE *ADC_Value, UBYTE *channels, UBYTE num_channels_to_read, UBYTE settling_cycles);
+UBYTE ADS1256_GetNChannels_Optimized(UDOUBLE *ADC_Value, UBYTE *channels, UBYTE num_channels_to_read, UBYTE settling_cycles);
 
 /**
  * @brief Acquires data from a list of N single-ended channels with minimal overhead.
  * @param ADC_Value Pointer to an array to store results.
  * @param channels Array of channel numbers (0-7) to read.
  * @param num_channels_to_read Number of channels in the `channels` array.
+ * @return ADS1256_OK on success, or ADS1256_TIMEOUT/ADS1256_ERROR if a conversion was missed.
+ */
+UBYTE ADS1256_GetNChannels_Fast(UDOUBLE *ADC_Value, UBYTE *channels, UBYTE num_channels_to_read);
+
+// === Scan Lists (Pipelined Sequencer) ===
+/**
+ * @brief Clears a scan list.
+ * @param list Scan list to initialize.
+ */
+void ADS1256_ScanList_Init(ADS1256_ScanList *list);
+
+/**
+ * @brief Appends an entry with an arbitrary MUX code to a scan list.
+ * @param list Scan list.
+ * @param mux MUX register value, e.g. ADS1256_MUX(ADS1256_MUX_AIN2, ADS1256_MUX_AIN5).
+ * @param gain PGA gain for this entry.
+ * @param drate Data rate for this entry.
+ * @param settling_cycles DRDY cycles before the result is taken (0 is treated as 1).
+ * @return ADS1256_OK on success, ADS1256_ERROR if the list is full or the gain/rate is invalid.
+ */
+UBYTE ADS1256_ScanList_Add(ADS1256_ScanList *list, UBYTE mux, ADS1256_GAIN gain, ADS1256_DRATE drate,
+                           UBYTE settling_cycles);
+
+/**
+ * @brief Builds a scan list from channel numbers, using the scan mode set by ADS1256_init().
+ * @param list Scan list to (re)build.
+ * @param channels Channel numbers (0-7 single-ended) or differential pair indices (0-3).
+ * @param num_channels Number of channels.
+ * @param gain PGA gain for every entry.
+ * @param drate Data rate for every entry.
+ * @param settling_cycles DRDY cycles per entry (0 is treated as 1).
+ * @return ADS1256_OK on success, ADS1256_ERROR on an invalid channel.
+ */
+UBYTE ADS1256_ScanList_Build(ADS1256_ScanList *list, const UBYTE *channels, UBYTE num_channels,
+                             ADS1256_GAIN gain, ADS1256_DRATE drate, UBYTE settling_cycles);
+
+/**
+ * @brief Forces the next ADS1256_Scan() to restart the pipeline (use after idling).
+ * @param list Scan list.
+ */
+void ADS1256_ScanList_Reset(ADS1256_ScanList *list);
+
+/**
+ * @brief Fills an auto-tuner configuration with defaults: 32 LSB tolerance,
+ *        up to 16 cycles, 32 reference cycles, 8 repeats, step from the previous entry.
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_TuneConfig_Init(ADS1256_TuneConfig *cfg);
+
+/**
+ * @brief Measures the settling each scan entry needs and stores it in the list.
+ *
+ * With a steady input on every channel, each entry is first sampled after
+ * `reference_cycles` to get its settled value. Then, for 1, 2, ... max_cycles
+ * DRDY cycles, the input is stepped from the step source (the preceding
+ * entry, as in the running scan, or `step_mux`) to the entry `repeats`
+ * times and read after that many cycles, exactly as ADS1256_Scan() does.
+ * The first count whose mean reading is within `tolerance_lsb` of the
+ * settled value (plus three standard errors of the measured noise) is
+ * stored in the entry's settling_cycles.
+ *
+ * Runs for roughly repeats * max_cycles^2 conversions per slow entry; the
+ * pipeline is reset afterwards.
+ * @param list Scan list to tune.
+ * @param cfg Configuration, or NULL for the defaults.
+ * @param results One result per entry, or NULL.
+ * @return ADS1256_OK on success (also if an entry did not converge), or the DRDY wait error.
+ */
+UBYTE ADS1256_ScanList_AutoTune(ADS1256_ScanList *list, const ADS1256_TuneConfig *cfg, ADS1256_TuneResult *results);
+
+/**
+ * @brief Executes one pipelined scan: the next entry's MUX is written right after
+ *        DRDY and before RDATA, so it settles while the current result is read.
+ * @param list Scan list.
+ * @param out Output array with one raw, sign-extended value per entry.
+ * @return ADS1256_OK on success, or ADS1256_TIMEOUT/ADS1256_ERROR.
+ */
+UBYTE ADS1256_Scan(ADS1256_ScanList *list, UDOUBLE *out);
+
+/**
+ * @brief Executes one pipelined scan and returns timestamped frames.
+ *
+ * Same SPI traffic as ADS1256_Scan(); each frame carries the DRDY time of
+ * its own conversion rather than the end of the scan.
+ * @param list Scan list.
+ * @param frames Output array with one frame per entry.
+ * @return ADS1256_OK on success, or ADS1256_TIMEOUT/ADS1256_ERROR.
+ */
+UBYTE ADS1256_ScanFrames(ADS1256_ScanList *list, ads1256_frame_t *frames);
+
+/**
+ * @brief First half of one step of ADS1256_ScanFrames(): waits until entry `i` has converted.
+ *
+ * ADS1256_ScanFrames() is ADS1256_ScanWaitEntry() and ADS1256_ScanReadEntry()
+ * for i = 0..num_entries-1. Calling the halves directly lets a sequencer act
+ * between DRDY and the switch to the next entry, e.g. to release the SYNC of
+ * several boards at the same instant (ADS1256_multi.h). A list that is not
+ * primed is primed here, which requires i = 0.
+ * @param list Scan list.
+ * @param i Entry index, counting up from 0 within a pass.
+ * @return ADS1256_OK on success, or ADS1256_TIMEOUT/ADS1256_ERROR (the pipeline is reset).
+ */
+UBYTE ADS1256_ScanWaitEntry(ADS1256_ScanList *list, UBYTE i);
+
+/**
+ * @brief Second half of one scan step: selects the next entry (SYNC/WAKEUP starts
+ *        its conversion) and reads the result of entry `i` in the same SPI message.
+ * @param list Scan list.
+ * @param i Entry passed to the preceding ADS1256_ScanWaitEntry().
+ * @param frame Output for the result, stamped with the DRDY of its conversion.
+ * @return ADS1256_OK on success, ADS1256_ERROR on an SPI error (the pipeline is reset).
+ */
+UBYTE ADS1256_ScanReadEntry(ADS1256_ScanList *list, UBYTE i, ads1256_frame_t *frame);
+
+// === Compiled Scan Kernels ===
+/*
+ * UBYTE ADS1256_Kernel_<name>(UDOUBLE *out), one per line of ADS1256_kernels.def.
+ *
+ * Executes one pipelined scan of the kernel's fixed entries, with the same
+ * SPI traffic and results as ADS1256_Scan() over an equivalent scan list.
+ * The first call (or any call after other code changed the MUX, gain or
+ * data rate) selects entry 0 and starts the pipeline; later calls only wait
+ * for DRDY and send the precomputed frames. `out` receives
+ * ADS1256_KERNEL_LEN_<name> raw, sign-extended values. Returns ADS1256_OK,
+ * or ADS1256_TIMEOUT/ADS1256_ERROR (the pipeline restarts on the next call).
+ */
+#define ADS1256_KERNEL_ENTRY(mux, settling_cycles)
+#define ADS1256_KERNEL(name, gain, drate, entries) UBYTE ADS1256_Kernel_##name(UDOUBLE *out);
+#include ADS1256_KERNELS_DEF
+#undef ADS1256_KERNEL
+#undef ADS1256_KERNEL_ENTRY
+
+/**
+ * @brief Looks up a compiled kernel by name.
+ * @param name Name from ADS1256_kernels.def, e.g. "SE8_30K".
+ * @return The kernel, or NULL if none has that name.
+ */
+const ADS1256_Kernel *ADS1256_FindKernel(const char *name);
+
+/**
+ * @brief Returns a compiled kernel by position, for listing them.
+ * @param index 0 for the first kernel of ADS1256_kernels.def.
+ * @return The kernel, or NULL past the last one.
+ */
+const ADS1256_Kernel *ADS1256_GetKernel(UBYTE index);
+
+/**
+ * @brief Runs one scan of a kernel picked at run time on the default device.
+ * @param kernel Kernel from ADS1256_FindKernel()/ADS1256_GetKernel().
+ * @param out Output array with kernel->num_entries raw, sign-extended values.
+ * @return ADS1256_OK on success, or ADS1256_TIMEOUT/ADS1256_ERROR.
+ */
+UBYTE ADS1256_RunKernel(const ADS1256_Kernel *kernel, UDOUBLE *out);
+
+// === Calibration ===
+/**
+ * @brief Runs a calibration command at the current gain/DRATE and reads back the result.
+ *
+ * For CMD_SYSOCAL/CMD_SYSGCAL the system zero or full-scale input must be
+ * applied to the selected input beforehand.
+ * @param cal_cmd CMD_SELFCAL, CMD_SELFOCAL, CMD_SELFGCAL, CMD_SYSOCAL or CMD_SYSGCAL.
+ * @param coeffs Output for the new coefficients (may be NULL).
+ * @return ADS1256_OK on success, ADS1256_TIMEOUT if calibration did not finish, ADS1256_ERROR otherwise.
+ */
+UBYTE ADS1256_Calibrate(ADS1256_CMD cal_cmd, ADS1256_CalCoeffs *coeffs);
+
+/**
+ * @brief Starts a calibration without blocking; ADS1256_Poll() completes it.
+ *
+ * The command goes out on the first poll that sees DRDY low, and OFC/FSC are
+ * read back on the first poll after DRDY returns. Read the result with
+ * ADS1256_GetCalibration(). ADS1256_Calibrate() is this call polled to completion.
+ * @param cal_cmd CMD_SELFCAL, CMD_SELFOCAL, CMD_SELFGCAL, CMD_SYSOCAL or CMD_SYSGCAL.
+ * @return ADS1256_BUSY while running (or the result if it finished at once),
+ *         ADS1256_ERROR on an invalid command or a busy device.
+ */
+UBYTE ADS1256_CalibrateStart(ADS1256_CMD cal_cmd);
+
+/**
+ * @brief Returns the coefficients currently in OFC0..FSC2 (from the register shadow).
+ * @param coeffs Output for the coefficients.
+ */
+void ADS1256_GetCalibration(ADS1256_CalCoeffs *coeffs);
+
+/**
+ * @brief Writes OFC0..FSC2 with one WREG burst (skipped if unchanged).
+ * @param coeffs Coefficients to load.
+ * @return ADS1256_OK on success, ADS1256_ERROR on failure.
+ */
+UBYTE ADS1256_SetCalibration(const ADS1256_CalCoeffs *coeffs);
+
+/**
+ * @brief Attaches saved coefficients that are loaded on every gain/DRATE change.
+ *
+ * Applies to ADS1256_ConfigADC()/ADS1256_init(), ADS1256_SetGain(),
+ * ADS1256_SetDataRate() and scan-list entries. Combinations without saved
+ * coefficients leave OFC/FSC as they are. The table is not copied.
+ * @param table Table to use, or NULL to detach.
+ */
+void ADS1256_SetCalTable(const ADS1256_CalTable *table);
+
+// === Continuous (RDATAC) Acquisition ===
+/**
+ * @brief Sets the SCLK frequency of the default device's messages.
+ * @param speed_hz Clock in Hz (at most ADS1256_SCLK_MAX_HZ per the datasheet).
+ * @return ADS1256_OK on success, ADS1256_ERROR on an invalid speed or a closed port.
+ */
+UBYTE ADS1256_SetSpiSpeed(UDOUBLE speed_hz);
+
+/**
+ * @brief Returns the SCLK frequency the default device's messages use.
+ * @return Clock in Hz.
+ */
+UDOUBLE ADS1256_GetSpiSpeed(void);
+
+/**
+ * @brief Fills a probe configuration with defaults: 1 MHz up to
+ *        ADS1256_SCLK_MAX_HZ in steps of 1.25x, 64 register rounds per
+ *        clock, no known-input check (8 reads and 256 codes when enabled).
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_SpeedProbe_Init(ADS1256_SpeedProbe *cfg);
+
+/**
+ * @brief Finds the fastest SPI clock the default device passes without errors and keeps it.
+ *
+ * Steps the clock from `min_hz` up to `max_hz`. At each clock, `iterations`
+ * rounds write a changing pattern to OFC0..OFC2 and read every register
+ * back in one burst (chip ID and all configuration registers must match).
+ * With `known_mux` set, that input is also converted `known_reads` times
+ * and compared with a reference taken at the starting clock. The first
+ * failing clock ends the probe. The registers (including OFC) are then
+ * restored at the fastest passing clock, which stays selected. If even
+ * `min_hz` fails, the original clock is kept.
+ *
+ * Raising `max_hz` above ADS1256_SCLK_MAX_HZ measures the margin of a
+ * board, but speeds beyond the datasheet are not guaranteed across
+ * temperature and parts.
+ * @param cfg Configuration, or NULL for the defaults.
+ * @param result Outcome, or NULL.
+ * @return ADS1256_OK when at least one clock passed, ADS1256_ERROR otherwise
+ *         (or if the registers could not be restored).
+ */
+UBYTE ADS1256_ProbeSpiSpeed(const ADS1256_SpeedProbe *cfg, ADS1256_SpeedProbeResult *result);
+
+/**
+ * @brief Starts Read Data Continuous mode on a single channel.
+ *
+ * The digital filter is restarted once; afterwards every DRDY delivers one
+ * result with no command overhead, so the channel runs at the full DRATE.
+ * While active, all other read and configuration functions are rejected.
+ * @param Channel Channel number (0-7 single-ended) or differential pair index (0-3).
+ * @return ADS1256_OK on success, ADS1256_ERROR or ADS1256_TIMEOUT on failure.
  */
-void ADS1256_GetNChannels_Fast(UDOUBLE *ADC_Value, UBYTE *channels, UBYTE num_channels_to_read);
+UBYTE ADS1256_StartContinuous(UBYTE Channel);
+
+/**
+ * @brief Reads `n` consecutive conversions in continuous mode.
+ * @param buf Output array of at least `n` raw, sign-extended results.
+ * @param n Number of samples to read.
+ * @return ADS1256_OK, or the DRDY wait error that stopped the read early.
+ */
+UBYTE ADS1256_ReadContinuous(UDOUBLE *buf, UDOUBLE n);
+
+/**
+ * @brief Reads `n` consecutive conversions in continuous mode as timestamped frames.
+ * @param frames Output array of at least `n` frames.
+ * @param n Number of samples to read.
+ * @return ADS1256_OK, or the DRDY wait error that stopped the read early.
+ */
+UBYTE ADS1256_ReadContinuousFrames(ads1256_frame_t *frames, UDOUBLE n);
+
+/**
+ * @brief Stops continuous mode (SDATAC).
+ * @return ADS1256_OK on success, ADS1256_ERROR if continuous mode was not active.
+ */
+UBYTE ADS1256_StopContinuous(void);
 
 // === Performance Monitoring Functions ===
 /**
@@ -228,7 +834,10 @@ void ADS1256_GetNChannels_Fast(UDOUBLE *ADC_Value, UBYTE *channels, UBYTE num_ch
 void ADS1256_InitPerformanceMonitoring(ADS1256_DRATE drate_enum_val);
 
 /**
- * @brief Retrieves a pointer to the current performance metrics data.
+ * @brief Computes the derived rates and returns the performance metrics.
+ *
+ * The rate and efficiency fields are refreshed by this call only, so call it
+ * again whenever they are displayed. Counters and histograms are always live.
  * @return Pointer to the `performance_metrics_t` structure.
  */
 performance_metrics_t* ADS1256_GetPerformanceMetrics(void);
@@ -249,4 +858,87 @@ void ADS1256_PrintPerformanceReport(void);
  */
 float ADS1256_RawToVoltage(UDOUBLE raw_value, float vref_positive, float vref_negative, ADS1256_GAIN gain_enum);
 
+/**
+ * @brief Converts a data rate enum to its nominal samples per second.
+ * @param drate The ADS1256_DRATE enum value.
+ * @return The nominal data rate in SPS (2.5 for unknown values).
+ */
+float ADS1256_DrateToSps(ADS1256_DRATE drate);
+
+/*--------------------------------------------------------------------------
+                          Multi-instance API
+  The functions above drive the board's ADC through a default device on
+  DEV_GetADCPort(). The ADS1256_Dev_*() variants below take the device
+  explicitly, so several chips (on one bus or on several) can be used at
+  once, e.g. one acquisition thread per device. Parameters and return values
+  match the single-instance function of the same name. A scan list must
+  only be used with the device it was built for.
+---------------------------------------------------------------------------*/
+/**
+ * @brief Returns the device behind the single-instance API.
+ * @return Default device context.
+ */
+ads1256_dev_t *ADS1256_GetDefaultDev(void);
+
+/**
+ * @brief Resets and configures an ADS1256 on a port.
+ *
+ * Metrics and an attached calibration table survive re-initialization.
+ * @param dev Device context, zero-initialized before the first call.
+ * @param port Port the chip is wired to (from DEV_Port_Open()).
+ * @param drate The desired data rate.
+ * @param gain The desired PGA gain.
+ * @param scan_mode The desired scan mode.
+ * @return 0 on success, 1 on failure.
+ */
+UBYTE ADS1256_Dev_Init(ads1256_dev_t *dev, DEV_Port *port, ADS1256_DRATE drate, ADS1256_GAIN gain,
+                       ADS1256_SCAN_MODE scan_mode);
+UBYTE ADS1256_Dev_WarmInit(ads1256_dev_t *dev, DEV_Port *port, ADS1256_DRATE drate, ADS1256_GAIN gain,
+                           ADS1256_SCAN_MODE scan_mode);
+UBYTE ADS1256_Dev_ResetStart(ads1256_dev_t *dev, ADS1256_DRATE drate, ADS1256_GAIN gain);
+UBYTE ADS1256_Dev_Poll(ads1256_dev_t *dev);
+void ADS1256_Dev_SetDeadline(ads1256_dev_t *dev, uint64_t deadline_ns);
+UBYTE ADS1256_Dev_ConfigADC(ads1256_dev_t *dev, ADS1256_GAIN gain, ADS1256_DRATE drate);
+UBYTE ADS1256_Dev_SetGain(ads1256_dev_t *dev, ADS1256_GAIN gain);
+UBYTE ADS1256_Dev_SetDataRate(ads1256_dev_t *dev, ADS1256_DRATE drate);
+UDOUBLE ADS1256_Dev_GetChannelValue(ads1256_dev_t *dev, UBYTE Channel);
+UBYTE ADS1256_Dev_ReadChannel(ads1256_dev_t *dev, UBYTE Channel, UDOUBLE *value);
+UBYTE ADS1256_Dev_GetAllChannels(ads1256_dev_t *dev, UDOUBLE *ADC_Value);
+UBYTE ADS1256_Dev_ReadChipID(ads1256_dev_t *dev);
+UBYTE ADS1256_Dev_ReadReg(ads1256_dev_t *dev, UBYTE Reg, UBYTE force);
+void ADS1256_Dev_GetLastDRDYTime(ads1256_dev_t *dev, struct timespec *ts);
+UBYTE ADS1256_Dev_GetNChannels_Optimized(ads1256_dev_t *dev, UDOUBLE *ADC_Value, UBYTE *channels,
+                                         UBYTE num_channels_to_read, UBYTE settling_cycles);
+UBYTE ADS1256_Dev_GetNChannels_Fast(ads1256_dev_t *dev, UDOUBLE *ADC_Value, UBYTE *channels,
+                                    UBYTE num_channels_to_read);
+UBYTE ADS1256_Dev_ScanList_Build(ads1256_dev_t *dev, ADS1256_ScanList *list, const UBYTE *channels, UBYTE num_channels,
+                                 ADS1256_GAIN gain, ADS1256_DRATE drate, UBYTE settling_cycles);
+UBYTE ADS1256_Dev_Scan(ads1256_dev_t *dev, ADS1256_ScanList *list, UDOUBLE *out);
+UBYTE ADS1256_Dev_ScanFrames(ads1256_dev_t *dev, ADS1256_ScanList *list, ads1256_frame_t *frames);
+UBYTE ADS1256_Dev_ScanWaitEntry(ads1256_dev_t *dev, ADS1256_ScanList *list, UBYTE i);
+UBYTE ADS1256_Dev_ScanReadEntry(ads1256_dev_t *dev, ADS1256_ScanList *list, UBYTE i, ads1256_frame_t *frame);
+UBYTE ADS1256_Dev_ScanList_AutoTune(ads1256_dev_t *dev, ADS1256_ScanList *list, const ADS1256_TuneConfig *cfg,
+                                    ADS1256_TuneResult *results);
+#define ADS1256_KERNEL_ENTRY(mux, settling_cycles)
+#define ADS1256_KERNEL(name, gain, drate, entries) UBYTE ADS1256_Dev_Kernel_##name(ads1256_dev_t *dev, UDOUBLE *out);
+#include ADS1256_KERNELS_DEF
+#undef ADS1256_KERNEL
+#undef ADS1256_KERNEL_ENTRY
+UBYTE ADS1256_Dev_RunKernel(ads1256_dev_t *dev, const ADS1256_Kernel *kernel, UDOUBLE *out);
+UBYTE ADS1256_Dev_Calibrate(ads1256_dev_t *dev, ADS1256_CMD cal_cmd, ADS1256_CalCoeffs *coeffs);
+UBYTE ADS1256_Dev_CalibrateStart(ads1256_dev_t *dev, ADS1256_CMD cal_cmd);
+void ADS1256_Dev_GetCalibration(ads1256_dev_t *dev, ADS1256_CalCoeffs *coeffs);
+UBYTE ADS1256_Dev_SetCalibration(ads1256_dev_t *dev, const ADS1256_CalCoeffs *coeffs);
+void ADS1256_Dev_SetCalTable(ads1256_dev_t *dev, const ADS1256_CalTable *table);
+UBYTE ADS1256_Dev_SetSpiSpeed(ads1256_dev_t *dev, UDOUBLE speed_hz);
+UDOUBLE ADS1256_Dev_GetSpiSpeed(ads1256_dev_t *dev);
+UBYTE ADS1256_Dev_ProbeSpiSpeed(ads1256_dev_t *dev, const ADS1256_SpeedProbe *cfg, ADS1256_SpeedProbeResult *result);
+UBYTE ADS1256_Dev_StartContinuous(ads1256_dev_t *dev, UBYTE Channel);
+UBYTE ADS1256_Dev_ReadContinuous(ads1256_dev_t *dev, UDOUBLE *buf, UDOUBLE n);
+UBYTE ADS1256_Dev_ReadContinuousFrames(ads1256_dev_t *dev, ads1256_frame_t *frames, UDOUBLE n);
+UBYTE ADS1256_Dev_StopContinuous(ads1256_dev_t *dev);
+void ADS1256_Dev_InitPerformanceMonitoring(ads1256_dev_t *dev, ADS1256_DRATE drate_enum_val);
+performance_metrics_t* ADS1256_Dev_GetPerformanceMetrics(ads1256_dev_t *dev);
+void ADS1256_Dev_PrintPerformanceReport(ads1256_dev_t *dev);
+
 #endif // _ADS1256_H_
\ No newline at end of file
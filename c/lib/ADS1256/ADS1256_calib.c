@@ -0,0 +1,279 @@
+/**
+ * @file ADS1256_calib.c
+ * @brief Calibration table management and persistence for the ADS1256.
+ *
+ * File layout (little-endian, independent of struct padding):
+ *   header  "ADSC", version, chip ID, entry count (2 bytes), board ID (4 bytes), 4 reserved bytes
+ *   entries gain, DRATE, OFC0..OFC2, FSC0..FSC2 (8 bytes each)
+ *   footer  FNV-1a hash of everything before it (4 bytes)
+ */
+#include "ADS1256_calib.h"
+#include <stdio.h>
+#include <string.h>
+
+#define ADS1256_CAL_MAGIC       "ADSC"
+#define ADS1256_CAL_VERSION     1
+#define ADS1256_CAL_HEADER_LEN  16
+#define ADS1256_CAL_ENTRY_LEN   8
+#define ADS1256_CAL_MAX_ENTRIES ((ADS1256_GAIN_64 + 1) * ADS1256_DRATE_MAX)
+#define ADS1256_CAL_FILE_MAX    (ADS1256_CAL_HEADER_LEN + ADS1256_CAL_MAX_ENTRIES * ADS1256_CAL_ENTRY_LEN + 4)
+
+/**
+ * @brief Computes the 32-bit FNV-1a hash of a buffer.
+ * @param data Buffer.
+ * @param len Buffer length.
+ * @return Hash value.
+ */
+static UDOUBLE ADS1256_CalHash(const UBYTE *data, UDOUBLE len)
+{
+    UDOUBLE hash = 2166136261u;
+    for (UDOUBLE i = 0; i < len; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Stores a 32-bit value little-endian.
+ * @param p Destination (4 bytes).
+ * @param v Value.
+ */
+static void ADS1256_CalPut32(UBYTE *p, UDOUBLE v)
+{
+    p[0] = (UBYTE)v; p[1] = (UBYTE)(v >> 8); p[2] = (UBYTE)(v >> 16); p[3] = (UBYTE)(v >> 24);
+}
+
+/**
+ * @brief Loads a little-endian 32-bit value.
+ * @param p Source (4 bytes).
+ * @return Value.
+ */
+static UDOUBLE ADS1256_CalGet32(const UBYTE *p)
+{
+    return (UDOUBLE)p[0] | ((UDOUBLE)p[1] << 8) | ((UDOUBLE)p[2] << 16) | ((UDOUBLE)p[3] << 24);
+}
+
+/**
+ * @brief Clears a calibration table.
+ * @param table Table to initialize.
+ * @param board_id Identifier of the board the coefficients belong to.
+ */
+void ADS1256_CalTable_Init(ADS1256_CalTable *table, UDOUBLE board_id)
+{
+    memset(table, 0, sizeof(*table));
+    table->board_id = board_id;
+}
+
+/**
+ * @brief Stores coefficients for a gain/DRATE combination.
+ * @param table Table to update.
+ * @param gain PGA gain.
+ * @param drate Data rate.
+ * @param coeffs Coefficients to store.
+ * @return ADS1256_OK on success, ADS1256_ERROR on an invalid gain or rate.
+ */
+UBYTE ADS1256_CalTable_Store(ADS1256_CalTable *table, ADS1256_GAIN gain, ADS1256_DRATE drate,
+                             const ADS1256_CalCoeffs *coeffs)
+{
+    if (!table || !coeffs || gain > ADS1256_GAIN_64 || drate >= ADS1256_DRATE_MAX) return ADS1256_ERROR;
+
+    table->coeffs[gain][drate] = *coeffs;
+    table->valid[gain] |= (UWORD)(1u << drate);
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Switches a device to a gain/DRATE combination, calibrates it and stores the result.
+ * @param dev Device context.
+ * @param table Table to update.
+ * @param gain PGA gain.
+ * @param drate Data rate.
+ * @param cal_cmd Calibration command.
+ * @return ADS1256_OK on success, otherwise the error from the driver.
+ */
+UBYTE ADS1256_Dev_CalTable_Calibrate(ads1256_dev_t *dev, ADS1256_CalTable *table, ADS1256_GAIN gain,
+                                     ADS1256_DRATE drate, ADS1256_CMD cal_cmd)
+{
+    ADS1256_CalCoeffs coeffs;
+    UBYTE status;
+
+    if (!dev || !table) return ADS1256_ERROR;
+    if ((status = ADS1256_Dev_SetDataRate(dev, drate)) != ADS1256_OK) return status;
+    if ((status = ADS1256_Dev_SetGain(dev, gain)) != ADS1256_OK) return status;
+    if ((status = ADS1256_Dev_Calibrate(dev, cal_cmd, &coeffs)) != ADS1256_OK) return status;
+    return ADS1256_CalTable_Store(table, gain, drate, &coeffs);
+}
+
+/**
+ * @brief Switches to a gain/DRATE combination, calibrates it and stores the result.
+ * @param table Table to update.
+ * @param gain PGA gain.
+ * @param drate Data rate.
+ * @param cal_cmd Calibration command.
+ * @return ADS1256_OK on success, otherwise the error from the driver.
+ */
+UBYTE ADS1256_CalTable_Calibrate(ADS1256_CalTable *table, ADS1256_GAIN gain, ADS1256_DRATE drate,
+                                 ADS1256_CMD cal_cmd)
+{
+    return ADS1256_Dev_CalTable_Calibrate(ADS1256_GetDefaultDev(), table, gain, drate, cal_cmd);
+}
+
+/**
+ * @brief Self-calibrates every distinct gain/DRATE combination used by a scan list on a device.
+ * @param dev Device context.
+ * @param table Table to update.
+ * @param list Scan list whose combinations are calibrated.
+ * @param cal_cmd CMD_SELFCAL, CMD_SELFOCAL or CMD_SELFGCAL.
+ * @return ADS1256_OK on success, otherwise the first error.
+ */
+UBYTE ADS1256_Dev_CalTable_CalibrateScanList(ads1256_dev_t *dev, ADS1256_CalTable *table, ADS1256_ScanList *list,
+                                             ADS1256_CMD cal_cmd)
+{
+    UWORD done[ADS1256_GAIN_64 + 1] = {0};
+
+    if (!table || !list) return ADS1256_ERROR;
+    if (cal_cmd != CMD_SELFCAL && cal_cmd != CMD_SELFOCAL && cal_cmd != CMD_SELFGCAL) {
+        fprintf(stderr, "ADS1256_CalTable_CalibrateScanList: Only self-calibration is supported\r\n");
+        return ADS1256_ERROR;
+    }
+
+    ADS1256_ScanList_Reset(list);
+    for (UBYTE i = 0; i < list->num_entries; i++) {
+        const ADS1256_ScanEntry *entry = &list->entries[i];
+        if (done[entry->gain] & (1u << entry->drate)) continue;
+
+        UBYTE status = ADS1256_Dev_CalTable_Calibrate(dev, table, entry->gain, entry->drate, cal_cmd);
+        if (status != ADS1256_OK) return status;
+        done[entry->gain] |= (UWORD)(1u << entry->drate);
+    }
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Self-calibrates every distinct gain/DRATE combination used by a scan list.
+ * @param table Table to update.
+ * @param list Scan list whose combinations are calibrated.
+ * @param cal_cmd CMD_SELFCAL, CMD_SELFOCAL or CMD_SELFGCAL.
+ * @return ADS1256_OK on success, otherwise the first error.
+ */
+UBYTE ADS1256_CalTable_CalibrateScanList(ADS1256_CalTable *table, ADS1256_ScanList *list, ADS1256_CMD cal_cmd)
+{
+    return ADS1256_Dev_CalTable_CalibrateScanList(ADS1256_GetDefaultDev(), table, list, cal_cmd);
+}
+
+/**
+ * @brief Saves a calibration table to a binary file.
+ *
+ * The data is written to `path`.tmp and renamed over `path`, so a crash
+ * never leaves a truncated table behind.
+ * @param table Table to save.
+ * @param path File path.
+ * @return ADS1256_OK on success, ADS1256_ERROR on an I/O error.
+ */
+UBYTE ADS1256_CalTable_Save(const ADS1256_CalTable *table, const char *path)
+{
+    UBYTE buf[ADS1256_CAL_FILE_MAX];
+    UDOUBLE len = ADS1256_CAL_HEADER_LEN;
+    UWORD count = 0;
+    char tmp_path[256];
+
+    if (!table || !path) return ADS1256_ERROR;
+
+    for (UBYTE g = 0; g <= ADS1256_GAIN_64; g++) {
+        for (UBYTE d = 0; d < ADS1256_DRATE_MAX; d++) {
+            if (!(table->valid[g] & (1u << d))) continue;
+            UBYTE *e = &buf[len];
+            const ADS1256_CalCoeffs *c = &table->coeffs[g][d];
+            e[0] = g;
+            e[1] = d;
+            memcpy(&e[2], c->ofc, 3);
+            memcpy(&e[5], c->fsc, 3);
+            len += ADS1256_CAL_ENTRY_LEN;
+            count++;
+        }
+    }
+
+    memcpy(buf, ADS1256_CAL_MAGIC, 4);
+    buf[4] = ADS1256_CAL_VERSION;
+    buf[5] = ADS1256_ID;
+    buf[6] = (UBYTE)count;
+    buf[7] = (UBYTE)(count >> 8);
+    ADS1256_CalPut32(&buf[8], table->board_id);
+    ADS1256_CalPut32(&buf[12], 0);
+    ADS1256_CalPut32(&buf[len], ADS1256_CalHash(buf, len));
+    len += 4;
+
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path)) {
+        fprintf(stderr, "ADS1256_CalTable_Save: Path too long\r\n");
+        return ADS1256_ERROR;
+    }
+    FILE *f = fopen(tmp_path, "wb");
+    if (!f) {
+        perror("ADS1256_CalTable_Save: Failed to open calibration file");
+        return ADS1256_ERROR;
+    }
+    size_t written = fwrite(buf, 1, len, f);
+    if (fclose(f) != 0 || written != len || rename(tmp_path, path) != 0) {
+        perror("ADS1256_CalTable_Save: Failed to write calibration file");
+        remove(tmp_path);
+        return ADS1256_ERROR;
+    }
+
+    Debug("ADS1256_CalTable_Save: %d entries written to %s\n", count, path);
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Loads a calibration table saved by ADS1256_CalTable_Save().
+ * @param table Table to fill; its board_id selects the expected file.
+ * @param path File path.
+ * @return ADS1256_OK on success, ADS1256_ERROR if the file is missing, corrupt or for another board.
+ */
+UBYTE ADS1256_CalTable_Load(ADS1256_CalTable *table, const char *path)
+{
+    UBYTE buf[ADS1256_CAL_FILE_MAX + 1];
+
+    if (!table || !path) return ADS1256_ERROR;
+
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        Debug("ADS1256_CalTable_Load: %s not found\n", path);
+        return ADS1256_ERROR;
+    }
+    size_t len = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+
+    if (len < ADS1256_CAL_HEADER_LEN + 4 || len > ADS1256_CAL_FILE_MAX ||
+        memcmp(buf, ADS1256_CAL_MAGIC, 4) != 0 || buf[4] != ADS1256_CAL_VERSION) {
+        fprintf(stderr, "ADS1256_CalTable_Load: %s is not a calibration file\r\n", path);
+        return ADS1256_ERROR;
+    }
+    UWORD count = (UWORD)(buf[6] | (buf[7] << 8));
+    if (len != ADS1256_CAL_HEADER_LEN + (size_t)count * ADS1256_CAL_ENTRY_LEN + 4 ||
+        ADS1256_CalGet32(&buf[len - 4]) != ADS1256_CalHash(buf, len - 4)) {
+        fprintf(stderr, "ADS1256_CalTable_Load: %s is corrupt\r\n", path);
+        return ADS1256_ERROR;
+    }
+    if (buf[5] != ADS1256_ID || ADS1256_CalGet32(&buf[8]) != table->board_id) {
+        fprintf(stderr, "ADS1256_CalTable_Load: %s belongs to another chip/board (ID %d, board 0x%08X)\r\n",
+                path, buf[5], ADS1256_CalGet32(&buf[8]));
+        return ADS1256_ERROR;
+    }
+
+    ADS1256_CalTable_Init(table, table->board_id);
+    for (UWORD i = 0; i < count; i++) {
+        const UBYTE *e = &buf[ADS1256_CAL_HEADER_LEN + i * ADS1256_CAL_ENTRY_LEN];
+        ADS1256_CalCoeffs c;
+        memcpy(c.ofc, &e[2], 3);
+        memcpy(c.fsc, &e[5], 3);
+        if (ADS1256_CalTable_Store(table, (ADS1256_GAIN)e[0], (ADS1256_DRATE)e[1], &c) != ADS1256_OK) {
+            fprintf(stderr, "ADS1256_CalTable_Load: Invalid entry %d in %s\r\n", i, path);
+            ADS1256_CalTable_Init(table, table->board_id);
+            return ADS1256_ERROR;
+        }
+    }
+
+    Debug("ADS1256_CalTable_Load: %d entries loaded from %s\n", count, path);
+    return ADS1256_OK;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file ADS1256_calib.h
+ * @brief Calibration table management and persistence for the ADS1256.
+ *
+ * Calibrating every gain/DRATE combination once and saving the OFC/FSC
+ * coefficients lets later runs skip calibration entirely: the table is loaded
+ * from disk, attached with ADS1256_SetCalTable(), and the driver writes the
+ * matching coefficients alongside every gain or data rate change.
+ */
+
+#ifndef _ADS1256_CALIB_H_
+#define _ADS1256_CALIB_H_
+
+#include "ADS1256.h"
+
+/** @brief Default calibration file name used by the examples. */
+#define ADS1256_CAL_DEFAULT_FILE "ads1256_cal.bin"
+
+/**
+ * @brief Clears a calibration table.
+ * @param table Table to initialize.
+ * @param board_id Identifier of the board the coefficients belong to (checked on load).
+ */
+void ADS1256_CalTable_Init(ADS1256_CalTable *table, UDOUBLE board_id);
+
+/**
+ * @brief Stores coefficients for a gain/DRATE combination.
+ * @param table Table to update.
+ * @param gain PGA gain.
+ * @param drate Data rate.
+ * @param coeffs Coefficients to store.
+ * @return ADS1256_OK on success, ADS1256_ERROR on an invalid gain or rate.
+ */
+UBYTE ADS1256_CalTable_Store(ADS1256_CalTable *table, ADS1256_GAIN gain, ADS1256_DRATE drate,
+                             const ADS1256_CalCoeffs *coeffs);
+
+/**
+ * @brief Switches to a gain/DRATE combination, calibrates it and stores the result.
+ *
+ * The chip is left at the given gain and data rate.
+ * @param table Table to update.
+ * @param gain PGA gain.
+ * @param drate Data rate.
+ * @param cal_cmd Calibration command (CMD_SELFCAL ... CMD_SYSGCAL).
+ * @return ADS1256_OK on success, otherwise the error from the driver.
+ */
+UBYTE ADS1256_CalTable_Calibrate(ADS1256_CalTable *table, ADS1256_GAIN gain, ADS1256_DRATE drate,
+                                 ADS1256_CMD cal_cmd);
+
+/**
+ * @brief Self-calibrates every distinct gain/DRATE combination used by a scan list.
+ *
+ * System calibrations need a known input per entry and are not supported here;
+ * use ADS1256_CalTable_Calibrate() for those. The list's pipeline is reset.
+ * @param table Table to update.
+ * @param list Scan list whose combinations are calibrated.
+ * @param cal_cmd CMD_SELFCAL, CMD_SELFOCAL or CMD_SELFGCAL.
+ * @return ADS1256_OK on success, otherwise the first error.
+ */
+UBYTE ADS1256_CalTable_CalibrateScanList(ADS1256_CalTable *table, ADS1256_ScanList *list, ADS1256_CMD cal_cmd);
+
+/**
+ * @brief ADS1256_CalTable_Calibrate() on a given device.
+ * @param dev Device context.
+ * @param table Table to update.
+ * @param gain PGA gain.
+ * @param drate Data rate.
+ * @param cal_cmd Calibration command (CMD_SELFCAL ... CMD_SYSGCAL).
+ * @return ADS1256_OK on success, otherwise the error from the driver.
+ */
+UBYTE ADS1256_Dev_CalTable_Calibrate(ads1256_dev_t *dev, ADS1256_CalTable *table, ADS1256_GAIN gain,
+                                     ADS1256_DRATE drate, ADS1256_CMD cal_cmd);
+
+/**
+ * @brief ADS1256_CalTable_CalibrateScanList() on a given device.
+ * @param dev Device context the list was built for.
+ * @param table Table to update.
+ * @param list Scan list whose combinations are calibrated.
+ * @param cal_cmd CMD_SELFCAL, CMD_SELFOCAL or CMD_SELFGCAL.
+ * @return ADS1256_OK on success, otherwise the first error.
+ */
+UBYTE ADS1256_Dev_CalTable_CalibrateScanList(ads1256_dev_t *dev, ADS1256_CalTable *table, ADS1256_ScanList *list,
+                                             ADS1256_CMD cal_cmd);
+
+/**
+ * @brief Saves a calibration table to a binary file (written atomically via rename).
+ * @param table Table to save.
+ * @param path File path.
+ * @return ADS1256_OK on success, ADS1256_ERROR on an I/O error.
+ */
+UBYTE ADS1256_CalTable_Save(const ADS1256_CalTable *table, const char *path);
+
+/**
+ * @brief Loads a calibration table saved by ADS1256_CalTable_Save().
+ *
+ * The file must carry the same board ID as `table` (set by
+ * ADS1256_CalTable_Init()) and the chip ID of an ADS1256.
+ * @param table Table to fill; its board_id selects the expected file.
+ * @param path File path.
+ * @return ADS1256_OK on success, ADS1256_ERROR if the file is missing, corrupt or for another board.
+ */
+UBYTE ADS1256_CalTable_Load(ADS1256_CalTable *table, const char *path);
+
+#endif // _ADS1256_CALIB_H_
@@ -0,0 +1,491 @@
+/**
+ * @file ADS1256_capture.c
+ * @brief Writer thread, segment files and decoder for binary ADS1256 captures.
+ *
+ * Only the writer thread touches the mapping of the current segment. Records
+ * are stored through the mapping, so the data is written to the page cache
+ * without a copy through write(); msync(MS_ASYNC) marks finished pages for
+ * writeback without waiting for it.
+ */
+#define _GNU_SOURCE // For pthread_setaffinity_np, CPU_SET
+#include "ADS1256_capture.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+_Static_assert(sizeof(ads1256_capture_record_t) == 8, "capture records must stay 8 bytes");
+_Static_assert(sizeof(ads1256_capture_header_t) <= ADS1256_CAPTURE_HEADER_SIZE, "capture header too large");
+
+#define ADS1256_CAPTURE_READ_BLOCK 4096 ///< Frames taken from the stream per read
+#define ADS1256_CAPTURE_READ_MS    20   ///< Stream read timeout, bounds the stop latency
+#define ADS1256_CAPTURE_LOST_MAX   0xFFFFFFu
+
+/**
+ * @brief Fills a configuration with defaults.
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_Capture_DefaultConfig(ads1256_capture_config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->path_prefix = "capture";
+    cfg->segment_records = ADS1256_CAPTURE_DEFAULT_SEGMENT;
+    cfg->max_segments = 0;
+    cfg->flush_records = ADS1256_CAPTURE_DEFAULT_FLUSH;
+    cfg->vref_positive = ADC_VREF_POS_5V0;
+    cfg->vref_negative = ADC_VREF_NEG_GND;
+    cfg->cpu = -1;
+}
+
+/**
+ * @brief Formats the file name of a segment.
+ * @param cap Capture object.
+ * @param index Segment index.
+ * @param path Output buffer of ADS1256_CAPTURE_PATH_MAX + 16 bytes.
+ * @param size Size of `path`.
+ */
+static void ADS1256_Capture_SegmentPath(const ads1256_capture_t *cap, uint32_t index, char *path, size_t size)
+{
+    snprintf(path, size, "%s_%06u.adc", cap->path_prefix, index);
+}
+
+/**
+ * @brief Fills the header template from the stream's scan list and device.
+ * @param cap Capture object with `stream` and `config` set.
+ */
+static void ADS1256_Capture_BuildHeader(ads1256_capture_t *cap)
+{
+    ads1256_capture_header_t *h = &cap->header;
+    const ADS1256_ScanList *scan = &cap->stream->scan;
+    const ads1256_dev_t *dev = cap->stream->config.dev;
+    const ADS1256_CalTable *cal = dev->cal_table;
+
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, ADS1256_CAPTURE_MAGIC, sizeof(h->magic));
+    h->version = ADS1256_CAPTURE_VERSION;
+    h->header_size = ADS1256_CAPTURE_HEADER_SIZE;
+    h->record_size = sizeof(ads1256_capture_record_t);
+    h->capacity = cap->config.segment_records;
+    h->board_id = cal ? cal->board_id : 0;
+    h->vref_positive = cap->config.vref_positive;
+    h->vref_negative = cap->config.vref_negative;
+    h->scan_mode = (uint8_t)dev->scan_mode;
+    h->num_entries = scan->num_entries;
+
+    for (UBYTE i = 0; i < scan->num_entries; i++) {
+        const ADS1256_ScanEntry *e = &scan->entries[i];
+        ads1256_capture_entry_t *out = &h->entries[i];
+
+        out->mux = e->mux;
+        out->gain = (uint8_t)e->gain;
+        out->drate = (uint8_t)e->drate;
+        out->settling_cycles = e->settling_cycles;
+        out->channel = e->channel;
+        if (cal && (cal->valid[e->gain] & (1u << e->drate))) {
+            out->cal_valid = 1;
+            memcpy(out->ofc, cal->coeffs[e->gain][e->drate].ofc, sizeof(out->ofc));
+            memcpy(out->fsc, cal->coeffs[e->gain][e->drate].fsc, sizeof(out->fsc));
+        }
+    }
+}
+
+/**
+ * @brief Hands the records written since the last flush to the kernel.
+ *
+ * Only whole pages are flushed until the segment is closed, so a page is
+ * not written back twice.
+ * @param cap Capture object.
+ * @param final Non-zero to flush everything and wait for it (segment close).
+ */
+static void ADS1256_Capture_Flush(ads1256_capture_t *cap, UBYTE final)
+{
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t start = ADS1256_CAPTURE_HEADER_SIZE + cap->flushed * sizeof(ads1256_capture_record_t);
+    size_t end = ADS1256_CAPTURE_HEADER_SIZE + cap->pos * sizeof(ads1256_capture_record_t);
+
+    start &= ~(page - 1);
+    if (!final) end &= ~(page - 1);
+    if (end > start && msync(cap->map + start, end - start, final ? MS_SYNC : MS_ASYNC) != 0) {
+        perror("ADS1256_Capture: msync failed");
+        atomic_fetch_add_explicit(&cap->io_errors, 1, memory_order_relaxed);
+    }
+    cap->flushed = cap->pos;
+
+    // The header lives on page 0, which is flushed with it
+    ads1256_capture_header_t *h = (ads1256_capture_header_t *)cap->map;
+    h->record_count = cap->pos;
+    if (msync(cap->map, page, final ? MS_SYNC : MS_ASYNC) != 0) {
+        atomic_fetch_add_explicit(&cap->io_errors, 1, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Finishes the current segment: final header, flush, trim, close.
+ * @param cap Capture object.
+ */
+static void ADS1256_Capture_CloseSegment(ads1256_capture_t *cap)
+{
+    if (!cap->map) return;
+
+    ((ads1256_capture_header_t *)cap->map)->closed = 1;
+    ADS1256_Capture_Flush(cap, 1);
+    munmap(cap->map, cap->map_size);
+    cap->map = NULL;
+
+    // Drop the unused preallocated tail so the file size matches the records
+    off_t used = (off_t)(ADS1256_CAPTURE_HEADER_SIZE + cap->pos * sizeof(ads1256_capture_record_t));
+    if (ftruncate(cap->fd, used) != 0) {
+        atomic_fetch_add_explicit(&cap->io_errors, 1, memory_order_relaxed);
+    }
+    close(cap->fd);
+    cap->fd = -1;
+}
+
+/**
+ * @brief Creates, preallocates and maps the next segment file.
+ * @param cap Capture object.
+ * @return ADS1256_OK on success, ADS1256_ERROR on an I/O error.
+ */
+static UBYTE ADS1256_Capture_OpenSegment(ads1256_capture_t *cap)
+{
+    char path[ADS1256_CAPTURE_PATH_MAX + 16];
+    size_t size = ADS1256_CAPTURE_HEADER_SIZE + (size_t)cap->config.segment_records * sizeof(ads1256_capture_record_t);
+
+    ADS1256_Capture_SegmentPath(cap, cap->segment_index, path, sizeof(path));
+    cap->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (cap->fd < 0) {
+        fprintf(stderr, "ADS1256_Capture: Cannot create %s: %s\r\n", path, strerror(errno));
+        return ADS1256_ERROR;
+    }
+    // Reserve the blocks now, so a full disk fails here and not as SIGBUS on a store.
+    // Only a filesystem that cannot preallocate falls back to a sparse file.
+    int err = posix_fallocate(cap->fd, 0, (off_t)size);
+    if (err == EOPNOTSUPP || err == EINVAL) {
+        Debug("ADS1256_Capture: %s cannot be preallocated, using a sparse file\n", path);
+        err = ftruncate(cap->fd, (off_t)size) == 0 ? 0 : errno;
+    }
+    if (err != 0) {
+        fprintf(stderr, "ADS1256_Capture: Cannot size %s: %s\r\n", path, strerror(err));
+        close(cap->fd);
+        cap->fd = -1;
+        return ADS1256_ERROR;
+    }
+    cap->map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, cap->fd, 0);
+    if (cap->map == MAP_FAILED) {
+        perror("ADS1256_Capture: mmap failed");
+        cap->map = NULL;
+        close(cap->fd);
+        cap->fd = -1;
+        return ADS1256_ERROR;
+    }
+    madvise(cap->map, size, MADV_SEQUENTIAL);
+    cap->map_size = size;
+    cap->pos = 0;
+    cap->flushed = 0;
+    cap->need_sync = 1;
+
+    DEV_ClockCorr corr = {0};
+    ads1256_capture_header_t *h = (ads1256_capture_header_t *)cap->map;
+    *h = cap->header;
+    h->segment_index = cap->segment_index;
+    if (DEV_ClockCorr_Measure(&corr, CLOCK_REALTIME) == 0) {
+        h->mono_ns = corr.mono_ns;
+        h->realtime_ns = corr.target_ns;
+    }
+    atomic_fetch_add_explicit(&cap->segments, 1, memory_order_relaxed);
+
+    // Segment ring: the oldest file goes once max_segments newer ones exist
+    if (cap->config.max_segments && cap->segment_index >= cap->config.max_segments) {
+        ADS1256_Capture_SegmentPath(cap, cap->segment_index - cap->config.max_segments, path, sizeof(path));
+        unlink(path);
+    }
+    Debug("ADS1256_Capture: Segment %u opened (%llu records)\n", cap->segment_index,
+          (unsigned long long)cap->config.segment_records);
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Stores a 64-bit value in a record slot.
+ * @param rec Record slot.
+ * @param value Value to store.
+ */
+static void ADS1256_Capture_Store64(ads1256_capture_record_t *rec, uint64_t value)
+{
+    memcpy(rec, &value, sizeof(value));
+}
+
+/**
+ * @brief Appends one frame, with a sync marker in front where needed.
+ * @param cap Capture object.
+ * @param f Frame to append.
+ * @return ADS1256_OK on success, ADS1256_ERROR if a new segment cannot be opened.
+ */
+static UBYTE ADS1256_Capture_Append(ads1256_capture_t *cap, const ads1256_frame_t *f)
+{
+    // The first frame of the capture has no predecessor to be compared against
+    uint64_t lost = atomic_load_explicit(&cap->frames, memory_order_relaxed) ? f->sequence - cap->next_sequence : 0;
+    uint64_t dt = f->timestamp_ns - cap->last_timestamp_ns;
+    UBYTE sync = cap->need_sync || lost != 0 || dt > UINT32_MAX;
+    uint64_t need = sync ? ADS1256_CAPTURE_SYNC_RECORDS + 1 : 1;
+
+    if (cap->pos + need > cap->config.segment_records) {
+        ADS1256_Capture_CloseSegment(cap);
+        cap->segment_index++;
+        if (ADS1256_Capture_OpenSegment(cap) != ADS1256_OK) return ADS1256_ERROR;
+        sync = 1;
+    }
+
+    ads1256_capture_record_t *rec = (ads1256_capture_record_t *)(cap->map + ADS1256_CAPTURE_HEADER_SIZE) + cap->pos;
+    if (sync) {
+        ads1256_capture_header_t *h = (ads1256_capture_header_t *)cap->map;
+        uint32_t lost24 = lost > ADS1256_CAPTURE_LOST_MAX ? ADS1256_CAPTURE_LOST_MAX : (uint32_t)lost;
+
+        if (cap->pos == 0) {
+            h->first_sequence = f->sequence;
+            h->first_timestamp_ns = f->timestamp_ns;
+        }
+        if (lost) atomic_fetch_add_explicit(&cap->lost, lost, memory_order_relaxed);
+        rec[0] = (ads1256_capture_record_t){ .code = { lost24 & 0xFF, (lost24 >> 8) & 0xFF, (lost24 >> 16) & 0xFF },
+                                             .tag = ADS1256_CAPTURE_TAG_SYNC, .dt_ns = 0 };
+        ADS1256_Capture_Store64(&rec[1], f->timestamp_ns);
+        ADS1256_Capture_Store64(&rec[2], f->sequence);
+        rec += ADS1256_CAPTURE_SYNC_RECORDS;
+        cap->pos += ADS1256_CAPTURE_SYNC_RECORDS;
+        dt = 0;
+        cap->need_sync = 0;
+    }
+
+    rec->code[0] = f->value & 0xFF;
+    rec->code[1] = (f->value >> 8) & 0xFF;
+    rec->code[2] = (f->value >> 16) & 0xFF;
+    rec->tag = f->channel;
+    rec->dt_ns = (uint32_t)dt;
+    cap->pos++;
+
+    cap->next_sequence = f->sequence + 1;
+    cap->last_timestamp_ns = f->timestamp_ns;
+    atomic_fetch_add_explicit(&cap->frames, 1, memory_order_relaxed);
+
+    if (cap->pos - cap->flushed >= cap->config.flush_records) {
+        ADS1256_Capture_Flush(cap, 0);
+    }
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Writer thread body: drain the stream into the current segment.
+ * @param arg The ads1256_capture_t being run.
+ * @return NULL.
+ */
+static void *ADS1256_Capture_Thread(void *arg)
+{
+    ads1256_capture_t *cap = (ads1256_capture_t *)arg;
+    ads1256_frame_t *block = malloc(ADS1256_CAPTURE_READ_BLOCK * sizeof(ads1256_frame_t));
+    UBYTE failed = 0;
+
+    if (!block) {
+        perror("ADS1256_Capture: Failed to allocate read block");
+        return NULL;
+    }
+    if (cap->config.cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cap->config.cpu, &set);
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (err != 0) {
+            fprintf(stderr, "ADS1256_Capture: Failed to pin writer to CPU %d: %s\r\n", cap->config.cpu, strerror(err));
+        }
+    }
+
+    while (!failed && atomic_load_explicit(&cap->running, memory_order_relaxed)) {
+        UDOUBLE n = ADS1256_Stream_Read(cap->stream, block, ADS1256_CAPTURE_READ_BLOCK, ADS1256_CAPTURE_READ_MS);
+        for (UDOUBLE i = 0; i < n && !failed; i++) {
+            failed = (ADS1256_Capture_Append(cap, &block[i]) != ADS1256_OK);
+        }
+    }
+    // Drain what was queued at the stop request; the stream may still be producing
+    UDOUBLE remaining = failed ? 0 : ADS1256_Stream_Available(cap->stream);
+    while (remaining && !failed) {
+        UDOUBLE max = remaining < ADS1256_CAPTURE_READ_BLOCK ? remaining : ADS1256_CAPTURE_READ_BLOCK;
+        UDOUBLE n = ADS1256_Stream_Read(cap->stream, block, max, 0);
+        if (n == 0) break;
+        for (UDOUBLE i = 0; i < n && !failed; i++) {
+            failed = (ADS1256_Capture_Append(cap, &block[i]) != ADS1256_OK);
+        }
+        remaining -= n;
+    }
+    if (failed) {
+        atomic_fetch_add_explicit(&cap->io_errors, 1, memory_order_relaxed);
+        fprintf(stderr, "ADS1256_Capture: Writer stopped after an I/O error\r\n");
+    }
+    ADS1256_Capture_CloseSegment(cap);
+    free(block);
+    return NULL;
+}
+
+/**
+ * @brief Starts writing a running stream to disk.
+ * @param cap Capture object.
+ * @param stream Running stream.
+ * @param cfg Configuration (copied).
+ * @return ADS1256_OK on success, ADS1256_ERROR on failure.
+ */
+UBYTE ADS1256_Capture_Start(ads1256_capture_t *cap, ads1256_stream_t *stream, const ads1256_capture_config_t *cfg)
+{
+    if (!cap || !stream || !stream->thread_started || !cfg || !cfg->path_prefix ||
+        cfg->segment_records <= ADS1256_CAPTURE_SYNC_RECORDS || cfg->flush_records == 0) {
+        fprintf(stderr, "ADS1256_Capture_Start: Invalid configuration or stream not running\r\n");
+        return ADS1256_ERROR;
+    }
+
+    memset(cap, 0, sizeof(*cap));
+    cap->config = *cfg;
+    snprintf(cap->path_prefix, sizeof(cap->path_prefix), "%s", cfg->path_prefix);
+    cap->config.path_prefix = cap->path_prefix;
+    cap->stream = stream;
+    cap->fd = -1;
+    atomic_init(&cap->frames, 0);
+    atomic_init(&cap->lost, 0);
+    atomic_init(&cap->segments, 0);
+    atomic_init(&cap->io_errors, 0);
+    atomic_init(&cap->running, 1);
+
+    ADS1256_Capture_BuildHeader(cap);
+    if (ADS1256_Capture_OpenSegment(cap) != ADS1256_OK) return ADS1256_ERROR;
+
+    int err = pthread_create(&cap->thread, NULL, ADS1256_Capture_Thread, cap);
+    if (err != 0) {
+        fprintf(stderr, "ADS1256_Capture_Start: Failed to create thread: %s\r\n", strerror(err));
+        ADS1256_Capture_CloseSegment(cap);
+        return ADS1256_ERROR;
+    }
+    cap->thread_started = 1;
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Drains the stream, finishes the current segment and joins the writer.
+ * @param cap Capture object.
+ * @return ADS1256_OK on success, ADS1256_ERROR if the capture was not running.
+ */
+UBYTE ADS1256_Capture_Stop(ads1256_capture_t *cap)
+{
+    if (!cap || !cap->thread_started) return ADS1256_ERROR;
+
+    atomic_store_explicit(&cap->running, 0, memory_order_relaxed);
+    pthread_join(cap->thread, NULL);
+    cap->thread_started = 0;
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Prints frame, loss and segment counters.
+ * @param cap Capture object.
+ */
+void ADS1256_Capture_PrintReport(ads1256_capture_t *cap)
+{
+    if (!cap) return;
+
+    uint64_t frames = atomic_load(&cap->frames);
+    printf("\n--- Capture Report ---\n");
+    printf("Files: %s_NNNNNN.adc, %llu segment(s) of up to %lu records\n", cap->path_prefix,
+           (unsigned long long)atomic_load(&cap->segments), (unsigned long)cap->config.segment_records);
+    printf("Frames written: %llu (%.1f MiB), lost: %llu, I/O errors: %llu\n", (unsigned long long)frames,
+           frames * sizeof(ads1256_capture_record_t) / 1048576.0, (unsigned long long)atomic_load(&cap->lost),
+           (unsigned long long)atomic_load(&cap->io_errors));
+    printf("----------------------\n");
+}
+
+/**
+ * @brief Maps a segment file for decoding.
+ * @param reader Reader to initialize.
+ * @param path Segment file.
+ * @return ADS1256_OK on success, ADS1256_ERROR otherwise.
+ */
+UBYTE ADS1256_CaptureReader_Open(ads1256_capture_reader_t *reader, const char *path)
+{
+    struct stat st;
+
+    memset(reader, 0, sizeof(*reader));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) != 0 || (size_t)st.st_size < ADS1256_CAPTURE_HEADER_SIZE) {
+        fprintf(stderr, "ADS1256_CaptureReader_Open: Cannot read %s\r\n", path);
+        if (fd >= 0) close(fd);
+        return ADS1256_ERROR;
+    }
+    reader->map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (reader->map == MAP_FAILED) {
+        perror("ADS1256_CaptureReader_Open: mmap failed");
+        reader->map = NULL;
+        return ADS1256_ERROR;
+    }
+    reader->map_size = (size_t)st.st_size;
+    reader->header = (const ads1256_capture_header_t *)reader->map;
+
+    const ads1256_capture_header_t *h = reader->header;
+    if (memcmp(h->magic, ADS1256_CAPTURE_MAGIC, sizeof(h->magic)) != 0 || h->version != ADS1256_CAPTURE_VERSION ||
+        h->record_size != sizeof(ads1256_capture_record_t) || h->header_size < sizeof(*h)) {
+        fprintf(stderr, "ADS1256_CaptureReader_Open: %s is not a version %d capture segment\r\n",
+                path, ADS1256_CAPTURE_VERSION);
+        ADS1256_CaptureReader_Close(reader);
+        return ADS1256_ERROR;
+    }
+    reader->records = (const ads1256_capture_record_t *)(reader->map + h->header_size);
+
+    // An unfinished segment (crash) is valid up to its last flush
+    uint64_t in_file = (reader->map_size - h->header_size) / sizeof(ads1256_capture_record_t);
+    reader->count = (h->record_count < in_file) ? h->record_count : in_file;
+    reader->sequence = h->first_sequence;
+    reader->timestamp_ns = h->first_timestamp_ns;
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Decodes the next frame.
+ * @param reader Open reader.
+ * @param frame Receives the frame.
+ * @return 1 when a frame was decoded, 0 at the end of the segment.
+ */
+int ADS1256_CaptureReader_Next(ads1256_capture_reader_t *reader, ads1256_frame_t *frame)
+{
+    while (reader->pos < reader->count) {
+        const ads1256_capture_record_t *rec = &reader->records[reader->pos];
+        uint32_t code = (uint32_t)rec->code[0] | ((uint32_t)rec->code[1] << 8) | ((uint32_t)rec->code[2] << 16);
+
+        if (rec->tag == ADS1256_CAPTURE_TAG_SYNC) {
+            if (reader->pos + ADS1256_CAPTURE_SYNC_RECORDS > reader->count) break;
+            memcpy(&reader->timestamp_ns, &rec[1], sizeof(uint64_t));
+            memcpy(&reader->sequence, &rec[2], sizeof(uint64_t));
+            reader->lost += code;
+            reader->pos += ADS1256_CAPTURE_SYNC_RECORDS;
+            // The frame after a sync is stored with dt 0 relative to the sync timestamp
+            continue;
+        }
+
+        reader->timestamp_ns += rec->dt_ns;
+        frame->timestamp_ns = reader->timestamp_ns;
+        frame->sequence = reader->sequence++;
+        frame->value = (code & 0x800000) ? (code | 0xFF000000u) : code;
+        frame->channel = rec->tag;
+        reader->pos++;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Unmaps a segment file.
+ * @param reader Reader to close.
+ */
+void ADS1256_CaptureReader_Close(ads1256_capture_reader_t *reader)
+{
+    if (reader->map) munmap(reader->map, reader->map_size);
+    memset(reader, 0, sizeof(*reader));
+}
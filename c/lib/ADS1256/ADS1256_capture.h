@@ -0,0 +1,208 @@
+/**
+ * @file ADS1256_capture.h
+ * @brief Binary capture of an ADS1256 stream into memory-mapped segment files.
+ *
+ * A writer thread drains an ads1256_stream_t and packs each frame into an
+ * 8-byte record (24-bit code, channel, timestamp delta) written straight
+ * into a memory-mapped, preallocated segment file. Finished pages are
+ * handed to the kernel with msync(MS_ASYNC), so neither the acquisition
+ * thread nor the writer waits for the disk; back-pressure only ever fills
+ * the stream ring, where it is counted as overruns.
+ *
+ * Each segment starts with a fixed ADS1256_CAPTURE_HEADER_SIZE header that
+ * describes the scan list, gain, data rate and calibration, so a segment
+ * can be mapped and decoded on its own (see ads1256_capture_reader_t).
+ * All fields are little-endian.
+ */
+
+#ifndef _ADS1256_CAPTURE_H_
+#define _ADS1256_CAPTURE_H_
+
+#include "ADS1256_stream.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+/** @name File format */
+#define ADS1256_CAPTURE_MAGIC        "ADS1256C" ///< First 8 bytes of every segment
+#define ADS1256_CAPTURE_VERSION      1
+#define ADS1256_CAPTURE_HEADER_SIZE  4096       ///< Records start on the first page after the header
+#define ADS1256_CAPTURE_TAG_SYNC     0xFF       ///< Record tag of a sync marker
+#define ADS1256_CAPTURE_SYNC_RECORDS 3          ///< Records taken by one sync marker
+#define ADS1256_CAPTURE_PATH_MAX     256
+
+/** @name Defaults */
+#define ADS1256_CAPTURE_DEFAULT_SEGMENT (8u << 20) ///< Records per segment (64 MiB files)
+#define ADS1256_CAPTURE_DEFAULT_FLUSH   65536      ///< Records between msync() calls (512 KiB)
+
+/**
+ * @brief One scan list entry as stored in the segment header.
+ */
+typedef struct {
+    uint8_t mux;             ///< MUX register value
+    uint8_t gain;            ///< ADS1256_GAIN
+    uint8_t drate;           ///< ADS1256_DRATE
+    uint8_t settling_cycles; ///< DRDY cycles per result
+    uint8_t channel;         ///< Channel label, used as the record tag
+    uint8_t cal_valid;       ///< Non-zero when ofc/fsc hold saved calibration for this gain/DRATE
+    uint8_t ofc[3];          ///< OFC0..OFC2
+    uint8_t fsc[3];          ///< FSC0..FSC2
+    uint8_t reserved[4];
+} ads1256_capture_entry_t;
+
+/**
+ * @brief Segment file header, at offset 0 of every segment.
+ */
+typedef struct {
+    char magic[8];               ///< ADS1256_CAPTURE_MAGIC, not NUL-terminated
+    uint32_t version;            ///< ADS1256_CAPTURE_VERSION
+    uint32_t header_size;        ///< Offset of the first record
+    uint32_t record_size;        ///< sizeof(ads1256_capture_record_t)
+    uint32_t segment_index;      ///< Position of this file in the capture
+    uint64_t capacity;           ///< Records the segment was preallocated for
+    uint64_t record_count;       ///< Valid records (updated at every flush and on close)
+    uint64_t first_sequence;     ///< Sequence number of the first frame in the segment
+    uint64_t first_timestamp_ns; ///< CLOCK_MONOTONIC time of the first frame in the segment
+    uint64_t mono_ns;            ///< CLOCK_MONOTONIC time of the clock correlation below
+    uint64_t realtime_ns;        ///< CLOCK_REALTIME at mono_ns
+    uint64_t board_id;           ///< Board identifier of the attached calibration table (0 if none)
+    float vref_positive;         ///< Reference voltages for converting codes to volts
+    float vref_negative;
+    uint8_t scan_mode;           ///< ADS1256_SCAN_MODE of the device
+    uint8_t num_entries;         ///< Valid entries in `entries`
+    uint8_t closed;              ///< Non-zero once the segment was finished cleanly
+    uint8_t reserved[5];
+    ads1256_capture_entry_t entries[ADS1256_SCAN_MAX_ENTRIES]; ///< Scan list, in scan order
+} ads1256_capture_header_t;
+
+/**
+ * @brief One packed record.
+ *
+ * A data record holds a frame: `code` is the 24-bit two's complement
+ * result (byte 0 least significant), `tag` the channel label and `dt_ns`
+ * the time since the previous frame; its sequence number is the previous
+ * one plus 1. A record with tag ADS1256_CAPTURE_TAG_SYNC starts a sync
+ * marker: its `code` holds the number of frames lost before it (saturated
+ * at 2^24 - 1), and the next two records hold the absolute 64-bit timestamp
+ * and sequence number of the following frame. Every segment starts with a
+ * sync; so does every sequence gap and every delta that overflows 32 bits.
+ */
+typedef struct {
+    uint8_t code[3]; ///< 24-bit code, little-endian
+    uint8_t tag;     ///< Channel label, or ADS1256_CAPTURE_TAG_SYNC
+    uint32_t dt_ns;  ///< Nanoseconds since the previous frame
+} ads1256_capture_record_t;
+
+/**
+ * @brief Capture configuration. Fill with ADS1256_Capture_DefaultConfig().
+ */
+typedef struct {
+    const char *path_prefix;  ///< Segments are named <prefix>_NNNNNN.adc
+    UDOUBLE segment_records;  ///< Records per segment file
+    UDOUBLE max_segments;     ///< Keep only the newest N segments (ring), or 0 to keep all
+    UDOUBLE flush_records;    ///< Records between msync(MS_ASYNC) calls
+    float vref_positive;      ///< Stored in the header for offline conversion
+    float vref_negative;
+    int cpu;                  ///< CPU core to pin the writer to, or -1
+} ads1256_capture_config_t;
+
+/**
+ * @brief Capture state. Treat as opaque; use the functions below.
+ */
+typedef struct {
+    ads1256_capture_config_t config;            ///< Copy of the configuration
+    char path_prefix[ADS1256_CAPTURE_PATH_MAX]; ///< Copy of config.path_prefix
+    ads1256_stream_t *stream;                   ///< Stream being drained
+    ads1256_capture_header_t header;            ///< Header template for new segments
+    int fd;                                     ///< Current segment file (-1 if none)
+    UBYTE *map;                                 ///< Mapping of the current segment
+    size_t map_size;                            ///< Size of the mapping
+    uint32_t segment_index;                     ///< Index of the current segment
+    uint64_t pos;                               ///< Records written to the current segment
+    uint64_t flushed;                           ///< Records already handed to msync()
+    uint64_t next_sequence;                     ///< Expected sequence of the next frame
+    uint64_t last_timestamp_ns;                 ///< Timestamp of the last frame written
+    UBYTE need_sync;                            ///< Non-zero when the next frame needs a sync marker
+    pthread_t thread;                           ///< Writer thread
+    UBYTE thread_started;                       ///< Non-zero while `thread` must be joined
+    _Atomic int running;                        ///< Cleared to ask the writer to finish
+    _Atomic uint64_t frames;                    ///< Frames written
+    _Atomic uint64_t lost;                      ///< Frames missing from the sequence (stream overruns)
+    _Atomic uint64_t segments;                  ///< Segment files created
+    _Atomic uint64_t io_errors;                 ///< Failed file operations
+} ads1256_capture_t;
+
+/**
+ * @brief Sequential decoder for one segment file.
+ */
+typedef struct {
+    UBYTE *map;                               ///< Read-only mapping of the file
+    size_t map_size;                          ///< Size of the mapping
+    const ads1256_capture_header_t *header;   ///< Segment header
+    const ads1256_capture_record_t *records;  ///< First record
+    uint64_t count;                           ///< Valid records
+    uint64_t pos;                             ///< Next record to decode
+    uint64_t timestamp_ns;                    ///< Timestamp of the last decoded frame
+    uint64_t sequence;                        ///< Sequence number of the next frame
+    uint64_t lost;                            ///< Frames reported lost by sync markers so far
+} ads1256_capture_reader_t;
+
+/**
+ * @brief Fills a configuration with defaults: prefix "capture", 64 MiB
+ *        segments, all segments kept, msync every 512 KiB, 5 V / GND
+ *        reference, writer unpinned.
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_Capture_DefaultConfig(ads1256_capture_config_t *cfg);
+
+/**
+ * @brief Starts writing a running stream to disk.
+ *
+ * The writer becomes the stream's only consumer: do not call
+ * ADS1256_Stream_Read() until ADS1256_Capture_Stop() returns.
+ * @param cap Capture object.
+ * @param stream Running stream.
+ * @param cfg Configuration (copied).
+ * @return ADS1256_OK on success, ADS1256_ERROR if the first segment cannot be created.
+ */
+UBYTE ADS1256_Capture_Start(ads1256_capture_t *cap, ads1256_stream_t *stream, const ads1256_capture_config_t *cfg);
+
+/**
+ * @brief Drains what the stream holds, finishes the current segment and joins the writer.
+ *
+ * Call before ADS1256_Stream_Stop().
+ * @param cap Capture object.
+ * @return ADS1256_OK on success, ADS1256_ERROR if the capture was not running.
+ */
+UBYTE ADS1256_Capture_Stop(ads1256_capture_t *cap);
+
+/**
+ * @brief Prints frame, loss and segment counters.
+ * @param cap Capture object.
+ */
+void ADS1256_Capture_PrintReport(ads1256_capture_t *cap);
+
+/**
+ * @brief Maps a segment file for decoding.
+ * @param reader Reader to initialize.
+ * @param path Segment file.
+ * @return ADS1256_OK on success, ADS1256_ERROR if the file is missing or not a capture segment.
+ */
+UBYTE ADS1256_CaptureReader_Open(ads1256_capture_reader_t *reader, const char *path);
+
+/**
+ * @brief Decodes the next frame.
+ * @param reader Open reader.
+ * @param frame Receives the frame (sign-extended code, absolute timestamp and sequence).
+ * @return 1 when a frame was decoded, 0 at the end of the segment.
+ */
+int ADS1256_CaptureReader_Next(ads1256_capture_reader_t *reader, ads1256_frame_t *frame);
+
+/**
+ * @brief Unmaps a segment file.
+ * @param reader Reader to close.
+ */
+void ADS1256_CaptureReader_Close(ads1256_capture_reader_t *reader);
+
+#endif // _ADS1256_CAPTURE_H_
@@ -0,0 +1,162 @@
+/**
+ * @file ADS1256_convert.c
+ * @brief Bulk raw-code conversion for the ADS1256.
+ *
+ * Sign extension and scaling are done in one pass: each code is shifted left
+ * by 8 so that bit 23 lands in the sign bit, converted, and multiplied by a
+ * scale that already includes the 1/256 for the shift. The shifted value has
+ * its low 8 bits clear, so the int-to-float conversion is exact.
+ */
+#include "ADS1256_convert.h"
+#include <math.h>
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define ADS1256_CONV_NEON 1
+#endif
+
+/** @brief LSB weight for a 1 V reference span at each PGA gain: 1 / (2^23 * PGA). */
+static const float ADS1256_LSB_PER_VOLT[ADS1256_GAIN_64 + 1] = {
+    1.0f / 8388608.0f,    ///< GAIN 1
+    1.0f / 16777216.0f,   ///< GAIN 2
+    1.0f / 33554432.0f,   ///< GAIN 4
+    1.0f / 67108864.0f,   ///< GAIN 8
+    1.0f / 134217728.0f,  ///< GAIN 16
+    1.0f / 268435456.0f,  ///< GAIN 32
+    1.0f / 536870912.0f,  ///< GAIN 64
+};
+
+/**
+ * @brief Shifts a code so its 24-bit sign bit becomes bit 31.
+ * @param code Sign-extended or plain 24-bit code.
+ * @return code << 8 as a signed value.
+ */
+static inline int32_t ADS1256_ConvShift(int32_t code)
+{
+    return (int32_t)((uint32_t)code << 8);
+}
+
+/**
+ * @brief Precomputes the conversion for a channel.
+ * @param scale Conversion to fill.
+ * @param vref_positive Positive reference voltage.
+ * @param vref_negative Negative reference voltage.
+ * @param gain The PGA gain used when the codes were acquired.
+ * @param gain_correction Multiplicative correction (1.0f for none).
+ * @param offset_correction Volts added after scaling (0.0f for none).
+ */
+void ADS1256_ConvScale_Init(ADS1256_ConvScale *scale, float vref_positive, float vref_negative,
+                            ADS1256_GAIN gain, float gain_correction, float offset_correction)
+{
+    float lsb = (gain <= ADS1256_GAIN_64) ? ADS1256_LSB_PER_VOLT[gain] : ADS1256_LSB_PER_VOLT[ADS1256_GAIN_1];
+
+    scale->scale = (vref_positive - vref_negative) * lsb * gain_correction;
+    scale->offset = offset_correction;
+    scale->scale_q24 = (int32_t)lrint((double)scale->scale * 1e6 * (double)(1 << ADS1256_CONV_Q_BITS));
+    scale->offset_uv = (int32_t)lrint((double)offset_correction * 1e6);
+}
+
+/**
+ * @brief Converts a buffer of codes from a single channel to volts.
+ * @param raw Input codes.
+ * @param out Output voltages.
+ * @param n Number of samples.
+ * @param scale Conversion for the channel.
+ */
+void ADS1256_RawToVoltageBatch(const int32_t *raw, float *out, UDOUBLE n, const ADS1256_ConvScale *scale)
+{
+    const float k = scale->scale * (1.0f / 256.0f); // Undo the << 8 in the same multiply
+    const float offset = scale->offset;
+    UDOUBLE i = 0;
+
+#ifdef ADS1256_CONV_NEON
+    const float32x4_t vk = vdupq_n_f32(k);
+    const float32x4_t voff = vdupq_n_f32(offset);
+    for (; i + 8 <= n; i += 8) {
+        float32x4_t a = vcvtq_f32_s32(vshlq_n_s32(vld1q_s32(raw + i), 8));
+        float32x4_t b = vcvtq_f32_s32(vshlq_n_s32(vld1q_s32(raw + i + 4), 8));
+        vst1q_f32(out + i, vfmaq_f32(voff, a, vk));
+        vst1q_f32(out + i + 4, vfmaq_f32(voff, b, vk));
+    }
+#endif
+    for (; i < n; i++) {
+        out[i] = (float)ADS1256_ConvShift(raw[i]) * k + offset;
+    }
+}
+
+/**
+ * @brief Converts interleaved scans to volts with a conversion per channel.
+ *
+ * The per-channel scales are expanded into a pattern of lcm(num_channels, 4)
+ * lanes, so the vector loop stays branch-free for any channel count.
+ * @param raw Input codes, `num_scans * num_channels` entries.
+ * @param out Output voltages.
+ * @param num_scans Number of complete scans.
+ * @param scales One conversion per channel, in scan order.
+ * @param num_channels Channels per scan.
+ */
+void ADS1256_RawToVoltageInterleaved(const int32_t *raw, float *out, UDOUBLE num_scans,
+                                     const ADS1256_ConvScale *scales, UBYTE num_channels)
+{
+    if (num_channels == 0 || num_channels > ADS1256_SCAN_MAX_ENTRIES) return;
+    if (num_channels == 1) {
+        ADS1256_RawToVoltageBatch(raw, out, num_scans, scales);
+        return;
+    }
+
+    const UDOUBLE total = num_scans * num_channels;
+    UDOUBLE i = 0;
+
+#ifdef ADS1256_CONV_NEON
+    // Period of the lane pattern: lcm(num_channels, 4)
+    UBYTE period = num_channels * ((num_channels % 4 == 0) ? 1 : (num_channels % 2 == 0) ? 2 : 4);
+    float k_pattern[4 * ADS1256_SCAN_MAX_ENTRIES];
+    float off_pattern[4 * ADS1256_SCAN_MAX_ENTRIES];
+    for (UBYTE lane = 0; lane < period; lane++) {
+        k_pattern[lane] = scales[lane % num_channels].scale * (1.0f / 256.0f);
+        off_pattern[lane] = scales[lane % num_channels].offset;
+    }
+
+    UBYTE phase = 0;
+    for (; i + 4 <= total; i += 4) {
+        float32x4_t f = vcvtq_f32_s32(vshlq_n_s32(vld1q_s32(raw + i), 8));
+        vst1q_f32(out + i, vfmaq_f32(vld1q_f32(off_pattern + phase), f, vld1q_f32(k_pattern + phase)));
+        phase += 4;
+        if (phase == period) phase = 0;
+    }
+#endif
+    for (; i < total; i++) {
+        const ADS1256_ConvScale *s = &scales[i % num_channels];
+        out[i] = (float)ADS1256_ConvShift(raw[i]) * (s->scale * (1.0f / 256.0f)) + s->offset;
+    }
+}
+
+/**
+ * @brief Converts a buffer of codes from a single channel to integer microvolts.
+ * @param raw Input codes.
+ * @param out_uv Output in microvolts.
+ * @param n Number of samples.
+ * @param scale Conversion for the channel.
+ */
+void ADS1256_RawToMicrovoltsBatch(const int32_t *raw, int32_t *out_uv, UDOUBLE n, const ADS1256_ConvScale *scale)
+{
+    const int32_t q = scale->scale_q24;
+    const int32_t offset = scale->offset_uv;
+    UDOUBLE i = 0;
+
+#ifdef ADS1256_CONV_NEON
+    const int32x4_t voff = vdupq_n_s32(offset);
+    for (; i + 4 <= n; i += 4) {
+        int32x4_t code = vshrq_n_s32(vshlq_n_s32(vld1q_s32(raw + i), 8), 8); // Sign-extend bit 23
+        int64x2_t lo = vmull_n_s32(vget_low_s32(code), q);
+        int64x2_t hi = vmull_high_n_s32(code, q);
+        int32x4_t uv = vcombine_s32(vrshrn_n_s64(lo, ADS1256_CONV_Q_BITS), vrshrn_n_s64(hi, ADS1256_CONV_Q_BITS));
+        vst1q_s32(out_uv + i, vaddq_s32(uv, voff));
+    }
+#endif
+    for (; i < n; i++) {
+        int64_t code = ADS1256_ConvShift(raw[i]) >> 8; // Arithmetic shift: sign-extends bit 23
+        int64_t product = code * q + ((int64_t)1 << (ADS1256_CONV_Q_BITS - 1));
+        out_uv[i] = (int32_t)(product >> ADS1256_CONV_Q_BITS) + offset;
+    }
+}
@@ -0,0 +1,84 @@
+/**
+ * @file ADS1256_convert.h
+ * @brief Bulk conversion of ADS1256 raw codes to volts or fixed-point microvolts.
+ *
+ * The per-sample cost of ADS1256_RawToVoltage() (gain switch, division, vref
+ * span) is moved into a precomputed ADS1256_ConvScale, so a buffer of codes is
+ * converted with one multiply-add per sample. On AArch64 (Raspberry Pi 5,
+ * Cortex-A76) the loops are NEON-vectorized; elsewhere a scalar loop is used.
+ */
+
+#ifndef _ADS1256_CONVERT_H_
+#define _ADS1256_CONVERT_H_
+
+#include "ADS1256.h"
+#include <stdint.h>
+
+/** @brief Fractional bits of ADS1256_ConvScale::scale_q24 (microvolts per LSB). */
+#define ADS1256_CONV_Q_BITS 24
+
+/**
+ * @brief Precomputed conversion for one channel: out = code * scale + offset.
+ *
+ * Fill with ADS1256_ConvScale_Init(). The offset and gain correction of the
+ * channel are folded in, so no extra pass is needed for calibration.
+ */
+typedef struct {
+    float scale;        ///< Volts per LSB (vref span / 2^23 / PGA * gain correction)
+    float offset;       ///< Volts added after scaling
+    int32_t scale_q24;  ///< Microvolts per LSB in Q8.24 for the fixed-point path
+    int32_t offset_uv;  ///< Microvolts added after scaling in the fixed-point path
+} ADS1256_ConvScale;
+
+/**
+ * @brief Precomputes the conversion for a channel.
+ * @param scale Conversion to fill.
+ * @param vref_positive Positive reference voltage (e.g., 5.0V).
+ * @param vref_negative Negative reference voltage (e.g., 0.0V for GND).
+ * @param gain The PGA gain used when the codes were acquired.
+ * @param gain_correction Multiplicative correction (1.0f for none).
+ * @param offset_correction Volts added after scaling (0.0f for none).
+ */
+void ADS1256_ConvScale_Init(ADS1256_ConvScale *scale, float vref_positive, float vref_negative,
+                            ADS1256_GAIN gain, float gain_correction, float offset_correction);
+
+/**
+ * @brief Converts a buffer of codes from a single channel to volts.
+ *
+ * Codes may be either sign-extended (as returned by the driver, so UDOUBLE
+ * buffers can be passed with a cast) or plain 24-bit two's complement; sign
+ * extension is done in the same pass.
+ * @param raw Input codes.
+ * @param out Output voltages (may not alias `raw`).
+ * @param n Number of samples.
+ * @param scale Conversion for the channel.
+ */
+void ADS1256_RawToVoltageBatch(const int32_t *raw, float *out, UDOUBLE n, const ADS1256_ConvScale *scale);
+
+/**
+ * @brief Converts interleaved scans (ch0, ch1, ..., chN-1, ch0, ...) to volts.
+ *
+ * This is the layout produced by repeated ADS1256_Scan() or
+ * ADS1256_GetNChannels_*() calls into consecutive slices of one buffer.
+ * @param raw Input codes, `num_scans * num_channels` entries.
+ * @param out Output voltages.
+ * @param num_scans Number of complete scans.
+ * @param scales One conversion per channel, in scan order.
+ * @param num_channels Channels per scan (1-ADS1256_SCAN_MAX_ENTRIES).
+ */
+void ADS1256_RawToVoltageInterleaved(const int32_t *raw, float *out, UDOUBLE num_scans,
+                                     const ADS1256_ConvScale *scales, UBYTE num_channels);
+
+/**
+ * @brief Converts a buffer of codes from a single channel to integer microvolts.
+ *
+ * Uses the Q8.24 multiplier in `scale` with 64-bit products and rounding,
+ * so it needs no FPU work and is exact to well under 1 uV at every gain.
+ * @param raw Input codes (sign-extended or 24-bit two's complement).
+ * @param out_uv Output in microvolts.
+ * @param n Number of samples.
+ * @param scale Conversion for the channel.
+ */
+void ADS1256_RawToMicrovoltsBatch(const int32_t *raw, int32_t *out_uv, UDOUBLE n, const ADS1256_ConvScale *scale);
+
+#endif // _ADS1256_CONVERT_H_
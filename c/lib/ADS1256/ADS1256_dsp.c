@@ -0,0 +1,313 @@
+/**
+ * @file ADS1256_dsp.c
+ * @brief Median, CIC, FIR and moving-average stages for ADS1256_dsp.h.
+ *
+ * The CIC integrators run at the input rate in 64-bit wrap-around
+ * arithmetic: intermediate overflow cancels in the combs as long as the
+ * output fits, which ADS1256_DSP_MAX_CIC_BITS guarantees. Everything after
+ * the CIC runs at the decimated rate, and the FIR is only evaluated for the
+ * samples it outputs.
+ */
+#include "ADS1256_dsp.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define ADS1256_DSP_NEON 1
+#endif
+
+/**
+ * @brief Fills a chain configuration with every stage off.
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_Dsp_DefaultChain(ads1256_dsp_chain_config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->cic_decimation = 1;
+    cfg->fir_decimation = 1;
+}
+
+/**
+ * @brief Initializes a DSP stage with every channel passing through.
+ * @param dsp DSP stage.
+ */
+void ADS1256_Dsp_Init(ads1256_dsp_t *dsp)
+{
+    memset(dsp, 0, sizeof(*dsp));
+}
+
+/**
+ * @brief Clears the filter state of one chain.
+ * @param chain Chain to clear.
+ */
+static void ADS1256_Dsp_ResetChain(ads1256_dsp_chain_t *chain)
+{
+    chain->median_pos = chain->median_fill = 0;
+    memset(chain->integrator, 0, sizeof(chain->integrator));
+    memset(chain->comb, 0, sizeof(chain->comb));
+    chain->cic_count = 0;
+    memset(chain->fir_hist, 0, sizeof(chain->fir_hist));
+    chain->fir_pos = chain->fir_count = 0;
+    chain->avg_sum = 0;
+    chain->avg_pos = chain->avg_fill = 0;
+}
+
+/**
+ * @brief Clears the filter state of every channel, keeping the chains.
+ * @param dsp DSP stage.
+ */
+void ADS1256_Dsp_Reset(ads1256_dsp_t *dsp)
+{
+    // The output sequence keeps counting, so a restarted stream shows no spurious gap
+    for (int c = 0; c < ADS1256_DSP_MAX_CHANNELS; c++) ADS1256_Dsp_ResetChain(&dsp->chains[c]);
+}
+
+/**
+ * @brief Designs a linear-phase CIC compensator.
+ * @param coeffs Output, `taps` Q30 coefficients.
+ * @param taps Number of taps.
+ * @param order CIC stages.
+ * @param decimation CIC rate change.
+ * @param passband Passband edge as a fraction of the CIC output rate.
+ */
+void ADS1256_Dsp_DesignCicCompensator(int32_t *coeffs, UBYTE taps, UBYTE order, UWORD decimation, float passband)
+{
+    const int grid = 1024; // Integration steps over the passband
+    double h[ADS1256_DSP_MAX_FIR_TAPS];
+    double center = (taps - 1) / 2.0;
+    double sum = 0.0;
+
+    if (taps == 0 || taps > ADS1256_DSP_MAX_FIR_TAPS) return;
+    if (passband > 0.5f) passband = 0.5f;
+
+    for (int n = 0; n < taps; n++) {
+        double acc = 0.0;
+        // Inverse of the normalized CIC response, integrated with the midpoint rule
+        for (int k = 0; k < grid; k++) {
+            double f = (k + 0.5) * passband / grid;
+            double resp = (f > 0.0) ? sin(M_PI * f) / (decimation * sin(M_PI * f / decimation)) : 1.0;
+            acc += pow(fabs(resp), -(double)order) * cos(2.0 * M_PI * f * (n - center));
+        }
+        double window = (taps > 1) ? 0.54 - 0.46 * cos(2.0 * M_PI * n / (taps - 1)) : 1.0;
+        h[n] = acc * window;
+        sum += h[n];
+    }
+    for (int n = 0; n < taps; n++) {
+        coeffs[n] = (int32_t)lrint(h[n] / sum * (double)(1 << ADS1256_DSP_FIR_Q));
+    }
+}
+
+/**
+ * @brief Sets (or removes) the chain of one channel and clears its state.
+ * @param dsp DSP stage.
+ * @param channel Channel label.
+ * @param cfg Chain configuration, or NULL for pass-through.
+ * @return ADS1256_OK on success, ADS1256_ERROR on an invalid configuration.
+ */
+UBYTE ADS1256_Dsp_SetChain(ads1256_dsp_t *dsp, UBYTE channel, const ads1256_dsp_chain_config_t *cfg)
+{
+    if (!dsp || channel >= ADS1256_DSP_MAX_CHANNELS) return ADS1256_ERROR;
+
+    ads1256_dsp_chain_t *chain = &dsp->chains[channel];
+    if (!cfg) {
+        memset(chain, 0, sizeof(*chain));
+        return ADS1256_OK;
+    }
+
+    double cic_bits = cfg->cic_order ? cfg->cic_order * log2((double)cfg->cic_decimation) : 0.0;
+    if ((cfg->median && (cfg->median < 3 || cfg->median > ADS1256_DSP_MAX_MEDIAN || !(cfg->median & 1))) ||
+        cfg->cic_order > ADS1256_DSP_MAX_CIC_ORDER || (cfg->cic_order && cfg->cic_decimation < 2) ||
+        cic_bits > ADS1256_DSP_MAX_CIC_BITS ||
+        cfg->fir_taps > ADS1256_DSP_MAX_FIR_TAPS || (cfg->fir_taps && cfg->fir_decimation == 0) ||
+        (cfg->fir_taps && !cfg->fir_coeffs && !cfg->cic_order) ||
+        cfg->average == 1 || cfg->average > ADS1256_DSP_MAX_AVERAGE) {
+        fprintf(stderr, "ADS1256_Dsp_SetChain: Invalid filter chain for channel %d\r\n", channel);
+        return ADS1256_ERROR;
+    }
+
+    memset(chain, 0, sizeof(*chain));
+    chain->config = *cfg;
+    if (!cfg->cic_order) chain->config.cic_decimation = 1;
+    if (!cfg->fir_taps) chain->config.fir_decimation = 1;
+
+    chain->cic_gain = 1;
+    for (UBYTE i = 0; i < cfg->cic_order; i++) chain->cic_gain *= cfg->cic_decimation;
+
+    if (cfg->fir_taps) {
+        int32_t taps[ADS1256_DSP_MAX_FIR_TAPS];
+        if (cfg->fir_coeffs) {
+            memcpy(taps, cfg->fir_coeffs, cfg->fir_taps * sizeof(int32_t));
+        } else {
+            // Keep the compensator's passband below the Nyquist limit of its own output
+            ADS1256_Dsp_DesignCicCompensator(taps, cfg->fir_taps, cfg->cic_order, cfg->cic_decimation,
+                                             0.4f / chain->config.fir_decimation);
+        }
+        for (UBYTE k = 0; k < cfg->fir_taps; k++) chain->fir_rev[k] = taps[cfg->fir_taps - 1 - k];
+        chain->config.fir_coeffs = chain->fir_rev;
+    }
+    chain->enabled = cfg->median || cfg->cic_order || cfg->fir_taps || cfg->average;
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Returns the total rate change of a channel.
+ * @param dsp DSP stage.
+ * @param channel Channel label.
+ * @return Input samples per output sample.
+ */
+UDOUBLE ADS1256_Dsp_Decimation(const ads1256_dsp_t *dsp, UBYTE channel)
+{
+    if (!dsp || channel >= ADS1256_DSP_MAX_CHANNELS || !dsp->chains[channel].enabled) return 1;
+    const ads1256_dsp_chain_config_t *cfg = &dsp->chains[channel].config;
+    return (UDOUBLE)cfg->cic_decimation * cfg->fir_decimation;
+}
+
+/**
+ * @brief Divides with rounding to nearest, halves away from zero.
+ * @param num Dividend.
+ * @param den Positive divisor.
+ * @return Rounded quotient.
+ */
+static inline int64_t ADS1256_Dsp_DivRound(int64_t num, int64_t den)
+{
+    return (num >= 0) ? (num + den / 2) / den : -((-num + den / 2) / den);
+}
+
+/**
+ * @brief Returns the median of the current window.
+ * @param chain Chain with a median stage.
+ * @return Median of the samples seen so far (up to the window length).
+ */
+static int32_t ADS1256_Dsp_Median(const ads1256_dsp_chain_t *chain)
+{
+    int32_t sorted[ADS1256_DSP_MAX_MEDIAN];
+    UBYTE n = chain->median_fill;
+
+    // Insertion sort: windows are at most 15 samples
+    for (UBYTE i = 0; i < n; i++) {
+        int32_t v = chain->median_buf[i];
+        int j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+    return sorted[n / 2];
+}
+
+/**
+ * @brief Dot product of the FIR window and the reversed taps.
+ * @param x Oldest sample of the window, `taps` contiguous samples.
+ * @param c Reversed taps.
+ * @param taps Number of taps.
+ * @return Sum of products in Q30.
+ */
+static int64_t ADS1256_Dsp_Dot(const int32_t *x, const int32_t *c, UBYTE taps)
+{
+    int64_t acc = 0;
+    UBYTE k = 0;
+
+#ifdef ADS1256_DSP_NEON
+    int64x2_t vacc = vdupq_n_s64(0);
+    for (; k + 4 <= taps; k += 4) {
+        int32x4_t vx = vld1q_s32(x + k);
+        int32x4_t vc = vld1q_s32(c + k);
+        vacc = vmlal_s32(vacc, vget_low_s32(vx), vget_low_s32(vc));
+        vacc = vmlal_high_s32(vacc, vx, vc);
+    }
+    acc = vaddvq_s64(vacc);
+#endif
+    for (; k < taps; k++) acc += (int64_t)x[k] * c[k];
+    return acc;
+}
+
+/**
+ * @brief Runs one sample through a chain.
+ * @param chain Enabled chain.
+ * @param x Input code.
+ * @param y Receives the output code when one is produced.
+ * @return 1 if an output was produced, 0 if the sample was absorbed by decimation.
+ */
+static UBYTE ADS1256_Dsp_Step(ads1256_dsp_chain_t *chain, int32_t x, int32_t *y)
+{
+    const ads1256_dsp_chain_config_t *cfg = &chain->config;
+
+    if (cfg->median) {
+        chain->median_buf[chain->median_pos] = x;
+        chain->median_pos = (chain->median_pos + 1 == cfg->median) ? 0 : chain->median_pos + 1;
+        if (chain->median_fill < cfg->median) chain->median_fill++;
+        x = ADS1256_Dsp_Median(chain);
+    }
+
+    if (cfg->cic_order) {
+        int64_t v = x;
+        for (UBYTE s = 0; s < cfg->cic_order; s++) {
+            chain->integrator[s] = (int64_t)((uint64_t)chain->integrator[s] + (uint64_t)v);
+            v = chain->integrator[s];
+        }
+        if (++chain->cic_count < cfg->cic_decimation) return 0;
+        chain->cic_count = 0;
+        for (UBYTE s = 0; s < cfg->cic_order; s++) {
+            int64_t d = (int64_t)((uint64_t)v - (uint64_t)chain->comb[s]);
+            chain->comb[s] = v;
+            v = d;
+        }
+        x = (int32_t)ADS1256_Dsp_DivRound(v, chain->cic_gain);
+    }
+
+    if (cfg->fir_taps) {
+        chain->fir_hist[chain->fir_pos] = x;
+        chain->fir_hist[chain->fir_pos + cfg->fir_taps] = x;
+        chain->fir_pos = (chain->fir_pos + 1 == cfg->fir_taps) ? 0 : chain->fir_pos + 1;
+        if (++chain->fir_count < cfg->fir_decimation) return 0;
+        chain->fir_count = 0;
+        // fir_pos now indexes the oldest sample; the copy makes the window contiguous
+        int64_t acc = ADS1256_Dsp_Dot(&chain->fir_hist[chain->fir_pos], cfg->fir_coeffs, cfg->fir_taps);
+        x = (int32_t)((acc + (1LL << (ADS1256_DSP_FIR_Q - 1))) >> ADS1256_DSP_FIR_Q);
+    }
+
+    if (cfg->average) {
+        if (chain->avg_fill == cfg->average) {
+            chain->avg_sum -= chain->avg_buf[chain->avg_pos];
+        } else {
+            chain->avg_fill++;
+        }
+        chain->avg_buf[chain->avg_pos] = x;
+        chain->avg_sum += x;
+        chain->avg_pos = (chain->avg_pos + 1 == cfg->average) ? 0 : chain->avg_pos + 1;
+        x = (int32_t)ADS1256_Dsp_DivRound(chain->avg_sum, chain->avg_fill);
+    }
+
+    *y = x;
+    return 1;
+}
+
+/**
+ * @brief Filters a block of frames.
+ * @param dsp DSP stage.
+ * @param in Input frames.
+ * @param n Number of input frames.
+ * @param out Output frames, room for `n` (may alias `in`).
+ * @return Number of output frames.
+ */
+UDOUBLE ADS1256_Dsp_Process(ads1256_dsp_t *dsp, const ads1256_frame_t *in, UDOUBLE n, ads1256_frame_t *out)
+{
+    UDOUBLE count = 0;
+
+    for (UDOUBLE i = 0; i < n; i++) {
+        ads1256_frame_t f = in[i];
+        int32_t y = (int32_t)f.value;
+
+        if (f.channel < ADS1256_DSP_MAX_CHANNELS && dsp->chains[f.channel].enabled &&
+            !ADS1256_Dsp_Step(&dsp->chains[f.channel], (int32_t)f.value, &y)) {
+            continue;
+        }
+        f.value = (UDOUBLE)y;
+        f.sequence = dsp->sequence++;
+        out[count++] = f;
+    }
+    return count;
+}
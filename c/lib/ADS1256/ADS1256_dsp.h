@@ -0,0 +1,144 @@
+/**
+ * @file ADS1256_dsp.h
+ * @brief Fixed-point decimation and filtering of ADS1256 codes.
+ *
+ * Each channel label can have its own filter chain, applied in this order:
+ *
+ *   median -> CIC decimator -> FIR (optionally decimating) -> moving average
+ *
+ * Every stage is optional. The chain works on the sign-extended codes in
+ * integer arithmetic and its output stays in code units (DC gain 1), so
+ * ADS1256_RawToVoltage() and ADS1256_convert.h apply unchanged. Channels
+ * without a chain pass through.
+ *
+ * Attach an ads1256_dsp_t to ads1256_stream_config_t::dsp to run it on the
+ * acquisition thread before samples enter the ring: consumers then see only
+ * the decimated frames. A stream without a DSP stage does not call any of this.
+ */
+
+#ifndef _ADS1256_DSP_H_
+#define _ADS1256_DSP_H_
+
+#include "ADS1256.h"
+#include <stdint.h>
+
+/** @name Limits */
+#define ADS1256_DSP_MAX_CHANNELS  16  ///< Channel labels 0..15 can be filtered
+#define ADS1256_DSP_MAX_MEDIAN    15  ///< Largest median window (odd)
+#define ADS1256_DSP_MAX_CIC_ORDER 5   ///< Largest number of CIC stages
+#define ADS1256_DSP_MAX_CIC_BITS  39  ///< Limit on order * log2(decimation): 24 + 39 bits fit the 64-bit integrators
+#define ADS1256_DSP_MAX_FIR_TAPS  64
+#define ADS1256_DSP_MAX_AVERAGE   256 ///< Longest moving average
+#define ADS1256_DSP_FIR_Q         30  ///< Fractional bits of FIR coefficients
+
+/**
+ * @brief Filter chain of one channel. Fill with ADS1256_Dsp_DefaultChain().
+ */
+typedef struct {
+    UBYTE median;              ///< Median window on the input (odd, 3 .. ADS1256_DSP_MAX_MEDIAN), 0 = off
+    UBYTE cic_order;           ///< CIC stages (1 .. ADS1256_DSP_MAX_CIC_ORDER), 0 = off
+    UWORD cic_decimation;      ///< CIC rate change (>= 2)
+    UBYTE fir_taps;            ///< FIR length (1 .. ADS1256_DSP_MAX_FIR_TAPS), 0 = off
+    UBYTE fir_decimation;      ///< FIR rate change (1 = none)
+    const int32_t *fir_coeffs; ///< Q30 taps (copied), or NULL for a compensator of the CIC above
+    UWORD average;             ///< Moving-average length on the output (2 .. ADS1256_DSP_MAX_AVERAGE), 0 = off
+} ads1256_dsp_chain_config_t;
+
+/**
+ * @brief Filter state of one channel.
+ */
+typedef struct {
+    ads1256_dsp_chain_config_t config;              ///< Chain settings (fir_coeffs points at `fir_rev`)
+    UBYTE enabled;                                  ///< Non-zero when a chain is set
+    int32_t median_buf[ADS1256_DSP_MAX_MEDIAN];     ///< Median window, circular
+    UBYTE median_pos;
+    UBYTE median_fill;
+    int64_t integrator[ADS1256_DSP_MAX_CIC_ORDER];  ///< CIC integrators (wrap-around arithmetic)
+    int64_t comb[ADS1256_DSP_MAX_CIC_ORDER];        ///< CIC comb delays
+    int64_t cic_gain;                               ///< decimation ^ order
+    UWORD cic_count;
+    int32_t fir_rev[ADS1256_DSP_MAX_FIR_TAPS];      ///< Taps in reverse order, to match the delay line
+    int32_t fir_hist[2 * ADS1256_DSP_MAX_FIR_TAPS]; ///< Delay line, stored twice so a window is contiguous
+    UBYTE fir_pos;
+    UBYTE fir_count;
+    int32_t avg_buf[ADS1256_DSP_MAX_AVERAGE];       ///< Moving-average window, circular
+    int64_t avg_sum;
+    UWORD avg_pos;
+    UWORD avg_fill;
+} ads1256_dsp_chain_t;
+
+/**
+ * @brief DSP stage: one chain per channel label.
+ */
+typedef struct {
+    ads1256_dsp_chain_t chains[ADS1256_DSP_MAX_CHANNELS]; ///< Indexed by channel label
+    uint64_t sequence;                                    ///< Sequence number of the next output frame
+} ads1256_dsp_t;
+
+/**
+ * @brief Fills a chain configuration with every stage off.
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_Dsp_DefaultChain(ads1256_dsp_chain_config_t *cfg);
+
+/**
+ * @brief Initializes a DSP stage with every channel passing through.
+ * @param dsp DSP stage.
+ */
+void ADS1256_Dsp_Init(ads1256_dsp_t *dsp);
+
+/**
+ * @brief Sets (or with NULL, removes) the chain of one channel and clears its state.
+ *
+ * Not safe while a stream runs the stage; configure before ADS1256_Stream_Start().
+ * @param dsp DSP stage.
+ * @param channel Channel label (< ADS1256_DSP_MAX_CHANNELS).
+ * @param cfg Chain configuration, or NULL for pass-through.
+ * @return ADS1256_OK on success, ADS1256_ERROR on an invalid configuration.
+ */
+UBYTE ADS1256_Dsp_SetChain(ads1256_dsp_t *dsp, UBYTE channel, const ads1256_dsp_chain_config_t *cfg);
+
+/**
+ * @brief Clears the filter state of every channel, keeping the chains.
+ *
+ * The output sequence counter is kept. ADS1256_Stream_Start() calls this.
+ * @param dsp DSP stage.
+ */
+void ADS1256_Dsp_Reset(ads1256_dsp_t *dsp);
+
+/**
+ * @brief Returns the total rate change of a channel.
+ * @param dsp DSP stage.
+ * @param channel Channel label.
+ * @return Input samples per output sample (1 for pass-through).
+ */
+UDOUBLE ADS1256_Dsp_Decimation(const ads1256_dsp_t *dsp, UBYTE channel);
+
+/**
+ * @brief Filters a block of frames.
+ *
+ * Output frames carry the channel label and timestamp of the input frame
+ * that completed them, and sequence numbers counted by the stage, so a
+ * consumer still sees consecutive numbers.
+ * @param dsp DSP stage.
+ * @param in Input frames.
+ * @param n Number of input frames.
+ * @param out Output frames, room for `n` (may alias `in`).
+ * @return Number of output frames.
+ */
+UDOUBLE ADS1256_Dsp_Process(ads1256_dsp_t *dsp, const ads1256_frame_t *in, UDOUBLE n, ads1256_frame_t *out);
+
+/**
+ * @brief Designs a linear-phase FIR that flattens the passband droop of a CIC.
+ *
+ * Windowed (Hamming) design of 1 / |H_cic(f)| up to `passband`, 0 above,
+ * normalized to DC gain 1.
+ * @param coeffs Output, `taps` Q30 coefficients.
+ * @param taps Number of taps (1 .. ADS1256_DSP_MAX_FIR_TAPS).
+ * @param order CIC stages.
+ * @param decimation CIC rate change.
+ * @param passband Passband edge as a fraction of the CIC output rate (0 .. 0.5).
+ */
+void ADS1256_Dsp_DesignCicCompensator(int32_t *coeffs, UBYTE taps, UBYTE order, UWORD decimation, float passband);
+
+#endif // _ADS1256_DSP_H_
@@ -0,0 +1,716 @@
+/**
+ * @file ADS1256_metrics.c
+ * @brief Exporter thread: samples the acquisition counters and serves them as
+ *        Prometheus text or pushes them as StatsD datagrams.
+ *
+ * Everything here runs on the exporter thread or under `lock`; the
+ * acquisition side is only ever read, with relaxed atomic loads.
+ */
+
+#define _GNU_SOURCE // For syscall(SYS_gettid)
+#include "ADS1256_metrics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+#define ADS1256_METRICS_IDLE_MS      100   ///< Longest sleep, bounds the time ADS1256_Metrics_Stop() takes
+#define ADS1256_METRICS_IO_TIMEOUT_S 1     ///< A scraper slower than this is dropped
+#define ADS1256_METRICS_REQUEST_MAX  1024
+#define ADS1256_METRICS_STATSD_MTU   1432  ///< Payload that fits one Ethernet frame with IPv6/UDP headers
+#define ADS1256_METRICS_TEXT_INITIAL 16384
+
+/**
+ * @brief One exported counter.
+ */
+typedef struct {
+    const char *name;   ///< Base name; Prometheus appends "_total"
+    const char *help;   ///< Prometheus HELP text
+    size_t offset;      ///< Offset in performance_metrics_t, or of an ads1256_stream_t field when `stream` is set
+    UBYTE stream;       ///< Non-zero for an _Atomic uint64_t of the stream, zero for an _Atomic unsigned long of the device
+} ADS1256_MetricsCounter;
+
+static const ADS1256_MetricsCounter counters[ADS1256_METRICS_NUM_COUNTERS] = {
+    { "samples", "Samples acquired", offsetof(performance_metrics_t, total_samples_acquired), 0 },
+    { "scans", "N-channel scans completed", offsetof(performance_metrics_t, total_n_channel_scans), 0 },
+    { "drdy_timeouts", "DRDY waits that ran into the timeout", offsetof(performance_metrics_t, drdy_timeouts), 0 },
+    { "deadline_misses", "Operations cut short by the deadline", offsetof(performance_metrics_t, deadline_misses), 0 },
+    { "spi_errors", "SPI transfers that failed", offsetof(performance_metrics_t, spi_errors), 0 },
+    { "gpio_errors", "DRDY or reset line accesses that failed", offsetof(performance_metrics_t, gpio_errors), 0 },
+    { "resets", "Chip resets started", offsetof(performance_metrics_t, resets), 0 },
+    { "warm_starts", "Initializations that took over a running chip", offsetof(performance_metrics_t, warm_starts), 0 },
+    { "ring_overruns", "Samples dropped because the stream ring was full", offsetof(ads1256_stream_t, overruns), 1 },
+    { "stream_errors", "Scans the stream lost to DRDY timeouts or SPI/GPIO errors", offsetof(ads1256_stream_t, drdy_errors), 1 },
+};
+
+/**
+ * @brief One exported latency histogram.
+ */
+typedef struct {
+    const char *name;   ///< Base name; Prometheus appends "_seconds"
+    const char *help;   ///< Prometheus HELP text
+    size_t offset;      ///< Offset of the latency_hist_t in performance_metrics_t
+} ADS1256_MetricsHist;
+
+static const ADS1256_MetricsHist hists[] = {
+    { "drdy_wait", "Time spent waiting for DRDY", offsetof(performance_metrics_t, drdy_wait) },
+    { "spi_transaction", "SPI transaction duration, CS assert to deassert", offsetof(performance_metrics_t, spi_transaction) },
+    { "scan_period", "Time between consecutive completed scans", offsetof(performance_metrics_t, scan_period) },
+};
+#define ADS1256_METRICS_NUM_HISTS ((int)(sizeof(hists) / sizeof(hists[0])))
+
+// Prometheus bucket bounds, 1-2-5 steps from 1 us to 1 s
+static const uint64_t bucket_ns[] = {
+    1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000,
+    1000000, 2000000, 5000000, 10000000, 20000000, 50000000, 100000000, 200000000, 500000000, 1000000000,
+};
+#define ADS1256_METRICS_NUM_BUCKETS ((unsigned)(sizeof(bucket_ns) / sizeof(bucket_ns[0])))
+
+/**
+ * @brief Fills a configuration with defaults.
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_Metrics_DefaultConfig(ads1256_metrics_config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->mode = ADS1256_METRICS_PROMETHEUS;
+    cfg->host = "127.0.0.1";
+    cfg->port = ADS1256_METRICS_DEFAULT_PORT;
+    cfg->prefix = "ads1256";
+    cfg->interval_ms = ADS1256_METRICS_DEFAULT_INTERVAL_MS;
+    cfg->nice = ADS1256_METRICS_DEFAULT_NICE;
+}
+
+/**
+ * @brief Returns CLOCK_MONOTONIC in nanoseconds.
+ * @return Current time.
+ */
+static uint64_t ADS1256_Metrics_NowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Reads one counter of a source.
+ * @param src Source.
+ * @param c Counter.
+ * @return Current value (0 for a stream counter of a source without a stream).
+ */
+static uint64_t ADS1256_Metrics_Read(const ads1256_metrics_source_t *src, const ADS1256_MetricsCounter *c)
+{
+    if (c->stream) {
+        if (!src->stream) return 0;
+        return atomic_load_explicit((_Atomic uint64_t *)((char *)src->stream + c->offset), memory_order_relaxed);
+    }
+    return atomic_load_explicit((_Atomic unsigned long *)((char *)&src->dev->metrics + c->offset), memory_order_relaxed);
+}
+
+/**
+ * @brief Returns one histogram of a source.
+ * @param src Source.
+ * @param h Histogram.
+ * @return The device's histogram.
+ */
+static const latency_hist_t *ADS1256_Metrics_Hist(const ads1256_metrics_source_t *src, const ADS1256_MetricsHist *h)
+{
+    return (const latency_hist_t *)((const char *)&src->dev->metrics + h->offset);
+}
+
+/**
+ * @brief Returns the difference of two counter readings.
+ * @param now Current reading.
+ * @param before Earlier reading.
+ * @return `now - before`, or `now` if the counter was reset in between.
+ */
+static uint64_t ADS1256_Metrics_Delta(uint64_t now, uint64_t before)
+{
+    return now >= before ? now - before : now;
+}
+
+/**
+ * @brief Takes a new counter sample of every source and updates the rate gauges.
+ *
+ * Called with `lock` held.
+ * @param m Exporter object.
+ */
+static void ADS1256_Metrics_Sample(ads1256_metrics_t *m)
+{
+    uint64_t now = ADS1256_Metrics_NowNs();
+
+    for (UBYTE s = 0; s < m->num_sources; s++) {
+        ads1256_metrics_source_t *src = &m->sources[s];
+        uint64_t cur[ADS1256_METRICS_NUM_COUNTERS];
+
+        for (int c = 0; c < ADS1256_METRICS_NUM_COUNTERS; c++) cur[c] = ADS1256_Metrics_Read(src, &counters[c]);
+        if (src->sampled_ns != 0 && now > src->sampled_ns) {
+            double dt = (double)(now - src->sampled_ns) / 1e9;
+            src->sps = (double)ADS1256_Metrics_Delta(cur[0], src->counters[0]) / dt;
+            src->sps_per_channel = (double)ADS1256_Metrics_Delta(cur[1], src->counters[1]) / dt;
+        }
+        memcpy(src->counters, cur, sizeof(cur));
+        src->sampled_ns = now;
+    }
+}
+
+/**
+ * @brief Returns the ring fill of a source's stream.
+ * @param src Source.
+ * @return Samples waiting in the ring, 0 without a stream.
+ */
+static uint64_t ADS1256_Metrics_RingFill(const ads1256_metrics_source_t *src)
+{
+    if (!src->stream) return 0;
+    uint64_t tail = atomic_load_explicit(&src->stream->tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&src->stream->head, memory_order_relaxed);
+    return head > tail ? head - tail : 0;
+}
+
+/**
+ * @brief Returns the efficiency of a source over the last interval.
+ * @param src Source.
+ * @return Per-channel rate over the theoretical rate, 0 if unknown.
+ */
+static double ADS1256_Metrics_Efficiency(const ads1256_metrics_source_t *src)
+{
+    double theoretical = src->dev->metrics.theoretical_sps_per_channel;
+    return theoretical > 0 ? src->sps_per_channel / theoretical : 0.0;
+}
+
+/**
+ * @brief Appends formatted text to the output buffer, growing it as needed.
+ * @param m Exporter object.
+ * @param fmt printf() format.
+ * @return 0 on success, -1 if the buffer could not grow.
+ */
+static int ADS1256_Metrics_Printf(ads1256_metrics_t *m, const char *fmt, ...)
+{
+    for (;;) {
+        va_list ap;
+        size_t room = m->text_cap - m->text_len;
+
+        va_start(ap, fmt);
+        int n = vsnprintf(m->text + m->text_len, room, fmt, ap);
+        va_end(ap);
+        if (n < 0) return -1;
+        if ((size_t)n < room) {
+            m->text_len += (size_t)n;
+            return 0;
+        }
+
+        char *grown = realloc(m->text, m->text_cap * 2);
+        if (!grown) return -1;
+        m->text = grown;
+        m->text_cap *= 2;
+    }
+}
+
+/**
+ * @brief Renders every source in the Prometheus text exposition format.
+ *
+ * Called with `lock` held. Each metric family is emitted once, with one
+ * line per source, as the format requires.
+ * @param m Exporter object.
+ * @return 0 on success, -1 if the output buffer could not grow.
+ */
+static int ADS1256_Metrics_RenderPrometheus(ads1256_metrics_t *m)
+{
+    const char *p = m->prefix;
+    int err = 0;
+
+    m->text_len = 0;
+    m->text[0] = '\0';
+
+    for (int c = 0; c < ADS1256_METRICS_NUM_COUNTERS; c++) {
+        err |= ADS1256_Metrics_Printf(m, "# HELP %s_%s_total %s.\n# TYPE %s_%s_total counter\n",
+                                      p, counters[c].name, counters[c].help, p, counters[c].name);
+        for (UBYTE s = 0; s < m->num_sources; s++) {
+            err |= ADS1256_Metrics_Printf(m, "%s_%s_total{device=\"%s\"} %llu\n", p, counters[c].name,
+                                          m->sources[s].label, (unsigned long long)m->sources[s].counters[c]);
+        }
+    }
+
+    static const struct { const char *name; const char *help; } gauges[] = {
+        { "sps", "Samples per second over the last interval" },
+        { "sps_per_channel", "Samples per second of each scanned channel over the last interval" },
+        { "theoretical_sps_per_channel", "Data rate of a single channel at the configured DRATE" },
+        { "efficiency_ratio", "Achieved per-channel rate over the theoretical rate" },
+        { "ring_fill_samples", "Samples waiting in the stream ring" },
+    };
+    for (int g = 0; g < (int)(sizeof(gauges) / sizeof(gauges[0])); g++) {
+        err |= ADS1256_Metrics_Printf(m, "# HELP %s_%s %s.\n# TYPE %s_%s gauge\n",
+                                      p, gauges[g].name, gauges[g].help, p, gauges[g].name);
+        for (UBYTE s = 0; s < m->num_sources; s++) {
+            const ads1256_metrics_source_t *src = &m->sources[s];
+            double value = 0.0;
+            switch (g) {
+                case 0: value = src->sps; break;
+                case 1: value = src->sps_per_channel; break;
+                case 2: value = src->dev->metrics.theoretical_sps_per_channel; break;
+                case 3: value = ADS1256_Metrics_Efficiency(src); break;
+                case 4: value = (double)ADS1256_Metrics_RingFill(src); break;
+            }
+            err |= ADS1256_Metrics_Printf(m, "%s_%s{device=\"%s\"} %.6g\n", p, gauges[g].name, src->label, value);
+        }
+    }
+
+    for (int h = 0; h < ADS1256_METRICS_NUM_HISTS; h++) {
+        err |= ADS1256_Metrics_Printf(m, "# HELP %s_%s_seconds %s.\n# TYPE %s_%s_seconds histogram\n",
+                                      p, hists[h].name, hists[h].help, p, hists[h].name);
+        for (UBYTE s = 0; s < m->num_sources; s++) {
+            const ads1256_metrics_source_t *src = &m->sources[s];
+            const latency_hist_t *hist = ADS1256_Metrics_Hist(src, &hists[h]);
+            uint64_t cumulative[ADS1256_METRICS_NUM_BUCKETS];
+            uint64_t total = LatencyHist_Cumulative(hist, bucket_ns, ADS1256_METRICS_NUM_BUCKETS, cumulative);
+            uint64_t sum_ns = atomic_load_explicit(&hist->sum_ns, memory_order_relaxed);
+
+            for (unsigned b = 0; b < ADS1256_METRICS_NUM_BUCKETS; b++) {
+                err |= ADS1256_Metrics_Printf(m, "%s_%s_seconds_bucket{device=\"%s\",le=\"%g\"} %llu\n", p,
+                                              hists[h].name, src->label, (double)bucket_ns[b] / 1e9,
+                                              (unsigned long long)cumulative[b]);
+            }
+            err |= ADS1256_Metrics_Printf(m, "%s_%s_seconds_bucket{device=\"%s\",le=\"+Inf\"} %llu\n"
+                                             "%s_%s_seconds_sum{device=\"%s\"} %.9f\n"
+                                             "%s_%s_seconds_count{device=\"%s\"} %llu\n",
+                                          p, hists[h].name, src->label, (unsigned long long)total,
+                                          p, hists[h].name, src->label, (double)sum_ns / 1e9,
+                                          p, hists[h].name, src->label, (unsigned long long)total);
+        }
+    }
+    return err ? -1 : 0;
+}
+
+/**
+ * @brief Writes a whole buffer to a socket.
+ * @param fd Connected socket with a send timeout.
+ * @param data Bytes to send.
+ * @param len Number of bytes.
+ * @return 0 on success, -1 on error or timeout.
+ */
+static int ADS1256_Metrics_SendAll(int fd, const char *data, size_t len)
+{
+    while (len > 0) {
+        ssize_t w = send(fd, data, len, MSG_NOSIGNAL);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += w;
+        len -= (size_t)w;
+    }
+    return 0;
+}
+
+/**
+ * @brief Answers one HTTP request on an accepted connection and closes it.
+ * @param m Exporter object in Prometheus mode.
+ * @param fd Accepted connection.
+ */
+static void ADS1256_Metrics_Serve(ads1256_metrics_t *m, int fd)
+{
+    struct timeval tv = { ADS1256_METRICS_IO_TIMEOUT_S, 0 };
+    char req[ADS1256_METRICS_REQUEST_MAX];
+    char header[160];
+    size_t len = 0;
+    int status = 200;
+
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    // Only the request line matters; read until the end of the headers or a full buffer
+    while (len < sizeof(req) - 1) {
+        ssize_t r = recv(fd, req + len, sizeof(req) - 1 - len, 0);
+        if (r <= 0) break;
+        len += (size_t)r;
+        req[len] = '\0';
+        if (strstr(req, "\r\n\r\n") || strstr(req, "\n\n")) break;
+    }
+    req[len] = '\0';
+
+    if (strncmp(req, "GET ", 4) != 0) {
+        status = 405;
+    } else if (strncmp(req + 4, "/metrics", 8) != 0 || (req[12] != ' ' && req[12] != '?')) {
+        status = 404;
+    }
+
+    const char *body = "";
+    size_t body_len = 0;
+    pthread_mutex_lock(&m->lock);
+    if (status == 200) {
+        if (ADS1256_Metrics_RenderPrometheus(m) == 0) {
+            body = m->text;
+            body_len = m->text_len;
+        } else {
+            status = 500;
+        }
+    }
+    int n = snprintf(header, sizeof(header),
+                     "HTTP/1.1 %d %s\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %zu\r\n"
+                     "Connection: close\r\n\r\n",
+                     status, status == 200 ? "OK" : status == 404 ? "Not Found" :
+                             status == 405 ? "Method Not Allowed" : "Internal Server Error", body_len);
+    int failed = ADS1256_Metrics_SendAll(fd, header, (size_t)n) != 0 ||
+                 ADS1256_Metrics_SendAll(fd, body, body_len) != 0;
+    pthread_mutex_unlock(&m->lock);
+
+    if (failed || status != 200) {
+        atomic_fetch_add_explicit(&m->errors, 1, memory_order_relaxed);
+        Debug("ADS1256_Metrics: Request answered with %d%s\n", status, failed ? " (send failed)" : "");
+    } else {
+        atomic_fetch_add_explicit(&m->exports, 1, memory_order_relaxed);
+    }
+    close(fd);
+}
+
+/**
+ * @brief Sends the pending StatsD datagram.
+ * @param m Exporter object in StatsD mode; `text` holds the datagram.
+ */
+static void ADS1256_Metrics_Flush(ads1256_metrics_t *m)
+{
+    if (m->text_len == 0) return;
+    if (sendto(m->fd, m->text, m->text_len, MSG_DONTWAIT, (struct sockaddr *)&m->dest, m->dest_len) < 0) {
+        atomic_fetch_add_explicit(&m->errors, 1, memory_order_relaxed);
+    }
+    m->text_len = 0;
+}
+
+/**
+ * @brief Adds one StatsD line, sending the datagram first if the line would not fit.
+ * @param m Exporter object in StatsD mode.
+ * @param src Source the metric belongs to.
+ * @param name Metric name.
+ * @param value Formatted value.
+ * @param type StatsD type ("c" or "g").
+ */
+static void ADS1256_Metrics_StatsdLine(ads1256_metrics_t *m, const ads1256_metrics_source_t *src, const char *name,
+                                       const char *value, const char *type)
+{
+    char line[160];
+    int n = snprintf(line, sizeof(line), "%s.%s.%s:%s|%s\n", m->prefix, src->label, name, value, type);
+
+    if (n <= 0 || (size_t)n >= sizeof(line)) return;
+    if (m->text_len + (size_t)n > ADS1256_METRICS_STATSD_MTU) ADS1256_Metrics_Flush(m);
+    memcpy(m->text + m->text_len, line, (size_t)n);
+    m->text_len += (size_t)n;
+}
+
+/**
+ * @brief Pushes counter deltas, gauges and latency percentiles of every source.
+ *
+ * Called with `lock` held, right after ADS1256_Metrics_Sample().
+ * @param m Exporter object in StatsD mode.
+ */
+static void ADS1256_Metrics_PushStatsd(ads1256_metrics_t *m)
+{
+    char value[32];
+
+    m->text_len = 0;
+    for (UBYTE s = 0; s < m->num_sources; s++) {
+        ads1256_metrics_source_t *src = &m->sources[s];
+
+        for (int c = 0; c < ADS1256_METRICS_NUM_COUNTERS; c++) {
+            uint64_t delta = ADS1256_Metrics_Delta(src->counters[c], src->pushed[c]);
+            src->pushed[c] = src->counters[c];
+            if (delta == 0 && c > 1) continue; // Error counters are quiet until something happens
+            snprintf(value, sizeof(value), "%llu", (unsigned long long)delta);
+            ADS1256_Metrics_StatsdLine(m, src, counters[c].name, value, "c");
+        }
+
+        snprintf(value, sizeof(value), "%.6g", src->sps);
+        ADS1256_Metrics_StatsdLine(m, src, "sps", value, "g");
+        snprintf(value, sizeof(value), "%.6g", src->sps_per_channel);
+        ADS1256_Metrics_StatsdLine(m, src, "sps_per_channel", value, "g");
+        snprintf(value, sizeof(value), "%.6g", src->dev->metrics.theoretical_sps_per_channel);
+        ADS1256_Metrics_StatsdLine(m, src, "theoretical_sps_per_channel", value, "g");
+        snprintf(value, sizeof(value), "%.6g", ADS1256_Metrics_Efficiency(src));
+        ADS1256_Metrics_StatsdLine(m, src, "efficiency_ratio", value, "g");
+        if (src->stream) {
+            snprintf(value, sizeof(value), "%llu", (unsigned long long)ADS1256_Metrics_RingFill(src));
+            ADS1256_Metrics_StatsdLine(m, src, "ring_fill_samples", value, "g");
+        }
+
+        static const struct { const char *suffix; double percentile; } points[] = {
+            { "p50_us", 50.0 }, { "p99_us", 99.0 }, { "max_us", 100.0 },
+        };
+        for (int h = 0; h < ADS1256_METRICS_NUM_HISTS; h++) {
+            const latency_hist_t *hist = ADS1256_Metrics_Hist(src, &hists[h]);
+            if (LatencyHist_Count(hist) == 0) continue;
+            for (int i = 0; i < (int)(sizeof(points) / sizeof(points[0])); i++) {
+                char name[64];
+                snprintf(name, sizeof(name), "%s.%s", hists[h].name, points[i].suffix);
+                snprintf(value, sizeof(value), "%.1f", LatencyHist_Percentile(hist, points[i].percentile) / 1000.0);
+                ADS1256_Metrics_StatsdLine(m, src, name, value, "g");
+            }
+        }
+    }
+    ADS1256_Metrics_Flush(m);
+    atomic_fetch_add_explicit(&m->exports, 1, memory_order_relaxed);
+}
+
+/**
+ * @brief Exporter thread body: sample every interval, answer scrapes in between.
+ * @param arg The ads1256_metrics_t being run.
+ * @return NULL.
+ */
+static void *ADS1256_Metrics_Thread(void *arg)
+{
+    ads1256_metrics_t *m = (ads1256_metrics_t *)arg;
+    const uint64_t interval_ns = (uint64_t)m->config.interval_ms * 1000000ULL;
+    uint64_t next = ADS1256_Metrics_NowNs();
+
+    // Per-thread nice on Linux; keeps scrapes from competing with the acquisition threads
+    if (m->config.nice != 0 && setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), m->config.nice) != 0) {
+        Debug("ADS1256_Metrics: nice %d not applied: %s\n", m->config.nice, strerror(errno));
+    }
+
+    while (atomic_load_explicit(&m->running, memory_order_relaxed)) {
+        uint64_t now = ADS1256_Metrics_NowNs();
+        if (now >= next) {
+            pthread_mutex_lock(&m->lock);
+            ADS1256_Metrics_Sample(m);
+            if (m->config.mode == ADS1256_METRICS_STATSD) ADS1256_Metrics_PushStatsd(m);
+            pthread_mutex_unlock(&m->lock);
+            next += interval_ns;
+            if (next <= now) next = now + interval_ns; // Fell behind; do not burst to catch up
+        }
+
+        uint64_t wait_ms = (next - now + 999999) / 1000000;
+        if (wait_ms > ADS1256_METRICS_IDLE_MS) wait_ms = ADS1256_METRICS_IDLE_MS;
+        if (m->config.mode == ADS1256_METRICS_PROMETHEUS) {
+            struct pollfd pfd = { .fd = m->fd, .events = POLLIN };
+            if (poll(&pfd, 1, (int)wait_ms) > 0) {
+                int fd = accept4(m->fd, NULL, NULL, SOCK_CLOEXEC);
+                if (fd >= 0) ADS1256_Metrics_Serve(m, fd);
+            }
+        } else {
+            poll(NULL, 0, (int)wait_ms);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Opens the listen socket (Prometheus) or the UDP socket (StatsD).
+ *
+ * `host` is the address the Prometheus endpoint binds to, or the StatsD
+ * destination.
+ * @param m Exporter object with `config` set.
+ * @return ADS1256_OK on success, ADS1256_ERROR otherwise.
+ */
+static UBYTE ADS1256_Metrics_Open(ads1256_metrics_t *m)
+{
+    const ads1256_metrics_config_t *cfg = &m->config;
+    UBYTE listen_mode = cfg->mode == ADS1256_METRICS_PROMETHEUS;
+    int type = listen_mode ? SOCK_STREAM : SOCK_DGRAM;
+    int one = 1;
+
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = type, .ai_flags = listen_mode ? AI_PASSIVE : 0 };
+    struct addrinfo *res;
+    char port[8];
+    snprintf(port, sizeof(port), "%u", cfg->port);
+    int err = getaddrinfo(cfg->host, port, &hints, &res);
+    if (err != 0) {
+        fprintf(stderr, "ADS1256_Metrics: Cannot resolve %s: %s\r\n", cfg->host, gai_strerror(err));
+        return ADS1256_ERROR;
+    }
+    m->fd = socket(res->ai_family, type | (listen_mode ? SOCK_NONBLOCK : 0) | SOCK_CLOEXEC, 0);
+    if (m->fd < 0) {
+        perror("ADS1256_Metrics: socket failed");
+        freeaddrinfo(res);
+        return ADS1256_ERROR;
+    }
+    if (listen_mode) {
+        setsockopt(m->fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (bind(m->fd, res->ai_addr, res->ai_addrlen) != 0 || listen(m->fd, 4) != 0) {
+            fprintf(stderr, "ADS1256_Metrics: Cannot listen on %s port %u: %s\r\n", cfg->host, cfg->port,
+                    strerror(errno));
+            freeaddrinfo(res);
+            return ADS1256_ERROR;
+        }
+        freeaddrinfo(res);
+        return ADS1256_OK;
+    }
+    memcpy(&m->dest, res->ai_addr, res->ai_addrlen);
+    m->dest_len = res->ai_addrlen;
+    freeaddrinfo(res);
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Opens the socket and starts the exporter thread.
+ * @param m Exporter object.
+ * @param cfg Configuration (copied).
+ * @return ADS1256_OK on success, ADS1256_ERROR on failure.
+ */
+UBYTE ADS1256_Metrics_Start(ads1256_metrics_t *m, const ads1256_metrics_config_t *cfg)
+{
+    if (!m || !cfg || cfg->interval_ms == 0 || !cfg->prefix || !cfg->prefix[0] ||
+        strlen(cfg->prefix) >= ADS1256_METRICS_PREFIX_MAX || !cfg->host) {
+        fprintf(stderr, "ADS1256_Metrics_Start: Invalid configuration\r\n");
+        return ADS1256_ERROR;
+    }
+
+    memset(m, 0, sizeof(*m));
+    m->config = *cfg;
+    strcpy(m->prefix, cfg->prefix);
+    m->config.prefix = m->prefix;
+    m->fd = -1;
+    atomic_init(&m->exports, 0);
+    atomic_init(&m->errors, 0);
+    atomic_init(&m->running, 1);
+
+    // StatsD only ever holds one datagram; the Prometheus text grows with the sources
+    m->text_cap = ADS1256_METRICS_TEXT_INITIAL;
+    m->text = malloc(m->text_cap);
+    if (!m->text) {
+        perror("ADS1256_Metrics_Start: Failed to allocate the output buffer");
+        return ADS1256_ERROR;
+    }
+    if (ADS1256_Metrics_Open(m) != ADS1256_OK) {
+        if (m->fd >= 0) close(m->fd);
+        free(m->text);
+        m->text = NULL;
+        return ADS1256_ERROR;
+    }
+    pthread_mutex_init(&m->lock, NULL);
+
+    int err = pthread_create(&m->thread, NULL, ADS1256_Metrics_Thread, m);
+    if (err != 0) {
+        fprintf(stderr, "ADS1256_Metrics_Start: Failed to create thread: %s\r\n", strerror(err));
+        pthread_mutex_destroy(&m->lock);
+        close(m->fd);
+        free(m->text);
+        m->text = NULL;
+        return ADS1256_ERROR;
+    }
+    m->thread_started = 1;
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Copies a label, replacing characters that Prometheus label values
+ *        or StatsD names would need escaped.
+ * @param out Output of ADS1256_METRICS_LABEL_MAX bytes.
+ * @param label Label to copy (truncated if too long).
+ */
+static void ADS1256_Metrics_Sanitize(char *out, const char *label)
+{
+    size_t i;
+    for (i = 0; label[i] && i < ADS1256_METRICS_LABEL_MAX - 1; i++) {
+        char ch = label[i];
+        int ok = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') ||
+                 ch == '_' || ch == '-';
+        out[i] = ok ? ch : '_';
+    }
+    out[i] = '\0';
+}
+
+/**
+ * @brief Finds a source by its sanitized label. Called with `lock` held.
+ * @param m Exporter object.
+ * @param label Sanitized label.
+ * @return Index of the source, or -1.
+ */
+static int ADS1256_Metrics_Find(const ads1256_metrics_t *m, const char *label)
+{
+    for (int s = 0; s < m->num_sources; s++) {
+        if (strcmp(m->sources[s].label, label) == 0) return s;
+    }
+    return -1;
+}
+
+/**
+ * @brief Registers a source.
+ * @param m Running exporter.
+ * @param label Source name.
+ * @param dev Device, or NULL for the stream's (or default) device.
+ * @param stream Stream, or NULL.
+ * @return ADS1256_OK on success, ADS1256_ERROR otherwise.
+ */
+UBYTE ADS1256_Metrics_Add(ads1256_metrics_t *m, const char *label, ads1256_dev_t *dev, ads1256_stream_t *stream)
+{
+    char clean[ADS1256_METRICS_LABEL_MAX];
+    UBYTE status = ADS1256_ERROR;
+
+    if (!m || !m->thread_started || !label || !label[0]) return ADS1256_ERROR;
+    if (!dev) dev = (stream && stream->config.dev) ? stream->config.dev : ADS1256_GetDefaultDev();
+    ADS1256_Metrics_Sanitize(clean, label);
+
+    pthread_mutex_lock(&m->lock);
+    if (ADS1256_Metrics_Find(m, clean) >= 0) {
+        fprintf(stderr, "ADS1256_Metrics_Add: Label %s already registered\r\n", clean);
+    } else if (m->num_sources == ADS1256_METRICS_MAX_SOURCES) {
+        fprintf(stderr, "ADS1256_Metrics_Add: At most %d sources\r\n", ADS1256_METRICS_MAX_SOURCES);
+    } else {
+        ads1256_metrics_source_t *src = &m->sources[m->num_sources];
+        memset(src, 0, sizeof(*src));
+        strcpy(src->label, clean);
+        src->dev = dev;
+        src->stream = stream;
+
+        // Start the deltas from now, so the first push does not report the whole history
+        for (int c = 0; c < ADS1256_METRICS_NUM_COUNTERS; c++) {
+            src->counters[c] = src->pushed[c] = ADS1256_Metrics_Read(src, &counters[c]);
+        }
+        src->sampled_ns = ADS1256_Metrics_NowNs();
+        m->num_sources++;
+        status = ADS1256_OK;
+    }
+    pthread_mutex_unlock(&m->lock);
+    return status;
+}
+
+/**
+ * @brief Unregisters a source.
+ * @param m Running exporter.
+ * @param label Label of the source.
+ * @return ADS1256_OK on success, ADS1256_ERROR otherwise.
+ */
+UBYTE ADS1256_Metrics_Remove(ads1256_metrics_t *m, const char *label)
+{
+    char clean[ADS1256_METRICS_LABEL_MAX];
+
+    if (!m || !m->thread_started || !label) return ADS1256_ERROR;
+    ADS1256_Metrics_Sanitize(clean, label);
+
+    pthread_mutex_lock(&m->lock);
+    int s = ADS1256_Metrics_Find(m, clean);
+    if (s >= 0) {
+        memmove(&m->sources[s], &m->sources[s + 1], (size_t)(m->num_sources - s - 1) * sizeof(m->sources[0]));
+        m->num_sources--;
+    }
+    pthread_mutex_unlock(&m->lock);
+    return s >= 0 ? ADS1256_OK : ADS1256_ERROR;
+}
+
+/**
+ * @brief Stops the exporter thread and closes its socket.
+ * @param m Exporter object.
+ * @return ADS1256_OK on success, ADS1256_ERROR if the exporter was not running.
+ */
+UBYTE ADS1256_Metrics_Stop(ads1256_metrics_t *m)
+{
+    if (!m || !m->thread_started) return ADS1256_ERROR;
+
+    atomic_store_explicit(&m->running, 0, memory_order_relaxed);
+    pthread_join(m->thread, NULL);
+    m->thread_started = 0;
+    pthread_mutex_destroy(&m->lock);
+    close(m->fd);
+    m->fd = -1;
+    free(m->text);
+    m->text = NULL;
+    Debug("ADS1256_Metrics: Stopped after %llu exports, %llu errors\n",
+          (unsigned long long)atomic_load(&m->exports), (unsigned long long)atomic_load(&m->errors));
+    return ADS1256_OK;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file ADS1256_metrics.h
+ * @brief Live export of acquisition metrics to Prometheus or StatsD.
+ *
+ * The acquisition path only increments the counters in performance_metrics_t
+ * and ads1256_stream_t, with relaxed atomic adds, and records into the
+ * latency histograms. A low-priority exporter thread samples those counters
+ * every `interval_ms` for every registered source (a device, optionally with
+ * the stream acquiring from it) and either serves them as a Prometheus text
+ * endpoint (`GET /metrics`) or pushes them to a StatsD daemon over UDP.
+ * Nothing on the acquisition side waits for the exporter, takes a lock or
+ * formats text.
+ *
+ * The endpoint is unauthenticated and served one scrape at a time, so a slow
+ * client holds up the others (and Add/Remove) for up to the 1 s I/O timeout.
+ * It binds to `host`, loopback by default; name an address on a trusted
+ * network to expose it.
+ *
+ * Exported per source, labelled `device="<label>"` (Prometheus) or named
+ * `<prefix>.<label>.<metric>` (StatsD):
+ * - counters: samples, scans, DRDY timeouts, deadline misses, SPI and GPIO
+ *   errors, resets, warm starts, ring overruns and stream scan errors;
+ * - gauges: achieved SPS (total and per channel) over the last interval,
+ *   theoretical SPS per channel, efficiency and ring fill;
+ * - histograms: DRDY wait, SPI transaction and scan period (Prometheus
+ *   buckets from 1 us to 1 s, or p50/p99/max gauges in microseconds for StatsD).
+ *
+ * Counters restart from zero on ADS1256_InitPerformanceMonitoring(), which
+ * Prometheus treats as a counter reset and StatsD deltas absorb.
+ */
+
+#ifndef _ADS1256_METRICS_H_
+#define _ADS1256_METRICS_H_
+
+#include "ADS1256_stream.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sys/socket.h>
+
+/** @name Limits and defaults */
+#define ADS1256_METRICS_MAX_SOURCES         16
+#define ADS1256_METRICS_LABEL_MAX           32
+#define ADS1256_METRICS_PREFIX_MAX          32
+#define ADS1256_METRICS_DEFAULT_PORT        9256 ///< Prometheus listen port
+#define ADS1256_METRICS_DEFAULT_STATSD_PORT 8125
+#define ADS1256_METRICS_DEFAULT_INTERVAL_MS 1000
+#define ADS1256_METRICS_DEFAULT_NICE        10
+
+/** @brief Number of counters exported per source. */
+#define ADS1256_METRICS_NUM_COUNTERS        10
+
+/**
+ * @brief How metrics leave the process.
+ */
+typedef enum {
+    ADS1256_METRICS_PROMETHEUS = 0, ///< Serve `GET /metrics` on TCP `host`:`port`
+    ADS1256_METRICS_STATSD,         ///< Push UDP datagrams to `host`:`port` every interval
+} ADS1256_METRICS_MODE;
+
+/**
+ * @brief Exporter configuration. Fill with ADS1256_Metrics_DefaultConfig().
+ */
+typedef struct {
+    ADS1256_METRICS_MODE mode;  ///< Prometheus or StatsD
+    const char *host;           ///< Prometheus bind address, or StatsD destination host or address
+    UWORD port;                 ///< Prometheus listen port, or StatsD destination port
+    const char *prefix;         ///< Metric name prefix, e.g. "ads1256"
+    UDOUBLE interval_ms;        ///< Sampling period of the rate gauges and of StatsD pushes
+    int nice;                   ///< Nice value of the exporter thread (0 keeps the caller's)
+} ads1256_metrics_config_t;
+
+/**
+ * @brief One registered source and the exporter's view of it.
+ */
+typedef struct {
+    char label[ADS1256_METRICS_LABEL_MAX];        ///< Label value, restricted to [A-Za-z0-9_-]
+    ads1256_dev_t *dev;                           ///< Device whose metrics are exported
+    ads1256_stream_t *stream;                     ///< Stream acquiring from `dev`, or NULL
+    uint64_t counters[ADS1256_METRICS_NUM_COUNTERS]; ///< Counters at the last sample
+    uint64_t pushed[ADS1256_METRICS_NUM_COUNTERS];   ///< Counters at the last StatsD push
+    uint64_t sampled_ns;                          ///< Time of the last sample (0 = none yet)
+    double sps;                                   ///< Samples per second over the last interval
+    double sps_per_channel;                       ///< Scans per second over the last interval
+} ads1256_metrics_source_t;
+
+/**
+ * @brief Exporter state. Treat as opaque; use the functions below.
+ */
+typedef struct {
+    ads1256_metrics_config_t config;        ///< Copy of the configuration; `prefix` points at `prefix`
+    char prefix[ADS1256_METRICS_PREFIX_MAX];
+    pthread_mutex_t lock;                   ///< Guards `sources` against Add/Remove (never taken by acquisition)
+    ads1256_metrics_source_t sources[ADS1256_METRICS_MAX_SOURCES];
+    UBYTE num_sources;                      ///< Entries used in `sources`
+    int fd;                                 ///< TCP listen socket, or UDP socket for StatsD
+    struct sockaddr_storage dest;           ///< StatsD destination
+    socklen_t dest_len;                     ///< Length of `dest`
+    char *text;                             ///< Output buffer, reused across scrapes
+    size_t text_len;                        ///< Bytes used in `text`
+    size_t text_cap;                        ///< Bytes allocated for `text`
+    pthread_t thread;                       ///< Exporter thread
+    UBYTE thread_started;                   ///< Non-zero while `thread` must be joined
+    _Atomic int running;                    ///< Cleared to stop the exporter
+    _Atomic uint64_t exports;               ///< Scrapes served or StatsD pushes sent
+    _Atomic uint64_t errors;                ///< Failed requests or datagrams
+} ads1256_metrics_t;
+
+/**
+ * @brief Fills a configuration with defaults: Prometheus on 127.0.0.1 port
+ *        9256, prefix "ads1256", 1 s interval, nice 10.
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_Metrics_DefaultConfig(ads1256_metrics_config_t *cfg);
+
+/**
+ * @brief Opens the socket and starts the exporter thread with no sources.
+ * @param m Exporter object.
+ * @param cfg Configuration (copied).
+ * @return ADS1256_OK on success, ADS1256_ERROR on a socket error or an invalid configuration.
+ */
+UBYTE ADS1256_Metrics_Start(ads1256_metrics_t *m, const ads1256_metrics_config_t *cfg);
+
+/**
+ * @brief Registers a source while the exporter runs.
+ *
+ * The device and stream must stay valid until the source is removed or the
+ * exporter is stopped; a stream may be stopped and restarted in place.
+ * @param m Running exporter.
+ * @param label Source name; characters outside [A-Za-z0-9_-] become '_'.
+ * @param dev Device, or NULL for the stream's device (or the default device without a stream).
+ * @param stream Stream acquiring from the device, or NULL if there is none.
+ * @return ADS1256_OK on success, ADS1256_ERROR if the label is taken or the registry is full.
+ */
+UBYTE ADS1256_Metrics_Add(ads1256_metrics_t *m, const char *label, ads1256_dev_t *dev, ads1256_stream_t *stream);
+
+/**
+ * @brief Unregisters a source; the exporter no longer touches it on return.
+ * @param m Running exporter.
+ * @param label Label passed to ADS1256_Metrics_Add() (after sanitizing).
+ * @return ADS1256_OK on success, ADS1256_ERROR if no source has that label.
+ */
+UBYTE ADS1256_Metrics_Remove(ads1256_metrics_t *m, const char *label);
+
+/**
+ * @brief Stops the exporter thread and closes its socket.
+ * @param m Exporter object.
+ * @return ADS1256_OK on success, ADS1256_ERROR if the exporter was not running.
+ */
+UBYTE ADS1256_Metrics_Stop(ads1256_metrics_t *m);
+
+#endif // _ADS1256_METRICS_H_
@@ -0,0 +1,399 @@
+/**
+ * @file ADS1256_multi.c
+ * @brief Barrier-synchronized acquisition threads for several ADS1256 boards.
+ *
+ * Each worker repeats: wait for its board's DRDY, meet the other workers at
+ * the barrier, send the switch-and-read message, store its value in the
+ * pending frame. The worker that stores the last value of a frame publishes
+ * it. The barrier orders these steps, so only one worker at a time ever
+ * produces into the ring, and the ring needs no more than the
+ * acquire/release indices of ADS1256_stream.c. When any board reports an
+ * error at the barrier, every worker resets its pipeline and all boards are
+ * primed again together.
+ */
+#define _GNU_SOURCE // For pthread_setaffinity_np, CPU_SET
+#include "ADS1256_multi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#define ADS1256_MULTI_POLL_NS 200000L // Consumer sleep between ring checks while waiting (200 us)
+#define ADS1256_MULTI_SPINS   1000    // Barrier polls before a waiting worker starts yielding the CPU
+
+/**
+ * @brief Fills a configuration with defaults.
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_Multi_DefaultConfig(ads1256_multi_config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    for (UBYTE i = 0; i < 4; i++) {
+        cfg->channels[i] = i;
+    }
+    cfg->num_channels = 4;
+    cfg->settling_cycles = 1;
+    cfg->gain = ADS1256_GAIN_1;
+    cfg->drate = ADS1256_30000SPS;
+    cfg->ring_capacity = ADS1256_MULTI_DEFAULT_RING;
+    for (UBYTE i = 0; i < ADS1256_MULTI_MAX_DEVS; i++) {
+        cfg->cpus[i] = -1;
+    }
+}
+
+/**
+ * @brief Rounds a ring size up to the next power of two.
+ * @param n Requested size.
+ * @return Power of two >= n (minimum 2).
+ */
+static uint64_t ADS1256_Multi_RoundPow2(uint64_t n)
+{
+    uint64_t size = 2;
+    while (size < n) size <<= 1;
+    return size;
+}
+
+/**
+ * @brief Applies CPU affinity and scheduling policy to the calling worker.
+ * @param cfg Group configuration.
+ * @param index Worker index.
+ */
+static void ADS1256_Multi_ApplyScheduling(const ads1256_multi_config_t *cfg, UBYTE index)
+{
+    if (cfg->cpus[index] >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cfg->cpus[index], &set);
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (err != 0) {
+            fprintf(stderr, "ADS1256_Multi: Failed to pin worker %d to CPU %d: %s\r\n", index, cfg->cpus[index],
+                    strerror(err));
+        }
+    }
+    if (cfg->rt_priority > 0) {
+        struct sched_param param = { .sched_priority = cfg->rt_priority };
+        int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (err != 0) {
+            fprintf(stderr, "ADS1256_Multi: SCHED_FIFO priority %d unavailable (%s), using SCHED_OTHER\r\n",
+                    cfg->rt_priority, strerror(err));
+        }
+    }
+}
+
+/**
+ * @brief Waits until every worker has arrived, then releases them together.
+ *
+ * Workers spin on the round counter so the release reaches all of them
+ * within a cache-line transfer. After ADS1256_MULTI_SPINS polls they also
+ * yield, so an unpinned group on a busy machine still makes progress.
+ * @param multi Group.
+ * @param fault Non-zero if this worker's board had an error since the last round.
+ * @return 0 to continue, 1 if any board reported an error (all must resync), -1 to stop.
+ */
+static int ADS1256_Multi_Barrier(ads1256_multi_t *multi, int fault)
+{
+    UDOUBLE round = atomic_load_explicit(&multi->barrier_round, memory_order_acquire);
+
+    if (fault) atomic_store_explicit(&multi->barrier_fault, 1, memory_order_relaxed);
+
+    if (atomic_fetch_add_explicit(&multi->barrier_count, 1, memory_order_acq_rel) + 1 == multi->config.num_devs) {
+        atomic_store_explicit(&multi->barrier_count, 0, memory_order_relaxed);
+        multi->round_fault = atomic_exchange_explicit(&multi->barrier_fault, 0, memory_order_relaxed);
+        if (multi->round_fault) atomic_fetch_add_explicit(&multi->resyncs, 1, memory_order_relaxed);
+        atomic_store_explicit(&multi->barrier_round, round + 1, memory_order_release);
+    } else {
+        unsigned spins = 0;
+        while (atomic_load_explicit(&multi->barrier_round, memory_order_acquire) == round) {
+            if (!atomic_load_explicit(&multi->running, memory_order_relaxed)) return -1;
+            if (++spins > ADS1256_MULTI_SPINS) sched_yield();
+        }
+    }
+
+    if (!atomic_load_explicit(&multi->running, memory_order_relaxed)) return -1;
+    return multi->round_fault ? 1 : 0;
+}
+
+/**
+ * @brief Publishes a completed frame to the ring, or drops it when the ring is full.
+ * @param multi Group.
+ * @param frame Completed frame.
+ */
+static void ADS1256_Multi_Push(ads1256_multi_t *multi, const ads1256_multi_frame_t *frame)
+{
+    uint64_t head = atomic_load_explicit(&multi->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&multi->tail, memory_order_acquire);
+
+    if (head - tail > multi->ring_mask) {
+        atomic_fetch_add_explicit(&multi->overruns, 1, memory_order_relaxed);
+        return;
+    }
+    multi->ring[head & multi->ring_mask] = *frame;
+    atomic_store_explicit(&multi->head, head + 1, memory_order_release);
+}
+
+/**
+ * @brief Stores one board's result in the pending frame and publishes the frame once it is complete.
+ * @param multi Group.
+ * @param worker Worker storing its result.
+ * @param entry Scan position the result belongs to.
+ * @param frame The board's result, or NULL if its read failed (the frame is dropped).
+ */
+static void ADS1256_Multi_Fill(ads1256_multi_t *multi, const ads1256_multi_worker_t *worker, UBYTE entry,
+                               const ads1256_frame_t *frame)
+{
+    UBYTE n = multi->config.num_devs;
+
+    if (frame) {
+        multi->pending.values[worker->index] = frame->value;
+        multi->pending_drdy_ns[worker->index] = frame->timestamp_ns;
+    } else {
+        atomic_store_explicit(&multi->pending_bad, 1, memory_order_relaxed);
+    }
+    if (atomic_fetch_add_explicit(&multi->pending_filled, 1, memory_order_acq_rel) + 1 != n) return;
+
+    // Last value of this frame: every other worker's store is visible through the counter
+    atomic_store_explicit(&multi->pending_filled, 0, memory_order_relaxed);
+    UBYTE bad = atomic_exchange_explicit(&multi->pending_bad, 0, memory_order_relaxed);
+    uint64_t sequence = multi->next_sequence++;
+    if (bad) return; // Leaves a gap in the sequence
+
+    uint64_t first = multi->pending_drdy_ns[0], last = multi->pending_drdy_ns[0];
+    for (UBYTE i = 1; i < n; i++) {
+        if (multi->pending_drdy_ns[i] < first) first = multi->pending_drdy_ns[i];
+        if (multi->pending_drdy_ns[i] > last) last = multi->pending_drdy_ns[i];
+    }
+    multi->pending.timestamp_ns = last;
+    multi->pending.sequence = sequence;
+    multi->pending.skew_ns = (UDOUBLE)(last - first);
+    multi->pending.entry = entry;
+    multi->pending.channel = worker->scan.entries[entry].channel;
+    multi->pending.num_values = n;
+    ADS1256_Multi_Push(multi, &multi->pending);
+}
+
+/**
+ * @brief Worker body: DRDY, barrier, switch-and-read, store, repeat.
+ * @param arg The ads1256_multi_worker_t being run.
+ * @return NULL.
+ */
+static void *ADS1256_Multi_Thread(void *arg)
+{
+    ads1256_multi_worker_t *worker = (ads1256_multi_worker_t *)arg;
+    ads1256_multi_t *multi = worker->group;
+    ads1256_dev_t *dev = worker->dev;
+    UBYTE num_entries = worker->scan.num_entries;
+    UBYTE fault = 0;
+    UBYTE i = 0;
+
+    ADS1256_Multi_ApplyScheduling(&multi->config, worker->index);
+    ADS1256_Dev_InitPerformanceMonitoring(dev, multi->config.drate);
+
+    // All boards prime entry 0 together right after this first round
+    if (ADS1256_Multi_Barrier(multi, 0) < 0) return NULL;
+
+    for (;;) {
+        ads1256_frame_t frame;
+        UBYTE status = fault ? ADS1256_ERROR : ADS1256_Dev_ScanWaitEntry(dev, &worker->scan, i);
+
+        int round = ADS1256_Multi_Barrier(multi, status != ADS1256_OK);
+        if (round < 0) break;
+        if (round > 0) {
+            // Some board lost its pipeline: restart all of them from entry 0 at the same instant
+            ADS1256_ScanList_Reset(&worker->scan);
+            fault = 0;
+            i = 0;
+            continue;
+        }
+
+        // Released with the other boards: this message's SYNC/WAKEUP starts the next conversion
+        if (ADS1256_Dev_ScanReadEntry(dev, &worker->scan, i, &frame) != ADS1256_OK) {
+            fault = 1;
+            ADS1256_Multi_Fill(multi, worker, i, NULL);
+            continue;
+        }
+        ADS1256_Multi_Fill(multi, worker, i, &frame);
+        i = (UBYTE)((i + 1) % num_entries);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Allocates the ring and starts one acquisition thread per board.
+ * @param multi Group object to start.
+ * @param cfg Configuration (copied).
+ * @return ADS1256_OK on success, ADS1256_ERROR on failure.
+ */
+UBYTE ADS1256_Multi_Start(ads1256_multi_t *multi, const ads1256_multi_config_t *cfg)
+{
+    if (!multi || !cfg || cfg->num_devs == 0 || cfg->num_devs > ADS1256_MULTI_MAX_DEVS) return ADS1256_ERROR;
+
+    memset(multi, 0, sizeof(*multi));
+    multi->config = *cfg;
+    multi->config.scan_list = NULL; // Only the workers' private copies are used
+
+    for (UBYTE d = 0; d < cfg->num_devs; d++) {
+        ads1256_multi_worker_t *worker = &multi->workers[d];
+        UBYTE status;
+        UBYTE duplicate = 0;
+
+        for (UBYTE e = 0; e < d; e++) {
+            if (cfg->devs[e] == cfg->devs[d]) duplicate = 1; // Two threads must never drive one device
+        }
+        if (!cfg->devs[d] || duplicate) {
+            fprintf(stderr, "ADS1256_Multi_Start: Missing or duplicate device %d\r\n", d);
+            return ADS1256_ERROR;
+        }
+
+        worker->group = multi;
+        worker->dev = cfg->devs[d];
+        worker->index = d;
+        if (cfg->scan_list) {
+            worker->scan = *cfg->scan_list;
+            status = (worker->scan.num_entries > 0) ? ADS1256_OK : ADS1256_ERROR;
+        } else {
+            status = ADS1256_Dev_ScanList_Build(worker->dev, &worker->scan, cfg->channels, cfg->num_channels,
+                                                cfg->gain, cfg->drate, cfg->settling_cycles);
+        }
+        if (status != ADS1256_OK) {
+            fprintf(stderr, "ADS1256_Multi_Start: Invalid channel configuration\r\n");
+            return ADS1256_ERROR;
+        }
+        ADS1256_ScanList_Reset(&worker->scan);
+    }
+
+    if (cfg->lock_memory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        perror("ADS1256_Multi_Start: mlockall failed, continuing unlocked");
+    }
+
+    uint64_t capacity = ADS1256_Multi_RoundPow2(cfg->ring_capacity ? cfg->ring_capacity : ADS1256_MULTI_DEFAULT_RING);
+    multi->ring = aligned_alloc(ADS1256_MULTI_CACHE_LINE, capacity * sizeof(ads1256_multi_frame_t));
+    if (!multi->ring) {
+        perror("ADS1256_Multi_Start: Failed to allocate frame ring");
+        return ADS1256_ERROR;
+    }
+    memset(multi->ring, 0, capacity * sizeof(ads1256_multi_frame_t)); // Pre-fault every page before the threads start
+    multi->ring_mask = capacity - 1;
+
+    atomic_init(&multi->barrier_count, 0);
+    atomic_init(&multi->barrier_round, 0);
+    atomic_init(&multi->barrier_fault, 0);
+    atomic_init(&multi->pending_filled, 0);
+    atomic_init(&multi->pending_bad, 0);
+    atomic_init(&multi->head, 0);
+    atomic_init(&multi->tail, 0);
+    atomic_init(&multi->overruns, 0);
+    atomic_init(&multi->resyncs, 0);
+    atomic_init(&multi->running, 1);
+
+    for (UBYTE d = 0; d < cfg->num_devs; d++) {
+        int err = pthread_create(&multi->workers[d].thread, NULL, ADS1256_Multi_Thread, &multi->workers[d]);
+        if (err != 0) {
+            fprintf(stderr, "ADS1256_Multi_Start: Failed to create worker %d: %s\r\n", d, strerror(err));
+            ADS1256_Multi_Stop(multi); // Releases the workers already waiting at the first barrier
+            return ADS1256_ERROR;
+        }
+        multi->workers[d].thread_started = 1;
+    }
+
+    Debug("ADS1256_Multi_Start: %d boards, %d scan entries, ring %llu frames\n", cfg->num_devs,
+          multi->workers[0].scan.num_entries, (unsigned long long)capacity);
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Returns the number of frames waiting in the ring.
+ * @param multi Running group.
+ * @return Frames available to ADS1256_Multi_Read().
+ */
+UDOUBLE ADS1256_Multi_Available(ads1256_multi_t *multi)
+{
+    uint64_t head = atomic_load_explicit(&multi->head, memory_order_acquire);
+    uint64_t tail = atomic_load_explicit(&multi->tail, memory_order_relaxed);
+    return (UDOUBLE)(head - tail);
+}
+
+/**
+ * @brief Copies up to `max` frames out of the ring (consumer side).
+ * @param multi Running group.
+ * @param out Output array for at least `max` frames.
+ * @param max Maximum number of frames to copy.
+ * @param timeout_ms Time to wait for data if the ring is empty (0 = return immediately).
+ * @return Number of frames copied.
+ */
+UDOUBLE ADS1256_Multi_Read(ads1256_multi_t *multi, ads1256_multi_frame_t *out, UDOUBLE max, int timeout_ms)
+{
+    if (!multi || !multi->ring || !out || max == 0) return 0;
+
+    UDOUBLE avail = ADS1256_Multi_Available(multi);
+    if (avail == 0 && timeout_ms > 0) {
+        struct timespec pause = { 0, ADS1256_MULTI_POLL_NS };
+        long waited_ns = 0;
+        while (avail == 0 && waited_ns < timeout_ms * 1000000L &&
+               atomic_load_explicit(&multi->running, memory_order_relaxed)) {
+            nanosleep(&pause, NULL);
+            waited_ns += ADS1256_MULTI_POLL_NS;
+            avail = ADS1256_Multi_Available(multi);
+        }
+    }
+
+    UDOUBLE count = (avail < max) ? avail : max;
+    if (count == 0) return 0;
+
+    uint64_t tail = atomic_load_explicit(&multi->tail, memory_order_relaxed);
+    uint64_t start = tail & multi->ring_mask;
+    uint64_t first = multi->ring_mask + 1 - start; // Slots before the wrap point
+    if (first > count) first = count;
+
+    memcpy(out, &multi->ring[start], first * sizeof(ads1256_multi_frame_t));
+    memcpy(out + first, &multi->ring[0], (count - first) * sizeof(ads1256_multi_frame_t));
+
+    atomic_store_explicit(&multi->tail, tail + count, memory_order_release);
+    return count;
+}
+
+/**
+ * @brief Returns the number of frames dropped because the consumer fell behind.
+ * @param multi Group object.
+ * @return Overrun counter.
+ */
+uint64_t ADS1256_Multi_Overruns(ads1256_multi_t *multi)
+{
+    return atomic_load_explicit(&multi->overruns, memory_order_relaxed);
+}
+
+/**
+ * @brief Returns how often the boards were restarted together.
+ * @param multi Group object.
+ * @return Resync counter.
+ */
+uint64_t ADS1256_Multi_Resyncs(ads1256_multi_t *multi)
+{
+    return atomic_load_explicit(&multi->resyncs, memory_order_relaxed);
+}
+
+/**
+ * @brief Stops the threads and frees the ring.
+ * @param multi Group object.
+ * @return ADS1256_OK on success, ADS1256_ERROR if the group was not running.
+ */
+UBYTE ADS1256_Multi_Stop(ads1256_multi_t *multi)
+{
+    if (!multi || !multi->ring) return ADS1256_ERROR;
+
+    atomic_store_explicit(&multi->running, 0, memory_order_relaxed);
+    for (UBYTE d = 0; d < multi->config.num_devs; d++) {
+        if (multi->workers[d].thread_started) {
+            pthread_join(multi->workers[d].thread, NULL);
+            multi->workers[d].thread_started = 0;
+        }
+    }
+
+    Debug("ADS1256_Multi_Stop: %llu overruns, %llu resyncs\n", (unsigned long long)ADS1256_Multi_Overruns(multi),
+          (unsigned long long)ADS1256_Multi_Resyncs(multi));
+
+    free(multi->ring);
+    multi->ring = NULL;
+    return ADS1256_OK;
+}
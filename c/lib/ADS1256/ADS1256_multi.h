@@ -0,0 +1,161 @@
+/**
+ * @file ADS1256_multi.h
+ * @brief Synchronized acquisition from several ADS1256 boards.
+ *
+ * One thread per device (ideally one per SPI bus, each pinned to its own
+ * core) runs the same pipelined scan list as ADS1256_Stream. The threads
+ * meet at a barrier after every DRDY. Once all boards have a result, they
+ * are released together, and each sends its usual
+ * WREG/SYNC/WAKEUP/RDATA message. Every conversion on every board therefore
+ * starts from the same instant, and the boards cannot drift apart. The
+ * results of one scan position on all boards are merged into one
+ * ads1256_multi_frame_t in a lock-free ring.
+ *
+ * The alignment is only as good as the release: a few microseconds with
+ * the threads pinned to idle cores and one board per bus. Boards sharing a
+ * bus take turns on it, so their conversions start one SPI message apart.
+ * Each frame reports the spread of its DRDY times in `skew_ns`.
+ */
+
+#ifndef _ADS1256_MULTI_H_
+#define _ADS1256_MULTI_H_
+
+#include "ADS1256.h"
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+/** @brief Maximum number of boards in one group. */
+#define ADS1256_MULTI_MAX_DEVS 8
+/** @brief Default ring capacity in frames (rounded up to a power of two). */
+#define ADS1256_MULTI_DEFAULT_RING 16384
+/** @brief Size used to keep shared counters on separate cache lines. */
+#define ADS1256_MULTI_CACHE_LINE 64
+
+/**
+ * @brief One scan position converted on every board at the same time.
+ */
+typedef struct {
+    uint64_t timestamp_ns;  ///< CLOCK_MONOTONIC time of the latest DRDY among the boards
+    uint64_t sequence;      ///< Frame counter; a gap means frames were dropped (overrun or resync)
+    UDOUBLE skew_ns;        ///< Latest minus earliest DRDY time of this conversion across the boards
+    UBYTE entry;            ///< Position in the scan list
+    UBYTE channel;          ///< Channel label of that entry
+    UBYTE num_values;       ///< Number of boards
+    UDOUBLE values[ADS1256_MULTI_MAX_DEVS]; ///< Raw, sign-extended result of each board, in `devs` order
+} ads1256_multi_frame_t;
+
+/**
+ * @brief Group configuration. Fill with ADS1256_Multi_DefaultConfig() and override what is needed.
+ */
+typedef struct {
+    ads1256_dev_t *devs[ADS1256_MULTI_MAX_DEVS]; ///< Initialized devices (ADS1256_Dev_Init()), one thread each
+    UBYTE num_devs;         ///< Number of entries in `devs` (at least 1)
+    UBYTE channels[NUM_SINGLE_ENDED_CHANNELS]; ///< Channels scanned on every board, in order
+    UBYTE num_channels;     ///< Number of entries in `channels`
+    UBYTE settling_cycles;  ///< DRDY cycles per channel switch
+    ADS1256_GAIN gain;      ///< PGA gain for every channel in `channels`
+    ADS1256_DRATE drate;    ///< Data rate for every channel in `channels`
+    const ADS1256_ScanList *scan_list; ///< Optional prebuilt scan list run on every board; overrides channels/gain/settling
+    UDOUBLE ring_capacity;  ///< Ring size in frames (rounded up to a power of two)
+    int cpus[ADS1256_MULTI_MAX_DEVS]; ///< CPU core for each board's thread, or -1 to leave it unpinned
+    int rt_priority;        ///< SCHED_FIFO priority (1-99) of the threads, or 0 for SCHED_OTHER
+    UBYTE lock_memory;      ///< Non-zero to mlockall() the process before starting
+} ads1256_multi_config_t;
+
+typedef struct ads1256_multi ads1256_multi_t;
+
+/**
+ * @brief One board's acquisition thread.
+ */
+typedef struct {
+    ads1256_multi_t *group;  ///< Group the worker belongs to
+    ads1256_dev_t *dev;      ///< Board it drives
+    ADS1256_ScanList scan;   ///< Private copy of the scan list
+    UBYTE index;             ///< Position in `devs` and in each frame's `values`
+    pthread_t thread;        ///< The thread
+    UBYTE thread_started;    ///< Non-zero while `thread` must be joined
+} ads1256_multi_worker_t;
+
+/**
+ * @brief Group state. Treat as opaque; use the accessor functions.
+ */
+struct ads1256_multi {
+    ads1256_multi_config_t config;       ///< Copy of the configuration passed to Start
+    ads1256_multi_worker_t workers[ADS1256_MULTI_MAX_DEVS]; ///< One per board
+    ads1256_multi_frame_t *ring;         ///< Preallocated frame ring
+    uint64_t ring_mask;                  ///< ring capacity - 1
+    ads1256_multi_frame_t pending;       ///< Frame being filled by the workers
+    uint64_t pending_drdy_ns[ADS1256_MULTI_MAX_DEVS]; ///< DRDY time of each board's value in `pending`
+    uint64_t next_sequence;              ///< Sequence number of the next completed frame
+    UBYTE round_fault;                   ///< Outcome of the last barrier round
+    _Alignas(ADS1256_MULTI_CACHE_LINE) _Atomic UDOUBLE barrier_count; ///< Workers waiting at the barrier
+    _Atomic UDOUBLE barrier_round;       ///< Incremented by the last worker to arrive
+    _Atomic UBYTE barrier_fault;         ///< Set by a worker arriving after an error
+    _Atomic UDOUBLE pending_filled;      ///< Workers that stored their value in `pending`
+    _Atomic UBYTE pending_bad;           ///< Set by a worker whose read failed
+    _Alignas(ADS1256_MULTI_CACHE_LINE) _Atomic uint64_t head; ///< Next write index (the completing worker)
+    _Alignas(ADS1256_MULTI_CACHE_LINE) _Atomic uint64_t tail; ///< Next read index (consumer only)
+    _Alignas(ADS1256_MULTI_CACHE_LINE) _Atomic uint64_t overruns; ///< Frames dropped because the ring was full
+    _Atomic uint64_t resyncs;            ///< Pipeline restarts after a DRDY timeout or SPI error on any board
+    _Atomic int running;                 ///< Cleared to ask the workers to stop
+};
+
+/**
+ * @brief Fills a configuration with defaults: no devices, AIN0..AIN3 at gain 1,
+ *        1 settling cycle, 30000 SPS, 16k-frame ring, unpinned, SCHED_OTHER.
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_Multi_DefaultConfig(ads1256_multi_config_t *cfg);
+
+/**
+ * @brief Allocates the ring and starts one acquisition thread per board.
+ *
+ * Every device must already be initialized. While the group runs, its
+ * threads own the devices: do not call other functions on them until
+ * ADS1256_Multi_Stop() returns.
+ * @param multi Group object to start.
+ * @param cfg Configuration (copied).
+ * @return ADS1256_OK on success, ADS1256_ERROR on failure.
+ */
+UBYTE ADS1256_Multi_Start(ads1256_multi_t *multi, const ads1256_multi_config_t *cfg);
+
+/**
+ * @brief Copies up to `max` frames out of the ring.
+ * @param multi Running group.
+ * @param out Output array for at least `max` frames.
+ * @param max Maximum number of frames to copy.
+ * @param timeout_ms Time to wait for data if the ring is empty (0 = return immediately).
+ * @return Number of frames copied (0 if none arrived before the timeout).
+ */
+UDOUBLE ADS1256_Multi_Read(ads1256_multi_t *multi, ads1256_multi_frame_t *out, UDOUBLE max, int timeout_ms);
+
+/**
+ * @brief Returns the number of frames waiting in the ring.
+ * @param multi Running group.
+ * @return Frames available to ADS1256_Multi_Read().
+ */
+UDOUBLE ADS1256_Multi_Available(ads1256_multi_t *multi);
+
+/**
+ * @brief Returns the number of frames dropped because the consumer fell behind.
+ * @param multi Group object.
+ * @return Overrun counter.
+ */
+uint64_t ADS1256_Multi_Overruns(ads1256_multi_t *multi);
+
+/**
+ * @brief Returns how often the boards were restarted together after an error on one of them.
+ * @param multi Group object.
+ * @return Resync counter.
+ */
+uint64_t ADS1256_Multi_Resyncs(ads1256_multi_t *multi);
+
+/**
+ * @brief Stops the threads and frees the ring.
+ * @param multi Group object.
+ * @return ADS1256_OK on success, ADS1256_ERROR if the group was not running.
+ */
+UBYTE ADS1256_Multi_Stop(ads1256_multi_t *multi);
+
+#endif // _ADS1256_MULTI_H_
@@ -0,0 +1,788 @@
+/**
+ * @file ADS1256_net.c
+ * @brief Sender thread, packet batching and remote control for ADS1256_net.h.
+ *
+ * Everything except the counters is owned by the sender thread: it is the
+ * stream's only consumer, it builds the packets in place in a preallocated
+ * batch buffer, and it serves the control port between reads, so a
+ * reconfiguration never races with acquisition or packing.
+ */
+#define _GNU_SOURCE // For sendmmsg, pthread_setaffinity_np, CPU_SET
+#include "ADS1256_net.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <math.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/uio.h>
+
+_Static_assert(ADS1256_NET_OFF_RESERVED + 4 == ADS1256_NET_HEADER_SIZE, "header fields must fill the header");
+_Static_assert(ADS1256_NET_REC_OFF_DT + 4 == ADS1256_NET_RECORD_SIZE, "record fields must fill the record");
+_Static_assert(ADS1256_NET_HEADER_SIZE + ADS1256_NET_DEFAULT_FRAMES * ADS1256_NET_RECORD_SIZE <= ADS1256_NET_MTU_PAYLOAD,
+               "default packets must fit one Ethernet frame");
+
+#define ADS1256_NET_READ_BLOCK   1024    ///< Frames taken from the stream per read
+#define ADS1256_NET_IDLE_MS      20      ///< Stream read timeout with an empty batch
+#define ADS1256_NET_SEND_TIMEOUT_US 100000 ///< A TCP client blocking longer is dropped
+#define ADS1256_NET_SNDBUF       (1 << 20)
+#define ADS1256_NET_CMD_MAX      256
+
+/**
+ * @brief Fills a configuration with defaults.
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_Net_DefaultConfig(ads1256_net_config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->mode = ADS1256_NET_UDP;
+    cfg->host = "127.0.0.1";
+    cfg->bind_addr = "127.0.0.1"; // The command port is unauthenticated; keep it local unless asked
+    cfg->port = ADS1256_NET_DEFAULT_PORT;
+    cfg->control_port = ADS1256_NET_DEFAULT_CONTROL_PORT;
+    cfg->frames_per_packet = ADS1256_NET_DEFAULT_FRAMES;
+    cfg->batch_packets = ADS1256_NET_DEFAULT_BATCH;
+    cfg->flush_us = ADS1256_NET_DEFAULT_FLUSH_US;
+    cfg->cpu = -1;
+}
+
+/**
+ * @brief Returns CLOCK_MONOTONIC in nanoseconds.
+ * @return Current time.
+ */
+static uint64_t ADS1256_Net_NowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Stores a 16-bit value little-endian.
+ * @param p Destination (2 bytes).
+ * @param v Value.
+ */
+static void ADS1256_Net_Put16(UBYTE *p, uint16_t v)
+{
+    p[0] = (UBYTE)v; p[1] = (UBYTE)(v >> 8);
+}
+
+/**
+ * @brief Stores a 32-bit value little-endian.
+ * @param p Destination (4 bytes).
+ * @param v Value.
+ */
+static void ADS1256_Net_Put32(UBYTE *p, uint32_t v)
+{
+    p[0] = (UBYTE)v; p[1] = (UBYTE)(v >> 8); p[2] = (UBYTE)(v >> 16); p[3] = (UBYTE)(v >> 24);
+}
+
+/**
+ * @brief Stores a 64-bit value little-endian.
+ * @param p Destination (8 bytes).
+ * @param v Value.
+ */
+static void ADS1256_Net_Put64(UBYTE *p, uint64_t v)
+{
+    ADS1256_Net_Put32(p, (uint32_t)v);
+    ADS1256_Net_Put32(p + 4, (uint32_t)(v >> 32));
+}
+
+/**
+ * @brief Loads a little-endian 16-bit value.
+ * @param p Source (2 bytes).
+ * @return Value.
+ */
+static uint16_t ADS1256_Net_Get16(const UBYTE *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+ * @brief Loads a little-endian 32-bit value.
+ * @param p Source (4 bytes).
+ * @return Value.
+ */
+static uint32_t ADS1256_Net_Get32(const UBYTE *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Loads a little-endian 64-bit value.
+ * @param p Source (8 bytes).
+ * @return Value.
+ */
+static uint64_t ADS1256_Net_Get64(const UBYTE *p)
+{
+    return (uint64_t)ADS1256_Net_Get32(p) | ((uint64_t)ADS1256_Net_Get32(p + 4) << 32);
+}
+
+/**
+ * @brief Returns the header of packet `i` of the batch.
+ * @param net Server object.
+ * @param i Packet index.
+ * @return Packet header (host form, serialized in ADS1256_Net_SendBatch()).
+ */
+static ads1256_net_header_t *ADS1256_Net_Packet(ads1256_net_t *net, UWORD i)
+{
+    return &net->headers[i];
+}
+
+/**
+ * @brief Returns the serialized bytes of packet `i` of the batch.
+ * @param net Server object.
+ * @param i Packet index.
+ * @return Start of the packet buffer.
+ */
+static UBYTE *ADS1256_Net_PacketData(ads1256_net_t *net, UWORD i)
+{
+    return net->packets + (size_t)i * net->packet_size;
+}
+
+/**
+ * @brief Serializes a header at the start of a packet buffer.
+ * @param p Packet buffer (ADS1256_NET_HEADER_SIZE bytes).
+ * @param h Header.
+ */
+static void ADS1256_Net_PutHeader(UBYTE *p, const ads1256_net_header_t *h)
+{
+    ADS1256_Net_Put32(p + ADS1256_NET_OFF_MAGIC, h->magic);
+    ADS1256_Net_Put16(p + ADS1256_NET_OFF_VERSION, h->version);
+    ADS1256_Net_Put16(p + ADS1256_NET_OFF_COUNT, h->count);
+    ADS1256_Net_Put32(p + ADS1256_NET_OFF_CONFIG_GEN, h->config_gen);
+    ADS1256_Net_Put32(p + ADS1256_NET_OFF_LOST, h->lost);
+    ADS1256_Net_Put64(p + ADS1256_NET_OFF_PACKET_SEQ, h->packet_seq);
+    ADS1256_Net_Put64(p + ADS1256_NET_OFF_FIRST_SEQUENCE, h->first_sequence);
+    ADS1256_Net_Put64(p + ADS1256_NET_OFF_FIRST_TIME, h->first_timestamp_ns);
+    p[ADS1256_NET_OFF_GAIN] = h->gain;
+    p[ADS1256_NET_OFF_DRATE] = h->drate;
+    p[ADS1256_NET_OFF_SCAN_MODE] = h->scan_mode;
+    p[ADS1256_NET_OFF_NUM_ENTRIES] = h->num_entries;
+    ADS1256_Net_Put32(p + ADS1256_NET_OFF_RESERVED, h->reserved);
+}
+
+/**
+ * @brief Drops a TCP client.
+ * @param net Server object.
+ * @param slot Client slot.
+ */
+static void ADS1256_Net_DropClient(ads1256_net_t *net, int slot)
+{
+    Debug("ADS1256_Net: Client %d disconnected\n", slot);
+    close(net->clients[slot]);
+    net->clients[slot] = -1;
+}
+
+/**
+ * @brief Sends the packets of the current batch with sendmmsg() and empties it.
+ * @param net Server object.
+ */
+static void ADS1256_Net_SendBatch(ads1256_net_t *net)
+{
+    struct mmsghdr msgs[ADS1256_NET_MAX_BATCH];
+    struct iovec iov[ADS1256_NET_MAX_BATCH];
+    UWORD n = net->fill;
+    uint64_t frames = 0;
+
+    // The packet being filled goes out too, so a flush never waits for it to fill up
+    if (n < net->config.batch_packets && ADS1256_Net_Packet(net, n)->count > 0) n++;
+    if (n == 0) return;
+
+    memset(msgs, 0, n * sizeof(msgs[0]));
+    for (UWORD i = 0; i < n; i++) {
+        ads1256_net_header_t *h = ADS1256_Net_Packet(net, i);
+        ADS1256_Net_PutHeader(ADS1256_Net_PacketData(net, i), h);
+        iov[i].iov_base = ADS1256_Net_PacketData(net, i);
+        iov[i].iov_len = ADS1256_NET_HEADER_SIZE + (size_t)h->count * ADS1256_NET_RECORD_SIZE;
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        if (net->config.mode == ADS1256_NET_UDP) {
+            msgs[i].msg_hdr.msg_name = &net->dest;
+            msgs[i].msg_hdr.msg_namelen = net->dest_len;
+        }
+        frames += h->count;
+    }
+
+    if (net->config.mode == ADS1256_NET_UDP) {
+        UWORD sent = 0;
+        while (sent < n) {
+            int r = sendmmsg(net->data_fd, msgs + sent, n - sent, 0);
+            atomic_fetch_add_explicit(&net->send_calls, 1, memory_order_relaxed);
+            if (r <= 0) {
+                if (r < 0 && errno == EINTR) continue;
+                Debug("ADS1256_Net: sendmmsg failed: %s\n", strerror(errno));
+                break;
+            }
+            sent += (UWORD)r;
+        }
+        atomic_fetch_add_explicit(&net->packets_sent, sent, memory_order_relaxed);
+        atomic_fetch_add_explicit(&net->send_errors, n - sent, memory_order_relaxed);
+    } else {
+        // A stream cannot resynchronize after a partial packet, so any short send drops the client
+        for (int c = 0; c < ADS1256_NET_MAX_CLIENTS; c++) {
+            if (net->clients[c] < 0) continue;
+            int r = sendmmsg(net->clients[c], msgs, n, MSG_NOSIGNAL);
+            atomic_fetch_add_explicit(&net->send_calls, 1, memory_order_relaxed);
+            UBYTE ok = (r == n);
+            for (int i = 0; ok && i < r; i++) ok = (msgs[i].msg_len == iov[i].iov_len);
+            if (ok) {
+                atomic_fetch_add_explicit(&net->packets_sent, n, memory_order_relaxed);
+            } else {
+                atomic_fetch_add_explicit(&net->send_errors, n, memory_order_relaxed);
+                ADS1256_Net_DropClient(net, c);
+            }
+        }
+    }
+    atomic_fetch_add_explicit(&net->frames, frames, memory_order_relaxed);
+
+    for (UWORD i = 0; i < n; i++) ADS1256_Net_Packet(net, i)->count = 0;
+    net->fill = 0;
+}
+
+/**
+ * @brief Closes the packet being filled and sends the batch once it is full.
+ * @param net Server object.
+ */
+static void ADS1256_Net_EndPacket(ads1256_net_t *net)
+{
+    if (ADS1256_Net_Packet(net, net->fill)->count == 0) return;
+    if (++net->fill == net->config.batch_packets) ADS1256_Net_SendBatch(net);
+}
+
+/**
+ * @brief Appends one frame to the current packet.
+ *
+ * A sequence gap or a delta that does not fit 32 bits ends the packet, so
+ * records within a packet always have consecutive sequence numbers.
+ * @param net Server object.
+ * @param f Frame to append.
+ */
+static void ADS1256_Net_Pack(ads1256_net_t *net, const ads1256_frame_t *f)
+{
+    uint64_t lost = (net->packet_seq || net->fill) ? f->sequence - net->next_sequence : 0;
+    uint64_t dt = f->timestamp_ns - net->last_timestamp_ns;
+    ads1256_net_header_t *h = ADS1256_Net_Packet(net, net->fill);
+
+    if (h->count > 0 && (lost != 0 || dt > UINT32_MAX)) {
+        ADS1256_Net_EndPacket(net);
+        h = ADS1256_Net_Packet(net, net->fill);
+    }
+    if (lost) {
+        net->pending_lost += lost;
+        atomic_fetch_add_explicit(&net->lost, lost, memory_order_relaxed);
+    }
+
+    if (h->count == 0) {
+        const ADS1256_ScanEntry *e = &net->stream.scan.entries[0];
+
+        if (net->fill == 0) net->batch_start_ns = f->timestamp_ns;
+        h->magic = ADS1256_NET_MAGIC;
+        h->version = ADS1256_NET_VERSION;
+        h->config_gen = net->config_gen;
+        h->lost = (net->pending_lost > UINT32_MAX) ? UINT32_MAX : (uint32_t)net->pending_lost;
+        h->packet_seq = net->packet_seq++;
+        h->first_sequence = f->sequence;
+        h->first_timestamp_ns = f->timestamp_ns;
+        h->gain = (uint8_t)e->gain;
+        h->drate = (uint8_t)e->drate;
+        h->scan_mode = (uint8_t)net->stream.config.dev->scan_mode;
+        h->num_entries = net->stream.scan.num_entries;
+        h->reserved = 0;
+        net->pending_lost = 0;
+        dt = 0;
+    }
+
+    UBYTE *rec = ADS1256_Net_PacketData(net, net->fill) + ADS1256_NET_HEADER_SIZE + (size_t)h->count * ADS1256_NET_RECORD_SIZE;
+    rec[ADS1256_NET_REC_OFF_CODE] = f->value & 0xFF;
+    rec[ADS1256_NET_REC_OFF_CODE + 1] = (f->value >> 8) & 0xFF;
+    rec[ADS1256_NET_REC_OFF_CODE + 2] = (f->value >> 16) & 0xFF;
+    rec[ADS1256_NET_REC_OFF_CHANNEL] = f->channel;
+    ADS1256_Net_Put32(rec + ADS1256_NET_REC_OFF_DT, (uint32_t)dt);
+    net->next_sequence = f->sequence + 1;
+    net->last_timestamp_ns = f->timestamp_ns;
+
+    if (++h->count == net->config.frames_per_packet) ADS1256_Net_EndPacket(net);
+}
+
+/**
+ * @brief Restarts acquisition with new settings, or the old ones if they fail.
+ * @param net Server object.
+ * @param cfg New acquisition settings.
+ * @return ADS1256_OK if the new settings are running, ADS1256_ERROR otherwise.
+ */
+static UBYTE ADS1256_Net_Reconfigure(ads1256_net_t *net, const ads1256_stream_config_t *cfg)
+{
+    ads1256_frame_t block[64];
+    UDOUBLE remaining = ADS1256_Stream_Available(&net->stream);
+
+    // Send what was acquired with the old settings; packets never mix two configurations
+    while (remaining > 0) {
+        UDOUBLE n = ADS1256_Stream_Read(&net->stream, block, remaining < 64 ? remaining : 64, 0);
+        if (n == 0) break;
+        for (UDOUBLE i = 0; i < n; i++) ADS1256_Net_Pack(net, &block[i]);
+        remaining -= n;
+    }
+    ADS1256_Stream_Stop(&net->stream);
+    ADS1256_Net_SendBatch(net);
+
+    if (ADS1256_Stream_Start(&net->stream, cfg) == ADS1256_OK) {
+        net->stream_config = *cfg;
+        net->config_gen++;
+        atomic_fetch_add_explicit(&net->commands, 1, memory_order_relaxed);
+        return ADS1256_OK;
+    }
+    if (ADS1256_Stream_Start(&net->stream, &net->stream_config) != ADS1256_OK) {
+        fprintf(stderr, "ADS1256_Net: Failed to restore the previous acquisition settings\r\n");
+        atomic_store_explicit(&net->running, 0, memory_order_relaxed);
+    }
+    return ADS1256_ERROR;
+}
+
+/**
+ * @brief Applies one text command.
+ * @param net Running server.
+ * @param cmd NUL-terminated command.
+ * @param reply Receives "OK ..." or "ERR ...".
+ * @param reply_size Size of `reply`.
+ * @return ADS1256_OK if the command was applied, ADS1256_ERROR otherwise.
+ */
+UBYTE ADS1256_Net_Command(ads1256_net_t *net, const char *cmd, char *reply, size_t reply_size)
+{
+    ads1256_stream_config_t cfg = net->stream_config;
+    const char *arg = cmd + strcspn(cmd, " \t");
+    size_t len = (size_t)(arg - cmd);
+    char *end;
+
+    arg += strspn(arg, " \t");
+
+    if (len == 6 && strncasecmp(cmd, "STATUS", 6) == 0) {
+        int clients = 0, pos;
+        for (int c = 0; c < ADS1256_NET_MAX_CLIENTS; c++) clients += (net->clients[c] >= 0);
+        pos = snprintf(reply, reply_size, "OK gen=%u drate=%g gain=%d frames=%llu packets=%llu lost=%llu "
+                       "send_errors=%llu clients=%d channels=", net->config_gen, ADS1256_DrateToSps(cfg.drate),
+                       1 << cfg.gain, (unsigned long long)atomic_load(&net->frames),
+                       (unsigned long long)atomic_load(&net->packets_sent), (unsigned long long)atomic_load(&net->lost),
+                       (unsigned long long)atomic_load(&net->send_errors), clients);
+        for (UBYTE i = 0; i < cfg.num_channels && pos > 0 && (size_t)pos < reply_size; i++) {
+            pos += snprintf(reply + pos, reply_size - pos, i ? ",%d" : "%d", cfg.channels[i]);
+        }
+        return ADS1256_OK;
+    }
+
+    if (len == 4 && strncasecmp(cmd, "SCAN", 4) == 0) {
+        UBYTE n = 0;
+        while (*arg && n < NUM_SINGLE_ENDED_CHANNELS) {
+            long ch = strtol(arg, &end, 10);
+            if (end == arg || ch < 0 || ch >= NUM_SINGLE_ENDED_CHANNELS) break;
+            cfg.channels[n++] = (UBYTE)ch;
+            arg = end + strspn(end, ", \t");
+        }
+        if (n == 0 || *arg) {
+            snprintf(reply, reply_size, "ERR SCAN expects 1 to %d channels 0..%d", NUM_SINGLE_ENDED_CHANNELS,
+                     NUM_SINGLE_ENDED_CHANNELS - 1);
+            return ADS1256_ERROR;
+        }
+        cfg.num_channels = n;
+    } else if (len == 5 && strncasecmp(cmd, "DRATE", 5) == 0) {
+        double sps = strtod(arg, &end);
+        int d;
+        for (d = 0; d < ADS1256_DRATE_MAX; d++) {
+            if (fabs(ADS1256_DrateToSps((ADS1256_DRATE)d) - sps) < 0.01) break;
+        }
+        if (end == arg || d == ADS1256_DRATE_MAX) {
+            snprintf(reply, reply_size, "ERR DRATE expects a nominal rate, 30000 .. 2.5");
+            return ADS1256_ERROR;
+        }
+        cfg.drate = (ADS1256_DRATE)d;
+    } else if (len == 4 && strncasecmp(cmd, "GAIN", 4) == 0) {
+        long g = strtol(arg, &end, 10);
+        int e;
+        for (e = ADS1256_GAIN_1; e <= ADS1256_GAIN_64; e++) {
+            if ((1L << e) == g) break;
+        }
+        if (end == arg || e > ADS1256_GAIN_64) {
+            snprintf(reply, reply_size, "ERR GAIN expects 1, 2, 4, 8, 16, 32 or 64");
+            return ADS1256_ERROR;
+        }
+        cfg.gain = (ADS1256_GAIN)e;
+    } else {
+        snprintf(reply, reply_size, "ERR unknown command (SCAN, DRATE, GAIN, STATUS)");
+        return ADS1256_ERROR;
+    }
+
+    if (ADS1256_Net_Reconfigure(net, &cfg) != ADS1256_OK) {
+        snprintf(reply, reply_size, "ERR settings rejected by the ADC, previous settings kept");
+        return ADS1256_ERROR;
+    }
+    snprintf(reply, reply_size, "OK gen=%u", net->config_gen);
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Serves pending commands on the control port.
+ * @param net Server object.
+ */
+static void ADS1256_Net_ServeControl(ads1256_net_t *net)
+{
+    char cmd[ADS1256_NET_CMD_MAX];
+    char reply[ADS1256_NET_CMD_MAX];
+    struct sockaddr_storage from;
+
+    if (net->control_fd < 0) return;
+    for (;;) {
+        socklen_t from_len = sizeof(from);
+        ssize_t r = recvfrom(net->control_fd, cmd, sizeof(cmd) - 1, MSG_DONTWAIT,
+                             (struct sockaddr *)&from, &from_len);
+        if (r < 0) return;
+
+        while (r > 0 && (cmd[r - 1] == '\n' || cmd[r - 1] == '\r' || cmd[r - 1] == ' ')) r--;
+        cmd[r] = '\0';
+        ADS1256_Net_Command(net, cmd, reply, sizeof(reply) - 1);
+        Debug("ADS1256_Net: \"%s\" -> %s\n", cmd, reply);
+        strcat(reply, "\n");
+        sendto(net->control_fd, reply, strlen(reply), MSG_DONTWAIT, (struct sockaddr *)&from, from_len);
+    }
+}
+
+/**
+ * @brief Accepts pending TCP connections.
+ * @param net Server object in TCP mode.
+ */
+static void ADS1256_Net_Accept(ads1256_net_t *net)
+{
+    for (;;) {
+        int fd = accept(net->data_fd, NULL, NULL);
+        if (fd < 0) return;
+
+        int slot;
+        for (slot = 0; slot < ADS1256_NET_MAX_CLIENTS && net->clients[slot] >= 0; slot++) {}
+        if (slot == ADS1256_NET_MAX_CLIENTS) {
+            Debug("ADS1256_Net: Client limit reached, connection refused\n");
+            close(fd);
+            continue;
+        }
+
+        struct timeval tv = { 0, ADS1256_NET_SEND_TIMEOUT_US };
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // Batching is done here, not by Nagle
+        net->clients[slot] = fd;
+        Debug("ADS1256_Net: Client %d connected\n", slot);
+    }
+}
+
+/**
+ * @brief Sender thread body: read, pack, flush, serve the control port.
+ * @param arg The ads1256_net_t being run.
+ * @return NULL.
+ */
+static void *ADS1256_Net_Thread(void *arg)
+{
+    ads1256_net_t *net = (ads1256_net_t *)arg;
+    ads1256_frame_t *block = malloc(ADS1256_NET_READ_BLOCK * sizeof(ads1256_frame_t));
+    const uint64_t flush_ns = (uint64_t)net->config.flush_us * 1000ULL;
+
+    if (!block) {
+        perror("ADS1256_Net: Failed to allocate read block");
+        return NULL;
+    }
+    if (net->config.cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(net->config.cpu, &set);
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (err != 0) {
+            fprintf(stderr, "ADS1256_Net: Failed to pin sender to CPU %d: %s\r\n", net->config.cpu, strerror(err));
+        }
+    }
+
+    while (atomic_load_explicit(&net->running, memory_order_relaxed)) {
+        UBYTE pending = net->fill > 0 || ADS1256_Net_Packet(net, 0)->count > 0;
+        int timeout_ms = ADS1256_NET_IDLE_MS;
+
+        // Wake up in time for the flush deadline of a partial batch
+        if (pending) {
+            uint64_t deadline = net->batch_start_ns + flush_ns;
+            uint64_t now = ADS1256_Net_NowNs();
+            timeout_ms = (deadline > now) ? (int)((deadline - now + 999999) / 1000000) : 0;
+        }
+
+        UDOUBLE n = ADS1256_Stream_Read(&net->stream, block, ADS1256_NET_READ_BLOCK, timeout_ms);
+        for (UDOUBLE i = 0; i < n; i++) ADS1256_Net_Pack(net, &block[i]);
+
+        if ((net->fill > 0 || ADS1256_Net_Packet(net, 0)->count > 0) &&
+            ADS1256_Net_NowNs() - net->batch_start_ns >= flush_ns) {
+            ADS1256_Net_SendBatch(net);
+        }
+        if (net->config.mode == ADS1256_NET_TCP) ADS1256_Net_Accept(net);
+        ADS1256_Net_ServeControl(net);
+    }
+    ADS1256_Net_SendBatch(net);
+    free(block);
+    return NULL;
+}
+
+/**
+ * @brief Closes every socket and frees the batch buffer.
+ * @param net Server object.
+ */
+static void ADS1256_Net_Close(ads1256_net_t *net)
+{
+    for (int c = 0; c < ADS1256_NET_MAX_CLIENTS; c++) {
+        if (net->clients[c] >= 0) ADS1256_Net_DropClient(net, c);
+    }
+    if (net->data_fd >= 0) close(net->data_fd);
+    if (net->control_fd >= 0) close(net->control_fd);
+    net->data_fd = -1;
+    net->control_fd = -1;
+    free(net->packets);
+    net->packets = NULL;
+}
+
+/**
+ * @brief Builds the local address the listener and the control port bind to.
+ * @param net Server object with `config` set.
+ * @param port Port to bind.
+ * @param addr Receives the address.
+ * @return ADS1256_OK on success, ADS1256_ERROR if `bind_addr` is not an IPv4 address.
+ */
+static UBYTE ADS1256_Net_LocalAddr(const ads1256_net_t *net, UWORD port, struct sockaddr_in *addr)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons(port);
+    if (inet_pton(AF_INET, net->config.bind_addr, &addr->sin_addr) != 1) {
+        fprintf(stderr, "ADS1256_Net: Invalid bind address %s\r\n", net->config.bind_addr);
+        return ADS1256_ERROR;
+    }
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Creates a UDP socket bound to `port` on `bind_addr`.
+ * @param net Server object with `config` set.
+ * @param port Port to bind.
+ * @return Socket, or -1 on error.
+ */
+static int ADS1256_Net_BindUdp(const ads1256_net_t *net, UWORD port)
+{
+    struct sockaddr_in addr;
+    if (ADS1256_Net_LocalAddr(net, port, &addr) != ADS1256_OK) return -1;
+
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        fprintf(stderr, "ADS1256_Net: Cannot bind UDP %s:%u: %s\r\n", net->config.bind_addr, port, strerror(errno));
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Opens the data socket: a connected-less UDP sender or a TCP listener.
+ * @param net Server object with `config` set.
+ * @return ADS1256_OK on success, ADS1256_ERROR otherwise.
+ */
+static UBYTE ADS1256_Net_OpenData(ads1256_net_t *net)
+{
+    const ads1256_net_config_t *cfg = &net->config;
+    int one = 1;
+
+    if (cfg->mode == ADS1256_NET_TCP) {
+        struct sockaddr_in addr;
+        if (ADS1256_Net_LocalAddr(net, cfg->port, &addr) != ADS1256_OK) return ADS1256_ERROR;
+        net->data_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (net->data_fd < 0) {
+            perror("ADS1256_Net: socket failed");
+            return ADS1256_ERROR;
+        }
+        setsockopt(net->data_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (bind(net->data_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(net->data_fd, 4) != 0) {
+            fprintf(stderr, "ADS1256_Net: Cannot listen on TCP %s:%u: %s\r\n", cfg->bind_addr, cfg->port,
+                    strerror(errno));
+            return ADS1256_ERROR;
+        }
+        return ADS1256_OK;
+    }
+
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_DGRAM };
+    struct addrinfo *res;
+    char port[8];
+    snprintf(port, sizeof(port), "%u", cfg->port);
+    int err = getaddrinfo(cfg->host, port, &hints, &res);
+    if (err != 0) {
+        fprintf(stderr, "ADS1256_Net: Cannot resolve %s: %s\r\n", cfg->host, gai_strerror(err));
+        return ADS1256_ERROR;
+    }
+    net->data_fd = socket(res->ai_family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (net->data_fd < 0) {
+        perror("ADS1256_Net: socket failed");
+        freeaddrinfo(res);
+        return ADS1256_ERROR;
+    }
+    memcpy(&net->dest, res->ai_addr, res->ai_addrlen);
+    net->dest_len = res->ai_addrlen;
+    freeaddrinfo(res);
+
+    // Room for a few batches, so a short stall on the link does not drop packets
+    int sndbuf = ADS1256_NET_SNDBUF;
+    if (setsockopt(net->data_fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf)) != 0) {
+        Debug("ADS1256_Net: SO_SNDBUF not set: %s\n", strerror(errno));
+    }
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Opens the sockets, starts acquisition and starts the sender thread.
+ * @param net Server object.
+ * @param stream_cfg Acquisition settings (copied).
+ * @param cfg Network configuration (copied).
+ * @return ADS1256_OK on success, ADS1256_ERROR on failure.
+ */
+UBYTE ADS1256_Net_Start(ads1256_net_t *net, const ads1256_stream_config_t *stream_cfg, const ads1256_net_config_t *cfg)
+{
+    if (!net || !stream_cfg || stream_cfg->scan_list || !cfg ||
+        cfg->frames_per_packet == 0 || cfg->frames_per_packet > ADS1256_NET_MAX_FRAMES_PER_PACKET ||
+        cfg->batch_packets == 0 || cfg->batch_packets > ADS1256_NET_MAX_BATCH ||
+        (cfg->mode == ADS1256_NET_UDP && !cfg->host) || !cfg->bind_addr) {
+        fprintf(stderr, "ADS1256_Net_Start: Invalid configuration\r\n");
+        return ADS1256_ERROR;
+    }
+
+    memset(net, 0, sizeof(*net));
+    net->config = *cfg;
+    net->stream_config = *stream_cfg;
+    net->data_fd = -1;
+    net->control_fd = -1;
+    for (int c = 0; c < ADS1256_NET_MAX_CLIENTS; c++) net->clients[c] = -1;
+    atomic_init(&net->frames, 0);
+    atomic_init(&net->packets_sent, 0);
+    atomic_init(&net->send_calls, 0);
+    atomic_init(&net->lost, 0);
+    atomic_init(&net->send_errors, 0);
+    atomic_init(&net->commands, 0);
+    atomic_init(&net->running, 1);
+
+    net->packet_size = ADS1256_NET_HEADER_SIZE + (size_t)cfg->frames_per_packet * ADS1256_NET_RECORD_SIZE;
+    net->packets = calloc(cfg->batch_packets, net->packet_size);
+    if (!net->packets) {
+        perror("ADS1256_Net_Start: Failed to allocate packet buffers");
+        return ADS1256_ERROR;
+    }
+
+    UBYTE status = ADS1256_Net_OpenData(net);
+    if (status == ADS1256_OK && cfg->control_port) {
+        net->control_fd = ADS1256_Net_BindUdp(net, cfg->control_port);
+        if (net->control_fd < 0) status = ADS1256_ERROR;
+    }
+    if (status != ADS1256_OK || ADS1256_Stream_Start(&net->stream, &net->stream_config) != ADS1256_OK) {
+        ADS1256_Net_Close(net);
+        return ADS1256_ERROR;
+    }
+
+    int err = pthread_create(&net->thread, NULL, ADS1256_Net_Thread, net);
+    if (err != 0) {
+        fprintf(stderr, "ADS1256_Net_Start: Failed to create thread: %s\r\n", strerror(err));
+        ADS1256_Stream_Stop(&net->stream);
+        ADS1256_Net_Close(net);
+        return ADS1256_ERROR;
+    }
+    net->thread_started = 1;
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Flushes the pending batch, stops acquisition and closes the sockets.
+ * @param net Server object.
+ * @return ADS1256_OK on success, ADS1256_ERROR if the server was not running.
+ */
+UBYTE ADS1256_Net_Stop(ads1256_net_t *net)
+{
+    if (!net || !net->thread_started) return ADS1256_ERROR;
+
+    atomic_store_explicit(&net->running, 0, memory_order_relaxed);
+    pthread_join(net->thread, NULL);
+    net->thread_started = 0;
+    ADS1256_Stream_Stop(&net->stream);
+    ADS1256_Net_Close(net);
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Prints frame, packet and error counters.
+ * @param net Server object.
+ */
+void ADS1256_Net_PrintReport(ads1256_net_t *net)
+{
+    if (!net) return;
+
+    uint64_t packets = atomic_load(&net->packets_sent);
+    uint64_t calls = atomic_load(&net->send_calls);
+    printf("\n--- Network Stream Report ---\n");
+    printf("Frames sent: %llu, lost before sending: %llu\n", (unsigned long long)atomic_load(&net->frames),
+           (unsigned long long)atomic_load(&net->lost));
+    printf("Packets: %llu in %llu sendmmsg() calls (%.1f per call), send errors: %llu\n",
+           (unsigned long long)packets, (unsigned long long)calls, calls ? (double)packets / calls : 0.0,
+           (unsigned long long)atomic_load(&net->send_errors));
+    printf("Reconfigurations: %llu (generation %u)\n", (unsigned long long)atomic_load(&net->commands),
+           net->config_gen);
+    printf("-----------------------------\n");
+}
+
+/**
+ * @brief Decodes a received packet.
+ * @param data Packet bytes.
+ * @param len Packet length.
+ * @param header Receives the header (may be NULL).
+ * @param frames Output for up to `max` frames.
+ * @param max Capacity of `frames`.
+ * @return Frames decoded, or -1 if the packet is malformed.
+ */
+int ADS1256_Net_Decode(const void *data, size_t len, ads1256_net_header_t *header, ads1256_frame_t *frames, UDOUBLE max)
+{
+    const UBYTE *p = (const UBYTE *)data;
+    ads1256_net_header_t h;
+
+    if (len < ADS1256_NET_HEADER_SIZE) return -1;
+    h.magic = ADS1256_Net_Get32(p + ADS1256_NET_OFF_MAGIC);
+    h.version = ADS1256_Net_Get16(p + ADS1256_NET_OFF_VERSION);
+    h.count = ADS1256_Net_Get16(p + ADS1256_NET_OFF_COUNT);
+    h.config_gen = ADS1256_Net_Get32(p + ADS1256_NET_OFF_CONFIG_GEN);
+    h.lost = ADS1256_Net_Get32(p + ADS1256_NET_OFF_LOST);
+    h.packet_seq = ADS1256_Net_Get64(p + ADS1256_NET_OFF_PACKET_SEQ);
+    h.first_sequence = ADS1256_Net_Get64(p + ADS1256_NET_OFF_FIRST_SEQUENCE);
+    h.first_timestamp_ns = ADS1256_Net_Get64(p + ADS1256_NET_OFF_FIRST_TIME);
+    h.gain = p[ADS1256_NET_OFF_GAIN];
+    h.drate = p[ADS1256_NET_OFF_DRATE];
+    h.scan_mode = p[ADS1256_NET_OFF_SCAN_MODE];
+    h.num_entries = p[ADS1256_NET_OFF_NUM_ENTRIES];
+    h.reserved = ADS1256_Net_Get32(p + ADS1256_NET_OFF_RESERVED);
+    if (h.magic != ADS1256_NET_MAGIC || h.version != ADS1256_NET_VERSION ||
+        len < ADS1256_NET_HEADER_SIZE + (size_t)h.count * ADS1256_NET_RECORD_SIZE) {
+        return -1;
+    }
+    if (header) *header = h;
+
+    p += ADS1256_NET_HEADER_SIZE;
+    uint64_t timestamp = h.first_timestamp_ns;
+    UDOUBLE n = (h.count < max) ? h.count : max;
+    for (UDOUBLE i = 0; i < n; i++, p += ADS1256_NET_RECORD_SIZE) {
+        const UBYTE *code = p + ADS1256_NET_REC_OFF_CODE;
+        uint32_t raw = (uint32_t)code[0] | ((uint32_t)code[1] << 8) | ((uint32_t)code[2] << 16);
+
+        timestamp += ADS1256_Net_Get32(p + ADS1256_NET_REC_OFF_DT);
+        frames[i].timestamp_ns = timestamp;
+        frames[i].sequence = h.first_sequence + i;
+        frames[i].value = (raw & 0x800000) ? (raw | 0xFF000000u) : raw;
+        frames[i].channel = p[ADS1256_NET_REC_OFF_CHANNEL];
+    }
+    return (int)n;
+}
@@ -0,0 +1,226 @@
+/**
+ * @file ADS1256_net.h
+ * @brief Batched binary streaming of ADS1256 frames over UDP or TCP.
+ *
+ * A sender thread drains an ads1256_stream_t, packs frames into packets of
+ * up to `frames_per_packet` records and hands up to `batch_packets` packets
+ * to the kernel with one sendmmsg() call. A batch is sent when it is full or
+ * `flush_us` after its first frame, whichever comes first, so the two knobs
+ * trade latency against packets per second.
+ *
+ * UDP packets go to one destination (unicast or multicast). In TCP mode the
+ * server listens and sends the same packets, back to back, to every
+ * connected client. Each packet carries a packet counter and the sequence
+ * number of its first frame; frames inside a packet have consecutive
+ * sequence numbers, so receivers detect both lost packets and frames lost
+ * before transmission (ring overruns).
+ *
+ * A text command port (UDP) changes the scan list, DRATE and gain while
+ * running; see ADS1256_Net_Command(). Commands are not authenticated: anyone
+ * who can reach the port can reconfigure or stall acquisition. The command
+ * port and the TCP listener therefore bind to `bind_addr`, loopback by
+ * default; only widen it on a trusted network. Packets are serialized field by field
+ * at the fixed offsets below, every multi-byte field little-endian, so the
+ * wire format does not depend on the sender's byte order or struct padding.
+ * The structs are the decoded form only.
+ */
+
+#ifndef _ADS1256_NET_H_
+#define _ADS1256_NET_H_
+
+#include "ADS1256_stream.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sys/socket.h>
+
+/** @name Wire format */
+#define ADS1256_NET_MAGIC   0x314E4441u ///< "ADN1" in the first 4 bytes of every packet
+#define ADS1256_NET_VERSION 1
+#define ADS1256_NET_HEADER_SIZE 48 ///< Bytes of the packet header on the wire
+#define ADS1256_NET_RECORD_SIZE 8  ///< Bytes of one record on the wire
+
+/** @name Header field offsets on the wire */
+#define ADS1256_NET_OFF_MAGIC          0  ///< u32
+#define ADS1256_NET_OFF_VERSION        4  ///< u16
+#define ADS1256_NET_OFF_COUNT          6  ///< u16
+#define ADS1256_NET_OFF_CONFIG_GEN     8  ///< u32
+#define ADS1256_NET_OFF_LOST           12 ///< u32
+#define ADS1256_NET_OFF_PACKET_SEQ     16 ///< u64
+#define ADS1256_NET_OFF_FIRST_SEQUENCE 24 ///< u64
+#define ADS1256_NET_OFF_FIRST_TIME     32 ///< u64
+#define ADS1256_NET_OFF_GAIN           40 ///< u8
+#define ADS1256_NET_OFF_DRATE          41 ///< u8
+#define ADS1256_NET_OFF_SCAN_MODE      42 ///< u8
+#define ADS1256_NET_OFF_NUM_ENTRIES    43 ///< u8
+#define ADS1256_NET_OFF_RESERVED       44 ///< u32, zero
+
+/** @name Record field offsets on the wire */
+#define ADS1256_NET_REC_OFF_CODE       0  ///< 24-bit two's complement code
+#define ADS1256_NET_REC_OFF_CHANNEL    3  ///< u8
+#define ADS1256_NET_REC_OFF_DT         4  ///< u32
+
+/** @name Limits and defaults */
+#define ADS1256_NET_MAX_FRAMES_PER_PACKET 1024
+#define ADS1256_NET_MAX_BATCH             64
+#define ADS1256_NET_MAX_CLIENTS           8
+#define ADS1256_NET_DEFAULT_PORT          5025
+#define ADS1256_NET_DEFAULT_CONTROL_PORT  5026
+#define ADS1256_NET_DEFAULT_FRAMES        176  ///< 48 + 176 * 8 = 1456 bytes, fits a 1500-byte MTU
+#define ADS1256_NET_MTU_PAYLOAD           1472 ///< UDP payload of a 1500-byte IPv4 frame
+#define ADS1256_NET_DEFAULT_BATCH         16
+#define ADS1256_NET_DEFAULT_FLUSH_US      5000
+
+/**
+ * @brief Transport used for data packets.
+ */
+typedef enum {
+    ADS1256_NET_UDP = 0, ///< Datagrams to `host`:`port`
+    ADS1256_NET_TCP,     ///< Listen on `port`, stream to every client
+} ADS1256_NET_MODE;
+
+/**
+ * @brief Decoded packet header. On the wire it takes ADS1256_NET_HEADER_SIZE
+ *        bytes and is followed by `count` records of ADS1256_NET_RECORD_SIZE bytes.
+ */
+typedef struct {
+    uint32_t magic;              ///< ADS1256_NET_MAGIC
+    uint16_t version;            ///< ADS1256_NET_VERSION
+    uint16_t count;              ///< Records in this packet
+    uint32_t config_gen;         ///< Incremented by every applied reconfiguration
+    uint32_t lost;               ///< Frames lost just before this packet (saturated)
+    uint64_t packet_seq;         ///< Packet counter, consecutive per server
+    uint64_t first_sequence;     ///< Sequence number of the first record
+    uint64_t first_timestamp_ns; ///< CLOCK_MONOTONIC time of the first record
+    uint8_t gain;                ///< ADS1256_GAIN of the scan
+    uint8_t drate;               ///< ADS1256_DRATE of the scan
+    uint8_t scan_mode;           ///< ADS1256_SCAN_MODE of the device
+    uint8_t num_entries;         ///< Entries in the scan list
+    uint32_t reserved;
+} ads1256_net_header_t;
+
+/**
+ * @brief One decoded record: 24-bit code, channel label, time since the
+ *        previous record (0 for the first record of a packet).
+ */
+typedef struct {
+    uint8_t code[3]; ///< 24-bit two's complement code, least significant byte first
+    uint8_t channel; ///< Channel label
+    uint32_t dt_ns;  ///< Nanoseconds since the previous record
+} ads1256_net_record_t;
+
+/**
+ * @brief Server configuration. Fill with ADS1256_Net_DefaultConfig().
+ */
+typedef struct {
+    ADS1256_NET_MODE mode;      ///< UDP or TCP
+    const char *host;           ///< UDP destination host or address (unused for TCP)
+    const char *bind_addr;      ///< Local IPv4 address of the TCP listener and the control port ("0.0.0.0" = every interface)
+    UWORD port;                 ///< UDP destination port, or TCP listen port
+    UWORD control_port;         ///< UDP port for text commands, or 0 to disable remote control
+    UWORD frames_per_packet;    ///< Records per packet (1 .. ADS1256_NET_MAX_FRAMES_PER_PACKET)
+    UWORD batch_packets;        ///< Packets per sendmmsg() (1 .. ADS1256_NET_MAX_BATCH)
+    UDOUBLE flush_us;           ///< Send a partial batch this long after its first frame
+    int cpu;                    ///< CPU core to pin the sender to, or -1
+} ads1256_net_config_t;
+
+/**
+ * @brief Server state. Treat as opaque; use the functions below.
+ */
+typedef struct {
+    ads1256_net_config_t config;            ///< Copy of the configuration
+    ads1256_stream_config_t stream_config;  ///< Acquisition settings, changed by commands
+    ads1256_stream_t stream;                ///< Acquisition engine owned by the server
+    int data_fd;                            ///< UDP socket, or TCP listen socket
+    int control_fd;                         ///< Command socket (-1 if disabled)
+    int clients[ADS1256_NET_MAX_CLIENTS];   ///< Connected TCP clients (-1 = free slot)
+    struct sockaddr_storage dest;           ///< UDP destination
+    socklen_t dest_len;                     ///< Length of `dest`
+    ads1256_net_header_t headers[ADS1256_NET_MAX_BATCH]; ///< Headers of the batch, serialized when sent
+    UBYTE *packets;                         ///< batch_packets serialized packet buffers
+    size_t packet_size;                     ///< Bytes per packet buffer
+    UWORD fill;                             ///< Packets completed in the current batch
+    uint64_t batch_start_ns;                ///< Timestamp when the current batch got its first frame
+    uint64_t next_sequence;                 ///< Expected sequence of the next frame
+    uint64_t last_timestamp_ns;             ///< Timestamp of the last record packed
+    uint64_t pending_lost;                  ///< Frames lost since the last record packed
+    uint64_t packet_seq;                    ///< Counter for the next packet header
+    uint32_t config_gen;                    ///< Current configuration generation
+    pthread_t thread;                       ///< Sender thread
+    UBYTE thread_started;                   ///< Non-zero while `thread` must be joined
+    _Atomic int running;                    ///< Cleared to stop the server
+    _Atomic uint64_t frames;                ///< Frames sent
+    _Atomic uint64_t packets_sent;          ///< Packets sent
+    _Atomic uint64_t send_calls;            ///< sendmmsg() calls
+    _Atomic uint64_t lost;                  ///< Frames missing from the sequence
+    _Atomic uint64_t send_errors;           ///< Packets the kernel did not accept
+    _Atomic uint64_t commands;              ///< Commands applied
+} ads1256_net_t;
+
+/**
+ * @brief Fills a configuration with defaults: UDP to 127.0.0.1:5025, commands
+ *        on 5026, listener and command port bound to 127.0.0.1, 176 frames per
+ *        packet, 16 packets per batch, 5 ms flush.
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_Net_DefaultConfig(ads1256_net_config_t *cfg);
+
+/**
+ * @brief Opens the sockets, starts acquisition and starts the sender thread.
+ *
+ * The server owns the stream; the scan list is built from the channels,
+ * gain and DRATE in `stream_cfg` (a prebuilt `scan_list` is not accepted).
+ * Reconfiguration restarts the stream with the new settings, and the
+ * device's register shadow keeps unchanged registers from being rewritten.
+ * @param net Server object.
+ * @param stream_cfg Acquisition settings (copied).
+ * @param cfg Network configuration (copied).
+ * @return ADS1256_OK on success, ADS1256_ERROR on a socket error or an invalid configuration.
+ */
+UBYTE ADS1256_Net_Start(ads1256_net_t *net, const ads1256_stream_config_t *stream_cfg, const ads1256_net_config_t *cfg);
+
+/**
+ * @brief Flushes the pending batch, stops acquisition and closes the sockets.
+ * @param net Server object.
+ * @return ADS1256_OK on success, ADS1256_ERROR if the server was not running.
+ */
+UBYTE ADS1256_Net_Stop(ads1256_net_t *net);
+
+/**
+ * @brief Applies one text command, as received on the control port.
+ *
+ * Commands (case-insensitive, one per datagram):
+ * - `SCAN <ch>[,<ch>...]` channels to scan
+ * - `DRATE <sps>`         nominal data rate, e.g. `DRATE 1000`
+ * - `GAIN <1|2|4|...|64>` PGA gain
+ * - `STATUS`              counters, reply only
+ *
+ * Must be called from the sender thread (the control port does that); it
+ * is public so the same parser can be driven from other front ends.
+ * @param net Running server.
+ * @param cmd NUL-terminated command.
+ * @param reply Receives "OK ..." or "ERR ..." (NUL-terminated).
+ * @param reply_size Size of `reply`.
+ * @return ADS1256_OK if the command was applied, ADS1256_ERROR otherwise.
+ */
+UBYTE ADS1256_Net_Command(ads1256_net_t *net, const char *cmd, char *reply, size_t reply_size);
+
+/**
+ * @brief Prints frame, packet and error counters.
+ * @param net Server object.
+ */
+void ADS1256_Net_PrintReport(ads1256_net_t *net);
+
+/**
+ * @brief Decodes a received packet (receiver side).
+ * @param data Packet bytes.
+ * @param len Packet length.
+ * @param header Receives the header (may be NULL).
+ * @param frames Output for up to `max` frames.
+ * @param max Capacity of `frames`.
+ * @return Frames decoded, or -1 if the packet is malformed.
+ */
+int ADS1256_Net_Decode(const void *data, size_t len, ads1256_net_header_t *header, ads1256_frame_t *frames, UDOUBLE max);
+
+#endif // _ADS1256_NET_H_
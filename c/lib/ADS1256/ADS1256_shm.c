@@ -0,0 +1,313 @@
+/**
+ * @file ADS1256_shm.c
+ * @brief Seqlock broadcast ring in POSIX shared memory.
+ *
+ * The producer writes slot `w & mask` by storing an odd sequence word,
+ * copying the frame and storing 2 * (w + 1) with release ordering, then
+ * advances `head` once per published block. A reader only trusts a slot
+ * whose sequence word matches the index it expects both before and after the
+ * copy; anything else means the producer has since reused the slot.
+ */
+#define _DEFAULT_SOURCE
+#include "ADS1256_shm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define ADS1256_SHM_POLL_NS 200000L // Reader sleep between ring checks while waiting (200 us)
+
+_Static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "64-bit atomics must be lock-free to be shared between processes");
+
+/**
+ * @brief Fills a configuration with defaults.
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_Shm_DefaultConfig(ads1256_shm_config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->name = ADS1256_SHM_DEFAULT_NAME;
+    cfg->capacity = ADS1256_SHM_DEFAULT_RING;
+    cfg->mode = 0644;
+    cfg->forward_frames = 1;
+}
+
+/**
+ * @brief Returns the number of bytes mapped for a ring.
+ * @param capacity Number of slots.
+ * @return Header plus slots.
+ */
+static size_t ADS1256_Shm_MapSize(uint64_t capacity)
+{
+    return sizeof(ads1256_shm_header_t) + capacity * sizeof(ads1256_shm_slot_t);
+}
+
+/**
+ * @brief Creates and maps the ring.
+ * @param shm Producer object.
+ * @param cfg Configuration (copied).
+ * @return ADS1256_OK on success, ADS1256_ERROR on failure.
+ */
+UBYTE ADS1256_Shm_Create(ads1256_shm_t *shm, const ads1256_shm_config_t *cfg)
+{
+    if (!shm || !cfg || !cfg->name || cfg->name[0] != '/' || strlen(cfg->name) >= ADS1256_SHM_NAME_MAX ||
+        strchr(cfg->name + 1, '/')) {
+        fprintf(stderr, "ADS1256_Shm_Create: Name must be \"/name\" shorter than %d characters\r\n",
+                ADS1256_SHM_NAME_MAX);
+        return ADS1256_ERROR;
+    }
+
+    memset(shm, 0, sizeof(*shm));
+    shm->config = *cfg;
+    strcpy(shm->name, cfg->name);
+    shm->config.name = shm->name;
+
+    uint64_t capacity = 2;
+    while (capacity < (cfg->capacity ? cfg->capacity : ADS1256_SHM_DEFAULT_RING)) capacity <<= 1;
+    shm->map_size = ADS1256_Shm_MapSize(capacity);
+    shm->ring_mask = capacity - 1;
+
+    // Unlink first so readers of a stale object keep their mapping and see it as closed
+    shm_unlink(shm->name);
+    int fd = shm_open(shm->name, O_CREAT | O_EXCL | O_RDWR, cfg->mode);
+    if (fd < 0) {
+        perror("ADS1256_Shm_Create: shm_open failed");
+        return ADS1256_ERROR;
+    }
+    fchmod(fd, cfg->mode); // Not reduced by the umask
+    if (ftruncate(fd, (off_t)shm->map_size) != 0) {
+        perror("ADS1256_Shm_Create: ftruncate failed");
+        close(fd);
+        shm_unlink(shm->name);
+        return ADS1256_ERROR;
+    }
+    void *map = mmap(NULL, shm->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("ADS1256_Shm_Create: mmap failed");
+        shm_unlink(shm->name);
+        return ADS1256_ERROR;
+    }
+    memset(map, 0, shm->map_size); // Pre-fault every page before the producer starts
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    shm->hdr = (ads1256_shm_header_t *)map;
+    shm->hdr->slot_size = sizeof(ads1256_shm_slot_t);
+    shm->hdr->capacity = (uint32_t)capacity;
+    shm->hdr->created_ns = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    shm->hdr->producer_pid = (int32_t)getpid();
+    for (uint64_t i = 0; i < capacity; i++) {
+        atomic_init(&shm->hdr->slots[i].seq, 0);
+    }
+    atomic_init(&shm->hdr->head, 0);
+    atomic_init(&shm->hdr->open, 1);
+    shm->hdr->version = ADS1256_SHM_VERSION;
+    atomic_thread_fence(memory_order_release);
+    shm->hdr->magic = ADS1256_SHM_MAGIC; // Last, so a reader never sees a half-initialized header
+
+    Debug("ADS1256_Shm_Create: %s, %llu slots, %zu bytes\n", shm->name, (unsigned long long)capacity, shm->map_size);
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Publishes frames to every reader (producer thread only).
+ * @param shm Producer object.
+ * @param frames Frames.
+ * @param n Number of frames.
+ */
+void ADS1256_Shm_Publish(ads1256_shm_t *shm, const ads1256_frame_t *frames, UDOUBLE n)
+{
+    ads1256_shm_header_t *hdr = shm->hdr;
+    uint64_t w = shm->head;
+
+    for (UDOUBLE i = 0; i < n; i++, w++) {
+        ads1256_shm_slot_t *slot = &hdr->slots[w & shm->ring_mask];
+        atomic_store_explicit(&slot->seq, 2 * w + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        slot->frame = frames[i];
+        atomic_store_explicit(&slot->seq, 2 * w + 2, memory_order_release);
+    }
+    shm->head = w;
+    atomic_store_explicit(&hdr->head, w, memory_order_release);
+}
+
+/**
+ * @brief Marks the ring closed, unmaps it and removes its name.
+ * @param shm Producer object.
+ */
+void ADS1256_Shm_Destroy(ads1256_shm_t *shm)
+{
+    if (!shm || !shm->hdr) return;
+
+    atomic_store_explicit(&shm->hdr->open, 0, memory_order_release);
+    munmap(shm->hdr, shm->map_size);
+    shm_unlink(shm->name);
+    shm->hdr = NULL;
+}
+
+/**
+ * @brief Maps a producer's ring read-only.
+ * @param reader Reader object.
+ * @param name Object name passed to the producer.
+ * @return ADS1256_OK on success, ADS1256_ERROR otherwise.
+ */
+UBYTE ADS1256_Shm_Attach(ads1256_shm_reader_t *reader, const char *name)
+{
+    if (!reader || !name) return ADS1256_ERROR;
+    memset(reader, 0, sizeof(*reader));
+
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        Debug("ADS1256_Shm_Attach: %s: %s\n", name, strerror(errno));
+        return ADS1256_ERROR;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ads1256_shm_header_t)) {
+        close(fd);
+        return ADS1256_ERROR; // Producer is still sizing it
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("ADS1256_Shm_Attach: mmap failed");
+        return ADS1256_ERROR;
+    }
+
+    const ads1256_shm_header_t *hdr = (const ads1256_shm_header_t *)map;
+    UBYTE valid = (hdr->magic == ADS1256_SHM_MAGIC);
+    atomic_thread_fence(memory_order_acquire);
+    if (valid && (hdr->version != ADS1256_SHM_VERSION || hdr->slot_size != sizeof(ads1256_shm_slot_t) ||
+                  hdr->capacity < 2 || (hdr->capacity & (hdr->capacity - 1)) != 0 ||
+                  ADS1256_Shm_MapSize(hdr->capacity) > (size_t)st.st_size)) {
+        fprintf(stderr, "ADS1256_Shm_Attach: %s has an incompatible layout\r\n", name);
+        valid = 0;
+    }
+    if (!valid) {
+        munmap(map, (size_t)st.st_size);
+        return ADS1256_ERROR;
+    }
+
+    reader->hdr = hdr;
+    reader->map_size = (size_t)st.st_size;
+    reader->ring_mask = hdr->capacity - 1;
+    reader->cursor = atomic_load_explicit(&hdr->head, memory_order_acquire);
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Returns the number of frames published but not yet read by this reader.
+ * @param reader Attached reader.
+ * @return Pending frames.
+ */
+UDOUBLE ADS1256_Shm_Available(ads1256_shm_reader_t *reader)
+{
+    uint64_t head = atomic_load_explicit(&reader->hdr->head, memory_order_acquire);
+    return (head > reader->cursor) ? (UDOUBLE)(head - reader->cursor) : 0;
+}
+
+/**
+ * @brief Moves a lapped reader past every frame the producer may have overwritten.
+ * @param reader Attached reader.
+ * @param newest Highest ring index the producer is known to have started writing.
+ */
+static void ADS1256_Shm_Skip(ads1256_shm_reader_t *reader, uint64_t newest)
+{
+    if (newest < reader->ring_mask) return;
+
+    uint64_t oldest = newest - reader->ring_mask; // Writing `newest` destroys `newest - capacity`
+    if (reader->cursor < oldest) {
+        reader->overruns += oldest - reader->cursor;
+        reader->cursor = oldest;
+    }
+}
+
+/**
+ * @brief Copies up to `max` frames from the reader's cursor.
+ * @param reader Attached reader.
+ * @param out Output array for at least `max` frames.
+ * @param max Maximum number of frames to copy.
+ * @param timeout_ms Time to wait for data if none is pending (0 = return immediately).
+ * @return Number of frames copied.
+ */
+UDOUBLE ADS1256_Shm_Read(ads1256_shm_reader_t *reader, ads1256_frame_t *out, UDOUBLE max, int timeout_ms)
+{
+    if (!reader || !reader->hdr || !out || max == 0) return 0;
+
+    UDOUBLE avail = ADS1256_Shm_Available(reader);
+    if (avail == 0 && timeout_ms > 0) {
+        struct timespec pause = { 0, ADS1256_SHM_POLL_NS };
+        long waited_ns = 0;
+        while (avail == 0 && waited_ns < timeout_ms * 1000000L &&
+               atomic_load_explicit(&reader->hdr->open, memory_order_relaxed)) {
+            nanosleep(&pause, NULL);
+            waited_ns += ADS1256_SHM_POLL_NS;
+            avail = ADS1256_Shm_Available(reader);
+        }
+    }
+    if (avail == 0) return 0;
+
+    uint64_t head = atomic_load_explicit(&reader->hdr->head, memory_order_acquire);
+    ADS1256_Shm_Skip(reader, head);
+    UDOUBLE count = 0;
+    while (count < max && reader->cursor < head) {
+        const ads1256_shm_slot_t *slot = &reader->hdr->slots[reader->cursor & reader->ring_mask];
+        uint64_t expected = 2 * reader->cursor + 2;
+        uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+
+        if (seq == expected) {
+            out[count] = slot->frame;
+            atomic_thread_fence(memory_order_acquire);
+            seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+            if (seq == expected) {
+                count++;
+                reader->cursor++;
+                continue;
+            }
+        }
+        // The producer reused the slot for index (seq - 1) / 2, so it has lapped this reader
+        ADS1256_Shm_Skip(reader, (seq - 1) / 2);
+        head = atomic_load_explicit(&reader->hdr->head, memory_order_acquire);
+    }
+    return count;
+}
+
+/**
+ * @brief Returns the number of frames this reader lost to the producer lapping it.
+ * @param reader Reader object.
+ * @return Overrun counter.
+ */
+uint64_t ADS1256_Shm_ReaderOverruns(const ads1256_shm_reader_t *reader)
+{
+    return reader->overruns;
+}
+
+/**
+ * @brief Checks whether the producer still publishes into the ring.
+ * @param reader Attached reader.
+ * @return 1 while the ring is open and its producer is running, 0 otherwise.
+ */
+int ADS1256_Shm_ProducerAlive(const ads1256_shm_reader_t *reader)
+{
+    if (!reader || !reader->hdr) return 0;
+    if (!atomic_load_explicit(&reader->hdr->open, memory_order_acquire)) return 0;
+    return kill((pid_t)reader->hdr->producer_pid, 0) == 0 || errno == EPERM; // Catches a crashed producer
+}
+
+/**
+ * @brief Unmaps the ring.
+ * @param reader Reader object.
+ */
+void ADS1256_Shm_Detach(ads1256_shm_reader_t *reader)
+{
+    if (!reader || !reader->hdr) return;
+
+    munmap((void *)reader->hdr, reader->map_size);
+    reader->hdr = NULL;
+}
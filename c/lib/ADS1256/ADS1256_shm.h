@@ -0,0 +1,172 @@
+/**
+ * @file ADS1256_shm.h
+ * @brief Shared-memory broadcast of acquired frames to other local processes.
+ *
+ * Only one process can own the SPI device. With ads1256_stream_config_t::shm
+ * set, the acquisition thread also publishes every frame into a POSIX
+ * shared-memory ring (shm_open() + mmap()) that any number of local processes
+ * map read-only: a logger, a dashboard and a control loop all see the same
+ * data with no extra SPI traffic and no cost to the producer per reader.
+ *
+ * The ring is single-producer/multi-consumer and never waits for readers.
+ * Each slot carries its own sequence word, following the seqlock used for the
+ * statistics summaries: it is odd while the slot is written and 2 * (index + 1)
+ * once it holds ring index `index`. A reader keeps a private cursor and checks
+ * that word before and after copying a slot. If the writer has lapped it, the
+ * reader skips forward to the oldest slot still valid and counts the lost
+ * frames in its own overrun counter. Slow readers therefore only ever hurt
+ * themselves.
+ */
+
+#ifndef _ADS1256_SHM_H_
+#define _ADS1256_SHM_H_
+
+#include "ADS1256.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <sys/types.h>
+
+#define ADS1256_SHM_MAGIC        0x4D485341u // "ASHM"
+#define ADS1256_SHM_VERSION      1
+#define ADS1256_SHM_DEFAULT_NAME "/ads1256"
+#define ADS1256_SHM_DEFAULT_RING 65536       ///< Slots (rounded up to a power of two)
+#define ADS1256_SHM_CACHE_LINE   64
+#define ADS1256_SHM_NAME_MAX     64
+
+/**
+ * @brief One ring slot.
+ */
+typedef struct {
+    _Atomic uint64_t seq;   ///< Odd while being written, 2 * (index + 1) once it holds ring index `index`
+    ads1256_frame_t frame;  ///< The frame
+} ads1256_shm_slot_t;
+
+/**
+ * @brief Layout at the start of the shared-memory object, followed by the slots.
+ */
+typedef struct {
+    uint32_t magic;         ///< ADS1256_SHM_MAGIC
+    uint32_t version;       ///< ADS1256_SHM_VERSION
+    uint32_t slot_size;     ///< sizeof(ads1256_shm_slot_t) of the producer
+    uint32_t capacity;      ///< Number of slots, a power of two
+    uint64_t created_ns;    ///< CLOCK_MONOTONIC time the producer created the ring
+    int32_t producer_pid;   ///< Process publishing into the ring
+    _Alignas(ADS1256_SHM_CACHE_LINE) _Atomic uint64_t head; ///< Frames published so far
+    _Atomic uint32_t open;  ///< Cleared by the producer when it closes the ring
+    _Alignas(ADS1256_SHM_CACHE_LINE) ads1256_shm_slot_t slots[]; ///< `capacity` slots
+} ads1256_shm_header_t;
+
+/**
+ * @brief Producer configuration. Fill with ADS1256_Shm_DefaultConfig().
+ */
+typedef struct {
+    const char *name;       ///< Object name for shm_open(), starting with '/'
+    UDOUBLE capacity;       ///< Ring size in frames (rounded up to a power of two)
+    mode_t mode;            ///< Permissions of the object (readers need read access only)
+    UBYTE forward_frames;   ///< Non-zero to still put every frame into the stream ring
+} ads1256_shm_config_t;
+
+/**
+ * @brief Producer side. Treat as opaque.
+ */
+typedef struct {
+    ads1256_shm_config_t config;   ///< Copy of the configuration; `name` points at `name`
+    char name[ADS1256_SHM_NAME_MAX];
+    ads1256_shm_header_t *hdr;     ///< Mapped object
+    size_t map_size;               ///< Bytes mapped
+    uint64_t ring_mask;            ///< capacity - 1
+    uint64_t head;                 ///< Producer's copy of hdr->head
+} ads1256_shm_t;
+
+/**
+ * @brief Reader side. Each reader has its own cursor and overrun count.
+ */
+typedef struct {
+    const ads1256_shm_header_t *hdr; ///< Object mapped read-only
+    size_t map_size;                 ///< Bytes mapped
+    uint64_t ring_mask;              ///< capacity - 1
+    uint64_t cursor;                 ///< Ring index of the next frame to read
+    uint64_t overruns;               ///< Frames skipped because the producer lapped this reader
+} ads1256_shm_reader_t;
+
+/**
+ * @brief Fills a configuration with defaults: "/ads1256", 64k frames,
+ *        mode 0644, frames still forwarded to the stream ring.
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_Shm_DefaultConfig(ads1256_shm_config_t *cfg);
+
+/**
+ * @brief Creates (replacing any stale object of the same name) and maps the ring.
+ *
+ * Readers still attached to a replaced object see it as closed.
+ * @param shm Producer object.
+ * @param cfg Configuration (copied).
+ * @return ADS1256_OK on success, ADS1256_ERROR on an invalid name or a system call failure.
+ */
+UBYTE ADS1256_Shm_Create(ads1256_shm_t *shm, const ads1256_shm_config_t *cfg);
+
+/**
+ * @brief Publishes frames to every reader (producer thread only). Never blocks.
+ * @param shm Producer object.
+ * @param frames Frames.
+ * @param n Number of frames.
+ */
+void ADS1256_Shm_Publish(ads1256_shm_t *shm, const ads1256_frame_t *frames, UDOUBLE n);
+
+/**
+ * @brief Marks the ring closed, unmaps it and removes its name.
+ * @param shm Producer object (no longer published to).
+ */
+void ADS1256_Shm_Destroy(ads1256_shm_t *shm);
+
+/**
+ * @brief Maps a producer's ring read-only. The reader starts at the newest frame.
+ * @param reader Reader object.
+ * @param name Object name passed to the producer.
+ * @return ADS1256_OK on success, ADS1256_ERROR if the ring does not exist or is incompatible.
+ */
+UBYTE ADS1256_Shm_Attach(ads1256_shm_reader_t *reader, const char *name);
+
+/**
+ * @brief Copies up to `max` frames from the reader's cursor.
+ *
+ * Frames overwritten before they could be read are skipped and added to
+ * ADS1256_Shm_ReaderOverruns(); the frame sequence numbers show where.
+ * @param reader Attached reader.
+ * @param out Output array for at least `max` frames.
+ * @param max Maximum number of frames to copy.
+ * @param timeout_ms Time to wait for data if none is pending (0 = return immediately).
+ * @return Number of frames copied (0 on timeout or once the producer has closed the ring).
+ */
+UDOUBLE ADS1256_Shm_Read(ads1256_shm_reader_t *reader, ads1256_frame_t *out, UDOUBLE max, int timeout_ms);
+
+/**
+ * @brief Returns the number of frames published but not yet read by this reader.
+ * @param reader Attached reader.
+ * @return Pending frames (may exceed the capacity if the reader was lapped).
+ */
+UDOUBLE ADS1256_Shm_Available(ads1256_shm_reader_t *reader);
+
+/**
+ * @brief Returns the number of frames this reader lost to the producer lapping it.
+ * @param reader Reader object.
+ * @return Overrun counter.
+ */
+uint64_t ADS1256_Shm_ReaderOverruns(const ads1256_shm_reader_t *reader);
+
+/**
+ * @brief Checks whether the producer still publishes into the ring.
+ * @param reader Attached reader.
+ * @return 1 while the ring is open and its producer is running, 0 otherwise (detach and attach again).
+ */
+int ADS1256_Shm_ProducerAlive(const ads1256_shm_reader_t *reader);
+
+/**
+ * @brief Unmaps the ring.
+ * @param reader Reader object.
+ */
+void ADS1256_Shm_Detach(ads1256_shm_reader_t *reader);
+
+#endif // _ADS1256_SHM_H_
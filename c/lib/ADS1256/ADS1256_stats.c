@@ -0,0 +1,370 @@
+/**
+ * @file ADS1256_stats.c
+ * @brief Running statistics, seqlock-published summaries and trigger capture.
+ *
+ * The acquisition thread is the only writer. Summaries are published under
+ * a per-channel sequence counter (odd while an update is in progress), so a
+ * reader retries instead of blocking the writer. Trigger windows are filled
+ * in place in preallocated slots that are handed to the consumer in
+ * reservation order once complete.
+ */
+#include "ADS1256_stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/**
+ * @brief Fills a configuration with defaults.
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_Stats_DefaultConfig(ads1256_stats_config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->interval_ns = ADS1256_STATS_DEFAULT_INTERVAL_NS;
+    cfg->event_slots = ADS1256_STATS_DEFAULT_EVENTS;
+    cfg->max_window = ADS1256_STATS_DEFAULT_WINDOW;
+    cfg->forward_frames = 1;
+}
+
+/**
+ * @brief Clears an accumulator.
+ * @param acc Accumulator.
+ */
+static void ADS1256_Stats_AccReset(ads1256_stats_acc_t *acc)
+{
+    memset(acc, 0, sizeof(*acc));
+    acc->min = INT32_MAX;
+    acc->max = INT32_MIN;
+}
+
+/**
+ * @brief Adds one value to an accumulator (Welford update).
+ * @param acc Accumulator.
+ * @param x Value in code units.
+ * @param timestamp_ns Timestamp of the value.
+ */
+static void ADS1256_Stats_AccAdd(ads1256_stats_acc_t *acc, int32_t x, uint64_t timestamp_ns)
+{
+    double delta = x - acc->mean;
+
+    if (acc->count++ == 0) acc->start_ns = timestamp_ns;
+    acc->end_ns = timestamp_ns;
+    acc->mean += delta / (double)acc->count;
+    acc->m2 += delta * (x - acc->mean);
+    acc->sum_sq += (double)x * x;
+    if (x < acc->min) acc->min = x;
+    if (x > acc->max) acc->max = x;
+}
+
+/**
+ * @brief Converts an accumulator to a summary.
+ * @param acc Accumulator with at least one value.
+ * @param out Summary to fill.
+ */
+static void ADS1256_Stats_Summarize(const ads1256_stats_acc_t *acc, ads1256_stats_summary_t *out)
+{
+    out->count = acc->count;
+    out->min = acc->min;
+    out->max = acc->max;
+    out->mean = acc->mean;
+    out->stddev = (acc->count > 1) ? sqrt(acc->m2 / (double)(acc->count - 1)) : 0.0;
+    out->rms = sqrt(acc->sum_sq / (double)acc->count);
+    out->start_ns = acc->start_ns;
+    out->end_ns = acc->end_ns;
+}
+
+/**
+ * @brief Allocates the event slots and clears every channel.
+ * @param stats Engine.
+ * @param cfg Configuration (copied).
+ * @return ADS1256_OK on success, ADS1256_ERROR otherwise.
+ */
+UBYTE ADS1256_Stats_Init(ads1256_stats_t *stats, const ads1256_stats_config_t *cfg)
+{
+    if (!stats || !cfg || cfg->interval_ns == 0 || cfg->event_slots == 0 || cfg->max_window < 2) {
+        fprintf(stderr, "ADS1256_Stats_Init: Invalid configuration\r\n");
+        return ADS1256_ERROR;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    stats->config = *cfg;
+    for (int c = 0; c < ADS1256_STATS_MAX_CHANNELS; c++) {
+        ADS1256_Stats_AccReset(&stats->channels[c].interval);
+        ADS1256_Stats_AccReset(&stats->channels[c].total);
+        atomic_init(&stats->channels[c].seq, 0);
+    }
+    atomic_init(&stats->slot_tail, 0);
+    atomic_init(&stats->frames, 0);
+    atomic_init(&stats->triggers, 0);
+    atomic_init(&stats->events_dropped, 0);
+
+    stats->slots = calloc(cfg->event_slots, sizeof(ads1256_stats_slot_t));
+    if (!stats->slots) {
+        perror("ADS1256_Stats_Init: Failed to allocate event slots");
+        return ADS1256_ERROR;
+    }
+    for (UBYTE i = 0; i < cfg->event_slots; i++) {
+        atomic_init(&stats->slots[i].ready, 0);
+        stats->slots[i].event.frames = malloc(cfg->max_window * sizeof(ads1256_frame_t));
+        if (!stats->slots[i].event.frames) {
+            perror("ADS1256_Stats_Init: Failed to allocate event window");
+            ADS1256_Stats_Free(stats);
+            return ADS1256_ERROR;
+        }
+        // Pre-fault the window so the first trigger does not page-fault on the RT thread
+        memset(stats->slots[i].event.frames, 0, cfg->max_window * sizeof(ads1256_frame_t));
+    }
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Sets (or removes) the trigger of a channel.
+ * @param stats Engine.
+ * @param channel Channel label.
+ * @param trig Trigger configuration, or NULL.
+ * @return ADS1256_OK on success, ADS1256_ERROR otherwise.
+ */
+UBYTE ADS1256_Stats_SetTrigger(ads1256_stats_t *stats, UBYTE channel, const ads1256_trigger_config_t *trig)
+{
+    if (!stats || channel >= ADS1256_STATS_MAX_CHANNELS) return ADS1256_ERROR;
+    if (trig && (trig->mode > ADS1256_TRIG_FALLING || trig->post == 0 || trig->hysteresis < 0 ||
+                 (UDOUBLE)trig->pre + trig->post > stats->config.max_window)) {
+        fprintf(stderr, "ADS1256_Stats_SetTrigger: Invalid trigger for channel %d\r\n", channel);
+        return ADS1256_ERROR;
+    }
+
+    ads1256_stats_channel_t *ch = &stats->channels[channel];
+    free(ch->history);
+    ch->history = NULL;
+    ch->history_pos = ch->history_fill = 0;
+    ch->capture = NULL;
+    memset(&ch->trigger, 0, sizeof(ch->trigger));
+    if (!trig) return ADS1256_OK;
+
+    if (trig->pre) {
+        ch->history = calloc(trig->pre, sizeof(ads1256_frame_t));
+        if (!ch->history) {
+            perror("ADS1256_Stats_SetTrigger: Failed to allocate history");
+            return ADS1256_ERROR;
+        }
+    }
+    ch->trigger = *trig;
+    // Level triggers may fire on the first frame; edges need to see the other side first
+    ch->armed = (trig->mode == ADS1256_TRIG_ABOVE || trig->mode == ADS1256_TRIG_BELOW);
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Publishes the finished interval of a channel and starts the next one.
+ * @param ch Channel state.
+ */
+static void ADS1256_Stats_Publish(ads1256_stats_channel_t *ch)
+{
+    uint32_t seq = atomic_load_explicit(&ch->seq, memory_order_relaxed);
+
+    atomic_store_explicit(&ch->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    ADS1256_Stats_Summarize(&ch->interval, &ch->published_interval);
+    ADS1256_Stats_Summarize(&ch->total, &ch->published_total);
+    atomic_store_explicit(&ch->seq, seq + 2, memory_order_release);
+
+    ADS1256_Stats_AccReset(&ch->interval);
+}
+
+/**
+ * @brief Evaluates the trigger condition for one value and updates the arming state.
+ * @param ch Channel state with a trigger.
+ * @param x Value.
+ * @return Non-zero if the trigger fires.
+ */
+static UBYTE ADS1256_Stats_Fires(ads1256_stats_channel_t *ch, int32_t x)
+{
+    const ads1256_trigger_config_t *t = &ch->trigger;
+    int64_t low = (int64_t)t->level - t->hysteresis;
+    int64_t high = (int64_t)t->level + t->hysteresis;
+    UBYTE fire = 0;
+
+    switch (t->mode) {
+        case ADS1256_TRIG_ABOVE:
+            fire = ch->armed && x > t->level;
+            if (!ch->armed && x <= low) ch->armed = 1;
+            break;
+        case ADS1256_TRIG_BELOW:
+            fire = ch->armed && x < t->level;
+            if (!ch->armed && x >= high) ch->armed = 1;
+            break;
+        case ADS1256_TRIG_RISING:
+            if (x <= low) ch->armed = 1;
+            else fire = ch->armed && x >= t->level;
+            break;
+        case ADS1256_TRIG_FALLING:
+            if (x >= high) ch->armed = 1;
+            else fire = ch->armed && x <= t->level;
+            break;
+        default:
+            break;
+    }
+    if (fire) ch->armed = 0;
+    return fire;
+}
+
+/**
+ * @brief Starts a capture window: reserves a slot and copies the pre-trigger history.
+ * @param stats Engine.
+ * @param ch Channel state.
+ * @param f Triggering frame.
+ */
+static void ADS1256_Stats_StartCapture(ads1256_stats_t *stats, ads1256_stats_channel_t *ch, const ads1256_frame_t *f)
+{
+    uint64_t tail = atomic_load_explicit(&stats->slot_tail, memory_order_acquire);
+
+    atomic_fetch_add_explicit(&stats->triggers, 1, memory_order_relaxed);
+    if (stats->slot_head - tail >= stats->config.event_slots) {
+        atomic_fetch_add_explicit(&stats->events_dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    ads1256_stats_slot_t *slot = &stats->slots[stats->slot_head++ % stats->config.event_slots];
+    ads1256_stats_event_t *ev = &slot->event;
+    UWORD pre = ch->trigger.pre;
+
+    ev->channel = f->channel;
+    ev->mode = ch->trigger.mode;
+    ev->trigger_ns = f->timestamp_ns;
+    ev->trigger_sequence = f->sequence;
+    ev->pre_count = ch->history_fill;
+    // Oldest first: the history is full from history_pos on, or filled from 0 up to history_pos
+    for (UWORD i = 0; i < ch->history_fill; i++) {
+        UWORD idx = (ch->history_fill == pre) ? (UWORD)((ch->history_pos + i) % pre) : i;
+        ev->frames[i] = ch->history[idx];
+    }
+    ev->frames[ev->pre_count] = *f;
+    ev->count = ev->pre_count + 1;
+
+    if (ch->trigger.post == 1) {
+        atomic_store_explicit(&slot->ready, 1, memory_order_release);
+    } else {
+        ch->capture = slot;
+    }
+}
+
+/**
+ * @brief Updates statistics and triggers with a block of frames.
+ * @param stats Engine.
+ * @param frames Frames.
+ * @param n Number of frames.
+ */
+void ADS1256_Stats_Update(ads1256_stats_t *stats, const ads1256_frame_t *frames, UDOUBLE n)
+{
+    for (UDOUBLE i = 0; i < n; i++) {
+        const ads1256_frame_t *f = &frames[i];
+        if (f->channel >= ADS1256_STATS_MAX_CHANNELS) continue;
+
+        ads1256_stats_channel_t *ch = &stats->channels[f->channel];
+        int32_t x = (int32_t)f->value;
+
+        if (ch->interval.count && f->timestamp_ns - ch->interval.start_ns >= stats->config.interval_ns) {
+            ADS1256_Stats_Publish(ch);
+        }
+        ADS1256_Stats_AccAdd(&ch->interval, x, f->timestamp_ns);
+        ADS1256_Stats_AccAdd(&ch->total, x, f->timestamp_ns);
+
+        if (ch->trigger.mode == ADS1256_TRIG_OFF) continue;
+
+        if (ch->capture) {
+            ads1256_stats_event_t *ev = &ch->capture->event;
+            ev->frames[ev->count++] = *f;
+            if (ev->count == ev->pre_count + ch->trigger.post) {
+                atomic_store_explicit(&ch->capture->ready, 1, memory_order_release);
+                ch->capture = NULL;
+            }
+        } else if (ADS1256_Stats_Fires(ch, x)) {
+            ADS1256_Stats_StartCapture(stats, ch, f);
+        }
+
+        if (ch->trigger.pre) {
+            ch->history[ch->history_pos] = *f;
+            ch->history_pos = (ch->history_pos + 1 == ch->trigger.pre) ? 0 : ch->history_pos + 1;
+            if (ch->history_fill < ch->trigger.pre) ch->history_fill++;
+        }
+    }
+    atomic_fetch_add_explicit(&stats->frames, n, memory_order_relaxed);
+}
+
+/**
+ * @brief Reads the published summaries of a channel.
+ * @param stats Engine.
+ * @param channel Channel label.
+ * @param interval Receives the last completed interval (may be NULL).
+ * @param total Receives the totals up to the end of that interval (may be NULL).
+ * @return ADS1256_OK if an interval has completed, ADS1256_ERROR otherwise.
+ */
+UBYTE ADS1256_Stats_Get(ads1256_stats_t *stats, UBYTE channel, ads1256_stats_summary_t *interval,
+                        ads1256_stats_summary_t *total)
+{
+    if (!stats || channel >= ADS1256_STATS_MAX_CHANNELS) return ADS1256_ERROR;
+
+    ads1256_stats_channel_t *ch = &stats->channels[channel];
+    ads1256_stats_summary_t a, b;
+    uint32_t s1, s2;
+
+    do {
+        s1 = atomic_load_explicit(&ch->seq, memory_order_acquire);
+        if (s1 & 1) continue;
+        a = ch->published_interval;
+        b = ch->published_total;
+        atomic_thread_fence(memory_order_acquire);
+        s2 = atomic_load_explicit(&ch->seq, memory_order_relaxed);
+    } while ((s1 & 1) || s1 != s2);
+
+    if (s1 == 0) return ADS1256_ERROR;
+    if (interval) *interval = a;
+    if (total) *total = b;
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Takes the oldest completed trigger window.
+ * @param stats Engine.
+ * @param event Receives the event.
+ * @param frames Output for the window.
+ * @param max Capacity of `frames`.
+ * @return 1 if an event was returned, 0 if none is ready.
+ */
+int ADS1256_Stats_PollEvent(ads1256_stats_t *stats, ads1256_stats_event_t *event, ads1256_frame_t *frames, UDOUBLE max)
+{
+    uint64_t tail = atomic_load_explicit(&stats->slot_tail, memory_order_relaxed);
+    ads1256_stats_slot_t *slot = &stats->slots[tail % stats->config.event_slots];
+
+    if (!atomic_load_explicit(&slot->ready, memory_order_acquire)) return 0;
+
+    *event = slot->event;
+    if (event->count > max) event->count = max;
+    memcpy(frames, slot->event.frames, event->count * sizeof(ads1256_frame_t));
+    event->frames = frames;
+
+    atomic_store_explicit(&slot->ready, 0, memory_order_relaxed);
+    atomic_store_explicit(&stats->slot_tail, tail + 1, memory_order_release);
+    return 1;
+}
+
+/**
+ * @brief Frees the event slots and trigger histories.
+ * @param stats Engine.
+ */
+void ADS1256_Stats_Free(ads1256_stats_t *stats)
+{
+    if (!stats) return;
+
+    for (int c = 0; c < ADS1256_STATS_MAX_CHANNELS; c++) {
+        free(stats->channels[c].history);
+        stats->channels[c].history = NULL;
+        stats->channels[c].capture = NULL;
+    }
+    if (stats->slots) {
+        for (UBYTE i = 0; i < stats->config.event_slots; i++) free(stats->slots[i].event.frames);
+        free(stats->slots);
+        stats->slots = NULL;
+    }
+}
@@ -0,0 +1,199 @@
+/**
+ * @file ADS1256_stats.h
+ * @brief Per-channel running statistics and threshold triggers on the acquisition path.
+ *
+ * Attached to ads1256_stream_config_t::stats, the engine is updated by the
+ * acquisition thread for every frame before it enters the ring (after the
+ * DSP stage, if any). It keeps, per channel label:
+ *
+ * - running min/max/mean/variance (Welford) and RMS, published as a summary
+ *   for each completed interval (default 1 s) and since the start;
+ * - a level or edge trigger that captures a window of frames around each
+ *   event (pre-trigger history plus post-trigger frames).
+ *
+ * A consumer polls ADS1256_Stats_Get() and ADS1256_Stats_PollEvent(); both
+ * are lock-free and never block the acquisition thread. With
+ * `forward_frames` cleared, raw frames are not put into the ring at all, so
+ * only summaries and trigger windows leave the acquisition path.
+ */
+
+#ifndef _ADS1256_STATS_H_
+#define _ADS1256_STATS_H_
+
+#include "ADS1256.h"
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define ADS1256_STATS_MAX_CHANNELS   16         ///< Channel labels 0..15 are tracked
+#define ADS1256_STATS_DEFAULT_INTERVAL_NS 1000000000ULL
+#define ADS1256_STATS_DEFAULT_EVENTS 8          ///< Event slots
+#define ADS1256_STATS_DEFAULT_WINDOW 1024       ///< Frames per event (pre + post)
+
+/**
+ * @brief Trigger condition.
+ */
+typedef enum {
+    ADS1256_TRIG_OFF = 0,
+    ADS1256_TRIG_ABOVE,   ///< Level: value > level while armed
+    ADS1256_TRIG_BELOW,   ///< Level: value < level while armed
+    ADS1256_TRIG_RISING,  ///< Edge: value crosses level upwards (armed once seen below level - hysteresis)
+    ADS1256_TRIG_FALLING, ///< Edge: value crosses level downwards (armed once seen above level + hysteresis)
+} ADS1256_TRIG_MODE;
+
+/**
+ * @brief Trigger configuration of one channel. Levels are in code units.
+ */
+typedef struct {
+    ADS1256_TRIG_MODE mode;
+    int32_t level;       ///< Threshold
+    int32_t hysteresis;  ///< Distance back past the level needed to re-arm
+    UWORD pre;           ///< Frames of this channel kept from before the trigger
+    UWORD post;          ///< Frames of this channel captured from the trigger on (>= 1)
+} ads1256_trigger_config_t;
+
+/**
+ * @brief Statistics of one channel over an interval.
+ */
+typedef struct {
+    uint64_t count;     ///< Frames
+    int32_t min;
+    int32_t max;
+    double mean;        ///< Code units
+    double stddev;      ///< Sample standard deviation, code units
+    double rms;         ///< Code units
+    uint64_t start_ns;  ///< Timestamp of the first frame
+    uint64_t end_ns;    ///< Timestamp of the last frame
+} ads1256_stats_summary_t;
+
+/**
+ * @brief A captured trigger window.
+ */
+typedef struct {
+    UBYTE channel;             ///< Channel label
+    ADS1256_TRIG_MODE mode;    ///< Condition that fired
+    uint64_t trigger_ns;       ///< Timestamp of the triggering frame
+    uint64_t trigger_sequence; ///< Sequence number of the triggering frame
+    UDOUBLE pre_count;         ///< Frames before the trigger in `frames` (may be < pre right after start)
+    UDOUBLE count;             ///< Frames in `frames`; frames[pre_count] is the trigger
+    ads1256_frame_t *frames;   ///< Window, oldest first
+} ads1256_stats_event_t;
+
+/**
+ * @brief Engine configuration. Fill with ADS1256_Stats_DefaultConfig().
+ */
+typedef struct {
+    uint64_t interval_ns;   ///< Length of a summary interval
+    UBYTE event_slots;      ///< Trigger windows that can be pending at once
+    UWORD max_window;       ///< Largest pre + post of any trigger
+    UBYTE forward_frames;   ///< Non-zero to still put every frame into the stream ring
+} ads1256_stats_config_t;
+
+/** @brief Accumulator of one channel (acquisition thread only). */
+typedef struct {
+    uint64_t count;
+    double mean;
+    double m2;
+    double sum_sq;
+    int32_t min;
+    int32_t max;
+    uint64_t start_ns;
+    uint64_t end_ns;
+} ads1256_stats_acc_t;
+
+/** @brief One event slot. */
+typedef struct {
+    ads1256_stats_event_t event;
+    _Atomic int ready;      ///< Set by the acquisition thread when the window is complete
+} ads1256_stats_slot_t;
+
+/** @brief Per-channel state. */
+typedef struct {
+    ads1256_stats_acc_t interval;                ///< Current interval
+    ads1256_stats_acc_t total;                   ///< Since the start
+    _Atomic uint32_t seq;                        ///< Seqlock over `published_*`
+    ads1256_stats_summary_t published_interval;  ///< Last completed interval
+    ads1256_stats_summary_t published_total;     ///< Totals at the end of that interval
+    ads1256_trigger_config_t trigger;
+    UBYTE armed;
+    ads1256_frame_t *history;                    ///< Last `trigger.pre` frames, circular
+    UWORD history_pos;
+    UWORD history_fill;
+    ads1256_stats_slot_t *capture;               ///< Slot being filled after a trigger, or NULL
+} ads1256_stats_channel_t;
+
+/**
+ * @brief Statistics and trigger engine. Treat as opaque; use the functions below.
+ */
+typedef struct {
+    ads1256_stats_config_t config;
+    ads1256_stats_channel_t channels[ADS1256_STATS_MAX_CHANNELS];
+    ads1256_stats_slot_t *slots;    ///< config.event_slots slots
+    uint64_t slot_head;             ///< Next slot to reserve (acquisition thread)
+    _Atomic uint64_t slot_tail;     ///< Next slot to hand out (consumer)
+    _Atomic uint64_t frames;        ///< Frames seen
+    _Atomic uint64_t triggers;      ///< Trigger conditions met
+    _Atomic uint64_t events_dropped;///< Triggers ignored because every slot was pending
+} ads1256_stats_t;
+
+/**
+ * @brief Fills a configuration with defaults: 1 s intervals, 8 event slots
+ *        of up to 1024 frames, frames still forwarded to the ring.
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_Stats_DefaultConfig(ads1256_stats_config_t *cfg);
+
+/**
+ * @brief Allocates the event slots and clears every channel.
+ * @param stats Engine.
+ * @param cfg Configuration (copied).
+ * @return ADS1256_OK on success, ADS1256_ERROR on an invalid configuration or allocation failure.
+ */
+UBYTE ADS1256_Stats_Init(ads1256_stats_t *stats, const ads1256_stats_config_t *cfg);
+
+/**
+ * @brief Sets (or with NULL, removes) the trigger of a channel.
+ *
+ * Configure before ADS1256_Stream_Start(); not safe while the engine runs.
+ * @param stats Engine.
+ * @param channel Channel label.
+ * @param trig Trigger configuration, or NULL.
+ * @return ADS1256_OK on success, ADS1256_ERROR if the window exceeds max_window.
+ */
+UBYTE ADS1256_Stats_SetTrigger(ads1256_stats_t *stats, UBYTE channel, const ads1256_trigger_config_t *trig);
+
+/**
+ * @brief Updates statistics and triggers with a block of frames (acquisition thread).
+ * @param stats Engine.
+ * @param frames Frames.
+ * @param n Number of frames.
+ */
+void ADS1256_Stats_Update(ads1256_stats_t *stats, const ads1256_frame_t *frames, UDOUBLE n);
+
+/**
+ * @brief Reads the published summaries of a channel.
+ * @param stats Engine.
+ * @param channel Channel label.
+ * @param interval Receives the last completed interval (may be NULL).
+ * @param total Receives the totals up to the end of that interval (may be NULL).
+ * @return ADS1256_OK if an interval has completed, ADS1256_ERROR otherwise.
+ */
+UBYTE ADS1256_Stats_Get(ads1256_stats_t *stats, UBYTE channel, ads1256_stats_summary_t *interval,
+                        ads1256_stats_summary_t *total);
+
+/**
+ * @brief Takes the oldest completed trigger window.
+ * @param stats Engine.
+ * @param event Receives the event; its `frames` points at `frames`.
+ * @param frames Output for the window.
+ * @param max Capacity of `frames`; longer windows are truncated.
+ * @return 1 if an event was returned, 0 if none is ready.
+ */
+int ADS1256_Stats_PollEvent(ads1256_stats_t *stats, ads1256_stats_event_t *event, ads1256_frame_t *frames, UDOUBLE max);
+
+/**
+ * @brief Frees the event slots and trigger histories.
+ * @param stats Engine (not attached to a running stream).
+ */
+void ADS1256_Stats_Free(ads1256_stats_t *stats);
+
+#endif // _ADS1256_STATS_H_
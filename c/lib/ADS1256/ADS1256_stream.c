@@ -0,0 +1,316 @@
+/**
+ * @file ADS1256_stream.c
+ * @brief Real-time acquisition thread and SPSC sample ring for the ADS1256.
+ *
+ * The acquisition thread is the only producer and the application thread
+ * calling ADS1256_Stream_Read() the only consumer, so the ring needs nothing
+ * more than acquire/release ordering on its two indices. The producer never
+ * blocks and never makes a system call for the ring; when the ring is full
+ * the newest scan is dropped and counted as an overrun.
+ */
+#define _GNU_SOURCE // For pthread_setaffinity_np, CPU_SET
+#include "ADS1256_stream.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#define ADS1256_STREAM_POLL_NS 200000L // Consumer sleep between ring checks while waiting (200 us)
+
+/**
+ * @brief Fills a configuration with defaults.
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_Stream_DefaultConfig(ads1256_stream_config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    for (UBYTE i = 0; i < 4; i++) {
+        cfg->channels[i] = i;
+    }
+    cfg->num_channels = 4;
+    cfg->settling_cycles = 1;
+    cfg->gain = ADS1256_GAIN_1;
+    cfg->scan_list = NULL;
+    cfg->drate = ADS1256_30000SPS;
+    cfg->ring_capacity = ADS1256_STREAM_DEFAULT_RING;
+    cfg->cpu = -1;
+    cfg->rt_priority = 0;
+    cfg->lock_memory = 0;
+    cfg->dev = NULL;
+    cfg->dsp = NULL;
+    cfg->stats = NULL;
+    cfg->shm = NULL;
+}
+
+/**
+ * @brief Rounds a ring size up to the next power of two.
+ * @param n Requested size.
+ * @return Power of two >= n (minimum 2).
+ */
+static uint64_t ADS1256_Stream_RoundPow2(uint64_t n)
+{
+    uint64_t size = 2;
+    while (size < n) size <<= 1;
+    return size;
+}
+
+/**
+ * @brief Publishes one scan worth of samples to the ring (producer side).
+ *
+ * The whole scan is dropped if it does not fit, so consumers always see
+ * complete scans.
+ * @param stream Stream object.
+ * @param frames Timestamped samples, one per configured channel.
+ * @param n Number of samples.
+ */
+static void ADS1256_Stream_Push(ads1256_stream_t *stream, const ads1256_frame_t *frames, UBYTE n)
+{
+    uint64_t head = atomic_load_explicit(&stream->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&stream->tail, memory_order_acquire);
+
+    if ((stream->ring_mask + 1) - (head - tail) < n) {
+        atomic_fetch_add_explicit(&stream->overruns, n, memory_order_relaxed);
+        return;
+    }
+
+    for (UBYTE i = 0; i < n; i++) {
+        stream->ring[(head + i) & stream->ring_mask] = frames[i];
+    }
+    atomic_store_explicit(&stream->head, head + n, memory_order_release);
+}
+
+/**
+ * @brief Applies CPU affinity and scheduling policy to the calling thread.
+ * @param cfg Stream configuration.
+ */
+static void ADS1256_Stream_ApplyScheduling(const ads1256_stream_config_t *cfg)
+{
+    if (cfg->cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cfg->cpu, &set);
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (err != 0) {
+            fprintf(stderr, "ADS1256_Stream: Failed to pin thread to CPU %d: %s\r\n", cfg->cpu, strerror(err));
+        }
+    }
+    if (cfg->rt_priority > 0) {
+        struct sched_param param = { .sched_priority = cfg->rt_priority };
+        int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (err != 0) {
+            fprintf(stderr, "ADS1256_Stream: SCHED_FIFO priority %d unavailable (%s), using SCHED_OTHER\r\n",
+                    cfg->rt_priority, strerror(err));
+        }
+    }
+}
+
+/**
+ * @brief Acquisition thread body: scan, timestamp, publish, repeat.
+ * @param arg The ads1256_stream_t being run.
+ * @return NULL.
+ */
+static void *ADS1256_Stream_Thread(void *arg)
+{
+    ads1256_stream_t *stream = (ads1256_stream_t *)arg;
+    ads1256_stream_config_t *cfg = &stream->config;
+    ads1256_dev_t *dev = cfg->dev;
+    ads1256_frame_t frames[ADS1256_SCAN_MAX_ENTRIES];
+    UBYTE continuous = (cfg->num_channels == 1); // Zero when a prebuilt scan list was supplied
+
+    ADS1256_Stream_ApplyScheduling(cfg);
+    ADS1256_Dev_InitPerformanceMonitoring(dev, cfg->drate);
+
+    if (continuous && (ADS1256_Dev_SetDataRate(dev, cfg->drate) != ADS1256_OK ||
+                       ADS1256_Dev_SetGain(dev, cfg->gain) != ADS1256_OK ||
+                       ADS1256_Dev_StartContinuous(dev, cfg->channels[0]) != ADS1256_OK)) {
+        fprintf(stderr, "ADS1256_Stream: RDATAC start failed, falling back to per-sample reads\r\n");
+        continuous = 0;
+    }
+
+    while (atomic_load_explicit(&stream->running, memory_order_relaxed)) {
+        UBYTE status;
+
+        if (continuous) {
+            status = ADS1256_Dev_ReadContinuousFrames(dev, frames, 1);
+        } else {
+            status = ADS1256_Dev_ScanFrames(dev, &stream->scan, frames);
+        }
+
+        if (status != ADS1256_OK) {
+            atomic_fetch_add_explicit(&stream->drdy_errors, 1, memory_order_relaxed);
+            continue;
+        }
+
+        UBYTE n = stream->scan.num_entries;
+        if (cfg->dsp) {
+            n = (UBYTE)ADS1256_Dsp_Process(cfg->dsp, frames, n, frames);
+            if (n == 0) continue;
+        }
+        UBYTE forward = 1;
+        if (cfg->stats) {
+            ADS1256_Stats_Update(cfg->stats, frames, n);
+            forward = cfg->stats->config.forward_frames;
+        }
+        if (cfg->shm) {
+            ADS1256_Shm_Publish(cfg->shm, frames, n);
+            forward = forward && cfg->shm->config.forward_frames;
+        }
+        if (forward) ADS1256_Stream_Push(stream, frames, n);
+    }
+
+    if (continuous) {
+        ADS1256_Dev_StopContinuous(dev);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Allocates the ring and starts the acquisition thread.
+ * @param stream Stream object to start.
+ * @param cfg Configuration (copied).
+ * @return ADS1256_OK on success, ADS1256_ERROR on failure.
+ */
+UBYTE ADS1256_Stream_Start(ads1256_stream_t *stream, const ads1256_stream_config_t *cfg)
+{
+    if (!stream || !cfg) return ADS1256_ERROR;
+
+    memset(stream, 0, sizeof(*stream));
+    stream->config = *cfg;
+    stream->config.scan_list = NULL; // Only the private copy below is used by the thread
+    if (!stream->config.dev) stream->config.dev = ADS1256_GetDefaultDev();
+
+    UBYTE status;
+    if (cfg->scan_list) {
+        stream->scan = *cfg->scan_list;
+        status = (stream->scan.num_entries > 0) ? ADS1256_OK : ADS1256_ERROR;
+    } else {
+        status = ADS1256_Dev_ScanList_Build(stream->config.dev, &stream->scan, cfg->channels, cfg->num_channels,
+                                            cfg->gain, cfg->drate, cfg->settling_cycles);
+    }
+    if (status != ADS1256_OK) {
+        fprintf(stderr, "ADS1256_Stream_Start: Invalid channel configuration\r\n");
+        return ADS1256_ERROR;
+    }
+    ADS1256_ScanList_Reset(&stream->scan);
+    if (cfg->dsp) ADS1256_Dsp_Reset(cfg->dsp);
+    if (cfg->scan_list) stream->config.num_channels = 0; // Channel list not used
+
+    if (cfg->lock_memory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        perror("ADS1256_Stream_Start: mlockall failed, continuing unlocked");
+    }
+
+    uint64_t capacity = ADS1256_Stream_RoundPow2(cfg->ring_capacity ? cfg->ring_capacity : ADS1256_STREAM_DEFAULT_RING);
+    if (capacity < stream->scan.num_entries) capacity = ADS1256_Stream_RoundPow2(stream->scan.num_entries);
+    stream->ring = aligned_alloc(ADS1256_STREAM_CACHE_LINE, capacity * sizeof(ads1256_sample_t));
+    if (!stream->ring) {
+        perror("ADS1256_Stream_Start: Failed to allocate sample ring");
+        return ADS1256_ERROR;
+    }
+    memset(stream->ring, 0, capacity * sizeof(ads1256_sample_t)); // Pre-fault every page before the thread starts
+    stream->ring_mask = capacity - 1;
+
+    atomic_init(&stream->head, 0);
+    atomic_init(&stream->tail, 0);
+    atomic_init(&stream->overruns, 0);
+    atomic_init(&stream->drdy_errors, 0);
+    atomic_init(&stream->running, 1);
+
+    int err = pthread_create(&stream->thread, NULL, ADS1256_Stream_Thread, stream);
+    if (err != 0) {
+        fprintf(stderr, "ADS1256_Stream_Start: Failed to create thread: %s\r\n", strerror(err));
+        free(stream->ring);
+        stream->ring = NULL;
+        return ADS1256_ERROR;
+    }
+    stream->thread_started = 1;
+
+    Debug("ADS1256_Stream_Start: %d scan entries, ring %llu samples, cpu %d, prio %d\n",
+          stream->scan.num_entries, (unsigned long long)capacity, cfg->cpu, cfg->rt_priority);
+    return ADS1256_OK;
+}
+
+/**
+ * @brief Returns the number of samples waiting in the ring.
+ * @param stream Running stream.
+ * @return Samples available to ADS1256_Stream_Read().
+ */
+UDOUBLE ADS1256_Stream_Available(ads1256_stream_t *stream)
+{
+    uint64_t head = atomic_load_explicit(&stream->head, memory_order_acquire);
+    uint64_t tail = atomic_load_explicit(&stream->tail, memory_order_relaxed);
+    return (UDOUBLE)(head - tail);
+}
+
+/**
+ * @brief Copies up to `max` samples out of the ring (consumer side).
+ * @param stream Running stream.
+ * @param out Output array for at least `max` samples.
+ * @param max Maximum number of samples to copy.
+ * @param timeout_ms Time to wait for data if the ring is empty (0 = return immediately).
+ * @return Number of samples copied.
+ */
+UDOUBLE ADS1256_Stream_Read(ads1256_stream_t *stream, ads1256_sample_t *out, UDOUBLE max, int timeout_ms)
+{
+    if (!stream || !stream->ring || !out || max == 0) return 0;
+
+    UDOUBLE avail = ADS1256_Stream_Available(stream);
+    if (avail == 0 && timeout_ms > 0) {
+        struct timespec pause = { 0, ADS1256_STREAM_POLL_NS };
+        long waited_ns = 0;
+        while (avail == 0 && waited_ns < timeout_ms * 1000000L &&
+               atomic_load_explicit(&stream->running, memory_order_relaxed)) {
+            nanosleep(&pause, NULL);
+            waited_ns += ADS1256_STREAM_POLL_NS;
+            avail = ADS1256_Stream_Available(stream);
+        }
+    }
+
+    UDOUBLE count = (avail < max) ? avail : max;
+    if (count == 0) return 0;
+
+    uint64_t tail = atomic_load_explicit(&stream->tail, memory_order_relaxed);
+    uint64_t start = tail & stream->ring_mask;
+    uint64_t first = stream->ring_mask + 1 - start; // Slots before the wrap point
+    if (first > count) first = count;
+
+    memcpy(out, &stream->ring[start], first * sizeof(ads1256_sample_t));
+    memcpy(out + first, &stream->ring[0], (count - first) * sizeof(ads1256_sample_t));
+
+    atomic_store_explicit(&stream->tail, tail + count, memory_order_release);
+    return count;
+}
+
+/**
+ * @brief Returns the number of samples dropped because the consumer fell behind.
+ * @param stream Stream object.
+ * @return Overrun counter.
+ */
+uint64_t ADS1256_Stream_Overruns(ads1256_stream_t *stream)
+{
+    return atomic_load_explicit(&stream->overruns, memory_order_relaxed);
+}
+
+/**
+ * @brief Stops the acquisition thread and frees the ring.
+ * @param stream Stream object.
+ * @return ADS1256_OK on success, ADS1256_ERROR if the stream was not running.
+ */
+UBYTE ADS1256_Stream_Stop(ads1256_stream_t *stream)
+{
+    if (!stream || !stream->thread_started) return ADS1256_ERROR;
+
+    atomic_store_explicit(&stream->running, 0, memory_order_relaxed);
+    pthread_join(stream->thread, NULL);
+    stream->thread_started = 0;
+
+    Debug("ADS1256_Stream_Stop: %llu overruns, %llu DRDY errors\n",
+          (unsigned long long)ADS1256_Stream_Overruns(stream),
+          (unsigned long long)atomic_load(&stream->drdy_errors));
+
+    free(stream->ring);
+    stream->ring = NULL;
+    return ADS1256_OK;
+}
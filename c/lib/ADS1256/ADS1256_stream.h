@@ -0,0 +1,126 @@
+/**
+ * @file ADS1256_stream.h
+ * @brief Real-time acquisition engine for the ADS1256.
+ *
+ * Runs the channel scan on a dedicated (optionally SCHED_FIFO, CPU-pinned,
+ * memory-locked) thread and hands timestamped samples to the consumer through
+ * a preallocated lock-free single-producer/single-consumer ring. A slow
+ * consumer therefore never stalls acquisition; it only shows up in the
+ * overrun counter.
+ */
+
+#ifndef _ADS1256_STREAM_H_
+#define _ADS1256_STREAM_H_
+
+#include "ADS1256.h"
+#include "ADS1256_dsp.h"
+#include "ADS1256_stats.h"
+#include "ADS1256_shm.h"
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+/** @brief Default ring capacity in samples (rounded up to a power of two). */
+#define ADS1256_STREAM_DEFAULT_RING 65536
+/** @brief Size used to keep producer and consumer indices on separate cache lines. */
+#define ADS1256_STREAM_CACHE_LINE 64
+
+/**
+ * @brief One acquired sample as stored in the stream ring.
+ *
+ * Each sample is stamped with the DRDY of its own conversion. Its sequence
+ * number is assigned at acquisition, so samples dropped on a ring overrun
+ * show up as a gap.
+ */
+typedef ads1256_frame_t ads1256_sample_t;
+
+/**
+ * @brief Acquisition thread configuration.
+ *
+ * Fill with ADS1256_Stream_DefaultConfig() and override what is needed.
+ */
+typedef struct {
+    UBYTE channels[NUM_SINGLE_ENDED_CHANNELS]; ///< Channels to scan, in order
+    UBYTE num_channels;     ///< Number of entries in `channels` (1 uses RDATAC continuous mode)
+    UBYTE settling_cycles;  ///< DRDY cycles per channel switch in the pipelined scan
+    ADS1256_GAIN gain;      ///< PGA gain for every channel in `channels`
+    const ADS1256_ScanList *scan_list; ///< Optional prebuilt scan list; overrides channels/gain/settling when set
+    ADS1256_DRATE drate;    ///< Data rate for every channel in `channels`, also used for performance monitoring
+    UDOUBLE ring_capacity;  ///< Ring size in samples (rounded up to a power of two)
+    int cpu;                ///< CPU core to pin the thread to, or -1 to leave it unpinned
+    int rt_priority;        ///< SCHED_FIFO priority (1-99), or 0 for SCHED_OTHER
+    UBYTE lock_memory;      ///< Non-zero to mlockall() the process before starting
+    ads1256_dev_t *dev;     ///< Device to acquire from, or NULL for the default device (ADS1256_init())
+    ads1256_dsp_t *dsp;     ///< Filter/decimation stage run before samples enter the ring, or NULL for raw samples
+    ads1256_stats_t *stats; ///< Statistics/trigger engine updated after the DSP stage, or NULL
+    ads1256_shm_t *shm;     ///< Shared-memory ring for other processes (ADS1256_Shm_Create()), or NULL
+} ads1256_stream_config_t;
+
+/**
+ * @brief Acquisition engine state. Treat as opaque; use the accessor functions.
+ */
+typedef struct {
+    ads1256_stream_config_t config;     ///< Copy of the configuration passed to Start
+    ADS1256_ScanList scan;              ///< Scan list executed by the thread
+    ads1256_sample_t *ring;             ///< Preallocated sample ring
+    uint64_t ring_mask;                 ///< ring capacity - 1
+    pthread_t thread;                   ///< Acquisition thread
+    UBYTE thread_started;               ///< Non-zero while `thread` must be joined
+    _Alignas(ADS1256_STREAM_CACHE_LINE) _Atomic uint64_t head; ///< Next write index (producer only)
+    _Alignas(ADS1256_STREAM_CACHE_LINE) _Atomic uint64_t tail; ///< Next read index (consumer only)
+    _Alignas(ADS1256_STREAM_CACHE_LINE) _Atomic uint64_t overruns; ///< Samples dropped because the ring was full
+    _Atomic uint64_t drdy_errors;       ///< Scans lost to DRDY timeouts or SPI/GPIO errors
+    _Atomic int running;                ///< Cleared to ask the thread to stop
+} ads1256_stream_t;
+
+/**
+ * @brief Fills a configuration with defaults: AIN0..AIN3 at gain 1, 1 settling cycle,
+ *        30000 SPS, 64k-sample ring, unpinned, SCHED_OTHER, no mlockall.
+ * @param cfg Configuration to initialize.
+ */
+void ADS1256_Stream_DefaultConfig(ads1256_stream_config_t *cfg);
+
+/**
+ * @brief Allocates the ring and starts the acquisition thread.
+ *
+ * The ADS1256 must already be initialized with ADS1256_init(). While the
+ * stream runs, the thread owns the driver: do not call other ADS1256
+ * functions until ADS1256_Stream_Stop() returns.
+ * @param stream Stream object to start.
+ * @param cfg Configuration (copied).
+ * @return ADS1256_OK on success, ADS1256_ERROR on failure.
+ */
+UBYTE ADS1256_Stream_Start(ads1256_stream_t *stream, const ads1256_stream_config_t *cfg);
+
+/**
+ * @brief Copies up to `max` samples out of the ring.
+ * @param stream Running stream.
+ * @param out Output array for at least `max` samples.
+ * @param max Maximum number of samples to copy.
+ * @param timeout_ms Time to wait for data if the ring is empty (0 = return immediately).
+ * @return Number of samples copied (0 if none arrived before the timeout).
+ */
+UDOUBLE ADS1256_Stream_Read(ads1256_stream_t *stream, ads1256_sample_t *out, UDOUBLE max, int timeout_ms);
+
+/**
+ * @brief Returns the number of samples waiting in the ring.
+ * @param stream Running stream.
+ * @return Samples available to ADS1256_Stream_Read().
+ */
+UDOUBLE ADS1256_Stream_Available(ads1256_stream_t *stream);
+
+/**
+ * @brief Returns the number of samples dropped because the consumer fell behind.
+ * @param stream Stream object.
+ * @return Overrun counter.
+ */
+uint64_t ADS1256_Stream_Overruns(ads1256_stream_t *stream);
+
+/**
+ * @brief Stops the acquisition thread and frees the ring.
+ * @param stream Stream object.
+ * @return ADS1256_OK on success, ADS1256_ERROR if the stream was not running.
+ */
+UBYTE ADS1256_Stream_Stop(ads1256_stream_t *stream);
+
+#endif // _ADS1256_STREAM_H_
@@ -12,25 +12,191 @@
 #include "../../common/DEV_Config.h"
 
 /**
- * @brief Writes a 16-bit data value to the specified DAC channel.
+ * @brief Binds a DAC8532 context to a port.
+ * @param dev Device context to initialize.
+ * @param port Port the chip is wired to (only its chip select is used).
+ * @param vref Reference voltage in volts, used by DAC8532_Dev_Out_Voltage().
+ * @return 0 on success, 1 on invalid arguments.
+ */
+UBYTE DAC8532_Dev_Init(dac8532_dev_t *dev, DEV_Port *port, float vref)
+{
+    if (!dev || !port || vref <= 0.0f) return 1;
+
+    dev->port = port;
+    dev->vref = vref;
+    return 0;
+}
+
+/**
+ * @brief Sets the SCLK frequency of the DAC's messages.
+ * @param dev Device context.
+ * @param speed_hz Clock in Hz (1 to DAC8532_SCLK_MAX_HZ), or 0 for the bus's speed.
+ * @return 0 on success, 1 on an invalid speed or a closed port.
+ */
+UBYTE DAC8532_Dev_SetSpiSpeed(dac8532_dev_t *dev, UDOUBLE speed_hz)
+{
+    if (!dev || !dev->port || speed_hz > DAC8532_SCLK_MAX_HZ) return 1;
+    return DEV_Port_SetSpeed(dev->port, speed_hz) == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Sends one 24-bit input word in its own chip-select frame.
+ * @param dev Device context.
+ * @param cmd Control byte.
+ * @param Data The 16-bit data value.
+ * @return 0 on success, non-zero on an SPI error.
+ */
+static int DAC8532_Dev_SendWord(dac8532_dev_t *dev, UBYTE cmd, UWORD Data)
+{
+    UBYTE tx[3] = {
+        cmd,
+        (Data >> 8) & 0xFF,
+        Data & 0xFF,
+    };
+    DEV_SPI_Segment seg = { .tx = tx, .len = sizeof(tx) };
+
+    return DEV_Port_Message(dev->port, &seg, 1); // Whole 24-bit word in one ioctl
+}
+
+/**
+ * @brief Writes a 16-bit data value to a DAC channel of a device.
  * 
  * This function sends a 24-bit serial word to the DAC8532.
  * The first byte specifies the channel and operation mode.
  * The next two bytes are the 16-bit data for the DAC.
  * 
+ * @param dev Device context.
  * @param Channel The DAC channel to write to.
  *                Use `DAC8532_CHANNEL_A` or `DAC8532_CHANNEL_B`.
  * @param Data The 16-bit data value to write to the DAC.
+ * @return 0 on success, non-zero on an SPI error.
  */
-void Write_DAC8532(UBYTE Channel, UWORD Data)
+int DAC8532_Dev_Write(dac8532_dev_t *dev, UBYTE Channel, UWORD Data)
 {
-    DEV_Digital_Write(DEV_CS1_PIN, LOW); 
+    return DAC8532_Dev_SendWord(dev, Channel, Data);
+}
 
-    DEV_SPI_WriteByte(Channel);
-    DEV_SPI_WriteByte((Data >> 8) & 0xFF); 
-    DEV_SPI_WriteByte(Data & 0xFF);      
+/**
+ * @brief Writes both DAC channels and updates the two outputs at the same time.
+ * 
+ * The chip takes one 24-bit word per SYNC (chip select) frame, so the two
+ * words go out in two frames. Until the second one, both outputs keep their
+ * old value. With a native chip select both frames are one SPI message,
+ * split by `cs_change`; with a GPIO chip select they are two messages.
+ * 
+ * @param dev Device context.
+ * @param code_a Data for channel A.
+ * @param code_b Data for channel B.
+ * @return 0 on success, non-zero on an SPI error.
+ */
+int DAC8532_Dev_WriteBoth(dac8532_dev_t *dev, UWORD code_a, UWORD code_b)
+{
+    if (DEV_Port_HasNativeCS(dev->port)) {
+        UBYTE tx[6] = {
+            0x00, (code_a >> 8) & 0xFF, code_a & 0xFF, // Buffer A, no load
+            DAC8532_CMD_BUFFER_B | DAC8532_CMD_LDA | DAC8532_CMD_LDB, (code_b >> 8) & 0xFF, code_b & 0xFF,
+        };
+        DEV_SPI_Segment msg[2] = {
+            { .tx = tx, .len = 3, .cs_change = 1 },
+            { .tx = tx + 3, .len = 3 },
+        };
+        return DEV_Port_Message(dev->port, msg, 2);
+    }
+
+    int ret = DAC8532_Dev_SendWord(dev, 0x00, code_a); // Buffer A, no load
+    if (ret != 0) return ret;
+
+    return DAC8532_Dev_SendWord(dev, DAC8532_CMD_BUFFER_B | DAC8532_CMD_LDA | DAC8532_CMD_LDB, code_b);
+}
+
+/**
+ * @brief Converts a voltage to a DAC code.
+ * @param vref Reference voltage in volts.
+ * @param Voltage Voltage, clamped to 0.0 .. vref.
+ * @return DAC code.
+ */
+UWORD DAC8532_VoltageToCode(float vref, float Voltage)
+{
+    if (Voltage > vref) {
+        Voltage = vref;
+    } else if (Voltage < 0.0f) {
+        Voltage = 0.0f;
+    }
 
-    DEV_Digital_Write(DEV_CS1_PIN, HIGH); 
+    return (UWORD)((Voltage / vref) * DAC_VALUE_MAX);
+}
+
+/**
+ * @brief Sets the output voltage for a DAC channel of a device.
+ * 
+ * The voltage is clamped to 0 .. the device's reference voltage.
+ * 
+ * @param dev Device context.
+ * @param Channel The DAC channel to set the voltage for.
+ *                Use `DAC8532_CHANNEL_A` or `DAC8532_CHANNEL_B`.
+ * @param Voltage The desired output voltage (0.0 to vref).
+ * @return 0 on success, non-zero on an SPI error.
+ */
+int DAC8532_Dev_Out_Voltage(dac8532_dev_t *dev, UBYTE Channel, float Voltage)
+{
+    return DAC8532_Dev_Write(dev, Channel, DAC8532_VoltageToCode(dev->vref, Voltage));
+}
+
+/**
+ * @brief Queues a 16-bit data value for a DAC channel without waiting for the bus.
+ * 
+ * The write is sent by the bus scheduler, preferably while an ADC on the
+ * same bus is converting (see DEV_Port_Submit()). A newer value for the same
+ * channel replaces one still queued.
+ * 
+ * @param dev Device context.
+ * @param Channel The DAC channel to write to.
+ *                Use `DAC8532_CHANNEL_A` or `DAC8532_CHANNEL_B`.
+ * @param Data The 16-bit data value to write to the DAC.
+ * @param deadline_ns Latest send time on the DEV_Now_ns() clock, or 0 for none.
+ * @return 0 when queued, 1 if the bus queue is full.
+ */
+int DAC8532_Dev_Submit(dac8532_dev_t *dev, UBYTE Channel, UWORD Data, uint64_t deadline_ns)
+{
+    UBYTE tx[3] = {
+        Channel,
+        (Data >> 8) & 0xFF,
+        Data & 0xFF,
+    };
+
+    return DEV_Port_Submit(dev->port, tx, sizeof(tx), deadline_ns);
+}
+
+/**
+ * @brief Queues an output voltage for a DAC channel without waiting for the bus.
+ * 
+ * @param dev Device context.
+ * @param Channel The DAC channel to set the voltage for.
+ *                Use `DAC8532_CHANNEL_A` or `DAC8532_CHANNEL_B`.
+ * @param Voltage The desired output voltage, clamped to 0.0 .. vref.
+ * @param deadline_ns Latest send time on the DEV_Now_ns() clock, or 0 for none.
+ * @return 0 when queued, 1 if the bus queue is full.
+ */
+int DAC8532_Dev_Submit_Voltage(dac8532_dev_t *dev, UBYTE Channel, float Voltage, uint64_t deadline_ns)
+{
+    return DAC8532_Dev_Submit(dev, Channel, DAC8532_VoltageToCode(dev->vref, Voltage), deadline_ns);
+}
+
+/**
+ * @brief Writes a 16-bit data value to the specified DAC channel.
+ * 
+ * Uses the board's DAC on DEV_GetDACPort().
+ * 
+ * @param Channel The DAC channel to write to.
+ *                Use `DAC8532_CHANNEL_A` or `DAC8532_CHANNEL_B`.
+ * @param Data The 16-bit data value to write to the DAC.
+ * @return 0 on success, non-zero on an SPI error.
+ */
+int Write_DAC8532(UBYTE Channel, UWORD Data)
+{
+    dac8532_dev_t dev = { .port = DEV_GetDACPort(), .vref = DAC_VREF };
+
+    return DAC8532_Dev_Write(&dev, Channel, Data);
 }
 
 /**
@@ -43,18 +209,11 @@ void Write_DAC8532(UBYTE Channel, UWORD Data)
  * @param Channel The DAC channel to set the voltage for.
  *                Use `DAC8532_CHANNEL_A` or `DAC8532_CHANNEL_B`.
  * @param Voltage The desired output voltage (0.0 to V_REF).
+ * @return 0 on success, non-zero on an SPI error.
  */
-void DAC8532_Out_Voltage(UBYTE Channel, float Voltage)
+int DAC8532_Out_Voltage(UBYTE Channel, float Voltage)
 {
-    UWORD digital_value = 0;
-
-    if (Voltage > DAC_VREF) {
-        Voltage = DAC_VREF;
-    } else if (Voltage < 0.0f) {
-        Voltage = 0.0f;
-    }
+    dac8532_dev_t dev = { .port = DEV_GetDACPort(), .vref = DAC_VREF };
 
-    digital_value = (UWORD)((Voltage / DAC_VREF) * DAC_VALUE_MAX);
-
-    Write_DAC8532(Channel, digital_value);
-}
\ No newline at end of file
+    return DAC8532_Dev_Out_Voltage(&dev, Channel, Voltage);
+}
@@ -24,12 +24,113 @@
  */
 #define DAC8532_CHANNEL_B   0x34
 
+/** @name Control byte bits (DB23..DB16 of the 24-bit input word) */
+#define DAC8532_CMD_LDB      0x20 ///< Load DAC B from its buffer after this write
+#define DAC8532_CMD_LDA      0x10 ///< Load DAC A from its buffer after this write
+#define DAC8532_CMD_BUFFER_B 0x04 ///< Write the data to buffer B (clear: buffer A)
+
 /** @brief Maximum digital value for the 16-bit DAC (2^16 - 1). */
 #define DAC_VALUE_MAX  65535U
 
 /** @brief Reference voltage for the DAC in Volts. */
 #define DAC_VREF  5.0f
 
+/** @brief Highest SCLK the DAC8532 accepts (datasheet: 30 MHz). */
+#define DAC8532_SCLK_MAX_HZ 30000000
+
+/**
+ * @brief State of one DAC8532: the port it is wired to and its reference voltage.
+ */
+typedef struct {
+    DEV_Port *port;  ///< Bus and chip select
+    float vref;      ///< Reference voltage in volts
+} dac8532_dev_t;
+
+/**
+ * @brief Binds a DAC8532 context to a port.
+ * @param dev Device context to initialize.
+ * @param port Port the chip is wired to (only its chip select is used).
+ * @param vref Reference voltage in volts.
+ * @return 0 on success, 1 on invalid arguments.
+ */
+UBYTE DAC8532_Dev_Init(dac8532_dev_t *dev, DEV_Port *port, float vref);
+
+/**
+ * @brief Sets the SCLK frequency of the DAC's messages, independently of the ADC on the same bus.
+ *
+ * The DAC8532 takes up to DAC8532_SCLK_MAX_HZ, so a fast DAC clock shortens
+ * the time each write holds the bus that the ADC also needs.
+ * @param dev Device context.
+ * @param speed_hz Clock in Hz (1 to DAC8532_SCLK_MAX_HZ), or 0 for the bus's speed.
+ * @return 0 on success, 1 on an invalid speed or a closed port.
+ */
+UBYTE DAC8532_Dev_SetSpiSpeed(dac8532_dev_t *dev, UDOUBLE speed_hz);
+
+/**
+ * @brief Writes a 16-bit data value to a DAC channel of a device.
+ *
+ * The write holds the port's bus lock, so it can be issued from another
+ * thread while an ADC on the same bus is acquiring.
+ * @param dev Device context.
+ * @param Channel The DAC channel to write to (e.g., `DAC8532_CHANNEL_A`).
+ * @param Data The 16-bit data value to write to the DAC.
+ * @return 0 on success, non-zero on an SPI error.
+ */
+int DAC8532_Dev_Write(dac8532_dev_t *dev, UBYTE Channel, UWORD Data);
+
+/**
+ * @brief Writes both DAC channels and updates the two outputs at the same time.
+ *
+ * Sends channel A to its buffer without loading, then channel B with both
+ * load bits set, so the outputs change together on the second word.
+ * @param dev Device context.
+ * @param code_a Data for channel A.
+ * @param code_b Data for channel B.
+ * @return 0 on success, non-zero on an SPI error.
+ */
+int DAC8532_Dev_WriteBoth(dac8532_dev_t *dev, UWORD code_a, UWORD code_b);
+
+/**
+ * @brief Converts a voltage to a DAC code.
+ * @param vref Reference voltage in volts.
+ * @param Voltage Voltage, clamped to 0.0 .. vref.
+ * @return DAC code.
+ */
+UWORD DAC8532_VoltageToCode(float vref, float Voltage);
+
+/**
+ * @brief Sets the output voltage for a DAC channel of a device.
+ * @param dev Device context.
+ * @param Channel The DAC channel to set the voltage for (e.g., `DAC8532_CHANNEL_A`).
+ * @param Voltage The desired output voltage, clamped to 0.0 .. vref.
+ * @return 0 on success, non-zero on an SPI error.
+ */
+int DAC8532_Dev_Out_Voltage(dac8532_dev_t *dev, UBYTE Channel, float Voltage);
+
+/**
+ * @brief Queues a 16-bit data value for a DAC channel without waiting for the bus.
+ *
+ * The bus scheduler sends it while an ADC on the same bus is converting, or
+ * ahead of the next transaction once the deadline is near (see
+ * DEV_Port_Submit()). A newer value for the same channel replaces a queued one.
+ * @param dev Device context.
+ * @param Channel The DAC channel to write to (e.g., `DAC8532_CHANNEL_A`).
+ * @param Data The 16-bit data value to write to the DAC.
+ * @param deadline_ns Latest send time on the DEV_Now_ns() clock, or 0 for none.
+ * @return 0 when queued, 1 if the bus queue is full.
+ */
+int DAC8532_Dev_Submit(dac8532_dev_t *dev, UBYTE Channel, UWORD Data, uint64_t deadline_ns);
+
+/**
+ * @brief Queues an output voltage for a DAC channel without waiting for the bus.
+ * @param dev Device context.
+ * @param Channel The DAC channel to set the voltage for (e.g., `DAC8532_CHANNEL_A`).
+ * @param Voltage The desired output voltage, clamped to 0.0 .. vref.
+ * @param deadline_ns Latest send time on the DEV_Now_ns() clock, or 0 for none.
+ * @return 0 when queued, 1 if the bus queue is full.
+ */
+int DAC8532_Dev_Submit_Voltage(dac8532_dev_t *dev, UBYTE Channel, float Voltage, uint64_t deadline_ns);
+
 /**
  * @brief Sets the output voltage for a specified DAC channel.
  * 
@@ -38,8 +139,9 @@
  * 
  * @param Channel The DAC channel to set the voltage for (e.g., `DAC8532_CHANNEL_A`).
  * @param Voltage The desired output voltage (0.0 to `DAC_VREF`).
+ * @return 0 on success, non-zero on an SPI error.
  */
-void DAC8532_Out_Voltage(UBYTE Channel, float Voltage);
+int DAC8532_Out_Voltage(UBYTE Channel, float Voltage);
 
 /**
  * @brief Writes a 16-bit data value to the specified DAC channel.
@@ -48,7 +150,8 @@ void DAC8532_Out_Voltage(UBYTE Channel, float Voltage);
  * 
  * @param Channel The DAC channel to write to (e.g., `DAC8532_CHANNEL_A`).
  * @param Data The 16-bit data value to write to the DAC.
+ * @return 0 on success, non-zero on an SPI error.
  */
-void Write_DAC8532(UBYTE Channel, UWORD Data);
+int Write_DAC8532(UBYTE Channel, UWORD Data);
 
 #endif // _DAC8532_H_
\ No newline at end of file
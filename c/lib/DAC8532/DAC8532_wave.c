@@ -0,0 +1,359 @@
+/**
+ * @file DAC8532_wave.c
+ * @brief Table-driven waveform playback for the DAC8532.
+ */
+#define _GNU_SOURCE // For pthread_setaffinity_np, CPU_SET
+#include "DAC8532_wave.h"
+#include "../../common/Debug.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#define DAC8532_WAVE_DEFAULT_RATE_HZ 10000
+
+/**
+ * @brief Returns the current CLOCK_MONOTONIC time.
+ * @return Nanoseconds.
+ */
+static uint64_t DAC8532_Wave_Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Waits until an absolute CLOCK_MONOTONIC time.
+ *
+ * Sleeps until `spin_ns` before the target and busy-waits the rest, which
+ * trades CPU time for less wake-up jitter at high tick rates.
+ * @param target_ns Time to wait for.
+ * @param spin_ns Busy-wait window.
+ */
+static void DAC8532_Wave_WaitUntil(uint64_t target_ns, uint64_t spin_ns)
+{
+    if (target_ns > spin_ns) {
+        uint64_t sleep_ns = target_ns - spin_ns;
+        struct timespec ts = { .tv_sec = (time_t)(sleep_ns / 1000000000ULL),
+                               .tv_nsec = (long)(sleep_ns % 1000000000ULL) };
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+        }
+    }
+    while (spin_ns && DAC8532_Wave_Now() < target_ns) {
+    }
+}
+
+/**
+ * @brief Maps a channel command to a table index.
+ * @param Channel `DAC8532_CHANNEL_A` or `DAC8532_CHANNEL_B`.
+ * @return 0 for channel A, 1 for channel B.
+ */
+static UBYTE DAC8532_Wave_Index(UBYTE Channel)
+{
+    return (Channel & DAC8532_CMD_BUFFER_B) ? 1 : 0;
+}
+
+/**
+ * @brief Fills a configuration with defaults.
+ * @param cfg Configuration to initialize.
+ */
+void DAC8532_Wave_DefaultConfig(dac8532_wave_config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->dac = NULL;
+    cfg->rate_hz = DAC8532_WAVE_DEFAULT_RATE_HZ;
+    cfg->spin_ns = 0;
+    cfg->num_ticks = 0;
+    cfg->cpu = -1;
+    cfg->rt_priority = 0;
+    cfg->lock_memory = 0;
+}
+
+/**
+ * @brief Initializes an empty player.
+ * @param wave Player to initialize.
+ */
+void DAC8532_Wave_Init(dac8532_wave_t *wave)
+{
+    memset(wave, 0, sizeof(*wave));
+    atomic_init(&wave->running, 0);
+}
+
+/**
+ * @brief Copies a code table for one channel into the player.
+ * @param wave Stopped player.
+ * @param Channel `DAC8532_CHANNEL_A` or `DAC8532_CHANNEL_B`.
+ * @param codes DAC codes.
+ * @param n Number of codes.
+ * @return 0 on success, 1 while playing or if the table cannot be allocated.
+ */
+UBYTE DAC8532_LoadWaveform(dac8532_wave_t *wave, UBYTE Channel, const UWORD *codes, UDOUBLE n)
+{
+    if (!wave || wave->thread_started) {
+        fprintf(stderr, "DAC8532_LoadWaveform: Player is running, call DAC8532_Wave_Stop() first\r\n");
+        return 1;
+    }
+
+    UBYTE idx = DAC8532_Wave_Index(Channel);
+    UWORD *table = NULL;
+
+    if (codes && n > 0) {
+        table = malloc((size_t)n * sizeof(UWORD));
+        if (!table) {
+            perror("DAC8532_LoadWaveform: Failed to allocate table");
+            return 1;
+        }
+        memcpy(table, codes, (size_t)n * sizeof(UWORD));
+    }
+    free(wave->table[idx]);
+    wave->table[idx] = table;
+    wave->length[idx] = table ? n : 0;
+    return 0;
+}
+
+/**
+ * @brief Applies CPU affinity and scheduling policy to the calling thread.
+ * @param cfg Player configuration.
+ */
+static void DAC8532_Wave_ApplyScheduling(const dac8532_wave_config_t *cfg)
+{
+    if (cfg->cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cfg->cpu, &set);
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (err != 0) {
+            fprintf(stderr, "DAC8532_Wave: Failed to pin thread to CPU %d: %s\r\n", cfg->cpu, strerror(err));
+        }
+    }
+    if (cfg->rt_priority > 0) {
+        struct sched_param param = { .sched_priority = cfg->rt_priority };
+        int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (err != 0) {
+            fprintf(stderr, "DAC8532_Wave: SCHED_FIFO priority %d unavailable (%s), using SCHED_OTHER\r\n",
+                    cfg->rt_priority, strerror(err));
+        }
+    }
+}
+
+/**
+ * @brief Playback thread body.
+ * @param arg The dac8532_wave_t being played.
+ * @return NULL.
+ */
+static void *DAC8532_Wave_Thread(void *arg)
+{
+    dac8532_wave_t *wave = (dac8532_wave_t *)arg;
+    const dac8532_wave_config_t *cfg = &wave->config;
+    const uint64_t period_ns = 1000000000ULL / cfg->rate_hz;
+    const UWORD *table_a = wave->table[0];
+    const UWORD *table_b = wave->table[1];
+    const UDOUBLE len_a = wave->length[0];
+    const UDOUBLE len_b = wave->length[1];
+    UDOUBLE pos_a = 0, pos_b = 0;
+    uint64_t ticks = 0;
+    uint64_t next_ns = DAC8532_Wave_Now();
+
+    DAC8532_Wave_ApplyScheduling(cfg);
+
+    while (atomic_load_explicit(&wave->running, memory_order_relaxed)) {
+        int ret;
+
+        next_ns += period_ns;
+        DAC8532_Wave_WaitUntil(next_ns, cfg->spin_ns);
+        uint64_t start_ns = DAC8532_Wave_Now();
+        LatencyHist_Record(&wave->lateness, start_ns - next_ns);
+
+        if (len_a && len_b) {
+            ret = DAC8532_Dev_WriteBoth(cfg->dac, table_a[pos_a], table_b[pos_b]);
+        } else if (len_a) {
+            ret = DAC8532_Dev_Write(cfg->dac, DAC8532_CHANNEL_A, table_a[pos_a]);
+        } else {
+            ret = DAC8532_Dev_Write(cfg->dac, DAC8532_CHANNEL_B, table_b[pos_b]);
+        }
+        uint64_t done_ns = DAC8532_Wave_Now();
+        LatencyHist_Record(&wave->write_time, done_ns - start_ns);
+        if (ret != 0) {
+            atomic_fetch_add_explicit(&wave->errors, 1, memory_order_relaxed);
+        }
+        atomic_fetch_add_explicit(&wave->updates, 1, memory_order_relaxed);
+
+        // Ticks a slow write ran into are dropped, but the tables still advance
+        // past them so the waveform stays locked to the clock
+        UDOUBLE step = 1;
+        while (next_ns + period_ns <= done_ns) {
+            next_ns += period_ns;
+            step++;
+            atomic_fetch_add_explicit(&wave->overruns, 1, memory_order_relaxed);
+        }
+        if (len_a) pos_a = (pos_a + step) % len_a;
+        if (len_b) pos_b = (pos_b + step) % len_b;
+
+        ticks += step;
+        if (cfg->num_ticks && ticks >= cfg->num_ticks) break;
+    }
+    atomic_store_explicit(&wave->running, 0, memory_order_relaxed);
+    return NULL;
+}
+
+/**
+ * @brief Starts the playback thread.
+ * @param wave Player with at least one table loaded.
+ * @param cfg Configuration (copied).
+ * @return 0 on success, 1 on an invalid configuration or thread error.
+ */
+UBYTE DAC8532_Wave_Start(dac8532_wave_t *wave, const dac8532_wave_config_t *cfg)
+{
+    if (!wave || !cfg || wave->thread_started || cfg->rate_hz == 0 ||
+        (wave->length[0] == 0 && wave->length[1] == 0)) {
+        fprintf(stderr, "DAC8532_Wave_Start: No table loaded, already running or zero rate\r\n");
+        return 1;
+    }
+
+    wave->config = *cfg;
+    if (!wave->config.dac) {
+        DAC8532_Dev_Init(&wave->dac, DEV_GetDACPort(), DAC_VREF);
+        wave->config.dac = &wave->dac;
+    }
+    atomic_store(&wave->updates, 0);
+    atomic_store(&wave->overruns, 0);
+    atomic_store(&wave->errors, 0);
+    atomic_store(&wave->running, 1);
+    LatencyHist_Reset(&wave->lateness);
+    LatencyHist_Reset(&wave->write_time);
+
+    if (cfg->lock_memory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        perror("DAC8532_Wave_Start: mlockall failed, continuing unlocked");
+    }
+
+    int err = pthread_create(&wave->thread, NULL, DAC8532_Wave_Thread, wave);
+    if (err != 0) {
+        fprintf(stderr, "DAC8532_Wave_Start: Failed to create thread: %s\r\n", strerror(err));
+        atomic_store(&wave->running, 0);
+        return 1;
+    }
+    wave->thread_started = 1;
+
+    Debug("DAC8532_Wave_Start: A %lu codes, B %lu codes, %lu Hz, cpu %d, prio %d\n",
+          (unsigned long)wave->length[0], (unsigned long)wave->length[1], (unsigned long)cfg->rate_hz,
+          cfg->cpu, cfg->rt_priority);
+    return 0;
+}
+
+/**
+ * @brief Returns whether the playback thread is still playing.
+ * @param wave Player.
+ * @return Non-zero until stopped or num_ticks is reached.
+ */
+UBYTE DAC8532_Wave_IsRunning(dac8532_wave_t *wave)
+{
+    return wave && atomic_load_explicit(&wave->running, memory_order_relaxed);
+}
+
+/**
+ * @brief Stops playback and joins the thread.
+ * @param wave Player.
+ * @return 0 on success, 1 if the player was not started.
+ */
+UBYTE DAC8532_Wave_Stop(dac8532_wave_t *wave)
+{
+    if (!wave || !wave->thread_started) return 1;
+
+    atomic_store_explicit(&wave->running, 0, memory_order_relaxed);
+    pthread_join(wave->thread, NULL);
+    wave->thread_started = 0;
+    return 0;
+}
+
+/**
+ * @brief Frees the code tables of a stopped player.
+ * @param wave Player.
+ */
+void DAC8532_Wave_Free(dac8532_wave_t *wave)
+{
+    if (!wave) return;
+    if (wave->thread_started) DAC8532_Wave_Stop(wave);
+
+    for (UBYTE i = 0; i < DAC8532_WAVE_CHANNELS; i++) {
+        free(wave->table[i]);
+        wave->table[i] = NULL;
+        wave->length[i] = 0;
+    }
+}
+
+/**
+ * @brief Prints tick counters and timing percentiles.
+ * @param wave Player.
+ */
+void DAC8532_Wave_PrintReport(dac8532_wave_t *wave)
+{
+    if (!wave) return;
+
+    printf("\n--- Waveform Playback Report ---\n");
+    printf("Rate: %lu Hz, A: %lu codes, B: %lu codes%s\n", (unsigned long)wave->config.rate_hz,
+           (unsigned long)wave->length[0], (unsigned long)wave->length[1],
+           (wave->length[0] && wave->length[1]) ? " (simultaneous update)" : "");
+    printf("Updates: %llu, overruns: %llu, errors: %llu\n",
+           (unsigned long long)atomic_load(&wave->updates), (unsigned long long)atomic_load(&wave->overruns),
+           (unsigned long long)atomic_load(&wave->errors));
+    LatencyHist_Print("Tick lateness", &wave->lateness);
+    LatencyHist_Print("DAC write", &wave->write_time);
+    printf("--------------------------------\n");
+}
+
+/**
+ * @brief Fills a table with one period of a sine wave.
+ * @param codes Table to fill.
+ * @param n Number of codes (one period).
+ * @param vref DAC reference voltage.
+ * @param offset_v Center voltage.
+ * @param amplitude_v Peak amplitude; the result is clamped to 0 .. vref.
+ */
+void DAC8532_Synth_Sine(UWORD *codes, UDOUBLE n, float vref, float offset_v, float amplitude_v)
+{
+    for (UDOUBLE i = 0; i < n; i++) {
+        double v = offset_v + amplitude_v * sin(2.0 * M_PI * (double)i / (double)n);
+        codes[i] = DAC8532_VoltageToCode(vref, (float)v);
+    }
+}
+
+/**
+ * @brief Fills a table with a linear ramp.
+ * @param codes Table to fill.
+ * @param n Number of codes.
+ * @param vref DAC reference voltage.
+ * @param start_v Voltage of the first code.
+ * @param end_v Voltage of the last code.
+ */
+void DAC8532_Synth_Ramp(UWORD *codes, UDOUBLE n, float vref, float start_v, float end_v)
+{
+    for (UDOUBLE i = 0; i < n; i++) {
+        double t = (n > 1) ? (double)i / (double)(n - 1) : 0.0;
+        codes[i] = DAC8532_VoltageToCode(vref, (float)(start_v + (end_v - start_v) * t));
+    }
+}
+
+/**
+ * @brief Fills a table with one period of a square wave.
+ * @param codes Table to fill.
+ * @param n Number of codes (one period).
+ * @param vref DAC reference voltage.
+ * @param low_v Low level.
+ * @param high_v High level.
+ * @param duty Fraction of the period at the high level, 0.0 .. 1.0.
+ */
+void DAC8532_Synth_Square(UWORD *codes, UDOUBLE n, float vref, float low_v, float high_v, float duty)
+{
+    UWORD high = DAC8532_VoltageToCode(vref, high_v);
+    UWORD low = DAC8532_VoltageToCode(vref, low_v);
+    UDOUBLE high_count = (UDOUBLE)lrint((double)duty * (double)n);
+
+    if (high_count > n) high_count = n;
+    for (UDOUBLE i = 0; i < n; i++) {
+        codes[i] = (i < high_count) ? high : low;
+    }
+}
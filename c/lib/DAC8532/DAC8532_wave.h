@@ -0,0 +1,152 @@
+/**
+ * @file DAC8532_wave.h
+ * @brief Table-driven waveform playback for the DAC8532.
+ *
+ * Waveforms are converted to DAC codes once (DAC8532_LoadWaveform() or the
+ * DAC8532_Synth_*() helpers), so playback does no arithmetic per update. A
+ * playback thread paced with clock_nanosleep(TIMER_ABSTIME) writes one code
+ * per channel per tick; when both channels play, they are updated together
+ * through the DAC8532 load bits (DAC8532_Dev_WriteBoth()).
+ */
+
+#ifndef _DAC8532_WAVE_H_
+#define _DAC8532_WAVE_H_
+
+#include "DAC8532.h"
+#include "../../common/LatencyHist.h"
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+/** @brief Number of DAC channels a player drives. */
+#define DAC8532_WAVE_CHANNELS 2
+
+/**
+ * @brief Playback thread configuration.
+ *
+ * Fill with DAC8532_Wave_DefaultConfig() and override what is needed.
+ */
+typedef struct {
+    dac8532_dev_t *dac;   ///< DAC to drive, or NULL for the board's DAC at DAC_VREF
+    UDOUBLE rate_hz;      ///< Table updates per second (per channel)
+    UDOUBLE spin_ns;      ///< Busy-wait this long before each tick instead of sleeping (0 = sleep only)
+    uint64_t num_ticks;   ///< Stop after this many ticks, or 0 to play until DAC8532_Wave_Stop()
+    int cpu;              ///< CPU core to pin the thread to, or -1 to leave it unpinned
+    int rt_priority;      ///< SCHED_FIFO priority (1-99), or 0 for SCHED_OTHER
+    UBYTE lock_memory;    ///< Non-zero to mlockall() the process before starting
+} dac8532_wave_config_t;
+
+/**
+ * @brief Waveform player state. Treat as opaque; use the functions below.
+ */
+typedef struct {
+    dac8532_wave_config_t config;               ///< Copy of the configuration passed to Start
+    dac8532_dev_t dac;                          ///< DAC used when the configuration gives none
+    UWORD *table[DAC8532_WAVE_CHANNELS];        ///< Code tables, index 0 = channel A, 1 = channel B
+    UDOUBLE length[DAC8532_WAVE_CHANNELS];      ///< Table lengths (0 = channel not played)
+    pthread_t thread;                           ///< Playback thread
+    UBYTE thread_started;                       ///< Non-zero while `thread` must be joined
+    _Atomic int running;                        ///< Cleared to stop, or by the thread when num_ticks is reached
+    _Atomic uint64_t updates;                   ///< Ticks written to the DAC
+    _Atomic uint64_t overruns;                  ///< Ticks skipped because a write ran past the next tick
+    _Atomic uint64_t errors;                    ///< Ticks whose SPI write failed
+    latency_hist_t lateness;                    ///< Actual minus scheduled tick time
+    latency_hist_t write_time;                  ///< Time to write one tick to the DAC
+} dac8532_wave_t;
+
+/**
+ * @brief Fills a configuration with defaults: board DAC, 10 kHz, no spinning,
+ *        endless playback, unpinned, SCHED_OTHER, no mlockall.
+ * @param cfg Configuration to initialize.
+ */
+void DAC8532_Wave_DefaultConfig(dac8532_wave_config_t *cfg);
+
+/**
+ * @brief Initializes an empty player.
+ * @param wave Player to initialize.
+ */
+void DAC8532_Wave_Init(dac8532_wave_t *wave);
+
+/**
+ * @brief Copies a code table for one channel into the player.
+ *
+ * Each tick plays the next entry; the table repeats, so a table of n codes
+ * at rate_hz plays a waveform of rate_hz / n Hz. Loading n = 0 (or NULL)
+ * removes the channel from playback.
+ * @param wave Stopped player.
+ * @param Channel `DAC8532_CHANNEL_A` or `DAC8532_CHANNEL_B`.
+ * @param codes DAC codes.
+ * @param n Number of codes.
+ * @return 0 on success, 1 while playing or if the table cannot be allocated.
+ */
+UBYTE DAC8532_LoadWaveform(dac8532_wave_t *wave, UBYTE Channel, const UWORD *codes, UDOUBLE n);
+
+/**
+ * @brief Starts the playback thread.
+ *
+ * While the player runs, its thread owns the DAC; do not write to it from
+ * elsewhere until DAC8532_Wave_Stop() returns.
+ * @param wave Player with at least one table loaded.
+ * @param cfg Configuration (copied).
+ * @return 0 on success, 1 on an invalid configuration or thread error.
+ */
+UBYTE DAC8532_Wave_Start(dac8532_wave_t *wave, const dac8532_wave_config_t *cfg);
+
+/**
+ * @brief Returns whether the playback thread is still playing.
+ * @param wave Player.
+ * @return Non-zero until stopped or num_ticks is reached.
+ */
+UBYTE DAC8532_Wave_IsRunning(dac8532_wave_t *wave);
+
+/**
+ * @brief Stops playback and joins the thread. The outputs keep their last codes.
+ * @param wave Player.
+ * @return 0 on success, 1 if the player was not started.
+ */
+UBYTE DAC8532_Wave_Stop(dac8532_wave_t *wave);
+
+/**
+ * @brief Frees the code tables of a stopped player.
+ * @param wave Player.
+ */
+void DAC8532_Wave_Free(dac8532_wave_t *wave);
+
+/**
+ * @brief Prints tick counters and timing percentiles.
+ * @param wave Player.
+ */
+void DAC8532_Wave_PrintReport(dac8532_wave_t *wave);
+
+/**
+ * @brief Fills a table with one period of a sine wave.
+ * @param codes Table to fill.
+ * @param n Number of codes (one period).
+ * @param vref DAC reference voltage.
+ * @param offset_v Center voltage.
+ * @param amplitude_v Peak amplitude; the result is clamped to 0 .. vref.
+ */
+void DAC8532_Synth_Sine(UWORD *codes, UDOUBLE n, float vref, float offset_v, float amplitude_v);
+
+/**
+ * @brief Fills a table with a linear ramp (sawtooth when repeated).
+ * @param codes Table to fill.
+ * @param n Number of codes.
+ * @param vref DAC reference voltage.
+ * @param start_v Voltage of the first code.
+ * @param end_v Voltage of the last code.
+ */
+void DAC8532_Synth_Ramp(UWORD *codes, UDOUBLE n, float vref, float start_v, float end_v);
+
+/**
+ * @brief Fills a table with one period of a square wave.
+ * @param codes Table to fill.
+ * @param n Number of codes (one period).
+ * @param vref DAC reference voltage.
+ * @param low_v Low level.
+ * @param high_v High level.
+ * @param duty Fraction of the period at the high level, 0.0 .. 1.0.
+ */
+void DAC8532_Synth_Square(UWORD *codes, UDOUBLE n, float vref, float low_v, float high_v, float duty);
+
+#endif // _DAC8532_WAVE_H_